@@ -0,0 +1,113 @@
+// Arduino.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Minimal Arduino core for the native test environment (pio test -e native).
+// The runtime only needs the clock, flash string helpers and a Serial port.
+// The port reads the bytes a test queued in Serial.input and collects the
+// bytes the runtime writes in Serial.output; text printing is discarded.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define ARDUINO 10819
+
+typedef uint8_t byte;
+class __FlashStringHelper;
+
+static char* __brkval = nullptr; // freeMemory() reports the distance to the stack
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*) (p))
+#define pgm_read_word(p) (*(const uint16_t*) (p))
+#define pgm_read_dword(p) (*(const uint32_t*) (p))
+#define pgm_read_ptr(p) (*(p))
+#define F(x) reinterpret_cast<const __FlashStringHelper*>(x)
+
+#define HEX 16
+#define DEC 10
+#define OCT 8
+#define BIN 2
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define LED_BUILTIN 13
+
+inline unsigned long millis() { return (unsigned long) std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+inline unsigned long micros() { return (unsigned long) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+inline void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+inline void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return LOW; }
+
+// Byte stream interface of the Arduino core, implemented by tests that simulate a wire
+class Stream {
+public:
+    virtual ~Stream() {}
+    virtual int available() = 0;
+    virtual int peek() = 0;
+    virtual int read() = 0;
+    virtual void flush() {}
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t* data, size_t size) {
+        for (size_t i = 0; i < size; i++) write(data[i]);
+        return size;
+    }
+};
+
+class HostSerial : public Stream {
+public:
+    std::vector<uint8_t> input; // Bytes the runtime has yet to read
+    std::vector<uint8_t> output; // Bytes the runtime wrote
+
+    void begin(unsigned long) {}
+    void end() {}
+    int available() { return (int) input.size(); }
+    int peek() { return input.empty() ? -1 : input.front(); }
+    int read() {
+        if (input.empty()) return -1;
+        int c = input.front();
+        input.erase(input.begin());
+        return c;
+    }
+    void flush() {}
+    size_t write(uint8_t b) { output.push_back(b); return 1; }
+    size_t write(const uint8_t* data, size_t size) { output.insert(output.end(), data, data + size); return size; }
+    template <typename T> size_t print(T) { return 0; }
+    template <typename T> size_t print(T, int) { return 0; }
+    template <typename T> size_t println(T) { return 0; }
+    template <typename T> size_t println(T, int) { return 0; }
+    size_t println() { return 0; }
+    int printf(const char*, ...) { return 0; }
+    operator bool() { return true; }
+};
+
+static HostSerial Serial;
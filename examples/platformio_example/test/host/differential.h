@@ -0,0 +1,84 @@
+// differential.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// Differential fixture for the native tests of the faster execution paths.
+// A test builds bytecode into `program`, loads it as the active program of
+// the runtime under test and runs a copy of it through run(program, size) of
+// `plain`, which always takes the byte interpreter. Both must end every scan
+// with the same status, stack and user memory.
+// Include after the runtime and after any feature macros the test opts into.
+
+#pragma once
+
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+
+#define USER_ADDR 64        // Everything below holds the system flags and clocks
+
+typedef InstructionCompiler IC;
+
+static VovkPLCRuntime plain;
+static u8 program[4096];
+static u32 size = 0;
+static u8 copy[sizeof(program)];
+
+// Reproducible operands: the same sequence on every run
+static u32 seed = 12345;
+inline u32 next_random(u32 n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+// Load `program` as the active program of `runtime` on fresh memory and an empty stack
+inline void load_program(VovkPLCRuntime& runtime) {
+    u8 checksum = 0;
+    crc8_simple(checksum, program, size);
+    runtime.initialize();
+    runtime.formatMemory();
+    runtime.loadProgram(program, size, checksum);
+    runtime.stack.clear();
+}
+
+inline RuntimeError load_and_run(VovkPLCRuntime& runtime) {
+    load_program(runtime);
+    return runtime.run();
+}
+
+// Load `program` into `runtime`, fill `data_size` random bytes from `data_addr` in both
+// runtimes and run `cycles` scans of each. Returns the status of the last scan.
+inline RuntimeError compare_with_plain(VovkPLCRuntime& runtime, const char* name, u8 cycles, u32 data_addr = 0, u32 data_size = 0) {
+    load_program(runtime);
+    plain.initialize();
+    plain.formatMemory();
+    memcpy(copy, program, size);
+    for (u32 i = 0; i < data_size; i++) runtime.memory[data_addr + i] = plain.memory[data_addr + i] = (u8) next_random(256);
+    RuntimeError status = STATUS_SUCCESS;
+    for (u8 cycle = 0; cycle < cycles; cycle++) {
+        runtime.stack.clear();
+        plain.stack.clear();
+        status = runtime.run();
+        TEST_ASSERT_EQUAL_INT_MESSAGE(plain.run(copy, size), status, name);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(plain.stack.size(), runtime.stack.size(), name);
+        for (u32 i = 0; i < plain.stack.size(); i++) TEST_ASSERT_EQUAL_UINT8_MESSAGE(plain.stack.peek(i), runtime.stack.peek(i), name);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(plain.memory + USER_ADDR, runtime.memory + USER_ADDR, PLCRUNTIME_MAX_MEMORY_SIZE - USER_ADDR, name);
+    }
+    return status;
+}
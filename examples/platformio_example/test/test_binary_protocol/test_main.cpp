@@ -0,0 +1,341 @@
+// test_main.cpp - Binary framed protocol and memory subscriptions over the Serial port
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define PLCRUNTIME_SERIAL_ENABLED
+#define PLCRUNTIME_BINARY_PROTOCOL // Opt in before the runtime is included
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+
+#define DATA_ADDR 100
+#define COUNTER_ADDR 300    // u32 incremented once per scan by the test programs
+#define CHUNK 100           // Program bytes per PROGRAM_CHUNK frame
+
+typedef InstructionCompiler IC;
+
+static VovkPLCRuntime runtime;
+static u8 sequence = 0;
+
+struct Frame {
+    u8 command;
+    u8 sequence;
+    u8 status;
+    std::vector<u8> data;
+};
+
+static void send(u8 command, const std::vector<u8>& payload) {
+    std::vector<u8> frame;
+    frame.push_back(command);
+    frame.push_back(sequence++);
+    frame.push_back(payload.size() & 0xFF);
+    frame.push_back(payload.size() >> 8);
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    const u32 crc = crc32_update(0, frame.data(), frame.size());
+    Serial.input.push_back(PLC_FRAME_SYNC);
+    Serial.input.insert(Serial.input.end(), frame.begin(), frame.end());
+    for (u8 i = 0; i < 4; i++) Serial.input.push_back((crc >> (8 * i)) & 0xFF);
+}
+
+// Split everything the runtime wrote into frames, every one must carry a valid CRC
+static std::vector<Frame> received() {
+    std::vector<Frame> frames;
+    const std::vector<u8>& out = Serial.output;
+    size_t i = 0;
+    while (i + 10 <= out.size()) {
+        TEST_ASSERT_EQUAL_HEX8(PLC_FRAME_SYNC, out[i]);
+        const u16 length = plc_frame_u16(&out[i + 3]);
+        TEST_ASSERT_TRUE(length >= 1 && i + 9 + length <= out.size());
+        TEST_ASSERT_EQUAL_HEX32(crc32_update(0, &out[i + 1], 4 + length), plc_frame_u32(&out[i + 5 + length]));
+        Frame frame;
+        frame.command = out[i + 1];
+        frame.sequence = out[i + 2];
+        frame.status = out[i + 5];
+        frame.data.assign(out.begin() + i + 6, out.begin() + i + 5 + length);
+        frames.push_back(frame);
+        i += 9 + length;
+    }
+    TEST_ASSERT_EQUAL_UINT32(out.size(), i);
+    Serial.output.clear();
+    return frames;
+}
+
+// Send one request and return its reply, pushes sent in between are skipped
+static Frame request(u8 command, const std::vector<u8>& payload) {
+    const u8 expected = sequence;
+    send(command, payload);
+    for (u8 i = 0; i < 10 && !Serial.input.empty(); i++) runtime.listen();
+    TEST_ASSERT_TRUE(Serial.input.empty());
+    std::vector<Frame> frames = received();
+    for (size_t i = 0; i < frames.size(); i++) {
+        if (frames[i].command != (command | PLC_FRAME_REPLY)) continue;
+        TEST_ASSERT_EQUAL_UINT8(expected, frames[i].sequence);
+        return frames[i];
+    }
+    TEST_FAIL_MESSAGE("No reply");
+    return Frame();
+}
+
+static void put_u16(std::vector<u8>& v, u16 x) { v.push_back(x & 0xFF); v.push_back(x >> 8); }
+static void put_u32(std::vector<u8>& v, u32 x) { for (u8 i = 0; i < 4; i++) v.push_back((x >> (8 * i)) & 0xFF); }
+
+static void reset() {
+    runtime.initialize();
+    runtime.formatMemory();
+    Serial.input.clear();
+    Serial.output.clear();
+}
+
+void test_hello_and_memory() {
+    reset();
+    Frame hello = request(FRAME_HELLO, std::vector<u8>());
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, hello.status);
+    TEST_ASSERT_EQUAL_UINT32(11, hello.data.size());
+    TEST_ASSERT_EQUAL_UINT8(PLC_FRAME_VERSION, hello.data[0]);
+    TEST_ASSERT_EQUAL_UINT16(PLCRUNTIME_BINARY_MAX_PAYLOAD, plc_frame_u16(&hello.data[1]));
+    TEST_ASSERT_EQUAL_UINT32(PLCRUNTIME_MAX_MEMORY_SIZE, plc_frame_u32(&hello.data[7]));
+
+    std::vector<u8> write;
+    put_u32(write, DATA_ADDR);
+    write.push_back(0x11);
+    write.push_back(0x22);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, request(FRAME_MEMORY_WRITE, write).status);
+
+    std::vector<u8> mask;
+    put_u32(mask, DATA_ADDR);
+    mask.push_back(0xFF);
+    mask.push_back(0x0F);
+    mask.push_back(0xF0);
+    mask.push_back(0x0F);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, request(FRAME_MEMORY_WRITE_MASK, mask).status);
+
+    std::vector<u8> read;
+    put_u32(read, DATA_ADDR - 1);
+    put_u16(read, 4);
+    Frame reply = request(FRAME_MEMORY_READ, read);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, reply.status);
+    const u8 expected[4] = { 0, 0xF1, 0x2F, 0 };
+    TEST_ASSERT_EQUAL_UINT32(4, reply.data.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected, reply.data.data(), 4);
+
+    std::vector<u8> format;
+    put_u32(format, DATA_ADDR);
+    put_u32(format, 2);
+    format.push_back(0x5A);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, request(FRAME_MEMORY_FORMAT, format).status);
+    TEST_ASSERT_EQUAL_HEX8(0x5A, runtime.memory[DATA_ADDR + 1]);
+
+    // Out of range and malformed requests are refused without touching memory
+    std::vector<u8> outside;
+    put_u32(outside, PLCRUNTIME_MAX_MEMORY_SIZE - 1);
+    outside.push_back(1);
+    outside.push_back(2);
+    TEST_ASSERT_EQUAL_INT(INVALID_MEMORY_ADDRESS, request(FRAME_MEMORY_WRITE, outside).status);
+    TEST_ASSERT_EQUAL_UINT8(0, runtime.memory[PLCRUNTIME_MAX_MEMORY_SIZE - 1]);
+    TEST_ASSERT_EQUAL_INT(INVALID_INSTRUCTION, request(FRAME_MEMORY_READ, std::vector<u8>(3)).status);
+    TEST_ASSERT_EQUAL_INT(UNKNOWN_INSTRUCTION, request(0x7E, std::vector<u8>()).status);
+}
+
+// A frame with a damaged byte is answered with INVALID_CHECKSUM and not executed
+void test_corrupted_frame() {
+    reset();
+    std::vector<u8> write;
+    put_u32(write, DATA_ADDR);
+    write.push_back(0x33);
+    send(FRAME_MEMORY_WRITE, write);
+    Serial.input[6] ^= 0x01;
+    runtime.listen();
+    std::vector<Frame> frames = received();
+    TEST_ASSERT_EQUAL_UINT32(1, frames.size());
+    TEST_ASSERT_EQUAL_INT(INVALID_CHECKSUM, frames[0].status);
+    TEST_ASSERT_EQUAL_UINT8(0, runtime.memory[DATA_ADDR]);
+
+    // Noise before a frame is skipped and the next frame is handled
+    Serial.input.push_back(0x00);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, request(FRAME_HELLO, std::vector<u8>()).status);
+}
+
+// Increments of every third byte from DATA_ADDR and of the counter, long enough to need several chunks
+static std::vector<u8> counting_program() {
+    u8 program[512];
+    u32 size = 0;
+    for (u32 i = 0; i < 60; i++) size += IC::push_inc(program + size, type_u8, DATA_ADDR + i * 3);
+    size += IC::push_inc(program + size, type_u32, COUNTER_ADDR);
+    program[size++] = EXIT;
+    return std::vector<u8>(program, program + size);
+}
+
+static RuntimeError download(const std::vector<u8>& program, u32 crc) {
+    std::vector<u8> begin;
+    put_u32(begin, program.size());
+    put_u32(begin, crc);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, request(FRAME_PROGRAM_BEGIN, begin).status);
+    for (u32 offset = 0; offset < program.size(); offset += CHUNK) {
+        std::vector<u8> chunk;
+        put_u32(chunk, offset);
+        const u32 n = program.size() - offset < CHUNK ? program.size() - offset : CHUNK;
+        chunk.insert(chunk.end(), program.begin() + offset, program.begin() + offset + n);
+        Frame reply = request(FRAME_PROGRAM_CHUNK, chunk);
+        TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, reply.status);
+        TEST_ASSERT_EQUAL_UINT32(offset + n, plc_frame_u32(reply.data.data()));
+        // A repeated chunk (lost reply) is acknowledged again, a gap is refused
+        reply = request(FRAME_PROGRAM_CHUNK, chunk);
+        TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, reply.status);
+        TEST_ASSERT_EQUAL_UINT32(offset + n, plc_frame_u32(reply.data.data()));
+        std::vector<u8> gap;
+        put_u32(gap, offset + n + 1);
+        gap.push_back(NOP);
+        TEST_ASSERT_EQUAL_INT(INVALID_PROGRAM_INDEX, request(FRAME_PROGRAM_CHUNK, gap).status);
+    }
+    return (RuntimeError) request(FRAME_PROGRAM_END, std::vector<u8>()).status;
+}
+
+// A streamed program runs exactly like the same bytes interpreted directly and uploads unchanged
+void test_program_download() {
+    reset();
+    static VovkPLCRuntime plain;
+    plain.initialize();
+    plain.formatMemory();
+    std::vector<u8> program = counting_program();
+    TEST_ASSERT_TRUE(program.size() > 2 * CHUNK);
+    TEST_ASSERT_EQUAL_INT(INVALID_CHECKSUM, download(program, crc32_update(0, program.data(), program.size()) ^ 1));
+    TEST_ASSERT_EQUAL_UINT32(0, runtime.program.prog_size);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, download(program, crc32_update(0, program.data(), program.size())));
+    TEST_ASSERT_EQUAL_UINT32(program.size(), runtime.program.prog_size);
+
+    std::vector<u8> copy(program);
+    for (u8 cycle = 0; cycle < 3; cycle++) {
+        runtime.stack.clear();
+        plain.stack.clear();
+        TEST_ASSERT_EQUAL_INT(plain.run(copy.data(), copy.size()), runtime.run());
+        TEST_ASSERT_EQUAL_MEMORY(plain.memory + DATA_ADDR, runtime.memory + DATA_ADDR, COUNTER_ADDR + 4 - DATA_ADDR);
+    }
+    TEST_ASSERT_EQUAL_UINT8(3, runtime.memory[COUNTER_ADDR]);
+
+    std::vector<u8> upload;
+    put_u32(upload, CHUNK);
+    put_u16(upload, 20);
+    Frame reply = request(FRAME_PROGRAM_UPLOAD, upload);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, reply.status);
+    TEST_ASSERT_EQUAL_MEMORY(program.data() + CHUNK, reply.data.data(), 20);
+    TEST_ASSERT_EQUAL_INT(NO_PROGRAM, request(FRAME_PROGRAM_END, std::vector<u8>()).status);
+}
+
+// Apply the runs of a PUSH frame to the host's copy of the subscribed bytes
+static void apply_push(const Frame& push, std::vector<u8>& mirror) {
+    TEST_ASSERT_EQUAL_HEX8(FRAME_PUSH | PLC_FRAME_REPLY, push.command);
+    size_t i = 0;
+    while (i < push.data.size()) {
+        TEST_ASSERT_TRUE(i + 3 <= push.data.size());
+        const u16 offset = plc_frame_u16(&push.data[i]);
+        const u8 count = push.data[i + 2];
+        TEST_ASSERT_TRUE(count > 0 && i + 3 + count <= push.data.size() && offset + count <= mirror.size());
+        memcpy(&mirror[offset], &push.data[i + 3], count);
+        i += 3 + count;
+    }
+}
+
+static std::vector<Frame> scan() {
+    runtime.stack.clear();
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, runtime.run());
+    runtime.listen();
+    return received();
+}
+
+// Subscribed bytes reach the host as change-only pushes, at most once per scan and interval
+void test_subscription() {
+    reset();
+    std::vector<u8> program = counting_program();
+    u8 checksum = 0;
+    crc8_simple(checksum, program.data(), program.size());
+    runtime.loadProgram(program.data(), program.size(), checksum);
+    for (u32 i = 0; i < 40; i++) runtime.memory[DATA_ADDR + i] = (u8) (i * 7);
+
+    // The first range is never written by the program, the others change every scan
+    std::vector<u8> subscribe;
+    put_u16(subscribe, 0);
+    put_u32(subscribe, DATA_ADDR + 1);
+    put_u16(subscribe, 2);
+    put_u32(subscribe, DATA_ADDR);
+    put_u16(subscribe, 40);
+    put_u32(subscribe, COUNTER_ADDR);
+    put_u16(subscribe, 4);
+    Frame reply = request(FRAME_SUBSCRIBE, subscribe);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, reply.status);
+    TEST_ASSERT_EQUAL_UINT16(46, plc_frame_u16(reply.data.data()));
+
+    // The first push carries every byte
+    std::vector<u8> mirror(46, 0xEE);
+    runtime.listen();
+    std::vector<Frame> frames = received();
+    TEST_ASSERT_EQUAL_UINT32(1, frames.size());
+    apply_push(frames[0], mirror);
+    TEST_ASSERT_EQUAL_MEMORY(runtime.memory + DATA_ADDR + 1, mirror.data(), 2);
+    TEST_ASSERT_EQUAL_MEMORY(runtime.memory + DATA_ADDR, mirror.data() + 2, 40);
+    TEST_ASSERT_EQUAL_MEMORY(runtime.memory + COUNTER_ADDR, mirror.data() + 42, 4);
+
+    // Nothing more until the next scan
+    runtime.listen();
+    TEST_ASSERT_EQUAL_UINT32(0, received().size());
+
+    u8 last_sequence = frames[0].sequence;
+    for (u8 cycle = 0; cycle < 5; cycle++) {
+        frames = scan();
+        TEST_ASSERT_EQUAL_UINT32(1, frames.size());
+        TEST_ASSERT_EQUAL_UINT8((u8) (last_sequence + 1), frames[0].sequence);
+        last_sequence = frames[0].sequence;
+        // Only changed bytes travel, the unchanged first range is not sent again
+        TEST_ASSERT_TRUE(plc_frame_u16(frames[0].data.data()) >= 2);
+        apply_push(frames[0], mirror);
+        TEST_ASSERT_EQUAL_MEMORY(runtime.memory + DATA_ADDR, mirror.data() + 2, 40);
+        TEST_ASSERT_EQUAL_MEMORY(runtime.memory + COUNTER_ADDR, mirror.data() + 42, 4);
+    }
+
+    // With an interval the scans in between are not pushed
+    subscribe[0] = 0xE8; // 1000 ms
+    subscribe[1] = 0x03;
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, request(FRAME_SUBSCRIBE, subscribe).status);
+    runtime.listen();
+    TEST_ASSERT_EQUAL_UINT32(1, received().size());
+    TEST_ASSERT_EQUAL_UINT32(0, scan().size());
+
+    // Too many bytes are refused, no ranges unsubscribe
+    std::vector<u8> large;
+    put_u16(large, 0);
+    put_u32(large, DATA_ADDR);
+    put_u16(large, PLCRUNTIME_SUBSCRIPTION_MAX_BYTES + 1);
+    TEST_ASSERT_EQUAL_INT(INVALID_MEMORY_SIZE, request(FRAME_SUBSCRIBE, large).status);
+    std::vector<u8> none;
+    put_u16(none, 0);
+    reply = request(FRAME_SUBSCRIBE, none);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, reply.status);
+    TEST_ASSERT_EQUAL_UINT16(0, plc_frame_u16(reply.data.data()));
+    TEST_ASSERT_EQUAL_UINT32(0, scan().size());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_hello_and_memory);
+    RUN_TEST(test_corrupted_frame);
+    RUN_TEST(test_program_download);
+    RUN_TEST(test_subscription);
+    return UNITY_END();
+}
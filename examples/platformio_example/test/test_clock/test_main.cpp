@@ -0,0 +1,140 @@
+// test_main.cpp - PLCClock pulses and runtimes running on separate time bases
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+
+#define TIMER_ADDR 500
+#define Q_ADDR 520
+#define DAY_MS 86400000UL
+
+typedef InstructionCompiler IC;
+
+// Every pulse fires once per period over a simulated day in 50 ms steps
+void test_pulse_periods() {
+    PLCClock clock;
+    clock.external = true;
+    u32 p100ms = 0, p1s = 0, p2s = 0, p5s = 0, p10s = 0, p30s = 0, p1min = 0, p2min = 0, p5min = 0, p10min = 0, p15min = 0;
+    u32 p30min = 0, p1hr = 0, p2hr = 0, p3hr = 0, p4hr = 0, p5hr = 0, p6hr = 0, p12hr = 0, p1day = 0, s1s = 0;
+    bool last_s1s = false;
+    for (u32 t = 50; t <= DAY_MS; t += 50) {
+        clock.update(t);
+        TEST_ASSERT_TRUE(clock.P_50ms);
+        p100ms += clock.P_100ms; p1s += clock.P_1s; p2s += clock.P_2s; p5s += clock.P_5s; p10s += clock.P_10s;
+        p30s += clock.P_30s; p1min += clock.P_1min; p2min += clock.P_2min; p5min += clock.P_5min; p10min += clock.P_10min;
+        p15min += clock.P_15min; p30min += clock.P_30min; p1hr += clock.P_1hr; p2hr += clock.P_2hr; p3hr += clock.P_3hr;
+        p4hr += clock.P_4hr; p5hr += clock.P_5hr; p6hr += clock.P_6hr; p12hr += clock.P_12hr; p1day += clock.P_1day;
+        s1s += clock.S_1s != last_s1s;
+        last_s1s = clock.S_1s;
+    }
+    TEST_ASSERT_EQUAL_UINT32(864000, p100ms);
+    TEST_ASSERT_EQUAL_UINT32(86400, p1s);
+    TEST_ASSERT_EQUAL_UINT32(43200, p2s);
+    TEST_ASSERT_EQUAL_UINT32(17280, p5s);
+    TEST_ASSERT_EQUAL_UINT32(8640, p10s);
+    TEST_ASSERT_EQUAL_UINT32(2880, p30s);
+    TEST_ASSERT_EQUAL_UINT32(1440, p1min);
+    TEST_ASSERT_EQUAL_UINT32(720, p2min);
+    TEST_ASSERT_EQUAL_UINT32(288, p5min);
+    TEST_ASSERT_EQUAL_UINT32(144, p10min);
+    TEST_ASSERT_EQUAL_UINT32(96, p15min);
+    TEST_ASSERT_EQUAL_UINT32(48, p30min);
+    TEST_ASSERT_EQUAL_UINT32(24, p1hr);
+    TEST_ASSERT_EQUAL_UINT32(12, p2hr);
+    TEST_ASSERT_EQUAL_UINT32(8, p3hr);
+    TEST_ASSERT_EQUAL_UINT32(6, p4hr);
+    TEST_ASSERT_EQUAL_UINT32(4, p5hr);
+    TEST_ASSERT_EQUAL_UINT32(4, p6hr);
+    TEST_ASSERT_EQUAL_UINT32(2, p12hr);
+    TEST_ASSERT_EQUAL_UINT32(1, p1day);
+    TEST_ASSERT_EQUAL_UINT32(172800, s1s); // Square wave flips every half period
+    TEST_ASSERT_EQUAL_UINT32(86400, clock.uptime_seconds);
+    TEST_ASSERT_EQUAL_UINT8(1, clock.time_days);
+    TEST_ASSERT_EQUAL_UINT8(0, clock.time_hours);
+}
+
+// An unchanged time raises nothing, a time that went backwards (millis() wrap) restarts the 50 ms base
+void test_time_steps() {
+    PLCClock clock;
+    clock.update(1000);
+    clock.update(1000);
+    TEST_ASSERT_FALSE(clock.P_50ms);
+    clock.update(1049);
+    TEST_ASSERT_FALSE(clock.P_50ms);
+    const u32 before = clock.counter_50ms;
+    clock.update(10);
+    TEST_ASSERT_TRUE(clock.P_50ms);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, clock.counter_50ms);
+    clock.update(60);
+    TEST_ASSERT_TRUE(clock.P_50ms);
+
+    // reset() restarts the time base but keeps the time of day
+    clock.time_hours = 7;
+    clock.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, clock.counter_50ms);
+    TEST_ASSERT_EQUAL_UINT32(0, clock.uptime_seconds);
+    TEST_ASSERT_EQUAL_UINT8(7, clock.time_hours);
+}
+
+// Two runtimes scanned alternately on their own external clocks: timers and system time follow each runtime's clock
+void test_runtimes_keep_separate_clocks() {
+    static VovkPLCRuntime fast;
+    static VovkPLCRuntime slow;
+    u8 program[32];
+    u32 size = 0;
+    size += IC::push_bool(program + size, true);
+    size += IC::push_timer_const(program + size, TON_CONST, TIMER_ADDR, 1000);
+    size += IC::push_move_to(program + size, type_u8, Q_ADDR);
+    program[size++] = EXIT;
+    u8 checksum = 0;
+    crc8_simple(checksum, program, size);
+
+    VovkPLCRuntime* runtimes[2] = { &fast, &slow };
+    for (u8 r = 0; r < 2; r++) {
+        runtimes[r]->initialize();
+        runtimes[r]->formatMemory();
+        runtimes[r]->loadProgram(program, size, checksum);
+        runtimes[r]->clock.external = true;
+    }
+    for (u32 t = 0; t <= 3000; t += 50) {
+        fast.clock.update(t);
+        slow.clock.update(t / 4);
+        for (u8 r = 0; r < 2; r++) {
+            runtimes[r]->stack.clear();
+            TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, runtimes[r]->run());
+        }
+        TEST_ASSERT_EQUAL_UINT8(t >= 1000, fast.memory[Q_ADDR]);
+        TEST_ASSERT_EQUAL_UINT8(t / 4 >= 1000, slow.memory[Q_ADDR]);
+    }
+    TEST_ASSERT_EQUAL_UINT8(3, fast.memory[fast.system_offset + 8]); // Seconds of the time of day
+    TEST_ASSERT_EQUAL_UINT8(0, slow.memory[slow.system_offset + 8]);
+    TEST_ASSERT_EQUAL_UINT32(3, fast.clock.uptime_seconds);
+    TEST_ASSERT_EQUAL_UINT32(0, slow.clock.uptime_seconds);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_pulse_periods);
+    RUN_TEST(test_time_steps);
+    RUN_TEST(test_runtimes_keep_separate_clocks);
+    return UNITY_END();
+}
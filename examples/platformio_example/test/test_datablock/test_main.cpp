@@ -0,0 +1,222 @@
+// test_main.cpp - DataBlock number index and free-list allocator against a reference model
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+
+#define ROUNDS 5000
+#define MAX_DB_SIZE 3000    // Large enough that the free space runs out now and then
+#define DB_NUMBERS 64       // DB numbers drawn from 1..DB_NUMBERS, so they collide in the index
+
+static VovkPLCRuntime runtime;
+static DataBlockManager& blocks = runtime.dataBlocks;
+
+// What the DataBlocks should hold: each declared DB with its size and a fill pattern
+struct Model {
+    u16 db;
+    u16 size;
+    u8 pattern;
+};
+static Model model[PLCRUNTIME_NUM_OF_DATABLOCKS];
+static u16 model_count = 0;
+
+static u32 seed = 1234;
+static u32 next_random(u32 n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+static i16 model_find(u16 db) {
+    for (u16 i = 0; i < model_count; i++) if (model[i].db == db) return (i16) i;
+    return -1;
+}
+
+static void fill(const Model& m) {
+    const u16 address = blocks.resolveAddress(m.db, 0);
+    for (u16 i = 0; i < m.size; i++) runtime.memory[address + i] = (u8) (m.pattern + i);
+}
+
+static void reset() {
+    runtime.initialize();
+    runtime.formatMemory();
+    blocks.format();
+    model_count = 0;
+}
+
+// Every modelled DB resolves and keeps its data, regions stay inside the DB area and never overlap
+static void verify() {
+    TEST_ASSERT_EQUAL_UINT16(model_count, blocks.activeCount());
+    u32 used = 0;
+    for (u16 k = 0; k < model_count; k++) {
+        const Model& m = model[k];
+        const u16 address = blocks.resolveAddress(m.db, 0);
+        TEST_ASSERT_TRUE(address != 0xFFFF);
+        TEST_ASSERT_EQUAL_UINT16(address + m.size - 1, blocks.resolveAddress(m.db, m.size - 1));
+        TEST_ASSERT_EQUAL_UINT16(0xFFFF, blocks.resolveAddress(m.db, m.size));
+        for (u16 i = 0; i < m.size; i++) TEST_ASSERT_EQUAL_UINT8((u8) (m.pattern + i), runtime.memory[address + i]);
+        used += m.size;
+    }
+    TEST_ASSERT_EQUAL_UINT32(used, blocks.totalDataUsed());
+    for (u16 i = 0; i < blocks.num_slots; i++) {
+        u16 db, offset, size;
+        blocks.getEntry(i, db, offset, size);
+        if (db == 0) continue;
+        TEST_ASSERT_TRUE(model_find(db) >= 0);
+        TEST_ASSERT_TRUE(offset >= blocks.user_area_end && (u32) offset + size <= blocks.table_offset);
+        for (u16 j = i + 1; j < blocks.num_slots; j++) {
+            u16 db2, offset2, size2;
+            blocks.getEntry(j, db2, offset2, size2);
+            if (db2 == 0) continue;
+            TEST_ASSERT_TRUE(db != db2);
+            TEST_ASSERT_TRUE(offset >= offset2 + size2 || offset2 >= offset + size);
+        }
+    }
+}
+
+// A fresh table fills slot by slot downward from the lookup table, the layout the compiler assumes
+void test_sequential_layout() {
+    reset();
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, blocks.resolveAddress(1, 0));
+    u16 expect = blocks.table_offset;
+    for (u16 k = 0; k < blocks.num_slots; k++) {
+        Model m = { (u16) (k * 17 + 1), (u16) (1 + next_random(200)), (u8) next_random(256) };
+        TEST_ASSERT_EQUAL_INT(k, blocks.declare(m.db, m.size));
+        expect -= m.size;
+        TEST_ASSERT_EQUAL_UINT16(expect, blocks.entryOffset(k));
+        model[model_count++] = m;
+        fill(m);
+    }
+    TEST_ASSERT_EQUAL_UINT16(expect, blocks.lowestAllocatedAddress());
+    TEST_ASSERT_EQUAL_UINT16(expect - blocks.user_area_end, blocks.freeSpace());
+
+    // Refused: DB 0, size 0, an existing number and a full table
+    TEST_ASSERT_EQUAL_INT(-1, blocks.declare(0, 4));
+    TEST_ASSERT_EQUAL_INT(-1, blocks.declare(5000, 0));
+    TEST_ASSERT_EQUAL_INT(-1, blocks.declare(model[3].db, 4));
+    TEST_ASSERT_EQUAL_INT(-1, blocks.declare(5000, 4));
+    verify();
+
+    // The hole a removed DB leaves is reused before the space below the lowest DB
+    const u16 hole = blocks.entryOffset(3);
+    TEST_ASSERT_TRUE(blocks.remove(model[3].db));
+    TEST_ASSERT_FALSE(blocks.remove(model[3].db));
+    model[3] = model[--model_count];
+    Model m = { 5000, 1, 0x5A };
+    TEST_ASSERT_EQUAL_INT(3, blocks.declare(m.db, m.size));
+    TEST_ASSERT_TRUE(blocks.entryOffset(3) >= hole);
+    TEST_ASSERT_EQUAL_UINT16(expect, blocks.lowestAllocatedAddress());
+    model[model_count++] = m;
+    fill(m);
+    verify();
+
+    // Compacting closes the rest of the hole
+    const u16 lowest = blocks.compact();
+    TEST_ASSERT_EQUAL_UINT16(blocks.lowestAllocatedAddress(), lowest);
+    TEST_ASSERT_EQUAL_UINT16(blocks.table_offset - blocks.totalDataUsed(), lowest);
+    verify();
+}
+
+// Random declare, remove, resize, migrate and compact keep every DB the way the reference model describes it
+void test_random_operations() {
+    reset();
+    for (u32 round = 0; round < ROUNDS; round++) {
+        const u32 op = next_random(10);
+        if (op < 3 && model_count > 0) {
+            const u16 k = (u16) next_random(model_count);
+            TEST_ASSERT_TRUE(blocks.remove(model[k].db));
+            model[k] = model[--model_count];
+        } else if (op < 6) {
+            Model m = { (u16) (1 + next_random(DB_NUMBERS)), (u16) (1 + next_random(MAX_DB_SIZE)), (u8) next_random(256) };
+            const bool exists = model_find(m.db) >= 0;
+            const i16 slot = blocks.declare(m.db, m.size);
+            if (exists || model_count == blocks.num_slots) TEST_ASSERT_EQUAL_INT(-1, slot);
+            if (slot >= 0) {
+                for (u16 i = 0; i < m.size; i++) TEST_ASSERT_EQUAL_UINT8(0, runtime.memory[blocks.entryOffset(slot) + i]);
+                model[model_count++] = m;
+                fill(m);
+            }
+        } else if (op < 8 && model_count > 0) {
+            Model& m = model[next_random(model_count)];
+            const u16 size = (u16) (1 + next_random(MAX_DB_SIZE));
+            if (blocks.resize(m.db, size)) {
+                const u16 address = blocks.resolveAddress(m.db, 0);
+                const u16 kept = size < m.size ? size : m.size;
+                for (u16 i = 0; i < kept; i++) TEST_ASSERT_EQUAL_UINT8((u8) (m.pattern + i), runtime.memory[address + i]);
+                for (u16 i = kept; i < size; i++) TEST_ASSERT_EQUAL_UINT8(0, runtime.memory[address + i]);
+                m.size = size;
+                fill(m);
+            }
+        } else if (op == 8 && model_count > 0) {
+            const Model& m = model[next_random(model_count)];
+            const u16 target = (u16) (blocks.user_area_end + next_random(blocks.table_offset - blocks.user_area_end));
+            if (blocks.migrate(m.db, target)) TEST_ASSERT_EQUAL_UINT16(target, blocks.resolveAddress(m.db, 0));
+        } else {
+            const u16 lowest = blocks.compact();
+            TEST_ASSERT_EQUAL_UINT16(blocks.lowestAllocatedAddress(), lowest);
+            TEST_ASSERT_EQUAL_UINT16(blocks.table_offset - blocks.totalDataUsed(), lowest);
+        }
+        verify();
+    }
+}
+
+// Entries written straight into the lookup table are picked up by the next lookup or allocation
+void test_external_table_edits() {
+    reset();
+    Model m = { 9, 100, 0x33 };
+    TEST_ASSERT_EQUAL_INT(0, blocks.declare(m.db, m.size));
+    fill(m);
+
+    // Cleared behind the manager's back, then restored
+    u16 db, offset, size;
+    blocks.getEntry(0, db, offset, size);
+    blocks.setEntry(0, 0, 0, 0);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, blocks.resolveAddress(m.db, 0));
+    blocks.setEntry(0, db, offset, size);
+    TEST_ASSERT_EQUAL_UINT16(offset, blocks.resolveAddress(m.db, 0));
+
+    // Added behind the manager's back: found by number, and later allocations go around it
+    const u16 foreign = blocks.table_offset - 1000;
+    blocks.setEntry(5, 4242, foreign, 10);
+    TEST_ASSERT_EQUAL_INT(5, blocks.findSlot(4242));
+    TEST_ASSERT_EQUAL_INT(-1, blocks.declare(4242, 10));
+    const i16 slot = blocks.declare(4243, 2000);
+    TEST_ASSERT_TRUE(slot >= 0);
+    const u16 placed = blocks.entryOffset(slot);
+    TEST_ASSERT_TRUE(placed >= foreign + 10 || placed + 2000 <= foreign);
+    model_count = 0;
+    model[model_count++] = m;
+    const Model added = { 4242, 10, 0 };
+    const Model declared = { 4243, 2000, 0 };
+    model[model_count++] = added;
+    model[model_count++] = declared;
+    fill(added);
+    fill(declared);
+    verify();
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_sequential_layout);
+    RUN_TEST(test_random_operations);
+    RUN_TEST(test_external_table_edits);
+    return UNITY_END();
+}
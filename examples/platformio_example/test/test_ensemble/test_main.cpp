@@ -0,0 +1,211 @@
+// test_main.cpp - Lockstep ensemble lanes against the plain interpreter
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define PLCRUNTIME_ENSEMBLE // Opt in before the runtime is included
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+#include <differential.h>
+
+#define LANES 37            // Not a multiple of any vector width
+#define LANE_MEMORY 1024    // Memory bytes per lane
+#define DATA_ADDR 100       // Random operands, different in every lane
+#define DATA_SIZE 256
+#define RESULT_ADDR 400     // Results written by the programs
+#define BLOCKS 40           // Operations per generated program
+#define CYCLES 3
+
+// The ensemble runs the program of `runtime` over all lanes, `plain` interprets it lane by lane
+static VovkPLCRuntime runtime;
+static PLCEnsemble ensemble;
+
+static u8 lane_memory[LANE_MEMORY * LANES];
+static u8 lane_stack[PLCRUNTIME_MAX_STACK_SIZE * LANES];
+static u32 lane_br[LANES];
+static RuntimeError lane_status[LANES];
+static u8 images[LANES][LANE_MEMORY];
+static u8 image[LANE_MEMORY];
+
+static const u8 types[] = { type_u8, type_i8, type_u16, type_i16, type_u32, type_i32, type_f32 };
+
+static u8 type_size(u8 type) {
+    switch (type) {
+        case type_u8: case type_i8: return 1;
+        case type_u16: case type_i16: return 2;
+        default: return 4;
+    }
+}
+
+// Load the program into `runtime` and bind the ensemble to it
+static RuntimeError load() {
+    load_and_run(runtime);
+    return ensemble.load(runtime);
+}
+
+// Run CYCLES scans of every lane and of the interpreter per lane image, memory and status must match
+static void compare(const char* name) {
+    TEST_ASSERT_EQUAL_INT_MESSAGE(STATUS_SUCCESS, load(), name);
+    TEST_ASSERT_TRUE_MESSAGE(ensemble.stackBytes() * LANES <= sizeof(lane_stack), name);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(STATUS_SUCCESS, ensemble.attach(lane_memory, LANE_MEMORY, LANES, lane_stack, lane_br, lane_status), name);
+    for (u32 l = 0; l < LANES; l++) {
+        memset(images[l], 0, LANE_MEMORY);
+        for (u32 i = 0; i < DATA_SIZE; i++) images[l][DATA_ADDR + i] = (u8) next_random(256);
+        ensemble.scatter(l, images[l]);
+    }
+    memcpy(copy, program, size);
+    for (u8 cycle = 0; cycle < CYCLES; cycle++) {
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, ensemble.run(), name);
+        for (u32 l = 0; l < LANES; l++) {
+            plain.initialize();
+            plain.formatMemory();
+            memcpy(plain.memory, images[l], LANE_MEMORY);
+            plain.stack.clear();
+            TEST_ASSERT_EQUAL_INT_MESSAGE(plain.run(copy, size), lane_status[l], name);
+            memcpy(images[l], plain.memory, LANE_MEMORY);
+            ensemble.gather(l, image);
+            TEST_ASSERT_EQUAL_MEMORY_MESSAGE(images[l] + USER_ADDR, image + USER_ADDR, LANE_MEMORY - USER_ADDR, name);
+        }
+    }
+}
+
+// Random typed arithmetic and comparisons between the lane operands. A comparison may
+// guard the next operation with a conditional jump, so some lanes skip it and others do not.
+static void random_program(bool branches) {
+    size = 0;
+    u32 result = RESULT_ADDR;
+    for (u32 block = 0; block < BLOCKS; block++) {
+        const u32 kind = next_random(branches ? 3 : 2);
+        u8 type = types[next_random(sizeof(types))];
+        if (kind == 0 && type == type_i32) type = type_u32; // i32 overflow is undefined behaviour in C++, u32 wraps the same bits
+        const u8 width = type_size(type);
+        size += IC::push_load_from(program + size, (PLCRuntimeInstructionSet) type, DATA_ADDR + next_random(DATA_SIZE - width));
+        size += IC::push_load_from(program + size, (PLCRuntimeInstructionSet) type, DATA_ADDR + next_random(DATA_SIZE - width));
+        if (kind == 0) {
+            static const u8 math[] = { ADD, SUB, MUL };
+            size += IC::push(program + size, math[next_random(sizeof(math))], type);
+            size += IC::push_move_to(program + size, (PLCRuntimeInstructionSet) type, result);
+            result += width;
+        } else {
+            size += IC::push(program + size, CMP_EQ + next_random(6), type);
+            if (kind == 1) {
+                size += IC::push_move_to(program + size, type_u8, result++);
+            } else {
+                // Skip the increment of a counter in the lanes where the comparison fails
+                const u32 jump = size;
+                size += IC::push_jmp_if_not(program + size, 0);
+                size += IC::push_load_from(program + size, type_u8, result);
+                size += IC::push_u8(program + size, 1);
+                size += IC::push(program + size, ADD, type_u8);
+                size += IC::push_move_to(program + size, type_u8, result++);
+                IC::push_jmp_if_not(program + jump, size);
+            }
+        }
+    }
+    program[size++] = EXIT;
+}
+
+// Without branches every lane runs the same instructions, all through the lane loops
+void test_uniform_lanes() {
+    for (u32 n = 0; n < 5; n++) {
+        random_program(false);
+        compare("uniform");
+        TEST_ASSERT_FALSE(ensemble.diverged);
+        TEST_ASSERT_TRUE(ensemble.vector_steps > 0);
+        TEST_ASSERT_EQUAL_UINT32(0, ensemble.lane_steps);
+    }
+}
+
+// Lanes that branch differently finish the cycle lane by lane with the same results
+void test_divergent_lanes() {
+    for (u32 n = 0; n < 5; n++) {
+        random_program(true);
+        compare("divergent");
+        TEST_ASSERT_TRUE(ensemble.diverged);
+        TEST_ASSERT_TRUE(ensemble.vector_steps > 0);
+        TEST_ASSERT_TRUE(ensemble.lane_steps > 0);
+    }
+}
+
+// Stack-only instructions without a lane loop (CVT) and calls take the per-lane paths
+void test_lane_by_lane_instructions() {
+    size = 0;
+    size += IC::push_load_from(program + size, type_i16, DATA_ADDR);
+    size += IC::push_cvt(program + size, type_i16, type_f32);
+    size += IC::push_load_from(program + size, type_f32, DATA_ADDR + 8);
+    size += IC::push(program + size, ADD, type_f32);
+    size += IC::push_move_to(program + size, type_f32, RESULT_ADDR);
+    const u32 call = size;
+    size += IC::pushCALL(program + size, 0);
+    program[size++] = EXIT;
+    IC::pushCALL(program + call, size);
+    size += IC::push_load_from(program + size, type_u16, DATA_ADDR + 2);
+    size += IC::push_u16(program + size, 3);
+    size += IC::push(program + size, MUL, type_u16);
+    size += IC::push_move_to(program + size, type_u16, RESULT_ADDR + 4);
+    program[size++] = RET;
+    compare("lane by lane");
+    TEST_ASSERT_TRUE(ensemble.diverged);
+}
+
+// Programs the ensemble cannot bind to, memory it cannot address and programs changed underneath it
+void test_errors() {
+    static PLCEnsemble unbound;
+    TEST_ASSERT_EQUAL_INT(NO_PROGRAM, unbound.attach(lane_memory, LANE_MEMORY, LANES, lane_stack, lane_br, lane_status));
+
+    // Depths that differ where two paths meet fail verification
+    size = 0;
+    size += IC::push_u8(program + size, 1);
+    size += IC::push_u8(program + size, 1);
+    const u32 jump = size;
+    size += IC::push_jmp_if(program + size, 0);
+    size += IC::push_u8(program + size, 1);
+    IC::push_jmp_if(program + jump, size);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(INVALID_STACK_SIZE, load());
+
+    // A result past the lane memory
+    size = 0;
+    size += IC::push_u8(program + size, 1);
+    size += IC::push_move_to(program + size, type_u8, LANE_MEMORY);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, load());
+    TEST_ASSERT_EQUAL_INT(INVALID_MEMORY_ADDRESS, ensemble.attach(lane_memory, LANE_MEMORY, LANES, lane_stack, lane_br, lane_status));
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, ensemble.attach(lane_memory, LANE_MEMORY + 1, LANES - 1, lane_stack, lane_br, lane_status));
+
+    // Every lane reports the program change until the ensemble is loaded again
+    TEST_ASSERT_EQUAL_UINT32(0, ensemble.run());
+    program[1] = 2;
+    u8 checksum = 0;
+    crc8_simple(checksum, program, size);
+    runtime.loadProgram(program, size, checksum);
+    TEST_ASSERT_EQUAL_UINT32(LANES - 1, ensemble.run());
+    for (u32 l = 0; l < LANES - 1; l++) TEST_ASSERT_EQUAL_INT(NO_PROGRAM, lane_status[l]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_uniform_lanes);
+    RUN_TEST(test_divergent_lanes);
+    RUN_TEST(test_lane_by_lane_instructions);
+    RUN_TEST(test_errors);
+    return UNITY_END();
+}
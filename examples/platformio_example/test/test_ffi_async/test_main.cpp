@@ -0,0 +1,191 @@
+// test_main.cpp - Async FFI jobs started by runtimes scanning on different threads
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+
+#define RUNTIMES 2
+#define JOBS_PER_SCAN 4     // Two runtimes fill all 8 job slots
+#define PARAM_ADDR 100      // i32 per job
+#define RESULT_ADDR 120     // i32 per job
+#define HANDLE_ADDR 140     // u16 per job
+#define SCANS_PER_RUNTIME 5000
+
+static i32 scale(i32 x) { return x * 3 + 1; }
+
+// Every runtime starts its jobs in one scan, polls them to completion and checks that the results are its own
+struct Caller {
+    VovkPLCRuntime runtime;
+    u8 start[JOBS_PER_SCAN * 16 + 1];
+    u32 start_size = 0;
+    u8 poll[JOBS_PER_SCAN][4];
+    i32 base = 0;
+    u32 started = 0;
+    u32 wrong = 0;
+    u32 lost = 0;
+
+    void setup(i8 ffi_index, i32 base_value) {
+        runtime.initialize();
+        base = base_value;
+        for (u8 j = 0; j < JOBS_PER_SCAN; j++) {
+            u16 addrs[3] = { (u16) (PARAM_ADDR + j * 4), (u16) (RESULT_ADDR + j * 4), (u16) (HANDLE_ADDR + j * 2) };
+            start_size += InstructionCompiler::push_ffi_start(start + start_size, ffi_index, 1, addrs);
+            u8 size = InstructionCompiler::push_ffi_poll(poll[j], HANDLE_ADDR + j * 2);
+            poll[j][size] = EXIT;
+        }
+        start[start_size++] = EXIT;
+    }
+
+    bool done(u8 job) {
+        runtime.clear();
+        runtime.run(poll[job], 4);
+        return runtime.read<bool>();
+    }
+
+    void loop() {
+        for (i32 scan = 0; scan < SCANS_PER_RUNTIME; scan++) {
+            for (u8 j = 0; j < JOBS_PER_SCAN; j++) {
+                i32 x = base + scan * JOBS_PER_SCAN + j;
+                memcpy(runtime.memory + PARAM_ADDR + j * 4, &x, sizeof(x));
+                memset(runtime.memory + RESULT_ADDR + j * 4, 0, 4);
+            }
+            runtime.clear();
+            runtime.run(start, start_size);
+            for (u8 j = 0; j < JOBS_PER_SCAN; j++) {
+                u16 handle = 0;
+                memcpy(&handle, runtime.memory + HANDLE_ADDR + j * 2, sizeof(handle));
+                if (handle == 0) continue; // Every slot was busy
+                started++;
+                bool finished = false;
+                for (u32 retry = 0; retry < 1000000 && !finished; retry++) finished = done(j);
+                i32 result = 0;
+                memcpy(&result, runtime.memory + RESULT_ADDR + j * 4, sizeof(result));
+                if (!finished) lost++;
+                else if (result != scale(base + scan * JOBS_PER_SCAN + j)) wrong++;
+            }
+        }
+    }
+};
+
+static Caller callers[RUNTIMES];
+
+static i32 mul_add(i32 a, i32 b) { return a * 7 + b; }
+
+// Without worker threads the jobs run from serviceFFI(), their results appear at the next scan boundary
+// and equal a synchronous FFI_CALL with the values the parameters had when the job started
+void test_cooperative_jobs_match_sync_calls() {
+    static VovkPLCRuntime runtime;
+    runtime.initialize();
+    runtime.formatMemory();
+    i8 async_index = runtime.registerFFIAsync("F_mul_add_async", "i32,i32->i32", "a * 7 + b", mul_add);
+    i8 sync_index = runtime.registerFFI("F_mul_add", "i32,i32->i32", "a * 7 + b", mul_add);
+    TEST_ASSERT_TRUE(async_index >= 0 && sync_index >= 0);
+    const i32 a = 12345, b = -678;
+    memcpy(runtime.memory + PARAM_ADDR, &a, sizeof(a));
+    memcpy(runtime.memory + PARAM_ADDR + 4, &b, sizeof(b));
+
+    u8 call[16];
+    u16 call_addrs[3] = { PARAM_ADDR, PARAM_ADDR + 4, RESULT_ADDR + 4 };
+    u8 call_size = InstructionCompiler::push_ffi_call(call, sync_index, 2, call_addrs);
+    call[call_size++] = EXIT;
+    runtime.clear();
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, runtime.run(call, call_size));
+
+    u8 start[16];
+    u16 start_addrs[4] = { PARAM_ADDR, PARAM_ADDR + 4, RESULT_ADDR, HANDLE_ADDR };
+    u8 start_size = InstructionCompiler::push_ffi_start(start, async_index, 2, start_addrs);
+    start[start_size++] = EXIT;
+    u8 poll[4];
+    u8 poll_size = InstructionCompiler::push_ffi_poll(poll, HANDLE_ADDR);
+    poll[poll_size++] = EXIT;
+    runtime.clear();
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, runtime.run(start, start_size));
+    const u16 handle = read_u16(runtime.memory + HANDLE_ADDR);
+    TEST_ASSERT_TRUE(handle != 0);
+    memset(runtime.memory + PARAM_ADDR, 0, 8); // The job keeps its own copy of the parameters
+
+    runtime.clear();
+    runtime.run(poll, poll_size);
+    TEST_ASSERT_FALSE(runtime.read<bool>());
+    TEST_ASSERT_EQUAL_UINT8(1, runtime.getFFIPending());
+    TEST_ASSERT_EQUAL_UINT8(1, runtime.serviceFFI(4));
+    TEST_ASSERT_EQUAL_UINT8(0, runtime.getFFIPending());
+    TEST_ASSERT_EQUAL_UINT32(0, read_u32(runtime.memory + RESULT_ADDR)); // Not before the next scan
+    runtime.clear();
+    runtime.run(poll, poll_size);
+    TEST_ASSERT_TRUE(runtime.read<bool>());
+    TEST_ASSERT_EQUAL_MEMORY(runtime.memory + RESULT_ADDR + 4, runtime.memory + RESULT_ADDR, 4);
+    TEST_ASSERT_EQUAL_UINT16(0, read_u16(runtime.memory + HANDLE_ADDR));
+
+    // A handle whose job was freed never completes again
+    write_u16(runtime.memory + HANDLE_ADDR, handle);
+    runtime.clear();
+    runtime.run(poll, poll_size);
+    TEST_ASSERT_FALSE(runtime.read<bool>());
+
+    // With every slot busy FFI_START succeeds with handle 0, a program reload drops the queued jobs
+    const u32 rejected = g_ffiAsync.rejected;
+    for (u8 i = 0; i <= PLCRUNTIME_FFI_ASYNC_MAX_JOBS; i++) {
+        runtime.clear();
+        TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, runtime.run(start, start_size));
+        TEST_ASSERT_EQUAL_UINT8(i < PLCRUNTIME_FFI_ASYNC_MAX_JOBS, read_u16(runtime.memory + HANDLE_ADDR) != 0);
+    }
+    TEST_ASSERT_EQUAL_UINT32(rejected + 1, g_ffiAsync.rejected);
+    TEST_ASSERT_EQUAL_UINT8(PLCRUNTIME_FFI_ASYNC_MAX_JOBS, runtime.getFFIPending());
+    runtime.loadProgramUnsafe(poll, poll_size);
+    TEST_ASSERT_EQUAL_UINT8(0, runtime.getFFIPending());
+
+    // A synchronous function cannot be started as a job
+    start[1] = (u8) sync_index;
+    runtime.clear();
+    TEST_ASSERT_EQUAL_INT(FFI_INVALID_PARAMS, runtime.run(start, start_size));
+}
+
+void test_two_runtimes_start_jobs_concurrently() {
+    i8 ffi_index = callers[0].runtime.registerFFIAsync("F_scale", "i32->i32", "x * 3 + 1", scale);
+    TEST_ASSERT_TRUE(ffi_index >= 0);
+    for (u8 i = 0; i < RUNTIMES; i++) callers[i].setup(ffi_index, i * 1000000);
+    u32 started_before = g_ffiAsync.started;
+
+    g_ffiAsync.startWorkers();
+    std::thread threads[RUNTIMES];
+    for (u8 i = 0; i < RUNTIMES; i++) threads[i] = std::thread(&Caller::loop, &callers[i]);
+    for (u8 i = 0; i < RUNTIMES; i++) threads[i].join();
+    g_ffiAsync.stopWorkers();
+
+    u32 started = 0;
+    for (u8 i = 0; i < RUNTIMES; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, callers[i].lost);
+        TEST_ASSERT_EQUAL_UINT32(0, callers[i].wrong);
+        started += callers[i].started;
+    }
+    TEST_ASSERT_TRUE(started > 0);
+    TEST_ASSERT_EQUAL_UINT32(started, g_ffiAsync.started - started_before);
+    TEST_ASSERT_EQUAL_UINT8(0, g_ffiAsync.pending());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cooperative_jobs_match_sync_calls);
+    RUN_TEST(test_two_runtimes_start_jobs_concurrently);
+    return UNITY_END();
+}
@@ -0,0 +1,141 @@
+// test_main.cpp - Batched FFI calls against one FFI_CALL per record
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+
+#define RECORDS_ADDR 1001   // Odd on purpose, records carry no alignment
+#define RECORDS 40
+#define USER_ADDR 64        // Everything below holds the system flags and clocks
+
+typedef InstructionCompiler IC;
+
+static VovkPLCRuntime batched;
+static VovkPLCRuntime single;
+static u8 program[2048];
+
+static u32 seed = 777;
+static u32 next_random(u32 n) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 8) % n;
+}
+
+static i32 axis_step(i32 target, u16 speed) { return target / 2 + speed; }
+static f64 mix(u8 a, i16 b, f32 c, u64 d) { return a + b * 0.5 + c + (f64) (d % 1000); }
+static u32 touched = 0;
+static void touch(u32 v) { touched += v; }
+
+// Raw handler: halves the i32 parameter
+static RuntimeError halve_raw(u8* memory, u16* param_addrs, u8, u16 ret_addr, void*) {
+    i32 v = 0;
+    memcpy(&v, memory + param_addrs[0], sizeof(v));
+    v /= 2;
+    memcpy(memory + ret_addr, &v, sizeof(v));
+    return STATUS_SUCCESS;
+}
+
+// Run one FFI_CALL_BATCH on `batched` and one FFI_CALL per record on `single`, then compare the memory
+static void compare(i8 index, u8 param_count, const u8* sizes, u16 stride, const char* name) {
+    batched.initialize();
+    batched.formatMemory();
+    single.initialize();
+    single.formatMemory();
+    for (u32 i = 0; i < (u32) RECORDS * stride; i++) batched.memory[RECORDS_ADDR + i] = single.memory[RECORDS_ADDR + i] = (u8) next_random(256);
+
+    u32 size = IC::push_ffi_batch(program, index, RECORDS_ADDR, RECORDS, stride);
+    program[size++] = EXIT;
+    batched.clear();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(STATUS_SUCCESS, batched.run(program, size), name);
+
+    size = 0;
+    for (u16 n = 0; n < RECORDS; n++) {
+        u16 addrs[PLCRUNTIME_FFI_MAX_PARAMS + 1];
+        u16 addr = RECORDS_ADDR + n * stride;
+        for (u8 i = 0; i <= param_count; i++) {
+            addrs[i] = addr;
+            addr += sizes[i];
+        }
+        size += IC::push_ffi_call(program + size, index, param_count, addrs);
+    }
+    program[size++] = EXIT;
+    single.clear();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(STATUS_SUCCESS, single.run(program, size), name);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(single.memory + USER_ADDR, batched.memory + USER_ADDR, PLCRUNTIME_MAX_MEMORY_SIZE - USER_ADDR, name);
+}
+
+void test_batch_matches_single_calls() {
+    const i8 step = batched.registerFFI("F_axis_step", "i32,u16->i32", "Axis step", axis_step);
+    const i8 mixed = batched.registerFFI("F_mix", "u8,i16,f32,u64->f64", "Mixed types", mix);
+    const i8 raw = batched.registerFFI("F_halve", "i32->i32", "Raw handler", halve_raw);
+    TEST_ASSERT_TRUE(step >= 0 && mixed >= 0 && raw >= 0);
+
+    const u8 step_sizes[] = { 4, 2, 4 };
+    compare(step, 2, step_sizes, 10, "packed records");
+    compare(step, 2, step_sizes, 13, "padded records");
+    const u8 mix_sizes[] = { 1, 2, 4, 8, 8 };
+    compare(mixed, 4, mix_sizes, 23, "mixed types");
+    const u8 raw_sizes[] = { 4, 4 };
+    compare(raw, 1, raw_sizes, 8, "raw handler");
+
+    // Functions without a return value only read their records
+    const i8 sink = batched.registerFFI("F_touch", "u32->void", "Sum", touch);
+    TEST_ASSERT_TRUE(sink >= 0);
+    for (u16 n = 0; n < 3; n++) write_u32(batched.memory + RECORDS_ADDR + n * 4, n + 1);
+    u32 size = IC::push_ffi_batch(program, sink, RECORDS_ADDR, 3, 4);
+    program[size++] = EXIT;
+    batched.clear();
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, batched.run(program, size));
+    TEST_ASSERT_EQUAL_UINT32(6, touched);
+
+    for (i8 index : { step, mixed, raw, sink }) TEST_ASSERT_TRUE(batched.unregisterFFI((u8) index));
+}
+
+// Bad batches fail before any record is called
+static RuntimeError run_batch(u8 index, u16 base, u16 count, u16 stride) {
+    u32 size = IC::push_ffi_batch(program, index, base, count, stride);
+    program[size++] = EXIT;
+    batched.clear();
+    return batched.run(program, size);
+}
+
+void test_batch_errors() {
+    const i8 step = batched.registerFFI("F_axis_step", "i32,u16->i32", "Axis step", axis_step);
+    TEST_ASSERT_TRUE(step >= 0);
+    batched.initialize();
+    batched.formatMemory();
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, run_batch(step, RECORDS_ADDR, 0, 0));
+    TEST_ASSERT_EQUAL_INT(FFI_INVALID_PARAMS, run_batch(step, RECORDS_ADDR, 2, 9));
+    TEST_ASSERT_EQUAL_INT(INVALID_MEMORY_ADDRESS, run_batch(step, PLCRUNTIME_MAX_MEMORY_SIZE - 25, 3, 10));
+    for (u32 i = USER_ADDR; i < PLCRUNTIME_MAX_MEMORY_SIZE; i++) TEST_ASSERT_EQUAL_UINT8(0, batched.memory[i]);
+    TEST_ASSERT_TRUE(batched.unregisterFFI((u8) step));
+    TEST_ASSERT_EQUAL_INT(EXECUTION_ERROR, run_batch(step, RECORDS_ADDR, 1, 10));
+
+    // A signature that does not describe the function is refused
+    TEST_ASSERT_EQUAL_INT(-1, batched.registerFFI("F_wrong", "i32->i32", "Wrong", axis_step));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_batch_matches_single_calls);
+    RUN_TEST(test_batch_errors);
+    return UNITY_END();
+}
@@ -0,0 +1,169 @@
+// test_main.cpp - The native JIT against the plain interpreter
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define PLCRUNTIME_JIT // Opt in before the runtime is included
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+#include <differential.h>
+
+#define DATA_ADDR 100       // Random operands
+#define DATA_SIZE 256
+#define RESULT_ADDR 400     // Results written by the programs
+#define CYCLES 3
+
+// The active program runs as native code
+static VovkPLCRuntime native;
+
+static void compare(const char* name) {
+    compare_with_plain(native, name, CYCLES, DATA_ADDR, DATA_SIZE);
+    TEST_ASSERT_TRUE_MESSAGE(native.jit.valid, name);
+}
+
+// Straight-line arithmetic over random operands, every record becomes a native call
+void test_straight_line() {
+    static const u8 types[] = { type_u8, type_i16, type_u32, type_i32, type_i64, type_f32, type_f64 };
+    static const u8 ops[] = { ADD, SUB, MUL, CMP_GT, CMP_LTE };
+    for (u8 t = 0; t < sizeof(types); t++) {
+        const PLCRuntimeInstructionSet type = (PLCRuntimeInstructionSet) types[t];
+        for (u8 round = 0; round < 10; round++) {
+            size = 0;
+            u32 result = RESULT_ADDR;
+            for (u8 step = 0; step < 30; step++) {
+                const u8 op = ops[next_random(sizeof(ops))];
+                size += IC::push_load_from(program + size, type, DATA_ADDR + next_random(DATA_SIZE - 8));
+                size += IC::push_load_from(program + size, type, DATA_ADDR + next_random(DATA_SIZE - 8));
+                size += IC::push(program + size, op, type);
+                size += IC::push_move_to(program + size, op >= CMP_EQ ? type_u8 : type, result);
+                result += 8;
+            }
+            program[size++] = EXIT;
+            compare("straight line");
+        }
+    }
+}
+
+// Nested loops built from absolute and relative jumps, with plain and conditional subroutine calls
+void test_loops_and_calls() {
+    const MY_PTR_t i = RESULT_ADDR, j = RESULT_ADDR + 1, sum = RESULT_ADDR + 4, odd = RESULT_ADDR + 8;
+    size = 0;
+    size += IC::push_u8(program + size, 0);
+    size += IC::push_move_to(program + size, type_u8, i);
+    const u32 outer = size;
+    size += IC::push_u8(program + size, 0);
+    size += IC::push_move_to(program + size, type_u8, j);
+    const u32 inner = size;
+    size += IC::push_load_from(program + size, type_u8, i);
+    size += IC::push_load_from(program + size, type_u8, j);
+    size += IC::push(program + size, ADD, type_u8);
+    const u32 call_accumulate = size;
+    size += IC::pushCALL(program + size, 0);
+    size += IC::push_inc(program + size, type_u8, j);
+    size += IC::push_load_from(program + size, type_u8, j);
+    size += IC::push_u8(program + size, 7);
+    size += IC::push(program + size, CMP_LT, type_u8);
+    size += IC::push_jmp_if_rel(program + size, (i16) (inner - (size + 3)));
+    size += IC::push_load_from(program + size, type_u8, i);
+    size += IC::push_u8(program + size, 1);
+    size += IC::push(program + size, BW_AND_X8);
+    const u32 call_odd = size;
+    size += IC::pushCALL_IF(program + size, 0);
+    size += IC::push_inc(program + size, type_u8, i);
+    size += IC::push_load_from(program + size, type_u8, i);
+    size += IC::push_u8(program + size, 10);
+    size += IC::push(program + size, CMP_GTE, type_u8);
+    size += IC::push_jmp_if_not(program + size, outer);
+    program[size++] = EXIT;
+
+    write_u16(program + call_accumulate + 1, (u16) size);
+    size += IC::push_cvt(program + size, type_u8, type_u32);
+    size += IC::push_load_from(program + size, type_u32, sum);
+    size += IC::push(program + size, ADD, type_u32);
+    size += IC::push_move_to(program + size, type_u32, sum);
+    program[size++] = RET;
+
+    write_u16(program + call_odd + 1, (u16) size);
+    size += IC::push_inc(program + size, type_u16, odd);
+    program[size++] = RET;
+
+    compare("loops and calls");
+    u32 total = 0;
+    memcpy(&total, native.memory + sum, sizeof(total));
+    TEST_ASSERT_EQUAL_UINT32(CYCLES * (7 * 45 + 10 * 21), total); // Sum of i + j over i < 10, j < 7
+}
+
+// Records without a specialized handler (memory fill, bitwise, decrement) call into the interpreter
+void test_generic_records() {
+    size = 0;
+    size += IC::push_mem_fill(program + size, 0xA5, RESULT_ADDR, 16);
+    size += IC::push_load_from(program + size, type_u32, RESULT_ADDR);
+    size += IC::push_u32(program + size, 0x01020304);
+    size += IC::push(program + size, BW_XOR_X32);
+    size += IC::push_move_to(program + size, type_u32, RESULT_ADDR + 16);
+    size += IC::push_dec(program + size, type_i16, RESULT_ADDR + 20);
+    program[size++] = EXIT;
+    compare("generic records");
+}
+
+// Errors raised inside the native code end the scan with the interpreter's status
+void test_errors() {
+    size = 0;
+    const u32 top = size;
+    size += IC::push_u64(program + size, 1);
+    size += IC::push_jmp(program + size, top);
+    TEST_ASSERT_EQUAL_INT(STACK_OVERFLOW, load_and_run(native));
+    TEST_ASSERT_TRUE(native.jit.valid);
+
+    size = 0;
+    size += IC::push_u8(program + size, 1);
+    size += IC::push_jmp_if(program + size, 0xF000);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(PROGRAM_POINTER_OUT_OF_BOUNDS, load_and_run(native));
+}
+
+// Loading another program rebuilds the native code
+void test_reload() {
+    size = 0;
+    size += IC::push_u16(program + size, 1234);
+    size += IC::push_move_to(program + size, type_u16, RESULT_ADDR);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, load_and_run(native));
+    TEST_ASSERT_EQUAL_UINT16(1234, read_u16(native.memory + RESULT_ADDR));
+
+    write_u16(program + 1, 4321);
+    u8 checksum = 0;
+    crc8_simple(checksum, program, size);
+    native.loadProgram(program, size, checksum);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, native.run());
+    TEST_ASSERT_TRUE(native.jit.valid);
+    TEST_ASSERT_EQUAL_UINT16(4321, read_u16(native.memory + RESULT_ADDR));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_straight_line);
+    RUN_TEST(test_loops_and_calls);
+    RUN_TEST(test_generic_records);
+    RUN_TEST(test_errors);
+    RUN_TEST(test_reload);
+    return UNITY_END();
+}
@@ -0,0 +1,232 @@
+// test_main.cpp - Non-blocking Modbus RTU master and slave on a simulated bus
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define PLCRUNTIME_MODBUS_RTU // Opt in before the runtime is included
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+
+#define BAUDRATE 115200
+#define SLAVE_ADDR 7
+#define DONE_MS 1000        // Upper bound for any exchange on the simulated bus
+
+// One end of a point-to-point wire: bytes written arrive at the peer's receive buffer
+class WirePort : public Stream {
+public:
+    std::vector<uint8_t> rx;
+    WirePort* peer = nullptr;
+    bool connected = true;
+    int16_t corrupt = -1; // Index of the next written byte to damage
+
+    int available() { return (int) rx.size(); }
+    int peek() { return rx.empty() ? -1 : rx.front(); }
+    int read() {
+        if (rx.empty()) return -1;
+        int c = rx.front();
+        rx.erase(rx.begin());
+        return c;
+    }
+    size_t write(uint8_t b) {
+        if (corrupt == 0) b ^= 0x10;
+        if (corrupt >= 0) corrupt--;
+        if (connected) peer->rx.push_back(b);
+        return 1;
+    }
+};
+
+static WirePort master_port;
+static WirePort slave_port;
+static ModbusRTU master(master_port, BAUDRATE);
+static ModbusRTU slave(slave_port, BAUDRATE);
+
+static void reset() {
+    master_port.peer = &slave_port;
+    slave_port.peer = &master_port;
+    master_port.rx.clear();
+    slave_port.rx.clear();
+    master_port.connected = slave_port.connected = true;
+    master_port.corrupt = slave_port.corrupt = -1;
+    master.begin(0);
+    master.setTimeout(50);
+    master.resetCounters();
+    slave.begin(SLAVE_ADDR);
+    slave.resetCounters();
+    slave.addHoldingRegisters(100, 8);
+    slave.addInputRegisters(0, 4);
+    slave.addCoils(0, 16);
+    for (uint16_t i = 0; i < 8; i++) slave.holdingRegister(100 + i, 0x1100 + i);
+    for (uint16_t i = 0; i < 4; i++) slave.inputRegister(i, 0xA000 + i);
+}
+
+// Poll both ends until nothing is pending, returns false if the bus did not settle in time
+static bool run_bus() {
+    const unsigned long start = millis();
+    while (master.busy() || slave.state() != MODBUS_STATE_IDLE || slave_port.available()) {
+        master.poll();
+        slave.poll();
+        if (millis() - start > DONE_MS) return false;
+    }
+    return true;
+}
+
+// A queued request goes through the bus states one poll() at a time and completes through its result pointer
+void test_submit_does_not_block() {
+    reset();
+    uint16_t registers[4] = { 0 };
+    ModbusResult status = MODBUS_OK;
+    ModbusRequest request;
+    request.slave = SLAVE_ADDR;
+    request.fc = MODBUS_FC_READ_HOLDING_REGISTERS;
+    request.start = 102;
+    request.quantity = 4;
+    request.data = (uint8_t*) registers;
+    request.result = &status;
+    TEST_ASSERT_EQUAL_INT(MODBUS_PENDING, master.submit(request));
+    TEST_ASSERT_EQUAL_INT(MODBUS_PENDING, status);
+
+    // Each poll returns at once, the request is on its way long before it completes
+    bool sent = false;
+    const unsigned long start = millis();
+    while (status == MODBUS_PENDING && millis() - start < DONE_MS) {
+        const unsigned long before = micros();
+        master.poll();
+        slave.poll();
+        TEST_ASSERT_TRUE(micros() - before < 1500); // Shorter than the 1750 us t3.5 gap a blocking wait would take
+        if (master.state() == MODBUS_STATE_WAIT_REPLY || master.state() == MODBUS_STATE_RX) sent = true;
+    }
+    TEST_ASSERT_TRUE(sent);
+    TEST_ASSERT_EQUAL_INT(MODBUS_OK, status);
+    for (uint16_t i = 0; i < 4; i++) TEST_ASSERT_EQUAL_HEX16(0x1102 + i, registers[i]);
+    TEST_ASSERT_FALSE(master.busy());
+}
+
+// Requests queued back to back complete in order, register data can land in little-endian PLC memory
+void test_queue() {
+    reset();
+    static VovkPLCRuntime runtime;
+    runtime.initialize();
+    runtime.formatMemory();
+    uint8_t* plc = runtime.memory + 200;
+    const uint16_t values[2] = { 0xBEEF, 0x0102 };
+    ModbusResult status[5];
+    ModbusRequest requests[5];
+    requests[0].fc = MODBUS_FC_READ_INPUT_REGISTERS;
+    requests[0].start = 0;
+    requests[0].quantity = 4;
+    requests[0].flags = MODBUS_DATA_LE;
+    requests[0].data = plc;
+    requests[1].fc = MODBUS_FC_WRITE_SINGLE_COIL;
+    requests[1].start = 3;
+    requests[1].value = 0xFF00;
+    requests[2].fc = MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
+    requests[2].start = 104;
+    requests[2].quantity = 2;
+    requests[2].data = (uint8_t*) values;
+    requests[3].fc = MODBUS_FC_WRITE_SINGLE_REGISTER;
+    requests[3].start = 107;
+    requests[3].value = 1;
+    requests[4] = requests[3];
+    for (uint8_t i = 0; i < 5; i++) {
+        requests[i].slave = SLAVE_ADDR;
+        requests[i].result = &status[i];
+    }
+    for (uint8_t i = 0; i < 4; i++) TEST_ASSERT_EQUAL_INT(MODBUS_PENDING, master.submit(requests[i]));
+    TEST_ASSERT_EQUAL_UINT8(MODBUS_RTU_QUEUE_DEPTH, master.queued());
+    TEST_ASSERT_EQUAL_INT(MODBUS_ERR_QUEUE_FULL, master.submit(requests[4]));
+    // A queued single write to the same register takes the newer value instead of a new slot
+    requests[4].value = 42;
+    TEST_ASSERT_EQUAL_INT(MODBUS_PENDING, master.submit(requests[4], true));
+    TEST_ASSERT_EQUAL_UINT8(MODBUS_RTU_QUEUE_DEPTH, master.queued());
+
+    TEST_ASSERT_TRUE(run_bus());
+    for (uint8_t i = 0; i < 4; i++) TEST_ASSERT_EQUAL_INT(MODBUS_OK, status[i]);
+    for (uint16_t i = 0; i < 4; i++) TEST_ASSERT_EQUAL_HEX16(0xA000 + i, plc[i * 2] | (plc[i * 2 + 1] << 8));
+    TEST_ASSERT_TRUE(slave.coil(3));
+    TEST_ASSERT_FALSE(slave.coil(2));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, slave.holdingRegister(104));
+    TEST_ASSERT_EQUAL_HEX16(0x0102, slave.holdingRegister(105));
+    TEST_ASSERT_EQUAL_HEX16(42, slave.holdingRegister(107));
+    TEST_ASSERT_EQUAL_UINT32(4, master.txCount());
+}
+
+// Bus faults end the request with an error instead of hanging the master
+void test_errors() {
+    reset();
+    uint16_t registers[2];
+    TEST_ASSERT_EQUAL_INT(MODBUS_ERR_INVALID_PARAMS, master.submit(ModbusRequest()));
+
+    // Address outside the slave's block: exception reply
+    ModbusResult status = MODBUS_OK;
+    ModbusRequest request;
+    request.slave = SLAVE_ADDR;
+    request.fc = MODBUS_FC_READ_HOLDING_REGISTERS;
+    request.start = 107;
+    request.quantity = 2;
+    request.data = (uint8_t*) registers;
+    request.result = &status;
+    master.submit(request);
+    TEST_ASSERT_TRUE(run_bus());
+    TEST_ASSERT_EQUAL_INT(MODBUS_ERR_EXCEPTION, status);
+    TEST_ASSERT_EQUAL_UINT8(MODBUS_EX_ILLEGAL_DATA_ADDRESS, master.lastExceptionCode());
+
+    // Damaged reply
+    request.start = 100;
+    slave_port.corrupt = 4;
+    master.submit(request);
+    TEST_ASSERT_TRUE(run_bus());
+    TEST_ASSERT_EQUAL_INT(MODBUS_ERR_CRC, status);
+
+    // Damaged request: the slave stays silent and the master times out
+    master_port.corrupt = 2;
+    master.submit(request);
+    TEST_ASSERT_TRUE(run_bus());
+    TEST_ASSERT_EQUAL_INT(MODBUS_ERR_TIMEOUT, status);
+    TEST_ASSERT_EQUAL_UINT32(2, slave.errorCount()); // The exception reply and the damaged request
+
+    // Another slave address is ignored
+    request.slave = SLAVE_ADDR + 1;
+    master.submit(request);
+    TEST_ASSERT_TRUE(run_bus());
+    TEST_ASSERT_EQUAL_INT(MODBUS_ERR_TIMEOUT, status);
+
+    // No slave on the wire
+    request.slave = SLAVE_ADDR;
+    master_port.connected = false;
+    master.submit(request);
+    TEST_ASSERT_TRUE(run_bus());
+    TEST_ASSERT_EQUAL_INT(MODBUS_ERR_TIMEOUT, status);
+
+    // The bus recovers for the next request
+    master_port.connected = true;
+    master.submit(request);
+    TEST_ASSERT_TRUE(run_bus());
+    TEST_ASSERT_EQUAL_INT(MODBUS_OK, status);
+    TEST_ASSERT_EQUAL_HEX16(0x1101, registers[1]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_submit_does_not_block);
+    RUN_TEST(test_queue);
+    RUN_TEST(test_errors);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+// test_main.cpp - The pre-decoded dispatch loop and its cached top of stack against the plain interpreter
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+#include <differential.h>
+
+#define DATA_ADDR 100       // Random operands
+#define DATA_SIZE 256
+#define RESULT_ADDR 400     // Results written by the programs
+#define CYCLES 3
+
+// The active program runs from the pre-decoded cache
+static VovkPLCRuntime decoded;
+
+static void compare(const char* name) {
+    compare_with_plain(decoded, name, CYCLES, DATA_ADDR, DATA_SIZE);
+    TEST_ASSERT_TRUE_MESSAGE(decoded.decoded.valid, name);
+}
+
+static u8 type_size(u8 type) {
+    switch (type) {
+        case type_u8: case type_i8: return 1;
+        case type_u16: case type_i16: return 2;
+        case type_u32: case type_i32: case type_f32: return 4;
+        default: return 8;
+    }
+}
+
+// Straight-line stack code over one type: loads, arithmetic, comparisons and stack shuffles, so the
+// two cached stack values are spilled and refilled in every combination
+static void random_program(u8 type) {
+    static const u8 binary[] = { ADD, SUB, MUL };
+    static const u8 compares[] = { CMP_EQ, CMP_NEQ, CMP_GT, CMP_LT, CMP_GTE, CMP_LTE };
+    const u8 width = type_size(type);
+    const bool is_signed = type == type_i8 || type == type_i16 || type == type_i32 || type == type_i64 || type == type_f32 || type == type_f64;
+    u32 depth = 0;
+    u32 result = RESULT_ADDR;
+    size = 0;
+    for (u32 step = 0; step < 200; step++) {
+        u32 choice = next_random(10);
+        if (depth < 2 || (choice < 3 && depth < 12)) {
+            size += IC::push_load_from(program + size, (PLCRuntimeInstructionSet) type, DATA_ADDR + next_random(DATA_SIZE - 8));
+            depth++;
+        } else if (choice < 5) {
+            size += IC::push(program + size, binary[next_random(sizeof(binary))], type);
+            depth--;
+        } else if (choice == 5) {
+            size += IC::push(program + size, compares[next_random(sizeof(compares))], type);
+            size += IC::push_move_to(program + size, type_u8, result++);
+            depth -= 2;
+        } else if (choice == 6) {
+            size += IC::push_copy(program + size, (PLCRuntimeInstructionSet) type);
+            depth++;
+        } else if (choice == 7) {
+            size += IC::push_swap(program + size, (PLCRuntimeInstructionSet) type, (PLCRuntimeInstructionSet) type);
+        } else if (choice == 8 && depth > 2) {
+            size += IC::push_pick(program + size, (PLCRuntimeInstructionSet) type, width * next_random(depth));
+            depth++;
+        } else if (is_signed) {
+            size += IC::push(program + size, NEG, type);
+        } else {
+            size += IC::push_drop(program + size, (PLCRuntimeInstructionSet) type);
+            depth--;
+        }
+    }
+    while (depth-- > 0) {
+        size += IC::push_move_to(program + size, (PLCRuntimeInstructionSet) type, result);
+        result += width;
+    }
+    program[size++] = EXIT;
+}
+
+void test_random_stack_code() {
+    static const u8 types[] = { type_u8, type_i8, type_u16, type_i16, type_u32, type_i32, type_u64, type_i64, type_f32, type_f64 };
+    for (u8 t = 0; t < sizeof(types); t++) {
+        for (u8 round = 0; round < 20; round++) {
+            random_program(types[t]);
+            compare("random stack code");
+        }
+    }
+}
+
+// Count M[RESULT] to 50 in a loop and accumulate it through a subroutine
+void test_loop_and_call() {
+    size = 0;
+    u32 top = size;
+    size += IC::push_inc(program + size, type_u8, RESULT_ADDR);
+    size += IC::push_load_from(program + size, type_u8, RESULT_ADDR);
+    u32 call = size;
+    size += IC::pushCALL(program + size, 0);
+    size += IC::push_load_from(program + size, type_u8, RESULT_ADDR);
+    size += IC::push_u8(program + size, 50);
+    size += IC::push(program + size, CMP_LT, type_u8);
+    size += IC::push_jmp_if(program + size, top);
+    program[size++] = EXIT;
+    write_u16(program + call + 1, (u16) size);
+    size += IC::push_cvt(program + size, type_u8, type_u32);
+    size += IC::push_load_from(program + size, type_u32, RESULT_ADDR + 4);
+    size += IC::push(program + size, ADD, type_u32);
+    size += IC::push_move_to(program + size, type_u32, RESULT_ADDR + 4);
+    program[size++] = RET;
+    compare("loop and call");
+}
+
+// Fused compare-and-branch and bit instructions
+void test_superinstructions() {
+    const u8 limit = 200;
+    size = 0;
+    u32 skip = size;
+    size += IC::push_load_cmp_imm_jmp_if_not(program + size, CMP_GT, type_u8, DATA_ADDR, &limit, 0);
+    size += IC::push_InstructionWithPointer(program + size, READ_X8_B3, DATA_ADDR + 1);
+    size += IC::push_read_logic_x8(program + size, READ_AND_X8, DATA_ADDR + 2, 5);
+    size += IC::push_read_logic_x8(program + size, READ_OR_X8, DATA_ADDR + 3, 0);
+    size += IC::push_InstructionWithPointer(program + size, WRITE_X8_B0, RESULT_ADDR);
+    write_u16(program + skip + LOAD_CMP_IMM_SIZE(type_u8), (u16) size);
+    size += IC::push_InstructionWithPointer(program + size, READ_X8_B2, DATA_ADDR + 4);
+    size += IC::push_read_and_write_x8(program + size, DATA_ADDR + 4, 1, RESULT_ADDR, 1);
+    const MY_PTR_t addresses[] = { DATA_ADDR + 5, DATA_ADDR + 6, DATA_ADDR + 7, DATA_ADDR + 5 };
+    const u8 bits[] = { 0, 7, 3, 6 };
+    size += IC::push_bit_list(program + size, BIT_GATHER_X32, 4, addresses, bits);
+    size += IC::push_move_to(program + size, type_u32, RESULT_ADDR + 4);
+    program[size++] = EXIT;
+    for (u8 round = 0; round < 20; round++) compare("superinstructions");
+}
+
+// Errors the interpreter only catches in safe mode are still reported by the pre-decoded path
+void test_errors() {
+    size = 0;
+    for (u32 i = 0; i < PLCRUNTIME_MAX_STACK_SIZE / 8 + 1; i++) size += IC::push_u64(program + size, i);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(STACK_OVERFLOW, load_and_run(decoded));
+    TEST_ASSERT_FALSE(decoded.decoded.verified);
+
+    size = 0;
+    size += IC::push_u8(program + size, 1);
+    size += IC::push(program + size, ADD, type_u16);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(STACK_UNDERFLOW, load_and_run(decoded));
+
+    // Fused bit logic with nothing to combine the bit with underflows in the interpreter too
+    for (u8 opcode : { READ_AND_X8, READ_OR_X8, READ_AND_WRITE_X8 }) {
+        size = 0;
+        if (opcode == READ_AND_WRITE_X8) size += IC::push_read_and_write_x8(program + size, DATA_ADDR, 0, RESULT_ADDR, 0);
+        else size += IC::push_read_logic_x8(program + size, (PLCRuntimeInstructionSet) opcode, DATA_ADDR, 0);
+        program[size++] = EXIT;
+        TEST_ASSERT_EQUAL_INT(STACK_UNDERFLOW, load_and_run(decoded));
+        compare("fused underflow");
+    }
+
+    size = 0;
+    size += IC::push_jmp(program + size, 0xF000);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(PROGRAM_POINTER_OUT_OF_BOUNDS, load_and_run(decoded));
+    compare("jump out of bounds");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_random_stack_code);
+    RUN_TEST(test_loop_and_call);
+    RUN_TEST(test_superinstructions);
+    RUN_TEST(test_errors);
+    return UNITY_END();
+}
@@ -0,0 +1,154 @@
+// test_main.cpp - Double-buffered process image between an I/O thread and the scan cycle
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define PLCRUNTIME_PROCESS_IMAGE // Opt in before the runtime is included
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+#include <atomic>
+#include <thread>
+
+#define IMAGE_SIZE 16       // Bytes moved per image by the concurrent test
+#define IMAGES 200000
+
+typedef InstructionCompiler IC;
+
+static VovkPLCRuntime runtime;
+
+// The reader only sees published images, always the newest one, and never the slot being written
+void test_exchange_slots() {
+    static PLCImageExchange<4> image;
+    TEST_ASSERT_FALSE(image.fetch());
+    image.writeSlot()[0] = 1;
+    image.publish();
+    TEST_ASSERT_TRUE(image.fetch());
+    TEST_ASSERT_EQUAL_UINT8(1, image.readSlot()[0]);
+    TEST_ASSERT_FALSE(image.fetch());
+    TEST_ASSERT_EQUAL_UINT8(1, image.readSlot()[0]);
+
+    for (u8 v = 2; v <= 4; v++) {
+        image.writeSlot()[0] = v;
+        image.publish();
+        TEST_ASSERT_TRUE(image.writeSlot() != image.readSlot());
+    }
+    TEST_ASSERT_TRUE(image.fetch());
+    TEST_ASSERT_EQUAL_UINT8(4, image.readSlot()[0]);
+    TEST_ASSERT_TRUE(image.writeSlot() != image.readSlot());
+
+    image.reset();
+    TEST_ASSERT_FALSE(image.fetch());
+}
+
+// Copy the first IMAGE_SIZE input bytes to the outputs
+static void load_copy_program() {
+    u8 program[64];
+    u32 size = 0;
+    for (u32 i = 0; i < IMAGE_SIZE; i += 8) {
+        size += IC::push_load_from(program + size, type_u64, runtime.input_offset + i);
+        size += IC::push_move_to(program + size, type_u64, runtime.output_offset + i);
+    }
+    program[size++] = EXIT;
+    u8 checksum = 0;
+    crc8_simple(checksum, program, size);
+    runtime.initialize();
+    runtime.formatMemory();
+    runtime.input_image.reset();
+    runtime.output_image.reset();
+    runtime.loadProgram(program, size, checksum);
+}
+
+// Inputs reach the input area at the start of the next scan, outputs are readable after it
+void test_scan_takes_inputs_and_publishes_outputs() {
+    load_copy_program();
+    const u8 data[4] = { 10, 20, 30, 40 };
+    TEST_ASSERT_TRUE(runtime.writeInputs(2, data, sizeof(data)));
+    TEST_ASSERT_FALSE(runtime.writeInputs(PLCRUNTIME_NUM_OF_INPUTS - 1, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_UINT8(0, runtime.memory[runtime.input_offset + 2]);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, runtime.run());
+    TEST_ASSERT_EQUAL_MEMORY(data, runtime.memory + runtime.input_offset + 2, sizeof(data));
+
+    u8 outputs[IMAGE_SIZE];
+    TEST_ASSERT_TRUE(runtime.readOutputs(0, outputs, sizeof(outputs)));
+    TEST_ASSERT_EQUAL_MEMORY(data, outputs + 2, sizeof(data));
+    TEST_ASSERT_FALSE(runtime.readOutputs(PLCRUNTIME_NUM_OF_OUTPUTS, outputs, 1));
+
+    // Without a new input image the input area keeps its contents
+    runtime.memory[runtime.input_offset] = 99;
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, runtime.run());
+    TEST_ASSERT_EQUAL_UINT8(99, runtime.memory[runtime.input_offset]);
+    TEST_ASSERT_TRUE(runtime.readOutputs(0, outputs, sizeof(outputs)));
+    TEST_ASSERT_EQUAL_UINT8(99, outputs[0]);
+}
+
+// An I/O thread writes images with every byte equal while the scan copies them to the outputs.
+// Neither side may ever see a mix of two images, and the last image written reaches the outputs.
+void test_concurrent_images_are_never_torn() {
+    load_copy_program();
+    std::atomic<bool> done(false);
+    std::atomic<u32> torn_outputs(0);
+    std::thread io([&] {
+        u8 image[IMAGE_SIZE];
+        u8 outputs[IMAGE_SIZE];
+        for (u32 v = 1; v <= IMAGES; v++) {
+            memset(image, (u8) v, sizeof(image));
+            runtime.writeInputs(0, image, sizeof(image));
+            runtime.readOutputs(0, outputs, sizeof(outputs));
+            for (u32 i = 1; i < IMAGE_SIZE; i++) {
+                if (outputs[i] != outputs[0]) {
+                    torn_outputs++;
+                    break;
+                }
+            }
+        }
+        done = true;
+    });
+    u32 torn_inputs = 0;
+    u32 scans = 0;
+    while (!done) {
+        runtime.run();
+        scans++;
+        const u8* inputs = runtime.memory + runtime.input_offset;
+        for (u32 i = 1; i < IMAGE_SIZE; i++) {
+            if (inputs[i] != inputs[0]) {
+                torn_inputs++;
+                break;
+            }
+        }
+    }
+    io.join();
+    runtime.run();
+    TEST_ASSERT_TRUE(scans > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, torn_inputs);
+    TEST_ASSERT_EQUAL_UINT32(0, torn_outputs.load());
+    u8 outputs[IMAGE_SIZE];
+    TEST_ASSERT_TRUE(runtime.readOutputs(0, outputs, sizeof(outputs)));
+    TEST_ASSERT_EQUAL_UINT8((u8) IMAGES, outputs[0]);
+    TEST_ASSERT_EQUAL_UINT8((u8) IMAGES, outputs[IMAGE_SIZE - 1]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_exchange_slots);
+    RUN_TEST(test_scan_takes_inputs_and_publishes_outputs);
+    RUN_TEST(test_concurrent_images_are_never_torn);
+    return UNITY_END();
+}
@@ -0,0 +1,119 @@
+// test_main.cpp - Multi-PLC scheduler: every release runs once, on one worker at a time
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#define PLCRUNTIME_SCHEDULER // Opt in before the runtime is included
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+
+#define RUNTIMES 6
+#define WORKERS 3
+#define COUNTER_ADDR 600    // u32 incremented once per scan
+#define RUN_MS 300
+
+typedef InstructionCompiler IC;
+
+static VovkPLCRuntime runtimes[RUNTIMES + 2];
+static PLCScheduler scheduler;
+
+static void load(VovkPLCRuntime& runtime, bool fail) {
+    u8 program[16];
+    u32 size = 0;
+    if (fail) size += IC::push_jmp(program + size, 0xF000);
+    size += IC::push_inc(program + size, type_u32, COUNTER_ADDR);
+    program[size++] = EXIT;
+    u8 checksum = 0;
+    crc8_simple(checksum, program, size);
+    runtime.initialize();
+    runtime.formatMemory();
+    runtime.loadProgram(program, size, checksum);
+}
+
+static u32 counter(VovkPLCRuntime& runtime) {
+    u32 value = 0;
+    memcpy(&value, runtime.memory + COUNTER_ADDR, sizeof(value));
+    return value;
+}
+
+void test_rejects_invalid_tasks() {
+    load(runtimes[0], false);
+    TEST_ASSERT_EQUAL_INT(-1, scheduler.add(runtimes[0], 0));
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.taskCount());
+    TEST_ASSERT_NULL(scheduler.getTask(0));
+}
+
+// The counter of every runtime matches the scheduler's cycle count: no scan was lost or ran twice at once.
+// One runtime is added while the workers run, another fails every scan without affecting the rest.
+void test_tasks_run_once_per_release() {
+    for (u8 i = 0; i < RUNTIMES; i++) {
+        load(runtimes[i], false);
+        TEST_ASSERT_EQUAL_INT(i, scheduler.add(runtimes[i], 1000 * (i + 1)));
+        TEST_ASSERT_TRUE(runtimes[i].clock.external);
+    }
+    load(runtimes[RUNTIMES], true);
+    TEST_ASSERT_EQUAL_INT(RUNTIMES, scheduler.add(runtimes[RUNTIMES], 2000));
+    const u32 started = millis();
+    TEST_ASSERT_TRUE(scheduler.start(WORKERS));
+    TEST_ASSERT_FALSE(scheduler.start(WORKERS));
+    TEST_ASSERT_TRUE(scheduler.isRunning());
+    TEST_ASSERT_EQUAL_UINT32(WORKERS, scheduler.workerCount());
+    delay(RUN_MS / 2);
+    load(runtimes[RUNTIMES + 1], false);
+    TEST_ASSERT_EQUAL_INT(RUNTIMES + 1, scheduler.add(runtimes[RUNTIMES + 1], 1000));
+    delay(RUN_MS / 2);
+    scheduler.stop();
+    const u32 elapsed_ms = millis() - started + 1;
+    TEST_ASSERT_FALSE(scheduler.isRunning());
+
+    for (u8 i = 0; i < RUNTIMES + 2; i++) {
+        const PLCScheduler::Task* task = scheduler.getTask(i);
+        TEST_ASSERT_NOT_NULL(task);
+        TEST_ASSERT_TRUE(task->cycles > 0);
+        if (i == RUNTIMES) {
+            TEST_ASSERT_EQUAL_INT(PROGRAM_POINTER_OUT_OF_BOUNDS, task->last_status);
+            TEST_ASSERT_EQUAL_UINT32(0, counter(runtimes[i]));
+            continue;
+        }
+        TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, task->last_status);
+        TEST_ASSERT_EQUAL_UINT32(task->cycles, counter(runtimes[i]));
+        // Releases are either run or counted as overruns, never more than the elapsed periods allow
+        TEST_ASSERT_TRUE(task->cycles + task->overruns <= elapsed_ms * 1000 / task->period_us + 1);
+        TEST_ASSERT_TRUE(runtimes[i].clock.millis_now > 0);
+
+        DeviceHealth health;
+        TEST_ASSERT_TRUE(scheduler.getDeviceHealth(i, health));
+        TEST_ASSERT_TRUE(health.max_cycle_time_us >= health.min_cycle_time_us);
+        if (task->cycles > 2) TEST_ASSERT_TRUE(health.max_period_us >= task->period_us / 2);
+    }
+
+    // Nothing runs after stop()
+    const u32 after = counter(runtimes[0]);
+    delay(20);
+    TEST_ASSERT_EQUAL_UINT32(after, counter(runtimes[0]));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_rejects_invalid_tasks);
+    RUN_TEST(test_tasks_run_once_per_release);
+    return UNITY_END();
+}
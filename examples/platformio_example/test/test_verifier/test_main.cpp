@@ -0,0 +1,179 @@
+// test_main.cpp - Load-time verifier: proven programs against the interpreter, rejected ones keep the checks
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#include <Arduino.h>
+#include <unity.h>
+#include <VovkPLCRuntime.h>
+#include <differential.h>
+
+#define RESULT_ADDR 100     // Results written by the programs
+
+// The active program runs through the verifier and the pre-decoded cache
+static VovkPLCRuntime verified;
+
+// Run the active program and the interpreter once, the results must match. Returns the status.
+static RuntimeError compare(const char* name) {
+    return compare_with_plain(verified, name, 1);
+}
+
+// Straight line: (3 + 4) -> RESULT_ADDR
+static void straight_line() {
+    size = 0;
+    size += IC::push_u8(program + size, 3);
+    size += IC::push_u8(program + size, 4);
+    size += IC::push(program + size, ADD, type_u8);
+    size += IC::push_move_to(program + size, type_u8, RESULT_ADDR);
+    program[size++] = EXIT;
+}
+
+// Programs the verifier proves run the unchecked handlers and still match the interpreter
+void test_verified_programs_match_interpreter() {
+    straight_line();
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, compare("straight line"));
+    TEST_ASSERT_TRUE(verified.decoded.verified);
+    TEST_ASSERT_EQUAL_UINT16(2, verified.decoded.max_stack);
+    TEST_ASSERT_EQUAL_UINT8(7, verified.memory[RESULT_ADDR]);
+
+    // Loop: count RESULT_ADDR up to 10, the depth is the same on both edges into the loop head
+    size = 0;
+    const u32 top = size;
+    size += IC::push_load_from(program + size, type_u8, RESULT_ADDR);
+    size += IC::push_u8(program + size, 1);
+    size += IC::push(program + size, ADD, type_u8);
+    size += IC::push_move_to(program + size, type_u8, RESULT_ADDR);
+    size += IC::push_load_from(program + size, type_u8, RESULT_ADDR);
+    size += IC::push_u8(program + size, 10);
+    size += IC::push(program + size, CMP_LT, type_u8);
+    size += IC::push_jmp_if(program + size, top);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, compare("loop"));
+    TEST_ASSERT_TRUE(verified.decoded.verified);
+    TEST_ASSERT_EQUAL_UINT8(10, verified.memory[RESULT_ADDR]);
+
+    // Subroutine taking one argument from the caller: 5 * 2 -> RESULT_ADDR
+    size = 0;
+    size += IC::push_u8(program + size, 5);
+    const u32 call = size;
+    size += IC::pushCALL(program + size, 0);
+    size += IC::push_move_to(program + size, type_u8, RESULT_ADDR);
+    program[size++] = EXIT;
+    IC::pushCALL(program + call, size);
+    size += IC::push_u8(program + size, 2);
+    size += IC::push(program + size, MUL, type_u8);
+    program[size++] = RET;
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, compare("subroutine"));
+    TEST_ASSERT_TRUE(verified.decoded.verified);
+    TEST_ASSERT_EQUAL_UINT16(2, verified.decoded.max_stack);
+    TEST_ASSERT_EQUAL_UINT8(10, verified.memory[RESULT_ADDR]);
+}
+
+// Programs the verifier cannot prove keep the checked handlers and fail the way the interpreter does
+void test_unproven_programs_keep_checks() {
+    // Stack underflow, only guarded in the interpreter with PLCRUNTIME_SAFE_MODE, so the cache runs alone
+    size = 0;
+    size += IC::push(program + size, ADD, type_u8);
+    program[size++] = EXIT;
+    TEST_ASSERT_NOT_EQUAL(STATUS_SUCCESS, load_and_run(verified));
+    TEST_ASSERT_FALSE(verified.decoded.verified);
+
+    // Static stack overflow
+    size = 0;
+    for (u32 i = 0; i <= PLCRUNTIME_MAX_STACK_SIZE; i++) size += IC::push_u8(program + size, 1);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(STACK_OVERFLOW, compare("overflow"));
+    TEST_ASSERT_FALSE(verified.decoded.verified);
+
+    // Memory operand past the end of memory
+    size = 0;
+    size += IC::push_u16(program + size, 1);
+    size += IC::push_move_to(program + size, type_u16, PLCRUNTIME_MAX_MEMORY_SIZE - 1);
+    program[size++] = EXIT;
+    TEST_ASSERT_NOT_EQUAL(STATUS_SUCCESS, compare("address"));
+    TEST_ASSERT_FALSE(verified.decoded.verified);
+
+    // Depths that differ where two paths meet: a valid run, but not a provable one
+    size = 0;
+    size += IC::push_u8(program + size, 1);
+    size += IC::push_u8(program + size, 1);
+    const u32 jump = size;
+    size += IC::push_jmp_if(program + size, 0);
+    size += IC::push_u8(program + size, 1);
+    IC::push_jmp_if(program + jump, size);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, compare("merge"));
+    TEST_ASSERT_FALSE(verified.decoded.verified);
+
+    // Recursion has no bounded depth
+    size = 0;
+    size += IC::pushCALL(program + size, 0);
+    program[size++] = EXIT;
+    compare("recursion");
+    TEST_ASSERT_FALSE(verified.decoded.verified);
+}
+
+// A proven peak only holds for the stack it was proven for: with no headroom left the run falls back to the checked interpreter
+void test_no_headroom_falls_back() {
+    straight_line();
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, load_and_run(verified));
+    // run() clears the stack, running the active program by its buffer keeps what is on it
+    verified.stack.clear();
+    for (u32 i = 0; i < PLCRUNTIME_MAX_STACK_SIZE - 1; i++) verified.stack.push_u8(0);
+    TEST_ASSERT_EQUAL_INT(STACK_OVERFLOW, verified.run(verified.program.program, verified.program.prog_size));
+    TEST_ASSERT_TRUE(verified.decoded.verified);
+}
+
+// Malformed bytecode is rejected by the structure check with the matching status
+void test_structure_check() {
+    static u8 starts[(sizeof(program) + 7) / 8];
+    straight_line();
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, plc_check_program_structure(program, size, starts));
+    TEST_ASSERT_EQUAL_INT(EMPTY_PROGRAM, plc_check_program_structure(program, 0, starts));
+
+    // Cut inside the last instruction
+    TEST_ASSERT_EQUAL_INT(PROGRAM_SIZE_EXCEEDED, plc_check_program_structure(program, size - 3, starts));
+
+    // An opcode the runtime does not know
+    u8 unknown = 0;
+    while (OPCODE_EXISTS((PLCRuntimeInstructionSet) unknown)) unknown++;
+    program[0] = unknown;
+    TEST_ASSERT_EQUAL_INT(UNKNOWN_INSTRUCTION, plc_check_program_structure(program, size, starts));
+
+    // Jumps into the middle of an instruction and past the end
+    size = 0;
+    size += IC::push_u16(program + size, 1);
+    const u32 jump = size;
+    size += IC::push_jmp(program + size, 1);
+    program[size++] = EXIT;
+    TEST_ASSERT_EQUAL_INT(PROGRAM_POINTER_OUT_OF_BOUNDS, plc_check_program_structure(program, size, starts));
+    IC::push_jmp(program + jump, size);
+    TEST_ASSERT_EQUAL_INT(PROGRAM_POINTER_OUT_OF_BOUNDS, plc_check_program_structure(program, size, starts));
+    IC::push_jmp(program + jump, size - 1);
+    TEST_ASSERT_EQUAL_INT(STATUS_SUCCESS, plc_check_program_structure(program, size, starts));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_verified_programs_match_interpreter);
+    RUN_TEST(test_unproven_programs_keep_checks);
+    RUN_TEST(test_no_headroom_falls_back);
+    RUN_TEST(test_structure_check);
+    return UNITY_END();
+}
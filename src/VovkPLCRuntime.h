@@ -34,6 +34,8 @@
 #include "tools/assembly/st-linter.h"
 #include "tools/assembly/project-compiler.h"
 #include "tools/assembly/wcet-analysis.h"
+#include "tools/assembly/aot-cpp.h"
+#include "tools/assembly/aot-wasm.h"
 
 // Modbus RTU RS485 (enable with #define PLCRUNTIME_MODBUS_RTU before this include)
 // Note: plc-modbus-rtu.h and plc-comms-manager.h are included internally by runtime-lib.h
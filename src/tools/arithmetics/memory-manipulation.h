@@ -25,58 +25,58 @@ namespace PLCMethods {
 
     RuntimeError PUSH_pointer(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         MY_PTR_t value = 0;
-        extract_status = ProgramExtract.type_pointer(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_pointer(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_pointer(value);
     }
 
     RuntimeError PUSH_bool(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         bool value = 0;
-        extract_status = ProgramExtract.type_bool(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_bool(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_bool(value);
     }
     RuntimeError push_u8(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         u8 value = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_u8(value);
     }
     RuntimeError push_u16(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         u16 value = 0;
-        extract_status = ProgramExtract.type_u16(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_u16(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_u16(value);
     }
     RuntimeError push_u32(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         u32 value = 0;
-        extract_status = ProgramExtract.type_u32(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_u32(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_u32(value);
     }
 #ifdef USE_X64_OPS
     RuntimeError push_u64(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         u64 value = 0;
-        extract_status = ProgramExtract.type_u64(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_u64(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_u64(value);
     }
 #endif // USE_X64_OPS
     RuntimeError push_i8(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         i8 value = 0;
-        extract_status = ProgramExtract.type_i8(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_i8(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_i8(value);
     }
     RuntimeError push_i16(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         i16 value = 0;
-        extract_status = ProgramExtract.type_i16(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_i16(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_i16(value);
     }
     RuntimeError push_i32(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         i32 value = 0;
-        extract_status = ProgramExtract.type_i32(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_i32(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_i32(value);
     }
@@ -84,14 +84,14 @@ namespace PLCMethods {
 #ifdef USE_X64_OPS
     RuntimeError push_i64(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         i64 value = 0;
-        extract_status = ProgramExtract.type_i64(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_i64(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_i64(value);
     }
 #endif // USE_X64_OPS
     RuntimeError push_f32(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         f32 value = 0;
-        extract_status = ProgramExtract.type_f32(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_f32(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_f32(value);
     }
@@ -99,7 +99,7 @@ namespace PLCMethods {
 #ifdef USE_X64_OPS
     RuntimeError push_f64(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         f64 value = 0;
-        extract_status = ProgramExtract.type_f64(program, prog_size, index, &value);
+        RuntimeError extract_status = ProgramExtract.type_f64(program, prog_size, index, &value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         return stack.push_f64(value);
     }
@@ -128,7 +128,7 @@ namespace PLCMethods {
         SAFE_BOUNDS_CHECK(index + 2 > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 from_type = 0;
         u8 to_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &from_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &from_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         extract_status = ProgramExtract.type_u8(program, prog_size, index, &to_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
@@ -358,7 +358,7 @@ namespace PLCMethods {
     RuntimeError LOAD(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         RuntimeError status = stack.load_from_memory_to_stack(memory, data_type);
         return status;
@@ -368,7 +368,7 @@ namespace PLCMethods {
     RuntimeError MOVE(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         RuntimeError status = stack.store_from_stack_to_memory(memory, data_type);
         return status;
@@ -378,7 +378,7 @@ namespace PLCMethods {
     RuntimeError MOVE_COPY(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         RuntimeError status = stack.store_from_stack_to_memory(memory, data_type, true);
         return status;
@@ -406,7 +406,7 @@ namespace PLCMethods {
     RuntimeError LOAD_FROM(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 + sizeof(MY_PTR_t) > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         MY_PTR_t address = 0;
         extract_status = ProgramExtract.type_pointer(program, prog_size, index, &address);
@@ -463,7 +463,7 @@ namespace PLCMethods {
     RuntimeError MOVE_TO(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 + sizeof(MY_PTR_t) > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         MY_PTR_t address = 0;
         extract_status = ProgramExtract.type_pointer(program, prog_size, index, &address);
@@ -527,7 +527,7 @@ namespace PLCMethods {
     RuntimeError INC_MEM(u8* memory, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 + sizeof(MY_PTR_t) > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         MY_PTR_t address = 0;
         extract_status = ProgramExtract.type_pointer(program, prog_size, index, &address);
@@ -597,7 +597,7 @@ namespace PLCMethods {
     RuntimeError DEC_MEM(u8* memory, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 + sizeof(MY_PTR_t) > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         MY_PTR_t address = 0;
         extract_status = ProgramExtract.type_pointer(program, prog_size, index, &address);
@@ -667,7 +667,7 @@ namespace PLCMethods {
     RuntimeError COPY(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         switch (data_type) {
             case type_pointer: {
@@ -713,7 +713,7 @@ namespace PLCMethods {
         SAFE_BOUNDS_CHECK(index + 1 + MY_PTR_SIZE_BYTES > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
         MY_PTR_t depth = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         extract_status = ProgramExtract.type_pointer(program, prog_size, index, &depth);
         if (extract_status != STATUS_SUCCESS) return extract_status;
@@ -799,7 +799,7 @@ namespace PLCMethods {
         SAFE_BOUNDS_CHECK(index + 1 + MY_PTR_SIZE_BYTES > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
         MY_PTR_t depth = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         extract_status = ProgramExtract.type_pointer(program, prog_size, index, &depth);
         if (extract_status != STATUS_SUCCESS) return extract_status;
@@ -983,7 +983,7 @@ namespace PLCMethods {
     RuntimeError DROP(RuntimeStack& stack, u8* program, u32 prog_size, u32& index) {
         SAFE_BOUNDS_CHECK(index + 1 > prog_size, PROGRAM_POINTER_OUT_OF_BOUNDS);
         u8 data_type = 0;
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &data_type);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         switch (data_type) {
             case type_pointer: SAFE_BOUNDS_CHECK(stack.stack.size() < sizeof(MY_PTR_t), STACK_UNDERFLOW); stack.pop_pointer(); break;
@@ -1019,7 +1019,7 @@ namespace PLCMethods {
         MY_PTR_t address = 0;
         MY_PTR_t length = 0;
         
-        extract_status = ProgramExtract.type_u8(program, prog_size, index, &fill_value);
+        RuntimeError extract_status = ProgramExtract.type_u8(program, prog_size, index, &fill_value);
         if (extract_status != STATUS_SUCCESS) return extract_status;
         
         extract_status = ProgramExtract.type_pointer(program, prog_size, index, &address);
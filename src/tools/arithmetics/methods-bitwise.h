@@ -322,6 +322,78 @@ namespace PLCMethods {
     }
 #endif // USE_X64_OPS
 
+    // Packed bit access: [ u8 count, count x (address, u8 bit) ], bit n of the value belongs to the n-th listed memory bit.
+    // Checks the operand list and returns the index past it
+    RuntimeError bit_list_check(u8* program, u32 prog_size, u32 index, u8 max_count, u8& count, u32& end) {
+        if (index + 1 > prog_size) return CHECK_PROGRAM_POINTER_BOUNDS_HEAD(program, prog_size, index, index);
+        count = program[index];
+        if (count == 0 || count > max_count) return INVALID_INSTRUCTION;
+        end = index + 1 + (u32) count * (MY_PTR_SIZE_BYTES + 1);
+        if (end > prog_size) return CHECK_PROGRAM_POINTER_BOUNDS_HEAD(program, prog_size, index, index);
+        return STATUS_SUCCESS;
+    }
+
+    template <typename T>
+    RuntimeError bit_gather(u8* memory, u8* program, u32 prog_size, u32& index, T& value) {
+        u8 count = 0;
+        u32 end = 0;
+        RuntimeError status = bit_list_check(program, prog_size, index, sizeof(T) * 8, count, end);
+        if (status != STATUS_SUCCESS) return status;
+        const u8* entry = program + index + 1;
+        T word = 0;
+        for (u8 n = 0; n < count; n++, entry += MY_PTR_SIZE_BYTES + 1) {
+            u8 bit_index = entry[MY_PTR_SIZE_BYTES];
+            if (bit_index > 7) return INVALID_INSTRUCTION;
+            u8 x = 0;
+            if (get_u8(memory, read_ptr(entry), x)) return INVALID_MEMORY_ADDRESS;
+            word |= (T) ((x >> bit_index) & 1) << n;
+        }
+        value = word;
+        index = end;
+        return STATUS_SUCCESS;
+    }
+
+    template <typename T>
+    RuntimeError bit_scatter(u8* memory, u8* program, u32 prog_size, u32& index, T value) {
+        u8 count = 0;
+        u32 end = 0;
+        RuntimeError status = bit_list_check(program, prog_size, index, sizeof(T) * 8, count, end);
+        if (status != STATUS_SUCCESS) return status;
+        const u8* entry = program + index + 1;
+        for (u8 n = 0; n < count; n++, entry += MY_PTR_SIZE_BYTES + 1) {
+            u8 bit_index = entry[MY_PTR_SIZE_BYTES];
+            if (bit_index > 7) return INVALID_INSTRUCTION;
+            MY_PTR_t address = read_ptr(entry);
+            u8 x = 0;
+            if (get_u8(memory, address, x)) return INVALID_MEMORY_ADDRESS;
+            x = (value >> n) & 1 ? x | 1 << bit_index : x & ~(1 << bit_index);
+            if (set_u8(memory, address, x)) return INVALID_MEMORY_ADDRESS;
+        }
+        index = end;
+        return STATUS_SUCCESS;
+    }
+
+    RuntimeError handle_BIT_GATHER_X32(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        u32 value = 0;
+        RuntimeError status = bit_gather<u32>(memory, program, prog_size, index, value);
+        if (status != STATUS_SUCCESS) return status;
+        return stack.push_u32(value);
+    }
+    RuntimeError handle_BIT_SCATTER_X32(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        return bit_scatter<u32>(memory, program, prog_size, index, stack.pop_u32());
+    }
+#ifdef USE_X64_OPS
+    RuntimeError handle_BIT_GATHER_X64(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        u64 value = 0;
+        RuntimeError status = bit_gather<u64>(memory, program, prog_size, index, value);
+        if (status != STATUS_SUCCESS) return status;
+        return stack.push_u64(value);
+    }
+    RuntimeError handle_BIT_SCATTER_X64(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        return bit_scatter<u64>(memory, program, prog_size, index, stack.pop_u64());
+    }
+#endif // USE_X64_OPS
+
     // Helper for Edge Detection
     RuntimeError handle_READ_BIT_EDGE(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index, bool rising, bool invert = false) {
         u32 needed = MY_PTR_SIZE_BYTES + 1 + MY_PTR_SIZE_BYTES + 1; // input_addr + input_bit + state_addr + state_bit
@@ -227,6 +227,8 @@ namespace PLCMethods {
         return STATUS_SUCCESS;
     }
 
+    static RuntimeError handle_COMMS(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index);
+
     static RuntimeError handle_COMMS_POLL_ASYNC(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
         if (index + 1 > prog_size) return PROGRAM_SIZE_EXCEEDED;
         u8 inst = program[index++];
@@ -234,6 +236,18 @@ namespace PLCMethods {
         PLCCommsInstance* ci = g_plcComms.getInstance(inst);
         if (!ci || !ci->active) return stack.push_u8(0xFF);
 
+#ifdef PLCRUNTIME_MODBUS_RTU
+        // Modbus RTU keeps its own request queue, advance its bus state machine
+        if (ci->protocol == COMMS_PROTO_MODBUS_RTU) {
+            ModbusRTU* mb = (ModbusRTU*) ci->driver;
+            if (!mb) return stack.push_u8(0xFF);
+            u8 queued = mb->queued();
+            mb->poll();
+            if (mb->queued() < queued) ci->lastError = (u8) mb->lastError();
+            return stack.push_u8(mb->busy() ? 1 : 0);
+        }
+#endif
+
         PLCCommsTxn* txn = ci->asyncQueue.peek();
         if (!txn) return stack.push_u8(0); // idle - nothing queued
 
@@ -268,6 +282,10 @@ namespace PLCMethods {
         u8 inst = program[index++];
 
         PLCCommsInstance* ci = g_plcComms.getInstance(inst);
+#ifdef PLCRUNTIME_MODBUS_RTU
+        ModbusRTU* mb = g_plcComms.getModbusRTU(inst);
+        if (mb) return stack.push_u8(mb->queued());
+#endif
         return stack.push_u8(ci ? ci->asyncQueue.count : 0);
     }
 
@@ -301,6 +319,22 @@ namespace PLCMethods {
     // ========================================================================
 
 #ifdef PLCRUNTIME_MODBUS_RTU
+    // Issue a master request. In async priority the request is queued (an
+    // identical pending request is reused) and MODBUS_PENDING is pushed, the
+    // outcome shows up in comms_status once comms_poll_async completes it.
+    // In sync priority the scan waits for the response as before.
+    static RuntimeError mb_request(RuntimeStack& stack, PLCCommsInstance* ci, ModbusRTU* mb, const ModbusRequest& req) {
+        if (ci->priority == COMMS_PRIORITY_ASYNC) {
+            ModbusResult status = mb->submit(req, true);
+            if (status != MODBUS_PENDING) ci->lastError = (u8) status;
+            mb->poll(); // Start sending right away when the bus is free
+            return stack.push_u8((u8) status);
+        }
+        ModbusResult result = mb->transact(req);
+        ci->lastError = (u8) result;
+        return stack.push_u8((u8) result);
+    }
+
     static RuntimeError handle_MB_READ(RuntimeStack& stack, u8* memory, u8 sub_fn, u8* program, u32 prog_size, u32& index) {
         // Format: [inst:u8] [slave:u8] [start:u16] [qty:u16] [dest_mem:ptr]
         if (index + 6 + MY_PTR_SIZE_BYTES > prog_size) return PROGRAM_SIZE_EXCEEDED;
@@ -317,50 +351,20 @@ namespace PLCMethods {
             return stack.push_u8(0xFF);
         }
 
-        ModbusResult result;
+        ModbusRequest req;
+        req.slave = slave;
+        req.start = start;
+        req.quantity = qty;
+        req.flags = MODBUS_DATA_LE; // Registers land in PLC memory as little-endian u16
+        req.data = memory + dest_mem;
         switch ((PLCCommsSubFunction) sub_fn) {
-            case MB_READ_COILS: {
-                // Coils are packed bits - dest memory gets raw packed bytes
-                u8 byte_count = (qty + 7) / 8;
-                result = mb->readCoils(slave, start, qty, memory + dest_mem);
-                break;
-            }
-            case MB_READ_DISCRETE: {
-                u8 byte_count = (qty + 7) / 8;
-                (void) byte_count;
-                result = mb->readDiscreteInputs(slave, start, qty, memory + dest_mem);
-                break;
-            }
-            case MB_READ_HOLDING: {
-                // Registers are u16 - use temp buffer then write to memory
-                u16 regs[125]; // Max Modbus read quantity
-                if (qty > 125) qty = 125;
-                result = mb->readHoldingRegisters(slave, start, qty, regs);
-                if (result == MODBUS_OK) {
-                    for (u16 r = 0; r < qty; r++) {
-                        write_u16(memory + dest_mem + r * 2, regs[r]);
-                    }
-                }
-                break;
-            }
-            case MB_READ_INPUT: {
-                u16 regs[125];
-                if (qty > 125) qty = 125;
-                result = mb->readInputRegisters(slave, start, qty, regs);
-                if (result == MODBUS_OK) {
-                    for (u16 r = 0; r < qty; r++) {
-                        write_u16(memory + dest_mem + r * 2, regs[r]);
-                    }
-                }
-                break;
-            }
-            default:
-                result = MODBUS_ERR_INVALID_PARAMS;
-                break;
+            case MB_READ_COILS:    req.fc = MODBUS_FC_READ_COILS; break; // Packed bits
+            case MB_READ_DISCRETE: req.fc = MODBUS_FC_READ_DISCRETE_INPUTS; break;
+            case MB_READ_HOLDING:  req.fc = MODBUS_FC_READ_HOLDING_REGISTERS; break;
+            case MB_READ_INPUT:    req.fc = MODBUS_FC_READ_INPUT_REGISTERS; break;
+            default: break;
         }
-
-        ci->lastError = (u8) result;
-        return stack.push_u8((u8) result);
+        return mb_request(stack, ci, mb, req);
     }
 #endif // PLCRUNTIME_MODBUS_RTU
 
@@ -386,19 +390,19 @@ namespace PLCMethods {
             return stack.push_u8(0xFF);
         }
 
-        ModbusResult result;
+        ModbusRequest req;
+        req.slave = slave;
+        req.start = addr;
         if (sub_fn == MB_WRITE_COIL) {
-            bool val = stack.pop() != 0;
-            result = mb->writeSingleCoil(slave, addr, val);
+            req.fc = MODBUS_FC_WRITE_SINGLE_COIL;
+            req.value = stack.pop() != 0 ? 0xFF00 : 0x0000;
         } else { // MB_WRITE_REG
             u8 hi = stack.pop();
             u8 lo = stack.pop();
-            u16 val = (u16)lo | ((u16)hi << 8);
-            result = mb->writeSingleRegister(slave, addr, val);
+            req.fc = MODBUS_FC_WRITE_SINGLE_REGISTER;
+            req.value = (u16)lo | ((u16)hi << 8);
         }
-
-        ci->lastError = (u8) result;
-        return stack.push_u8((u8) result);
+        return mb_request(stack, ci, mb, req);
     }
 
     static RuntimeError handle_MB_WRITE_MULTIPLE(RuntimeStack& stack, u8* memory, u8 sub_fn, u8* program, u32 prog_size, u32& index) {
@@ -417,22 +421,16 @@ namespace PLCMethods {
             return stack.push_u8(0xFF);
         }
 
-        ModbusResult result;
-        if (sub_fn == MB_WRITE_COILS) {
-            // Coils are packed bits in memory
-            result = mb->writeMultipleCoils(slave, start, qty, memory + src_mem);
-        } else { // MB_WRITE_REGS
-            // Registers: read u16 values from PLC memory
-            u16 regs[123]; // Max Modbus write quantity
-            if (qty > 123) qty = 123;
-            for (u16 r = 0; r < qty; r++) {
-                regs[r] = read_u16(memory + src_mem + r * 2);
-            }
-            result = mb->writeMultipleRegisters(slave, start, qty, regs);
-        }
-
-        ci->lastError = (u8) result;
-        return stack.push_u8((u8) result);
+        // Coils are packed bits, registers little-endian u16 in PLC memory.
+        // The source is read when the frame is sent, so a queued write sends the latest values.
+        ModbusRequest req;
+        req.slave = slave;
+        req.fc = sub_fn == MB_WRITE_COILS ? MODBUS_FC_WRITE_MULTIPLE_COILS : MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
+        req.start = start;
+        req.quantity = qty;
+        req.flags = MODBUS_DATA_LE;
+        req.data = memory + src_mem;
+        return mb_request(stack, ci, mb, req);
     }
 #endif // PLCRUNTIME_MODBUS_RTU
 
@@ -0,0 +1,144 @@
+// methods-fused.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+// Fused superinstructions emitted by the PLCASM peephole pass.
+// Every handler produces exactly the same stack, memory and jump effects as
+// the instruction sequence it replaces, only with a single dispatch.
+
+namespace PLCMethods {
+
+    // Read [ address, u8 bit ] operand and return the addressed bit
+    RuntimeError fused_read_bit(u8* memory, u8* program, u32 prog_size, u32& index, u8& bit) {
+        READ_ADDRESS_FROM_MEMORY;
+        if (index + size + 1 > prog_size) return CHECK_PROGRAM_POINTER_BOUNDS_HEAD(program, prog_size, index, index_start);
+        u8 bit_index = program[index + size];
+        if (bit_index > 7) return INVALID_INSTRUCTION;
+        u8 x = 0;
+        bool error = get_u8(memory, address, x);
+        if (error) return INVALID_MEMORY_ADDRESS;
+        bit = (x >> bit_index) & 1;
+        index += size + 1;
+        return STATUS_SUCCESS;
+    }
+
+    // Read [ address, u8 bit ] operand and write the given bit to it
+    RuntimeError fused_write_bit(u8* memory, u8* program, u32 prog_size, u32& index, u8 bit) {
+        READ_ADDRESS_FROM_MEMORY;
+        if (index + size + 1 > prog_size) return CHECK_PROGRAM_POINTER_BOUNDS_HEAD(program, prog_size, index, index_start);
+        u8 bit_index = program[index + size];
+        if (bit_index > 7) return INVALID_INSTRUCTION;
+        u8 x = 0;
+        bool error = get_u8(memory, address, x);
+        if (error) return INVALID_MEMORY_ADDRESS;
+        x = bit ? x | 1 << bit_index : x & ~(1 << bit_index);
+        error = set_u8(memory, address, x);
+        if (error) return INVALID_MEMORY_ADDRESS;
+        index += size + 1;
+        return STATUS_SUCCESS;
+    }
+
+    // READ_X8_Bn + LOGIC_AND
+    RuntimeError READ_AND_X8(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        u8 bit = 0;
+        RuntimeError status = fused_read_bit(memory, program, prog_size, index, bit);
+        if (status != STATUS_SUCCESS) return status;
+        if (stack.size() < 1) return STACK_UNDERFLOW; // The LOGIC_AND/LOGIC_OR this replaces would underflow
+        u8 a = stack.pop_u8() != 0;
+        return stack.push_u8(a && bit);
+    }
+
+    // READ_X8_Bn + LOGIC_OR
+    RuntimeError READ_OR_X8(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        u8 bit = 0;
+        RuntimeError status = fused_read_bit(memory, program, prog_size, index, bit);
+        if (status != STATUS_SUCCESS) return status;
+        if (stack.size() < 1) return STACK_UNDERFLOW;
+        u8 a = stack.pop_u8() != 0;
+        return stack.push_u8(a || bit);
+    }
+
+    // READ_X8_Bn + LOGIC_AND + WRITE_X8_Bn
+    RuntimeError READ_AND_WRITE_X8(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        u8 bit = 0;
+        RuntimeError status = fused_read_bit(memory, program, prog_size, index, bit);
+        if (status != STATUS_SUCCESS) return status;
+        if (stack.size() < 1) return STACK_UNDERFLOW;
+        u8 a = stack.pop_u8() != 0;
+        return fused_write_bit(memory, program, prog_size, index, a && bit);
+    }
+
+    // Push the typed immediate that follows in the bytecode
+    RuntimeError fused_push_value(RuntimeStack& stack, u8 data_type, u8* program, u32 prog_size, u32& index) {
+        switch (data_type) {
+            case type_bool:
+            case type_u8: return push_u8(stack, program, prog_size, index);
+            case type_i8: return push_i8(stack, program, prog_size, index);
+            case type_u16: return push_u16(stack, program, prog_size, index);
+            case type_i16: return push_i16(stack, program, prog_size, index);
+#ifdef PLCRUNTIME_32BIT_OPS_ENABLED
+            case type_u32: return push_u32(stack, program, prog_size, index);
+            case type_i32: return push_i32(stack, program, prog_size, index);
+#endif // PLCRUNTIME_32BIT_OPS_ENABLED
+#ifdef PLCRUNTIME_FLOAT_OPS_ENABLED
+            case type_f32: return push_f32(stack, program, prog_size, index);
+#endif // PLCRUNTIME_FLOAT_OPS_ENABLED
+#ifdef USE_X64_OPS
+            case type_u64: return push_u64(stack, program, prog_size, index);
+            case type_i64: return push_i64(stack, program, prog_size, index);
+            case type_f64: return push_f64(stack, program, prog_size, index);
+#endif // USE_X64_OPS
+            default: return INVALID_DATA_TYPE;
+        }
+    }
+
+    // LOAD_FROM + <type> const + CMP_xx
+    // The comparison handlers read their type byte at `type_index`, which is the type byte of this instruction
+    RuntimeError LOAD_CMP_IMM(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        IGNORE_UNUSED u32 index_start = index;
+        if (index + 2 > prog_size) return CHECK_PROGRAM_POINTER_BOUNDS_HEAD(program, prog_size, index, index_start);
+        u8 cmp_opcode = program[index++];
+        u32 type_index = index;
+        u8 data_type = program[type_index];
+        RuntimeError status = LOAD_FROM(stack, memory, program, prog_size, index);
+        if (status != STATUS_SUCCESS) return status;
+        status = fused_push_value(stack, data_type, program, prog_size, index);
+        if (status != STATUS_SUCCESS) return status;
+        switch (cmp_opcode) {
+            case CMP_EQ: return handle_CMP_EQ(stack, program, prog_size, type_index);
+            case CMP_NEQ: return handle_CMP_NEQ(stack, program, prog_size, type_index);
+            case CMP_GT: return handle_CMP_GT(stack, program, prog_size, type_index);
+            case CMP_GTE: return handle_CMP_GTE(stack, program, prog_size, type_index);
+            case CMP_LT: return handle_CMP_LT(stack, program, prog_size, type_index);
+            case CMP_LTE: return handle_CMP_LTE(stack, program, prog_size, type_index);
+            default: return INVALID_INSTRUCTION;
+        }
+    }
+
+    // LOAD_FROM + <type> const + CMP_xx + JMP_IF_NOT
+    RuntimeError LOAD_CMP_IMM_JMP_IF_NOT(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+        RuntimeError status = LOAD_CMP_IMM(stack, memory, program, prog_size, index);
+        if (status != STATUS_SUCCESS) return status;
+        return handle_JMP_IF_NOT(stack, program, prog_size, index);
+    }
+
+}
@@ -62,21 +62,21 @@ namespace PLCMethods {
         memory[address + 3] = converter.u8A[3];
     }
 
-    void logic_TON(u8* memory, MY_PTR_t timer_ptr, u32 PT, bool IN, bool& Q_out) {
+    void logic_TON(u8* memory, u32 now, MY_PTR_t timer_ptr, u32 PT, bool IN, bool& Q_out) {
         u8 flags = memory[timer_ptr + TIMER_OFFSET_FLAGS];
         u32 start_time = read_u32_from_mem(memory, timer_ptr + TIMER_OFFSET_START);
         u32 et = 0;
 
         // DEBUG
-        // Serial.printf("TON: IN=%d, Flags=%02X, Start=%u, Now=%u, PT=%u\n", IN, flags, start_time, interval_millis_now, PT);
+        // Serial.printf("TON: IN=%d, Flags=%02X, Start=%u, Now=%u, PT=%u\n", IN, flags, start_time, now, PT);
 
         if (IN) {
             if (!(flags & TIMER_FLAG_RUNNING)) {
-                start_time = interval_millis_now;
+                start_time = now;
                 flags |= TIMER_FLAG_RUNNING;
                 write_u32_to_mem(memory, timer_ptr + TIMER_OFFSET_START, start_time);
             }
-            et = interval_millis_now - start_time;
+            et = now - start_time;
             if (et >= PT) {
                 flags |= TIMER_FLAG_Q;
                 et = PT;
@@ -93,7 +93,7 @@ namespace PLCMethods {
         Q_out = (flags & TIMER_FLAG_Q) ? true : false;
     }
 
-    void logic_TOF(u8* memory, MY_PTR_t timer_ptr, u32 PT, bool IN, bool& Q_out) {
+    void logic_TOF(u8* memory, u32 now, MY_PTR_t timer_ptr, u32 PT, bool IN, bool& Q_out) {
         u8 flags = memory[timer_ptr + TIMER_OFFSET_FLAGS];
 
         bool prev_IN = (flags & TIMER_FLAG_IN_OLD) ? true : false;
@@ -108,12 +108,12 @@ namespace PLCMethods {
         } else {
             if (prev_IN) { // Falling Edge
                 running = true;
-                start_time = interval_millis_now;
+                start_time = now;
                 write_u32_to_mem(memory, timer_ptr + TIMER_OFFSET_START, start_time);
             }
 
             if (running) {
-                et = interval_millis_now - start_time;
+                et = now - start_time;
                 if (et >= PT) {
                     running = false;
                     et = PT;
@@ -136,7 +136,7 @@ namespace PLCMethods {
         memory[timer_ptr + TIMER_OFFSET_FLAGS] = flags;
     }
 
-    void logic_TP(u8* memory, MY_PTR_t timer_ptr, u32 PT, bool IN, bool& Q_out) {
+    void logic_TP(u8* memory, u32 now, MY_PTR_t timer_ptr, u32 PT, bool IN, bool& Q_out) {
         u8 flags = memory[timer_ptr + TIMER_OFFSET_FLAGS];
 
         bool prev_IN = (flags & TIMER_FLAG_IN_OLD) ? true : false;
@@ -146,12 +146,12 @@ namespace PLCMethods {
 
         if (!prev_IN && IN && !running) {
             running = true;
-            start_time = interval_millis_now;
+            start_time = now;
             write_u32_to_mem(memory, timer_ptr + TIMER_OFFSET_START, start_time);
         }
 
         if (running) {
-            et = interval_millis_now - start_time;
+            et = now - start_time;
             if (et >= PT) {
                 running = false;
                 et = PT;
@@ -176,7 +176,7 @@ namespace PLCMethods {
 
 
     // TON_CONST
-    RuntimeError handle_TON_CONST(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError handle_TON_CONST(RuntimeStack& stack, u8* memory, u32 now, u8* program, u32 prog_size, u32& index) {
         MY_PTR_t timer_ptr = 0;
         RuntimeError err = ProgramExtract.type_pointer(program, prog_size, index, &timer_ptr);
         if (err != STATUS_SUCCESS) return err;
@@ -190,12 +190,12 @@ namespace PLCMethods {
         if (timer_ptr + TIMER_STRUCT_SIZE > PLCRUNTIME_MAX_MEMORY_SIZE) return MEMORY_ACCESS_ERROR;
 
         bool Q = false;
-        logic_TON(memory, timer_ptr, PT, IN, Q);
+        logic_TON(memory, now, timer_ptr, PT, IN, Q);
         return stack.push_bool(Q);
     }
 
     // TON_MEM
-    RuntimeError handle_TON_MEM(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError handle_TON_MEM(RuntimeStack& stack, u8* memory, u32 now, u8* program, u32 prog_size, u32& index) {
         MY_PTR_t timer_ptr = 0;
         RuntimeError err = ProgramExtract.type_pointer(program, prog_size, index, &timer_ptr);
         if (err != STATUS_SUCCESS) return err;
@@ -212,12 +212,12 @@ namespace PLCMethods {
         if (timer_ptr + TIMER_STRUCT_SIZE > PLCRUNTIME_MAX_MEMORY_SIZE) return MEMORY_ACCESS_ERROR;
 
         bool Q = false;
-        logic_TON(memory, timer_ptr, PT, IN, Q);
+        logic_TON(memory, now, timer_ptr, PT, IN, Q);
         return stack.push_bool(Q);
     }
 
     // TOF_CONST
-    RuntimeError handle_TOF_CONST(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError handle_TOF_CONST(RuntimeStack& stack, u8* memory, u32 now, u8* program, u32 prog_size, u32& index) {
         MY_PTR_t timer_ptr = 0;
         RuntimeError err = ProgramExtract.type_pointer(program, prog_size, index, &timer_ptr);
         if (err != STATUS_SUCCESS) return err;
@@ -231,12 +231,12 @@ namespace PLCMethods {
         if (timer_ptr + TIMER_STRUCT_SIZE > PLCRUNTIME_MAX_MEMORY_SIZE) return MEMORY_ACCESS_ERROR;
 
         bool Q = false;
-        logic_TOF(memory, timer_ptr, PT, IN, Q);
+        logic_TOF(memory, now, timer_ptr, PT, IN, Q);
         return stack.push_bool(Q);
     }
 
     // TOF_MEM
-    RuntimeError handle_TOF_MEM(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError handle_TOF_MEM(RuntimeStack& stack, u8* memory, u32 now, u8* program, u32 prog_size, u32& index) {
         MY_PTR_t timer_ptr = 0;
         RuntimeError err = ProgramExtract.type_pointer(program, prog_size, index, &timer_ptr);
         if (err != STATUS_SUCCESS) return err;
@@ -253,12 +253,12 @@ namespace PLCMethods {
         if (timer_ptr + TIMER_STRUCT_SIZE > PLCRUNTIME_MAX_MEMORY_SIZE) return MEMORY_ACCESS_ERROR;
 
         bool Q = false;
-        logic_TOF(memory, timer_ptr, PT, IN, Q);
+        logic_TOF(memory, now, timer_ptr, PT, IN, Q);
         return stack.push_bool(Q);
     }
 
     // TP_CONST
-    RuntimeError handle_TP_CONST(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError handle_TP_CONST(RuntimeStack& stack, u8* memory, u32 now, u8* program, u32 prog_size, u32& index) {
         MY_PTR_t timer_ptr = 0;
         RuntimeError err = ProgramExtract.type_pointer(program, prog_size, index, &timer_ptr);
         if (err != STATUS_SUCCESS) return err;
@@ -272,12 +272,12 @@ namespace PLCMethods {
         if (timer_ptr + TIMER_STRUCT_SIZE > PLCRUNTIME_MAX_MEMORY_SIZE) return MEMORY_ACCESS_ERROR;
 
         bool Q = false;
-        logic_TP(memory, timer_ptr, PT, IN, Q);
+        logic_TP(memory, now, timer_ptr, PT, IN, Q);
         return stack.push_bool(Q);
     }
 
     // TP_MEM
-    RuntimeError handle_TP_MEM(RuntimeStack& stack, u8* memory, u8* program, u32 prog_size, u32& index) {
+    RuntimeError handle_TP_MEM(RuntimeStack& stack, u8* memory, u32 now, u8* program, u32 prog_size, u32& index) {
         MY_PTR_t timer_ptr = 0;
         RuntimeError err = ProgramExtract.type_pointer(program, prog_size, index, &timer_ptr);
         if (err != STATUS_SUCCESS) return err;
@@ -294,7 +294,7 @@ namespace PLCMethods {
         if (timer_ptr + TIMER_STRUCT_SIZE > PLCRUNTIME_MAX_MEMORY_SIZE) return MEMORY_ACCESS_ERROR;
 
         bool Q = false;
-        logic_TP(memory, timer_ptr, PT, IN, Q);
+        logic_TP(memory, now, timer_ptr, PT, IN, Q);
         return stack.push_bool(Q);
     }
 }
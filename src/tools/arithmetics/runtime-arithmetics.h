@@ -472,3 +472,4 @@ RuntimeError handle_ABS(RuntimeStack& stack, u8* program, u32 prog_size, u32& in
 
 }
 
+#include "methods-fused.h"
@@ -104,8 +104,6 @@ struct Extract_t {
 #endif
 } ProgramExtract;
 
-RuntimeError extract_status;
-
 
 RuntimeError printOpcodeAt(const u8* program, u32 size, u32 index) {
     if (index >= size) return INVALID_PROGRAM_INDEX;
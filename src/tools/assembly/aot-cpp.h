@@ -0,0 +1,169 @@
+// aot-cpp.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+#include "../runtime-verifier.h"
+
+// ============================================================================
+// Ahead-of-time translator: bytecode -> C++ source
+// ============================================================================
+// Emits the bytecode together with a native function that runs it, in the form
+// described in runtime-aot.h. Every instruction becomes a PLC_AOT_OP() with its
+// opcode as a constant. Jump and call targets get labels; a branch instruction
+// is followed by a goto taken when its handler moved the index, so the handlers
+// keep their exact semantics (stack checks, call stack, error codes). RET goes
+// through a switch over the return sites of the program.
+//
+// The program must pass plc_check_program_structure(). All state is stored in
+// bare globals for WASM safety.
+// ============================================================================
+
+#define AOT_NAME_MAX 64
+
+char g_aot_name[AOT_NAME_MAX] = "plc_program";
+const char* g_aot_error = "";
+u8 g_aot_starts[(PLCRUNTIME_MAX_PROGRAM_SIZE + 7) / 8];
+u8 g_aot_labels[(PLCRUNTIME_MAX_PROGRAM_SIZE + 7) / 8];   // Jump and call targets
+u8 g_aot_returns[(PLCRUNTIME_MAX_PROGRAM_SIZE + 7) / 8];  // Return sites (instruction after a call)
+
+inline bool aot_bit(const u8* bits, u32 index) { return bits[index >> 3] & (1 << (index & 7)); }
+inline void aot_set_bit(u8* bits, u32 index) { bits[index >> 3] |= (u8) (1 << (index & 7)); }
+
+// Set the name used for the generated symbols, false if it is not a C identifier
+bool aot_set_name(const char* name) {
+    u32 len = 0;
+    while (name[len]) {
+        char c = name[len];
+        bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+        bool digit = c >= '0' && c <= '9';
+        if (!alpha && !(digit && len > 0)) return false;
+        if (++len >= AOT_NAME_MAX) return false;
+    }
+    if (len == 0) return false;
+    for (u32 i = 0; i <= len; i++) g_aot_name[i] = name[i];
+    return true;
+}
+
+// Static target of a branch instruction, false for other instructions and for
+// CALL_IF/CALL_IF_NOT without a target (their handler reports the error)
+bool aot_branch_target(const u8* bytecode, u32 index, u32 size, u32& target) {
+    u8 opcode = bytecode[index];
+    if (opcode >= JMP && opcode <= CALL_IF_NOT) target = read_u16(bytecode + index + 1);
+    else if (opcode >= JMP_REL && opcode <= CALL_IF_NOT_REL) target = (u32) ((i32) (index + 3) + read_i16(bytecode + index + 1));
+    else if (opcode == LOAD_CMP_IMM_JMP_IF_NOT) target = read_u16(bytecode + index + size - 2);
+    else return false;
+    return !(target == 0 && (opcode == CALL_IF || opcode == CALL_IF_NOT));
+}
+
+bool aot_is_call(u8 opcode) {
+    return (opcode >= CALL && opcode <= CALL_IF_NOT) || (opcode >= CALL_REL && opcode <= CALL_IF_NOT_REL);
+}
+
+// Print the C++ source for `bytecode` to stdout, false with g_aot_error set on failure
+bool aot_translate(const u8* bytecode, u32 size) {
+    g_aot_error = "";
+    if (!bytecode || size == 0) {
+        g_aot_error = "Empty program";
+        return false;
+    }
+    if (plc_check_program_structure(bytecode, size, g_aot_starts) != STATUS_SUCCESS) {
+        g_aot_error = "Invalid program structure (unknown instruction or jump target)";
+        return false;
+    }
+
+    // Labels and return sites
+    const u32 bitmap_size = (size + 7) / 8;
+    for (u32 i = 0; i < bitmap_size; i++) {
+        g_aot_labels[i] = 0;
+        g_aot_returns[i] = 0;
+    }
+    bool has_ret = false;
+    for (u32 index = 0; index < size;) {
+        u8 opcode = bytecode[index];
+        u32 length = INSTRUCTION_SIZE(bytecode, size, index);
+        u32 target = 0;
+        if (aot_branch_target(bytecode, index, length, target)) aot_set_bit(g_aot_labels, target);
+        if (aot_is_call(opcode) && index + length < size) {
+            aot_set_bit(g_aot_labels, index + length);
+            aot_set_bit(g_aot_returns, index + length);
+        }
+        if (opcode == RET || opcode == RET_IF || opcode == RET_IF_NOT) has_ret = true;
+        index += length;
+    }
+
+    const char* name = g_aot_name;
+    u8 checksum = 0;
+    crc8_simple(checksum, bytecode, size);
+    u32 crc = crc32_update(0, bytecode, size);
+
+    printf("// %s.h - generated by `npm run aot` from a %u byte program, do not edit\n", name, size);
+    printf("//\n");
+    printf("// Include after VovkPLCRuntime.h and load with runtime.loadNativeProgram(%s)\n\n", name);
+    printf("#pragma once\n\n");
+
+    printf("static const u8 %s_bytecode[%u] = {", name, size);
+    for (u32 i = 0; i < size; i++) {
+        if (i % 16 == 0) printf("\n   ");
+        printf(" 0x%02X,", bytecode[i]);
+    }
+    printf("\n};\n\n");
+
+    printf("static RuntimeError %s_entry(VovkPLCRuntime& rt, u32& index) {\n", name);
+    printf("    u8* const program = rt.program.program;\n");
+    printf("    const u32 prog_size = rt.program.prog_size;\n");
+    printf("    RuntimeError status = STATUS_SUCCESS;\n");
+    for (u32 index = 0; index < size;) {
+        u8 opcode = bytecode[index];
+        u32 length = INSTRUCTION_SIZE(bytecode, size, index);
+        u32 next = index + length;
+        if (aot_bit(g_aot_labels, index)) printf("at_%u:\n", index);
+        printf("    PLC_AOT_OP(%u, 0x%02X) // %s\n", index, opcode, (const char*) OPCODE_NAME((PLCRuntimeInstructionSet) opcode));
+        u32 target = 0;
+        if (opcode == RET) printf("    goto ret;\n");
+        else if (opcode == RET_IF || opcode == RET_IF_NOT) printf("    if (index != %u) goto ret;\n", next);
+        else if (aot_branch_target(bytecode, index, length, target)) {
+            bool always = opcode == JMP || opcode == JMP_REL || opcode == CALL || opcode == CALL_REL;
+            if (always) printf("    goto at_%u;\n", target);
+            else if (target != next) printf("    if (index != %u) goto at_%u;\n", next, target);
+        }
+        index = next;
+    }
+    printf("    index = prog_size;\n");
+    printf("    return STATUS_SUCCESS;\n");
+    if (has_ret) {
+        printf("ret:\n");
+        printf("    switch (index) {\n");
+        for (u32 index = 0; index < size; index++) {
+            if (aot_bit(g_aot_returns, index)) printf("        case %u: goto at_%u;\n", index, index);
+        }
+        printf("        default: return STATUS_SUCCESS; // The interpreter continues at `index`\n");
+        printf("    }\n");
+    }
+    printf("}\n\n");
+
+    printf("static const PLCAotProgram %s = { %s_entry, %s_bytecode, %u, 0x%02X, 0x%08Xu };\n", name, name, name, size, checksum, crc);
+    return true;
+}
+
+#endif // __WASM__
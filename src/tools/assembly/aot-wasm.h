@@ -0,0 +1,719 @@
+// aot-wasm.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+#include "aot-cpp.h"
+
+// ============================================================================
+// Ahead-of-time translator: bytecode -> WebAssembly module
+// ============================================================================
+// Used by the simulator to run a loaded program as native WebAssembly instead of
+// interpreting it inside the WASM build. The module has one import section:
+//
+//     env.memory  the simulator's linear memory (runtime memory and data stack)
+//     env.step    (runtime, index*) -> status, executes the instruction at *index
+//
+// and exports `run`, a PLCAotEntry (runtime-aot.h). The worker instantiates it,
+// stores `run` in the simulator's function table and binds it to the runtime,
+// so run() calls it every cycle in place of the interpreter loop.
+//
+// Constants, memory loads and stores, bit access, boolean logic, typed ADD/SUB/
+// MUL and comparisons up to 32 bits and jumps are emitted as WebAssembly working
+// directly on the runtime memory and data stack. Every other instruction (timers,
+// strings, FFI, COMMS, calls, ...) goes through env.step, which runs the regular
+// handler, so its behaviour is exactly the interpreter's. Control flow is a loop
+// over a br_table with one block per jump target and return site.
+//
+// The addresses of the runtime state are embedded, so a module is only valid for
+// the simulator instance it was translated in. All state is stored in bare
+// globals for WASM safety.
+// ============================================================================
+
+#ifndef PLCRUNTIME_AOT_WASM_MAX_MODULE
+#define PLCRUNTIME_AOT_WASM_MAX_MODULE (PLCRUNTIME_MAX_PROGRAM_SIZE * 12)
+#endif // PLCRUNTIME_AOT_WASM_MAX_MODULE
+
+#define AOT_WASM_MAX_BLOCKS 65520 // br_table size limit of the engines
+
+// Linear memory addresses of the runtime state used by the generated code
+struct AotWasmLayout {
+    u32 memory;      // VovkPLCRuntime::memory
+    u32 stack_data;  // Data stack bytes (Stack<u8>::_data)
+    u32 stack_max;   // Stack<u8>::MAX_STACK_SIZE
+    u32 stack_size;  // Stack<u8>::_size
+};
+
+u8 g_aot_wasm_module[PLCRUNTIME_AOT_WASM_MAX_MODULE];
+u32 g_aot_wasm_length = 0;
+bool g_aot_wasm_overflow = false;
+u16 g_aot_wasm_block[PLCRUNTIME_MAX_PROGRAM_SIZE]; // Block of each label
+u32 g_aot_wasm_blocks = 0;                          // Blocks in the dispatch loop
+u32 g_aot_wasm_current = 0;                         // Block being emitted
+u32 g_aot_wasm_native = 0;                          // Instructions emitted as WebAssembly
+u32 g_aot_wasm_fallback = 0;                        // Instructions executed through env.step
+AotWasmLayout g_aot_wasm_layout;
+
+// Program the module was translated from, used to bind it (see runtime-aot.h)
+u32 g_aot_wasm_size = 0;
+u32 g_aot_wasm_crc = 0;
+u8 g_aot_wasm_checksum = 0;
+
+// Locals of the generated function
+enum AotWasmLocal {
+    AOTW_RT = 0,    // Parameter: runtime
+    AOTW_INDEX,     // Parameter: u32* index
+    AOTW_SP,        // Cached data stack size
+    AOTW_A,
+    AOTW_B,
+    AOTW_PC,        // Block to dispatch to
+    AOTW_FA,
+    AOTW_FB,
+};
+
+// WebAssembly opcodes used by the translator
+enum AotWasmOpcode {
+    AOTW_UNREACHABLE = 0x00,
+    AOTW_BLOCK = 0x02,
+    AOTW_LOOP = 0x03,
+    AOTW_IF = 0x04,
+    AOTW_ELSE = 0x05,
+    AOTW_END = 0x0B,
+    AOTW_BR = 0x0C,
+    AOTW_BR_TABLE = 0x0E,
+    AOTW_RETURN = 0x0F,
+    AOTW_CALL = 0x10,
+    AOTW_LOCAL_GET = 0x20,
+    AOTW_LOCAL_SET = 0x21,
+    AOTW_LOCAL_TEE = 0x22,
+    AOTW_I32_LOAD = 0x28,
+    AOTW_F32_LOAD = 0x2A,
+    AOTW_I32_LOAD8_S = 0x2C,
+    AOTW_I32_LOAD8_U = 0x2D,
+    AOTW_I32_LOAD16_S = 0x2E,
+    AOTW_I32_LOAD16_U = 0x2F,
+    AOTW_I32_STORE = 0x36,
+    AOTW_F32_STORE = 0x38,
+    AOTW_I32_STORE8 = 0x3A,
+    AOTW_I32_STORE16 = 0x3B,
+    AOTW_I32_CONST = 0x41,
+    AOTW_I32_EQZ = 0x45,
+    AOTW_I32_EQ = 0x46,
+    AOTW_I32_NE = 0x47,
+    AOTW_I32_LT_S = 0x48,
+    AOTW_I32_LT_U = 0x49,
+    AOTW_I32_GT_S = 0x4A,
+    AOTW_I32_GT_U = 0x4B,
+    AOTW_I32_LE_S = 0x4C,
+    AOTW_I32_LE_U = 0x4D,
+    AOTW_I32_GE_S = 0x4E,
+    AOTW_I32_GE_U = 0x4F,
+    AOTW_F32_EQ = 0x5B,
+    AOTW_F32_NE = 0x5C,
+    AOTW_F32_LT = 0x5D,
+    AOTW_F32_GT = 0x5E,
+    AOTW_F32_LE = 0x5F,
+    AOTW_F32_GE = 0x60,
+    AOTW_I32_ADD = 0x6A,
+    AOTW_I32_SUB = 0x6B,
+    AOTW_I32_MUL = 0x6C,
+    AOTW_I32_AND = 0x71,
+    AOTW_I32_OR = 0x72,
+    AOTW_I32_XOR = 0x73,
+    AOTW_I32_SHR_U = 0x76,
+    AOTW_F32_ADD = 0x92,
+    AOTW_F32_SUB = 0x93,
+    AOTW_F32_MUL = 0x94,
+};
+
+#define AOTW_VOID 0x40
+#define AOTW_TYPE_I32 0x7F
+#define AOTW_TYPE_F32 0x7D
+
+// ---- Byte emitters ----
+
+void aotw_byte(u8 b) {
+    if (g_aot_wasm_length < PLCRUNTIME_AOT_WASM_MAX_MODULE) g_aot_wasm_module[g_aot_wasm_length++] = b;
+    else g_aot_wasm_overflow = true;
+}
+
+void aotw_uleb(u32 value) {
+    do {
+        u8 b = value & 0x7F;
+        value >>= 7;
+        if (value) b |= 0x80;
+        aotw_byte(b);
+    } while (value);
+}
+
+void aotw_sleb(i32 value) {
+    bool more = true;
+    while (more) {
+        u8 b = value & 0x7F;
+        value >>= 7;
+        if ((value == 0 && !(b & 0x40)) || (value == -1 && (b & 0x40))) more = false;
+        else b |= 0x80;
+        aotw_byte(b);
+    }
+}
+
+void aotw_name(const char* name) {
+    u32 len = 0;
+    while (name[len]) len++;
+    aotw_uleb(len);
+    for (u32 i = 0; i < len; i++) aotw_byte((u8) name[i]);
+}
+
+// Reserve a 5 byte LEB128 size, filled in by aotw_patch() once the content is emitted
+u32 aotw_reserve() {
+    u32 at = g_aot_wasm_length;
+    for (u32 i = 0; i < 5; i++) aotw_byte(0);
+    return at;
+}
+
+void aotw_patch(u32 at) {
+    if (g_aot_wasm_overflow) return;
+    u32 value = g_aot_wasm_length - at - 5;
+    for (u32 i = 0; i < 5; i++) {
+        g_aot_wasm_module[at + i] = (u8) ((value & 0x7F) | (i < 4 ? 0x80 : 0));
+        value >>= 7;
+    }
+}
+
+// ---- Instruction emitters ----
+
+void aotw_op(u8 opcode) { aotw_byte(opcode); }
+void aotw_i32(i32 value) { aotw_byte(AOTW_I32_CONST); aotw_sleb(value); }
+void aotw_local(u8 opcode, u8 local) { aotw_byte(opcode); aotw_uleb(local); }
+void aotw_mem(u8 opcode, u32 offset) { aotw_byte(opcode); aotw_uleb(0); aotw_uleb(offset); } // Unaligned access
+
+// Write the cached stack size back to the runtime
+void aotw_sync() {
+    aotw_i32(0);
+    aotw_local(AOTW_LOCAL_GET, AOTW_SP);
+    aotw_mem(AOTW_I32_STORE, g_aot_wasm_layout.stack_size);
+}
+
+void aotw_reload() {
+    aotw_i32(0);
+    aotw_mem(AOTW_I32_LOAD, g_aot_wasm_layout.stack_size);
+    aotw_local(AOTW_LOCAL_SET, AOTW_SP);
+}
+
+// Leave the function with `status`, the stack is left like the interpreter would
+void aotw_fail(RuntimeError status) {
+    aotw_sync();
+    aotw_i32(status);
+    aotw_op(AOTW_RETURN);
+}
+
+// Continue at `block` through the dispatch loop, `nesting` counts the open if blocks
+void aotw_goto(u32 block, u32 nesting) {
+    aotw_i32((i32) block);
+    aotw_local(AOTW_LOCAL_SET, AOTW_PC);
+    aotw_op(AOTW_BR);
+    aotw_uleb(g_aot_wasm_blocks - 1 - g_aot_wasm_current + nesting);
+}
+
+// Underflow check for `bytes` popped from the data stack
+void aotw_need(u32 bytes) {
+    aotw_local(AOTW_LOCAL_GET, AOTW_SP);
+    aotw_i32((i32) bytes);
+    aotw_op(AOTW_I32_LT_U);
+    aotw_op(AOTW_IF); aotw_byte(AOTW_VOID);
+    aotw_fail(STACK_UNDERFLOW);
+    aotw_op(AOTW_END);
+}
+
+// Overflow check for `bytes` pushed to the data stack
+void aotw_room(u32 bytes) {
+    aotw_local(AOTW_LOCAL_GET, AOTW_SP);
+    aotw_i32((i32) bytes);
+    aotw_op(AOTW_I32_ADD);
+    aotw_i32(0);
+    aotw_mem(AOTW_I32_LOAD, g_aot_wasm_layout.stack_max);
+    aotw_op(AOTW_I32_GT_U);
+    aotw_op(AOTW_IF); aotw_byte(AOTW_VOID);
+    aotw_fail(STACK_OVERFLOW);
+    aotw_op(AOTW_END);
+}
+
+// Pop `bytes` from the data stack leaving the value on the WebAssembly stack
+void aotw_pop(u8 load, u32 bytes) {
+    aotw_local(AOTW_LOCAL_GET, AOTW_SP);
+    aotw_i32((i32) bytes);
+    aotw_op(AOTW_I32_SUB);
+    aotw_local(AOTW_LOCAL_TEE, AOTW_SP);
+    aotw_mem(load, g_aot_wasm_layout.stack_data);
+}
+
+// Store the value on the WebAssembly stack to the top of the data stack.
+// The address must be pushed first, see aotw_push_begin()
+void aotw_push_begin() { aotw_local(AOTW_LOCAL_GET, AOTW_SP); }
+void aotw_push_end(u8 store, u32 bytes) {
+    aotw_mem(store, g_aot_wasm_layout.stack_data);
+    aotw_local(AOTW_LOCAL_GET, AOTW_SP);
+    aotw_i32((i32) bytes);
+    aotw_op(AOTW_I32_ADD);
+    aotw_local(AOTW_LOCAL_SET, AOTW_SP);
+}
+
+// ---- Data types ----
+
+struct AotWasmType {
+    u8 width;
+    u8 load;   // Load to an i32/f32 value
+    u8 store;
+    bool is_float;
+    bool is_signed;
+};
+
+// Types handled natively, false for 64-bit, pointer and invalid types
+bool aotw_type(u8 data_type, AotWasmType& t) {
+    switch (data_type) {
+        case type_bool:
+        case type_u8: t = { 1, AOTW_I32_LOAD8_U, AOTW_I32_STORE8, false, false }; return true;
+        case type_i8: t = { 1, AOTW_I32_LOAD8_S, AOTW_I32_STORE8, false, true }; return true;
+        case type_u16: t = { 2, AOTW_I32_LOAD16_U, AOTW_I32_STORE16, false, false }; return true;
+        case type_i16: t = { 2, AOTW_I32_LOAD16_S, AOTW_I32_STORE16, false, true }; return true;
+        case type_u32: t = { 4, AOTW_I32_LOAD, AOTW_I32_STORE, false, false }; return true;
+        case type_i32: t = { 4, AOTW_I32_LOAD, AOTW_I32_STORE, false, true }; return true;
+        case type_f32: t = { 4, AOTW_F32_LOAD, AOTW_F32_STORE, true, true }; return true;
+        default: return false;
+    }
+}
+
+u8 aotw_arith_op(u8 opcode, bool is_float) {
+    switch (opcode) {
+        case ADD: return is_float ? AOTW_F32_ADD : AOTW_I32_ADD;
+        case SUB: return is_float ? AOTW_F32_SUB : AOTW_I32_SUB;
+        default: return is_float ? AOTW_F32_MUL : AOTW_I32_MUL;
+    }
+}
+
+u8 aotw_compare_op(u8 opcode, const AotWasmType& t) {
+    switch (opcode) {
+        case CMP_EQ: return t.is_float ? AOTW_F32_EQ : AOTW_I32_EQ;
+        case CMP_NEQ: return t.is_float ? AOTW_F32_NE : AOTW_I32_NE;
+        case CMP_GT: return t.is_float ? AOTW_F32_GT : t.is_signed ? AOTW_I32_GT_S : AOTW_I32_GT_U;
+        case CMP_GTE: return t.is_float ? AOTW_F32_GE : t.is_signed ? AOTW_I32_GE_S : AOTW_I32_GE_U;
+        case CMP_LT: return t.is_float ? AOTW_F32_LT : t.is_signed ? AOTW_I32_LT_S : AOTW_I32_LT_U;
+        default: return t.is_float ? AOTW_F32_LE : t.is_signed ? AOTW_I32_LE_S : AOTW_I32_LE_U;
+    }
+}
+
+// ---- Instructions ----
+
+// Emit the instruction at `index` as WebAssembly, false to leave it to env.step
+bool aotw_native(const u8* bytecode, u32 index, u32 length) {
+    const u8 opcode = bytecode[index];
+    const u8* p = bytecode + index + 1;
+    const u32 memory = g_aot_wasm_layout.memory;
+
+    if (opcode >= READ_X8_B0 && opcode <= WRITE_INV_X8_B7) {
+        u32 address = read_ptr(p);
+        if (address >= PLCRUNTIME_MAX_MEMORY_SIZE) return false;
+        u8 group = (opcode - READ_X8_B0) / 8;
+        u8 bit = (opcode - READ_X8_B0) % 8;
+        u8 mask = (u8) (1 << bit);
+        if (group == 0) { // READ: push (byte >> bit) & 1
+            aotw_room(1);
+            aotw_push_begin();
+            aotw_i32(0);
+            aotw_mem(AOTW_I32_LOAD8_U, memory + address);
+            aotw_i32(bit);
+            aotw_op(AOTW_I32_SHR_U);
+            aotw_i32(1);
+            aotw_op(AOTW_I32_AND);
+            aotw_push_end(AOTW_I32_STORE8, 1);
+            return true;
+        }
+        if (group == 1) { // WRITE: pop the bit value
+            aotw_need(1);
+            aotw_pop(AOTW_I32_LOAD8_U, 1);
+            aotw_local(AOTW_LOCAL_SET, AOTW_A);
+            aotw_i32(0);
+            aotw_local(AOTW_LOCAL_GET, AOTW_A);
+            aotw_op(AOTW_IF); aotw_byte(AOTW_TYPE_I32);
+            aotw_i32(0);
+            aotw_mem(AOTW_I32_LOAD8_U, memory + address);
+            aotw_i32(mask);
+            aotw_op(AOTW_I32_OR);
+            aotw_op(AOTW_ELSE);
+            aotw_i32(0);
+            aotw_mem(AOTW_I32_LOAD8_U, memory + address);
+            aotw_i32((u8) ~mask);
+            aotw_op(AOTW_I32_AND);
+            aotw_op(AOTW_END);
+            aotw_mem(AOTW_I32_STORE8, memory + address);
+            return true;
+        }
+        // WRITE_S, WRITE_R, WRITE_INV
+        aotw_i32(0);
+        aotw_i32(0);
+        aotw_mem(AOTW_I32_LOAD8_U, memory + address);
+        aotw_i32(group == 3 ? (u8) ~mask : mask);
+        aotw_op(group == 2 ? AOTW_I32_OR : group == 3 ? AOTW_I32_AND : AOTW_I32_XOR);
+        aotw_mem(AOTW_I32_STORE8, memory + address);
+        return true;
+    }
+
+    AotWasmType t;
+    switch (opcode) {
+        case NOP:
+        case LANG:
+        case COMMENT: return true;
+
+        case EXIT:
+            aotw_fail(PROGRAM_EXITED);
+            return true;
+
+        case type_bool:
+        case type_u8:
+        case type_i8:
+        case type_u16:
+        case type_i16:
+        case type_u32:
+        case type_i32:
+        case type_f32: {
+            aotw_type(opcode, t);
+            i32 value = t.width == 1 ? (opcode == type_bool ? (p[0] ? 1 : 0) : p[0]) : t.width == 2 ? read_u16(p) : (i32) read_u32(p);
+            aotw_room(t.width);
+            aotw_push_begin();
+            aotw_i32(value);
+            aotw_push_end(t.width == 1 ? AOTW_I32_STORE8 : t.width == 2 ? AOTW_I32_STORE16 : AOTW_I32_STORE, t.width);
+            return true;
+        }
+
+        case LOAD_FROM:
+        case MOVE_TO: {
+            if (!aotw_type(p[0], t)) return false;
+            u32 address = read_ptr(p + 1);
+            if (address + t.width > PLCRUNTIME_MAX_MEMORY_SIZE) return false;
+            // Raw copy, floats are moved as their bit pattern
+            u8 load = t.width == 1 ? AOTW_I32_LOAD8_U : t.width == 2 ? AOTW_I32_LOAD16_U : AOTW_I32_LOAD;
+            u8 store = t.width == 1 ? AOTW_I32_STORE8 : t.width == 2 ? AOTW_I32_STORE16 : AOTW_I32_STORE;
+            if (opcode == LOAD_FROM) {
+                aotw_room(t.width);
+                aotw_push_begin();
+                aotw_i32(0);
+                aotw_mem(load, memory + address);
+                aotw_push_end(store, t.width);
+            } else {
+                aotw_need(t.width);
+                aotw_i32(0);
+                aotw_pop(load, t.width);
+                aotw_mem(store, memory + address);
+            }
+            return true;
+        }
+
+        case LOGIC_AND:
+        case LOGIC_OR:
+        case LOGIC_XOR:
+            aotw_need(2);
+            aotw_pop(AOTW_I32_LOAD8_U, 1);
+            aotw_local(AOTW_LOCAL_SET, AOTW_B);
+            aotw_pop(AOTW_I32_LOAD8_U, 1);
+            aotw_local(AOTW_LOCAL_SET, AOTW_A);
+            aotw_push_begin();
+            aotw_local(AOTW_LOCAL_GET, AOTW_A);
+            aotw_i32(0);
+            aotw_op(AOTW_I32_NE);
+            aotw_local(AOTW_LOCAL_GET, AOTW_B);
+            aotw_i32(0);
+            aotw_op(AOTW_I32_NE);
+            aotw_op(opcode == LOGIC_AND ? AOTW_I32_AND : opcode == LOGIC_OR ? AOTW_I32_OR : AOTW_I32_XOR);
+            aotw_push_end(AOTW_I32_STORE8, 1);
+            return true;
+
+        case LOGIC_NOT:
+            aotw_need(1);
+            aotw_pop(AOTW_I32_LOAD8_U, 1);
+            aotw_local(AOTW_LOCAL_SET, AOTW_A);
+            aotw_push_begin();
+            aotw_local(AOTW_LOCAL_GET, AOTW_A);
+            aotw_op(AOTW_I32_EQZ);
+            aotw_push_end(AOTW_I32_STORE8, 1);
+            return true;
+
+        case ADD:
+        case SUB:
+        case MUL:
+        case CMP_EQ:
+        case CMP_NEQ:
+        case CMP_GT:
+        case CMP_GTE:
+        case CMP_LT:
+        case CMP_LTE: {
+            if (!aotw_type(p[0], t)) return false;
+            const bool compare = opcode >= CMP_EQ && opcode <= CMP_LTE;
+            const u8 a = t.is_float ? AOTW_FA : AOTW_A;
+            const u8 b = t.is_float ? AOTW_FB : AOTW_B;
+            aotw_need(2 * t.width);
+            aotw_pop(t.load, t.width);
+            aotw_local(AOTW_LOCAL_SET, b);
+            aotw_pop(t.load, t.width);
+            aotw_local(AOTW_LOCAL_SET, a);
+            aotw_push_begin();
+            aotw_local(AOTW_LOCAL_GET, a);
+            aotw_local(AOTW_LOCAL_GET, b);
+            if (compare) {
+                aotw_op(aotw_compare_op(opcode, t));
+                aotw_push_end(AOTW_I32_STORE8, 1);
+            } else {
+                aotw_op(aotw_arith_op(opcode, t.is_float));
+                aotw_push_end(t.store, t.width); // Truncated like the handlers
+            }
+            return true;
+        }
+
+        case JMP:
+        case JMP_REL:
+        case JMP_IF:
+        case JMP_IF_REL:
+        case JMP_IF_NOT:
+        case JMP_IF_NOT_REL: {
+            u32 target = 0;
+            aot_branch_target(bytecode, index, length, target);
+            const u32 block = g_aot_wasm_block[target];
+            if (opcode == JMP || opcode == JMP_REL) {
+                aotw_goto(block, 0);
+                return true;
+            }
+            aotw_need(1);
+            aotw_pop(AOTW_I32_LOAD8_U, 1);
+            if (opcode == JMP_IF_NOT || opcode == JMP_IF_NOT_REL) aotw_op(AOTW_I32_EQZ);
+            aotw_op(AOTW_IF); aotw_byte(AOTW_VOID);
+            aotw_goto(block, 1);
+            aotw_op(AOTW_END);
+            return true;
+        }
+
+        default: return false;
+    }
+}
+
+// Execute the instruction at `index` through env.step and follow a moved index
+void aotw_fallback(const u8* bytecode, u32 index, u32 length, u32 resolve) {
+    const u8 opcode = bytecode[index];
+    const u32 next = index + length;
+    aotw_sync();
+    aotw_local(AOTW_LOCAL_GET, AOTW_INDEX);
+    aotw_i32((i32) index);
+    aotw_mem(AOTW_I32_STORE, 0);
+    aotw_local(AOTW_LOCAL_GET, AOTW_RT);
+    aotw_local(AOTW_LOCAL_GET, AOTW_INDEX);
+    aotw_op(AOTW_CALL); aotw_uleb(0);
+    aotw_local(AOTW_LOCAL_TEE, AOTW_A);
+    aotw_op(AOTW_IF); aotw_byte(AOTW_VOID);
+    aotw_local(AOTW_LOCAL_GET, AOTW_A);
+    aotw_op(AOTW_RETURN);
+    aotw_op(AOTW_END);
+    aotw_reload();
+
+    // Same rules as the gotos of aot_translate()
+    u32 block = resolve;
+    if (opcode == RET) {
+        aotw_goto(block, 0);
+        return;
+    }
+    if (opcode != RET_IF && opcode != RET_IF_NOT) {
+        u32 target = 0;
+        if (!aot_branch_target(bytecode, index, length, target)) return;
+        block = g_aot_wasm_block[target];
+        if (opcode == CALL || opcode == CALL_REL) {
+            aotw_goto(block, 0);
+            return;
+        }
+        if (target == next) return;
+    }
+    aotw_local(AOTW_LOCAL_GET, AOTW_INDEX);
+    aotw_mem(AOTW_I32_LOAD, 0);
+    aotw_i32((i32) next);
+    aotw_op(AOTW_I32_NE);
+    aotw_op(AOTW_IF); aotw_byte(AOTW_VOID);
+    aotw_goto(block, 1);
+    aotw_op(AOTW_END);
+}
+
+// Translate `bytecode` into g_aot_wasm_module, false with g_aot_error set on failure
+bool aot_wasm_translate(const u8* bytecode, u32 size, const AotWasmLayout& layout) {
+    g_aot_error = "";
+    g_aot_wasm_length = 0;
+    g_aot_wasm_overflow = false;
+    g_aot_wasm_native = 0;
+    g_aot_wasm_fallback = 0;
+    g_aot_wasm_layout = layout;
+    if (!bytecode || size == 0) {
+        g_aot_error = "Empty program";
+        return false;
+    }
+    if (plc_check_program_structure(bytecode, size, g_aot_starts) != STATUS_SUCCESS) {
+        g_aot_error = "Invalid program structure (unknown instruction or jump target)";
+        return false;
+    }
+
+    // Blocks: the entry, jump and call targets, return sites
+    const u32 bitmap_size = (size + 7) / 8;
+    for (u32 i = 0; i < bitmap_size; i++) {
+        g_aot_labels[i] = 0;
+        g_aot_returns[i] = 0;
+    }
+    aot_set_bit(g_aot_labels, 0);
+    bool has_ret = false;
+    for (u32 index = 0; index < size;) {
+        u8 opcode = bytecode[index];
+        u32 length = INSTRUCTION_SIZE(bytecode, size, index);
+        u32 target = 0;
+        if (aot_branch_target(bytecode, index, length, target)) aot_set_bit(g_aot_labels, target);
+        if (aot_is_call(opcode) && index + length < size) {
+            aot_set_bit(g_aot_labels, index + length);
+            aot_set_bit(g_aot_returns, index + length);
+        }
+        if (opcode == RET || opcode == RET_IF || opcode == RET_IF_NOT) has_ret = true;
+        index += length;
+    }
+    u32 labels = 0;
+    for (u32 index = 0; index < size; index++) {
+        if (aot_bit(g_aot_labels, index)) g_aot_wasm_block[index] = (u16) labels++;
+    }
+    const u32 resolve = labels; // Block dispatching a RET to its return site
+    g_aot_wasm_blocks = labels + (has_ret ? 1 : 0);
+    if (g_aot_wasm_blocks > AOT_WASM_MAX_BLOCKS) {
+        g_aot_error = "Too many jump targets for one WebAssembly function";
+        return false;
+    }
+    g_aot_wasm_size = size;
+    g_aot_wasm_checksum = 0;
+    crc8_simple(g_aot_wasm_checksum, bytecode, size);
+    g_aot_wasm_crc = crc32_update(0, bytecode, size);
+
+    // Header
+    aotw_byte(0x00); aotw_byte(0x61); aotw_byte(0x73); aotw_byte(0x6D);
+    aotw_byte(0x01); aotw_byte(0x00); aotw_byte(0x00); aotw_byte(0x00);
+
+    // Type section: (i32, i32) -> i32 for both env.step and run
+    aotw_byte(1);
+    u32 section = aotw_reserve();
+    aotw_uleb(1);
+    aotw_byte(0x60);
+    aotw_uleb(2); aotw_byte(AOTW_TYPE_I32); aotw_byte(AOTW_TYPE_I32);
+    aotw_uleb(1); aotw_byte(AOTW_TYPE_I32);
+    aotw_patch(section);
+
+    // Import section
+    aotw_byte(2);
+    section = aotw_reserve();
+    aotw_uleb(2);
+    aotw_name("env"); aotw_name("memory"); aotw_byte(0x02); aotw_byte(0x00); aotw_uleb(1);
+    aotw_name("env"); aotw_name("step"); aotw_byte(0x00); aotw_uleb(0);
+    aotw_patch(section);
+
+    // Function section
+    aotw_byte(3);
+    section = aotw_reserve();
+    aotw_uleb(1);
+    aotw_uleb(0);
+    aotw_patch(section);
+
+    // Export section
+    aotw_byte(7);
+    section = aotw_reserve();
+    aotw_uleb(1);
+    aotw_name("run"); aotw_byte(0x00); aotw_uleb(1);
+    aotw_patch(section);
+
+    // Code section
+    aotw_byte(10);
+    section = aotw_reserve();
+    aotw_uleb(1);
+    u32 body = aotw_reserve();
+    aotw_uleb(2);
+    aotw_uleb(4); aotw_byte(AOTW_TYPE_I32); // sp, a, b, pc
+    aotw_uleb(2); aotw_byte(AOTW_TYPE_F32); // fa, fb
+    aotw_reload();
+
+    // Dispatch: block k ends where the code of block k starts
+    aotw_op(AOTW_LOOP); aotw_byte(AOTW_VOID);
+    for (u32 i = 0; i < g_aot_wasm_blocks; i++) {
+        aotw_op(AOTW_BLOCK);
+        aotw_byte(AOTW_VOID);
+    }
+    aotw_local(AOTW_LOCAL_GET, AOTW_PC);
+    aotw_op(AOTW_BR_TABLE);
+    aotw_uleb(g_aot_wasm_blocks);
+    for (u32 i = 0; i < g_aot_wasm_blocks; i++) aotw_uleb(i);
+    aotw_uleb(0);
+
+    for (u32 index = 0; index < size;) {
+        u32 length = INSTRUCTION_SIZE(bytecode, size, index);
+        if (aot_bit(g_aot_labels, index)) {
+            aotw_op(AOTW_END);
+            g_aot_wasm_current = g_aot_wasm_block[index];
+        }
+        if (aotw_native(bytecode, index, length)) g_aot_wasm_native++;
+        else {
+            aotw_fallback(bytecode, index, length, resolve);
+            g_aot_wasm_fallback++;
+        }
+        index += length;
+    }
+    // End of the program
+    aotw_local(AOTW_LOCAL_GET, AOTW_INDEX);
+    aotw_i32((i32) size);
+    aotw_mem(AOTW_I32_STORE, 0);
+    aotw_fail(STATUS_SUCCESS);
+
+    if (has_ret) {
+        // RET left the return address in *index: continue at its block, or let the interpreter do it
+        aotw_op(AOTW_END);
+        g_aot_wasm_current = resolve;
+        aotw_local(AOTW_LOCAL_GET, AOTW_INDEX);
+        aotw_mem(AOTW_I32_LOAD, 0);
+        aotw_local(AOTW_LOCAL_SET, AOTW_A);
+        for (u32 index = 0; index < size; index++) {
+            if (!aot_bit(g_aot_returns, index)) continue;
+            aotw_local(AOTW_LOCAL_GET, AOTW_A);
+            aotw_i32((i32) index);
+            aotw_op(AOTW_I32_EQ);
+            aotw_op(AOTW_IF); aotw_byte(AOTW_VOID);
+            aotw_goto(g_aot_wasm_block[index], 1);
+            aotw_op(AOTW_END);
+        }
+        aotw_fail(STATUS_SUCCESS);
+    }
+    aotw_op(AOTW_END); // loop
+    aotw_op(AOTW_UNREACHABLE);
+    aotw_op(AOTW_END); // function
+    aotw_patch(body);
+    aotw_patch(section);
+
+    if (g_aot_wasm_overflow) {
+        g_aot_error = "Program too large for the WebAssembly module buffer";
+        return false;
+    }
+    return true;
+}
+
+#endif // __WASM__
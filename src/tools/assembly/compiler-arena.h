@@ -0,0 +1,178 @@
+// compiler-arena.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+#include "../runtime-lib.h"
+
+// ============================================================================
+// Compiler arena
+// ============================================================================
+// Bump allocator for the working tables of the compilers. Memory comes from
+// page_alloc() (wasm/jvmalloc.h) in chunks that are never handed back;
+// reset() rewinds every chunk so the next compile reuses the same memory.
+// Tables that used to be sized for the worst case now grow with the program
+// being compiled, so the footprint follows the largest program compiled in
+// the session instead of the configured limits.
+// ============================================================================
+
+#define COMPILER_ARENA_CHUNK_SIZE 65536
+#define COMPILER_ARENA_MAX_CHUNKS 64
+
+struct CompilerArenaChunk {
+    u8* data;
+    u32 size;
+    u32 used;
+};
+
+struct CompilerArenaMark {
+    int chunk;
+    u32 used;
+};
+
+struct CompilerArena {
+    CompilerArenaChunk chunks[COMPILER_ARENA_MAX_CHUNKS];
+    int chunk_count = 0;
+    int current = 0; // First chunk that may still have room
+
+    // Returns zeroed memory, or nullptr when the memory can not be grown
+    void* alloc(u32 size) {
+        size = (size + 7) & ~7u;
+        for (; current < chunk_count; current++) {
+            CompilerArenaChunk& chunk = chunks[current];
+            if (chunk.size - chunk.used < size) continue;
+            u8* ptr = chunk.data + chunk.used;
+            chunk.used += size;
+            memset(ptr, 0, size);
+            return ptr;
+        }
+        if (chunk_count >= COMPILER_ARENA_MAX_CHUNKS) return nullptr;
+        // Chunks grow with the arena so a growing table usually finds room to extend in place
+        u32 chunk_size = size > COMPILER_ARENA_CHUNK_SIZE ? size : COMPILER_ARENA_CHUNK_SIZE;
+        u32 total = reserved();
+        if (chunk_size < total) chunk_size = total;
+        u8* data = (u8*) page_alloc(chunk_size);
+        if (data == nullptr) return nullptr;
+        CompilerArenaChunk& chunk = chunks[chunk_count];
+        chunk.data = data;
+        chunk.size = (chunk_size + JV_PAGE_SIZE - 1) / JV_PAGE_SIZE * JV_PAGE_SIZE;
+        chunk.used = size;
+        current = chunk_count++;
+        memset(data, 0, size);
+        return data;
+    }
+
+    // Grow the most recent allocation in place, returns false when it is not
+    // the last one or its chunk has no room left (the caller then copies)
+    bool extend(void* ptr, u32 size, u32 new_size) {
+        if (current >= chunk_count || ptr == nullptr) return false;
+        size = (size + 7) & ~7u;
+        new_size = (new_size + 7) & ~7u;
+        CompilerArenaChunk& chunk = chunks[current];
+        if ((u8*) ptr + size != chunk.data + chunk.used) return false;
+        if (chunk.size - chunk.used < new_size - size) return false;
+        memset(chunk.data + chunk.used, 0, new_size - size);
+        chunk.used += new_size - size;
+        return true;
+    }
+
+    // Forget every allocation, the chunks stay reserved for reuse
+    void reset() {
+        for (int i = 0; i < chunk_count; i++) chunks[i].used = 0;
+        current = 0;
+    }
+
+    // Position of the bump pointer, see release()
+    CompilerArenaMark mark() const {
+        CompilerArenaMark m;
+        m.chunk = current;
+        m.used = current < chunk_count ? chunks[current].used : 0;
+        return m;
+    }
+
+    // Drop every allocation made after `m` was taken (scratch memory, last in first out)
+    void release(CompilerArenaMark m) {
+        for (int i = m.chunk; i < chunk_count; i++) chunks[i].used = i == m.chunk ? m.used : 0;
+        current = m.chunk;
+    }
+
+    u32 reserved() const {
+        u32 total = 0;
+        for (int i = 0; i < chunk_count; i++) total += chunks[i].size;
+        return total;
+    }
+
+    u32 used() const {
+        u32 total = 0;
+        for (int i = 0; i < chunk_count; i++) total += chunks[i].used;
+        return total;
+    }
+};
+
+// Releases the scratch memory allocated while it is in scope
+struct CompilerArenaScope {
+    CompilerArena& arena;
+    CompilerArenaMark start;
+
+    CompilerArenaScope(CompilerArena& arena) : arena(arena), start(arena.mark()) {}
+    ~CompilerArenaScope() { arena.release(start); }
+};
+
+// Table backed by a CompilerArena that grows on demand up to a fixed limit.
+// Growing moves the entries, so references into the table must not be held
+// across a reserve() that can grow it. After the arena is reset the table
+// has to be release()d before it is used again.
+template <typename T>
+struct ArenaTable {
+    T* data = nullptr;
+    int capacity = 0;
+
+    T& operator[](int index) { return data[index]; }
+    const T& operator[](int index) const { return data[index]; }
+
+    // Make room for `count` entries, keeping the existing ones. New entries are zeroed.
+    bool reserve(CompilerArena& arena, int count, int limit) {
+        if (count <= capacity) return true;
+        if (count > limit) return false;
+        int grown = capacity > 0 ? capacity * 2 : 64;
+        if (grown < count) grown = count;
+        if (grown > limit) grown = limit;
+        if (capacity > 0 && arena.extend(data, (u32) capacity * sizeof(T), (u32) grown * sizeof(T))) {
+            capacity = grown;
+            return true;
+        }
+        T* grown_data = (T*) arena.alloc((u32) grown * sizeof(T));
+        if (grown_data == nullptr) return false;
+        if (capacity > 0) memcpy(grown_data, data, capacity * sizeof(T));
+        data = grown_data;
+        capacity = grown;
+        return true;
+    }
+
+    void release() {
+        data = nullptr;
+        capacity = 0;
+    }
+};
+
+#endif // __WASM__
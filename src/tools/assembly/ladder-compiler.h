@@ -99,6 +99,7 @@ public:
         label_counter = 0;
         node_count = 0;
         connection_count = 0;
+        graph_index.clear();
         indent_level = 0;
     }
 
@@ -159,51 +160,56 @@ public:
     // ============ Graph Helper Wrappers ============
 
     int findNodeById(const char* nodeId) {
-        return ladderFindNodeById(nodes, node_count, nodeId);
+        return ladderFindNodeById(graph_index, nodeId);
     }
 
     bool nodeHasInputs(int nodeIdx) {
-        return ladderNodeHasInputs(nodes, node_count, connections, connection_count, nodeIdx);
+        return ladderNodeHasInputs(graph_index, nodeIdx);
     }
 
     bool nodeHasOutputs(int nodeIdx) {
-        return ladderNodeHasOutputs(nodes, node_count, connections, connection_count, nodeIdx);
+        return ladderNodeHasOutputs(graph_index, nodeIdx);
     }
 
     void getInputConnections(const char* nodeId, int* connIndices, int& count, int maxCount) {
-        ladderGetInputConnections(connections, connection_count, nodeId, connIndices, count, maxCount);
+        ladderGetInputConnections(graph_index, nodeId, connIndices, count, maxCount);
     }
 
     void getOutputConnections(const char* nodeId, int* connIndices, int& count, int maxCount) {
-        ladderGetOutputConnections(connections, connection_count, nodeId, connIndices, count, maxCount);
+        ladderGetOutputConnections(graph_index, nodeId, connIndices, count, maxCount);
     }
 
     void getSourceNodes(const char* nodeId, int* nodeIndices, int& count, int maxCount) {
-        ladderGetSourceNodes(nodes, node_count, connections, connection_count, nodeId, nodeIndices, count, maxCount);
+        ladderGetSourceNodes(graph_index, nodeId, nodeIndices, count, maxCount);
     }
 
     void getDestNodes(const char* nodeId, int* nodeIndices, int& count, int maxCount) {
-        ladderGetDestNodes(nodes, node_count, connections, connection_count, nodeId, nodeIndices, count, maxCount);
+        ladderGetDestNodes(graph_index, nodeId, nodeIndices, count, maxCount);
     }
 
-    void sortNodesByPosition() {
-        ladderSortNodesByPosition(nodes, node_count);
+    // Reorders the node table, so the graph index is rebuilt afterwards
+    bool sortNodesByPosition() {
+        if (!ladderSortNodesByPosition(nodes.data, node_count, graph_arena)) {
+            setError("Out of memory for ladder nodes");
+            return false;
+        }
+        return buildGraphIndex();
     }
 
     void findStartNodes(int* startNodes, int& count, int maxCount) {
-        ladderFindStartNodes(nodes, node_count, connections, connection_count, startNodes, count, maxCount);
+        ladderFindStartNodes(graph_index, startNodes, count, maxCount);
     }
 
     void findEndNodes(int* endNodes, int& count, int maxCount) {
-        ladderFindEndNodes(nodes, node_count, connections, connection_count, endNodes, count, maxCount);
+        ladderFindEndNodes(graph_index, endNodes, count, maxCount);
     }
 
     void findOutputNodes(int* outputNodes, int& count, int maxCount) {
-        ladderFindOutputNodes(nodes, node_count, outputNodes, count, maxCount);
+        ladderFindOutputNodes(nodes.data, node_count, outputNodes, count, maxCount);
     }
 
     void sortSourcesByPosition(int* sourceIndices, int sourceCount) {
-        ladderSortSourcesByPosition(nodes, sourceIndices, sourceCount);
+        ladderSortSourcesByPosition(nodes.data, sourceIndices, sourceCount);
     }
 
     // ============ Validation Helpers ============
@@ -412,9 +418,9 @@ public:
         if (!isCoil(node.type)) return false;
 
         // Check if node has outgoing connections to any downstream nodes
-        int destIndices[LADDER_MAX_NODES];
+        int destIndices[LADDER_MAX_FAN];
         int destCount;
-        getDestNodes(node.id, destIndices, destCount, LADDER_MAX_NODES);
+        getDestNodes(node.id, destIndices, destCount, LADDER_MAX_FAN);
 
         for (int d = 0; d < destCount; d++) {
             LadderGraphNode& dest = nodes[destIndices[d]];
@@ -429,9 +435,9 @@ public:
     bool hasDownstreamChain(int nodeIdx) {
         if (nodeIdx < 0 || nodeIdx >= node_count) return false;
 
-        int destIndices[LADDER_MAX_NODES];
+        int destIndices[LADDER_MAX_FAN];
         int destCount;
-        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_NODES);
+        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_FAN);
 
         for (int d = 0; d < destCount; d++) {
             LadderGraphNode& dest = nodes[destIndices[d]];
@@ -446,9 +452,9 @@ public:
     bool hasDownstreamContact(int nodeIdx) {
         if (nodeIdx < 0 || nodeIdx >= node_count) return false;
 
-        int destIndices[LADDER_MAX_NODES];
+        int destIndices[LADDER_MAX_FAN];
         int destCount;
-        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_NODES);
+        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_FAN);
 
         for (int d = 0; d < destCount; d++) {
             LadderGraphNode& dest = nodes[destIndices[d]];
@@ -461,9 +467,9 @@ public:
     bool hasDownstreamOutput(int nodeIdx) {
         if (nodeIdx < 0 || nodeIdx >= node_count) return false;
 
-        int destIndices[LADDER_MAX_NODES];
+        int destIndices[LADDER_MAX_FAN];
         int destCount;
-        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_NODES);
+        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_FAN);
 
         for (int d = 0; d < destCount; d++) {
             LadderGraphNode& dest = nodes[destIndices[d]];
@@ -776,9 +782,9 @@ public:
     void emitDownstreamChain(int nodeIdx, bool* outputProcessed) {
         if (nodeIdx < 0 || nodeIdx >= node_count) return;
 
-        int destIndices[LADDER_MAX_NODES];
+        int destIndices[LADDER_MAX_FAN];
         int destCount;
-        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_NODES);
+        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_FAN);
 
         for (int d = 0; d < destCount; d++) {
             int destIdx = destIndices[d];
@@ -787,9 +793,9 @@ public:
             if (isInputNode(dest.type)) {
                 emitContact(dest, true);
 
-                int outputIndices[LADDER_MAX_NODES];
+                int outputIndices[LADDER_MAX_FAN];
                 int outputCount;
-                getDestNodes(dest.id, outputIndices, outputCount, LADDER_MAX_NODES);
+                getDestNodes(dest.id, outputIndices, outputCount, LADDER_MAX_FAN);
 
                 for (int c = 0; c < outputCount; c++) {
                     int outIdx = outputIndices[c];
@@ -849,9 +855,9 @@ public:
     void emitPassthroughChain(int nodeIdx, bool* outputProcessed) {
         if (nodeIdx < 0 || nodeIdx >= node_count) return;
 
-        int destIndices[LADDER_MAX_NODES];
+        int destIndices[LADDER_MAX_FAN];
         int destCount;
-        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_NODES);
+        getDestNodes(nodes[nodeIdx].id, destIndices, destCount, LADDER_MAX_FAN);
 
         for (int d = 0; d < destCount; d++) {
             int destIdx = destIndices[d];
@@ -877,9 +883,9 @@ public:
             LadderGraphNode& node = nodes[sourceIndices[i]];
             if (!isContact(node.type)) return false;
 
-            int srcIndices[LADDER_MAX_NODES];
+            int srcIndices[LADDER_MAX_FAN];
             int srcCount;
-            getSourceNodes(node.id, srcIndices, srcCount, LADDER_MAX_NODES);
+            getSourceNodes(node.id, srcIndices, srcCount, LADDER_MAX_FAN);
             if (srcCount > 0) return false;
         }
         return true;
@@ -894,9 +900,9 @@ public:
 
         chainNodes[count++] = nodeIdx;
 
-        int srcIndices[LADDER_MAX_NODES];
+        int srcIndices[LADDER_MAX_FAN];
         int srcCount;
-        getSourceNodes(node.id, srcIndices, srcCount, LADDER_MAX_NODES);
+        getSourceNodes(node.id, srcIndices, srcCount, LADDER_MAX_FAN);
         for (int i = 0; i < srcCount && count < maxCount; i++) {
             collectChainNodes(srcIndices[i], chainNodes, count, maxCount);
         }
@@ -904,39 +910,53 @@ public:
         node.visited = false;
     }
 
-    // Find common ancestor
+    // Chain walks may reach a node through several paths, so the chain buffers
+    // hold at least LADDER_MAX_FAN entries even for small graphs
+    int chainLimit() const {
+        return node_count > LADDER_MAX_FAN ? node_count : LADDER_MAX_FAN;
+    }
+
+    // Scratch table for the current compile, released by the caller's CompilerArenaScope
+    int* allocScratch(int count) {
+        int* table = (int*) graph_arena.alloc((u32) (count + 1) * sizeof(int));
+        if (!table) setError("Out of memory for ladder compile");
+        return table;
+    }
+
+    // Find common ancestor: the first node of the first source's chain (other
+    // than the source itself) that is in the chain of every other source
     int findCommonAncestor(int* sourceIndices, int sourceCount) {
         if (sourceCount < 2) return -1;
 
-        int ancestors0[LADDER_MAX_NODES];
+        CompilerArenaScope scope(graph_arena);
+        int limit = chainLimit();
+        int* ancestors0 = allocScratch(limit);
+        int* ancestorsS = allocScratch(limit);
+        int* commonCount = allocScratch(node_count);  // Number of other sources whose chain has the node
+        int* lastSource = allocScratch(node_count);
+        if (!ancestors0 || !ancestorsS || !commonCount || !lastSource) return -1;
+
         int ancestorCount0 = 0;
         for (int i = 0; i < node_count; i++) nodes[i].visited = false;
-        collectChainNodes(sourceIndices[0], ancestors0, ancestorCount0, LADDER_MAX_NODES);
+        collectChainNodes(sourceIndices[0], ancestors0, ancestorCount0, limit);
         for (int i = 0; i < node_count; i++) nodes[i].visited = false;
 
+        for (int s = 1; s < sourceCount; s++) {
+            int ancestorCountS = 0;
+            collectChainNodes(sourceIndices[s], ancestorsS, ancestorCountS, limit);
+            for (int i = 0; i < node_count; i++) nodes[i].visited = false;
+            for (int as = 0; as < ancestorCountS; as++) {
+                int idx = ancestorsS[as];
+                if (lastSource[idx] == s) continue;
+                lastSource[idx] = s;
+                commonCount[idx]++;
+            }
+        }
+
         for (int a = 0; a < ancestorCount0; a++) {
             int candidateIdx = ancestors0[a];
             if (candidateIdx == sourceIndices[0]) continue;
-
-            bool isCommonToAll = true;
-            for (int s = 1; s < sourceCount && isCommonToAll; s++) {
-                int ancestorsS[LADDER_MAX_NODES];
-                int ancestorCountS = 0;
-                for (int i = 0; i < node_count; i++) nodes[i].visited = false;
-                collectChainNodes(sourceIndices[s], ancestorsS, ancestorCountS, LADDER_MAX_NODES);
-                for (int i = 0; i < node_count; i++) nodes[i].visited = false;
-
-                bool found = false;
-                for (int as = 0; as < ancestorCountS; as++) {
-                    if (ancestorsS[as] == candidateIdx) {
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) isCommonToAll = false;
-            }
-
-            if (isCommonToAll) return candidateIdx;
+            if (commonCount[candidateIdx] == sourceCount - 1) return candidateIdx;
         }
 
         return -1;
@@ -949,9 +969,9 @@ public:
 
         if (!isContact(node.type)) return false;
 
-        int srcIndices[LADDER_MAX_NODES];
+        int srcIndices[LADDER_MAX_FAN];
         int srcCount;
-        getSourceNodes(node.id, srcIndices, srcCount, LADDER_MAX_NODES);
+        getSourceNodes(node.id, srcIndices, srcCount, LADDER_MAX_FAN);
 
         if (srcCount == 0) return true;
 
@@ -981,9 +1001,9 @@ public:
             return false;
         }
 
-        int sourceIndices[LADDER_MAX_NODES];
+        int sourceIndices[LADDER_MAX_FAN];
         int sourceCount;
-        getSourceNodes(node.id, sourceIndices, sourceCount, LADDER_MAX_NODES);
+        getSourceNodes(node.id, sourceIndices, sourceCount, LADDER_MAX_FAN);
 
         if (isContact(node.type)) {
             if (sourceCount > 0) {
@@ -1079,10 +1099,12 @@ public:
             for (int i = 0; i < node_count; i++) nodes[i].visited = false;
             emitConditionForNode(commonAncestorIdx, depth + 1, false, stopAtEmittedOutputs);
 
-            int emittedChain[LADDER_MAX_NODES];
+            CompilerArenaScope scope(graph_arena);
+            int* emittedChain = allocScratch(chainLimit());
+            if (!emittedChain) return;
             int emittedCount = 0;
             for (int i = 0; i < node_count; i++) nodes[i].visited = false;
-            collectChainNodes(commonAncestorIdx, emittedChain, emittedCount, LADDER_MAX_NODES);
+            collectChainNodes(commonAncestorIdx, emittedChain, emittedCount, chainLimit());
             for (int i = 0; i < node_count; i++) nodes[i].visited = false;
 
             for (int i = 0; i < emittedCount; i++) {
@@ -1095,9 +1117,9 @@ public:
                     allSimpleContacts = false;
                     break;
                 }
-                int srcIndices[LADDER_MAX_NODES];
+                int srcIndices[LADDER_MAX_FAN];
                 int srcCount;
-                getSourceNodes(nodes[sourceIndices[s]].id, srcIndices, srcCount, LADDER_MAX_NODES);
+                getSourceNodes(nodes[sourceIndices[s]].id, srcIndices, srcCount, LADDER_MAX_FAN);
                 for (int i = 0; i < srcCount && allSimpleContacts; i++) {
                     bool found = false;
                     for (int j = 0; j < emittedCount; j++) {
@@ -1129,9 +1151,9 @@ public:
 
                 bool isSimpleEmittedContact = false;
                 if (isContact(nodes[sourceIndices[s]].type)) {
-                    int srcIndices[LADDER_MAX_NODES];
+                    int srcIndices[LADDER_MAX_FAN];
                     int srcCount;
-                    getSourceNodes(nodes[sourceIndices[s]].id, srcIndices, srcCount, LADDER_MAX_NODES);
+                    getSourceNodes(nodes[sourceIndices[s]].id, srcIndices, srcCount, LADDER_MAX_FAN);
 
                     isSimpleEmittedContact = true;
                     for (int i = 0; i < srcCount && isSimpleEmittedContact; i++) {
@@ -1172,10 +1194,12 @@ public:
         } else {
             emitConditionForNode(sourceIndices[0], depth + 1, false, stopAtEmittedOutputs);
 
-            int emittedChain[LADDER_MAX_NODES];
+            CompilerArenaScope scope(graph_arena);
+            int* emittedChain = allocScratch(chainLimit());
+            if (!emittedChain) return;
             int emittedCount = 0;
             for (int i = 0; i < node_count; i++) nodes[i].visited = false;
-            collectChainNodes(sourceIndices[0], emittedChain, emittedCount, LADDER_MAX_NODES);
+            collectChainNodes(sourceIndices[0], emittedChain, emittedCount, chainLimit());
             for (int i = 0; i < node_count; i++) nodes[i].visited = false;
 
             for (int s = 1; s < sourceCount; s++) {
@@ -1201,9 +1225,9 @@ public:
 
         if (!isTerminationNode(node.type)) return false;
 
-        int destIndices[LADDER_MAX_NODES];
+        int destIndices[LADDER_MAX_FAN];
         int destCount;
-        getDestNodes(node.id, destIndices, destCount, LADDER_MAX_NODES);
+        getDestNodes(node.id, destIndices, destCount, LADDER_MAX_FAN);
 
         if (destCount == 0) return true;
 
@@ -1228,28 +1252,29 @@ public:
     // ============ Main compilation function ============
 
     bool compile() {
-        sortNodesByPosition();
+        if (!sortNodesByPosition()) return false;
 
-        int outputNodes[LADDER_MAX_NODES];
+        CompilerArenaScope scope(graph_arena);
+        int* outputNodes = allocScratch(node_count);
+        bool* outputProcessed = (bool*) allocScratch(node_count);  // Zeroed by the arena
+        if (!outputNodes || !outputProcessed) return false;
         int outputCount;
-        findOutputNodes(outputNodes, outputCount, LADDER_MAX_NODES);
+        findOutputNodes(outputNodes, outputCount, node_count);
 
         if (outputCount == 0) {
             return true;
         }
 
-        bool outputProcessed[LADDER_MAX_NODES] = { false };
-
         // First pass: handle parallel branches
         for (int n = 0; n < node_count; n++) {
             LadderGraphNode& srcNode = nodes[n];
             if (!isInputNode(srcNode.type) && !isTerminationNode(srcNode.type)) continue;
 
-            int allDestIndices[LADDER_MAX_NODES];
+            int allDestIndices[LADDER_MAX_FAN];
             int allDestCount;
-            getDestNodes(srcNode.id, allDestIndices, allDestCount, LADDER_MAX_NODES);
+            getDestNodes(srcNode.id, allDestIndices, allDestCount, LADDER_MAX_FAN);
 
-            int termDests[LADDER_MAX_NODES];
+            int termDests[LADDER_MAX_FAN];
             int termDestCount = 0;
             for (int d = 0; d < allDestCount; d++) {
                 int destIdx = allDestIndices[d];
@@ -1292,9 +1317,9 @@ public:
                     emitComparator(destNode, true);
                     indent_level--;
                     emitLine(")");
-                    int compDestIndices[LADDER_MAX_NODES];
+                    int compDestIndices[LADDER_MAX_FAN];
                     int compDestCount;
-                    getDestNodes(destNode.id, compDestIndices, compDestCount, LADDER_MAX_NODES);
+                    getDestNodes(destNode.id, compDestIndices, compDestCount, LADDER_MAX_FAN);
                     for (int cd = 0; cd < compDestCount; cd++) {
                         int compDestIdx = compDestIndices[cd];
                         LadderGraphNode& compDest = nodes[compDestIdx];
@@ -1359,9 +1384,9 @@ public:
 
             if (destNode.emitted) continue;
 
-            int sourceIndices[LADDER_MAX_NODES];
+            int sourceIndices[LADDER_MAX_FAN];
             int sourceCount;
-            getSourceNodes(destNode.id, sourceIndices, sourceCount, LADDER_MAX_NODES);
+            getSourceNodes(destNode.id, sourceIndices, sourceCount, LADDER_MAX_FAN);
 
             bool sourceIsEmittedCoil = false;
             if (sourceCount == 1) {
@@ -1591,8 +1616,11 @@ public:
 
     virtual bool validateGraph() {
         for (int i = 0; i < node_count; i++) {
-            for (int j = i + 1; j < node_count; j++) {
-                if (nodes[i].x == nodes[j].x && nodes[i].y == nodes[j].y) {
+            int start;
+            int count = graph_index.positionGroup(nodes[i].x, nodes[i].y, start);
+            for (int k = 0; k < count; k++) {
+                int j = graph_index.position_order[start + k];
+                if (j > i) {
                     char msg[64];
                     int mi = 0;
                     const char* prefix = "Overlaps with node '";
@@ -1656,7 +1684,9 @@ public:
             return false;
         }
 
-        normalizeConnections();
+        if (!normalizeConnections() || !buildGraphIndex()) {
+            return false;
+        }
 
         if (!validateGraph()) {
             return false;
@@ -583,47 +583,12 @@ public:
         return true;  // Always return true to continue linting
     }
 
-    // Check if two nodes are connected (either direction)
+    // Check if two nodes are connected (either direction): one of them is a
+    // source and the other a destination of the same connection
     bool nodesAreConnected(int nodeIdxA, int nodeIdxB) {
         if (nodeIdxA < 0 || nodeIdxA >= node_count) return false;
         if (nodeIdxB < 0 || nodeIdxB >= node_count) return false;
-        
-        const char* idA = nodes[nodeIdxA].id;
-        const char* idB = nodes[nodeIdxB].id;
-        
-        for (int c = 0; c < connection_count; c++) {
-            Connection& conn = connections[c];
-            bool hasA = false, hasB = false;
-            
-            // Check if A is a source and B is a destination
-            for (int s = 0; s < conn.source_count; s++) {
-                if (strEqI(conn.sources[s], idA)) hasA = true;
-                if (strEqI(conn.sources[s], idB)) hasB = true;
-            }
-            for (int d = 0; d < conn.dest_count; d++) {
-                if (strEqI(conn.destinations[d], idA)) hasA = true;
-                if (strEqI(conn.destinations[d], idB)) hasB = true;
-            }
-            
-            // If both nodes are in the same connection (one as source, one as dest)
-            if (hasA && hasB) {
-                // Verify it's actually a source->dest relationship
-                bool aIsSource = false, bIsDest = false;
-                bool bIsSource = false, aIsDest = false;
-                for (int s = 0; s < conn.source_count; s++) {
-                    if (strEqI(conn.sources[s], idA)) aIsSource = true;
-                    if (strEqI(conn.sources[s], idB)) bIsSource = true;
-                }
-                for (int d = 0; d < conn.dest_count; d++) {
-                    if (strEqI(conn.destinations[d], idA)) aIsDest = true;
-                    if (strEqI(conn.destinations[d], idB)) bIsDest = true;
-                }
-                if ((aIsSource && bIsDest) || (bIsSource && aIsDest)) {
-                    return true;
-                }
-            }
-        }
-        return false;
+        return graph_index.linked(graph_index.node_name[nodeIdxA], graph_index.node_name[nodeIdxB]);
     }
 
     // Check if two nodes are touching horizontally (adjacent on X axis only)
@@ -649,8 +614,11 @@ public:
     bool validateGraph() override {
         // Check for duplicate nodes at same position
         for (int i = 0; i < node_count; i++) {
-            for (int j = i + 1; j < node_count; j++) {
-                if (nodes[i].x == nodes[j].x && nodes[i].y == nodes[j].y) {
+            int start;
+            int count = graph_index.positionGroup(nodes[i].x, nodes[i].y, start);
+            for (int k = 0; k < count; k++) {
+                int j = graph_index.position_order[start + k];
+                if (j > i) {
                     char msg[64];
                     int mi = 0;
                     const char* prefix = "Overlaps with node '";
@@ -666,7 +634,19 @@ public:
 
         // Check for touching nodes that are NOT connected (warning for each)
         for (int i = 0; i < node_count; i++) {
-            for (int j = i + 1; j < node_count; j++) {
+            // Candidates are the nodes one column to the left and to the right,
+            // merged back into node order so the warnings come out as before
+            int leftStart, rightStart;
+            int leftCount = graph_index.positionGroup(nodes[i].x - 1, nodes[i].y, leftStart);
+            int rightCount = graph_index.positionGroup(nodes[i].x + 1, nodes[i].y, rightStart);
+            const int* left = graph_index.position_order + leftStart;
+            const int* right = graph_index.position_order + rightStart;
+            int l = 0, r = 0;
+            while (l < leftCount || r < rightCount) {
+                int j;
+                if (r >= rightCount || (l < leftCount && left[l] < right[r])) j = left[l++];
+                else j = right[r++];
+                if (j <= i) continue;
                 if (nodesAreTouching(i, j) && !nodesAreConnected(i, j)) {
                     // Add warning for first node
                     char msg1[96];
@@ -753,7 +733,7 @@ public:
         length = len;
         
         // Use base class parseGraph to parse the JSON
-        if (!parseGraph()) {
+        if (!parseGraph() || !buildGraphIndex()) {
             // Parser error already added via setError override
             return false;
         }
@@ -776,7 +756,7 @@ public:
         length = len;
         
         // Parse the graph JSON
-        if (!parseGraph()) {
+        if (!parseGraph() || !buildGraphIndex()) {
             return false;
         }
         
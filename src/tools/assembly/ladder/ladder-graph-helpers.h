@@ -26,195 +26,129 @@
 
 #include "ladder-types.h"
 #include "ladder-node-types.h"
+#include "ladder-graph-index.h"
 
 // ============================================================================
 // Graph Helper Functions
-// These are utility functions for navigating the ladder graph structure
+// These are utility functions for navigating the ladder graph structure.
+// Lookups go through a LadderGraphIndex built for the current node and
+// connection tables, so each query costs the size of its answer.
 // ============================================================================
 
 // Find a node by its ID, returns index or -1 if not found
-inline int ladderFindNodeById(const LadderGraphNode* nodes, int node_count, const char* nodeId) {
-    for (int i = 0; i < node_count; i++) {
-        if (ladderStrEqI(nodes[i].id, nodeId)) return i;
-    }
-    return -1;
+inline int ladderFindNodeById(const LadderGraphIndex& index, const char* nodeId) {
+    return index.findNode(nodeId);
 }
 
 // Check if a node has any incoming connections
-inline bool ladderNodeHasInputs(
-    const LadderGraphNode* nodes, int node_count,
-    const LadderConnection* connections, int connection_count,
-    int nodeIdx
-) {
-    if (nodeIdx < 0 || nodeIdx >= node_count) return false;
-    for (int c = 0; c < connection_count; c++) {
-        for (int d = 0; d < connections[c].dest_count; d++) {
-            if (ladderStrEqI(connections[c].destinations[d], nodes[nodeIdx].id)) {
-                return true;
-            }
-        }
-    }
-    return false;
+inline bool ladderNodeHasInputs(const LadderGraphIndex& index, int nodeIdx) {
+    if (nodeIdx < 0 || nodeIdx >= index.node_count) return false;
+    return index.inputCount(index.node_name[nodeIdx]) > 0;
 }
 
 // Check if a node has any outgoing connections
-inline bool ladderNodeHasOutputs(
-    const LadderGraphNode* nodes, int node_count,
-    const LadderConnection* connections, int connection_count,
-    int nodeIdx
-) {
-    if (nodeIdx < 0 || nodeIdx >= node_count) return false;
-    for (int c = 0; c < connection_count; c++) {
-        for (int s = 0; s < connections[c].source_count; s++) {
-            if (ladderStrEqI(connections[c].sources[s], nodes[nodeIdx].id)) {
-                return true;
-            }
-        }
-    }
-    return false;
+inline bool ladderNodeHasOutputs(const LadderGraphIndex& index, int nodeIdx) {
+    if (nodeIdx < 0 || nodeIdx >= index.node_count) return false;
+    return index.outputCount(index.node_name[nodeIdx]) > 0;
 }
 
 // Find all connections where this node is a destination (inputs to this node)
 inline void ladderGetInputConnections(
-    const LadderConnection* connections, int connection_count,
+    const LadderGraphIndex& index,
     const char* nodeId, int* connIndices, int& count, int maxCount
 ) {
-    count = 0;
-    for (int c = 0; c < connection_count && count < maxCount; c++) {
-        for (int d = 0; d < connections[c].dest_count; d++) {
-            if (ladderStrEqI(connections[c].destinations[d], nodeId)) {
-                connIndices[count++] = c;
-                break;
-            }
-        }
-    }
+    int name = index.find(nodeId);
+    const int* list = index.inputs(name);
+    int total = index.inputCount(name);
+    for (count = 0; count < total && count < maxCount; count++) connIndices[count] = list[count];
 }
 
 // Find all connections where this node is a source (outputs from this node)
 inline void ladderGetOutputConnections(
-    const LadderConnection* connections, int connection_count,
+    const LadderGraphIndex& index,
     const char* nodeId, int* connIndices, int& count, int maxCount
 ) {
-    count = 0;
-    for (int c = 0; c < connection_count && count < maxCount; c++) {
-        for (int s = 0; s < connections[c].source_count; s++) {
-            if (ladderStrEqI(connections[c].sources[s], nodeId)) {
-                connIndices[count++] = c;
-                break;
-            }
-        }
-    }
+    int name = index.find(nodeId);
+    const int* list = index.outputs(name);
+    int total = index.outputCount(name);
+    for (count = 0; count < total && count < maxCount; count++) connIndices[count] = list[count];
 }
 
 // Get all source node indices feeding into a given node
 inline void ladderGetSourceNodes(
-    const LadderGraphNode* nodes, int node_count,
-    const LadderConnection* connections, int connection_count,
+    LadderGraphIndex& index,
     const char* nodeId, int* nodeIndices, int& count, int maxCount
 ) {
     count = 0;
-    int connIndices[LADDER_MAX_CONNECTIONS];
-    int connCount;
-    ladderGetInputConnections(connections, connection_count, nodeId, connIndices, connCount, LADDER_MAX_CONNECTIONS);
-
-    for (int c = 0; c < connCount; c++) {
-        const LadderConnection& conn = connections[connIndices[c]];
-        for (int s = 0; s < conn.source_count && count < maxCount; s++) {
-            int idx = ladderFindNodeById(nodes, node_count, conn.sources[s]);
-            if (idx >= 0) {
-                // Check if already added
-                bool found = false;
-                for (int i = 0; i < count; i++) {
-                    if (nodeIndices[i] == idx) { found = true; break; }
-                }
-                if (!found) nodeIndices[count++] = idx;
-            }
+    int name = index.find(nodeId);
+    const int* list = index.inputs(name);
+    int connCount = index.inputCount(name);
+    index.beginNodeQuery();
+
+    for (int c = 0; c < connCount && count < maxCount; c++) {
+        int sourceCount = index.endpointCount(list[c], false);
+        for (int s = 0; s < sourceCount && count < maxCount; s++) {
+            int idx = index.name_node[index.endpointName(list[c], false, s)];
+            if (idx >= 0 && index.firstSeen(idx)) nodeIndices[count++] = idx;
         }
     }
 }
 
 // Get all destination node indices this node feeds into
 inline void ladderGetDestNodes(
-    const LadderGraphNode* nodes, int node_count,
-    const LadderConnection* connections, int connection_count,
+    LadderGraphIndex& index,
     const char* nodeId, int* nodeIndices, int& count, int maxCount
 ) {
     count = 0;
-    int connIndices[LADDER_MAX_CONNECTIONS];
-    int connCount;
-    ladderGetOutputConnections(connections, connection_count, nodeId, connIndices, connCount, LADDER_MAX_CONNECTIONS);
-
-    for (int c = 0; c < connCount; c++) {
-        const LadderConnection& conn = connections[connIndices[c]];
-        for (int d = 0; d < conn.dest_count && count < maxCount; d++) {
-            int idx = ladderFindNodeById(nodes, node_count, conn.destinations[d]);
-            if (idx >= 0) {
-                bool found = false;
-                for (int i = 0; i < count; i++) {
-                    if (nodeIndices[i] == idx) { found = true; break; }
-                }
-                if (!found) nodeIndices[count++] = idx;
-            }
+    int name = index.find(nodeId);
+    const int* list = index.outputs(name);
+    int connCount = index.outputCount(name);
+    index.beginNodeQuery();
+
+    for (int c = 0; c < connCount && count < maxCount; c++) {
+        int destCount = index.endpointCount(list[c], true);
+        for (int d = 0; d < destCount && count < maxCount; d++) {
+            int idx = index.name_node[index.endpointName(list[c], true, d)];
+            if (idx >= 0 && index.firstSeen(idx)) nodeIndices[count++] = idx;
         }
     }
 }
 
-// Sort nodes by x,y coordinates (left-to-right, top-to-bottom)
-inline void ladderSortNodesByPosition(LadderGraphNode* nodes, int node_count) {
-    // Simple bubble sort for embedded compatibility
-    for (int i = 0; i < node_count - 1; i++) {
-        for (int j = 0; j < node_count - i - 1; j++) {
-            bool swap = false;
-            if (nodes[j].x > nodes[j + 1].x) {
-                swap = true;
-            } else if (nodes[j].x == nodes[j + 1].x && nodes[j].y > nodes[j + 1].y) {
-                swap = true;
-            }
-            if (swap) {
-                LadderGraphNode tmp = nodes[j];
-                nodes[j] = nodes[j + 1];
-                nodes[j + 1] = tmp;
-            }
-        }
-    }
-
-    // Assign order indices
+// Sort nodes by x,y coordinates (left-to-right, top-to-bottom), keeping the
+// original order of nodes on the same cell. Returns false when the scratch
+// space does not fit in the arena.
+inline bool ladderSortNodesByPosition(LadderGraphNode* nodes, int node_count, CompilerArena& arena) {
+    CompilerArenaScope scope(arena);
+    int* order = (int*) arena.alloc((node_count + 1) * sizeof(int));
+    int* scratch = (int*) arena.alloc((node_count + 1) * sizeof(int));
+    LadderGraphNode* sorted = (LadderGraphNode*) arena.alloc((node_count + 1) * sizeof(LadderGraphNode));
+    if (!order || !scratch || !sorted) return false;
+
+    for (int i = 0; i < node_count; i++) order[i] = i;
+    ladderMergeSort(order, scratch, node_count, [nodes](int a, int b) {
+        return nodes[a].x < nodes[b].x || (nodes[a].x == nodes[b].x && nodes[a].y < nodes[b].y);
+    });
+    for (int i = 0; i < node_count; i++) sorted[i] = nodes[order[i]];
     for (int i = 0; i < node_count; i++) {
+        nodes[i] = sorted[i];
         nodes[i].order_index = i;
     }
+    return true;
 }
 
 // Find starting nodes (nodes with no input connections)
-inline void ladderFindStartNodes(
-    const LadderGraphNode* nodes, int node_count,
-    const LadderConnection* connections, int connection_count,
-    int* startNodes, int& count, int maxCount
-) {
+inline void ladderFindStartNodes(const LadderGraphIndex& index, int* startNodes, int& count, int maxCount) {
     count = 0;
-    for (int i = 0; i < node_count && count < maxCount; i++) {
-        int inputConns[LADDER_MAX_CONNECTIONS];
-        int inputCount;
-        ladderGetInputConnections(connections, connection_count, nodes[i].id, inputConns, inputCount, LADDER_MAX_CONNECTIONS);
-        if (inputCount == 0) {
-            startNodes[count++] = i;
-        }
+    for (int i = 0; i < index.node_count && count < maxCount; i++) {
+        if (!ladderNodeHasInputs(index, i)) startNodes[count++] = i;
     }
 }
 
 // Find ending nodes (nodes with no output connections)
-inline void ladderFindEndNodes(
-    const LadderGraphNode* nodes, int node_count,
-    const LadderConnection* connections, int connection_count,
-    int* endNodes, int& count, int maxCount
-) {
+inline void ladderFindEndNodes(const LadderGraphIndex& index, int* endNodes, int& count, int maxCount) {
     count = 0;
-    for (int i = 0; i < node_count && count < maxCount; i++) {
-        int outputConns[LADDER_MAX_CONNECTIONS];
-        int outputCount;
-        ladderGetOutputConnections(connections, connection_count, nodes[i].id, outputConns, outputCount, LADDER_MAX_CONNECTIONS);
-        if (outputCount == 0) {
-            endNodes[count++] = i;
-        }
+    for (int i = 0; i < index.node_count && count < maxCount; i++) {
+        if (!ladderNodeHasOutputs(index, i)) endNodes[count++] = i;
     }
 }
 
@@ -233,18 +167,18 @@ inline void ladderFindOutputNodes(
 
 // Sort source indices by y position (top to bottom)
 inline void ladderSortSourcesByPosition(const LadderGraphNode* nodes, int* sourceIndices, int sourceCount) {
-    // Simple bubble sort
-    for (int i = 0; i < sourceCount - 1; i++) {
-        for (int j = 0; j < sourceCount - i - 1; j++) {
-            int yA = nodes[sourceIndices[j]].y;
-            int yB = nodes[sourceIndices[j + 1]].y;
+    // Stable insertion sort, source lists are short
+    for (int i = 1; i < sourceCount; i++) {
+        int idx = sourceIndices[i];
+        int j = i;
+        while (j > 0) {
+            const LadderGraphNode& prev = nodes[sourceIndices[j - 1]];
             // If same y, sort by x
-            if (yA > yB || (yA == yB && nodes[sourceIndices[j]].x > nodes[sourceIndices[j + 1]].x)) {
-                int tmp = sourceIndices[j];
-                sourceIndices[j] = sourceIndices[j + 1];
-                sourceIndices[j + 1] = tmp;
-            }
+            if (!(prev.y > nodes[idx].y || (prev.y == nodes[idx].y && prev.x > nodes[idx].x))) break;
+            sourceIndices[j] = sourceIndices[j - 1];
+            j--;
         }
+        sourceIndices[j] = idx;
     }
 }
 
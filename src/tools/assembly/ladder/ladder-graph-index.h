@@ -0,0 +1,282 @@
+// ladder-graph-index.h - Indexed adjacency structure for the ladder graph
+// Interned node ids and per-id connection lists built once per parsed graph
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+#include "../compiler-arena.h"
+#include "../shared-symbols.h"
+#include "ladder-types.h"
+#include "ladder-node-types.h"
+
+// ============================================================================
+// Ladder Graph Index
+// ============================================================================
+// Node ids and connection endpoints are interned into names (case-insensitive,
+// like ladderStrEqI). For every name the index keeps the connections that list
+// it as a destination (its inputs) and as a source (its outputs), in connection
+// order and without duplicates, as CSR-style offset + list arrays. Nodes are
+// also kept sorted by position so overlapping and adjacent nodes are found
+// with a binary search.
+//
+// The index refers to nodes and connections by position in their tables, so
+// it has to be rebuilt when either table is reordered or changed. All arrays
+// live in the arena passed to build().
+// ============================================================================
+
+// Stable bottom-up merge sort of indices, `less(a, b)` orders two entries
+template <typename Less>
+inline void ladderMergeSort(int* order, int* scratch, int count, Less less) {
+    int* from = order;
+    int* to = scratch;
+    for (int width = 1; width < count; width *= 2) {
+        for (int lo = 0; lo < count; lo += 2 * width) {
+            int mid = lo + width < count ? lo + width : count;
+            int hi = lo + 2 * width < count ? lo + 2 * width : count;
+            int a = lo, b = mid, k = lo;
+            while (a < mid && b < hi) to[k++] = less(from[b], from[a]) ? from[b++] : from[a++];
+            while (a < mid) to[k++] = from[a++];
+            while (b < hi) to[k++] = from[b++];
+        }
+        int* swap = from; from = to; to = swap;
+    }
+    if (from != order) for (int i = 0; i < count; i++) order[i] = from[i];
+}
+
+struct LadderGraphIndex {
+    int name_count = 0;
+    const char** names = nullptr;       // Name -> first spelling seen
+    int* name_node = nullptr;           // Name -> first node with this id, -1 if no node has it
+    int* slots = nullptr;               // Hash slot -> name + 1, 0 = empty
+    u32 slot_mask = 0;
+
+    int node_count = 0;
+    int* node_name = nullptr;           // Node -> name
+    int* position_order = nullptr;      // Nodes sorted by (y, x, index)
+
+    int connection_count = 0;
+    int* endpoint_names = nullptr;      // Connection -> sources then destinations, LADDER_MAX_CONN_ENDPOINTS each
+    int* endpoint_counts = nullptr;     // Connection -> source count, destination count
+
+    int* input_start = nullptr;         // Name -> first entry in input_list, name_count + 1 entries
+    int* input_list = nullptr;          // Connections listing the name as a destination
+    int* output_start = nullptr;
+    int* output_list = nullptr;         // Connections listing the name as a source
+
+    int* node_seen = nullptr;           // De-duplication scratch for node queries
+    int seen_stamp = 0;
+
+    void clear() {
+        name_count = 0;
+        node_count = 0;
+        connection_count = 0;
+    }
+
+    // Build the index for the given tables, returns false when the arena is exhausted
+    bool build(CompilerArena& arena, const LadderGraphNode* nodes, int nodes_count, const LadderConnection* connections, int connections_count) {
+        clear();
+        int bound = nodes_count;
+        for (int c = 0; c < connections_count; c++) bound += connections[c].source_count + connections[c].dest_count;
+        u32 slot_count = 16;
+        while (slot_count < (u32) bound * 2) slot_count <<= 1;
+        slot_mask = slot_count - 1;
+
+        slots = (int*) arena.alloc(slot_count * sizeof(int));
+        names = (const char**) arena.alloc((bound + 1) * sizeof(const char*));
+        name_node = (int*) arena.alloc((bound + 1) * sizeof(int));
+        node_name = (int*) arena.alloc((nodes_count + 1) * sizeof(int));
+        position_order = (int*) arena.alloc((nodes_count + 1) * sizeof(int));
+        node_seen = (int*) arena.alloc((nodes_count + 1) * sizeof(int));
+        endpoint_names = (int*) arena.alloc((connections_count * 2 * LADDER_MAX_CONN_ENDPOINTS + 1) * sizeof(int));
+        endpoint_counts = (int*) arena.alloc((connections_count * 2 + 1) * sizeof(int));
+        if (!slots || !names || !name_node || !node_name || !position_order || !node_seen || !endpoint_names || !endpoint_counts) return false;
+        seen_stamp = 0;
+
+        for (int i = 0; i < nodes_count; i++) {
+            int name = intern(nodes[i].id);
+            node_name[i] = name;
+            if (name_node[name] < 0) name_node[name] = i;
+        }
+        node_count = nodes_count;
+
+        int entries = 0;
+        for (int c = 0; c < connections_count; c++) {
+            const LadderConnection& conn = connections[c];
+            int* ends = endpoint_names + c * 2 * LADDER_MAX_CONN_ENDPOINTS;
+            for (int s = 0; s < conn.source_count; s++) ends[s] = intern(conn.sources[s]);
+            for (int d = 0; d < conn.dest_count; d++) ends[LADDER_MAX_CONN_ENDPOINTS + d] = intern(conn.destinations[d]);
+            endpoint_counts[c * 2] = conn.source_count;
+            endpoint_counts[c * 2 + 1] = conn.dest_count;
+            entries += conn.source_count + conn.dest_count;
+        }
+        connection_count = connections_count;
+
+        input_start = (int*) arena.alloc((name_count + 1) * sizeof(int));
+        output_start = (int*) arena.alloc((name_count + 1) * sizeof(int));
+        input_list = (int*) arena.alloc((entries + 1) * sizeof(int));
+        output_list = (int*) arena.alloc((entries + 1) * sizeof(int));
+        int* last = (int*) arena.alloc((name_count + 1) * sizeof(int));
+        if (!input_start || !output_start || !input_list || !output_list || !last) return false;
+        fillLists(0, output_start, output_list, last);
+        fillLists(LADDER_MAX_CONN_ENDPOINTS, input_start, input_list, last);
+
+        for (int i = 0; i < nodes_count; i++) position_order[i] = i;
+        int* scratch = (int*) arena.alloc((nodes_count + 1) * sizeof(int));
+        if (!scratch) return false;
+        positions = nodes;
+        ladderMergeSort(position_order, scratch, nodes_count, [nodes](int a, int b) {
+            return nodes[a].y < nodes[b].y || (nodes[a].y == nodes[b].y && nodes[a].x < nodes[b].x);
+        });
+        return true;
+    }
+
+    // Name of an id, -1 if it is neither a node id nor a connection endpoint
+    int find(const char* id) const {
+        if (name_count == 0) return -1;
+        u32 i = nameHash(id, idLength(id), true) & slot_mask;
+        while (slots[i] != 0) {
+            int name = slots[i] - 1;
+            if (ladderStrEqI(names[name], id)) return name;
+            i = (i + 1) & slot_mask;
+        }
+        return -1;
+    }
+
+    // First node with the given id, -1 if not found
+    int findNode(const char* id) const {
+        int name = find(id);
+        return name < 0 ? -1 : name_node[name];
+    }
+
+    int endpointCount(int connection, bool destination) const {
+        return endpoint_counts[connection * 2 + (destination ? 1 : 0)];
+    }
+
+    int endpointName(int connection, bool destination, int k) const {
+        return endpoint_names[connection * 2 * LADDER_MAX_CONN_ENDPOINTS + (destination ? LADDER_MAX_CONN_ENDPOINTS : 0) + k];
+    }
+
+    int inputCount(int name) const { return name < 0 ? 0 : input_start[name + 1] - input_start[name]; }
+    const int* inputs(int name) const { return input_list + (name < 0 ? 0 : input_start[name]); }
+    int outputCount(int name) const { return name < 0 ? 0 : output_start[name + 1] - output_start[name]; }
+    const int* outputs(int name) const { return output_list + (name < 0 ? 0 : output_start[name]); }
+
+    // True when a connection leads from one name to the other (either direction)
+    bool linked(int nameA, int nameB) const {
+        if (nameA < 0 || nameB < 0) return false;
+        return shareConnection(outputs(nameA), outputCount(nameA), inputs(nameB), inputCount(nameB))
+            || shareConnection(outputs(nameB), outputCount(nameB), inputs(nameA), inputCount(nameA));
+    }
+
+    // Nodes at (x, y) in ascending node order, returns the count and the offset in position_order
+    int positionGroup(int x, int y, int& start) const {
+        int lo = 0;
+        int hi = node_count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            const LadderGraphNode& node = positions[position_order[mid]];
+            if (node.y < y || (node.y == y && node.x < x)) lo = mid + 1;
+            else hi = mid;
+        }
+        start = lo;
+        int end = lo;
+        while (end < node_count && positions[position_order[end]].x == x && positions[position_order[end]].y == y) end++;
+        return end - lo;
+    }
+
+    // Start a new de-duplicated node query
+    void beginNodeQuery() {
+        seen_stamp++;
+    }
+
+    // Returns true the first time a node is seen in the current query
+    bool firstSeen(int nodeIdx) {
+        if (node_seen[nodeIdx] == seen_stamp) return false;
+        node_seen[nodeIdx] = seen_stamp;
+        return true;
+    }
+
+private:
+    const LadderGraphNode* positions = nullptr;
+
+    static bool shareConnection(const int* a, int countA, const int* b, int countB) {
+        int i = 0, j = 0;
+        while (i < countA && j < countB) {
+            if (a[i] == b[j]) return true;
+            if (a[i] < b[j]) i++;
+            else j++;
+        }
+        return false;
+    }
+
+    static int idLength(const char* id) {
+        int length = 0;
+        while (id[length]) length++;
+        return length;
+    }
+
+    int intern(const char* id) {
+        u32 i = nameHash(id, idLength(id), true) & slot_mask;
+        while (slots[i] != 0) {
+            int name = slots[i] - 1;
+            if (ladderStrEqI(names[name], id)) return name;
+            i = (i + 1) & slot_mask;
+        }
+        int name = name_count++;
+        slots[i] = name + 1;
+        names[name] = id;
+        name_node[name] = -1;
+        return name;
+    }
+
+    // Count, offset and fill one side (sources at 0, destinations at LADDER_MAX_CONN_ENDPOINTS) of the endpoint lists
+    void fillLists(int side, int* start, int* list, int* last) {
+        for (int n = 0; n <= name_count; n++) { start[n] = 0; last[n] = -1; }
+        for (int c = 0; c < connection_count; c++) {
+            int count = endpoint_counts[c * 2 + (side ? 1 : 0)];
+            const int* ends = endpoint_names + c * 2 * LADDER_MAX_CONN_ENDPOINTS + side;
+            for (int k = 0; k < count; k++) {
+                if (last[ends[k]] == c) continue;
+                last[ends[k]] = c;
+                start[ends[k] + 1]++;
+            }
+        }
+        for (int n = 0; n < name_count; n++) start[n + 1] += start[n];
+        for (int n = 0; n < name_count; n++) last[n] = -1;
+        for (int c = 0; c < connection_count; c++) {
+            int count = endpoint_counts[c * 2 + (side ? 1 : 0)];
+            const int* ends = endpoint_names + c * 2 * LADDER_MAX_CONN_ENDPOINTS + side;
+            for (int k = 0; k < count; k++) {
+                int name = ends[k];
+                if (last[name] == c) continue;
+                last[name] = c;
+                list[start[name]++] = c;
+            }
+        }
+        // The fill pass advanced every start to the next name's start, shift them back
+        for (int n = name_count; n > 0; n--) start[n] = start[n - 1];
+        start[0] = 0;
+    }
+};
+
+#endif // __WASM__
@@ -26,6 +26,7 @@
 
 #include "ladder-types.h"
 #include "ladder-node-types.h"
+#include "ladder-graph-index.h"
 
 // Note: strcpy is provided by wasm/jvmalloc.h via parent files
 
@@ -44,11 +45,13 @@ protected:
     char error_msg[256];
     bool has_error;
 
-    // Graph data
-    LadderGraphNode nodes[LADDER_MAX_NODES];
+    // Graph data, the tables and the index live in graph_arena and are rebuilt by parseGraph()
+    CompilerArena graph_arena;
+    ArenaTable<LadderGraphNode> nodes;
     int node_count;
-    LadderConnection connections[LADDER_MAX_CONNECTIONS];
+    ArenaTable<LadderConnection> connections;
     int connection_count;
+    LadderGraphIndex graph_index;
 
 public:
     LadderJsonParser() : source(nullptr), length(0), pos(0), has_error(false), node_count(0), connection_count(0) {
@@ -372,6 +375,11 @@ public:
     }
 
     bool parseGraph() {
+        graph_arena.reset();
+        nodes.release();
+        connections.release();
+        graph_index.clear();
+
         if (!expect('{')) {
             setError("Expected JSON object");
             return false;
@@ -393,6 +401,10 @@ public:
                         setError("Too many nodes");
                         return false;
                     }
+                    if (!nodes.reserve(graph_arena, node_count + 1, LADDER_MAX_NODES)) {
+                        setError("Out of memory for nodes");
+                        return false;
+                    }
                     if (!parseNode(nodes[node_count])) return false;
                     node_count++;
                     skipWhitespace();
@@ -407,6 +419,10 @@ public:
                         setError("Too many connections");
                         return false;
                     }
+                    if (!connections.reserve(graph_arena, connection_count + 1, LADDER_MAX_CONNECTIONS)) {
+                        setError("Out of memory for connections");
+                        return false;
+                    }
                     if (!parseConnection(connections[connection_count])) return false;
                     connection_count++;
                     skipWhitespace();
@@ -441,74 +457,123 @@ public:
 
     // ============ Connection Normalization ============
 
-    // Helper: Check if a string is already in an array
-    bool stringInArray(const char* str, char arr[][32], int count) {
-        for (int i = 0; i < count; i++) {
-            if (ladderStrEqI(arr[i], str)) return true;
-        }
+    // Build graph_index for the current tables, returns false when the arena is exhausted
+    bool buildGraphIndex() {
+        if (graph_index.build(graph_arena, nodes.data, node_count, connections.data, connection_count)) return true;
+        graph_index.clear();
+        setError("Out of memory for ladder graph index");
         return false;
     }
 
-    // Helper: Check if two connections share any source or destination
-    bool connectionsShareEndpoints(const LadderConnection& a, const LadderConnection& b) {
-        // Check if they share any sources
-        for (int i = 0; i < a.source_count; i++) {
-            for (int j = 0; j < b.source_count; j++) {
-                if (ladderStrEqI(a.sources[i], b.sources[j])) return true;
-            }
+    // Normalize connections: merge all connections that share sources or destinations
+    // This creates many-to-many relationships for parallel power transfer detection
+    //
+    // Connections are merged in the order of the original pairwise scan: the
+    // first connection that shares an endpoint with a later one absorbs the
+    // lowest such connection, again and again, before the next one is looked
+    // at. The candidates come from the index (connections that list one of the
+    // absorbed names on the same side), kept in a min-heap so each merge costs
+    // a few heap steps instead of a rescan of all pairs.
+    bool normalizeConnections() {
+        if (connection_count < 2) return true;
+        CompilerArenaScope scope(graph_arena);
+        if (!buildGraphIndex()) return false;
+        LadderGraphIndex& index = graph_index;
+
+        int entries = index.input_start[index.name_count] + index.output_start[index.name_count];
+        int* source_mark = (int*) graph_arena.alloc((index.name_count + 1) * sizeof(int));
+        int* dest_mark = (int*) graph_arena.alloc((index.name_count + 1) * sizeof(int));
+        bool* merged = (bool*) graph_arena.alloc(connection_count + 1);
+        int* pending = (int*) graph_arena.alloc((entries + 1) * sizeof(int));
+        if (!source_mark || !dest_mark || !merged || !pending) {
+            graph_index.clear();
+            setError("Out of memory for ladder graph index");
+            return false;
         }
-        // Check if they share any destinations
-        for (int i = 0; i < a.dest_count; i++) {
-            for (int j = 0; j < b.dest_count; j++) {
-                if (ladderStrEqI(a.destinations[i], b.destinations[j])) return true;
+
+        for (int i = 0; i < connection_count; i++) {
+            if (merged[i]) continue;
+            LadderConnection& root = connections[i];
+            int pending_count = 0;
+            for (int s = 0; s < root.source_count; s++) {
+                int name = index.endpointName(i, false, s);
+                if (source_mark[name] == i + 1) continue;
+                source_mark[name] = i + 1;
+                pushCandidates(pending, pending_count, index.outputs(name), index.outputCount(name), i, merged);
+            }
+            for (int d = 0; d < root.dest_count; d++) {
+                int name = index.endpointName(i, true, d);
+                if (dest_mark[name] == i + 1) continue;
+                dest_mark[name] = i + 1;
+                pushCandidates(pending, pending_count, index.inputs(name), index.inputCount(name), i, merged);
             }
-        }
-        return false;
-    }
 
-    // Helper: Merge connection b into connection a (adding unique sources/destinations)
-    void mergeConnections(LadderConnection& a, const LadderConnection& b) {
-        // Merge sources
-        for (int i = 0; i < b.source_count; i++) {
-            if (!stringInArray(b.sources[i], a.sources, a.source_count)) {
-                if (a.source_count < LADDER_MAX_CONN_ENDPOINTS) {
-                    strcpy(a.sources[a.source_count], b.sources[i]);
-                    a.source_count++;
+            while (pending_count > 0) {
+                int j = popCandidate(pending, pending_count);
+                if (merged[j]) continue;
+                merged[j] = true;
+                // Merge j into i, adding its unique sources/destinations while there is room
+                const LadderConnection& other = connections[j];
+                for (int s = 0; s < other.source_count; s++) {
+                    int name = index.endpointName(j, false, s);
+                    if (source_mark[name] == i + 1 || root.source_count >= LADDER_MAX_CONN_ENDPOINTS) continue;
+                    strcpy(root.sources[root.source_count], other.sources[s]);
+                    root.source_count++;
+                    source_mark[name] = i + 1;
+                    pushCandidates(pending, pending_count, index.outputs(name), index.outputCount(name), i, merged);
                 }
-            }
-        }
-        // Merge destinations
-        for (int i = 0; i < b.dest_count; i++) {
-            if (!stringInArray(b.destinations[i], a.destinations, a.dest_count)) {
-                if (a.dest_count < LADDER_MAX_CONN_ENDPOINTS) {
-                    strcpy(a.destinations[a.dest_count], b.destinations[i]);
-                    a.dest_count++;
+                for (int d = 0; d < other.dest_count; d++) {
+                    int name = index.endpointName(j, true, d);
+                    if (dest_mark[name] == i + 1 || root.dest_count >= LADDER_MAX_CONN_ENDPOINTS) continue;
+                    strcpy(root.destinations[root.dest_count], other.destinations[d]);
+                    root.dest_count++;
+                    dest_mark[name] = i + 1;
+                    pushCandidates(pending, pending_count, index.inputs(name), index.inputCount(name), i, merged);
                 }
             }
         }
+
+        // Drop the merged connections, keeping the order of the rest
+        int kept = 0;
+        for (int i = 0; i < connection_count; i++) {
+            if (merged[i]) continue;
+            if (kept != i) connections[kept] = connections[i];
+            kept++;
+        }
+        connection_count = kept;
+        graph_index.clear();  // Built for the old tables, its memory goes with the scope
+        return true;
     }
 
-    // Normalize connections: merge all connections that share sources or destinations
-    // This creates many-to-many relationships for parallel power transfer detection
-    void normalizeConnections() {
-        bool merged;
-        do {
-            merged = false;
-            for (int i = 0; i < connection_count && !merged; i++) {
-                for (int j = i + 1; j < connection_count && !merged; j++) {
-                    if (connectionsShareEndpoints(connections[i], connections[j])) {
-                        // Merge j into i
-                        mergeConnections(connections[i], connections[j]);
-                        // Remove j by shifting remaining connections down
-                        for (int k = j; k < connection_count - 1; k++) {
-                            connections[k] = connections[k + 1];
-                        }
-                        connection_count--;
-                        merged = true; // Restart the loop
-                    }
-                }
+private:
+    // Min-heap of connection indices waiting to be merged into the current root
+    static void pushCandidates(int* pending, int& pending_count, const int* list, int count, int root, const bool* merged) {
+        for (int k = 0; k < count; k++) {
+            int c = list[k];
+            if (c <= root || merged[c]) continue;
+            int at = pending_count++;
+            while (at > 0 && pending[(at - 1) / 2] > c) {
+                pending[at] = pending[(at - 1) / 2];
+                at = (at - 1) / 2;
             }
-        } while (merged);
+            pending[at] = c;
+        }
+    }
+
+    static int popCandidate(int* pending, int& pending_count) {
+        int top = pending[0];
+        int last = pending[--pending_count];
+        int at = 0;
+        while (true) {
+            int child = at * 2 + 1;
+            if (child >= pending_count) break;
+            if (child + 1 < pending_count && pending[child + 1] < pending[child]) child++;
+            if (pending[child] >= last) break;
+            pending[at] = pending[child];
+            at = child;
+        }
+        if (pending_count > 0) pending[at] = last;
+        return top;
     }
 };
 
@@ -31,8 +31,10 @@
 // Constants
 // ============================================================================
 
-static const int LADDER_MAX_NODES = 256;
-static const int LADDER_MAX_CONNECTIONS = 256;
+// Graph tables grow on demand (see LadderJsonParser), these are the upper limits
+static const int LADDER_MAX_NODES = 8192;
+static const int LADDER_MAX_CONNECTIONS = 8192;
+static const int LADDER_MAX_FAN = 256;  // Max sources/destinations of a single node returned by one query
 static const int LADDER_MAX_CONN_ENDPOINTS = 16;  // Max sources/destinations per connection
 static const int LADDER_MAX_OUTPUT = 32768;
 
@@ -102,7 +104,7 @@ struct LadderConnection {
 // ============================================================================
 
 struct LadderOutputGroup {
-    int nodeIndices[LADDER_MAX_NODES];
+    int nodeIndices[LADDER_MAX_FAN];
     int count;
     int conditionSourceIdx;  // -1 if multiple sources
 
@@ -78,6 +78,7 @@ static u32 plcasm_counter_offset = PLCRUNTIME_COUNTER_OFFSET;
 
 #define MAX_ASSEMBLY_STRING_SIZE 64535
 #define MAX_NUM_OF_TOKENS 10000
+#define PLCASM_NAME_INDEX_SIZE 16384 // Power of two above MAX_NUM_OF_TOKENS
 
 // ################################################################################################
 // ### Example (0.1 + 0.2) * -1 = -0.3
@@ -234,6 +235,8 @@ int printTokenType(TokenType type) {
     return printf("unknown");
 }
 
+struct PLCASMIRRecord;
+
 struct Token {
     StringView string;
     int length;
@@ -243,6 +246,7 @@ struct Token {
     int value_int;
     float value_float;
     TokenType type;
+    const PLCASMIRRecord* record; // Instruction record the token was built from (plcasm-ir.h), nullptr for lexed text
     // Array operator get/set
     char& operator[](int index) {
         return string[index];
@@ -759,6 +763,36 @@ const char lex_dividers [] = { '(', ')', '=', '+', '-', '*', '/', '%', '&', '|',
 const char* data_type_keywords [] = { "i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64", "f32", "f64", "bool", "string", "bit", "byte", "ptr", "pointer", "*", "char", "str8", "str16" };
 const int data_type_keywords_count = sizeof(data_type_keywords) / sizeof(data_type_keywords[0]);
 
+// Data type named by the start of `name` ("u8", "u8.add"), returns true when there is none
+bool plcasmTypeFromName(StringView name, u8& type) {
+    for (int i = 0; i < data_type_keywords_count; i++) {
+        if (name.startsWithNoCase(data_type_keywords[i])) {
+            switch (i) {
+                case 0:  type = type_i8; break;
+                case 1:  type = type_i16; break;
+                case 2:  type = type_i32; break;
+                case 3:  type = type_i64; break;
+                case 4:  type = type_u8; break;
+                case 5:  type = type_u16; break;
+                case 6:  type = type_u32; break;
+                case 7:  type = type_u64; break;
+                case 8:  type = type_f32; break;
+                case 9:  type = type_f64; break;
+                case 10: type = type_bool; break;
+                case 11: return false; // type = type_string; break; // TODO: Add support for strings
+                case 12: type = type_bool; break;
+                case 13: type = type_u8; break;
+                case 14: type = type_pointer; break;
+                case 15: type = type_pointer; break;
+                case 16: type = type_pointer; break;
+                default: return true;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 // Check if token is exactly a data type keyword (case-insensitive), or ends with .const/.push
 bool isPushTypedValue(Token& token) {
     // Check for .const or .push suffix
@@ -818,39 +852,62 @@ struct Symbol {
 // DataBlock declarations now use the global registry in shared-symbols.h
 // (GlobalDBField, GlobalDBDecl, findGlobalDBDecl, etc.)
 
+#include "plcasm-mnemonics.h"
+#include "plcasm-ir.h"
+#include "compiler-arena.h"
+
 class PLCASMCompiler {
 public:
     int built_bytecode_length = 0;
     u8 built_bytecode_checksum = 0;
 
     char assembly_string[MAX_ASSEMBLY_STRING_SIZE] = { 0 };
+    PLCASMInstructionIR* instruction_ir = nullptr; // Optional generated PLCASM records spliced into assembly_string
+    char* listing = nullptr; // assembly_string with the records rendered in, built on first use (sourceText())
+
+    // Working tables live in `arena`, which is rewound at the start of every tokenize(). Symbols are
+    // filled in before a compile (project symbols), so they keep their own arena and their capacity.
+    CompilerArena arena;
+    CompilerArena symbol_arena;
 
-    Token tokens[MAX_NUM_OF_TOKENS];
+    ArenaTable<Token> tokens;
     int token_count = 0;
     int token_count_temp = 0;
 
     int line = 1;
     int column = 1;
 
-    struct LUT_label LUT_labels[MAX_NUM_OF_TOKENS];
+    ArenaTable<LUT_label> LUT_labels;
     int LUT_label_count = 0;
 
-    struct LUT_const LUT_consts[MAX_NUM_OF_TOKENS];
+    ArenaTable<LUT_const> LUT_consts;
     int LUT_const_count = 0;
 
-    struct Symbol symbols[MAX_NUM_OF_TOKENS];
+    ArenaTable<Symbol> symbols;
     int symbol_count = 0;
     int base_symbol_count = 0; // Symbols added externally (before compilation)
 
+    // Name -> entry indexes for the tables above (see NameHashIndex in shared-symbols.h)
+    NameHashIndex<PLCASM_NAME_INDEX_SIZE> symbol_index;
+    NameHashIndex<PLCASM_NAME_INDEX_SIZE> label_index;
+    NameHashIndex<PLCASM_NAME_INDEX_SIZE> const_index;
+    u32 name_generation = 0; // Bumped by namesChanged()
+
     u8 built_bytecode[PLCRUNTIME_MAX_PROGRAM_SIZE];
 
-    ProgramLine programLines[PLCRUNTIME_MAX_PROGRAM_SIZE];
+    ArenaTable<ProgramLine> programLines; // Staging lines, only the kept CONFIG_DB/default lines advance programLineCount
     int programLineCount = 0;
 
     bool last_token_is_exit = false;
     int num_of_compile_runs = 0;
     bool emit_warnings = false;
 
+    // Superinstruction fusion (peephole pass over the linked bytecode, see fuseSuperinstructions())
+    // Off by default: runtimes built before the fused opcodes existed reject them
+    bool fuse_superinstructions = false;
+    u32* fuse_offset_map = nullptr; // Old byte offset -> new byte offset (arena, length + 1 entries)
+    u8* fuse_marks = nullptr;       // FUSE_MARK_* per old byte offset (arena)
+
     // IR (Intermediate Representation) output
     IR_Entry ir_entries[MAX_IR_ENTRIES];
     int ir_entry_count = 0;
@@ -865,12 +922,7 @@ public:
 
     PLCASMCompiler() {
 
-        memset(tokens, 0, sizeof(tokens));
-        memset(LUT_labels, 0, sizeof(LUT_labels));
-        memset(LUT_consts, 0, sizeof(LUT_consts));
-        memset(symbols, 0, sizeof(symbols));
         memset(built_bytecode, 0, sizeof(built_bytecode));
-        memset(programLines, 0, sizeof(programLines));
         memset(downloaded_program, 0, sizeof(downloaded_program));
         memset(ir_entries, 0, sizeof(ir_entries));
         // Default assembly string
@@ -1529,17 +1581,16 @@ public:
         }
 
         // Check for duplicate symbol names
-        for (int i = 0; i < symbol_count; i++) {
-            if (str_cmp(symbols[i].name, name.string)) {
-                Serial.print(F("Error: duplicate symbol '"));
-                name.string.print();
-                Serial.print(F("' at line "));
-                Serial.print(name.line);
-                Serial.print(F(" (first defined at line "));
-                Serial.print(symbols[i].line);
-                Serial.println(F(")"));
-                return true;
-            }
+        Symbol* existing = findSymbol(name.string);
+        if (existing) {
+            Serial.print(F("Error: duplicate symbol '"));
+            name.string.print();
+            Serial.print(F("' at line "));
+            Serial.print(name.line);
+            Serial.print(F(" (first defined at line "));
+            Serial.print(existing->line);
+            Serial.println(F(")"));
+            return true;
         }
 
         // Validate type
@@ -1625,6 +1676,10 @@ public:
             Serial.println(F(")"));
             return true;
         }
+        if (!reserveSymbols(symbol_count + 1)) {
+            Serial.println(F("Error: out of memory for symbols"));
+            return true;
+        }
 
         Symbol& sym = symbols[symbol_count];
         sym.name = name.string;
@@ -1636,26 +1691,48 @@ public:
         sym.column = name.column;
         sym.type_size = type_size;
 
+        symbol_index.insert(nameHash(sym.name.data, sym.name.length, false), symbol_count);
         symbol_count++;
 
         return false;
     }
 
-    Symbol* findSymbol(const StringView& name) {
-        for (int i = 0; i < symbol_count; i++) {
-            if (str_cmp(symbols[i].name, name)) {
-                return &symbols[i];
-            }
+    // Call after truncating the symbol, label or const table or writing it from outside
+    void namesChanged() { name_generation++; }
+
+    // Re-index a table that changed other than by an indexed append
+    template <typename Entry>
+    void syncNameIndex(NameHashIndex<PLCASM_NAME_INDEX_SIZE>& index, Entry* entries, int count, StringView Entry::* name) {
+        if (!index.stale(name_generation, count)) return;
+        index.rebuild(name_generation);
+        for (int i = 0; i < count; i++) {
+            const StringView& key = entries[i].*name;
+            index.insert(nameHash(key.data, key.length, false), i);
         }
-        return nullptr;
+    }
+
+    Symbol* findSymbol(const StringView& name) {
+        syncNameIndex(symbol_index, symbols.data, symbol_count, &Symbol::name);
+        int i = symbol_index.find(nameHash(name.data, name.length, false), [&](int i) { return str_cmp(symbols[i].name, name); });
+        return i < 0 ? nullptr : &symbols[i];
+    }
+
+    LUT_label* findLabel(const StringView& name) {
+        syncNameIndex(label_index, LUT_labels.data, LUT_label_count, &LUT_label::string);
+        int i = label_index.find(nameHash(name.data, name.length, false), [&](int i) { return str_cmp(LUT_labels[i].string, name); });
+        return i < 0 ? nullptr : &LUT_labels[i];
+    }
+
+    LUT_const* findConst(const StringView& name) {
+        syncNameIndex(const_index, LUT_consts.data, LUT_const_count, &LUT_const::string);
+        int i = const_index.find(nameHash(name.data, name.length, false), [&](int i) { return str_cmp(LUT_consts[i].string, name); });
+        return i < 0 ? nullptr : &LUT_consts[i];
     }
 
     bool add_label(Token& token, int address) {
-        for (int i = 0; i < LUT_label_count; i++) {
-            if (str_cmp(LUT_labels[i].string, token.string)) {
-                Serial.print(F("Error: duplicate label. Label ")); token.print(); Serial.print(F(" already exists at ")); Serial.print(token.line); Serial.print(F(":")); Serial.println(token.column);
-                return true;
-            }
+        if (findLabel(token.string)) {
+            Serial.print(F("Error: duplicate label. Label ")); token.print(); Serial.print(F(" already exists at ")); Serial.print(token.line); Serial.print(F(":")); Serial.println(token.column);
+            return true;
         }
         for (int i = 0; i < illegal_keywords_count; i++) {
             if (str_cmp(token.string, illegal_keywords[i])) {
@@ -1667,18 +1744,21 @@ public:
             Serial.print(F("Error: too many labels. Max number of labels is")); Serial.println(MAX_NUM_OF_TOKENS);
             return true;
         }
+        if (!LUT_labels.reserve(arena, LUT_label_count + 1, MAX_NUM_OF_TOKENS)) {
+            Serial.println(F("Error: out of memory for labels"));
+            return true;
+        }
         LUT_labels[LUT_label_count].string = token.string;
         LUT_labels[LUT_label_count].address = -1;
+        label_index.insert(nameHash(token.string.data, token.string.length, false), LUT_label_count);
         LUT_label_count++;
         return false;
     }
 
     bool add_const(Token& keyword, Token& value, int address) {
-        for (int i = 0; i < LUT_const_count; i++) {
-            if (str_cmp(LUT_consts[i].string, keyword.string)) {
-                Serial.print(F("Error: duplicate const. Const ")); keyword.print(); Serial.print(F(" already exists at ")); Serial.print(keyword.line); Serial.print(F(":")); Serial.println(keyword.column);
-                return true;
-            }
+        if (findConst(keyword.string)) {
+            Serial.print(F("Error: duplicate const. Const ")); keyword.print(); Serial.print(F(" already exists at ")); Serial.print(keyword.line); Serial.print(F(":")); Serial.println(keyword.column);
+            return true;
         }
         for (int i = 0; i < illegal_keywords_count; i++) {
             if (str_cmp(keyword.string, illegal_keywords[i])) {
@@ -1690,6 +1770,10 @@ public:
             Serial.print(F("Error: too many consts. Max number of consts is")); Serial.println(MAX_NUM_OF_TOKENS);
             return true;
         }
+        if (!LUT_consts.reserve(arena, LUT_const_count + 1, MAX_NUM_OF_TOKENS)) {
+            Serial.println(F("Error: out of memory for consts"));
+            return true;
+        }
         LUT_consts[LUT_const_count].string = keyword.string;
         LUT_consts[LUT_const_count].address = address;
         LUT_consts[LUT_const_count].value_string = value.string;
@@ -1709,6 +1793,7 @@ public:
             LUT_consts[LUT_const_count].type = VAL_STRING;
             LUT_consts[LUT_const_count].value_string = value.string;
         }
+        const_index.insert(nameHash(keyword.string.data, keyword.string.length, false), LUT_const_count);
         LUT_const_count++;
         return false;
     }
@@ -1719,12 +1804,17 @@ public:
             Serial.print(F("Error: too many tokens. Max number of tokens is")); Serial.println(MAX_NUM_OF_TOKENS);
             return true;
         }
+        if (!tokens.reserve(arena, token_count_temp + 1, MAX_NUM_OF_TOKENS)) {
+            Serial.println(F("Error: out of memory for tokens"));
+            return true;
+        }
         Token& token = tokens[token_count_temp];
         token.string.data = string;
         token.string.length = length;
         token.length = length;
         token.line = line;
         token.column = column;
+        token.record = nullptr;
         token.parse();
         if (token.type == TOKEN_UNKNOWN) {
             Serial.print(F("Error: unknown token ")); token.print(); Serial.print(F(" at ")); Serial.print(line); Serial.print(F(":")); Serial.println(column);
@@ -1815,19 +1905,141 @@ public:
         return add_token(string, length);
     }
 
+    // Rewind the working tables for a new program
+    void resetTables() {
+        arena.reset();
+        tokens.release();
+        LUT_labels.release();
+        LUT_consts.release();
+        programLines.release();
+        fuse_offset_map = nullptr;
+        fuse_marks = nullptr;
+        listing = nullptr;
+    }
+
+    // Make room for symbols written directly into the table (project symbols)
+    bool reserveSymbols(int count) {
+        return symbols.reserve(symbol_arena, count, MAX_NUM_OF_TOKENS);
+    }
+
+    // Staging line for the next instruction. Lines are never read back once emitted,
+    // so if the table can not grow the last line is reused.
+    // Make room for the next staging line, false when the arena is exhausted
+    bool reserveProgramLine() {
+        return programLines.reserve(arena, programLineCount + 1, PLCRUNTIME_MAX_PROGRAM_SIZE);
+    }
+
     bool tokenize() {
+        resetTables();
         token_count = 0; // Fix: Reset token count
+        token_count_temp = 0; // A failed tokenize leaves its partial count behind
         LUT_label_count = 0;
         LUT_const_count = 0;
+        namesChanged();
         db_brace_depth = 0; // Reset brace depth tracking
-        char* token_start = assembly_string;
-        int token_length = 0;
         int assembly_string_length = string_len(assembly_string);
+        bool error = false;
+        int text_start = 0;
+        // Splice the segments of the instruction IR between the text parts
+        int segment_count = instruction_ir ? instruction_ir->segment_count : 0;
+        for (int s = 0; s < segment_count; s++) {
+            PLCASMIRSegment& segment = instruction_ir->segments[s];
+            int text_end = (int) segment.text_offset;
+            if (text_end > assembly_string_length) text_end = assembly_string_length;
+            error = tokenizeText(text_start, text_end);
+            if (error) return error;
+            error = tokenizeSegment(segment);
+            if (error) return error;
+            text_start = text_end;
+        }
+        error = tokenizeText(text_start, assembly_string_length);
+        if (error) return error;
+        if (!last_token_is_exit) {
+            // The implicit exit gets a line of its own so same-line operand lists never consume it
+            line++;
+            column = 1;
+            error = add_token((char*) "exit", 4);
+            if (error) return error;
+        }
+        token_count = token_count_temp;
+        token_count_temp = 0;
+        line = 1;
+        column = 1;
+        return false;
+    }
+
+    // Build the tokens of a segment straight from its records. Lines and columns are those of the
+    // rendered listing at the current position, the instruction tokens keep their record.
+    bool tokenizeSegment(const PLCASMIRSegment& segment) {
+        static char colon[] = ":";
+        char* pool = instruction_ir->pool.data;
+        bool error = false;
+        for (u32 r = segment.record_start; r < segment.record_end; r++) {
+            const PLCASMIRRecord& record = instruction_ir->records[r];
+            column = 1;
+            if (record.kind == PLCASM_IR_COMMENT) {
+                line += instruction_ir->lines(r, r + 1);
+                continue;
+            }
+            error = add_token(pool + record.text, record.length);
+            if (error) return error;
+            column += record.length;
+            if (record.kind == PLCASM_IR_LABEL) {
+                error = add_token(colon, 1);
+                if (error) return error;
+            } else {
+                tokens[token_count_temp - 1].record = &record;
+            }
+            for (int o = 0; o < record.operand_count; o++) {
+                const PLCASMIROperand& operand = instruction_ir->operands[record.operand_start + o];
+                char* text = pool + operand.text;
+                column++;
+                if (operand.form == PLCASM_IR_STRING) {
+                    // Quote, content and quote, as the text lexer hands them over
+                    int content = (int) operand.length - 2;
+                    error = add_token(text, 1);
+                    if (error) return error;
+                    column++;
+                    error = add_token_optional(text + 1, content);
+                    if (error) return error;
+                    column += content;
+                    error = add_token(text + 1 + content, 1);
+                    if (error) return error;
+                    column++;
+                } else {
+                    error = add_token(text, operand.length);
+                    if (error) return error;
+                    column += operand.length;
+                }
+            }
+            line++;
+        }
+        column = 1;
+        return false;
+    }
+
+    // The assembly text with the instruction records rendered in, which token lines and columns refer to
+    const char* sourceText() {
+        if (!instruction_ir || instruction_ir->segment_count == 0) return assembly_string;
+        if (listing) return listing;
+        int text_length = string_len(assembly_string);
+        int length = instruction_ir->renderListing(assembly_string, text_length, nullptr, 0);
+        listing = (char*) arena.alloc((u32) length + 1);
+        if (!listing) return assembly_string;
+        instruction_ir->renderListing(assembly_string, text_length, listing, length);
+        return listing;
+    }
+
+    // Lex assembly_string[from, to) into tokens
+    bool tokenizeText(int from, int to) {
+        char* token_start = assembly_string + from;
+        int token_length = 0;
+        int assembly_string_length = to;
 
         bool in_string = false;
         char string_char = '\0';  // The quote character that started the string (' or ")
         bool error = false;
-        for (int i = 0; i < assembly_string_length; i++) {
+        for (int i = from; i < assembly_string_length; i++) {
             char c = assembly_string[i];
 
             // Inside a string - accumulate all characters except unescaped string terminator or newline
@@ -1973,51 +2185,19 @@ public:
             if (token_length == 0) token_start = assembly_string + i;
             token_length++;
         }
-        error = add_token_optional(token_start, token_length);
-        if (error) return error;
-        if (!last_token_is_exit) {
-            error = add_token((char*) "exit", 4);
-            if (error) return error;
-        }
-        token_count = token_count_temp;
-        token_count_temp = 0;
-        line = 1;
-        column = 1;
-        return false;
+        return add_token_optional(token_start, token_length);
     }
 
     bool typeFromToken(Token& token, u8& type) {
-        if (token.type == TOKEN_KEYWORD) {
-            // "u8" = type_u8 (case-insensitive)
-            for (int i = 0; i < data_type_keywords_count; i++) {
-                if (token.startsWithNoCase(data_type_keywords[i])) {
-                    switch (i) {
-                        case 0:  type = type_i8; break;
-                        case 1:  type = type_i16; break;
-                        case 2:  type = type_i32; break;
-                        case 3:  type = type_i64; break;
-                        case 4:  type = type_u8; break;
-                        case 5:  type = type_u16; break;
-                        case 6:  type = type_u32; break;
-                        case 7:  type = type_u64; break;
-                        case 8:  type = type_f32; break;
-                        case 9:  type = type_f64; break;
-                        case 10: type = type_bool; break;
-                        case 11: return false; // type = type_string; break; // TODO: Add support for strings
-                        case 12: type = type_bool; break;
-                        case 13: type = type_u8; break;
-                        case 14: type = type_pointer; break;
-                        case 15: type = type_pointer; break;
-                        case 16: type = type_pointer; break;
-                        default: return true;
-                    }
-                    return false;
-                }
-            }
-        }
+        // "u8" = type_u8 (case-insensitive)
+        if (token.type == TOKEN_KEYWORD) return plcasmTypeFromName(token.string, type);
         return true;
     }
 
+    const PLCASMMnemonic* mnemonicFromToken(Token& token, u8 data_type) {
+        return plcasmResolveMnemonic(token.string.data, token.string.length, data_type);
+    }
+
     int typeSize(u8& type) {
         switch ((PLCRuntimeInstructionSet) type) {
             case type_bool: case type_i8: case type_u8: return 8;
@@ -2043,26 +2223,25 @@ public:
             return false;
         }
         if (token.type == TOKEN_KEYWORD) {
-            for (int i = 0; i < LUT_const_count; i++) {
-                LUT_const& c = LUT_consts[i];
-                if (str_cmp(token, c.string)) {
-                    if (c.type == VAL_BOOLEAN) {
-                        token.string = c.string;
-                        output = c.value_bool;
-                        return false;
-                    }
-                    if (c.type == VAL_INTEGER) {
-                        token.string = c.string;
-                        output = c.value_int != 0;
-                        return false;
-                    }
-                    if (c.type == VAL_REAL) {
-                        token.string = c.string;
-                        output = c.value_float != 0;
-                        return false;
-                    }
-                    return true;
+            LUT_const* found = findConst(token.string);
+            if (found) {
+                LUT_const& c = *found;
+                if (c.type == VAL_BOOLEAN) {
+                    token.string = c.string;
+                    output = c.value_bool;
+                    return false;
+                }
+                if (c.type == VAL_INTEGER) {
+                    token.string = c.string;
+                    output = c.value_int != 0;
+                    return false;
+                }
+                if (c.type == VAL_REAL) {
+                    token.string = c.string;
+                    output = c.value_float != 0;
+                    return false;
                 }
+                return true;
             }
         }
         return true;
@@ -2078,26 +2257,25 @@ public:
             return false;
         }
         if (token.type == TOKEN_KEYWORD) {
-            for (int i = 0; i < LUT_const_count; i++) {
-                LUT_const& c = LUT_consts[i];
-                if (str_cmp(token, c.string)) {
-                    if (c.type == VAL_BOOLEAN) {
-                        token.string = c.string;
-                        output = c.value_bool;
-                        return false;
-                    }
-                    if (c.type == VAL_INTEGER) {
-                        token.string = c.string;
-                        output = c.value_int;
-                        return false;
-                    }
-                    if (c.type == VAL_REAL) {
-                        token.string = c.string;
-                        output = c.value_float;
-                        return false;
-                    }
-                    return true;
+            LUT_const* found = findConst(token.string);
+            if (found) {
+                LUT_const& c = *found;
+                if (c.type == VAL_BOOLEAN) {
+                    token.string = c.string;
+                    output = c.value_bool;
+                    return false;
                 }
+                if (c.type == VAL_INTEGER) {
+                    token.string = c.string;
+                    output = c.value_int;
+                    return false;
+                }
+                if (c.type == VAL_REAL) {
+                    token.string = c.string;
+                    output = c.value_float;
+                    return false;
+                }
+                return true;
             }
         }
         return true;
@@ -2145,7 +2323,7 @@ public:
         Serial.print(F(" is outside size ")); Serial.print(size);
         Serial.print(F(" -> ")); token.print();
         Serial.print(F(" at line ")); Serial.print(token.line); Serial.print(F(":")); Serial.println(token.column);
-        token.highlight(assembly_string);
+        token.highlight(sourceText());
     }
 
     bool parsePrefixedAddressToken(Token& token, StringView& number, int& offset, int& multiplier) {
@@ -2237,26 +2415,25 @@ public:
             return false;
         }
         if (token.type == TOKEN_KEYWORD) {
-            for (int i = 0; i < LUT_const_count; i++) {
-                LUT_const& c = LUT_consts[i];
-                if (str_cmp(token, c.string)) {
-                    if (c.type == VAL_BOOLEAN) {
-                        token.string = c.string;
-                        output = c.value_bool;
-                        return false;
-                    }
-                    if (c.type == VAL_INTEGER) {
-                        token.string = c.string;
-                        output = c.value_int;
-                        return false;
-                    }
-                    if (c.type == VAL_REAL) {
-                        token.string = c.string;
-                        output = c.value_float;
-                        return false;
-                    }
-                    return true;
+            LUT_const* found = findConst(token.string);
+            if (found) {
+                LUT_const& c = *found;
+                if (c.type == VAL_BOOLEAN) {
+                    token.string = c.string;
+                    output = c.value_bool;
+                    return false;
+                }
+                if (c.type == VAL_INTEGER) {
+                    token.string = c.string;
+                    output = c.value_int;
+                    return false;
+                }
+                if (c.type == VAL_REAL) {
+                    token.string = c.string;
+                    output = c.value_float;
+                    return false;
                 }
+                return true;
             }
         }
         return true;
@@ -2403,12 +2580,10 @@ public:
 
     bool labelFromToken(Token& token, int& output) {
         if (token.type == TOKEN_KEYWORD) {
-            for (int i = 0; i < LUT_label_count; i++) {
-                LUT_label& l = LUT_labels[i];
-                if (str_cmp(token, l.string)) {
-                    output = l.address;
-                    return false;
-                }
+            LUT_label* l = findLabel(token.string);
+            if (l) {
+                output = l->address;
+                return false;
             }
         }
         if (token.type == TOKEN_INTEGER) {
@@ -2420,7 +2595,7 @@ public:
 
     virtual bool reportError(Token& token, const char* message) {
         Serial.print(F(" ERROR: ")); Serial.print(F(message)); Serial.print(F(" -> ")); token.print(); Serial.print(F(" at line ")); Serial.print(token.line); Serial.print(F(":")); Serial.println(token.column);
-        token.highlight(assembly_string);
+        token.highlight(sourceText());
         return true;
     }
 
@@ -2593,6 +2768,7 @@ public:
         // Also parse in lint mode to show symbol errors in the linter
         if (!finalPass || lintMode) {
             symbol_count = base_symbol_count; // Reset to base symbols (preserve external symbols)
+            namesChanged();
             for (int i = 0; i < token_count; i++) {
                 Token& token = tokens[i];
                 if (str_cmp(token.string, "$$")) {
@@ -2660,6 +2836,7 @@ public:
                             
                             // Emit CONFIG_TC bytecode instruction to configure runtime at startup
                             // Format: CONFIG_TC <timer_offset:u16> <timer_count:u8> <counter_offset:u16> <counter_count:u8>
+                            if (!reserveProgramLine()) return buildError(token, "out of memory for program lines");
                             ProgramLine& line = programLines[programLineCount];
                             line.index = built_bytecode_length;
                             line.refToken = &token;
@@ -2724,6 +2901,7 @@ public:
 
                     // Emit CONFIG_DB bytecode for all declared DBs
                     {
+                        if (!reserveProgramLine()) return buildError(token, "out of memory for program lines");
                         ProgramLine& line = programLines[programLineCount];
                         line.index = built_bytecode_length;
                         line.refToken = &token;
@@ -2751,6 +2929,7 @@ public:
                             u16 abs_addr = decl.computed_offset + field.offset;
 
                             // Emit: <type>.const <value> / <type>.move_to <address>
+                            if (!reserveProgramLine()) return buildError(token, "out of memory for program lines");
                             ProgramLine& line = programLines[programLineCount];
                             line.index = built_bytecode_length;
                             line.refToken = &token;
@@ -2797,6 +2976,7 @@ public:
                     if (!intFromToken(cnt_tok, db_count_val) && db_count_val > 0 && db_count_val <= 255) {
                         // Check we have enough tokens
                         if (i + 1 + db_count_val * 2 < token_count) {
+                            if (!reserveProgramLine()) return buildError(token, "out of memory for program lines");
                             ProgramLine& line = programLines[programLineCount];
                             line.index = built_bytecode_length;
                             line.refToken = &token;
@@ -2842,6 +3022,7 @@ public:
                     // Symbol found! Replace token with appropriate address/bit access
                     if (sym->is_bit) {
                         // Generate bit read instruction
+                        if (!reserveProgramLine()) return buildError(token, "out of memory for program lines");
                         ProgramLine& line = programLines[programLineCount];
                         line.index = built_bytecode_length;
                         line.refToken = &token;
@@ -2854,6 +3035,7 @@ public:
                         _line_push;
                     } else {
                         // Generate value load instruction based on type
+                        if (!reserveProgramLine()) return buildError(token, "out of memory for program lines");
                         ProgramLine& line = programLines[programLineCount];
                         line.index = built_bytecode_length;
                         line.refToken = &token;
@@ -2889,13 +3071,8 @@ public:
 
             if (type == TOKEN_LABEL) {
                 if (finalPass) continue;
-                for (int i = 0; i < LUT_label_count; i++) {
-                    LUT_label& label = LUT_labels[i];
-                    if (str_cmp(token, label.string)) {
-                        label.address = built_bytecode_length;
-                        break;
-                    }
-                }
+                LUT_label* label = findLabel(token.string);
+                if (label) label->address = built_bytecode_length;
                 continue;
             }
 
@@ -2905,6 +3082,7 @@ public:
             float value_float;
             u8 data_type = 0;
 
+            if (!reserveProgramLine()) return buildError(token, "out of memory for program lines");
             ProgramLine& line = programLines[programLineCount];
             line.index = built_bytecode_length;
             line.refToken = &token;
@@ -2917,15 +3095,41 @@ public:
             // bool e_bool = boolFromToken(token_p1, value_bool);
             bool e_int = intFromToken(token_p1, value_int);
             bool e_real = realFromToken(token_p1, value_float);
-            /* bool e_data_type = */ typeFromToken(token, data_type);
+            // Generated instructions carry the mnemonic resolved when they were emitted (plcasm-ir.h)
+            const PLCASMMnemonic* mnemonic = nullptr;
+            if (token.record) {
+                data_type = token.record->data_type;
+                mnemonic = token.record->mnemonic;
+            } else {
+                /* bool e_data_type = */ typeFromToken(token, data_type);
+                mnemonic = type == TOKEN_KEYWORD ? mnemonicFromToken(token, data_type) : nullptr;
+            }
+            u8 mn_group = mnemonic ? mnemonic->group : 0; // 0 = not in the mnemonic table, try every handler
 
 
             bool hasThird = i + 2 < token_count;
             Token& token_p2 = hasThird ? tokens[i + 2] : tokens[i];
 
             if (type == TOKEN_KEYWORD) {
+                // Table driven mnemonics (see plcasm-mnemonics.h)
+                if (mn_group == PLCASM_MN_OPCODE) { line.size = InstructionCompiler::push(bytecode, mnemonic->opcode); _line_push; }
+                if (mn_group == PLCASM_MN_TYPED && (hasNext || !(mnemonic->flags & PLCASM_MN_NEEDS_NEXT))) {
+                    line.size = InstructionCompiler::push(bytecode, mnemonic->opcode, data_type); _line_push;
+                }
+                if (mn_group == PLCASM_MN_JUMP && hasNext) {
+                    if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; }
+                    int target = label_address;
+                    if (mnemonic->flags & PLCASM_MN_RELATIVE) target = !e_label ? (label_address - (int) (line.index + 3)) : (!e_int ? value_int : 0);
+                    i++;
+                    bytecode[0] = mnemonic->opcode;
+                    write_u16(bytecode + 1, (u16) target);
+                    line.size = 3;
+                    _ir_set_jump(1, target);
+                    _line_push;
+                }
+
                 // Handle timers
-                {
+                if (!mn_group || mn_group == PLCASM_MN_TIMER) {
                     bool is_ton = token == "ton";
                     bool is_tof = token == "tof";
                     bool is_tp = token == "tp";
@@ -2993,7 +3197,7 @@ public:
                 }
 
                 // Handle counters (CTU, CTD)
-                {
+                if (!mn_group || mn_group == PLCASM_MN_COUNTER) {
                     bool is_ctu = token == "ctu";
                     bool is_ctd = token == "ctd";
 
@@ -3049,7 +3253,7 @@ public:
                     }
                 }
 
-                { // Handle communication protocol operations (COMMS opcode with sub-function dispatch)
+                if (!mn_group || mn_group == PLCASM_MN_COMMS) { // Handle communication protocol operations (COMMS opcode with sub-function dispatch)
                     // Helper: parse a #constant integer from a token (returns true on error)
                     // Already available: intFromToken (returns true on error)
                     // Already available: addressFromToken (returns true on error)
@@ -3570,27 +3774,7 @@ public:
                     }
                 }
 
-                { // Handle flow
-                    if (hasNext && (token == "jmp" || token == "jump")) { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } i++; line.size = InstructionCompiler::push_jmp(bytecode, label_address); _ir_set_jump(1, label_address); _line_push; }
-                    if (hasNext && (token == "jmp_if" || token == "jump_if")) { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } i++; line.size = InstructionCompiler::push_jmp_if(bytecode, label_address); _ir_set_jump(1, label_address); _line_push; }
-                    if (hasNext && (token == "jmp_if_not" || token == "jump_if_not")) { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } i++; line.size = InstructionCompiler::push_jmp_if_not(bytecode, label_address); _ir_set_jump(1, label_address); _line_push; }
-                    if (hasNext && token == "call") { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } i++; line.size = InstructionCompiler::pushCALL(bytecode, label_address); _ir_set_jump(1, label_address); _line_push; }
-                    if (hasNext && token == "call_if") { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } i++; line.size = InstructionCompiler::pushCALL_IF(bytecode, label_address); _ir_set_jump(1, label_address); _line_push; }
-                    if (hasNext && token == "call_if_not") { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } i++; line.size = InstructionCompiler::pushCALL_IF_NOT(bytecode, label_address); _ir_set_jump(1, label_address); _line_push; }
-
-                    if (hasNext && (token == "jmp_rel" || token == "jump_rel")) { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } int off = !e_label ? (label_address - (int) (line.index + 3)) : (!e_int ? value_int : 0); i++; line.size = InstructionCompiler::push_jmp_rel(bytecode, (i16) off); _ir_set_jump(1, off); _line_push; }
-                    if (hasNext && (token == "jmp_if_rel" || token == "jump_if_rel")) { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } int off = !e_label ? (label_address - (int) (line.index + 3)) : (!e_int ? value_int : 0); i++; line.size = InstructionCompiler::push_jmp_if_rel(bytecode, (i16) off); _ir_set_jump(1, off); _line_push; }
-                    if (hasNext && (token == "jmp_if_not_rel" || token == "jump_if_not_rel")) { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } int off = !e_label ? (label_address - (int) (line.index + 3)) : (!e_int ? value_int : 0); i++; line.size = InstructionCompiler::push_jmp_if_not_rel(bytecode, (i16) off); _ir_set_jump(1, off); _line_push; }
-
-                    if (hasNext && token == "call_rel") { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } int off = !e_label ? (label_address - (int) (line.index + 3)) : (!e_int ? value_int : 0); i++; line.size = InstructionCompiler::pushCALL_REL(bytecode, (i16) off); _ir_set_jump(1, off); _line_push; }
-                    if (hasNext && token == "call_if_rel") { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } int off = !e_label ? (label_address - (int) (line.index + 3)) : (!e_int ? value_int : 0); i++; line.size = InstructionCompiler::pushCALL_IF_REL(bytecode, (i16) off); _line_push; }
-                    if (hasNext && token == "call_if_not_rel") { if (finalPass && e_label) { if (buildErrorUnknownLabel(token_p1)) return true; } int off = !e_label ? (label_address - (int) (line.index + 3)) : (!e_int ? value_int : 0); i++; line.size = InstructionCompiler::pushCALL_IF_NOT_REL(bytecode, (i16) off); _line_push; }
-                    if (token == "ret" || token == "return") { line.size = InstructionCompiler::push(bytecode, RET); _line_push; }
-                    if (token == "ret_if" || token == "return_if") { line.size = InstructionCompiler::push(bytecode, RET_IF); _line_push; }
-                    if (token == "ret_if_not" || token == "return_if_not") { line.size = InstructionCompiler::push(bytecode, RET_IF_NOT); _line_push; }
-                    if (token == "nop") { line.size = InstructionCompiler::push(bytecode, NOP); _line_push; }
-                    
-                    // Metadata instructions (for decompilation and debugging)
+                if (!mn_group || mn_group == PLCASM_MN_META) { // Metadata instructions (for decompilation and debugging)
                     if (hasNext && token == "lang") {
                         u8 lang_id = LANG_UNKNOWN;
                         if (token_p1 == "plcasm") lang_id = LANG_PLCASM;
@@ -3623,7 +3807,7 @@ public:
                     }
                 }
 
-                { // FFI (Foreign Function Interface) call
+                if (!mn_group || mn_group == PLCASM_MN_FFI) { // FFI (Foreign Function Interface) call
                     // Syntax: ffi <function_name> <addr1> ... <addrN> <ret_addr>
                     // The function_name is looked up in the FFI registry to get index and param count
                     if (hasNext && token == "ffi") {
@@ -3647,9 +3831,7 @@ public:
                             if (buildError(token_p1, "FFI entry not found")) return true;
                         }
                         
-                        // Parse signature to count parameters
-                        u8 param_types[PLCRUNTIME_FFI_MAX_PARAMS];
-                        u8 param_count = ffi_parseSignatureParams(entry->signature, param_types, PLCRUNTIME_FFI_MAX_PARAMS);
+                        u8 param_count = entry->param_count;
                         
                         // Collect addresses (param_count params + 1 return address)
                         u16 addrs[PLCRUNTIME_FFI_MAX_PARAMS + 1];
@@ -3675,20 +3857,117 @@ public:
                         if (buildError(token, "FFI not enabled (define PLCRUNTIME_FFI_ENABLED)")) return true;
 #endif // PLCRUNTIME_FFI_ENABLED
                     }
-                }
 
-                { // Stack operations
-                    if (token == "clear") { line.size = InstructionCompiler::push(bytecode, CLEAR); _line_push; }
-                }
+                    // Syntax: ffi.start <function_name> <addr1> ... <addrN> <ret_addr> <handle_addr>
+                    // Queues a long-running FFI function, the job handle is written to <handle_addr>
+                    if (hasNext && token == "ffi.start") {
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+                        char ffi_name[PLCRUNTIME_FFI_MAX_NAME_LEN];
+                        u8 name_len = token_p1.string.length < PLCRUNTIME_FFI_MAX_NAME_LEN - 1 ?
+                                      token_p1.string.length : PLCRUNTIME_FFI_MAX_NAME_LEN - 1;
+                        for (u8 j = 0; j < name_len; j++) ffi_name[j] = token_p1.string.data[j];
+                        ffi_name[name_len] = '\0';
+
+                        i8 ffi_index = g_ffiRegistry.findByName(ffi_name);
+                        if (ffi_index < 0) {
+                            if (buildError(token_p1, "FFI function not found")) return true;
+                        }
+                        const PLCFFIEntry* entry = g_ffiRegistry.getEntry((u8) ffi_index);
+                        if (!entry) {
+                            if (buildError(token_p1, "FFI entry not found")) return true;
+                        }
+                        if (!entry->async) {
+                            if (buildError(token_p1, "FFI function is not async (use ffi, or register it with registerFFIAsync)")) return true;
+                        }
+
+                        u8 param_count = entry->param_count;
+
+                        // Collect addresses (param_count params + return address + handle address)
+                        u16 addrs[PLCRUNTIME_FFI_MAX_PARAMS + 2];
+                        i++; // Skip function name token
+                        for (u8 j = 0; j < param_count + 2; j++) {
+                            if (i + 1 >= token_count) {
+                                if (buildError(tokens[i], "missing FFI address arguments")) return true;
+                            }
+                            Token& addr_tok = tokens[++i];
+                            int addr_val = 0;
+                            if (addressFromToken(addr_tok, addr_val)) {
+                                if (buildError(addr_tok, "invalid FFI address")) return true;
+                            }
+                            addrs[j] = (u16) addr_val;
+                        }
+
+                        line.size = InstructionCompiler::push_ffi_start(bytecode, (u8) ffi_index, param_count, addrs);
+                        _line_push;
+#else
+                        if (buildError(token, "async FFI not enabled")) return true;
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
+                    }
+
+                    // Syntax: ffi.poll <handle_addr> - pushes true once the job's result is in memory
+                    if (hasNext && token == "ffi.poll") {
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+                        int addr_val = 0;
+                        if (addressFromToken(token_p1, addr_val)) {
+                            if (buildError(token_p1, "invalid FFI handle address")) return true;
+                        }
+                        i++;
+                        line.size = InstructionCompiler::push_ffi_poll(bytecode, (u16) addr_val);
+                        _line_push;
+#else
+                        if (buildError(token, "async FFI not enabled")) return true;
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
+                    }
 
-                { // Branch stack operations (for parallel branches in ladder logic)
-                    if (token == "br.save") { line.size = InstructionCompiler::push_br_save(bytecode); _line_push; }
-                    if (token == "br.read") { line.size = InstructionCompiler::push_br_read(bytecode); _line_push; }
-                    if (token == "br.drop") { line.size = InstructionCompiler::push_br_drop(bytecode); _line_push; }
-                    if (token == "br.clr") { line.size = InstructionCompiler::push_br_clr(bytecode); _line_push; }
+                    // Syntax: ffi.batch <function_name> <base_addr> <count> [stride]
+                    // Calls the function once per record, records are the parameters packed in
+                    // signature order followed by the return value (stride defaults to the record size)
+                    if (hasNext && token == "ffi.batch") {
+#ifdef PLCRUNTIME_FFI_ENABLED
+                        char ffi_name[PLCRUNTIME_FFI_MAX_NAME_LEN];
+                        u8 name_len = token_p1.string.length < PLCRUNTIME_FFI_MAX_NAME_LEN - 1 ?
+                                      token_p1.string.length : PLCRUNTIME_FFI_MAX_NAME_LEN - 1;
+                        for (u8 j = 0; j < name_len; j++) ffi_name[j] = token_p1.string.data[j];
+                        ffi_name[name_len] = '\0';
+
+                        i8 ffi_index = g_ffiRegistry.findByName(ffi_name);
+                        if (ffi_index < 0) {
+                            if (buildError(token_p1, "FFI function not found")) return true;
+                        }
+                        i++; // Skip function name token
+                        if (i + 2 >= token_count) {
+                            if (buildError(tokens[i], "missing FFI batch arguments")) return true;
+                        }
+                        int base_addr = 0;
+                        Token& base_tok = tokens[++i];
+                        if (addressFromToken(base_tok, base_addr)) {
+                            if (buildError(base_tok, "invalid FFI batch address")) return true;
+                        }
+                        int count = 0;
+                        Token& count_tok = tokens[++i];
+                        if (intFromToken(count_tok, count) || count < 0 || count > 0xFFFF) {
+                            if (buildError(count_tok, "invalid FFI batch record count")) return true;
+                        }
+                        int record_size = g_ffiRegistry.recordSize((u8) ffi_index);
+                        int stride = record_size;
+                        if (i + 1 < token_count && tokens[i + 1].type == TOKEN_INTEGER && tokens[i + 1].line == token.line) {
+                            Token& stride_tok = tokens[++i];
+                            if (intFromToken(stride_tok, stride) || stride < record_size || stride > 0xFFFF) {
+                                if (buildError(stride_tok, "FFI batch stride is smaller than the record")) return true;
+                            }
+                        }
+                        if ((u32) base_addr + (u32) (count > 0 ? count - 1 : 0) * stride + record_size > PLCRUNTIME_MAX_MEMORY_SIZE) {
+                            if (buildError(base_tok, "FFI batch records out of memory range")) return true;
+                        }
+                        line.size = InstructionCompiler::push_ffi_batch(bytecode, (u8) ffi_index, (u16) base_addr, (u16) count, (u16) stride);
+                        _line_push;
+#else
+                        if (buildError(token, "FFI not enabled (define PLCRUNTIME_FFI_ENABLED)")) return true;
+#endif // PLCRUNTIME_FFI_ENABLED
+                    }
                 }
 
-                { // Memory fill operation
+                if (!mn_group || mn_group == PLCASM_MN_MEMORY) { // Memory fill operation
                     // Syntax: mem.fill <value> <address> <length>
                     // Fills <length> bytes of memory starting at <address> with <value>
                     if (token == "mem.fill") {
@@ -3725,7 +4004,7 @@ public:
                     }
                 }
 
-                { // String operations: str.<op> for str8, str16.<op> for str16
+                if (!mn_group || mn_group == PLCASM_MN_STRING) { // String operations: str.<op> for str8, str16.<op> for str16
                     // Syntax: str.<op> <addr> [<addr2>]  or  str16.<op> <addr> [<addr2>]
                     // Single-address ops: len, cap, get, set, clear, char
                     // Dual-address ops: cmp, eq, concat, copy, substr, find
@@ -4057,34 +4336,7 @@ public:
                     }
                 }
 
-                { // Bitwise operations (bw.and.x8, bw.or.x16, bw.xor.x32, bw.not.x64, bw.shl.x8, bw.shr.x16, etc.)
-                    if (token == "bw.and.x8") { line.size = InstructionCompiler::push(bytecode, BW_AND_X8); _line_push; }
-                    if (token == "bw.and.x16") { line.size = InstructionCompiler::push(bytecode, BW_AND_X16); _line_push; }
-                    if (token == "bw.and.x32") { line.size = InstructionCompiler::push(bytecode, BW_AND_X32); _line_push; }
-                    if (token == "bw.and.x64") { line.size = InstructionCompiler::push(bytecode, BW_AND_X64); _line_push; }
-                    if (token == "bw.or.x8") { line.size = InstructionCompiler::push(bytecode, BW_OR_X8); _line_push; }
-                    if (token == "bw.or.x16") { line.size = InstructionCompiler::push(bytecode, BW_OR_X16); _line_push; }
-                    if (token == "bw.or.x32") { line.size = InstructionCompiler::push(bytecode, BW_OR_X32); _line_push; }
-                    if (token == "bw.or.x64") { line.size = InstructionCompiler::push(bytecode, BW_OR_X64); _line_push; }
-                    if (token == "bw.xor.x8") { line.size = InstructionCompiler::push(bytecode, BW_XOR_X8); _line_push; }
-                    if (token == "bw.xor.x16") { line.size = InstructionCompiler::push(bytecode, BW_XOR_X16); _line_push; }
-                    if (token == "bw.xor.x32") { line.size = InstructionCompiler::push(bytecode, BW_XOR_X32); _line_push; }
-                    if (token == "bw.xor.x64") { line.size = InstructionCompiler::push(bytecode, BW_XOR_X64); _line_push; }
-                    if (token == "bw.not.x8") { line.size = InstructionCompiler::push(bytecode, BW_NOT_X8); _line_push; }
-                    if (token == "bw.not.x16") { line.size = InstructionCompiler::push(bytecode, BW_NOT_X16); _line_push; }
-                    if (token == "bw.not.x32") { line.size = InstructionCompiler::push(bytecode, BW_NOT_X32); _line_push; }
-                    if (token == "bw.not.x64") { line.size = InstructionCompiler::push(bytecode, BW_NOT_X64); _line_push; }
-                    if (token == "bw.shl.x8") { line.size = InstructionCompiler::push(bytecode, BW_LSHIFT_X8); _line_push; }
-                    if (token == "bw.shl.x16") { line.size = InstructionCompiler::push(bytecode, BW_LSHIFT_X16); _line_push; }
-                    if (token == "bw.shl.x32") { line.size = InstructionCompiler::push(bytecode, BW_LSHIFT_X32); _line_push; }
-                    if (token == "bw.shl.x64") { line.size = InstructionCompiler::push(bytecode, BW_LSHIFT_X64); _line_push; }
-                    if (token == "bw.shr.x8") { line.size = InstructionCompiler::push(bytecode, BW_RSHIFT_X8); _line_push; }
-                    if (token == "bw.shr.x16") { line.size = InstructionCompiler::push(bytecode, BW_RSHIFT_X16); _line_push; }
-                    if (token == "bw.shr.x32") { line.size = InstructionCompiler::push(bytecode, BW_RSHIFT_X32); _line_push; }
-                    if (token == "bw.shr.x64") { line.size = InstructionCompiler::push(bytecode, BW_RSHIFT_X64); _line_push; }
-                }
-
-                { // Handle Bit operations (PLC specific)
+                if (!mn_group) { // Handle Bit operations (PLC specific)
 
                     if (data_type) {
                         PLCRuntimeInstructionSet type = (PLCRuntimeInstructionSet) data_type;
@@ -4107,11 +4359,6 @@ public:
                                 line.size = InstructionCompiler::push(bytecode, stack_bit_task); _line_push;
                             }
 
-                            if (token == "u8.and") { line.size = InstructionCompiler::push(bytecode, LOGIC_AND); _line_push; }
-                            if (token == "u8.or") { line.size = InstructionCompiler::push(bytecode, LOGIC_OR); _line_push; }
-                            if (token == "u8.xor") { line.size = InstructionCompiler::push(bytecode, LOGIC_XOR); _line_push; }
-                            if (token == "u8.not") { line.size = InstructionCompiler::push(bytecode, LOGIC_NOT); _line_push; }
-
                             // Edge detection
                             PLCRuntimeInstructionSet edge_task = (PLCRuntimeInstructionSet) 0;
                             if (token.endsWithNoCase(".readBitDU")) edge_task = READ_BIT_DU;
@@ -4202,10 +4449,43 @@ public:
                                 line.size = InstructionCompiler::push_InstructionWithPointer(bytecode, mem_bit_task, address); _line_push;
                             }
                         }
+
+                        // Packed bit access: u32.gatherBits X0.0 X0.1 ... / u64.scatterBits Y0.0 Y0.1 ...
+                        // Bit n of the value belongs to the n-th operand, all operands on the same line
+                        if (type == type_u32 || type == type_u64) {
+                            bool gather = token.endsWithNoCase(".gatherBits");
+                            bool scatter = !gather && token.endsWithNoCase(".scatterBits");
+                            if (gather || scatter) {
+                                const u8 max_count = type == type_u32 ? 32 : 64;
+                                MY_PTR_t addresses[64];
+                                u8 bits[64];
+                                u8 count = 0;
+                                while (i + 1 < token_count && tokens[i + 1].line == token.line) {
+                                    Token& operand = tokens[i + 1];
+                                    int address = 0;
+                                    int bit = 0;
+                                    bool e_membit = memoryBitFromToken(operand, address, bit);
+                                    if (e_membit) { if (buildError(operand, "unexpected token, expected bit representation")) return true; }
+                                    if (bit < 0 || bit > 7) { if (buildError(operand, "bit value out of range for 8-bit type")) return true; }
+                                    if (count >= max_count) { if (buildError(operand, type == type_u32 ? "too many bits, u32 packs up to 32" : "too many bits, u64 packs up to 64")) return true; }
+                                    if (!e_membit && scatter && buildErrorReadOnlyWrite(operand, address)) return true;
+                                    i++;
+                                    if (count < max_count) {
+                                        addresses[count] = (MY_PTR_t) address;
+                                        bits[count] = (u8) bit;
+                                        count++;
+                                    }
+                                }
+                                if (count == 0) { if (buildError(token, "expected at least one bit in the same line")) return true; continue; }
+                                PLCRuntimeInstructionSet opcode = gather ? (type == type_u32 ? BIT_GATHER_X32 : BIT_GATHER_X64) : (type == type_u32 ? BIT_SCATTER_X32 : BIT_SCATTER_X64);
+                                if (gather) { _ir_flags |= IR_FLAG_READ; } else { _ir_flags |= IR_FLAG_WRITE; }
+                                line.size = InstructionCompiler::push_bit_list(bytecode, opcode, count, addresses, bits); _line_push;
+                            }
+                        }
                     }
                 }
 
-                { // Handle data type operations
+                if (!mn_group || mn_group == PLCASM_MN_OPERAND) { // Handle data type operations
                     if (data_type) {
                         PLCRuntimeInstructionSet type = (PLCRuntimeInstructionSet) data_type;
                         // Support: u8.const 5, u8.push 5, u8 5 (all case-insensitive)
@@ -4361,12 +4641,7 @@ public:
                         }
                         // if (hasNext && token.endsWithNoCase(".load")) { if (e_int) return buildErrorExpectedInt(token_p1); i++; line.size = InstructionCompiler::pushGET(bytecode, value_int, type); _line_push; }
                         // if (hasNext && token.endsWithNoCase(".store")) { if (e_int) return buildErrorExpectedInt(token_p1); i++; line.size = InstructionCompiler::pushPUT(bytecode, value_int, type); _line_push; }
-                        if (hasNext && token.endsWithNoCase(".load")) { line.size = InstructionCompiler::push_load(bytecode, type); _line_push; }
-                        if (hasNext && token.endsWithNoCase(".move")) { line.size = InstructionCompiler::push_move(bytecode, type); _line_push; }
-                        if (hasNext && token.endsWithNoCase(".move_copy")) { line.size = InstructionCompiler::push_move_copy(bytecode, type); _line_push; }
-                        if (hasNext && token.endsWithNoCase(".copy")) { line.size = InstructionCompiler::push_copy(bytecode, type); _line_push; }
                         // if (hasNext && token.endsWithNoCase(".swap")) { line.size = InstructionCompiler::push_swap(bytecode, type); _line_push; }
-                        if (hasNext && token.endsWithNoCase(".drop")) { line.size = InstructionCompiler::push_drop(bytecode, type); _line_push; }
                         // Pick value from stack at byte depth
                         if (hasNext && token.endsWithNoCase(".pick")) {
                             int depth_value = 0;
@@ -4389,30 +4664,12 @@ public:
                             }
                             i++; line.size = InstructionCompiler::push_poke(bytecode, type, (MY_PTR_t)depth_value); _line_push;
                         }
-                        if (token.endsWithNoCase(".cmp_lt")) { line.size = InstructionCompiler::push(bytecode, CMP_LT, type); _line_push; }
-                        if (token.endsWithNoCase(".cmp_gt")) { line.size = InstructionCompiler::push(bytecode, CMP_GT, type); _line_push; }
-                        if (token.endsWithNoCase(".cmp_eq")) { line.size = InstructionCompiler::push(bytecode, CMP_EQ, type); _line_push; }
-                        if (token.endsWithNoCase(".cmp_neq")) { line.size = InstructionCompiler::push(bytecode, CMP_NEQ, type); _line_push; }
-                        if (token.endsWithNoCase(".cmp_gte")) { line.size = InstructionCompiler::push(bytecode, CMP_GTE, type); _line_push; }
-                        if (token.endsWithNoCase(".cmp_lte")) { line.size = InstructionCompiler::push(bytecode, CMP_LTE, type); _line_push; }
-
-                        if (token.endsWithNoCase(".add")) { line.size = InstructionCompiler::push(bytecode, ADD, type); _line_push; }
-                        if (token.endsWithNoCase(".sub")) { line.size = InstructionCompiler::push(bytecode, SUB, type); _line_push; }
-                        if (token.endsWithNoCase(".mul")) { line.size = InstructionCompiler::push(bytecode, MUL, type); _line_push; }
-                        if (token.endsWithNoCase(".div")) { line.size = InstructionCompiler::push(bytecode, DIV, type); _line_push; }
-                        if (token.endsWithNoCase(".mod")) { line.size = InstructionCompiler::push(bytecode, MOD, type); _line_push; }
-                        if (token.endsWithNoCase(".pow")) { line.size = InstructionCompiler::push(bytecode, POW, type); _line_push; }
-                        if (token.endsWithNoCase(".sqrt")) { line.size = InstructionCompiler::push(bytecode, SQRT, type); _line_push; }
-                        if (token.endsWithNoCase(".neg")) { line.size = InstructionCompiler::push(bytecode, NEG, type); _line_push; }
-                        if (token.endsWithNoCase(".abs")) { line.size = InstructionCompiler::push(bytecode, ABS, type); _line_push; }
-                        if (token.endsWithNoCase(".sin")) { line.size = InstructionCompiler::push(bytecode, SIN, type); _line_push; }
-                        if (token.endsWithNoCase(".cos")) { line.size = InstructionCompiler::push(bytecode, COS, type); _line_push; }
                     }
                 }
             }
 
             // [cvt , keyword , keyword]
-            if (hasThird) {
+            if (hasThird && (!mn_group || mn_group == PLCASM_MN_CONVERT)) {
                 u8 type_1;
                 u8 type_2;
                 bool e_dataType1 = typeFromToken(token_p1, type_1);
@@ -4439,11 +4696,6 @@ public:
             //     i += 1;
             // }
 
-            if (type == TOKEN_KEYWORD && token == "exit") {
-                line.size = InstructionCompiler::push(bytecode, EXIT);
-                _line_push;
-            }
-
             if (buildErrorUnknownToken(token)) return true; continue;
         }
         for (int i = 0; i < LUT_label_count; i++) {
@@ -4457,6 +4709,246 @@ public:
     }
 
 
+#define FUSE_MARK_START   0x01 // Byte offset is the start of an instruction
+#define FUSE_MARK_TARGET  0x02 // Byte offset is a jump/call target or a label
+#define FUSE_MARK_MERGED  0x04 // Instruction was folded into the preceding fused instruction
+
+    static bool fuseIsAbsJump(u8 op) { return op == JMP || op == JMP_IF || op == JMP_IF_NOT || op == CALL || op == CALL_IF || op == CALL_IF_NOT; }
+    static bool fuseIsRelJump(u8 op) { return op == JMP_REL || op == JMP_IF_REL || op == JMP_IF_NOT_REL || op == CALL_REL || op == CALL_IF_REL || op == CALL_IF_NOT_REL; }
+
+    // Absolute target of the jump/call at `pos` (both variants are 3 bytes)
+    i32 fuseJumpTarget(u32 pos) {
+        u8 op = built_bytecode[pos];
+        u16 operand = read_u16(built_bytecode + pos + 1);
+        if (fuseIsRelJump(op)) return (i32) pos + 3 + (i16) operand;
+        return operand;
+    }
+
+    // Instruction at `pos` can be folded into the instruction before it
+    bool fuseInterior(u32 pos, u32 length) {
+        return pos < length && (fuse_marks[pos] & FUSE_MARK_START) && !(fuse_marks[pos] & FUSE_MARK_TARGET);
+    }
+
+    // Match a fusable sequence starting at `pos`. Writes the fused instruction to `out`,
+    // returns its size (0 if nothing matches) and the number of bytes it replaces.
+    // A fused conditional jump keeps the old absolute target, relocated afterwards.
+    u32 fuseMatch(u32 pos, u32 length, u8* out, u32& consumed) {
+        u8* code = built_bytecode;
+        u8 op = code[pos];
+        u32 p1 = pos + INSTRUCTION_SIZE(code, length, pos);
+        if (!fuseInterior(p1, length)) return 0;
+        u8 op1 = code[p1];
+
+        // BR_SAVE + BR_READ
+        if (op == BR_SAVE && op1 == BR_READ) {
+            consumed = p1 + 1 - pos;
+            return InstructionCompiler::push_br_save_read(out);
+        }
+
+        // READ_X8_Bn + LOGIC_AND [+ WRITE_X8_Bn], READ_X8_Bn + LOGIC_OR
+        if (op >= READ_X8_B0 && op <= READ_X8_B7 && (op1 == LOGIC_AND || op1 == LOGIC_OR)) {
+            MY_PTR_t src = read_ptr(code + pos + 1);
+            u8 src_bit = op - READ_X8_B0;
+            u32 p2 = p1 + 1;
+            if (op1 == LOGIC_AND && fuseInterior(p2, length) && code[p2] >= WRITE_X8_B0 && code[p2] <= WRITE_X8_B7) {
+                consumed = p2 + 1 + MY_PTR_SIZE_BYTES - pos;
+                return InstructionCompiler::push_read_and_write_x8(out, src, src_bit, read_ptr(code + p2 + 1), code[p2] - WRITE_X8_B0);
+            }
+            consumed = p2 - pos;
+            return InstructionCompiler::push_read_logic_x8(out, op1 == LOGIC_AND ? READ_AND_X8 : READ_OR_X8, src, src_bit);
+        }
+
+        // LOAD_FROM + <type> const + CMP_xx [+ JMP_IF_NOT / JMP_IF_NOT_REL]
+        if (op == LOAD_FROM) {
+            u8 type = code[pos + 1];
+            if (LOAD_CMP_IMM_SIZE(type) == 0 || op1 != type) return 0;
+            u32 p2 = p1 + INSTRUCTION_SIZE(code, length, p1);
+            if (!fuseInterior(p2, length)) return 0;
+            u8 cmp = code[p2];
+            if (cmp < CMP_EQ || cmp > CMP_LTE || code[p2 + 1] != type) return 0;
+            PLCRuntimeInstructionSet cmp_op = (PLCRuntimeInstructionSet) cmp;
+            PLCRuntimeInstructionSet type_op = (PLCRuntimeInstructionSet) type;
+            MY_PTR_t address = read_ptr(code + pos + 2);
+            u32 p3 = p2 + 2;
+            if (fuseInterior(p3, length) && (code[p3] == JMP_IF_NOT || code[p3] == JMP_IF_NOT_REL)) {
+                consumed = p3 + 3 - pos;
+                return InstructionCompiler::push_load_cmp_imm_jmp_if_not(out, cmp_op, type_op, address, code + p1 + 1, (u32) fuseJumpTarget(p3));
+            }
+            consumed = p3 - pos;
+            return InstructionCompiler::push_load_cmp_imm(out, cmp_op, type_op, address, code + p1 + 1);
+        }
+        return 0;
+    }
+
+    // Rebuild the IR operands of a fused instruction from its encoding.
+    // The merge step carries the constant operand of LOAD_CMP_IMM* in operands[2].
+    void fuseRebuildIREntry(IR_Entry& e) {
+        const u8* code = built_bytecode + e.bytecode_offset;
+        e.opcode = code[0];
+        e.bytecode_size = (u8) INSTRUCTION_SIZE(built_bytecode, built_bytecode_length, e.bytecode_offset);
+        switch (e.opcode) {
+            case BR_SAVE_READ: e.operand_count = 0; break;
+            case READ_AND_X8:
+            case READ_OR_X8:
+            case READ_AND_WRITE_X8: {
+                e.operand_count = 1;
+                e.operands[0].type = IR_OP_PTR; e.operands[0].bytecode_pos = 1; e.operands[0].val_u64 = read_ptr(code + 1);
+                if (e.opcode == READ_AND_WRITE_X8) {
+                    u8 pos = 2 + MY_PTR_SIZE_BYTES;
+                    e.operand_count = 2;
+                    e.operands[1].type = IR_OP_PTR; e.operands[1].bytecode_pos = pos; e.operands[1].val_u64 = read_ptr(code + pos);
+                }
+                break;
+            }
+            case LOAD_CMP_IMM:
+            case LOAD_CMP_IMM_JMP_IF_NOT: {
+                // Constant first so constant editors keep finding it in operands[0]
+                u8 n = 0;
+                if (e.flags & IR_FLAG_CONST) {
+                    e.operands[n] = e.operands[2];
+                    e.operands[n].bytecode_pos = 3 + MY_PTR_SIZE_BYTES;
+                    n++;
+                }
+                e.operands[n].type = IR_OP_PTR; e.operands[n].bytecode_pos = 3; e.operands[n].val_u64 = read_ptr(code + 3);
+                n++;
+                if (e.opcode == LOAD_CMP_IMM_JMP_IF_NOT) {
+                    u8 pos = e.bytecode_size - 2;
+                    e.operands[n].type = IR_OP_LABEL; e.operands[n].bytecode_pos = pos; e.operands[n].val_u64 = read_u16(code + pos);
+                    n++;
+                }
+                e.operand_count = n;
+                break;
+            }
+            default: break;
+        }
+    }
+
+    // Peephole pass: replace common instruction sequences with fused superinstructions.
+    // A sequence is fused only when no jump, call or label lands inside it. Jump operands,
+    // labels and IR entries are relocated to the compacted bytecode. If the program
+    // contains anything that cannot be relocated safely it is left untouched.
+    void fuseSuperinstructions() {
+        u32 length = (u32) built_bytecode_length;
+        u8* code = built_bytecode;
+        if (length == 0) return;
+        fuse_marks = (u8*) arena.alloc(length);
+        fuse_offset_map = (u32*) arena.alloc((length + 1) * sizeof(u32));
+        if (fuse_marks == nullptr || fuse_offset_map == nullptr) return;
+
+        // Pass 1: instruction boundaries
+        for (u32 i = 0; i < length; i++) fuse_marks[i] = 0;
+        for (u32 pos = 0; pos < length;) {
+            u8 op = code[pos];
+            u32 size = INSTRUCTION_SIZE(code, length, pos);
+            if (size == 0 || pos + size > length) return;
+            if (op == CSTR_CPY || op == CSTR_EQ) return; // Carry program offsets
+            fuse_marks[pos] |= FUSE_MARK_START;
+            pos += size;
+        }
+
+        // Pass 2: jump/call targets and labels
+        for (u32 pos = 0; pos < length; pos += INSTRUCTION_SIZE(code, length, pos)) {
+            u8 op = code[pos];
+            if (!fuseIsAbsJump(op) && !fuseIsRelJump(op)) continue;
+            i32 target = fuseJumpTarget(pos);
+            if (target < 0 || (u32) target > length) return;
+            if ((u32) target == length) continue;
+            if (!(fuse_marks[target] & FUSE_MARK_START)) return;
+            fuse_marks[target] |= FUSE_MARK_TARGET;
+        }
+        for (int i = 0; i < LUT_label_count; i++) {
+            int address = LUT_labels[i].address;
+            if (address < 0 || (u32) address > length) return;
+            if ((u32) address == length) continue;
+            if (!(fuse_marks[address] & FUSE_MARK_START)) return;
+            fuse_marks[address] |= FUSE_MARK_TARGET;
+        }
+
+        // Pass 3: compact in place (the output never overtakes the input).
+        // Relative jumps temporarily hold their old absolute target.
+        u8 fused[MAX_PROGRAM_LINE_SIZE];
+        u32 write = 0;
+        for (u32 read = 0; read < length;) {
+            u32 consumed = 0;
+            u32 size = fuseMatch(read, length, fused, consumed);
+            fuse_offset_map[read] = write;
+            if (size > 0) {
+                for (u32 p = read + 1; p < read + consumed; p++) {
+                    if (!(fuse_marks[p] & FUSE_MARK_START)) continue;
+                    fuse_marks[p] |= FUSE_MARK_MERGED;
+                    fuse_offset_map[p] = write;
+                }
+                for (u32 j = 0; j < size; j++) code[write + j] = fused[j];
+                write += size;
+                read += consumed;
+                continue;
+            }
+            u8 op = code[read];
+            size = INSTRUCTION_SIZE(code, length, read);
+            u16 rel_target = fuseIsRelJump(op) ? (u16) fuseJumpTarget(read) : 0;
+            for (u32 j = 0; j < size; j++) code[write + j] = code[read + j];
+            if (fuseIsRelJump(op)) write_u16(code + write + 1, rel_target);
+            write += size;
+            read += size;
+        }
+        fuse_offset_map[length] = write;
+        for (u32 i = write; i < length; i++) code[i] = 0;
+        built_bytecode_length = (int) write;
+
+        // Pass 4: relocate jump operands
+        for (u32 pos = 0; pos < write;) {
+            u8 op = code[pos];
+            u32 size = INSTRUCTION_SIZE(code, write, pos);
+            if (fuseIsAbsJump(op) || op == LOAD_CMP_IMM_JMP_IF_NOT) {
+                u32 at = pos + size - 2;
+                write_u16(code + at, (u16) fuse_offset_map[read_u16(code + at)]);
+            } else if (fuseIsRelJump(op)) {
+                i32 target = (i32) fuse_offset_map[read_u16(code + pos + 1)];
+                write_u16(code + pos + 1, (u16) (i16) (target - (i32) (pos + size)));
+            }
+            pos += size;
+        }
+
+        built_bytecode_checksum = 0;
+        for (u32 i = 0; i < write; i++) crc8_simple(built_bytecode_checksum, code[i]);
+
+        for (int i = 0; i < LUT_label_count; i++) {
+            LUT_labels[i].address = (int) fuse_offset_map[LUT_labels[i].address];
+        }
+
+        // Relocate IR: merge entries of folded instructions into the fused one
+        int count = 0;
+        for (int k = 0; k < ir_entry_count; k++) {
+            IR_Entry e = ir_entries[k];
+            u32 old = e.bytecode_offset;
+            if (old < length && (fuse_marks[old] & FUSE_MARK_MERGED)) {
+                if (count == 0) continue;
+                IR_Entry& head = ir_entries[count - 1];
+                if ((e.flags & IR_FLAG_CONST) && e.operand_count > 0) head.operands[2] = e.operands[0];
+                head.flags |= e.flags;
+                continue;
+            }
+            if (old <= length) e.bytecode_offset = fuse_offset_map[old];
+            ir_entries[count++] = e;
+        }
+        ir_entry_count = count;
+        for (int k = 0; k < ir_entry_count; k++) {
+            IR_Entry& e = ir_entries[k];
+            if (e.bytecode_offset >= write) continue;
+            u8 op = code[e.bytecode_offset];
+            if (op != e.opcode) { fuseRebuildIREntry(e); continue; }
+            for (int n = 0; n < e.operand_count; n++) {
+                if (e.operands[n].type != IR_OP_LABEL) continue;
+                u16 operand = read_u16(code + e.bytecode_offset + e.operands[n].bytecode_pos);
+                e.operands[n].val_u64 = fuseIsRelJump(op) ? (u64) (i64) (i16) operand : (u64) operand;
+            }
+        }
+    }
+
+#undef FUSE_MARK_START
+#undef FUSE_MARK_TARGET
+#undef FUSE_MARK_MERGED
+
     void loadAssembly() {
         int size = 0;
         streamRead(assembly_string, size, MAX_ASSEMBLY_STRING_SIZE);
@@ -4526,6 +5018,8 @@ public:
         t1 = millis() - t1;
         if (error) { Serial.println(F("Failed at linking"));  return error; }
 
+        if (fuse_superinstructions && !lintMode) fuseSuperinstructions();
+
         total = millis() - total;
         if (debug) { Serial.print(F(" finished in ")); Serial.print(total); Serial.println(F(" ms")); }
 
@@ -4707,6 +5201,11 @@ WASM_EXPORT bool compileAssembly(bool debug = true) {
     return defaultCompiler.compileAssembly(debug, false);
 }
 
+// Enable fused superinstructions in the compiled bytecode (off by default, requires runtime support)
+WASM_EXPORT void setSuperinstructionFusion(bool enabled) {
+    defaultCompiler.fuse_superinstructions = enabled;
+}
+
 // IR (Intermediate Representation) exports for Front-End editor
 WASM_EXPORT int ir_get_count() {
     return defaultCompiler.ir_entry_count;
@@ -4738,7 +5237,7 @@ WASM_EXPORT int getCompiledBytecodeLength() {
 
 WASM_EXPORT void initialize() {
     runtime.initialize();
-    IntervalReset();
+    runtime.clock.reset();
 }
 
 WASM_EXPORT u16 getRuntimeFlags() {
@@ -4833,14 +5332,14 @@ WASM_EXPORT bool loadCompiledProgram() {
 }
 
 WASM_EXPORT void runFullProgramDebug() {
-    IntervalGlobalLoopCheck();
+    runtime.clock.update(millis());
     RuntimeError status = UnitTest::fullProgramDebug(runtime);
     const char* status_name = RUNTIME_ERROR_NAME(status);
     Serial.print(F("Runtime status: ")); Serial.println(status_name);
 }
 
 WASM_EXPORT void runFullProgram() {
-    IntervalGlobalLoopCheck();
+    runtime.clock.update(millis());
     RuntimeError status = runtime.run();
     const char* status_name = RUNTIME_ERROR_NAME(status);
     Serial.print(F("Runtime status: ")); Serial.println(status_name);
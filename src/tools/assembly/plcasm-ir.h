@@ -0,0 +1,393 @@
+// plcasm-ir.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+#include "../runtime-lib.h"
+#include "compiler-arena.h"
+
+// ============================================================================
+// PLCASM instruction IR
+// ============================================================================
+// Generated PLCASM as typed records instead of text. The STL and PLCScript
+// compilers emit one record per listing line: an instruction with its
+// mnemonic resolved through the mnemonic table (plcasm-mnemonics.h) and its
+// operands (names, label targets, integers, reals, strings), a label, or a
+// comment. The assembler builds its tokens straight from the records and
+// encodes table driven mnemonics from the resolved entry, nothing is lexed.
+// The PLCASM listing is rendered from the records when it is asked for.
+//
+// Records are spliced into an assembly text through segments: each segment
+// names the offset in the text where its records belong, so labels,
+// constants and line numbers resolve as if the listing was pasted there.
+//
+// Every table grows in the IR's own arena, so the size of the generated
+// PLCASM is only limited by memory.
+// ============================================================================
+
+#define PLCASM_IR_INSTRUCTION   0
+#define PLCASM_IR_LABEL         1
+#define PLCASM_IR_COMMENT       2   // Also a blank line (empty text), skipped by the assembler
+
+// Operand forms
+#define PLCASM_IR_NAME          0   // Address, symbol or type keyword
+#define PLCASM_IR_VALUE         1   // Constant as written in the front-end source
+#define PLCASM_IR_TARGET        2   // Label
+#define PLCASM_IR_INTEGER       3
+#define PLCASM_IR_REAL          4
+#define PLCASM_IR_STRING        5   // Text keeps the quotes and escapes
+
+#define PLCASM_IR_MAX_ENTRIES   0x3FFFFFFF
+
+struct PLCASMIROperand {
+    u32 text;           // Operand as written in the listing, in the pool
+    u32 length;
+    u8 form;            // PLCASM_IR_NAME, ...
+    u8 type;            // IR_OperandType of the value
+    union {
+        i64 integer;
+        double real;
+    };
+};
+
+struct PLCASMIRRecord {
+    u32 text;           // Mnemonic, label name or comment in the pool
+    u32 length;
+    u32 operand_start;
+    u16 operand_count;
+    u8 kind;            // PLCASM_IR_INSTRUCTION, PLCASM_IR_LABEL or PLCASM_IR_COMMENT
+    u8 data_type;       // Type of a "<type>.op" mnemonic, 0 when it has none
+    const PLCASMMnemonic* mnemonic; // nullptr when the mnemonic is not in the table, the assembler then matches it by name
+};
+
+struct PLCASMIRSegment {
+    u32 text_offset;    // Where the segment is spliced into the assembly text
+    u32 record_start;
+    u32 record_end;
+};
+
+struct PLCASMIRMark {
+    int record_count;
+    int operand_count;
+    int pool_length;
+};
+
+struct PLCASMInstructionIR {
+    CompilerArena arena;
+    ArenaTable<PLCASMIRRecord> records;
+    ArenaTable<PLCASMIROperand> operands;
+    ArenaTable<char> pool;
+    ArenaTable<PLCASMIRSegment> segments;
+    int record_count = 0;
+    int operand_count = 0;
+    int pool_length = 0;
+    int segment_count = 0;
+    bool overflow = false;      // The arena could not grow, the IR is incomplete
+    bool open = false;          // The last record still takes operands and text
+    bool segment_open = false;
+
+    void reset() {
+        arena.reset();
+        records.release();
+        operands.release();
+        pool.release();
+        segments.release();
+        record_count = 0;
+        operand_count = 0;
+        pool_length = 0;
+        segment_count = 0;
+        overflow = false;
+        open = false;
+        segment_open = false;
+    }
+
+    // ---------------- Building ----------------
+
+    // Start an instruction line, parts of a composed mnemonic are added with append()
+    void instruction(const char* mnemonic, const char* suffix = nullptr) {
+        begin(PLCASM_IR_INSTRUCTION);
+        append(mnemonic);
+        if (suffix) append(suffix);
+    }
+
+    // Whole instruction line without operands
+    void emit(const char* mnemonic) {
+        instruction(mnemonic);
+        end();
+    }
+
+    // Whole instruction line with one name operand
+    void emit(const char* mnemonic, const char* operand) {
+        instruction(mnemonic);
+        name(operand);
+        end();
+    }
+
+    void name(const char* text) { operand(PLCASM_IR_NAME, IR_OP_PTR); append(text); }
+    void value(const char* text) { operand(PLCASM_IR_VALUE, IR_OP_NONE); append(text); }
+    void target(const char* label) { operand(PLCASM_IR_TARGET, IR_OP_LABEL); append(label); }
+
+    void integer(i64 number) {
+        if (!operand(PLCASM_IR_INTEGER, IR_OP_I64)) return;
+        operands[operand_count - 1].integer = number;
+        appendInt(number);
+    }
+
+    // Written with six decimals
+    void real(double number) {
+        if (!operand(PLCASM_IR_REAL, IR_OP_F64)) return;
+        operands[operand_count - 1].real = number;
+        if (number < 0) { appendChar('-'); number = -number; }
+        i64 whole = (i64) number;
+        double fraction = number - whole;
+        appendInt(whole);
+        appendChar('.');
+        for (int i = 0; i < 6; i++) {
+            fraction *= 10;
+            int digit = (int) fraction;
+            appendChar((char) ('0' + digit));
+            fraction -= digit;
+        }
+    }
+
+    // String operand, the escaped content is added with append() and closed by endString()
+    void beginString(char quote) { operand(PLCASM_IR_STRING, IR_OP_NONE); appendChar(quote); }
+    void endString() {
+        if (!open || !records[record_count - 1].operand_count) return;
+        const PLCASMIROperand& string = operands[operand_count - 1];
+        appendChar(pool[string.text]);
+    }
+
+    void label(const char* name) { begin(PLCASM_IR_LABEL); append(name); }
+
+    // Comment line, `text` includes the comment marker
+    void comment(const char* text) { begin(PLCASM_IR_COMMENT); append(text); }
+
+    void blank() { begin(PLCASM_IR_COMMENT); end(); }
+
+    // Add text to the open record: its mnemonic, label or comment, or its last operand
+    void append(const char* text) {
+        while (*text) appendChar(*text++);
+    }
+
+    void appendChar(char c) {
+        if (!open) return;
+        if (!pool.reserve(arena, pool_length + 1, PLCASM_IR_MAX_ENTRIES)) { overflow = true; return; }
+        pool[pool_length++] = c;
+        PLCASMIRRecord& record = records[record_count - 1];
+        if (record.operand_count) operands[operand_count - 1].length++;
+        else record.length++;
+    }
+
+    void appendInt(i64 number) {
+        char digits[24];
+        int count = 0;
+        u64 magnitude = number < 0 ? (u64) 0 - (u64) number : (u64) number;
+        do {
+            digits[count++] = (char) ('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+        if (number < 0) appendChar('-');
+        while (count) appendChar(digits[--count]);
+    }
+
+    void appendHex(u32 number) {
+        const char hex[] = "0123456789abcdef";
+        for (int shift = 28; shift >= 0; shift -= 4) appendChar(hex[(number >> shift) & 0xF]);
+    }
+
+    // Close the open record (the end of its line). An instruction resolves its mnemonic here.
+    void end() {
+        if (!open) return;
+        open = false;
+        PLCASMIRRecord& record = records[record_count - 1];
+        if (record.kind != PLCASM_IR_INSTRUCTION) return;
+        StringView mnemonic;
+        mnemonic.data = pool.data + record.text;
+        mnemonic.length = (int) record.length;
+        u8 data_type = 0;
+        plcasmTypeFromName(mnemonic, data_type);
+        record.data_type = data_type;
+        record.mnemonic = plcasmResolveMnemonic(mnemonic.data, mnemonic.length, data_type);
+    }
+
+    // Position to drop records emitted after it (rewind())
+    PLCASMIRMark mark() {
+        end();
+        PLCASMIRMark m;
+        m.record_count = record_count;
+        m.operand_count = operand_count;
+        m.pool_length = pool_length;
+        return m;
+    }
+
+    void rewind(const PLCASMIRMark& m) {
+        open = false;
+        record_count = m.record_count;
+        operand_count = m.operand_count;
+        pool_length = m.pool_length;
+    }
+
+    // Append copies of the records [first, last) of another IR
+    void copy(const PLCASMInstructionIR& from, int first, int last) {
+        end();
+        for (int r = first; r < last; r++) {
+            const PLCASMIRRecord& source = from.records[r];
+            begin(source.kind);
+            appendText(from.pool.data + source.text, source.length);
+            for (int o = 0; o < source.operand_count; o++) {
+                const PLCASMIROperand& op = from.operands[source.operand_start + o];
+                if (!operand(op.form, op.type)) return;
+                operands[operand_count - 1].integer = op.integer;
+                appendText(from.pool.data + op.text, op.length);
+            }
+            end();
+        }
+    }
+
+    // ---------------- Segments ----------------
+
+    // Start collecting records that belong at `text_offset` of the assembly text
+    void beginSegment(int text_offset) {
+        end();
+        if (!segments.reserve(arena, segment_count + 1, PLCASM_IR_MAX_ENTRIES)) { overflow = true; return; }
+        PLCASMIRSegment& segment = segments[segment_count];
+        segment.text_offset = (u32) text_offset;
+        segment.record_start = (u32) record_count;
+        segment.record_end = (u32) record_count;
+        segment_open = true;
+    }
+
+    // Close the open segment, returns the number of lines it spans
+    int endSegment() {
+        if (!segment_open) return 0;
+        end();
+        segment_open = false;
+        PLCASMIRSegment& segment = segments[segment_count++];
+        segment.record_end = (u32) record_count;
+        return lines(segment.record_start, segment.record_end);
+    }
+
+    // Drop the open segment (the front-end failed)
+    void cancelSegment() {
+        if (!segment_open) return;
+        segment_open = false;
+        int first = (int) segments[segment_count].record_start;
+        PLCASMIRMark m;
+        m.record_count = first;
+        m.operand_count = first < record_count ? (int) records[first].operand_start : operand_count;
+        m.pool_length = first < record_count ? (int) records[first].text : pool_length;
+        rewind(m);
+    }
+
+    // ---------------- Listing ----------------
+
+    // Lines the records [first, last) take in the listing
+    int lines(int first, int last) const {
+        int count = 0;
+        for (int r = first; r < last; r++) {
+            const PLCASMIRRecord& record = records[r];
+            count++;
+            if (record.kind != PLCASM_IR_COMMENT) continue;
+            for (u32 i = 0; i < record.length; i++) if (pool[record.text + i] == '\n') count++;
+        }
+        return count;
+    }
+
+    // Render the records [first, last) as PLCASM text, returns the length written (or needed when out is null)
+    int render(int first, int last, char* out, int capacity) const {
+        int length = 0;
+        for (int r = first; r < last; r++) {
+            const PLCASMIRRecord& record = records[r];
+            put(out, capacity, length, pool.data + record.text, (int) record.length);
+            for (int o = 0; o < record.operand_count; o++) {
+                const PLCASMIROperand& op = operands[record.operand_start + o];
+                put(out, capacity, length, " ", 1);
+                put(out, capacity, length, pool.data + op.text, (int) op.length);
+            }
+            if (record.kind == PLCASM_IR_LABEL) put(out, capacity, length, ":", 1);
+            put(out, capacity, length, "\n", 1);
+        }
+        return length;
+    }
+
+    int render(const PLCASMIRSegment& segment, char* out, int capacity) const {
+        return render((int) segment.record_start, (int) segment.record_end, out, capacity);
+    }
+
+    // Render `text` with every segment spliced in at its offset
+    int renderListing(const char* text, int text_length, char* out, int capacity) const {
+        int length = 0;
+        int text_start = 0;
+        for (int s = 0; s < segment_count; s++) {
+            int text_end = (int) segments[s].text_offset;
+            if (text_end > text_length) text_end = text_length;
+            put(out, capacity, length, text + text_start, text_end - text_start);
+            length += render(segments[s], out ? out + length : nullptr, capacity > length ? capacity - length : 0);
+            text_start = text_end;
+        }
+        put(out, capacity, length, text + text_start, text_length - text_start);
+        return length;
+    }
+
+private:
+    static void put(char* out, int capacity, int& length, const char* text, int count) {
+        for (int i = 0; i < count; i++) {
+            if (out && length < capacity) out[length] = text[i];
+            length++;
+        }
+    }
+
+    void begin(u8 kind) {
+        end();
+        if (!records.reserve(arena, record_count + 1, PLCASM_IR_MAX_ENTRIES)) { overflow = true; return; }
+        PLCASMIRRecord& record = records[record_count++];
+        record.text = (u32) pool_length;
+        record.length = 0;
+        record.operand_start = (u32) operand_count;
+        record.operand_count = 0;
+        record.kind = kind;
+        record.data_type = 0;
+        record.mnemonic = nullptr;
+        open = true;
+    }
+
+    bool operand(u8 form, u8 type) {
+        if (!open || records[record_count - 1].kind != PLCASM_IR_INSTRUCTION) return false;
+        if (!operands.reserve(arena, operand_count + 1, PLCASM_IR_MAX_ENTRIES)) { overflow = true; return false; }
+        PLCASMIROperand& op = operands[operand_count++];
+        op.text = (u32) pool_length;
+        op.length = 0;
+        op.form = form;
+        op.type = type;
+        op.integer = 0;
+        records[record_count - 1].operand_count++;
+        return true;
+    }
+
+    void appendText(const char* text, u32 length) {
+        for (u32 i = 0; i < length; i++) appendChar(text[i]);
+    }
+};
+
+#endif // __WASM__
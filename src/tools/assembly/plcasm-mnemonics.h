@@ -0,0 +1,415 @@
+// plcasm-mnemonics.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef __WASM__
+
+#include "../runtime-lib.h"
+#include "shared-symbols.h"
+
+// ============================================================================
+// PLCASM mnemonic table
+// ============================================================================
+// Every mnemonic the assembler accepts is listed once with the group that
+// handles it and, for the table driven groups, the opcode it emits:
+//
+//   PLCASM_MN_OPCODE   single byte instruction            nop, ret, bw.and.x8
+//   PLCASM_MN_TYPED    opcode followed by the type byte   u8.add, f32.cmp_lt
+//   PLCASM_MN_JUMP     opcode followed by a u16 target    jmp, call_if_rel
+//
+// Typed instructions are keyed by their suffix (".add") and are matched
+// when the part before the first dot is a data type keyword, which carries
+// the PLCASM_MN_TYPE_PREFIX flag. The remaining groups only tell the build
+// pass which of its hand written handlers the mnemonic belongs to, so every
+// other handler is skipped. Tokens missing from the table still go through
+// all of the handlers.
+//
+// Lookup is a perfect hash built over the table on first use (hash and
+// displace): the case-insensitive FNV-1a hash picks a bucket, the bucket's
+// displacement picks the slot, and one name compare confirms the hit.
+// ============================================================================
+
+enum PLCASMMnemonicGroup {
+    PLCASM_MN_OPCODE = 1,
+    PLCASM_MN_TYPED,
+    PLCASM_MN_JUMP,
+    PLCASM_MN_OPERAND,     // Typed push/address forms (u8.const, u8.move_to, u8 5)
+    PLCASM_MN_TIMER,
+    PLCASM_MN_COUNTER,
+    PLCASM_MN_COMMS,
+    PLCASM_MN_META,
+    PLCASM_MN_FFI,
+    PLCASM_MN_MEMORY,
+    PLCASM_MN_STRING,
+    PLCASM_MN_CONVERT,
+};
+
+#define PLCASM_MN_SUFFIX        0x01 // Key is the ".op" part of a "<type>.op" mnemonic
+#define PLCASM_MN_TYPE_PREFIX   0x02 // Data type keyword, valid as a "<type>." prefix
+#define PLCASM_MN_NEEDS_NEXT    0x04 // Only recognized when another token follows
+#define PLCASM_MN_RELATIVE      0x08 // Jump operand is relative to the next instruction
+
+struct PLCASMMnemonic {
+    const char* name;
+    u8 group;
+    u8 opcode;
+    u8 flags;
+};
+
+const PLCASMMnemonic plcasm_mnemonics[] = {
+    // Single byte instructions
+    { "nop", PLCASM_MN_OPCODE, NOP, 0 },
+    { "ret", PLCASM_MN_OPCODE, RET, 0 },
+    { "return", PLCASM_MN_OPCODE, RET, 0 },
+    { "ret_if", PLCASM_MN_OPCODE, RET_IF, 0 },
+    { "return_if", PLCASM_MN_OPCODE, RET_IF, 0 },
+    { "ret_if_not", PLCASM_MN_OPCODE, RET_IF_NOT, 0 },
+    { "return_if_not", PLCASM_MN_OPCODE, RET_IF_NOT, 0 },
+    { "exit", PLCASM_MN_OPCODE, EXIT, 0 },
+    { "clear", PLCASM_MN_OPCODE, CLEAR, 0 },
+    { "br.save", PLCASM_MN_OPCODE, BR_SAVE, 0 },
+    { "br.read", PLCASM_MN_OPCODE, BR_READ, 0 },
+    { "br.drop", PLCASM_MN_OPCODE, BR_DROP, 0 },
+    { "br.clr", PLCASM_MN_OPCODE, BR_CLR, 0 },
+    { "u8.and", PLCASM_MN_OPCODE, LOGIC_AND, 0 },
+    { "u8.or", PLCASM_MN_OPCODE, LOGIC_OR, 0 },
+    { "u8.xor", PLCASM_MN_OPCODE, LOGIC_XOR, 0 },
+    { "u8.not", PLCASM_MN_OPCODE, LOGIC_NOT, 0 },
+    { "bw.and.x8", PLCASM_MN_OPCODE, BW_AND_X8, 0 },
+    { "bw.and.x16", PLCASM_MN_OPCODE, BW_AND_X16, 0 },
+    { "bw.and.x32", PLCASM_MN_OPCODE, BW_AND_X32, 0 },
+    { "bw.and.x64", PLCASM_MN_OPCODE, BW_AND_X64, 0 },
+    { "bw.or.x8", PLCASM_MN_OPCODE, BW_OR_X8, 0 },
+    { "bw.or.x16", PLCASM_MN_OPCODE, BW_OR_X16, 0 },
+    { "bw.or.x32", PLCASM_MN_OPCODE, BW_OR_X32, 0 },
+    { "bw.or.x64", PLCASM_MN_OPCODE, BW_OR_X64, 0 },
+    { "bw.xor.x8", PLCASM_MN_OPCODE, BW_XOR_X8, 0 },
+    { "bw.xor.x16", PLCASM_MN_OPCODE, BW_XOR_X16, 0 },
+    { "bw.xor.x32", PLCASM_MN_OPCODE, BW_XOR_X32, 0 },
+    { "bw.xor.x64", PLCASM_MN_OPCODE, BW_XOR_X64, 0 },
+    { "bw.not.x8", PLCASM_MN_OPCODE, BW_NOT_X8, 0 },
+    { "bw.not.x16", PLCASM_MN_OPCODE, BW_NOT_X16, 0 },
+    { "bw.not.x32", PLCASM_MN_OPCODE, BW_NOT_X32, 0 },
+    { "bw.not.x64", PLCASM_MN_OPCODE, BW_NOT_X64, 0 },
+    { "bw.shl.x8", PLCASM_MN_OPCODE, BW_LSHIFT_X8, 0 },
+    { "bw.shl.x16", PLCASM_MN_OPCODE, BW_LSHIFT_X16, 0 },
+    { "bw.shl.x32", PLCASM_MN_OPCODE, BW_LSHIFT_X32, 0 },
+    { "bw.shl.x64", PLCASM_MN_OPCODE, BW_LSHIFT_X64, 0 },
+    { "bw.shr.x8", PLCASM_MN_OPCODE, BW_RSHIFT_X8, 0 },
+    { "bw.shr.x16", PLCASM_MN_OPCODE, BW_RSHIFT_X16, 0 },
+    { "bw.shr.x32", PLCASM_MN_OPCODE, BW_RSHIFT_X32, 0 },
+    { "bw.shr.x64", PLCASM_MN_OPCODE, BW_RSHIFT_X64, 0 },
+
+    // Typed instructions: <type>.<op>
+    { ".load", PLCASM_MN_TYPED, LOAD, PLCASM_MN_SUFFIX | PLCASM_MN_NEEDS_NEXT },
+    { ".move", PLCASM_MN_TYPED, MOVE, PLCASM_MN_SUFFIX | PLCASM_MN_NEEDS_NEXT },
+    { ".move_copy", PLCASM_MN_TYPED, MOVE_COPY, PLCASM_MN_SUFFIX | PLCASM_MN_NEEDS_NEXT },
+    { ".copy", PLCASM_MN_TYPED, COPY, PLCASM_MN_SUFFIX | PLCASM_MN_NEEDS_NEXT },
+    { ".drop", PLCASM_MN_TYPED, DROP, PLCASM_MN_SUFFIX | PLCASM_MN_NEEDS_NEXT },
+    { ".cmp_lt", PLCASM_MN_TYPED, CMP_LT, PLCASM_MN_SUFFIX },
+    { ".cmp_gt", PLCASM_MN_TYPED, CMP_GT, PLCASM_MN_SUFFIX },
+    { ".cmp_eq", PLCASM_MN_TYPED, CMP_EQ, PLCASM_MN_SUFFIX },
+    { ".cmp_neq", PLCASM_MN_TYPED, CMP_NEQ, PLCASM_MN_SUFFIX },
+    { ".cmp_gte", PLCASM_MN_TYPED, CMP_GTE, PLCASM_MN_SUFFIX },
+    { ".cmp_lte", PLCASM_MN_TYPED, CMP_LTE, PLCASM_MN_SUFFIX },
+    { ".add", PLCASM_MN_TYPED, ADD, PLCASM_MN_SUFFIX },
+    { ".sub", PLCASM_MN_TYPED, SUB, PLCASM_MN_SUFFIX },
+    { ".mul", PLCASM_MN_TYPED, MUL, PLCASM_MN_SUFFIX },
+    { ".div", PLCASM_MN_TYPED, DIV, PLCASM_MN_SUFFIX },
+    { ".mod", PLCASM_MN_TYPED, MOD, PLCASM_MN_SUFFIX },
+    { ".pow", PLCASM_MN_TYPED, POW, PLCASM_MN_SUFFIX },
+    { ".sqrt", PLCASM_MN_TYPED, SQRT, PLCASM_MN_SUFFIX },
+    { ".neg", PLCASM_MN_TYPED, NEG, PLCASM_MN_SUFFIX },
+    { ".abs", PLCASM_MN_TYPED, ABS, PLCASM_MN_SUFFIX },
+    { ".sin", PLCASM_MN_TYPED, SIN, PLCASM_MN_SUFFIX },
+    { ".cos", PLCASM_MN_TYPED, COS, PLCASM_MN_SUFFIX },
+
+    // Jumps and calls: <op> label
+    { "jmp", PLCASM_MN_JUMP, JMP, PLCASM_MN_NEEDS_NEXT },
+    { "jump", PLCASM_MN_JUMP, JMP, PLCASM_MN_NEEDS_NEXT },
+    { "jmp_if", PLCASM_MN_JUMP, JMP_IF, PLCASM_MN_NEEDS_NEXT },
+    { "jump_if", PLCASM_MN_JUMP, JMP_IF, PLCASM_MN_NEEDS_NEXT },
+    { "jmp_if_not", PLCASM_MN_JUMP, JMP_IF_NOT, PLCASM_MN_NEEDS_NEXT },
+    { "jump_if_not", PLCASM_MN_JUMP, JMP_IF_NOT, PLCASM_MN_NEEDS_NEXT },
+    { "call", PLCASM_MN_JUMP, CALL, PLCASM_MN_NEEDS_NEXT },
+    { "call_if", PLCASM_MN_JUMP, CALL_IF, PLCASM_MN_NEEDS_NEXT },
+    { "call_if_not", PLCASM_MN_JUMP, CALL_IF_NOT, PLCASM_MN_NEEDS_NEXT },
+    { "jmp_rel", PLCASM_MN_JUMP, JMP_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+    { "jump_rel", PLCASM_MN_JUMP, JMP_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+    { "jmp_if_rel", PLCASM_MN_JUMP, JMP_IF_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+    { "jump_if_rel", PLCASM_MN_JUMP, JMP_IF_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+    { "jmp_if_not_rel", PLCASM_MN_JUMP, JMP_IF_NOT_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+    { "jump_if_not_rel", PLCASM_MN_JUMP, JMP_IF_NOT_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+    { "call_rel", PLCASM_MN_JUMP, CALL_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+    { "call_if_rel", PLCASM_MN_JUMP, CALL_IF_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+    { "call_if_not_rel", PLCASM_MN_JUMP, CALL_IF_NOT_REL, PLCASM_MN_NEEDS_NEXT | PLCASM_MN_RELATIVE },
+
+    // Typed push and address forms, handled by the data type operations
+    { ".const", PLCASM_MN_OPERAND, 0, PLCASM_MN_SUFFIX },
+    { ".push", PLCASM_MN_OPERAND, 0, PLCASM_MN_SUFFIX },
+    { ".load_from", PLCASM_MN_OPERAND, 0, PLCASM_MN_SUFFIX },
+    { ".move_to", PLCASM_MN_OPERAND, 0, PLCASM_MN_SUFFIX },
+    { ".inc", PLCASM_MN_OPERAND, 0, PLCASM_MN_SUFFIX },
+    { ".dec", PLCASM_MN_OPERAND, 0, PLCASM_MN_SUFFIX },
+    { ".pick", PLCASM_MN_OPERAND, 0, PLCASM_MN_SUFFIX },
+    { ".poke", PLCASM_MN_OPERAND, 0, PLCASM_MN_SUFFIX },
+    { "i8", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "i16", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "i32", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "i64", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "u8", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "u16", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "u32", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "u64", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "f32", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "f64", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "bool", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "bit", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "byte", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "ptr", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+    { "pointer", PLCASM_MN_OPERAND, 0, PLCASM_MN_TYPE_PREFIX },
+
+    // Hand written handlers in PLCASMCompiler::build()
+    { "ton", PLCASM_MN_TIMER, 0, 0 },
+    { "tof", PLCASM_MN_TIMER, 0, 0 },
+    { "tp", PLCASM_MN_TIMER, 0, 0 },
+    { "ctu", PLCASM_MN_COUNTER, 0, 0 },
+    { "ctd", PLCASM_MN_COUNTER, 0, 0 },
+    { "lang", PLCASM_MN_META, 0, 0 },
+    { "comment", PLCASM_MN_META, 0, 0 },
+    { "ffi", PLCASM_MN_FFI, 0, 0 },
+    { "ffi.start", PLCASM_MN_FFI, 0, 0 },
+    { "ffi.poll", PLCASM_MN_FFI, 0, 0 },
+    { "ffi.batch", PLCASM_MN_FFI, 0, 0 },
+    { "mem.fill", PLCASM_MN_MEMORY, 0, 0 },
+    { "cvt", PLCASM_MN_CONVERT, 0, 0 },
+    { "swap", PLCASM_MN_CONVERT, 0, 0 },
+
+    { "comms_begin", PLCASM_MN_COMMS, 0, 0 },
+    { "comms_end", PLCASM_MN_COMMS, 0, 0 },
+    { "comms_enabled", PLCASM_MN_COMMS, 0, 0 },
+    { "comms_status", PLCASM_MN_COMMS, 0, 0 },
+    { "comms_set_priority", PLCASM_MN_COMMS, 0, 0 },
+    { "comms_poll_async", PLCASM_MN_COMMS, 0, 0 },
+    { "comms_queue_size", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_add_coils", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_add_discrete", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_add_holding", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_add_input_reg", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_read_coils", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_read_discrete", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_read_holding", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_read_input", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_write_coil", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_write_reg", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_write_coils", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_write_regs", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_poll", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_slv_get_coil", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_slv_set_coil", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_slv_get_reg", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_slv_set_reg", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_slv_get_di", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_slv_set_di", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_slv_get_ir", PLCASM_MN_COMMS, 0, 0 },
+    { "mb_slv_set_ir", PLCASM_MN_COMMS, 0, 0 },
+    { "tcp_connect", PLCASM_MN_COMMS, 0, 0 },
+    { "tcp_disconnect", PLCASM_MN_COMMS, 0, 0 },
+    { "tcp_connected", PLCASM_MN_COMMS, 0, 0 },
+    { "tcp_listen", PLCASM_MN_COMMS, 0, 0 },
+    { "tcp_accept", PLCASM_MN_COMMS, 0, 0 },
+    { "tcp_send", PLCASM_MN_COMMS, 0, 0 },
+    { "tcp_recv", PLCASM_MN_COMMS, 0, 0 },
+    { "tcp_available", PLCASM_MN_COMMS, 0, 0 },
+    { "udp_open", PLCASM_MN_COMMS, 0, 0 },
+    { "udp_close", PLCASM_MN_COMMS, 0, 0 },
+    { "udp_send", PLCASM_MN_COMMS, 0, 0 },
+    { "udp_recv", PLCASM_MN_COMMS, 0, 0 },
+    { "udp_available", PLCASM_MN_COMMS, 0, 0 },
+    { "eth_sock_acquire", PLCASM_MN_COMMS, 0, 0 },
+    { "eth_sock_release", PLCASM_MN_COMMS, 0, 0 },
+    { "eth_sock_status", PLCASM_MN_COMMS, 0, 0 },
+    { "eth_sock_set_active", PLCASM_MN_COMMS, 0, 0 },
+    { "eth_sock_info", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_write", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_read", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_available", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_flush", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_write_byte", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_read_byte", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_poll", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_msg_ready", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_read_msg", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_set_delim", PLCASM_MN_COMMS, 0, 0 },
+    { "ser_set_baud", PLCASM_MN_COMMS, 0, 0 },
+
+    { "str.len", PLCASM_MN_STRING, 0, 0 },
+    { "str.cap", PLCASM_MN_STRING, 0, 0 },
+    { "str.get", PLCASM_MN_STRING, 0, 0 },
+    { "str.set", PLCASM_MN_STRING, 0, 0 },
+    { "str.clear", PLCASM_MN_STRING, 0, 0 },
+    { "str.char", PLCASM_MN_STRING, 0, 0 },
+    { "str.init", PLCASM_MN_STRING, 0, 0 },
+    { "str.cmp", PLCASM_MN_STRING, 0, 0 },
+    { "str.eq", PLCASM_MN_STRING, 0, 0 },
+    { "str.concat", PLCASM_MN_STRING, 0, 0 },
+    { "str.copy", PLCASM_MN_STRING, 0, 0 },
+    { "str.substr", PLCASM_MN_STRING, 0, 0 },
+    { "str.find", PLCASM_MN_STRING, 0, 0 },
+    { "str.cmp16", PLCASM_MN_STRING, 0, 0 },
+    { "str.eq16", PLCASM_MN_STRING, 0, 0 },
+    { "str.concat16", PLCASM_MN_STRING, 0, 0 },
+    { "str.copy16", PLCASM_MN_STRING, 0, 0 },
+    { "str.substr16", PLCASM_MN_STRING, 0, 0 },
+    { "str.find16", PLCASM_MN_STRING, 0, 0 },
+    { "str16.len", PLCASM_MN_STRING, 0, 0 },
+    { "str16.cap", PLCASM_MN_STRING, 0, 0 },
+    { "str16.get", PLCASM_MN_STRING, 0, 0 },
+    { "str16.set", PLCASM_MN_STRING, 0, 0 },
+    { "str16.clear", PLCASM_MN_STRING, 0, 0 },
+    { "str16.char", PLCASM_MN_STRING, 0, 0 },
+    { "str16.init", PLCASM_MN_STRING, 0, 0 },
+    { "str16.cmp", PLCASM_MN_STRING, 0, 0 },
+    { "str16.eq", PLCASM_MN_STRING, 0, 0 },
+    { "str16.concat", PLCASM_MN_STRING, 0, 0 },
+    { "str16.copy", PLCASM_MN_STRING, 0, 0 },
+    { "str16.substr", PLCASM_MN_STRING, 0, 0 },
+    { "str16.find", PLCASM_MN_STRING, 0, 0 },
+    { "str16.cmp8", PLCASM_MN_STRING, 0, 0 },
+    { "str16.eq8", PLCASM_MN_STRING, 0, 0 },
+    { "str16.concat8", PLCASM_MN_STRING, 0, 0 },
+    { "str16.copy8", PLCASM_MN_STRING, 0, 0 },
+    { "str16.substr8", PLCASM_MN_STRING, 0, 0 },
+    { "str16.find8", PLCASM_MN_STRING, 0, 0 },
+    { "cstr.lit", PLCASM_MN_STRING, 0, 0 },
+    { "cstr16.lit", PLCASM_MN_STRING, 0, 0 },
+    { "cstr.cat", PLCASM_MN_STRING, 0, 0 },
+    { "cstr16.cat", PLCASM_MN_STRING, 0, 0 },
+    // str.to.<type> / str.from.<type> are matched by prefix and are not listed here
+};
+const int plcasm_mnemonic_count = sizeof(plcasm_mnemonics) / sizeof(plcasm_mnemonics[0]);
+
+#define PLCASM_MNEMONIC_BUCKETS 128     // Power of two
+#define PLCASM_MNEMONIC_SLOTS   512     // Power of two, at least twice the table size
+
+struct PLCASMMnemonicIndex {
+    u8 displacement[PLCASM_MNEMONIC_BUCKETS];
+    u16 slots[PLCASM_MNEMONIC_SLOTS];   // Entry index + 1, 0 = empty
+    bool ready;
+    bool perfect;                       // False if no displacement was found, lookups scan the table
+
+    static u32 slotOf(u32 hash, u8 displacement) {
+        u32 h = hash ^ (displacement * 0x9E3779B9u);
+        h ^= h >> 16; h *= 0x85EBCA6Bu;
+        h ^= h >> 13; h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h & (PLCASM_MNEMONIC_SLOTS - 1);
+    }
+
+    static u32 hashOf(const char* data, int length) { return nameHash(data, length, true); }
+
+    // Place the largest buckets first, trying displacements until all of a bucket's keys land in free slots
+    void build() {
+        u32 hashes[plcasm_mnemonic_count];
+        u8 sizes[PLCASM_MNEMONIC_BUCKETS];
+        memset(sizes, 0, sizeof(sizes));
+        memset(displacement, 0, sizeof(displacement));
+        memset(slots, 0, sizeof(slots));
+        int largest = 0;
+        for (int i = 0; i < plcasm_mnemonic_count; i++) {
+            hashes[i] = hashOf(plcasm_mnemonics[i].name, string_len(plcasm_mnemonics[i].name));
+            u8& size = sizes[hashes[i] & (PLCASM_MNEMONIC_BUCKETS - 1)];
+            size++;
+            if (size > largest) largest = size;
+        }
+        perfect = true;
+        for (int size = largest; size > 0 && perfect; size--) {
+            for (int b = 0; b < PLCASM_MNEMONIC_BUCKETS && perfect; b++) {
+                if (sizes[b] != size) continue;
+                bool placed = false;
+                for (int d = 0; d < 256 && !placed; d++) {
+                    placed = true;
+                    for (int i = 0; i < plcasm_mnemonic_count; i++) {
+                        if ((hashes[i] & (PLCASM_MNEMONIC_BUCKETS - 1)) != (u32) b) continue;
+                        u16& slot = slots[slotOf(hashes[i], (u8) d)];
+                        if (slot) { placed = false; break; }
+                        slot = (u16) (i + 1);
+                    }
+                    if (placed) {
+                        displacement[b] = (u8) d;
+                    } else {
+                        // Roll back the keys of this bucket placed with `d`
+                        for (int s = 0; s < PLCASM_MNEMONIC_SLOTS; s++) {
+                            if (slots[s] && (hashes[slots[s] - 1] & (PLCASM_MNEMONIC_BUCKETS - 1)) == (u32) b) slots[s] = 0;
+                        }
+                    }
+                }
+                if (!placed) perfect = false;
+            }
+        }
+        ready = true;
+    }
+
+    const PLCASMMnemonic* find(const char* data, int length) {
+        if (!ready) build();
+        if (!perfect) {
+            for (int i = 0; i < plcasm_mnemonic_count; i++) {
+                if (matches(plcasm_mnemonics[i], data, length)) return &plcasm_mnemonics[i];
+            }
+            return nullptr;
+        }
+        u32 hash = hashOf(data, length);
+        u16 slot = slots[slotOf(hash, displacement[hash & (PLCASM_MNEMONIC_BUCKETS - 1)])];
+        if (slot == 0) return nullptr;
+        const PLCASMMnemonic& entry = plcasm_mnemonics[slot - 1];
+        return matches(entry, data, length) ? &entry : nullptr;
+    }
+
+    static bool matches(const PLCASMMnemonic& entry, const char* data, int length) {
+        const char* name = entry.name;
+        for (int i = 0; i < length; i++) {
+            if (name[i] == '\0' || sharedToLower(data[i]) != name[i]) return false;
+        }
+        return name[length] == '\0';
+    }
+};
+
+inline const PLCASMMnemonic* plcasmFindMnemonic(const char* data, int length) {
+    static PLCASMMnemonicIndex index;
+    return index.find(data, length);
+}
+
+// Resolve a mnemonic through the table: exact names first, then "<type>.<op>" by its suffix
+// when `data_type` was read from the prefix
+inline const PLCASMMnemonic* plcasmResolveMnemonic(const char* data, int length, u8 data_type) {
+    const PLCASMMnemonic* mnemonic = plcasmFindMnemonic(data, length);
+    if (mnemonic || !data_type) return mnemonic;
+    int dot = 0;
+    while (dot < length && data[dot] != '.') dot++;
+    if (dot == length) return nullptr;
+    const PLCASMMnemonic* prefix = plcasmFindMnemonic(data, dot);
+    if (!prefix || !(prefix->flags & PLCASM_MN_TYPE_PREFIX)) return nullptr;
+    mnemonic = plcasmFindMnemonic(data + dot, length - dot);
+    return mnemonic && (mnemonic->flags & PLCASM_MN_SUFFIX) ? mnemonic : nullptr;
+}
+
+#endif // __WASM__
@@ -530,6 +530,11 @@ public:
     // Output PLCASM
     char output[PLCSCRIPT_MAX_OUTPUT_SIZE];
     int outputLength = 0;
+
+    // Generated PLCASM records (plcasm-ir.h), rendered into output by compile()
+    // The project compiler points ir at its own records (kept across reset())
+    PLCASMInstructionIR generated;
+    PLCASMInstructionIR* ir = &generated;
     
     // Error handling
     char errorMessage[512];
@@ -714,134 +719,35 @@ public:
     // Output helpers
     // ========================================================================
     
-    void emit(const char* str) {
-        while (*str && outputLength < PLCSCRIPT_MAX_OUTPUT_SIZE - 1) {
-            output[outputLength++] = *str++;
-        }
+    // Render the generated records as the PLCASM text in output
+    void renderOutput() {
+        int length = generated.render(0, generated.record_count, output, PLCSCRIPT_MAX_OUTPUT_SIZE - 1);
+        outputLength = length < PLCSCRIPT_MAX_OUTPUT_SIZE - 1 ? length : PLCSCRIPT_MAX_OUTPUT_SIZE - 1;
         output[outputLength] = '\0';
     }
     
-    void emitLine(const char* str) {
-        emit(str);
-        emit("\n");
-    }
-    
-    void emitIndent(int level = 1) {
-        for (int i = 0; i < level; i++) {
-            emit("    ");
-        }
-    }
-    
-    void emitInt(int64_t value) {
-        char buf[32];
-        int i = 0;
-        bool negative = value < 0;
-        if (negative) value = -value;
-        if (value == 0) {
-            buf[i++] = '0';
-        } else {
-            while (value > 0) {
-                buf[i++] = '0' + (value % 10);
-                value /= 10;
-            }
-        }
-        if (negative) buf[i++] = '-';
-        for (int j = i - 1; j >= 0; j--) {
-            if (outputLength < PLCSCRIPT_MAX_OUTPUT_SIZE - 1) {
-                output[outputLength++] = buf[j];
-            }
-        }
-        output[outputLength] = '\0';
-    }
-    
-    void emitFloat(double value) {
-        // Simple float to string conversion
-        if (value < 0) {
-            emit("-");
-            value = -value;
-        }
-        int64_t intPart = (int64_t)value;
-        double fracPart = value - intPart;
-        emitInt(intPart);
-        emit(".");
-        // 6 decimal places
-        for (int i = 0; i < 6; i++) {
-            fracPart *= 10;
-            int digit = (int)fracPart;
-            char c = '0' + digit;
-            if (outputLength < PLCSCRIPT_MAX_OUTPUT_SIZE - 1) {
-                output[outputLength++] = c;
-            }
-            fracPart -= digit;
-        }
-        output[outputLength] = '\0';
-    }
-    
-    // Emit a string literal with proper escaping for PLCASM cstr.lit instruction
+    // String literal operand for the PLCASM string instructions
     // The input string has already been processed by the tokenizer (escapes decoded)
     // We need to re-encode escapes when emitting to PLCASM
     // PLCASM uses single quotes for string literals
     void emitStringLiteral(const char* str, int len) {
-        emit("'");
-        for (int i = 0; i < len; i++) {
-            char c = str[i];
-            switch (c) {
-                case '\n': emit("\\n"); break;
-                case '\r': emit("\\r"); break;
-                case '\t': emit("\\t"); break;
-                case '\0': emit("\\0"); break;
-                case '\\': emit("\\\\"); break;
-                case '\'': emit("\\'"); break;
-                default:
-                    // Emit printable ASCII directly, escape control chars
-                    if (c >= 32 && c < 127) {
-                        char buf[2] = { c, '\0' };
-                        emit(buf);
-                    } else {
-                        // Non-printable: emit as octal or just pass through
-                        // For simplicity, just emit the byte directly
-                        char buf[2] = { c, '\0' };
-                        emit(buf);
-                    }
-                    break;
-            }
-        }
-        emit("'");
-    }
-    
-    // Helper to emit a string literal without quotes (raw content for concat)
-    void emitStringLiteralRaw(const char* str, int len) {
+        ir->beginString('\'');
         for (int i = 0; i < len; i++) {
             char c = str[i];
             switch (c) {
-                case '\n': emit("\\n"); break;
-                case '\r': emit("\\r"); break;
-                case '\t': emit("\\t"); break;
-                case '\0': emit("\\0"); break;
-                case '\\': emit("\\\\"); break;
-                case '\'': emit("\\'"); break;
+                case '\n': ir->append("\\n"); break;
+                case '\r': ir->append("\\r"); break;
+                case '\t': ir->append("\\t"); break;
+                case '\0': ir->append("\\0"); break;
+                case '\\': ir->append("\\\\"); break;
+                case '\'': ir->append("\\'"); break;
                 default:
-                    if (c >= 32 && c < 127) {
-                        char buf[2] = { c, '\0' };
-                        emit(buf);
-                    } else {
-                        char buf[2] = { c, '\0' };
-                        emit(buf);
-                    }
+                    // Printable ASCII and any other byte pass through as is
+                    ir->appendChar(c);
                     break;
             }
         }
-    }
-    
-    void emitHex(uint32_t value) {
-        const char hex[] = "0123456789abcdef";
-        char buf[9];
-        for (int i = 7; i >= 0; i--) {
-            buf[i] = hex[value & 0xF];
-            value >>= 4;
-        }
-        buf[8] = '\0';
-        emit(buf);
+        ir->endString();
     }
     
     void generateLabel(char* buf, const char* prefix) {
@@ -877,8 +783,8 @@ public:
     }
     
     void emitLabel(const char* label) {
-        emit(label);
-        emitLine(":");
+        ir->label(label);
+        ir->end();
     }
     
     // ========================================================================
@@ -2160,29 +2066,28 @@ public:
     // ========================================================================
     
     void emitComment(const char* comment) {
-        emit("// ");
-        emitLine(comment);
+        ir->comment("// ");
+        ir->append(comment);
+        ir->end();
     }
     
     void emitLoadConst(PLCScriptVarType type, int64_t value) {
-        emit(varTypeToPlcasm(type));
-        emit(".const ");
-        emitInt(value);
-        emit("\n");
+        ir->instruction(varTypeToPlcasm(type), ".const");
+        ir->integer(value);
+        ir->end();
     }
     
     void emitLoadConstFloat(PLCScriptVarType type, double value) {
-        emit(varTypeToPlcasm(type));
-        emit(".const ");
-        emitFloat(value);
-        emit("\n");
+        ir->instruction(varTypeToPlcasm(type), ".const");
+        ir->real(value);
+        ir->end();
     }
     
     void emitDrop(PLCScriptVarType type) {
         // String types don't push values to stack, so nothing to drop
         if (type == PSTYPE_STR8 || type == PSTYPE_STR16) return;
-        emit(varTypeToPlcasm(type));
-        emitLine(".drop");
+        ir->instruction(varTypeToPlcasm(type), ".drop");
+        ir->end();
     }
 
     // Parse a compile-time integer argument for COMMS instructions.
@@ -2205,13 +2110,13 @@ public:
     // Emit a COMMS mnemonic with # prefixed integer arguments.
     // Example: emitCommsCall("tcp_listen", {0, 8080}) → "tcp_listen #0 #8080\n"
     void emitCommsInt(int64_t value) {
-        emit(" #");
-        emitInt(value);
+        ir->value("#");
+        ir->appendInt(value);
     }
     
     void emitCopy(PLCScriptVarType type) {
-        emit(varTypeToPlcasm(type));
-        emitLine(".copy");
+        ir->instruction(varTypeToPlcasm(type), ".copy");
+        ir->end();
     }
     
     // Get size in bytes for a variable type
@@ -2395,14 +2300,11 @@ public:
             // The address was generated when the variable was declared
         }
         if (sym->isBit) {
-            emit("u8.readBit ");
-            emit(sym->address);
-            emit("\n");
+            ir->emit("u8.readBit", sym->address);
         } else {
-            emit(varTypeToPlcasm(sym->type));
-            emit(".load_from ");
-            emit(sym->address);
-            emit("\n");
+            ir->instruction(varTypeToPlcasm(sym->type), ".load_from");
+            ir->name(sym->address);
+            ir->end();
         }
     }
     
@@ -2412,54 +2314,60 @@ public:
             // The address was generated when the variable was declared
         }
         if (sym->isBit) {
-            emit("u8.writeBit ");
-            emit(sym->address);
-            emit("\n");
+            ir->emit("u8.writeBit", sym->address);
         } else {
-            emit(varTypeToPlcasm(sym->type));
-            emit(".move_to ");
-            emit(sym->address);
-            emit("\n");
+            ir->instruction(varTypeToPlcasm(sym->type), ".move_to");
+            ir->name(sym->address);
+            ir->end();
         }
     }
     
     void emitBinaryOp(const char* op, PLCScriptVarType type) {
-        emit(varTypeToPlcasm(type));
-        emit(".");
-        emit(op);
-        emit("\n");
+        ir->instruction(varTypeToPlcasm(type));
+        ir->append(".");
+        ir->append(op);
+        ir->end();
     }
     
     void emitCompareOp(const char* op, PLCScriptVarType type) {
-        emit(varTypeToPlcasm(type));
-        emit(".cmp_");
-        emit(op);
-        emit("\n");
+        ir->instruction(varTypeToPlcasm(type));
+        ir->append(".cmp_");
+        ir->append(op);
+        ir->end();
     }
     
     void emitJump(const char* label) {
-        emit("jmp ");
-        emit(label);
-        emit("\n");
+        ir->instruction("jmp");
+        ir->target(label);
+        ir->end();
     }
     
     void emitJumpIfFalse(const char* label) {
-        emit("jmp_if_not ");
-        emit(label);
-        emit("\n");
+        ir->instruction("jmp_if_not");
+        ir->target(label);
+        ir->end();
     }
     
     void emitJumpIfTrue(const char* label) {
-        emit("jmp_if ");
-        emit(label);
-        emit("\n");
+        ir->instruction("jmp_if");
+        ir->target(label);
+        ir->end();
     }
     
     // ========================================================================
     // Parser & Code Generator
     // ========================================================================
     
+    // Compile to PLCASM records, rendered into output unless ir points at other records
     bool compile() {
+        bool standalone = ir == &generated;
+        if (standalone) generated.reset();
+        bool ok = generate();
+        if (standalone) renderOutput();
+        return ok;
+    }
+    
+    bool generate() {
         // Two-pass compilation:
         // Pass 1: Scan for function declarations and register their signatures
         // Pass 2: Generate code (now knowing all function signatures for forward references)
@@ -2493,11 +2401,14 @@ public:
         
         // Emit header comment
         emitComment("Generated by PLCScript Compiler");
-        emit("\n");
+        ir->blank();
         
         // Jump over function definitions to main code
         if (functionCount > 0) {
-            emit("jmp __main_start\n\n");
+            ir->instruction("jmp");
+            ir->target("__main_start");
+            ir->end();
+            ir->blank();
         }
         
         // First, emit all function bodies
@@ -2515,7 +2426,8 @@ public:
         
         // Emit main code label
         if (functionCount > 0) {
-            emit("__main_start:\n");
+            ir->label("__main_start");
+            ir->end();
         }
         
         // Parse main program (list of statements, excluding function declarations)
@@ -2529,7 +2441,7 @@ public:
         }
         
         // Emit exit if not already
-        emitLine("exit");
+        ir->emit("exit");
         
         return !hasError;
     }
@@ -2769,8 +2681,8 @@ public:
         currentFunction = func;
         
         // Emit function label
-        emit(func->entryLabel);
-        emit(":\n");
+        ir->label(func->entryLabel);
+        ir->end();
         
         // Enter function scope
         currentScopeLevel++;
@@ -2790,10 +2702,9 @@ public:
             generateAutoAddress(sym);
             
             // Pop parameter from stack into local variable address
-            emit(varTypeToPlcasm(param->type));
-            emit(".move_to ");
-            emit(sym->address);
-            emit("\n");
+            ir->instruction(varTypeToPlcasm(param->type), ".move_to");
+            ir->name(sym->address);
+            ir->end();
         }
         
         // Position tokenizer at body start (at the '{')
@@ -2823,7 +2734,7 @@ public:
         // Emit fallback return (in case function doesn't explicitly return)
         // This is unreachable if all code paths have explicit return statements
         if (func->returnType == PSTYPE_VOID) {
-            emit("ret\n");
+            ir->emit("ret");
         } else {
             // For non-void functions, warn if the last statement wasn't a return
             if (!lastStatementWasTerminator) {
@@ -2831,11 +2742,11 @@ public:
             }
             // Push a default value and return as fallback
             emitLoadConst(func->returnType, 0);
-            emit("ret\n");
+            ir->emit("ret");
         }
         lastStatementWasTerminator = false;
         
-        emit("\n");
+        ir->blank();
         
         // Exit function scope - remove local symbols
         while (symbolCount > prevSymbolCount) {
@@ -3006,9 +2917,10 @@ public:
             StructCompareResult cmp = compareUserStructTypes(existing, &tempUST);
             if (cmp == STRUCT_COMPARE_IDENTICAL) {
                 // Duplicate but identical - emit warning comment
-                emit("// WARNING: Duplicate struct type declaration '");
-                emit(typeName);
-                emit("' (identical to previous definition)\n");
+                ir->comment("// WARNING: Duplicate struct type declaration '");
+                ir->append(typeName);
+                ir->append("' (identical to previous definition)");
+                ir->end();
             } else {
                 // Conflict - add error
                 char err[128];
@@ -3040,22 +2952,23 @@ public:
         match(PSTOK_SEMICOLON);
         
         // Emit comment about the struct definition
-        emit("// type ");
-        emit(typeName);
-        emit(" = struct { ");
+        ir->comment("// type ");
+        ir->append(typeName);
+        ir->append(" = struct { ");
         for (int k = 0; k < structType->fieldCount; k++) {
-            if (k > 0) emit(", ");
-            emit(structType->fields[k].name);
-            emit(": ");
+            if (k > 0) ir->append(", ");
+            ir->append(structType->fields[k].name);
+            ir->append(": ");
             if (structType->fields[k].type == PSTYPE_STRUCT) {
-                emit(structTypes[structType->fields[k].structTypeIndex].name);
+                ir->append(structTypes[structType->fields[k].structTypeIndex].name);
             } else {
-                emit(varTypeToPlcasm(structType->fields[k].type));
+                ir->append(varTypeToPlcasm(structType->fields[k].type));
             }
         }
-        emit(" } // size=");
-        emitInt(structType->totalSize);
-        emit(" bytes\n");
+        ir->append(" } // size=");
+        ir->appendInt(structType->totalSize);
+        ir->append(" bytes");
+        ir->end();
     }
     
     // Parse a function declaration
@@ -3338,78 +3251,44 @@ public:
             }
             
             // Emit comment
-            emit("// ");
-            emit(isConst ? "const " : "let ");
-            emit(name);
-            emit(": ");
-            emit(varTypeToPlcasm(varType));
+            ir->comment("// ");
+            ir->append(isConst ? "const " : "let ");
+            ir->append(name);
+            ir->append(": ");
+            ir->append(varTypeToPlcasm(varType));
             if (string_capacity > 0) {
-                emit("[");
-                char sizeBuf[16];
-                int si = 0;
-                u16 s = string_capacity;
-                if (s == 0) sizeBuf[si++] = '0';
-                else {
-                    char temp[16];
-                    int ti = 0;
-                    while (s > 0) { temp[ti++] = '0' + (s % 10); s /= 10; }
-                    while (ti > 0) sizeBuf[si++] = temp[--ti];
-                }
-                sizeBuf[si] = '\0';
-                emit(sizeBuf);
-                emit("]");
+                ir->append("[");
+                ir->appendInt(string_capacity);
+                ir->append("]");
             } else if (array_size > 0) {
-                emit("[");
-                char sizeBuf[16];
-                int si = 0;
-                MY_PTR_t s = array_size;
-                if (s == 0) sizeBuf[si++] = '0';
-                else {
-                    char temp[16];
-                    int ti = 0;
-                    while (s > 0) { temp[ti++] = '0' + (s % 10); s /= 10; }
-                    while (ti > 0) sizeBuf[si++] = temp[--ti];
-                }
-                sizeBuf[si] = '\0';
-                emit(sizeBuf);
-                emit("]");
+                ir->append("[");
+                ir->appendInt(array_size);
+                ir->append("]");
             }
             if (hasAddress) {
-                emit(" @ ");
-                emit(address);
+                ir->append(" @ ");
+                ir->append(address);
                 if (isLocal) {
-                    emit(" (local)");
+                    ir->append(" (local)");
                 } else if (isAutoAddress) {
-                    emit(" (auto)");
+                    ir->append(" (auto)");
                 }
             }
             if (isTypeInferred) {
-                emit(" [inferred]");
+                ir->append(" [inferred]");
             }
-            emit("\n");
+            ir->end();
             
             // String initialization: emit str.init to set capacity
             if (varType == PSTYPE_STR8 || varType == PSTYPE_STR16) {
                 const char* strType = (varType == PSTYPE_STR8) ? "str" : "str16";
-                u16 cap = sym->stringCapacity;
                 
-                emit("u16.const ");
-                char capBuf[16];
-                int ci = 0;
-                if (cap == 0) capBuf[ci++] = '0';
-                else {
-                    char temp[16];
-                    int ti = 0;
-                    while (cap > 0) { temp[ti++] = '0' + (cap % 10); cap /= 10; }
-                    while (ti > 0) capBuf[ci++] = temp[--ti];
-                }
-                capBuf[ci] = '\0';
-                emit(capBuf);
-                emit("\n");
-                emit(strType);
-                emit(".init ");
-                emit(sym->address);
-                emit("\n");
+                ir->instruction("u16.const");
+                ir->integer(sym->stringCapacity);
+                ir->end();
+                ir->instruction(strType, ".init");
+                ir->name(sym->address);
+                ir->end();
             }
         }
         // else: type is still AUTO - will be resolved by the initializer below
@@ -3470,24 +3349,24 @@ public:
                 }
                 
                 // Emit comment (after expression code, before store)
-                emit("// ");
-                emit(isConst ? "const " : "let ");
-                emit(name);
-                emit(": ");
-                emit(varTypeToPlcasm(varType));
+                ir->comment("// ");
+                ir->append(isConst ? "const " : "let ");
+                ir->append(name);
+                ir->append(": ");
+                ir->append(varTypeToPlcasm(varType));
                 if (hasAddress) {
-                    emit(" @ ");
-                    emit(address);
+                    ir->append(" @ ");
+                    ir->append(address);
                     if (isLocal) {
-                        emit(" (local)");
+                        ir->append(" (local)");
                     } else if (isAutoAddress) {
-                        emit(" (auto)");
+                        ir->append(" (auto)");
                     }
                 }
                 if (isTypeInferred) {
-                    emit(" [inferred]");
+                    ir->append(" [inferred]");
                 }
-                emit("\n");
+                ir->end();
             }
             
             // Handle string type initialization specially
@@ -3509,22 +3388,18 @@ public:
                 // Check for string literal initialization
                 else if (hasPendingStringLiteral) {
                     // Use cstr.lit for efficient inline string literal copy
-                    emit(cstrType);
-                    emit(".lit ");
-                    emit(sym->address);
-                    emit(" ");
+                    ir->instruction(cstrType, ".lit");
+                    ir->name(sym->address);
                     emitStringLiteral(pendingStringLiteral, pendingStringLiteralLen);
-                    emit("\n");
+                    ir->end();
                     hasPendingStringLiteral = false;
                     sym->hasInitializer = true;
                 } else if (lastStringSymbol) {
                     // Copy from another string variable
-                    emit(strType);
-                    emit(".copy ");
-                    emit(sym->address);
-                    emit(" ");
-                    emit(lastStringSymbol->address);
-                    emit("\n");
+                    ir->instruction(strType, ".copy");
+                    ir->name(sym->address);
+                    ir->name(lastStringSymbol->address);
+                    ir->end();
                     sym->hasInitializer = true;
                 } else {
                     setError("String initializer must be a literal or variable");
@@ -3534,11 +3409,10 @@ public:
             } else {
                 // Type conversion if needed (non-string types)
                 if (exprType != varType && exprType != PSTYPE_VOID && !isStringType(exprType)) {
-                    emit("cvt ");
-                    emit(varTypeToPlcasm(exprType));
-                    emit(" ");
-                    emit(varTypeToPlcasm(varType));
-                    emit("\n");
+                    ir->instruction("cvt");
+                    ir->name(varTypeToPlcasm(exprType));
+                    ir->name(varTypeToPlcasm(varType));
+                    ir->end();
                 }
                 
                 // Store to memory
@@ -3581,24 +3455,24 @@ public:
             }
             
             // Emit comment
-            emit("// ");
-            emit(isConst ? "const " : "let ");
-            emit(name);
-            emit(": ");
-            emit(varTypeToPlcasm(varType));
+            ir->comment("// ");
+            ir->append(isConst ? "const " : "let ");
+            ir->append(name);
+            ir->append(": ");
+            ir->append(varTypeToPlcasm(varType));
             if (hasAddress) {
-                emit(" @ ");
-                emit(address);
+                ir->append(" @ ");
+                ir->append(address);
                 if (isLocal) {
-                    emit(" (local)");
+                    ir->append(" (local)");
                 } else if (isAutoAddress) {
-                    emit(" (auto)");
+                    ir->append(" (auto)");
                 }
             }
             if (isTypeInferred) {
-                emit(" [inferred]");
+                ir->append(" [inferred]");
             }
-            emit("\n");
+            ir->end();
         }
         
         // Semicolon is optional
@@ -3854,10 +3728,10 @@ public:
                 
                 // Convert return value to function's return type if needed
                 if (retType != currentFunction->returnType && currentFunction->returnType != PSTYPE_VOID) {
-                    emit("cvt ");
-                    emit(varTypeToPlcasm(retType));
-                    emit(" ");
-                    emitLine(varTypeToPlcasm(currentFunction->returnType));
+                    ir->instruction("cvt");
+                    ir->name(varTypeToPlcasm(retType));
+                    ir->name(varTypeToPlcasm(currentFunction->returnType));
+                    ir->end();
                 }
                 // Value stays on stack for caller
             } else if (currentFunction->returnType != PSTYPE_VOID) {
@@ -3865,14 +3739,14 @@ public:
                 setError("Non-void function must return a value");
                 return;
             }
-            emitLine("ret");
+            ir->emit("ret");
         } else {
             // At top level - return means exit
             if (!check(PSTOK_SEMICOLON)) {
                 PLCScriptVarType retType = parseExpression();
                 if (retType != PSTYPE_VOID) emitDrop(retType);
             }
-            emitLine("exit");
+            ir->emit("exit");
         }
         // Semicolon is optional
         match(PSTOK_SEMICOLON);
@@ -3903,10 +3777,9 @@ public:
         const char* cstrType = (destType == PSTYPE_STR8) ? "cstr" : "cstr16";
         
         // First, clear the destination string
-        emit(strType);
-        emit(".clear ");
-        emit(destAddr);
-        emit("\n");
+        ir->instruction(strType, ".clear");
+        ir->name(destAddr);
+        ir->end();
         
         // Parse through the template string
         int i = 0;
@@ -3921,21 +3794,17 @@ public:
                 if (textLen > 0) {
                     if (isFirstSegment) {
                         // Use cstr.lit for first segment
-                        emit(cstrType);
-                        emit(".lit ");
-                        emit(destAddr);
-                        emit(" ");
+                        ir->instruction(cstrType, ".lit");
+                        ir->name(destAddr);
                         emitStringLiteral(textBuf, textLen);
-                        emit("\n");
+                        ir->end();
                         isFirstSegment = false;
                     } else {
                         // Use cstr.cat for subsequent text segments (efficient concatenation)
-                        emit(cstrType);
-                        emit(".cat ");
-                        emit(destAddr);
-                        emit(" ");
+                        ir->instruction(cstrType, ".cat");
+                        ir->name(destAddr);
                         emitStringLiteral(textBuf, textLen);
-                        emit("\n");
+                        ir->end();
                     }
                     textLen = 0;
                 }
@@ -3999,29 +3868,20 @@ public:
                 if (exprType == PSTYPE_STR8 || exprType == PSTYPE_STR16) {
                     // String expression - should have set lastStringSymbol
                     if (lastStringSymbol) {
-                        emit(strType);
-                        emit(".concat ");
-                        emit(destAddr);
-                        emit(" ");
-                        emit(lastStringSymbol->address);
-                        emit("\n");
+                        ir->instruction(strType, ".concat");
+                        ir->name(destAddr);
+                        ir->name(lastStringSymbol->address);
+                        ir->end();
                     }
                 } else if (exprType != PSTYPE_VOID) {
                     // Numeric expression - convert to string and concat
                     // Stack has the numeric value, use str.from to append
-                    emit(strType);
-                    emit(".from.");
-                    emit(varTypeToPlcasm(exprType));
-                    emit(" ");
-                    emit(destAddr);
-                    emit(" ");
+                    ir->instruction(strType, ".from.");
+                    ir->append(varTypeToPlcasm(exprType));
+                    ir->name(destAddr);
                     // Use default base (10) or decimals (2)
-                    if (isFloatType(exprType)) {
-                        emit("2"); // 2 decimal places for floats
-                    } else {
-                        emit("10"); // base 10 for integers
-                    }
-                    emit("\n");
+                    ir->integer(isFloatType(exprType) ? 2 : 10);
+                    ir->end();
                 }
                 
                 isFirstSegment = false;
@@ -4038,20 +3898,16 @@ public:
         if (textLen > 0) {
             if (isFirstSegment) {
                 // Use cstr.lit for first (and only) segment
-                emit(cstrType);
-                emit(".lit ");
-                emit(destAddr);
-                emit(" ");
+                ir->instruction(cstrType, ".lit");
+                ir->name(destAddr);
                 emitStringLiteral(textBuf, textLen);
-                emit("\n");
+                ir->end();
             } else {
                 // Use cstr.cat for subsequent text segments (efficient concatenation)
-                emit(cstrType);
-                emit(".cat ");
-                emit(destAddr);
-                emit(" ");
+                ir->instruction(cstrType, ".cat");
+                ir->name(destAddr);
                 emitStringLiteral(textBuf, textLen);
-                emit("\n");
+                ir->end();
             }
         }
     }
@@ -4071,12 +3927,10 @@ public:
             if (i + 1 < tmplLen && tmpl[i] == '$' && tmpl[i + 1] == '{') {
                 // Emit accumulated text segment using cstr.cat (efficient concatenation)
                 if (textLen > 0) {
-                    emit(cstrType);
-                    emit(".cat ");
-                    emit(destAddr);
-                    emit(" ");
+                    ir->instruction(cstrType, ".cat");
+                    ir->name(destAddr);
                     emitStringLiteral(textBuf, textLen);
-                    emit("\n");
+                    ir->end();
                     textLen = 0;
                 }
                 
@@ -4134,26 +3988,17 @@ public:
                 // Emit code to concat the expression result to the string
                 if (exprType == PSTYPE_STR8 || exprType == PSTYPE_STR16) {
                     if (lastStringSymbol) {
-                        emit(strType);
-                        emit(".concat ");
-                        emit(destAddr);
-                        emit(" ");
-                        emit(lastStringSymbol->address);
-                        emit("\n");
+                        ir->instruction(strType, ".concat");
+                        ir->name(destAddr);
+                        ir->name(lastStringSymbol->address);
+                        ir->end();
                     }
                 } else if (exprType != PSTYPE_VOID) {
-                    emit(strType);
-                    emit(".from.");
-                    emit(varTypeToPlcasm(exprType));
-                    emit(" ");
-                    emit(destAddr);
-                    emit(" ");
-                    if (isFloatType(exprType)) {
-                        emit("2");
-                    } else {
-                        emit("10");
-                    }
-                    emit("\n");
+                    ir->instruction(strType, ".from.");
+                    ir->append(varTypeToPlcasm(exprType));
+                    ir->name(destAddr);
+                    ir->integer(isFloatType(exprType) ? 2 : 10);
+                    ir->end();
                 }
             } else {
                 // Regular character - accumulate
@@ -4166,12 +4011,10 @@ public:
         
         // Emit remaining text segment using cstr.cat (efficient concatenation)
         if (textLen > 0) {
-            emit(cstrType);
-            emit(".cat ");
-            emit(destAddr);
-            emit(" ");
+            ir->instruction(cstrType, ".cat");
+            ir->name(destAddr);
             emitStringLiteral(textBuf, textLen);
-            emit("\n");
+            ir->end();
         }
     }
     
@@ -4407,11 +4250,10 @@ public:
                     
                     // Type conversion if needed
                     if (rhsType != fieldSym.type && rhsType != PSTYPE_VOID) {
-                        emit("cvt ");
-                        emit(varTypeToPlcasm(rhsType));
-                        emit(" ");
-                        emit(varTypeToPlcasm(fieldSym.type));
-                        emit("\n");
+                        ir->instruction("cvt");
+                        ir->name(varTypeToPlcasm(rhsType));
+                        ir->name(varTypeToPlcasm(fieldSym.type));
+                        ir->end();
                     }
                     
                     emitCopy(fieldSym.type);
@@ -4432,11 +4274,10 @@ public:
                     targetType = savedTarget;
                     
                     if (rhsType != fieldSym.type && rhsType != PSTYPE_VOID) {
-                        emit("cvt ");
-                        emit(varTypeToPlcasm(rhsType));
-                        emit(" ");
-                        emit(varTypeToPlcasm(fieldSym.type));
-                        emit("\n");
+                        ir->instruction("cvt");
+                        ir->name(varTypeToPlcasm(rhsType));
+                        ir->name(varTypeToPlcasm(fieldSym.type));
+                        ir->end();
                     }
                     
                     const char* op = nullptr;
@@ -4550,11 +4391,10 @@ public:
                         PLCScriptVarType rhsType = parseAssignment();
                         targetType = savedTarget;
                         if (rhsType != fieldSym.type && rhsType != PSTYPE_VOID) {
-                            emit("cvt ");
-                            emit(varTypeToPlcasm(rhsType));
-                            emit(" ");
-                            emit(varTypeToPlcasm(fieldSym.type));
-                            emit("\n");
+                            ir->instruction("cvt");
+                            ir->name(varTypeToPlcasm(rhsType));
+                            ir->name(varTypeToPlcasm(fieldSym.type));
+                            ir->end();
                         }
                         emitCopy(fieldSym.type);
                         emitStoreToAddress(&fieldSym);
@@ -4570,11 +4410,10 @@ public:
                         PLCScriptVarType rhsType = parseAssignment();
                         targetType = savedTarget;
                         if (rhsType != fieldSym.type && rhsType != PSTYPE_VOID) {
-                            emit("cvt ");
-                            emit(varTypeToPlcasm(rhsType));
-                            emit(" ");
-                            emit(varTypeToPlcasm(fieldSym.type));
-                            emit("\n");
+                            ir->instruction("cvt");
+                            ir->name(varTypeToPlcasm(rhsType));
+                            ir->name(varTypeToPlcasm(fieldSym.type));
+                            ir->end();
                         }
                         const char* op = nullptr;
                         switch (opType) {
@@ -4640,7 +4479,7 @@ public:
                 
                 // Parse index expression
                 // Save output position in case we need to restore (for array reads, not writes)
-                int savedOutputLen = outputLength;
+                PLCASMIRMark savedOutput = ir->mark();
                 bool isStaticIndex = check(PSTOK_INTEGER);
                 int64_t staticIndex = 0;
                 
@@ -4657,9 +4496,10 @@ public:
                     PLCScriptVarType indexType = parseExpression();
                     
                     if (indexType != PSTYPE_U32 && indexType != PSTYPE_I32) {
-                        emit("cvt ");
-                        emit(varTypeToPlcasm(indexType));
-                        emit(" u32\n");
+                        ir->instruction("cvt");
+                        ir->name(varTypeToPlcasm(indexType));
+                        ir->name("u32");
+                        ir->end();
                     }
                 }
                 
@@ -4691,11 +4531,10 @@ public:
                         targetType = savedTarget;
                         
                         if (rhsType != elemType && rhsType != PSTYPE_VOID) {
-                            emit("cvt ");
-                            emit(varTypeToPlcasm(rhsType));
-                            emit(" ");
-                            emit(varTypeToPlcasm(elemType));
-                            emit("\n");
+                            ir->instruction("cvt");
+                            ir->name(varTypeToPlcasm(rhsType));
+                            ir->name(varTypeToPlcasm(elemType));
+                            ir->end();
                         }
                         
                         emitCopy(elemType);
@@ -4717,50 +4556,32 @@ public:
                         for (int r = ni - 1; r >= 0; r--) addr[idx++] = numBuf[r];
                         addr[idx] = '\0';
                         
-                        emit(varTypeToPlcasm(elemType));
-                        emit(".move_to ");
-                        emit(addr);
-                        emit("\n");
+                        ir->instruction(varTypeToPlcasm(elemType), ".move_to");
+                        ir->name(addr);
+                        ir->end();
                     } else {
                         // Dynamic index: stack has index
                         // Need to: compute address, then parse RHS, then store using pointer
                         
                         // Convert index to ptr for pointer arithmetic
-                        emit("cvt u32 ptr\n");
+                        ir->instruction("cvt");
+                        ir->name("u32");
+                        ir->name("ptr");
+                        ir->end();
                         
                         // Multiply index by element size
                         if (elemSize > 1) {
-                            emit("ptr.const ");
-                            char sizeBuf[16];
-                            int si = 0;
-                            u8 s = elemSize;
-                            if (s == 0) sizeBuf[si++] = '0';
-                            else {
-                                char temp[16];
-                                int ti = 0;
-                                while (s > 0) { temp[ti++] = '0' + (s % 10); s /= 10; }
-                                while (ti > 0) sizeBuf[si++] = temp[--ti];
-                            }
-                            sizeBuf[si] = '\0';
-                            emit(sizeBuf);
-                            emit("\nptr.mul\n");
+                            ir->instruction("ptr.const");
+                            ir->integer(elemSize);
+                            ir->end();
+                            ir->emit("ptr.mul");
                         }
                         
                         // Add base address - now we have pointer on stack
-                        emit("ptr.const ");
-                        char baseBuf[16];
-                        int bi = 0;
-                        u32 base = arrSym->memoryOffset;
-                        if (base == 0) baseBuf[bi++] = '0';
-                        else {
-                            char temp[16];
-                            int ti = 0;
-                            while (base > 0) { temp[ti++] = '0' + (base % 10); base /= 10; }
-                            while (ti > 0) baseBuf[bi++] = temp[--ti];
-                        }
-                        baseBuf[bi] = '\0';
-                        emit(baseBuf);
-                        emit("\nptr.add\n");
+                        ir->instruction("ptr.const");
+                        ir->integer(arrSym->memoryOffset);
+                        ir->end();
+                        ir->emit("ptr.add");
                         
                         // Stack: [address (ptr)]
                         // Parse RHS expression
@@ -4770,17 +4591,16 @@ public:
                         targetType = savedTarget;
                         
                         if (rhsType != elemType && rhsType != PSTYPE_VOID) {
-                            emit("cvt ");
-                            emit(varTypeToPlcasm(rhsType));
-                            emit(" ");
-                            emit(varTypeToPlcasm(elemType));
-                            emit("\n");
+                            ir->instruction("cvt");
+                            ir->name(varTypeToPlcasm(rhsType));
+                            ir->name(varTypeToPlcasm(elemType));
+                            ir->end();
                         }
                         
                         // Stack: [address] [value]
                         // Store using pointer and keep value on stack
-                        emit(varTypeToPlcasm(elemType));
-                        emit(".move_copy\n");
+                        ir->instruction(varTypeToPlcasm(elemType), ".move_copy");
+                        ir->end();
                     }
                     
                     return elemType;
@@ -4793,8 +4613,7 @@ public:
                 currentToken = savedToken;
                 hasPeekToken = savedHasPeek;
                 peekToken = savedPeek;
-                outputLength = savedOutputLen;  // Restore emitted code too
-                output[outputLength] = '\0';
+                ir->rewind(savedOutput);  // Restore emitted code too
                 return parseTernary();
             }
             
@@ -4823,12 +4642,10 @@ public:
                         int litLen = currentToken.textLen;
                         
                         const char* cstrType = (sym->type == PSTYPE_STR8) ? "cstr" : "cstr16";
-                        emit(cstrType);
-                        emit(".lit ");
-                        emit(sym->address);
-                        emit(" ");
+                        ir->instruction(cstrType, ".lit");
+                        ir->name(sym->address);
                         emitStringLiteral(litText, litLen);
-                        emit("\n");
+                        ir->end();
                         
                         nextToken(); // consume string literal
                         return sym->type;
@@ -4856,26 +4673,12 @@ public:
                     // Check if this is a number.toString() or number.toFixed() operation
                     if (hasToStringCall) {
                         // Stack has the number value, emit str.from.<type>
-                        emit(strType);
-                        emit(".from.");
-                        emit(varTypeToPlcasm(toStringNumType));
-                        emit(" ");
-                        emit(sym->address);
-                        emit(" ");
+                        ir->instruction(strType, ".from.");
+                        ir->append(varTypeToPlcasm(toStringNumType));
+                        ir->name(sym->address);
                         // Emit base or decimals
-                        char numBuf[8];
-                        int nbi = 0;
-                        u8 val = isFloatType(toStringNumType) ? toStringDecimals : toStringBase;
-                        if (val == 0) numBuf[nbi++] = '0';
-                        else {
-                            char temp[8];
-                            int ti = 0;
-                            while (val > 0) { temp[ti++] = '0' + (val % 10); val /= 10; }
-                            while (ti > 0) numBuf[nbi++] = temp[--ti];
-                        }
-                        numBuf[nbi] = '\0';
-                        emit(numBuf);
-                        emit("\n");
+                        ir->integer(isFloatType(toStringNumType) ? toStringDecimals : toStringBase);
+                        ir->end();
                         hasToStringCall = false;
                         return sym->type;
                     }
@@ -4888,22 +4691,18 @@ public:
                     // Check if this is a substr operation
                     if (lastSubstrSymbol && hasSubstrArgs) {
                         // str.substr dest src - stack has [start, length]
-                        emit(strType);
-                        emit(".substr ");
-                        emit(sym->address);
-                        emit(" ");
-                        emit(lastSubstrSymbol->address);
-                        emit("\n");
+                        ir->instruction(strType, ".substr");
+                        ir->name(sym->address);
+                        ir->name(lastSubstrSymbol->address);
+                        ir->end();
                         lastSubstrSymbol = nullptr;
                         hasSubstrArgs = false;
                     } else {
                         // Copy from source to destination
-                        emit(strType);
-                        emit(".copy ");
-                        emit(sym->address);
-                        emit(" ");
-                        emit(lastStringSymbol->address);
-                        emit("\n");
+                        ir->instruction(strType, ".copy");
+                        ir->name(sym->address);
+                        ir->name(lastStringSymbol->address);
+                        ir->end();
                     }
                     
                     return sym->type;
@@ -4917,11 +4716,10 @@ public:
                 
                 // Type conversion if needed
                 if (rhsType != sym->type && rhsType != PSTYPE_VOID) {
-                    emit("cvt ");
-                    emit(varTypeToPlcasm(rhsType));
-                    emit(" ");
-                    emit(varTypeToPlcasm(sym->type));
-                    emit("\n");
+                    ir->instruction("cvt");
+                    ir->name(varTypeToPlcasm(rhsType));
+                    ir->name(varTypeToPlcasm(sym->type));
+                    ir->end();
                 }
                 
                 // Duplicate value for the expression result
@@ -4960,24 +4758,12 @@ public:
                         // Append each character using str.char
                         for (int ci = 0; ci < litLen; ci++) {
                             char c = litText[ci];
-                            emit("u8.const ");
-                            char charBuf[8];
-                            int cbi = 0;
-                            u8 cv = (u8)c;
-                            if (cv == 0) charBuf[cbi++] = '0';
-                            else {
-                                char temp[8];
-                                int ti = 0;
-                                while (cv > 0) { temp[ti++] = '0' + (cv % 10); cv /= 10; }
-                                while (ti > 0) charBuf[cbi++] = temp[--ti];
-                            }
-                            charBuf[cbi] = '\0';
-                            emit(charBuf);
-                            emit("\n");
-                            emit(strType);
-                            emit(".char ");
-                            emit(sym->address);
-                            emit("\n");
+                            ir->instruction("u8.const");
+                            ir->integer((u8) c);
+                            ir->end();
+                            ir->instruction(strType, ".char");
+                            ir->name(sym->address);
+                            ir->end();
                         }
                         
                         nextToken(); // consume string literal
@@ -5005,12 +4791,10 @@ public:
                         return PSTYPE_VOID;
                     }
                     
-                    emit(strType);
-                    emit(".concat ");
-                    emit(sym->address);
-                    emit(" ");
-                    emit(lastStringSymbol->address);
-                    emit("\n");
+                    ir->instruction(strType, ".concat");
+                    ir->name(sym->address);
+                    ir->name(lastStringSymbol->address);
+                    ir->end();
                     
                     return sym->type;
                 }
@@ -5027,11 +4811,10 @@ public:
                 
                 // Type conversion if needed
                 if (rhsType != sym->type && rhsType != PSTYPE_VOID) {
-                    emit("cvt ");
-                    emit(varTypeToPlcasm(rhsType));
-                    emit(" ");
-                    emit(varTypeToPlcasm(sym->type));
-                    emit("\n");
+                    ir->instruction("cvt");
+                    ir->name(varTypeToPlcasm(rhsType));
+                    ir->name(varTypeToPlcasm(sym->type));
+                    ir->end();
                 }
                 
                 // Emit operation
@@ -5099,7 +4882,7 @@ public:
             targetType = PSTYPE_BOOL;
             (void)parseLogicalAnd();
             targetType = savedTarget;
-            emitLine("u8.or");
+            ir->emit("u8.or");
             left = PSTYPE_BOOL;
         }
         
@@ -5116,7 +4899,7 @@ public:
             targetType = PSTYPE_BOOL;
             (void)parseBitwiseOr();
             targetType = savedTarget;
-            emitLine("u8.and");
+            ir->emit("u8.and");
             left = PSTYPE_BOOL;
         }
         
@@ -5133,11 +4916,12 @@ public:
             targetType = left;
             (void)parseBitwiseXor();
             targetType = savedTarget;
-            emit("bw.or.");
-            if (left == PSTYPE_U8 || left == PSTYPE_I8 || left == PSTYPE_BOOL) emitLine("x8");
-            else if (left == PSTYPE_U16 || left == PSTYPE_I16) emitLine("x16");
-            else if (left == PSTYPE_U64 || left == PSTYPE_I64) emitLine("x64");
-            else emitLine("x32");
+            ir->instruction("bw.or.");
+            if (left == PSTYPE_U8 || left == PSTYPE_I8 || left == PSTYPE_BOOL) ir->append("x8");
+            else if (left == PSTYPE_U16 || left == PSTYPE_I16) ir->append("x16");
+            else if (left == PSTYPE_U64 || left == PSTYPE_I64) ir->append("x64");
+            else ir->append("x32");
+            ir->end();
         }
         
         return left;
@@ -5153,11 +4937,12 @@ public:
             targetType = left;
             (void)parseBitwiseAnd();
             targetType = savedTarget;
-            emit("bw.xor.");
-            if (left == PSTYPE_U8 || left == PSTYPE_I8 || left == PSTYPE_BOOL) emitLine("x8");
-            else if (left == PSTYPE_U16 || left == PSTYPE_I16) emitLine("x16");
-            else if (left == PSTYPE_U64 || left == PSTYPE_I64) emitLine("x64");
-            else emitLine("x32");
+            ir->instruction("bw.xor.");
+            if (left == PSTYPE_U8 || left == PSTYPE_I8 || left == PSTYPE_BOOL) ir->append("x8");
+            else if (left == PSTYPE_U16 || left == PSTYPE_I16) ir->append("x16");
+            else if (left == PSTYPE_U64 || left == PSTYPE_I64) ir->append("x64");
+            else ir->append("x32");
+            ir->end();
         }
         
         return left;
@@ -5173,11 +4958,12 @@ public:
             targetType = left;
             (void)parseEquality();
             targetType = savedTarget;
-            emit("bw.and.");
-            if (left == PSTYPE_U8 || left == PSTYPE_I8 || left == PSTYPE_BOOL) emitLine("x8");
-            else if (left == PSTYPE_U16 || left == PSTYPE_I16) emitLine("x16");
-            else if (left == PSTYPE_U64 || left == PSTYPE_I64) emitLine("x64");
-            else emitLine("x32");
+            ir->instruction("bw.and.");
+            if (left == PSTYPE_U8 || left == PSTYPE_I8 || left == PSTYPE_BOOL) ir->append("x8");
+            else if (left == PSTYPE_U16 || left == PSTYPE_I16) ir->append("x16");
+            else if (left == PSTYPE_U64 || left == PSTYPE_I64) ir->append("x64");
+            else ir->append("x32");
+            ir->end();
         }
         
         return left;
@@ -5212,16 +4998,14 @@ public:
             }
             
             // Emit str.eq left right -> pushes bool
-            emit(strType);
-            emit(".eq ");
-            emit(leftSym->address);
-            emit(" ");
-            emit(lastStringSymbol->address);
-            emit("\n");
+            ir->instruction(strType, ".eq");
+            ir->name(leftSym->address);
+            ir->name(lastStringSymbol->address);
+            ir->end();
             
             if (!isEq) {
                 // For != , negate the result
-                emit("u8.not\n");
+                ir->emit("u8.not");
             }
             
             return PSTYPE_BOOL;
@@ -5277,18 +5061,17 @@ public:
             targetType = savedTarget;
             // Convert shift amount to u8 if it wasn't already emitted as u8
             if (shiftType != PSTYPE_U8) {
-                emit("cvt ");
-                emit(varTypeToPlcasm(shiftType));
-                emit(" ");
-                emitLine(varTypeToPlcasm(PSTYPE_U8));
+                ir->instruction("cvt");
+                ir->name(varTypeToPlcasm(shiftType));
+                ir->name(varTypeToPlcasm(PSTYPE_U8));
+                ir->end();
             }
-            emit("bw.");
-            emit(isLeft ? "shl" : "shr");
-            emit(".");
-            if (left == PSTYPE_U8 || left == PSTYPE_I8) emitLine("x8");
-            else if (left == PSTYPE_U16 || left == PSTYPE_I16) emitLine("x16");
-            else if (left == PSTYPE_U64 || left == PSTYPE_I64) emitLine("x64");
-            else emitLine("x32");
+            ir->instruction("bw.", isLeft ? "shl." : "shr.");
+            if (left == PSTYPE_U8 || left == PSTYPE_I8) ir->append("x8");
+            else if (left == PSTYPE_U16 || left == PSTYPE_I16) ir->append("x16");
+            else if (left == PSTYPE_U64 || left == PSTYPE_I64) ir->append("x64");
+            else ir->append("x32");
+            ir->end();
         }
         
         return left;
@@ -5319,12 +5102,10 @@ public:
                         setError("String + requires string variables");
                         return left;
                     }
-                    emit(strType);
-                    emit(".concat ");
-                    emit(destSym->address);
-                    emit(" ");
-                    emit(lastStringSymbol->address);
-                    emit("\n");
+                    ir->instruction(strType, ".concat");
+                    ir->name(destSym->address);
+                    ir->name(lastStringSymbol->address);
+                    ir->end();
                 } else {
                     setError("Cannot concatenate non-string with string using +");
                     return left;
@@ -5384,10 +5165,9 @@ public:
             // If string type, convert to number (default f32 like JS)
             if (isStringType(type) && hasPendingStringVar) {
                 const char* strType = (pendingStringVarType == PSTYPE_STR8) ? "str" : "str16";
-                emit(strType);
-                emit(".to.f32 ");
-                emit(pendingStringVarAddr);
-                emit("\n");
+                ir->instruction(strType, ".to.f32");
+                ir->name(pendingStringVarAddr);
+                ir->end();
                 hasPendingStringVar = false;
                 return PSTYPE_F32;
             }
@@ -5397,24 +5177,25 @@ public:
         if (check(PSTOK_BANG)) {
             nextToken();
             (void)parseUnary();
-            emitLine("u8.not");
+            ir->emit("u8.not");
             return PSTYPE_BOOL;
         }
         if (check(PSTOK_TILDE)) {
             nextToken();
             PLCScriptVarType type = parseUnary();
-            emit("bw.not.");
-            if (type == PSTYPE_U8 || type == PSTYPE_I8) emitLine("x8");
-            else if (type == PSTYPE_U16 || type == PSTYPE_I16) emitLine("x16");
-            else if (type == PSTYPE_U64 || type == PSTYPE_I64) emitLine("x64");
-            else emitLine("x32");
+            ir->instruction("bw.not.");
+            if (type == PSTYPE_U8 || type == PSTYPE_I8) ir->append("x8");
+            else if (type == PSTYPE_U16 || type == PSTYPE_I16) ir->append("x16");
+            else if (type == PSTYPE_U64 || type == PSTYPE_I64) ir->append("x64");
+            else ir->append("x32");
+            ir->end();
             return type;
         }
         if (check(PSTOK_MINUS)) {
             nextToken();
             PLCScriptVarType type = parseUnary();
-            emit(varTypeToPlcasm(type));
-            emitLine(".neg");
+            ir->instruction(varTypeToPlcasm(type), ".neg");
+            ir->end();
             return type;
         }
         if (check(PSTOK_PLUS_PLUS) || check(PSTOK_MINUS_MINUS)) {
@@ -5559,15 +5340,12 @@ public:
             }
             
             if (isBit) {
-                emit("u8.readBit ");
-                emit(addr);
-                emit("\n");
+                ir->emit("u8.readBit", addr);
                 return PSTYPE_BOOL;
             } else {
-                emit(varTypeToPlcasm(type));
-                emit(".load_from ");
-                emit(addr);
-                emit("\n");
+                ir->instruction(varTypeToPlcasm(type), ".load_from");
+                ir->name(addr);
+                ir->end();
                 return type;
             }
         }
@@ -5598,12 +5376,11 @@ public:
                 }
                 
                 const char* strType = (pendingStringVarType == PSTYPE_STR8) ? "str" : "str16";
-                emit(strType);
-                emit(".to.");
-                emit(varTypeToPlcasm(castType));
-                emit(" ");
-                emit(pendingStringVarAddr);
-                emit("\n");
+                ir->instruction(strType);
+                ir->append(".to.");
+                ir->append(varTypeToPlcasm(castType));
+                ir->name(pendingStringVarAddr);
+                ir->end();
                 
                 hasPendingStringVar = false;
                 return castType;
@@ -5611,11 +5388,10 @@ public:
             
             // Regular numeric conversion using cvt
             if (exprType != castType && !isStringType(exprType) && !isStringType(castType)) {
-                emit("cvt ");
-                emit(varTypeToPlcasm(exprType));
-                emit(" ");
-                emit(varTypeToPlcasm(castType));
-                emit("\n");
+                ir->instruction("cvt");
+                ir->name(varTypeToPlcasm(exprType));
+                ir->name(varTypeToPlcasm(castType));
+                ir->end();
             }
             
             return castType;
@@ -5663,18 +5439,16 @@ public:
                     
                     // Property: .length
                     if (strEq(propName, "length")) {
-                        emit(strType);
-                        emit(".len ");
-                        emit(strSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".len");
+                        ir->name(strSym->address);
+                        ir->end();
                         return PSTYPE_U16;
                     }
                     // Property: .capacity
                     if (strEq(propName, "capacity")) {
-                        emit(strType);
-                        emit(".cap ");
-                        emit(strSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".cap");
+                        ir->name(strSym->address);
+                        ir->end();
                         return PSTYPE_U16;
                     }
                     
@@ -5688,10 +5462,9 @@ public:
                             setError("Expected ')' after clear(");
                             return PSTYPE_VOID;
                         }
-                        emit(strType);
-                        emit(".clear ");
-                        emit(strSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".clear");
+                        ir->name(strSym->address);
+                        ir->end();
                         return PSTYPE_VOID;
                     }
                     
@@ -5727,12 +5500,10 @@ public:
                         }
                         
                         // Emit str.find haystack needle -> pushes i16 index (-1 if not found)
-                        emit(strType);
-                        emit(".find ");
-                        emit(strSym->address);
-                        emit(" ");
-                        emit(needleSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".find");
+                        ir->name(strSym->address);
+                        ir->name(needleSym->address);
+                        ir->end();
                         return PSTYPE_I16;
                     }
                     
@@ -5768,15 +5539,15 @@ public:
                         }
                         
                         // Emit str.find then compare >= 0 to get bool
-                        emit(strType);
-                        emit(".find ");
-                        emit(strSym->address);
-                        emit(" ");
-                        emit(needleSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".find");
+                        ir->name(strSym->address);
+                        ir->name(needleSym->address);
+                        ir->end();
                         // Convert result: -1 means not found (false), >= 0 means found (true)
-                        emit("i16.const -1\n");
-                        emit("i16.cmp_neq\n");
+                        ir->instruction("i16.const");
+                        ir->integer(-1);
+                        ir->end();
+                        ir->emit("i16.cmp_neq");
                         return PSTYPE_BOOL;
                     }
                     
@@ -5797,9 +5568,10 @@ public:
                         }
                         // Convert from to u16 if needed
                         if (fromType != PSTYPE_U16) {
-                            emit("cvt ");
-                            emit(varTypeToPlcasm(fromType));
-                            emit(" u16\n");
+                            ir->instruction("cvt");
+                            ir->name(varTypeToPlcasm(fromType));
+                            ir->name("u16");
+                            ir->end();
                         }
                         
                         if (!match(PSTOK_COMMA)) {
@@ -5815,9 +5587,10 @@ public:
                         }
                         // Convert to to u16 if needed
                         if (toType != PSTYPE_U16) {
-                            emit("cvt ");
-                            emit(varTypeToPlcasm(toType));
-                            emit(" u16\n");
+                            ir->instruction("cvt");
+                            ir->name(varTypeToPlcasm(toType));
+                            ir->name("u16");
+                            ir->end();
                         }
                         
                         if (!match(PSTOK_RPAREN)) {
@@ -5836,11 +5609,11 @@ public:
                         // So stack order should be: start, len (len on top)
                         // We have: from, to (to on top)
                         // Need: from, (to - from)
-                        emit("u16.swap\n");    // to, from
-                        emit("u16.copy\n");    // to, from, from
-                        emit("u16.rot_up\n");  // from, from, to
-                        emit("u16.swap\n");    // from, to, from
-                        emit("u16.sub\n");     // from, (to - from) = from, length
+                        ir->emit("u16.swap"); // to, from
+                        ir->emit("u16.copy"); // to, from, from
+                        ir->emit("u16.rot_up"); // from, from, to
+                        ir->emit("u16.swap"); // from, to, from
+                        ir->emit("u16.sub"); // from, (to - from) = from, length
                         
                         // Now stack has: from (start), length with length on top - correct for STR_SUBSTR
                         
@@ -5866,15 +5639,15 @@ public:
                         }
                         // Convert index to u16 if needed
                         if (indexType != PSTYPE_U16) {
-                            emit("cvt ");
-                            emit(varTypeToPlcasm(indexType));
-                            emit(" u16\n");
+                            ir->instruction("cvt");
+                            ir->name(varTypeToPlcasm(indexType));
+                            ir->name("u16");
+                            ir->end();
                         }
                         // Emit str.get - pops u16 index, pushes u8 char
-                        emit(strType);
-                        emit(".get ");
-                        emit(strSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".get");
+                        ir->name(strSym->address);
+                        ir->end();
                         return PSTYPE_U8;
                     }
                     
@@ -5910,12 +5683,10 @@ public:
                         }
                         
                         // Emit str.concat dest src
-                        emit(strType);
-                        emit(".concat ");
-                        emit(strSym->address);
-                        emit(" ");
-                        emit(srcSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".concat");
+                        ir->name(strSym->address);
+                        ir->name(srcSym->address);
+                        ir->end();
                         return PSTYPE_VOID;
                     }
                     
@@ -5951,14 +5722,14 @@ public:
                         }
                         
                         // startsWith: indexOf(prefix) == 0
-                        emit(strType);
-                        emit(".find ");
-                        emit(strSym->address);
-                        emit(" ");
-                        emit(prefixSym->address);
-                        emit("\n");
-                        emit("i16.const 0\n");
-                        emit("i16.cmp_eq\n");
+                        ir->instruction(strType, ".find");
+                        ir->name(strSym->address);
+                        ir->name(prefixSym->address);
+                        ir->end();
+                        ir->instruction("i16.const");
+                        ir->integer(0);
+                        ir->end();
+                        ir->emit("i16.cmp_eq");
                         return PSTYPE_BOOL;
                     }
                     
@@ -5995,29 +5766,28 @@ public:
                         
                         // endsWith: indexOf(suffix) == (strLen - suffixLen)
                         // First get indexOf result
-                        emit(strType);
-                        emit(".find ");
-                        emit(strSym->address);
-                        emit(" ");
-                        emit(suffixSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".find");
+                        ir->name(strSym->address);
+                        ir->name(suffixSym->address);
+                        ir->end();
                         // Get string length
-                        emit(strType);
-                        emit(".len ");
-                        emit(strSym->address);
-                        emit("\n");
+                        ir->instruction(strType, ".len");
+                        ir->name(strSym->address);
+                        ir->end();
                         // Get suffix length
                         const char* suffixType = (suffixSym->type == PSTYPE_STR8) ? "str" : "str16";
-                        emit(suffixType);
-                        emit(".len ");
-                        emit(suffixSym->address);
-                        emit("\n");
+                        ir->instruction(suffixType, ".len");
+                        ir->name(suffixSym->address);
+                        ir->end();
                         // Calculate expected position: strLen - suffixLen
-                        emit("u16.sub\n");
+                        ir->emit("u16.sub");
                         // Convert to i16 for comparison
-                        emit("cvt u16 i16\n");
+                        ir->instruction("cvt");
+                        ir->name("u16");
+                        ir->name("i16");
+                        ir->end();
                         // Compare: indexOf == expected position
-                        emit("i16.cmp_eq\n");
+                        ir->emit("i16.cmp_eq");
                         return PSTYPE_BOOL;
                     }
                     
@@ -6043,7 +5813,7 @@ public:
                             // For simplicity, we only support literal bases
                             // Pop the base value from the expression - since it's already emitted
                             // We need to drop it and use the literal value
-                            emit("u8.drop\n");  // Drop the base value
+                            ir->emit("u8.drop"); // Drop the base value
                             // Use a fixed default for now - TODO: runtime base would need more work
                             base = 10;
                         }
@@ -6088,7 +5858,7 @@ public:
                                 nextToken();
                             } else {
                                 (void)parseExpression();  // Parse and discard decimals expression
-                                emit("u8.drop\n");  // Drop - use default
+                                ir->emit("u8.drop"); // Drop - use default
                                 decimals = 2;
                             }
                         }
@@ -6174,15 +5944,12 @@ public:
                     
                     // Emit load instruction based on field type
                     if (field->isBit || field->type == PSTYPE_BOOL) {
-                        emit("u8.readBit ");
-                        emit(fieldAddr);
-                        emit("\n");
+                        ir->emit("u8.readBit", fieldAddr);
                         return PSTYPE_BOOL;
                     } else {
-                        emit(varTypeToPlcasm(field->type));
-                        emit(".load_from ");
-                        emit(fieldAddr);
-                        emit("\n");
+                        ir->instruction(varTypeToPlcasm(field->type), ".load_from");
+                        ir->name(fieldAddr);
+                        ir->end();
                         return field->type;
                     }
                 }
@@ -6256,9 +6023,7 @@ public:
                         
                         // Emit load instruction based on field type
                         if (isBitField || userField->type_size == 0) {
-                            emit("u8.readBit ");
-                            emit(fieldAddr);
-                            emit("\n");
+                            ir->emit("u8.readBit", fieldAddr);
                             return PSTYPE_BOOL;
                         } else {
                             // type_size: 1=byte, 2=word, 4=dword, 8=qword
@@ -6270,10 +6035,9 @@ public:
                                 case 4: typeStr = "u32"; retType = PSTYPE_U32; break;
                                 case 8: typeStr = "u64"; retType = PSTYPE_U64; break;
                             }
-                            emit(typeStr);
-                            emit(".load_from ");
-                            emit(fieldAddr);
-                            emit("\n");
+                            ir->instruction(typeStr, ".load_from");
+                            ir->name(fieldAddr);
+                            ir->end();
                             return retType;
                         }
                     }
@@ -6308,22 +6072,20 @@ public:
                             // Determine type based on property
                             if (timerProperties[p].bit_pos != 0xFF) {
                                 // Bit property (Q, IN, RUN)
-                                emit("u8.readBit ");
-                                emit(fullAddr);
-                                emit("\n");
+                                ir->emit("u8.readBit", fullAddr);
                                 resultType = PSTYPE_BOOL;
                             } else {
                                 // Value property (ET)
                                 u8 ts = timerProperties[p].type_size;
                                 if (ts == 4) {
-                                    emit("u32.load_from ");
+                                    ir->instruction("u32.load_from");
                                     resultType = PSTYPE_U32;
                                 } else {
-                                    emit("u8.load_from ");
+                                    ir->instruction("u8.load_from");
                                     resultType = PSTYPE_U8;
                                 }
-                                emit(fullAddr);
-                                emit("\n");
+                                ir->name(fullAddr);
+                                ir->end();
                             }
                             break;
                         }
@@ -6343,22 +6105,20 @@ public:
                             // Determine type based on property
                             if (counterProperties[p].bit_pos != 0xFF) {
                                 // Bit property (Q, IN)
-                                emit("u8.readBit ");
-                                emit(fullAddr);
-                                emit("\n");
+                                ir->emit("u8.readBit", fullAddr);
                                 resultType = PSTYPE_BOOL;
                             } else {
                                 // Value property (CV)
                                 u8 ts = counterProperties[p].type_size;
                                 if (ts == 4) {
-                                    emit("u32.load_from ");
+                                    ir->instruction("u32.load_from");
                                     resultType = PSTYPE_U32;
                                 } else {
-                                    emit("u8.load_from ");
+                                    ir->instruction("u8.load_from");
                                     resultType = PSTYPE_U8;
                                 }
-                                emit(fullAddr);
-                                emit("\n");
+                                ir->name(fullAddr);
+                                ir->end();
                             }
                             break;
                         }
@@ -6394,21 +6154,19 @@ public:
 
                                 // Emit load based on field type
                                 if (field->bit_pos < 8 || field->type_size == 0) {
-                                    emit("u8.readBit ");
-                                    emit(fullAddr);
-                                    emit("\n");
+                                    ir->emit("u8.readBit", fullAddr);
                                     resultType = PSTYPE_BOOL;
                                 } else {
                                     switch (field->type_size) {
-                                        case 1: emit("u8"); resultType = PSTYPE_U8; break;
-                                        case 2: emit("u16"); resultType = PSTYPE_U16; break;
-                                        case 4: emit("u32"); resultType = PSTYPE_U32; break;
-                                        case 8: emit("u64"); resultType = PSTYPE_U64; break;
-                                        default: emit("u16"); resultType = PSTYPE_U16; break;
+                                        case 1: ir->instruction("u8"); resultType = PSTYPE_U8; break;
+                                        case 2: ir->instruction("u16"); resultType = PSTYPE_U16; break;
+                                        case 4: ir->instruction("u32"); resultType = PSTYPE_U32; break;
+                                        case 8: ir->instruction("u64"); resultType = PSTYPE_U64; break;
+                                        default: ir->instruction("u16"); resultType = PSTYPE_U16; break;
                                     }
-                                    emit(".load_from ");
-                                    emit(fullAddr);
-                                    emit("\n");
+                                    ir->append(".load_from");
+                                    ir->name(fullAddr);
+                                    ir->end();
                                 }
                             }
                         }
@@ -6470,9 +6228,10 @@ public:
                     
                     // Convert to u32 for address calculation if needed
                     if (indexType != PSTYPE_U32 && indexType != PSTYPE_I32) {
-                        emit("cvt ");
-                        emit(varTypeToPlcasm(indexType));
-                        emit(" u32\n");
+                        ir->instruction("cvt");
+                        ir->name(varTypeToPlcasm(indexType));
+                        ir->name("u32");
+                        ir->end();
                     }
                 }
                 
@@ -6506,55 +6265,37 @@ public:
                     addr[idx] = '\0';
                     
                     // Emit load instruction
-                    emit(varTypeToPlcasm(elemType));
-                    emit(".load_from ");
-                    emit(addr);
-                    emit("\n");
+                    ir->instruction(varTypeToPlcasm(elemType), ".load_from");
+                    ir->name(addr);
+                    ir->end();
                 } else {
                     // Dynamic index: emit instructions to compute address at runtime
                     // Stack now has: index (u32)
                     // Need to: base_address + (index * elem_size)
                     
                     // Convert index to ptr for pointer arithmetic
-                    emit("cvt u32 ptr\n");
+                    ir->instruction("cvt");
+                    ir->name("u32");
+                    ir->name("ptr");
+                    ir->end();
                     
                     // Multiply index by element size
                     if (elemSize > 1) {
-                        emit("ptr.const ");
-                        char sizeBuf[16];
-                        int si = 0;
-                        u8 s = elemSize;
-                        if (s == 0) sizeBuf[si++] = '0';
-                        else {
-                            char temp[16];
-                            int ti = 0;
-                            while (s > 0) { temp[ti++] = '0' + (s % 10); s /= 10; }
-                            while (ti > 0) sizeBuf[si++] = temp[--ti];
-                        }
-                        sizeBuf[si] = '\0';
-                        emit(sizeBuf);
-                        emit("\nptr.mul\n");
+                        ir->instruction("ptr.const");
+                        ir->integer(elemSize);
+                        ir->end();
+                        ir->emit("ptr.mul");
                     }
                     
                     // Add base address
-                    emit("ptr.const ");
-                    char baseBuf[16];
-                    int bi = 0;
-                    u32 base = arrSym->memoryOffset;
-                    if (base == 0) baseBuf[bi++] = '0';
-                    else {
-                        char temp[16];
-                        int ti = 0;
-                        while (base > 0) { temp[ti++] = '0' + (base % 10); base /= 10; }
-                        while (ti > 0) baseBuf[bi++] = temp[--ti];
-                    }
-                    baseBuf[bi] = '\0';
-                    emit(baseBuf);
-                    emit("\nptr.add\n");
+                    ir->instruction("ptr.const");
+                    ir->integer(arrSym->memoryOffset);
+                    ir->end();
+                    ir->emit("ptr.add");
                     
                     // Use dynamic load instruction with ptr address on stack
-                    emit(varTypeToPlcasm(elemType));
-                    emit(".load\n");
+                    ir->instruction(varTypeToPlcasm(elemType), ".load");
+                    ir->end();
                 }
                 
                 return elemType;
@@ -6642,11 +6383,11 @@ public:
             expect(PSTOK_RPAREN, "Expected ')'");
             
             // Emit timer instruction
-            if (strEqCI(name, "TON")) emit("ton.const ");
-            else if (strEqCI(name, "TOF")) emit("tof.const ");
-            else emit("tp.const ");
-            emit(timerAddr);
-            emit("\n");
+            if (strEqCI(name, "TON")) ir->instruction("ton.const");
+            else if (strEqCI(name, "TOF")) ir->instruction("tof.const");
+            else ir->instruction("tp.const");
+            ir->name(timerAddr);
+            ir->end();
             
             return PSTYPE_BOOL;
         }
@@ -6674,10 +6415,10 @@ public:
             parseExpression(); // preset value
             expect(PSTOK_RPAREN, "Expected ')'");
             
-            if (strEqCI(name, "CTU")) emit("ctu.const ");
-            else emit("ctd.const ");
-            emit(counterAddr);
-            emit("\n");
+            if (strEqCI(name, "CTU")) ir->instruction("ctu.const");
+            else ir->instruction("ctd.const");
+            ir->name(counterAddr);
+            ir->end();
             
             return PSTYPE_BOOL;
         }
@@ -6702,9 +6443,7 @@ public:
             
             expect(PSTOK_RPAREN, "Expected ')'");
             
-            emit("stack.du ");
-            emit(memAddr);
-            emit("\n");
+            ir->emit("stack.du", memAddr);
             
             return PSTYPE_BOOL;
         }
@@ -6728,9 +6467,7 @@ public:
             
             expect(PSTOK_RPAREN, "Expected ')'");
             
-            emit("stack.dd ");
-            emit(memAddr);
-            emit("\n");
+            ir->emit("stack.dd", memAddr);
             
             return PSTYPE_BOOL;
         }
@@ -6746,10 +6483,10 @@ public:
             expect(PSTOK_COMMA, "Expected ','");
             if (!parseCommsIntArg(config)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("comms_begin");
+            ir->instruction("comms_begin");
             emitCommsInt(inst);
             emitCommsInt(config);
-            emit("\n");
+            ir->end();
             return PSTYPE_BOOL;
         }
 
@@ -6758,9 +6495,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("comms_end");
+            ir->instruction("comms_end");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_VOID;
         }
 
@@ -6769,9 +6506,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("comms_enabled");
+            ir->instruction("comms_enabled");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_BOOL;
         }
 
@@ -6780,9 +6517,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("comms_status");
+            ir->instruction("comms_status");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_U8;
         }
 
@@ -6801,12 +6538,12 @@ public:
             expect(PSTOK_COMMA, "Expected ','");
             if (!parseCommsIntArg(port)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("tcp_connect");
+            ir->instruction("tcp_connect");
             emitCommsInt(inst);
             emitCommsInt(ip0); emitCommsInt(ip1);
             emitCommsInt(ip2); emitCommsInt(ip3);
             emitCommsInt(port);
-            emit("\n");
+            ir->end();
             return PSTYPE_BOOL;
         }
 
@@ -6815,9 +6552,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("tcp_disconnect");
+            ir->instruction("tcp_disconnect");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_VOID;
         }
 
@@ -6826,9 +6563,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("tcp_connected");
+            ir->instruction("tcp_connected");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_BOOL;
         }
 
@@ -6839,10 +6576,10 @@ public:
             expect(PSTOK_COMMA, "Expected ','");
             if (!parseCommsIntArg(port)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("tcp_listen");
+            ir->instruction("tcp_listen");
             emitCommsInt(inst);
             emitCommsInt(port);
-            emit("\n");
+            ir->end();
             return PSTYPE_BOOL;
         }
 
@@ -6851,9 +6588,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("tcp_accept");
+            ir->instruction("tcp_accept");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_BOOL;
         }
 
@@ -6866,11 +6603,11 @@ public:
             expect(PSTOK_COMMA, "Expected ','");
             if (!parseCommsIntArg(len)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("tcp_send");
+            ir->instruction("tcp_send");
             emitCommsInt(inst);
             emitCommsInt(src);
             emitCommsInt(len);
-            emit("\n");
+            ir->end();
             return PSTYPE_U16;
         }
 
@@ -6883,11 +6620,11 @@ public:
             expect(PSTOK_COMMA, "Expected ','");
             if (!parseCommsIntArg(max)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("tcp_recv");
+            ir->instruction("tcp_recv");
             emitCommsInt(inst);
             emitCommsInt(dest);
             emitCommsInt(max);
-            emit("\n");
+            ir->end();
             return PSTYPE_U16;
         }
 
@@ -6896,9 +6633,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("tcp_available");
+            ir->instruction("tcp_available");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_U16;
         }
 
@@ -6909,10 +6646,10 @@ public:
             expect(PSTOK_COMMA, "Expected ','");
             if (!parseCommsIntArg(port)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("udp_open");
+            ir->instruction("udp_open");
             emitCommsInt(inst);
             emitCommsInt(port);
-            emit("\n");
+            ir->end();
             return PSTYPE_BOOL;
         }
 
@@ -6921,9 +6658,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("udp_close");
+            ir->instruction("udp_close");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_VOID;
         }
 
@@ -6946,14 +6683,14 @@ public:
             expect(PSTOK_COMMA, "Expected ','");
             if (!parseCommsIntArg(len)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("udp_send");
+            ir->instruction("udp_send");
             emitCommsInt(inst);
             emitCommsInt(ip0); emitCommsInt(ip1);
             emitCommsInt(ip2); emitCommsInt(ip3);
             emitCommsInt(port);
             emitCommsInt(src);
             emitCommsInt(len);
-            emit("\n");
+            ir->end();
             return PSTYPE_U16;
         }
 
@@ -6966,11 +6703,11 @@ public:
             expect(PSTOK_COMMA, "Expected ','");
             if (!parseCommsIntArg(max)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("udp_recv");
+            ir->instruction("udp_recv");
             emitCommsInt(inst);
             emitCommsInt(dest);
             emitCommsInt(max);
-            emit("\n");
+            ir->end();
             return PSTYPE_U16;
         }
 
@@ -6979,9 +6716,9 @@ public:
             int64_t inst = 0;
             if (!parseCommsIntArg(inst)) return PSTYPE_VOID;
             expect(PSTOK_RPAREN, "Expected ')'");
-            emit("udp_available");
+            ir->instruction("udp_available");
             emitCommsInt(inst);
-            emit("\n");
+            ir->end();
             return PSTYPE_U16;
         }
 
@@ -7017,10 +6754,10 @@ public:
             // Convert argument type if necessary
             PLCScriptVarType expectedType = func->params[argCount].type;
             if (argType != expectedType) {
-                emit("cvt ");
-                emit(varTypeToPlcasm(argType));
-                emit(" ");
-                emitLine(varTypeToPlcasm(expectedType));
+                ir->instruction("cvt");
+                ir->name(varTypeToPlcasm(argType));
+                ir->name(varTypeToPlcasm(expectedType));
+                ir->end();
             }
             
             argCount++;
@@ -7044,9 +6781,9 @@ public:
         }
         
         // Call the function
-        emit("call ");
-        emit(func->entryLabel);
-        emit("\n");
+        ir->instruction("call");
+        ir->target(func->entryLabel);
+        ir->end();
         
         return func->returnType;
     }
@@ -123,6 +123,7 @@
 #define PROJECT_MAX_OUTPUT_SIZE 65536
 #define PROJECT_MAX_SOURCE_SIZE 65536
 #define PROJECT_MAX_ERROR_LEN 512
+#define PROJECT_BLOCK_CACHE_SIZE 65536   // PLCASM text held by the block cache before it starts over
 // Project-level DataBlock declarations now use the global DB registry
 // (GlobalDBDecl, GlobalDBField) from shared-symbols.h
 
@@ -172,6 +173,29 @@ struct ProgramBlock {
     }
 };
 
+// Generated PLCASM of a program block, kept across compilations
+struct BlockCacheEntry {
+    char file_path[PROJECT_MAX_PATH_LEN];
+    char name[PROJECT_MAX_NAME_LEN];
+    u32 source_hash;        // Block source and language
+    u32 deps_hash;          // Declarations of the symbols, datablocks and types the block refers to
+    int edge_mem_in;        // Ladder edge memory counter before and after the block
+    int edge_mem_out;
+    int record_start;       // PLCASM records in block_cache_ir
+    int record_end;
+
+    void reset() {
+        file_path[0] = '\0';
+        name[0] = '\0';
+        source_hash = 0;
+        deps_hash = 0;
+        edge_mem_in = 0;
+        edge_mem_out = 0;
+        record_start = 0;
+        record_end = 0;
+    }
+};
+
 // Program file definition (contains blocks)
 struct ProgramFile {
     char path[PROJECT_MAX_PATH_LEN];          // Program name (e.g., "main", "motor_control")
@@ -294,6 +318,12 @@ public:
     int combined_plcasm_length;
     int combined_plcasm_line;  // Current line number in combined output (1-based)
 
+    // PLCASM of the STL, Ladder, PLCScript and ST blocks as instruction records (plcasm-ir.h). Each block is a
+    // segment the assembler splices into combined_plcasm, the text listing is rendered on demand (combinedListing()).
+    PLCASMInstructionIR plcasm_ir;
+    char* combined_listing;         // Rendered listing in the plcasm_ir arena, nullptr until asked for
+    int combined_listing_length;
+
     // Output bytecode
     u8 output[PROJECT_MAX_OUTPUT_SIZE];
     int output_length;
@@ -327,6 +357,18 @@ public:
     // Project-level edge memory counter for differentiation bits (shared across all blocks)
     int project_edge_mem_counter;
 
+    // Incremental compilation: STL, Ladder, PLCScript and ST blocks reuse the PLCASM generated by an
+    // earlier compile() when their source and the declarations they refer to are unchanged.
+    // The cache survives reset(); clearBlockCache() drops it.
+    BlockCacheEntry block_cache[PROJECT_MAX_PROGRAM_BLOCKS];
+    int block_cache_count;
+    PLCASMInstructionIR block_cache_ir;
+    bool incremental;               // Use the block cache (on by default)
+    int block_cache_hits;           // Blocks reused by the last compile
+    int block_cache_misses;         // Blocks converted by the last compile
+    NameHashIndex<512> project_symbol_index; // Case-insensitive symbol name lookup for dependency hashing
+    u32 project_symbol_generation = 0;       // Bumped by reset(), symbols[] is otherwise only appended to
+
     // Timer/Counter auto-allocation tracking
     // Tracks which T/C indices are explicitly used vs need auto-assignment
     static const int MAX_TIMERS = 256;
@@ -357,13 +399,16 @@ public:
     // Byte-level defaults: value, has_explicit flag, source symbol for errors
     u8 mem_default_values[MEM_DEFAULT_MAP_SIZE];   // Default byte values
     u8 mem_default_flags[MEM_DEFAULT_MAP_SIZE];    // 0=no default, 1=has default
-    char mem_default_source[MEM_DEFAULT_MAP_SIZE][32]; // Source symbol name for conflict reporting
+    const char** mem_default_source = nullptr;     // Source symbol name for conflict reporting (arena, mem_default_size entries)
     
     // Bit-level defaults: track which bits to SET (after zeroing all memory)
     // bit_set_mask[addr] -> bits that should be 1
     // bit_sources[addr][bit] -> source symbol for that bit
     u8 bit_set_mask[MEM_DEFAULT_MAP_SIZE];
-    char bit_sources[MEM_DEFAULT_MAP_SIZE][8][32]; // [addr][bit][symbol_name]
+    const char* (*bit_sources)[8] = nullptr;       // [addr][bit] -> symbol_name (arena, mem_default_size entries)
+    u32 mem_default_size = 0;                      // Addresses covered by the source tables
+
+    CompilerArena arena; // Per-compile working memory, rewound by reset()
     
     u32 mem_default_base;  // Base address (Y area start)
     u32 mem_default_end;   // End address (M area end)
@@ -384,6 +429,8 @@ public:
     ProjectCompiler() {
         target_flags = 0xFFFF;  // Default: all features enabled
         target_flags_from_api = false;
+        incremental = true;
+        clearBlockCache();
         reset();
     }
 
@@ -468,6 +515,9 @@ public:
         combined_plcasm[0] = '\0';
         combined_plcasm_length = 0;
         combined_plcasm_line = 1;
+        plcasm_ir.reset();
+        combined_listing = nullptr;
+        combined_listing_length = 0;
 
         memset(output, 0, sizeof(output));
         output_length = 0;
@@ -498,6 +548,10 @@ public:
         // Reset project-level edge memory counter (starts at bit 800 = M100.0)
         project_edge_mem_counter = 800;
 
+        block_cache_hits = 0;
+        block_cache_misses = 0;
+        project_symbol_generation++;
+
         // Reset timer/counter tracking
         for (int i = 0; i < MAX_TIMERS; i++) timer_used[i] = false;
         for (int i = 0; i < MAX_COUNTERS; i++) counter_used[i] = false;
@@ -519,10 +573,12 @@ public:
         for (int i = 0; i < MEM_DEFAULT_MAP_SIZE; i++) {
             mem_default_values[i] = 0;
             mem_default_flags[i] = 0;
-            mem_default_source[i][0] = '\0';
             bit_set_mask[i] = 0;
-            for (int b = 0; b < 8; b++) bit_sources[i][b][0] = '\0';
         }
+        arena.reset();
+        mem_default_source = nullptr;
+        bit_sources = nullptr;
+        mem_default_size = 0;
         mem_default_base = 0;
         mem_default_end = 0;
 
@@ -532,6 +588,7 @@ public:
         // Reset child compilers' symbol tables
         plcasm_compiler.symbol_count = 0;
         plcasm_compiler.base_symbol_count = 0;
+        plcasm_compiler.namesChanged();
 
         // Reset shared symbol table and user struct types for fresh compile/lint
         resetSharedSymbols();
@@ -2840,6 +2897,11 @@ public:
     void copySymbolsToPLCASM() {
         plcasm_compiler.symbol_count = 0;
         plcasm_compiler.base_symbol_count = 0;
+        plcasm_compiler.namesChanged();
+        if (!plcasm_compiler.reserveSymbols(symbol_count)) {
+            setError("Out of memory for the PLCASM symbol table");
+            return;
+        }
 
         for (int i = 0; i < symbol_count; i++) {
             ProjectSymbol& psym = symbols[i];
@@ -2944,6 +3006,7 @@ public:
         }
 
         stSymbols.symbol_count = symbol_count < SHARED_MAX_SYMBOLS ? symbol_count : SHARED_MAX_SYMBOLS;
+        stSymbols.changed();
     }
 
     // Track a timer index as used
@@ -3322,7 +3385,7 @@ public:
     bool setByteDefault(u32 addr, u8 value, const char* source_symbol) {
         if (addr < mem_default_base || addr > mem_default_end) return true; // Out of range, ignore
         u32 idx = addr - mem_default_base;
-        if (idx >= MEM_DEFAULT_MAP_SIZE) return true; // Safety check
+        if (idx >= mem_default_size) return true; // Safety check
         
         if (mem_default_flags[idx]) {
             // Already has a default - check for conflict
@@ -3341,7 +3404,8 @@ public:
                 while (ai > 0) err[pos++] = addr_buf[--ai];
                 const char* msg2 = ": '";
                 for (int i = 0; msg2[i]; i++) err[pos++] = msg2[i];
-                for (int i = 0; mem_default_source[idx][i] && i < 30; i++) err[pos++] = mem_default_source[idx][i];
+                const char* existing = mem_default_source[idx] ? mem_default_source[idx] : "";
+                for (int i = 0; existing[i] && i < 30; i++) err[pos++] = existing[i];
                 const char* msg3 = "' vs '";
                 for (int i = 0; msg3[i]; i++) err[pos++] = msg3[i];
                 for (int i = 0; source_symbol[i] && i < 30; i++) err[pos++] = source_symbol[i];
@@ -3356,9 +3420,7 @@ public:
         
         mem_default_values[idx] = value;
         mem_default_flags[idx] = MEM_HAS_DEFAULT;
-        int si = 0;
-        while (source_symbol[si] && si < 31) { mem_default_source[idx][si] = source_symbol[si]; si++; }
-        mem_default_source[idx][si] = '\0';
+        mem_default_source[idx] = source_symbol;
         return true;
     }
     
@@ -3374,7 +3436,7 @@ public:
     bool setBitDefault(u32 byte_addr, u8 bit, bool value, const char* source_symbol) {
         if (byte_addr < mem_default_base || byte_addr > mem_default_end) return true;
         u32 idx = byte_addr - mem_default_base;
-        if (idx >= MEM_DEFAULT_MAP_SIZE || bit > 7) return true;
+        if (idx >= mem_default_size || bit > 7) return true;
         
         u8 mask = (1 << bit);
         bool already_set = (bit_set_mask[idx] & mask) != 0;
@@ -3397,7 +3459,8 @@ public:
                 err[pos++] = '0' + bit;
                 const char* msg2 = ": '";
                 for (int i = 0; msg2[i]; i++) err[pos++] = msg2[i];
-                for (int i = 0; bit_sources[idx][bit][i] && i < 30; i++) err[pos++] = bit_sources[idx][bit][i];
+                const char* existing = bit_sources[idx][bit] ? bit_sources[idx][bit] : "";
+                for (int i = 0; existing[i] && i < 30; i++) err[pos++] = existing[i];
                 const char* msg3 = "' vs '";
                 for (int i = 0; msg3[i]; i++) err[pos++] = msg3[i];
                 for (int i = 0; source_symbol[i] && i < 30; i++) err[pos++] = source_symbol[i];
@@ -3416,9 +3479,7 @@ public:
         // Note: if value is false, we don't need to do anything since memory starts zeroed
         
         // Record source
-        int si = 0;
-        while (source_symbol[si] && si < 31) { bit_sources[idx][bit][si] = source_symbol[si]; si++; }
-        bit_sources[idx][bit][si] = '\0';
+        bit_sources[idx][bit] = source_symbol;
         return true;
     }
     
@@ -3561,10 +3622,18 @@ public:
 
         // Generate DataBlock configuration directive (inside first-cycle block)
         // Format: .runtime_config_db <count> <db1_number> <db1_size> [<db2_number> <db2_size> ...]
-        if (db_count > 0) {
+        // DATABLOCKS section DBs go first: their computed_offset is where the runtime puts them
+        // when declared in this order on an empty table, and an online change lays them out the same way
+        if (db_count > 0 || globalDBDeclCount > 0) {
             appendToCombinedPLCASM("// DataBlock runtime configuration\n");
             appendToCombinedPLCASM(".runtime_config_db ");
-            appendCombinedPLCASMInt(db_count);
+            appendCombinedPLCASMInt(globalDBDeclCount + db_count);
+            for (int d = 0; d < globalDBDeclCount; d++) {
+                appendToCombinedPLCASM(" ");
+                appendCombinedPLCASMInt(globalDBDecls[d].db_number);
+                appendToCombinedPLCASM(" ");
+                appendCombinedPLCASMInt(globalDBDecls[d].total_size);
+            }
             for (int i = 0; i < db_count; i++) {
                 appendToCombinedPLCASM(" ");
                 appendCombinedPLCASMInt(db_entries[i].db_number);
@@ -3574,10 +3643,10 @@ public:
             appendToCombinedPLCASM("\n\n");
         }
 
-        // Generate project-level DataBlock declarations as .db<N> PLCASM directives
-        // Note: DataBlocks are already registered in globalDBDecls from DATABLOCKS parsing.
-        // The PLCASM compiler can access them via DB<N>.field syntax without needing .db directives.
-        // We just emit a comment showing the DB definitions for debugging purposes.
+        // Project-level DataBlock declarations
+        // Note: DataBlocks are already registered in globalDBDecls from DATABLOCKS parsing and declared
+        // by the CONFIG_DB above. The PLCASM compiler can access them via DB<N>.field syntax without
+        // needing .db directives. We just emit a comment showing the DB definitions for debugging purposes.
         if (globalDBDeclCount > 0) {
             appendToCombinedPLCASM("// Project-level DataBlock declarations (already registered)\n");
             for (int d = 0; d < globalDBDeclCount; d++) {
@@ -3664,10 +3733,17 @@ public:
             for (u32 i = 0; i < mem_size; i++) {
                 mem_default_values[i] = 0;
                 mem_default_flags[i] = 0;
-                mem_default_source[i][0] = '\0';
                 bit_set_mask[i] = 0;
-                for (int b = 0; b < 8; b++) bit_sources[i][b][0] = '\0';
             }
+
+            // Source names point at the symbol table, which outlives this pass
+            mem_default_source = (const char**) arena.alloc(mem_size * sizeof(const char*));
+            bit_sources = (const char* (*)[8]) arena.alloc(mem_size * sizeof(*bit_sources));
+            if (mem_default_source == nullptr || bit_sources == nullptr) {
+                setError("Out of memory for memory default tracking");
+                return;
+            }
+            mem_default_size = mem_size;
             
             // Phase 2: Collect defaults from all symbols (check for conflicts)
             for (int i = 0; i < symbol_count; i++) {
@@ -4113,21 +4189,22 @@ public:
         const char* token_text = nullptr, int token_len = 0) {
         int relative_line = 0;
         int block_idx = findBlockForCombinedLine(combined_line, relative_line);
+        const char* listing = combinedListing(); // Sets combined_listing_length
 
         if (block_idx >= 0) {
             ProgramBlock& block = program_blocks[block_idx];
             copyString(current_file, block.file_path, PROJECT_MAX_PATH_LEN);
             copyString(current_block, block.name, PROJECT_MAX_NAME_LEN);
             current_block_language = block.language;
-            // Use setErrorFull with combined_plcasm as source to extract the line
+            // Use setErrorFull with the combined listing as source to extract the line
             setErrorFull("PLCASM Compiler", msg, relative_line, col,
-                combined_plcasm, combined_plcasm_length,
+                listing, combined_listing_length,
                 token_text, token_len);
         } else {
             // Couldn't map to a block, just use the combined line number
             copyString(error_compiler, "PLCASM Compiler", 64);
             setErrorFull("PLCASM Compiler", msg, combined_line, col,
-                combined_plcasm, combined_plcasm_length,
+                listing, combined_listing_length,
                 token_text, token_len);
         }
     }
@@ -4175,6 +4252,188 @@ public:
         return true;
     }
 
+    // Route the records of the STL or PLCScript compiler into a new plcasm_ir segment at the end of combined_plcasm
+    void beginDirectSegment() {
+        plcasm_ir.beginSegment(combined_plcasm_length);
+        stl_compiler.ir = &plcasm_ir;
+        plcscript_compiler.ir = &plcasm_ir;
+    }
+
+    // Close the segment opened by beginDirectSegment(), its records are dropped when the block failed
+    bool endDirectSegment(bool success) {
+        stl_compiler.ir = &stl_compiler.generated;
+        plcscript_compiler.ir = &plcscript_compiler.generated;
+        if (!success) {
+            plcasm_ir.cancelSegment();
+            return false;
+        }
+        plcasm_ir.blank();
+        combined_plcasm_line += plcasm_ir.endSegment();
+        return true;
+    }
+
+    // combined_plcasm with every segment rendered in: the full PLCASM listing, which assembler lines refer to
+    const char* combinedListing() {
+        if (combined_listing) return combined_listing;
+        combined_listing_length = combined_plcasm_length;
+        if (plcasm_ir.segment_count == 0) return combined_plcasm;
+        int length = plcasm_ir.renderListing(combined_plcasm, combined_plcasm_length, nullptr, 0);
+        combined_listing = (char*) plcasm_ir.arena.alloc((u32) length + 1);
+        if (!combined_listing) return combined_plcasm;
+        plcasm_ir.renderListing(combined_plcasm, combined_plcasm_length, combined_listing, length);
+        combined_listing_length = length;
+        return combined_listing;
+    }
+
+    // ============ Block Cache ============
+
+    void clearBlockCache() {
+        for (int i = 0; i < PROJECT_MAX_PROGRAM_BLOCKS; i++) block_cache[i].reset();
+        block_cache_count = 0;
+        block_cache_ir.reset();
+    }
+
+    static u32 cacheHash(u32 hash, const char* data, int length) {
+        for (int i = 0; i < length; i++) hash = (hash ^ (u8) data[i]) * 16777619u;
+        return hash;
+    }
+
+    static u32 cacheHash(u32 hash, const char* str) {
+        return cacheHash(hash, str, string_len(str));
+    }
+
+    static u32 cacheHash(u32 hash, u32 value) {
+        for (int i = 0; i < 4; i++) {
+            hash = (hash ^ (value & 0xFF)) * 16777619u;
+            value >>= 8;
+        }
+        return hash;
+    }
+
+    u32 cacheHashStructType(u32 hash, const UserStructType& type) {
+        hash = cacheHash(hash, type.name);
+        hash = cacheHash(hash, (u32) type.total_size);
+        for (int i = 0; i < type.field_count; i++) {
+            const StructProperty& field = type.fields[i];
+            hash = cacheHash(hash, field.name);
+            hash = cacheHash(hash, (u32) field.offset | ((u32) field.type_size << 8) | ((u32) field.bit_pos << 16));
+            hash = cacheHash(hash, (u32) field.readable | ((u32) field.writable << 1));
+        }
+        return hash;
+    }
+
+    u32 cacheHashSymbol(u32 hash, const ProjectSymbol& sym) {
+        hash = cacheHash(hash, sym.name);
+        hash = cacheHash(hash, sym.type);
+        hash = cacheHash(hash, sym.address);
+        hash = cacheHash(hash, (u32) sym.bit | ((u32) sym.is_bit << 8) | ((u32) sym.type_size << 16));
+        hash = cacheHash(hash, (u32) sym.array_size);
+        UserStructType* type = findUserStructType(sym.type);
+        if (type) hash = cacheHashStructType(hash, *type);
+        return hash;
+    }
+
+    u32 cacheHashDB(u32 hash, const GlobalDBDecl& db) {
+        hash = cacheHash(hash, (u32) db.db_number | ((u32) db.total_size << 16));
+        hash = cacheHash(hash, db.alias);
+        hash = cacheHash(hash, (u32) db.computed_offset);
+        for (int i = 0; i < db.field_count; i++) {
+            const GlobalDBField& field = db.fields[i];
+            hash = cacheHash(hash, field.name);
+            hash = cacheHash(hash, field.type_name);
+            hash = cacheHash(hash, (u32) field.type_size | ((u32) field.offset << 8) | ((u32) field.has_default << 24));
+            if (field.has_default) hash = cacheHash(hash, (u32) field.default_value.int_val);
+        }
+        return hash;
+    }
+
+    int findSymbolIndexHashed(const char* name, int length) {
+        if (project_symbol_index.stale(project_symbol_generation, symbol_count)) {
+            project_symbol_index.rebuild(project_symbol_generation);
+            for (int i = 0; i < symbol_count; i++) {
+                if (!project_symbol_index.insert(nameHash(symbols[i].name, string_len(symbols[i].name), true), i)) break;
+            }
+        }
+        if (project_symbol_index.indexed != symbol_count) return findSymbolIndex(name);
+        return project_symbol_index.find(nameHash(name, length, true), [&](int i) { return strEqI(symbols[i].name, name); });
+    }
+
+    // Hash the declarations of every symbol, datablock and user type named by an identifier in block_source.
+    // Comments and strings are scanned too, which can only add dependencies.
+    u32 blockDependencyHash() {
+        u32 hash = 2166136261u;
+        char name[PROJECT_MAX_NAME_LEN];
+        int i = 0;
+        while (block_source[i]) {
+            char c = block_source[i];
+            if (!isAlpha(c)) { i++; continue; }
+            int start = i;
+            while (isAlphaNum(block_source[i])) i++;
+            int length = i - start;
+            if (length >= PROJECT_MAX_NAME_LEN) continue;
+            for (int k = 0; k < length; k++) name[k] = block_source[start + k];
+            name[length] = '\0';
+            int index = findSymbolIndexHashed(name, length);
+            if (index >= 0) hash = cacheHashSymbol(hash, symbols[index]);
+            GlobalDBDecl* db = findGlobalDBDecl(name);
+            if (db) hash = cacheHashDB(hash, *db);
+            UserStructType* type = findUserStructType(name);
+            if (type) hash = cacheHashStructType(hash, *type);
+        }
+        return hash;
+    }
+
+    BlockCacheEntry* findBlockCache(ProgramBlock& block) {
+        for (int i = 0; i < block_cache_count; i++) {
+            BlockCacheEntry& entry = block_cache[i];
+            if (sharedStrEq(entry.file_path, block.file_path) && sharedStrEq(entry.name, block.name)) return &entry;
+        }
+        return nullptr;
+    }
+
+    // Append the cached PLCASM of the block if it is still valid
+    bool reuseCachedBlock(ProgramBlock& block, u32 source_hash, u32 deps_hash) {
+        BlockCacheEntry* entry = findBlockCache(block);
+        if (!entry || entry->source_hash != source_hash || entry->deps_hash != deps_hash) return false;
+        if (block.language == LANG_LADDER && entry->edge_mem_in != project_edge_mem_counter) return false;
+        if (entry->record_end > entry->record_start) {
+            plcasm_ir.beginSegment(combined_plcasm_length);
+            plcasm_ir.copy(block_cache_ir, entry->record_start, entry->record_end);
+            combined_plcasm_line += plcasm_ir.endSegment();
+        }
+        if (block.language == LANG_LADDER) project_edge_mem_counter = entry->edge_mem_out;
+        // PLCScript blocks resolve symbols through the table the ST conversion fills
+        if (block.language == LANG_ST) copySymbolsToST();
+        block_cache_hits++;
+        return true;
+    }
+
+    // Store the records of the segment a block produced, a block without output stores none
+    void storeCachedBlock(ProgramBlock& block, u32 source_hash, u32 deps_hash, int edge_mem_in, int segment_count) {
+        BlockCacheEntry* entry = findBlockCache(block);
+        if (block_cache_ir.pool_length > PROJECT_BLOCK_CACHE_SIZE || (!entry && block_cache_count >= PROJECT_MAX_PROGRAM_BLOCKS)) {
+            // The records only grow, start over when the cache is full
+            clearBlockCache();
+            entry = nullptr;
+        }
+        if (!entry) {
+            entry = &block_cache[block_cache_count++];
+            copyString(entry->file_path, block.file_path, PROJECT_MAX_PATH_LEN);
+            copyString(entry->name, block.name, PROJECT_MAX_NAME_LEN);
+        }
+        entry->source_hash = source_hash;
+        entry->deps_hash = deps_hash;
+        entry->edge_mem_in = edge_mem_in;
+        entry->edge_mem_out = project_edge_mem_counter;
+        entry->record_start = block_cache_ir.record_count;
+        if (plcasm_ir.segment_count > segment_count) {
+            const PLCASMIRSegment& segment = plcasm_ir.segments[segment_count];
+            block_cache_ir.copy(plcasm_ir, (int) segment.record_start, (int) segment.record_end);
+        }
+        entry->record_end = block_cache_ir.record_count;
+        if (block_cache_ir.overflow) clearBlockCache();
+    }
+
     // Convert a block to PLCASM and append to combined buffer
     // This is the first pass - just gathering PLCASM from all blocks
     bool convertBlockToPLCASM(ProgramBlock& block) {
@@ -4228,6 +4487,24 @@ public:
         // Record the starting line for this block's actual content
         block.combined_line_start = combined_plcasm_line;
 
+        // Front-end blocks reuse the PLCASM of an earlier compile when nothing they depend on changed.
+        // Blocks that reported any problem are not cached, so their warnings show up again.
+        bool cacheable = incremental && block.language != LANG_PLCASM;
+        u32 source_hash = 0;
+        u32 deps_hash = 0;
+        int edge_mem_in = project_edge_mem_counter;
+        int problems_before = problem_count;
+        int segment_count = plcasm_ir.segment_count;
+        if (cacheable) {
+            source_hash = cacheHash(nameHash(block_source, string_len(block_source), false), (u32) block.language | ((u32) stl_compiler.bit_parallel << 8));
+            deps_hash = blockDependencyHash();
+            if (reuseCachedBlock(block, source_hash, deps_hash)) {
+                block.combined_line_end = combined_plcasm_line - 1;
+                return true;
+            }
+            block_cache_misses++;
+        }
+
         switch (block.language) {
             case LANG_PLCASM:
                 // PLCASM block - lint then append (stripping inline directives)
@@ -4267,6 +4544,10 @@ public:
         // Record the ending line for this block
         block.combined_line_end = combined_plcasm_line - 1;  // -1 because we just added a newline
 
+        if (cacheable && problem_count == problems_before && !has_error) {
+            storeCachedBlock(block, source_hash, deps_hash, edge_mem_in, segment_count);
+        }
+
         return true;
     }
 
@@ -4487,7 +4768,9 @@ public:
         int source_len = string_len(block_source);
         stl_compiler.setSource(block_source, source_len);
 
+        beginDirectSegment();
         bool success = stl_compiler.compile();
+        if (!success || stl_compiler.has_error) endDirectSegment(false);
 
         // Always copy problems (warnings, info, errors) from STL compiler
         if (stl_compiler.problem_count > 0) {
@@ -4520,11 +4803,8 @@ public:
             return false;
         }
 
-        // Append the generated PLCASM to combined buffer
-        if (!appendToCombinedPLCASM(stl_compiler.output)) return false;
-        if (!appendCharToCombinedPLCASM('\n')) return false;
-
-        return true;
+        // Close the segment holding the generated PLCASM
+        return endDirectSegment(true);
     }
 
     // Convert PLCScript block to PLCASM and append to combined buffer
@@ -4535,7 +4815,9 @@ public:
         int source_len = string_len(block_source);
         plcscript_compiler.setSource(block_source, source_len);
 
+        beginDirectSegment();
         bool success = plcscript_compiler.compile();
+        if (!success || plcscript_compiler.hasError) endDirectSegment(false);
 
         // Always copy problems (warnings, info, errors) from PLCScript compiler
         if (plcscript_compiler.getProblemCount() > 0) {
@@ -4566,11 +4848,8 @@ public:
             return false;
         }
 
-        // Append the generated PLCASM to combined buffer
-        if (!appendToCombinedPLCASM(plcscript_compiler.output)) return false;
-        if (!appendCharToCombinedPLCASM('\n')) return false;
-
-        return true;
+        // Close the segment holding the generated PLCASM
+        return endDirectSegment(true);
     }
 
     // Convert Structured Text (ST) block to PLCScript then to PLCASM
@@ -4618,7 +4897,9 @@ public:
         st_to_plcscript_buffer[plcscript_len < 65535 ? plcscript_len : 65535] = '\0';
 
         plcscript_compiler.setSource(st_to_plcscript_buffer, plcscript_len);
+        beginDirectSegment();
         success = plcscript_compiler.compile();
+        if (!success || plcscript_compiler.hasError) endDirectSegment(false);
 
         if (!success || plcscript_compiler.hasError) {
             // Internal error: PLCScript generated from ST failed
@@ -4634,11 +4915,8 @@ public:
             return false;
         }
 
-        // Append the generated PLCASM to combined buffer
-        if (!appendToCombinedPLCASM(plcscript_compiler.output)) return false;
-        if (!appendCharToCombinedPLCASM('\n')) return false;
-
-        return true;
+        // Close the segment holding the generated PLCASM
+        return endDirectSegment(true);
     }
 
     // Convert Ladder block to PLCASM and append to combined buffer
@@ -4685,7 +4963,9 @@ public:
         copySymbolsToSTL();
         stl_compiler.setSource(ladder_compiler.output, ladder_compiler.output_len);
 
+        beginDirectSegment();
         success = stl_compiler.compile();
+        if (!success || stl_compiler.has_error) endDirectSegment(false);
 
         if (!success || stl_compiler.has_error) {
             // Internal error: STL generated from ladder failed
@@ -4703,11 +4983,8 @@ public:
             return false;
         }
 
-        // Append the generated PLCASM to combined buffer
-        if (!appendToCombinedPLCASM(stl_compiler.output)) return false;
-        if (!appendCharToCombinedPLCASM('\n')) return false;
-
-        return true;
+        // Close the segment holding the generated PLCASM
+        return endDirectSegment(true);
     }
 
     // ============ Project Section Parsing ============
@@ -4865,9 +5142,14 @@ public:
         appendToCombinedPLCASM("// |               END OF PLCASM ASSEMBLY VOVKPLCPROJECT                |\n");
         appendToCombinedPLCASM("// +====================================================================+\n");
 
+        if (plcasm_ir.overflow) {
+            setError("Out of memory for the generated PLCASM");
+            return false;
+        }
+
         if (debug_mode) {
             Serial.println(F("Combined PLCASM:\n "));
-            Serial.println(combined_plcasm);
+            Serial.println(combinedListing());
         }
 
         // Pass 2: Compile the combined PLCASM to bytecode
@@ -4885,8 +5167,11 @@ public:
         // to preserve the original source language in the bytecode
         plcasm_compiler.set_assembly_string(combined_plcasm);
         plcasm_compiler.clearArray();
+        // The generated blocks are spliced in from their records
+        plcasm_compiler.instruction_ir = &plcasm_ir;
 
         bool error = plcasm_compiler.compileAssembly(true, false);  // true = real compile, not just analysis
+        plcasm_compiler.instruction_ir = nullptr;
 
         if (error || plcasm_compiler.problem_count > 0) {
             // Copy all problems from PLCASM compilter to project problems
@@ -5152,6 +5437,18 @@ extern "C" {
         project_compiler.clearTargetFlags();
     }
 
+    // Enable fused superinstructions in the compiled bytecode (off by default)
+    // Only enable for runtimes that support the fused opcodes (READ_AND_X8, LOAD_CMP_IMM, BR_SAVE_READ, ...)
+    WASM_EXPORT void project_setSuperinstructionFusion(bool enabled) {
+        project_compiler.plcasm_compiler.fuse_superinstructions = enabled;
+    }
+
+    // Compile runs of pure boolean rungs (STL and ladder) word-wide with BIT_GATHER/BIT_SCATTER (off by default)
+    // Only enable for runtimes built with PLCRUNTIME_BITWISE_OPS_ENABLED that know the bit gather/scatter opcodes
+    WASM_EXPORT void project_setBitParallel(bool enabled) {
+        project_compiler.stl_compiler.bit_parallel = enabled;
+    }
+
     // Compile a full project from source string
     // Returns true on success, false on error
     // Use project_getError() to get error message on failure
@@ -5208,12 +5505,33 @@ extern "C" {
 
     // Get the combined PLCASM source (generated during compilation)
     WASM_EXPORT const char* project_getCombinedPLCASM() {
-        return project_compiler.combined_plcasm;
+        return project_compiler.combinedListing();
     }
 
     // Get the combined PLCASM source length
     WASM_EXPORT int project_getCombinedPLCASMLength() {
-        return project_compiler.combined_plcasm_length;
+        project_compiler.combinedListing();
+        return project_compiler.combined_listing_length;
+    }
+
+    // Reuse the PLCASM of unchanged STL/Ladder/PLCScript/ST blocks from the previous compile (default on)
+    WASM_EXPORT void project_setIncremental(bool enabled) {
+        project_compiler.incremental = enabled;
+    }
+
+    // Drop all cached block output, the next compile converts every block
+    WASM_EXPORT void project_clearCache() {
+        project_compiler.clearBlockCache();
+    }
+
+    // Number of blocks reused from the cache by the last compile
+    WASM_EXPORT int project_getCacheHits() {
+        return project_compiler.block_cache_hits;
+    }
+
+    // Number of blocks converted (cache misses) by the last compile
+    WASM_EXPORT int project_getCacheMisses() {
+        return project_compiler.block_cache_misses;
     }
 
     // Get the compiled bytecode pointer
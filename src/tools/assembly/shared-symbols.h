@@ -54,6 +54,81 @@ inline bool sharedStrEqI(const char* a, const char* b) {
     return *a == *b;
 }
 
+// ============================================================================
+// Name Hash Index
+// ============================================================================
+// Open-addressed (linear probing) index from a name to the position of its
+// entry in an owner array. Each slot keeps a 16-bit tag of the name hash so
+// most probes are rejected without touching the entry, the owner confirms a
+// hit with its own string compare. Entries are never removed one by one: the
+// owner appends through insert() and keeps a generation counter that it bumps
+// on every other change (truncation, rename, bulk copy). The index records the
+// generation and entry count it covers and is rebuilt when either differs, so a
+// table rewritten to the same count is never looked up through stale slots.
+// CAPACITY must be a power of two, larger than the owner table (<= 65534).
+
+inline u32 nameHash(const char* data, int length, bool nocase) {
+    u32 hash = 2166136261u; // FNV-1a
+    for (int i = 0; i < length; i++) {
+        char c = nocase ? sharedToLower(data[i]) : data[i];
+        hash = (hash ^ (u8) c) * 16777619u;
+    }
+    return hash;
+}
+
+template <int CAPACITY>
+struct NameHashIndex {
+    u16 tags[CAPACITY];
+    u16 slots[CAPACITY];    // Entry index + 1, 0 = empty
+    int indexed = 0;        // Number of leading owner entries in the index
+    u32 generation = 0;     // Owner generation the index was built for
+
+    NameHashIndex() { clear(); }
+
+    void clear() {
+        memset(slots, 0, sizeof(slots));
+        indexed = 0;
+    }
+
+    // True if the index does not cover the owner's `count` entries as of `owner_generation`
+    bool stale(u32 owner_generation, int count) const { return generation != owner_generation || indexed != count; }
+
+    // Empty the index before the owner re-inserts its entries as of `owner_generation`
+    void rebuild(u32 owner_generation) {
+        clear();
+        generation = owner_generation;
+    }
+
+    // Returns the entry index for which match(index) is true, or -1
+    template <typename Match>
+    int find(u32 hash, Match match) const {
+        u16 tag = (u16) (hash >> 16);
+        u32 i = hash & (CAPACITY - 1);
+        for (int probe = 0; probe < CAPACITY; probe++) {
+            u16 slot = slots[i];
+            if (slot == 0) return -1;
+            if (tags[i] == tag && match(slot - 1)) return slot - 1;
+            i = (i + 1) & (CAPACITY - 1);
+        }
+        return -1;
+    }
+
+    // Adds entry `index` (the next owner entry), returns false if the index is full
+    bool insert(u32 hash, int index) {
+        u32 i = hash & (CAPACITY - 1);
+        for (int probe = 0; probe < CAPACITY; probe++) {
+            if (slots[i] == 0) {
+                slots[i] = (u16) (index + 1);
+                tags[i] = (u16) (hash >> 16);
+                indexed = index + 1;
+                return true;
+            }
+            i = (i + 1) & (CAPACITY - 1);
+        }
+        return false;
+    }
+};
+
 // ============================================================================
 // Shared Symbol Structure
 // ============================================================================
@@ -112,6 +187,8 @@ class SharedSymbolTable {
 public:
     SharedSymbol symbols[SHARED_MAX_SYMBOLS];
     int symbol_count = 0;
+    NameHashIndex<SHARED_MAX_SYMBOLS * 2> index; // Case-insensitive name -> symbols[]
+    u32 generation = 0; // Bumped by changed()
 
     SharedSymbolTable() {
         reset();
@@ -123,17 +200,27 @@ public:
         for (int i = 0; i < SHARED_MAX_SYMBOLS; i++) {
             symbols[i].reset();
         }
+        changed();
+    }
+
+    // Call after writing symbols[] or symbol_count directly, the name index is rebuilt on the next lookup
+    void changed() { generation++; }
+
+    static u32 hashName(const char* name) {
+        int length = 0;
+        while (name[length]) length++;
+        return nameHash(name, length, true);
     }
 
     // Find symbol by name (case-insensitive)
     SharedSymbol* findSymbol(const char* name) {
         if (!name || name[0] == '\0') return nullptr;
-        for (int i = 0; i < symbol_count; i++) {
-            if (sharedStrEqI(symbols[i].name, name)) {
-                return &symbols[i];
-            }
+        if (index.stale(generation, symbol_count)) {
+            index.rebuild(generation);
+            for (int i = 0; i < symbol_count; i++) index.insert(hashName(symbols[i].name), i);
         }
-        return nullptr;
+        int found = index.find(hashName(name), [&](int i) { return sharedStrEqI(symbols[i].name, name); });
+        return found < 0 ? nullptr : &symbols[found];
     }
 
     // Add a symbol to the table
@@ -180,6 +267,7 @@ public:
         sym.type_size = type_size;
         sym.array_size = array_size;
 
+        index.insert(hashName(sym.name), symbol_count);
         symbol_count++;
         return 0;
     }
@@ -417,11 +417,14 @@ extern "C" {
         sym.is_bit = is_bit;
         sym.type_size = type_size;
         sym.array_size = 0;
+        symbols.changed();
     }
 
     // Clear all shared symbols from the ST linter
     WASM_EXPORT void st_lint_clear_shared_symbols() {
-        stLinter.getSharedSymbols().symbol_count = 0;
+        SharedSymbolTable& symbols = stLinter.getSharedSymbols();
+        symbols.symbol_count = 0;
+        symbols.changed();
     }
 }
 
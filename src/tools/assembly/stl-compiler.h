@@ -37,6 +37,7 @@
 //   S, R                  - Set/Reset bit if RLO=1
 //   SET, CLR, NOT         - Set RLO=1, Clear RLO=0, Negate RLO
 //   A(, O(, X(, )         - Nesting (parentheses)
+//   (bit_parallel: runs of same-shape rungs ending in '=' coils compile to u32/u64 gatherBits/scatterBits)
 //
 // VovkPLCRuntime Extensions (non-standard):
 //   TAP                   - Tap/passthrough RLO to next rung (preserves RLO after output)
@@ -92,6 +93,9 @@
 #define STL_MAX_NESTING_DEPTH 16
 #define STL_MAX_LABELS 64
 #define STL_MAX_TYPE_STACK 64
+#define STL_BP_MAX_RUNGS 64    // Rungs per bit-parallel run (bits of an u64)
+#define STL_BP_MAX_OPERANDS 16 // Contacts and coils per bit-parallel rung
+#define STL_BP_MAX_SHAPE 48
 
 // Type IDs for stack tracking (must match PLCASM type codes)
 enum STLType {
@@ -119,6 +123,11 @@ public:
     char output[STL_MAX_OUTPUT_SIZE];
     int output_length = 0;
 
+    // Generated PLCASM records (plcasm-ir.h), rendered into output by compile()
+    // The project compiler points ir at its own records (kept across reset())
+    PLCASMInstructionIR generated;
+    PLCASMInstructionIR* ir = &generated;
+
     // Error handling
     char error_message[256];
     int error_line = 0;
@@ -156,6 +165,13 @@ public:
     
     // Current expression type (type of the last value pushed/computed)
     const char* currentExprType = nullptr;
+
+    // Bit-parallel evaluation of rung runs (see compileBitParallel(), kept across reset())
+    // Off by default: runtimes built before the bit gather/scatter opcodes existed reject them
+    bool bit_parallel = false;
+    u8 bp_shape[STL_BP_MAX_SHAPE];
+    u8 bp_shape_len = 0;
+    u32 bp_names[STL_BP_MAX_RUNGS][STL_BP_MAX_OPERANDS];
     
     // Static counter that increments with each compilation to ensure uniqueness
     // even for identical source code compiled multiple times
@@ -209,71 +225,23 @@ public:
         return hash;
     }
     
-    // Emit hex value (for hash suffix)
-    void emitHex(uint32_t value) {
-        const char hex[] = "0123456789abcdef";
-        char buf[9];
-        for (int i = 7; i >= 0; i--) {
-            buf[i] = hex[value & 0xF];
-            value >>= 4;
-        }
-        buf[8] = '\0';
-        emit(buf);
-    }
-
     // ============ Output helpers ============
 
-    void emit(const char* str) {
-        while (*str && output_length < STL_MAX_OUTPUT_SIZE - 1) {
-            output[output_length++] = *str++;
-        }
-        output[output_length] = '\0';
+    // Generated label <prefix><counter>_<hash>, added to the open label or jump target
+    void appendUniqueLabel(const char* prefix, int counter) {
+        ir->append(prefix);
+        ir->appendInt(counter);
+        ir->append("_");
+        ir->appendHex(compilation_hash);
     }
 
-    void emitLine(const char* str) {
-        emit(str);
-        emit("\n");
-    }
-
-    void emitIndent() {
-        emit("    ");
-    }
-
-    // Emit with format (simple implementation)
-    void emitInt(int value) {
-        char buf[16];
-        int i = 0;
-        bool negative = value < 0;
-        if (negative) value = -value;
-        if (value == 0) {
-            buf[i++] = '0';
-        } else {
-            while (value > 0) {
-                buf[i++] = '0' + (value % 10);
-                value /= 10;
-            }
-        }
-        if (negative) buf[i++] = '-';
-        // Reverse
-        for (int j = i - 1; j >= 0; j--) {
-            char c = buf[j];
-            if (output_length < STL_MAX_OUTPUT_SIZE - 1) {
-                output[output_length++] = c;
-            }
-        }
+    // Render the generated records as the PLCASM text in output
+    void renderOutput() {
+        int length = generated.render(0, generated.record_count, output, STL_MAX_OUTPUT_SIZE - 1);
+        output_length = length < STL_MAX_OUTPUT_SIZE - 1 ? length : STL_MAX_OUTPUT_SIZE - 1;
         output[output_length] = '\0';
     }
 
-    // Generate unique label with hash postfix to avoid collisions across compilation units
-    void emitUniqueLabel(const char* prefix) {
-        emit("__");
-        emit(prefix);
-        emit("_");
-        emitInt(label_counter++);
-        emit("_");
-        emitHex(compilation_hash);
-    }
-
     // ============ Error handling ============
 
     // Virtual so STLLinter can override to capture multiple errors
@@ -974,10 +942,10 @@ public:
         if (typesMatch(currentExprType, destType)) return;
         
         // Emit conversion: cvt <from> <to>
-        emit("cvt ");
-        emit(currentExprType);
-        emit(" ");
-        emitLine(destType);
+        ir->instruction("cvt");
+        ir->name(currentExprType);
+        ir->name(destType);
+        ir->end();
         currentExprType = destType;
     }
     
@@ -1116,20 +1084,19 @@ public:
         char plcAddr[64];
         convertAddress(addr, plcAddr);
         
-        emit("u8.readBit ");
-        emitLine(plcAddr);
+        ir->emit("u8.readBit", plcAddr);
         
         if (negate) {
-            emitLine("u8.not");
+            ir->emit("u8.not");
         }
     }
 
     // Emit boolean combine operation
     void emitBoolCombine(char op) {
         switch (op) {
-            case 'A': emitLine("u8.and"); break;
-            case 'O': emitLine("u8.or"); break;
-            case 'X': emitLine("u8.xor"); break;
+            case 'A': ir->emit("u8.and"); break;
+            case 'O': ir->emit("u8.or"); break;
+            case 'X': ir->emit("u8.xor"); break;
         }
     }
     
@@ -1264,11 +1231,10 @@ public:
         // If the next instruction is TAP, mark it as consumed since we emit the copy here
         bool foundTap = false;
         if (peekNextIsOutput(&foundTap)) {
-            emit("u8.copy\n");
+            ir->emit("u8.copy");
             if (foundTap) tap_consumed = true;
         }
-        emit("u8.writeBit ");
-        emitLine(plcAddr);
+        ir->emit("u8.writeBit", plcAddr);
         network_has_rlo = false; // Consumed (or preserved if we duped)
     }
 
@@ -1277,10 +1243,9 @@ public:
         char plcAddr[64];
         convertAddress(operand, plcAddr);
         // Always duplicate RLO first, then invert the copy, write, leaving original on stack
-        emit("u8.copy\n");
-        emit("u8.not\n");
-        emit("u8.writeBit ");
-        emitLine(plcAddr);
+        ir->emit("u8.copy");
+        ir->emit("u8.not");
+        ir->emit("u8.writeBit", plcAddr);
         // Original RLO is still on stack
         network_has_rlo = true;
     }
@@ -1296,24 +1261,20 @@ public:
         // If the next instruction is TAP, mark it as consumed since we emit the copy here
         bool foundTap = false;
         if (peekNextIsOutput(&foundTap)) {
-            emit("u8.copy\n");
+            ir->emit("u8.copy");
             if (foundTap) tap_consumed = true;  // TAP will be consumed, don't emit again
         }
         // Use relative jump for position-independent bytecode
-        emit("jmp_if_not_rel __skip_set_");
-        emitInt(savedCounter);
-        emit("_");
-        emitHex(compilation_hash);
-        emit("\n");
+        ir->instruction("jmp_if_not_rel");
+        ir->target("");
+        appendUniqueLabel("__skip_set_", savedCounter);
+        ir->end();
         
-        emit("u8.writeBitOn ");
-        emitLine(plcAddr);
+        ir->emit("u8.writeBitOn", plcAddr);
         
-        emit("__skip_set_");
-        emitInt(savedCounter);
-        emit("_");
-        emitHex(compilation_hash);
-        emit(":\n");
+        ir->label("");
+        appendUniqueLabel("__skip_set_", savedCounter);
+        ir->end();
         
         network_has_rlo = false;
     }
@@ -1329,24 +1290,20 @@ public:
         // If the next instruction is TAP, mark it as consumed since we emit the copy here
         bool foundTap = false;
         if (peekNextIsOutput(&foundTap)) {
-            emit("u8.copy\n");
+            ir->emit("u8.copy");
             if (foundTap) tap_consumed = true;  // TAP will be consumed, don't emit again
         }
         // Use relative jump for position-independent bytecode
-        emit("jmp_if_not_rel __skip_reset_");
-        emitInt(savedCounter);
-        emit("_");
-        emitHex(compilation_hash);
-        emit("\n");
+        ir->instruction("jmp_if_not_rel");
+        ir->target("");
+        appendUniqueLabel("__skip_reset_", savedCounter);
+        ir->end();
         
-        emit("u8.writeBitOff ");
-        emitLine(plcAddr);
+        ir->emit("u8.writeBitOff", plcAddr);
         
-        emit("__skip_reset_");
-        emitInt(savedCounter);
-        emit("_");
-        emitHex(compilation_hash);
-        emit(":\n");
+        ir->label("");
+        appendUniqueLabel("__skip_reset_", savedCounter);
+        ir->end();
         
         network_has_rlo = false;
     }
@@ -1355,24 +1312,21 @@ public:
     void handleFP(const char* edgeBit) {
         char plcAddr[64];
         convertAddress(edgeBit, plcAddr);
-        emit("u8.du ");
-        emitLine(plcAddr);
+        ir->emit("u8.du", plcAddr);
     }
 
     // Handle FN (negative edge)
     void handleFN(const char* edgeBit) {
         char plcAddr[64];
         convertAddress(edgeBit, plcAddr);
-        emit("u8.dd ");
-        emitLine(plcAddr);
+        ir->emit("u8.dd", plcAddr);
     }
 
     // Handle FX (any edge / change detect) - VovkPLCRuntime extension
     void handleFX(const char* edgeBit) {
         char plcAddr[64];
         convertAddress(edgeBit, plcAddr);
-        emit("u8.dc ");
-        emitLine(plcAddr);
+        ir->emit("u8.dc", plcAddr);
     }
 
     // Handle TON/TOF/TP timers
@@ -1381,11 +1335,10 @@ public:
         convertAddress(timerAddr, plcTimer);
         convertAddress(preset, plcPreset);
         
-        emit(type);
-        emit(" ");
-        emit(plcTimer);
-        emit(" ");
-        emitLine(plcPreset);
+        ir->instruction(type);
+        ir->name(plcTimer);
+        ir->value(plcPreset);
+        ir->end();
     }
 
     // Handle CTU counter: CTU C0, #10, X0.1
@@ -1398,17 +1351,18 @@ public:
         // Stack needs [CU, R] with R on top
         // RLO is already CU, now push R
         if (plcReset[0] != '\0') {
-            emit("u8.readBit ");
-            emitLine(plcReset);
+            ir->emit("u8.readBit", plcReset);
         } else {
             // No reset bit provided, push 0 (false) as default
-            emitLine("u8.const 0");
+            ir->instruction("u8.const");
+            ir->integer(0);
+            ir->end();
         }
         
-        emit("ctu ");
-        emit(plcCounter);
-        emit(" ");
-        emitLine(plcPreset);
+        ir->instruction("ctu");
+        ir->name(plcCounter);
+        ir->value(plcPreset);
+        ir->end();
     }
 
     // Handle CTD counter: CTD C1, #5, X0.3
@@ -1421,17 +1375,18 @@ public:
         // Stack needs [CD, LD] with LD on top
         // RLO is already CD, now push LD
         if (plcLoad[0] != '\0') {
-            emit("u8.readBit ");
-            emitLine(plcLoad);
+            ir->emit("u8.readBit", plcLoad);
         } else {
             // No load bit provided, push 0 (false) as default
-            emitLine("u8.const 0");
+            ir->instruction("u8.const");
+            ir->integer(0);
+            ir->end();
         }
         
-        emit("ctd ");
-        emit(plcCounter);
-        emit(" ");
-        emitLine(plcPreset);
+        ir->instruction("ctd");
+        ir->name(plcCounter);
+        ir->value(plcPreset);
+        ir->end();
     }
 
     // Emit a load instruction for an operand with explicit type
@@ -1442,16 +1397,16 @@ public:
         // Check if it's an immediate value
         if (operand[0] == '#') {
             // Immediate value
-            emit(type);
-            emit(".const ");
-            emitLine(operand + 1); // Skip #
+            ir->instruction(type, ".const");
+            ir->value(operand + 1); // Skip #
+            ir->end();
         } else {
             // Memory address - convert but use the type we were given
             const char* addrType = nullptr;
             convertTypedAddress(operand, plcAddr, &addrType);
-            emit(type);
-            emit(".load_from ");
-            emitLine(plcAddr);
+            ir->instruction(type, ".load_from");
+            ir->name(plcAddr);
+            ir->end();
         }
         // Track the type we just loaded
         setExprType(type);
@@ -1466,15 +1421,15 @@ public:
         if (operand[0] == '#') {
             // Immediate value - use lookahead to determine correct type
             type = peekNextMathType();
-            emit(type);
-            emit(".const ");
-            emitLine(operand + 1); // Skip #
+            ir->instruction(type, ".const");
+            ir->value(operand + 1); // Skip #
+            ir->end();
         } else {
             // Memory address - check for typed address (MW, MD, etc.)
             convertTypedAddress(operand, plcAddr, &type);
-            emit(type);
-            emit(".load_from ");
-            emitLine(plcAddr);
+            ir->instruction(type, ".load_from");
+            ir->name(plcAddr);
+            ir->end();
         }
         // Track the type we just loaded
         setExprType(type);
@@ -1489,9 +1444,9 @@ public:
         // If current expression type differs from destination, emit CVT
         emitCvtIfNeeded(destType);
         
-        emit(destType);
-        emit(".move_to ");
-        emitLine(plcAddr);
+        ir->instruction(destType, ".move_to");
+        ir->name(plcAddr);
+        ir->end();
         
         // Clear expression type after transfer (value consumed)
         currentExprType = nullptr;
@@ -1504,99 +1459,99 @@ public:
         const char* resultType = nullptr;
         
         // Standard Siemens STL operations (16-bit signed integer default)
-        if (strEq(op, "+I")) { emitLine("i16.add"); resultType = "i16"; }
-        else if (strEq(op, "-I")) { emitLine("i16.sub"); resultType = "i16"; }
-        else if (strEq(op, "*I")) { emitLine("i16.mul"); resultType = "i16"; }
-        else if (strEq(op, "/I")) { emitLine("i16.div"); resultType = "i16"; }
+        if (strEq(op, "+I")) { ir->emit("i16.add"); resultType = "i16"; }
+        else if (strEq(op, "-I")) { ir->emit("i16.sub"); resultType = "i16"; }
+        else if (strEq(op, "*I")) { ir->emit("i16.mul"); resultType = "i16"; }
+        else if (strEq(op, "/I")) { ir->emit("i16.div"); resultType = "i16"; }
         
         // Siemens STL 32-bit operations (Double word)
-        else if (strEq(op, "+D")) { emitLine("i32.add"); resultType = "i32"; }
-        else if (strEq(op, "-D")) { emitLine("i32.sub"); resultType = "i32"; }
-        else if (strEq(op, "*D")) { emitLine("i32.mul"); resultType = "i32"; }
-        else if (strEq(op, "/D")) { emitLine("i32.div"); resultType = "i32"; }
+        else if (strEq(op, "+D")) { ir->emit("i32.add"); resultType = "i32"; }
+        else if (strEq(op, "-D")) { ir->emit("i32.sub"); resultType = "i32"; }
+        else if (strEq(op, "*D")) { ir->emit("i32.mul"); resultType = "i32"; }
+        else if (strEq(op, "/D")) { ir->emit("i32.div"); resultType = "i32"; }
         
         // Siemens STL Real (float) operations
-        else if (strEq(op, "+R")) { emitLine("f32.add"); resultType = "f32"; }
-        else if (strEq(op, "-R")) { emitLine("f32.sub"); resultType = "f32"; }
-        else if (strEq(op, "*R")) { emitLine("f32.mul"); resultType = "f32"; }
-        else if (strEq(op, "/R")) { emitLine("f32.div"); resultType = "f32"; }
+        else if (strEq(op, "+R")) { ir->emit("f32.add"); resultType = "f32"; }
+        else if (strEq(op, "-R")) { ir->emit("f32.sub"); resultType = "f32"; }
+        else if (strEq(op, "*R")) { ir->emit("f32.mul"); resultType = "f32"; }
+        else if (strEq(op, "/R")) { ir->emit("f32.div"); resultType = "f32"; }
         
         // MOD variants
-        else if (strEq(op, "MOD")) { emitLine("i16.mod"); resultType = "i16"; }
-        else if (strEq(op, "MOD_U8"))  { emitLine("u8.mod");  resultType = "u8"; }
-        else if (strEq(op, "MOD_U16")) { emitLine("u16.mod"); resultType = "u16"; }
-        else if (strEq(op, "MOD_U32")) { emitLine("u32.mod"); resultType = "u32"; }
-        else if (strEq(op, "MOD_U64")) { emitLine("u64.mod"); resultType = "u64"; }
-        else if (strEq(op, "MOD_I8"))  { emitLine("i8.mod");  resultType = "i8"; }
-        else if (strEq(op, "MOD_I16")) { emitLine("i16.mod"); resultType = "i16"; }
-        else if (strEq(op, "MOD_I32")) { emitLine("i32.mod"); resultType = "i32"; }
-        else if (strEq(op, "MOD_I64")) { emitLine("i64.mod"); resultType = "i64"; }
+        else if (strEq(op, "MOD")) { ir->emit("i16.mod"); resultType = "i16"; }
+        else if (strEq(op, "MOD_U8"))  { ir->emit("u8.mod");  resultType = "u8"; }
+        else if (strEq(op, "MOD_U16")) { ir->emit("u16.mod"); resultType = "u16"; }
+        else if (strEq(op, "MOD_U32")) { ir->emit("u32.mod"); resultType = "u32"; }
+        else if (strEq(op, "MOD_U64")) { ir->emit("u64.mod"); resultType = "u64"; }
+        else if (strEq(op, "MOD_I8"))  { ir->emit("i8.mod");  resultType = "i8"; }
+        else if (strEq(op, "MOD_I16")) { ir->emit("i16.mod"); resultType = "i16"; }
+        else if (strEq(op, "MOD_I32")) { ir->emit("i32.mod"); resultType = "i32"; }
+        else if (strEq(op, "MOD_I64")) { ir->emit("i64.mod"); resultType = "i64"; }
         
         // NEG variants (signed types only)
-        else if (strEq(op, "NEG")) { emitLine("i16.neg"); resultType = "i16"; }
-        else if (strEq(op, "NEG_I8"))  { emitLine("i8.neg");  resultType = "i8"; }
-        else if (strEq(op, "NEG_I16")) { emitLine("i16.neg"); resultType = "i16"; }
-        else if (strEq(op, "NEG_I32")) { emitLine("i32.neg"); resultType = "i32"; }
-        else if (strEq(op, "NEG_I64")) { emitLine("i64.neg"); resultType = "i64"; }
-        else if (strEq(op, "NEG_F32")) { emitLine("f32.neg"); resultType = "f32"; }
-        else if (strEq(op, "NEG_F64")) { emitLine("f64.neg"); resultType = "f64"; }
+        else if (strEq(op, "NEG")) { ir->emit("i16.neg"); resultType = "i16"; }
+        else if (strEq(op, "NEG_I8"))  { ir->emit("i8.neg");  resultType = "i8"; }
+        else if (strEq(op, "NEG_I16")) { ir->emit("i16.neg"); resultType = "i16"; }
+        else if (strEq(op, "NEG_I32")) { ir->emit("i32.neg"); resultType = "i32"; }
+        else if (strEq(op, "NEG_I64")) { ir->emit("i64.neg"); resultType = "i64"; }
+        else if (strEq(op, "NEG_F32")) { ir->emit("f32.neg"); resultType = "f32"; }
+        else if (strEq(op, "NEG_F64")) { ir->emit("f64.neg"); resultType = "f64"; }
         
         // ABS variants (signed types only)
-        else if (strEq(op, "ABS")) { emitLine("i16.abs"); resultType = "i16"; }
-        else if (strEq(op, "ABS_I8"))  { emitLine("i8.abs");  resultType = "i8"; }
-        else if (strEq(op, "ABS_I16")) { emitLine("i16.abs"); resultType = "i16"; }
-        else if (strEq(op, "ABS_I32")) { emitLine("i32.abs"); resultType = "i32"; }
-        else if (strEq(op, "ABS_I64")) { emitLine("i64.abs"); resultType = "i64"; }
-        else if (strEq(op, "ABS_F32")) { emitLine("f32.abs"); resultType = "f32"; }
-        else if (strEq(op, "ABS_F64")) { emitLine("f64.abs"); resultType = "f64"; }
+        else if (strEq(op, "ABS")) { ir->emit("i16.abs"); resultType = "i16"; }
+        else if (strEq(op, "ABS_I8"))  { ir->emit("i8.abs");  resultType = "i8"; }
+        else if (strEq(op, "ABS_I16")) { ir->emit("i16.abs"); resultType = "i16"; }
+        else if (strEq(op, "ABS_I32")) { ir->emit("i32.abs"); resultType = "i32"; }
+        else if (strEq(op, "ABS_I64")) { ir->emit("i64.abs"); resultType = "i64"; }
+        else if (strEq(op, "ABS_F32")) { ir->emit("f32.abs"); resultType = "f32"; }
+        else if (strEq(op, "ABS_F64")) { ir->emit("f64.abs"); resultType = "f64"; }
         
         // Extended typed ADD operations
-        else if (strEq(op, "ADD_U8"))  { emitLine("u8.add");  resultType = "u8"; }
-        else if (strEq(op, "ADD_U16")) { emitLine("u16.add"); resultType = "u16"; }
-        else if (strEq(op, "ADD_U32")) { emitLine("u32.add"); resultType = "u32"; }
-        else if (strEq(op, "ADD_U64")) { emitLine("u64.add"); resultType = "u64"; }
-        else if (strEq(op, "ADD_I8"))  { emitLine("i8.add");  resultType = "i8"; }
-        else if (strEq(op, "ADD_I16")) { emitLine("i16.add"); resultType = "i16"; }
-        else if (strEq(op, "ADD_I32")) { emitLine("i32.add"); resultType = "i32"; }
-        else if (strEq(op, "ADD_I64")) { emitLine("i64.add"); resultType = "i64"; }
-        else if (strEq(op, "ADD_F32")) { emitLine("f32.add"); resultType = "f32"; }
-        else if (strEq(op, "ADD_F64")) { emitLine("f64.add"); resultType = "f64"; }
+        else if (strEq(op, "ADD_U8"))  { ir->emit("u8.add");  resultType = "u8"; }
+        else if (strEq(op, "ADD_U16")) { ir->emit("u16.add"); resultType = "u16"; }
+        else if (strEq(op, "ADD_U32")) { ir->emit("u32.add"); resultType = "u32"; }
+        else if (strEq(op, "ADD_U64")) { ir->emit("u64.add"); resultType = "u64"; }
+        else if (strEq(op, "ADD_I8"))  { ir->emit("i8.add");  resultType = "i8"; }
+        else if (strEq(op, "ADD_I16")) { ir->emit("i16.add"); resultType = "i16"; }
+        else if (strEq(op, "ADD_I32")) { ir->emit("i32.add"); resultType = "i32"; }
+        else if (strEq(op, "ADD_I64")) { ir->emit("i64.add"); resultType = "i64"; }
+        else if (strEq(op, "ADD_F32")) { ir->emit("f32.add"); resultType = "f32"; }
+        else if (strEq(op, "ADD_F64")) { ir->emit("f64.add"); resultType = "f64"; }
         
         // Extended typed SUB operations
-        else if (strEq(op, "SUB_U8"))  { emitLine("u8.sub");  resultType = "u8"; }
-        else if (strEq(op, "SUB_U16")) { emitLine("u16.sub"); resultType = "u16"; }
-        else if (strEq(op, "SUB_U32")) { emitLine("u32.sub"); resultType = "u32"; }
-        else if (strEq(op, "SUB_U64")) { emitLine("u64.sub"); resultType = "u64"; }
-        else if (strEq(op, "SUB_I8"))  { emitLine("i8.sub");  resultType = "i8"; }
-        else if (strEq(op, "SUB_I16")) { emitLine("i16.sub"); resultType = "i16"; }
-        else if (strEq(op, "SUB_I32")) { emitLine("i32.sub"); resultType = "i32"; }
-        else if (strEq(op, "SUB_I64")) { emitLine("i64.sub"); resultType = "i64"; }
-        else if (strEq(op, "SUB_F32")) { emitLine("f32.sub"); resultType = "f32"; }
-        else if (strEq(op, "SUB_F64")) { emitLine("f64.sub"); resultType = "f64"; }
+        else if (strEq(op, "SUB_U8"))  { ir->emit("u8.sub");  resultType = "u8"; }
+        else if (strEq(op, "SUB_U16")) { ir->emit("u16.sub"); resultType = "u16"; }
+        else if (strEq(op, "SUB_U32")) { ir->emit("u32.sub"); resultType = "u32"; }
+        else if (strEq(op, "SUB_U64")) { ir->emit("u64.sub"); resultType = "u64"; }
+        else if (strEq(op, "SUB_I8"))  { ir->emit("i8.sub");  resultType = "i8"; }
+        else if (strEq(op, "SUB_I16")) { ir->emit("i16.sub"); resultType = "i16"; }
+        else if (strEq(op, "SUB_I32")) { ir->emit("i32.sub"); resultType = "i32"; }
+        else if (strEq(op, "SUB_I64")) { ir->emit("i64.sub"); resultType = "i64"; }
+        else if (strEq(op, "SUB_F32")) { ir->emit("f32.sub"); resultType = "f32"; }
+        else if (strEq(op, "SUB_F64")) { ir->emit("f64.sub"); resultType = "f64"; }
         
         // Extended typed MUL operations
-        else if (strEq(op, "MUL_U8"))  { emitLine("u8.mul");  resultType = "u8"; }
-        else if (strEq(op, "MUL_U16")) { emitLine("u16.mul"); resultType = "u16"; }
-        else if (strEq(op, "MUL_U32")) { emitLine("u32.mul"); resultType = "u32"; }
-        else if (strEq(op, "MUL_U64")) { emitLine("u64.mul"); resultType = "u64"; }
-        else if (strEq(op, "MUL_I8"))  { emitLine("i8.mul");  resultType = "i8"; }
-        else if (strEq(op, "MUL_I16")) { emitLine("i16.mul"); resultType = "i16"; }
-        else if (strEq(op, "MUL_I32")) { emitLine("i32.mul"); resultType = "i32"; }
-        else if (strEq(op, "MUL_I64")) { emitLine("i64.mul"); resultType = "i64"; }
-        else if (strEq(op, "MUL_F32")) { emitLine("f32.mul"); resultType = "f32"; }
-        else if (strEq(op, "MUL_F64")) { emitLine("f64.mul"); resultType = "f64"; }
+        else if (strEq(op, "MUL_U8"))  { ir->emit("u8.mul");  resultType = "u8"; }
+        else if (strEq(op, "MUL_U16")) { ir->emit("u16.mul"); resultType = "u16"; }
+        else if (strEq(op, "MUL_U32")) { ir->emit("u32.mul"); resultType = "u32"; }
+        else if (strEq(op, "MUL_U64")) { ir->emit("u64.mul"); resultType = "u64"; }
+        else if (strEq(op, "MUL_I8"))  { ir->emit("i8.mul");  resultType = "i8"; }
+        else if (strEq(op, "MUL_I16")) { ir->emit("i16.mul"); resultType = "i16"; }
+        else if (strEq(op, "MUL_I32")) { ir->emit("i32.mul"); resultType = "i32"; }
+        else if (strEq(op, "MUL_I64")) { ir->emit("i64.mul"); resultType = "i64"; }
+        else if (strEq(op, "MUL_F32")) { ir->emit("f32.mul"); resultType = "f32"; }
+        else if (strEq(op, "MUL_F64")) { ir->emit("f64.mul"); resultType = "f64"; }
         
         // Extended typed DIV operations
-        else if (strEq(op, "DIV_U8"))  { emitLine("u8.div");  resultType = "u8"; }
-        else if (strEq(op, "DIV_U16")) { emitLine("u16.div"); resultType = "u16"; }
-        else if (strEq(op, "DIV_U32")) { emitLine("u32.div"); resultType = "u32"; }
-        else if (strEq(op, "DIV_U64")) { emitLine("u64.div"); resultType = "u64"; }
-        else if (strEq(op, "DIV_I8"))  { emitLine("i8.div");  resultType = "i8"; }
-        else if (strEq(op, "DIV_I16")) { emitLine("i16.div"); resultType = "i16"; }
-        else if (strEq(op, "DIV_I32")) { emitLine("i32.div"); resultType = "i32"; }
-        else if (strEq(op, "DIV_I64")) { emitLine("i64.div"); resultType = "i64"; }
-        else if (strEq(op, "DIV_F32")) { emitLine("f32.div"); resultType = "f32"; }
-        else if (strEq(op, "DIV_F64")) { emitLine("f64.div"); resultType = "f64"; }
+        else if (strEq(op, "DIV_U8"))  { ir->emit("u8.div");  resultType = "u8"; }
+        else if (strEq(op, "DIV_U16")) { ir->emit("u16.div"); resultType = "u16"; }
+        else if (strEq(op, "DIV_U32")) { ir->emit("u32.div"); resultType = "u32"; }
+        else if (strEq(op, "DIV_U64")) { ir->emit("u64.div"); resultType = "u64"; }
+        else if (strEq(op, "DIV_I8"))  { ir->emit("i8.div");  resultType = "i8"; }
+        else if (strEq(op, "DIV_I16")) { ir->emit("i16.div"); resultType = "i16"; }
+        else if (strEq(op, "DIV_I32")) { ir->emit("i32.div"); resultType = "i32"; }
+        else if (strEq(op, "DIV_I64")) { ir->emit("i64.div"); resultType = "i64"; }
+        else if (strEq(op, "DIV_F32")) { ir->emit("f32.div"); resultType = "f32"; }
+        else if (strEq(op, "DIV_F64")) { ir->emit("f64.div"); resultType = "f64"; }
         
         // Track result type after math operation
         if (resultType) {
@@ -1608,30 +1563,30 @@ public:
     // Siemens STL: ==I/<>I/>I etc (16-bit), ==D etc (32-bit), ==R etc (float)
     void handleCompare(const char* op) {
         // Standard Siemens STL 16-bit integer comparisons
-        if (strEq(op, "==I")) { emitLine("i16.cmp_eq"); }
-        else if (strEq(op, "<>I")) { emitLine("i16.cmp_neq"); }
-        else if (strEq(op, ">I"))  { emitLine("i16.cmp_gt"); }
-        else if (strEq(op, ">=I")) { emitLine("i16.cmp_gte"); }
-        else if (strEq(op, "<I"))  { emitLine("i16.cmp_lt"); }
-        else if (strEq(op, "<=I")) { emitLine("i16.cmp_lte"); }
+        if (strEq(op, "==I")) { ir->emit("i16.cmp_eq"); }
+        else if (strEq(op, "<>I")) { ir->emit("i16.cmp_neq"); }
+        else if (strEq(op, ">I"))  { ir->emit("i16.cmp_gt"); }
+        else if (strEq(op, ">=I")) { ir->emit("i16.cmp_gte"); }
+        else if (strEq(op, "<I"))  { ir->emit("i16.cmp_lt"); }
+        else if (strEq(op, "<=I")) { ir->emit("i16.cmp_lte"); }
         // Siemens STL 32-bit integer comparisons (Double word)
-        else if (strEq(op, "==D")) { emitLine("i32.cmp_eq"); }
-        else if (strEq(op, "<>D")) { emitLine("i32.cmp_neq"); }
-        else if (strEq(op, ">D"))  { emitLine("i32.cmp_gt"); }
-        else if (strEq(op, ">=D")) { emitLine("i32.cmp_gte"); }
-        else if (strEq(op, "<D"))  { emitLine("i32.cmp_lt"); }
-        else if (strEq(op, "<=D")) { emitLine("i32.cmp_lte"); }
+        else if (strEq(op, "==D")) { ir->emit("i32.cmp_eq"); }
+        else if (strEq(op, "<>D")) { ir->emit("i32.cmp_neq"); }
+        else if (strEq(op, ">D"))  { ir->emit("i32.cmp_gt"); }
+        else if (strEq(op, ">=D")) { ir->emit("i32.cmp_gte"); }
+        else if (strEq(op, "<D"))  { ir->emit("i32.cmp_lt"); }
+        else if (strEq(op, "<=D")) { ir->emit("i32.cmp_lte"); }
         // Siemens STL Real (float) comparisons
-        else if (strEq(op, "==R")) { emitLine("f32.cmp_eq"); }
-        else if (strEq(op, "<>R")) { emitLine("f32.cmp_neq"); }
-        else if (strEq(op, ">R"))  { emitLine("f32.cmp_gt"); }
-        else if (strEq(op, ">=R")) { emitLine("f32.cmp_gte"); }
-        else if (strEq(op, "<R"))  { emitLine("f32.cmp_lt"); }
-        else if (strEq(op, "<=R")) { emitLine("f32.cmp_lte"); }
+        else if (strEq(op, "==R")) { ir->emit("f32.cmp_eq"); }
+        else if (strEq(op, "<>R")) { ir->emit("f32.cmp_neq"); }
+        else if (strEq(op, ">R"))  { ir->emit("f32.cmp_gt"); }
+        else if (strEq(op, ">=R")) { ir->emit("f32.cmp_gte"); }
+        else if (strEq(op, "<R"))  { ir->emit("f32.cmp_lt"); }
+        else if (strEq(op, "<=R")) { ir->emit("f32.cmp_lte"); }
         
         // If BR was loaded for comparison (L BR pattern), AND result with BR
         if (br_loaded_for_comparison) {
-            emitLine("u8.and");
+            ir->emit("u8.and");
             br_loaded_for_comparison = false;
         }
         
@@ -1671,54 +1626,268 @@ public:
             }
             
             // Emit optimized single instruction: <type>.inc <addr> or <type>.dec <addr>
-            emit(typePrefix);
-            emit(isInc ? ".inc " : ".dec ");
-            emitLine(plcAddr);
+            ir->instruction(typePrefix, isInc ? ".inc" : ".dec");
+            ir->name(plcAddr);
+            ir->end();
         } else {
             // Stack-only operation: push 1, add/sub
-            emit(typePrefix);
-            emitLine(".const 1");
-            emit(typePrefix);
-            emitLine(isInc ? ".add" : ".sub");
+            ir->instruction(typePrefix, ".const");
+            ir->integer(1);
+            ir->end();
+            ir->instruction(typePrefix, isInc ? ".add" : ".sub");
+            ir->end();
         }
     }
 
     // Handle jumps
     void handleJump(const char* type, const char* label) {
         if (strEq(type, "JU")) {
-            emit("jmp ");
+            ir->instruction("jmp");
         } else if (strEq(type, "JC")) {
-            emit("jmp_if ");
+            ir->instruction("jmp_if");
             network_has_rlo = false;
         } else if (strEq(type, "JCN")) {
-            emit("jmp_if_not ");
+            ir->instruction("jmp_if_not");
             network_has_rlo = false;
         }
-        emitLine(label);
+        ir->target(label);
+        ir->end();
     }
 
     // Handle CALL
     void handleCall(const char* label) {
-        emit("call ");
-        emitLine(label);
+        ir->emit("call", label);
     }
 
     // Handle returns
     void handleReturn(const char* type) {
         if (strEq(type, "BE") || strEq(type, "RET")) {
-            emitLine("ret");
+            ir->emit("ret");
         } else if (strEq(type, "BEC")) {
-            emitLine("ret_if");
+            ir->emit("ret_if");
             network_has_rlo = false;
         } else if (strEq(type, "BEU")) {
-            emitLine("ret_if_not");
+            ir->emit("ret_if_not");
             network_has_rlo = false;
         }
     }
 
+    // ============ Bit-parallel networks ============
+    //
+    // With bit_parallel set, a run of consecutive rungs that share the same contact/nesting
+    // shape and only end in plain '=' coils is evaluated word-wide: rung n becomes bit n of
+    // an u32 (up to 32 rungs) or u64 (up to 64 rungs). Every contact column is one
+    // gatherBits, the logic is one bw.* per step and every coil column one scatterBits.
+    // A rung joins the run only if it does not read or write a bit written by an earlier
+    // rung of the run, so the result matches the rung-by-rung evaluation.
+
+    // Pack an X/Y/M/S bit address ("M12.3") as area << 24 | byte << 3 | bit, false for anything else
+    bool parseBitName(const char* plcAddr, u32& name) {
+        char area = plcAddr[0];
+        if (area != 'X' && area != 'Y' && area != 'M' && area != 'S') return false;
+        int i = 1;
+        u32 byte = 0;
+        while (isDigit(plcAddr[i]) && i < 8) byte = byte * 10 + (u32) (plcAddr[i++] - '0');
+        if (i == 1 || plcAddr[i] != '.' || plcAddr[i + 1] < '0' || plcAddr[i + 1] > '7' || plcAddr[i + 2] != '\0') return false;
+        name = ((u32) area << 24) | (byte << 3) | (u32) (plcAddr[i + 1] - '0');
+        return true;
+    }
+
+    // Absolute bit index of a packed name, used to detect overlapping rungs
+    u32 bitNameKey(u32 name) {
+        char area = (char) (name >> 24);
+        u32 base = area == 'X' ? plcasm_input_offset : area == 'Y' ? plcasm_output_offset : area == 'M' ? plcasm_marker_offset : plcasm_system_offset;
+        return ((base + ((name >> 3) & 0x1FFFFF)) << 3) | (name & 7);
+    }
+
+    void emitBitName(u32 name) {
+        ir->name("");
+        ir->appendChar((char) (name >> 24));
+        ir->appendInt((int) ((name >> 3) & 0x1FFFFF));
+        ir->appendChar('.');
+        ir->appendChar((char) ('0' + (name & 7)));
+    }
+
+    // Resolve a rung operand to a packed bit name without reporting anything.
+    // Virtual so STLLinter can resolve its local symbols.
+    virtual bool resolveBitAddress(const char* stlAddr, u32& name) {
+        if (hasPropertyAccess(stlAddr)) return false;
+        if (!isDirectAddress(stlAddr)) {
+            SharedSymbol* sym = findSharedSymbol(stlAddr);
+            if (!sym || !sym->is_bit || isTimerType(sym->type) || isCounterType(sym->type)) return false;
+        }
+        char plcAddr[64];
+        STLCompiler::convertAddress(stlAddr, plcAddr);
+        return parseBitName(plcAddr, name);
+    }
+
+    void skipBitRungSpace() {
+        while (pos < stl_length && (peek() == ' ' || peek() == '\t' || peek() == '\r' || peek() == '\n')) advance();
+    }
+
+    // Scan one pure rung at `pos` into shape codes and operand names:
+    //   'A' 'O' 'X' contact, 'a' 'o' 'x' negated contact, '&' '|' '^' A( O( X(, ')' close, '=' coil
+    // Returns false (position undefined) when the rung is anything else.
+    bool scanBitRung(u8* shape, u8& shape_len, u32* names, u8& name_count) {
+        shape_len = 0;
+        name_count = 0;
+        int depth = 0;
+        int coils = 0;
+        while (true) {
+            skipBitRungSpace();
+            char c = peek();
+            bool assign = c == '=' && peek(1) != '=' && peek(1) != 'N' && peek(1) != 'n';
+            if (coils > 0 && !assign) break;
+            if (shape_len >= STL_BP_MAX_SHAPE) return false;
+            if (assign) {
+                if (depth != 0 || shape_len == 0) return false;
+                advance();
+                skipWhitespace();
+            } else if (c == ')') {
+                if (depth == 0) return false;
+                advance();
+                depth--;
+                shape[shape_len++] = ')';
+                continue;
+            } else {
+                if (!isAlpha(c)) return false;
+                char token[8];
+                int n = 0;
+                while (isAlphaNum(peek()) && n < 7) {
+                    char ch = advance();
+                    token[n++] = ch >= 'a' && ch <= 'z' ? ch - 32 : ch;
+                }
+                token[n] = '\0';
+                if (isAlphaNum(peek())) return false;
+                char op = token[0];
+                bool negate = token[1] == 'N';
+                if ((op != 'A' && op != 'O' && op != 'X') || (n == 2 && !negate) || n > 2) return false;
+                skipWhitespace();
+                if (peek() == '(') {
+                    if (negate || ++depth > STL_MAX_NESTING_DEPTH) return false;
+                    advance();
+                    shape[shape_len++] = op == 'A' ? '&' : op == 'O' ? '|' : '^';
+                    continue;
+                }
+                shape[shape_len] = negate ? op + 32 : op;
+            }
+            char operand[64];
+            if (!STLCompiler::readIdentifier(operand, sizeof(operand)) || name_count >= STL_BP_MAX_OPERANDS) return false;
+            if (!resolveBitAddress(operand, names[name_count])) return false;
+            name_count++;
+            if (assign) {
+                shape[shape_len] = '=';
+                coils++;
+            }
+            shape_len++;
+        }
+        // S, R, TAP or =N after the coils keep using the RLO
+        return depth == 0 && !peekNextIsOutput();
+    }
+
+    // True if rung `r` of the run reads or writes a bit written by an earlier rung
+    bool bitRungOverlaps(u8 r) {
+        for (u8 i = 0, slot = 0; i < bp_shape_len; i++) {
+            if (!isAlpha((char) bp_shape[i]) && bp_shape[i] != '=') continue;
+            u32 key = bitNameKey(bp_names[r][slot++]);
+            for (u8 j = 0, other = 0; j < bp_shape_len; j++) {
+                if (!isAlpha((char) bp_shape[j]) && bp_shape[j] != '=') continue;
+                if (bp_shape[j] == '=') {
+                    for (u8 q = 0; q < r; q++) if (bitNameKey(bp_names[q][other]) == key) return true;
+                }
+                other++;
+            }
+        }
+        return false;
+    }
+
+    void emitBitColumn(const char* instr, u8 slot, u8 rungs) {
+        ir->instruction(instr);
+        for (u8 r = 0; r < rungs; r++) emitBitName(bp_names[r][slot]);
+        ir->end();
+    }
+
+    void emitBitCombine(char op, bool wide) {
+        ir->instruction(op == 'A' ? "bw.and" : op == 'O' ? "bw.or" : "bw.xor", wide ? ".x64" : ".x32");
+        ir->end();
+    }
+
+    // Try to compile a run of rungs starting at `pos` bit-parallel.
+    // Restores the position and returns false when fewer than two rungs qualify.
+    bool compileBitParallel() {
+        int start_pos = pos, start_line = current_line, start_column = current_column;
+        u8 rungs = 0;
+        u8 shape[STL_BP_MAX_SHAPE];
+        u8 shape_len = 0;
+        u8 name_count = 0;
+        while (rungs < STL_BP_MAX_RUNGS) {
+            int rung_pos = pos, rung_line = current_line, rung_column = current_column;
+            bool ok = scanBitRung(shape, shape_len, bp_names[rungs], name_count);
+            if (ok && rungs > 0) {
+                ok = shape_len == bp_shape_len;
+                for (u8 i = 0; ok && i < shape_len; i++) ok = shape[i] == bp_shape[i];
+            } else if (ok) {
+                for (u8 i = 0; i < shape_len; i++) bp_shape[i] = shape[i];
+                bp_shape_len = shape_len;
+            }
+            if (ok && rungs > 0) ok = !bitRungOverlaps(rungs);
+            if (!ok) {
+                pos = rung_pos; current_line = rung_line; current_column = rung_column;
+                break;
+            }
+            rungs++;
+        }
+        if (rungs < 2) {
+            pos = start_pos; current_line = start_line; current_column = start_column;
+            return false;
+        }
+
+        const bool wide = rungs > 32;
+        const char* gather = wide ? "u64.gatherBits" : "u32.gatherBits";
+        const char* scatter = wide ? "u64.scatterBits" : "u32.scatterBits";
+        u8 coils = 0;
+        for (u8 i = 0; i < bp_shape_len; i++) if (bp_shape[i] == '=') coils++;
+        bool has_rlo = false;
+        bool outer_rlo[STL_MAX_NESTING_DEPTH];
+        char outer_op[STL_MAX_NESTING_DEPTH];
+        int depth = 0;
+        u8 slot = 0;
+        for (u8 i = 0; i < bp_shape_len; i++) {
+            u8 code = bp_shape[i];
+            if (code == '&' || code == '|' || code == '^') {
+                outer_rlo[depth] = has_rlo;
+                outer_op[depth++] = code == '&' ? 'A' : code == '|' ? 'O' : 'X';
+                has_rlo = false;
+            } else if (code == ')') {
+                depth--;
+                if (outer_rlo[depth]) emitBitCombine(outer_op[depth], wide);
+                has_rlo = true;
+            } else if (code == '=') {
+                if (--coils > 0) ir->emit(wide ? "u64.copy" : "u32.copy");
+                emitBitColumn(scatter, slot++, rungs);
+            } else {
+                emitBitColumn(gather, slot++, rungs);
+                if (code >= 'a') ir->emit(wide ? "bw.not.x64" : "bw.not.x32");
+                if (has_rlo) emitBitCombine(code >= 'a' ? code - 32 : code, wide);
+                has_rlo = true;
+            }
+        }
+        network_has_rlo = false;
+        return true;
+    }
+
     // ============ Main parser ============
 
+    // Compile to PLCASM records, rendered into output unless ir points at other records
     bool compile() {
+        bool standalone = ir == &generated;
+        if (standalone) generated.reset();
+        bool ok = generate();
+        if (standalone) renderOutput();
+        return ok;
+    }
+
+    bool generate() {
         if (!stl_source || stl_length == 0) {
             setError("No source code provided");
             return false;
@@ -1741,19 +1910,18 @@ public:
             // Comment (// or (* *))
             if (c == '/' && peek(1) == '/') {
                 // Copy comment to output
-                emit("//");
+                ir->comment("//");
                 advance(); advance();
                 while (peek() != '\n' && peek() != '\0') {
-                    char cc = advance();
-                    if (output_length < STL_MAX_OUTPUT_SIZE - 1) {
-                        output[output_length++] = cc;
-                    }
+                    ir->appendChar(advance());
                 }
-                output[output_length] = '\0';
-                emit("\n");
+                ir->end();
                 continue;
             }
             
+            // Runs of pure boolean rungs, evaluated word-wide
+            if (bit_parallel && isAlpha(c) && !network_has_rlo && nesting_depth == 0 && !br_loaded_for_comparison && compileBitParallel()) continue;
+
             // Label definition: LABEL:
             if (isAlpha(c)) {
                 char token[64];
@@ -1763,8 +1931,8 @@ public:
                 if (peek() == ':' && peek(1) != '=') {
                     // It's a label
                     advance(); // consume :
-                    emit(token);
-                    emitLine(":");
+                    ir->label(token);
+                    ir->end();
                     continue;
                 }
                 
@@ -1796,7 +1964,8 @@ public:
                         processInstruction("==R");
                         continue;
                     }
-                    emit("// Unknown comparison: ==\n");
+                    ir->comment("// Unknown comparison: ==");
+                    ir->end();
                     continue;
                 }
                 // Check for =N (negated assign) - writes NOT(RLO) but preserves original
@@ -1835,8 +2004,9 @@ public:
                 }
                 // Not a math op - might be start of number, rewind
                 // Actually, we can't easily rewind, so emit unknown
-                emit("// Unknown operator: ");
-                emitLine(op);
+                ir->comment("// Unknown operator: ");
+                ir->append(op);
+                ir->end();
                 continue;
             }
             
@@ -1862,8 +2032,9 @@ public:
                     continue;
                 }
                 op[idx] = '\0';
-                emit("// Unknown comparison: ");
-                emitLine(op);
+                ir->comment("// Unknown comparison: ");
+                ir->append(op);
+                ir->end();
                 continue;
             }
             
@@ -1942,7 +2113,8 @@ public:
                 handleNestingOpen('O');
             } else if (peek() == '\n' || peek() == '\0' || peek() == '/') {
                 // Bare O instruction (OR with next network) - rare, emit comment
-                emitLine("// OR (network combine - not directly supported)");
+                ir->comment("// OR (network combine - not directly supported)");
+                ir->end();
             } else {
                 readIdentifier(operand1, sizeof(operand1));
                 if (!requireOperand(operand1, "O")) return;
@@ -1981,7 +2153,9 @@ public:
         
         // SET, CLR, NOT
         if (strEq(upperInstr, "SET")) {
-            emitLine("u8.const 1");
+            ir->instruction("u8.const");
+            ir->integer(1);
+            ir->end();
             network_has_rlo = true;
             return;
         }
@@ -1993,17 +2167,19 @@ public:
             readIdentifier(nextWord, sizeof(nextWord));
             toUpper(nextWord);
             if (strEq(nextWord, "BR")) {
-                emitLine("br.clr");
+                ir->emit("br.clr");
                 return;
             }
             // Not "CLR BR", restore position and handle as normal CLR (RLO=0)
             pos = lookAheadPos;
-            emitLine("u8.const 0");
+            ir->instruction("u8.const");
+            ir->integer(0);
+            ir->end();
             network_has_rlo = true;
             return;
         }
         if (strEq(upperInstr, "NOT")) {
-            emitLine("u8.not");
+            ir->emit("u8.not");
             return;
         }
         
@@ -2016,7 +2192,7 @@ public:
                 network_has_rlo = true;  // RLO is still on stack (copy was emitted by S/R)
                 return;  // Skip emitting another copy
             }
-            emitLine("u8.copy");  // Duplicate top of stack (RLO)
+            ir->emit("u8.copy");  // Duplicate top of stack (RLO)
             network_has_rlo = true;
             return;
         }
@@ -2028,7 +2204,7 @@ public:
         // CLR BR - Clear BR stack
         
         if (strEq(upperInstr, "SAVE")) {
-            emitLine("br.save");
+            ir->emit("br.save");
             network_has_rlo = false;  // SAVE moves RLO from stack to BR, so stack is now empty
             return;
         }
@@ -2042,7 +2218,7 @@ public:
             readIdentifier(nextWord, sizeof(nextWord));
             toUpper(nextWord);
             if (strEq(nextWord, "BR")) {
-                emitLine("br.read");
+                ir->emit("br.read");
                 network_has_rlo = true;  // BR value is now on stack as RLO
                 br_loaded_for_comparison = true;  // Track that BR was loaded for combining with comparison
                 return;
@@ -2059,7 +2235,7 @@ public:
             readIdentifier(nextWord, sizeof(nextWord));
             toUpper(nextWord);
             if (strEq(nextWord, "BR")) {
-                emitLine("br.drop");
+                ir->emit("br.drop");
                 return;
             }
             // Not "DROP BR", this is an error - DROP without BR is not valid STL
@@ -2325,16 +2501,16 @@ public:
         
         if (strEq(upperInstr, "NETWORK")) {
             // Network marker - emit clear and comment
-            emitLine("");
-            emit("// NETWORK");
+            ir->blank();
+            ir->comment("// NETWORK");
             skipWhitespace();
             if (isDigit(peek())) {
-                emit(" ");
+                ir->append(" ");
                 readIdentifier(operand1, sizeof(operand1));
-                emit(operand1);
+                ir->append(operand1);
             }
-            emitLine("");
-            emitLine("clear");
+            ir->end();
+            ir->emit("clear");
             network_has_rlo = false;
             return;
         }
@@ -2342,7 +2518,7 @@ public:
         // ============ NOP ============
         
         if (strEq(upperInstr, "NOP")) {
-            emitLine("nop");
+            ir->emit("nop");
             return;
         }
         
@@ -2455,8 +2631,9 @@ public:
         
         // Unknown instruction - report error
         setError("Unknown instruction");
-        emit("// Unknown instruction: ");
-        emitLine(instr);
+        ir->comment("// Unknown instruction: ");
+        ir->append(instr);
+        ir->end();
     }
 
     // Get compiled output
@@ -2508,6 +2685,11 @@ extern "C" {
         return stlCompiler.compile();
     }
 
+    // Compile runs of pure boolean rungs word-wide (off by default, requires runtime support for BIT_GATHER/BIT_SCATTER)
+    WASM_EXPORT void stl_setBitParallel(bool enabled) {
+        stlCompiler.bit_parallel = enabled;
+    }
+
     // Get output PLCASM pointer
     WASM_EXPORT const char* stl_get_output() {
         return stlCompiler.getOutput();
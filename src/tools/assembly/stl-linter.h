@@ -538,6 +538,20 @@ public:
         STLCompiler::convertAddress(stlAddr, plcasmAddr);
     }
 
+    // Override resolveBitAddress so bit-parallel runs also take local bit symbols
+    bool resolveBitAddress(const char* stlAddr, u32& name) override {
+        STLSymbol* sym = findSymbol(stlAddr);
+        if (sym) {
+            if (!sym->is_bit) return false;
+            char plcAddr[64];
+            convertAddress(stlAddr, plcAddr);
+            return parseBitName(plcAddr, name);
+        }
+        // Malformed addresses stay on the scalar path, which reports them
+        if (!findSharedSymbol(stlAddr) && !isValidAddressFormat(stlAddr)) return false;
+        return STLCompiler::resolveBitAddress(stlAddr, name);
+    }
+
     // Override setError to capture errors instead of stopping at the first one
     void setError(const char* msg) override {
         // Find if we already have an error on this line
@@ -669,6 +683,7 @@ public:
         current_column = 1;
         output_length = 0;
         output[0] = '\0';
+        generated.reset();
         network_has_rlo = false;
         nesting_depth = 0;
         label_counter = 0;
@@ -691,14 +706,12 @@ public:
             // Comment (// or (* *))
             if (c == '/' && peek(1) == '/') {
                 // Copy comment to output
-                emit("//");
+                ir->comment("//");
                 advance(); advance();
                 while (pos < stl_length && peek() != '\n') {
-                    char cc = advance();
-                    char buf[2] = { cc, '\0' };
-                    emit(buf);
+                    ir->appendChar(advance());
                 }
-                emit("\n");
+                ir->end();
                 continue;
             }
 
@@ -724,8 +737,8 @@ public:
                 if (peek() == ':') {
                     // It's a label
                     advance();
-                    emit(identifier);
-                    emitLine(":");
+                    ir->label(identifier);
+                    ir->end();
                 } else {
                     // It's an instruction
                     processInstruction(identifier);
@@ -831,6 +844,8 @@ public:
             setError("Unconsumed RLO at end of program - missing output instruction (=, S, R, etc.)");
         }
 
+        renderOutput();
+
         // If there are any errors, clear the output to prevent invalid PLCASM from being used
         bool hasErrors = false;
         for (int i = 0; i < problem_count; i++) {
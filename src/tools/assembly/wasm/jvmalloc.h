@@ -90,6 +90,20 @@ extern "C" {
         return dest;
     }
 
+    // memmove implementation (overlapping regions)
+    void* memmove(void* dest, const void* src, int num) {
+        char* char_dest = (char*) dest;
+        char* char_src = (char*) src;
+        if (char_dest < char_src) {
+            for (int i = 0; i < num; i++)
+                char_dest[i] = char_src[i];
+        } else if (char_dest > char_src) {
+            for (int i = num - 1; i >= 0; i--)
+                char_dest[i] = char_src[i];
+        }
+        return dest;
+    }
+
     // memcmp implementation
     int memcmp(const void* ptr1, const void* ptr2, int num) {
         char* char_ptr1 = (char*) ptr1;
@@ -215,5 +229,31 @@ extern "C" {
 }
 #endif // __cplusplus
 
+// Page allocation for large working memory that is kept for the whole session (compiler tables, see compiler-arena.h).
+// Pages are never returned. On wasm32 the linear memory is grown directly, so the pages do not count against the heap above.
+// Other targets (host builds of the compiler) carve the pages out of a static reserve.
+#define JV_PAGE_SIZE 65536
+
+#ifndef PAGE_RESERVE_SIZE
+#define PAGE_RESERVE_SIZE 32 * 1024 * 1024 // Only used when not targeting wasm32
+#endif // PAGE_RESERVE_SIZE
+
+void* page_alloc(uint32_t size) {
+    if (size == 0) return nullptr;
+    uint32_t pages = (size + JV_PAGE_SIZE - 1) / JV_PAGE_SIZE;
+#if defined(__wasm__)
+    unsigned long previous = __builtin_wasm_memory_grow(0, pages);
+    if (previous == (unsigned long) -1) return nullptr;
+    return (void*) (previous * JV_PAGE_SIZE);
+#else
+    static char page_reserve[PAGE_RESERVE_SIZE];
+    static uint32_t page_reserve_used = 0;
+    if (pages * JV_PAGE_SIZE > PAGE_RESERVE_SIZE - page_reserve_used) return nullptr;
+    void* ptr = &page_reserve[page_reserve_used];
+    page_reserve_used += pages * JV_PAGE_SIZE;
+    return ptr;
+#endif // __wasm__
+}
+
 
 #endif // __WASM__
\ No newline at end of file
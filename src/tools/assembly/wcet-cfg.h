@@ -111,7 +111,8 @@ u32             g_wcet_dead_code_bytes = 0;
 // ============================================================================
 inline bool wcet_is_branch(u8 op) {
     return op == JMP || op == JMP_IF || op == JMP_IF_NOT ||
-           op == JMP_REL || op == JMP_IF_REL || op == JMP_IF_NOT_REL;
+           op == JMP_REL || op == JMP_IF_REL || op == JMP_IF_NOT_REL ||
+           op == LOAD_CMP_IMM_JMP_IF_NOT;
 }
 inline bool wcet_is_call(u8 op) {
     return op == CALL || op == CALL_IF || op == CALL_IF_NOT ||
@@ -119,7 +120,8 @@ inline bool wcet_is_call(u8 op) {
 }
 inline bool wcet_is_conditional_branch(u8 op) {
     return op == JMP_IF || op == JMP_IF_NOT ||
-           op == JMP_IF_REL || op == JMP_IF_NOT_REL;
+           op == JMP_IF_REL || op == JMP_IF_NOT_REL ||
+           op == LOAD_CMP_IMM_JMP_IF_NOT;
 }
 inline bool wcet_is_conditional_call(u8 op) {
     return op == CALL_IF || op == CALL_IF_NOT ||
@@ -134,6 +136,12 @@ inline u32 wcet_resolve_target(const WCETInstruction& instr, const u8* bytecode)
         u16 target = (u16)bytecode[off + 1] | ((u16)bytecode[off + 2] << 8);
         return (u32)target;
     }
+    if (op == LOAD_CMP_IMM_JMP_IF_NOT) {
+        // Absolute target is the last operand
+        u32 at = off + instr.size - 2;
+        u16 target = (u16)bytecode[at] | ((u16)bytecode[at + 1] << 8);
+        return (u32)target;
+    }
     if (op == JMP_REL || op == JMP_IF_REL || op == JMP_IF_NOT_REL ||
         op == CALL_REL || op == CALL_IF_REL || op == CALL_IF_NOT_REL) {
         i16 rel = (i16)((u16)bytecode[off + 1] | ((u16)bytecode[off + 2] << 8));
@@ -209,6 +217,12 @@ bool wcet_cfg_decode(const u8* bytecode, u32 length) {
             } else if ((instr.opcode == CSTR_LIT || instr.opcode == CSTR_CAT) && offset + 4 < length) {
                 u16 str_len = (u16)bytecode[offset + 3] | ((u16)bytecode[offset + 4] << 8);
                 op_size = 5 + str_len;
+            } else if ((instr.opcode == LOAD_CMP_IMM || instr.opcode == LOAD_CMP_IMM_JMP_IF_NOT) && offset + 2 < length) {
+                op_size = LOAD_CMP_IMM_SIZE(bytecode[offset + 2]);
+                if (op_size && instr.opcode == LOAD_CMP_IMM_JMP_IF_NOT) op_size += 2;
+                if (!op_size) op_size = 1;
+            } else if (instr.opcode >= BIT_GATHER_X32 && instr.opcode <= BIT_SCATTER_X64 && offset + 1 < length) {
+                op_size = 2 + bytecode[offset + 1] * (MY_PTR_SIZE_BYTES + 1);
             } else {
                 op_size = 1;
             }
@@ -51,13 +51,6 @@ struct OpcodeCost {
     u8 wcet;    // Worst-case execution time in cycle units
 };
 
-// Stack effect: how many bytes pushed/popped per instruction
-// Positive = net push, negative = net pop, 0 = neutral
-struct OpcodeStackEffect {
-    i8 pop_bytes;   // Bytes consumed from stack (>= 0)
-    i8 push_bytes;  // Bytes produced to stack (>= 0)
-};
-
 // Get the CPU cycle cost for an opcode
 inline OpcodeCost wcet_opcode_cost(u8 opcode) {
     switch (opcode) {
@@ -169,6 +162,7 @@ inline OpcodeCost wcet_opcode_cost(u8 opcode) {
         case BR_READ:           return { 2, 3 };
         case BR_DROP:           return { 1, 2 };
         case BR_CLR:            return { 1, 1 };
+        case BR_SAVE_READ:      return { 3, 5 };
 
         // Bitwise operations
         case BW_AND_X8: case BW_OR_X8: case BW_XOR_X8: case BW_NOT_X8:
@@ -211,9 +205,25 @@ inline OpcodeCost wcet_opcode_cost(u8 opcode) {
         case CALL_IF_REL:       return { 2, 7 };
         case CALL_IF_NOT_REL:   return { 2, 7 };
 
+        // Fused superinstructions (single dispatch for the replaced sequence)
+        case READ_AND_X8:
+        case READ_OR_X8:        return { 5, 8 };
+        case READ_AND_WRITE_X8: return { 9, 14 };
+        case LOAD_CMP_IMM:      return { 9, 16 };
+        case LOAD_CMP_IMM_JMP_IF_NOT: return { 10, 19 };
+
+        // Packed bit access (one read or read-modify-write per listed bit, 1 to 32/64 bits)
+        case BIT_GATHER_X32:    return { 5, 100 };
+        case BIT_GATHER_X64:    return { 5, 196 };
+        case BIT_SCATTER_X32:   return { 6, 164 };
+        case BIT_SCATTER_X64:   return { 6, 255 };   // Saturated
+
         // FFI (highly variable — depends on the registered function)
         case FFI_CALL:          return { 30, 100 };
         case FFI_CALL_STACK:    return { 30, 100 };
+        case FFI_CALL_BATCH:    return { 30, 100 };    // Per invocation, the record count is only known at run time
+        case FFI_START:         return { 20, 40 };    // Parameter snapshot into a job slot, the call runs outside the scan
+        case FFI_POLL:          return { 4, 8 };
 
         // String operations (variable length, memory intensive)
         case STR_LEN:           return { 5, 10 };
@@ -251,6 +261,21 @@ inline OpcodeCost wcet_opcode_cost(u8 opcode) {
     }
 }
 
+#endif // __WASM__
+
+// ============================================================================
+// Stack effect per opcode
+// ============================================================================
+// Shared with the runtime's load-time verifier (runtime-verifier.h), so this
+// part is compiled for every target, not only the WASM compiler build.
+
+// Stack effect: how many bytes pushed/popped per instruction
+// Positive = net push, negative = net pop, 0 = neutral
+struct OpcodeStackEffect {
+    i8 pop_bytes;   // Bytes consumed from stack (>= 0)
+    i8 push_bytes;  // Bytes produced to stack (>= 0)
+};
+
 // Get the stack effect for an opcode (requires the type argument byte for typed ops)
 // Returns {pop_bytes, push_bytes}
 // For typed operations, type_arg is the data type byte following the opcode
@@ -384,20 +409,43 @@ inline OpcodeStackEffect wcet_stack_effect(u8 opcode, u8 type_arg = 0) {
         case BR_DROP:
         case BR_CLR:
             return { 0, 0 }; // No stack effect
+        case BR_SAVE_READ:
+            return { 1, 1 }; // pop u8 bool into BR register, push it back
+
+        // Fused superinstructions
+        case READ_AND_X8: case READ_OR_X8:
+            return { 1, 1 }; // pop bool, push combined bool
+        case READ_AND_WRITE_X8:
+            return { 1, 0 }; // pop bool
+        case LOAD_CMP_IMM:
+            return { 0, 1 }; // push bool (value and immediate never reach the stack)
+        case LOAD_CMP_IMM_JMP_IF_NOT:
+            return { 0, 0 };
+
+        // Packed bit access
+        case BIT_GATHER_X32:    return { 0, 4 };   // push u32
+        case BIT_GATHER_X64:    return { 0, 8 };   // push u64
+        case BIT_SCATTER_X32:   return { 4, 0 };   // pop u32
+        case BIT_SCATTER_X64:   return { 8, 0 };   // pop u64
 
         // Bitwise binary: pop two, push one (same size)
         case BW_AND_X8: case BW_OR_X8: case BW_XOR_X8:
-        case BW_LSHIFT_X8: case BW_RSHIFT_X8:
             return { 2, 1 };
         case BW_AND_X16: case BW_OR_X16: case BW_XOR_X16:
-        case BW_LSHIFT_X16: case BW_RSHIFT_X16:
             return { 4, 2 };
         case BW_AND_X32: case BW_OR_X32: case BW_XOR_X32:
-        case BW_LSHIFT_X32: case BW_RSHIFT_X32:
             return { 8, 4 };
         case BW_AND_X64: case BW_OR_X64: case BW_XOR_X64:
-        case BW_LSHIFT_X64: case BW_RSHIFT_X64:
             return { 16, 8 };
+        // Shifts: pop value + u8 shift count, push value
+        case BW_LSHIFT_X8: case BW_RSHIFT_X8:
+            return { 2, 1 };
+        case BW_LSHIFT_X16: case BW_RSHIFT_X16:
+            return { 3, 2 };
+        case BW_LSHIFT_X32: case BW_RSHIFT_X32:
+            return { 5, 4 };
+        case BW_LSHIFT_X64: case BW_RSHIFT_X64:
+            return { 9, 8 };
         // Bitwise unary: pop one, push one
         case BW_NOT_X8:     return { 1, 1 };
         case BW_NOT_X16:    return { 2, 2 };
@@ -436,6 +484,9 @@ inline OpcodeStackEffect wcet_stack_effect(u8 opcode, u8 type_arg = 0) {
         // FFI
         case FFI_CALL:          return { 0, 0 };   // Uses memory addresses, not stack
         case FFI_CALL_STACK:    return { 0, 0 };   // Variable — depends on param count (conservative: 0)
+        case FFI_CALL_BATCH:    return { 0, 0 };   // Records live in memory, not stack
+        case FFI_START:         return { 0, 0 };   // Uses memory addresses, not stack
+        case FFI_POLL:          return { 0, 1 };   // push bool
 
         // String ops — most use memory addresses from bytecode, minimal stack
         case STR_LEN:           return { 0, 2 };   // push u16 length
@@ -469,5 +520,3 @@ inline OpcodeStackEffect wcet_stack_effect(u8 opcode, u8 type_arg = 0) {
         default:                return { 0, 0 };
     }
 }
-
-#endif // __WASM__
@@ -406,6 +406,7 @@ inline u8 wcet_opcode_to_category(u8 opcode, u8 type_arg) {
         case JMP: case JMP_REL:
             return WCET_CAT_JMP;
         case JMP_IF: case JMP_IF_NOT: case JMP_IF_REL: case JMP_IF_NOT_REL:
+        case LOAD_CMP_IMM_JMP_IF_NOT:
             return WCET_CAT_JMP_COND;
         case CALL: case CALL_IF: case CALL_IF_NOT:
         case CALL_REL: case CALL_IF_REL: case CALL_IF_NOT_REL:
@@ -413,7 +414,7 @@ inline u8 wcet_opcode_to_category(u8 opcode, u8 type_arg) {
         case RET: case RET_IF: case RET_IF_NOT:
             return WCET_CAT_RET;
 
-        case LOAD: case LOAD_FROM:
+        case LOAD: case LOAD_FROM: case LOAD_CMP_IMM:
             return WCET_CAT_LOAD;
         case MOVE: case MOVE_TO: case MOVE_COPY: case MEM_FILL:
         case INC_MEM: case DEC_MEM:
@@ -432,6 +433,8 @@ inline u8 wcet_opcode_to_category(u8 opcode, u8 type_arg) {
         case READ_X8_B4: case READ_X8_B5: case READ_X8_B6: case READ_X8_B7:
         case WRITE_X8_B0: case WRITE_X8_B1: case WRITE_X8_B2: case WRITE_X8_B3:
         case WRITE_X8_B4: case WRITE_X8_B5: case WRITE_X8_B6: case WRITE_X8_B7:
+        case READ_AND_X8: case READ_OR_X8: case READ_AND_WRITE_X8:
+        case BIT_GATHER_X32: case BIT_GATHER_X64: case BIT_SCATTER_X32: case BIT_SCATTER_X64:
             return WCET_CAT_BIT_RW;
 
         case TON_CONST: case TON_MEM: case TOF_CONST: case TOF_MEM:
@@ -451,9 +454,15 @@ inline u8 wcet_opcode_to_category(u8 opcode, u8 type_arg) {
         case CSTR_LIT: case CSTR_CPY: case CSTR_EQ: case CSTR_CAT:
             return WCET_CAT_STR_OP;
 
-        case FFI_CALL: case FFI_CALL_STACK:
+        case FFI_CALL: case FFI_CALL_STACK: case FFI_CALL_BATCH:
             return WCET_CAT_FFI;
 
+        // Async FFI only copies parameters / checks a job slot, the call itself runs outside the scan
+        case FFI_START:
+            return WCET_CAT_STR_OP;
+        case FFI_POLL:
+            return WCET_CAT_LOAD;
+
         case EXIT:
             return WCET_CAT_EXIT;
 
@@ -0,0 +1,107 @@
+// runtime-aot.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-tools.h"
+#include "runtime-program.h"
+#include "arithmetics/crc32.h"
+
+#ifdef PLCRUNTIME_AOT_ENABLED
+
+// ============================================================================
+// Ahead-of-time compiled programs
+// ============================================================================
+// The translator (assembly/aot-cpp.h, `npm run aot`) turns a compiled program
+// into C++ source holding the bytecode and one native function. Each basic
+// block becomes straight-line code, every instruction a VovkPLCRuntime::execute()
+// call with a constant opcode that the compiler reduces to the PLCMethods
+// handler of that instruction. Jumps and calls become gotos.
+//
+// The runtime is header-only, so the generated file is included into the sketch
+// after VovkPLCRuntime.h:
+//
+//     #include <VovkPLCRuntime.h>
+//     #include "plc_program.h"            // npm run aot -- --name plc_program
+//     ...
+//     runtime.loadNativeProgram(plc_program);
+//
+// loadNativeProgram() loads the embedded bytecode like loadProgram() does and
+// binds the native function to it. run() executes the native function while the
+// loaded program matches the bytecode it was generated from (size and CRC-32).
+// Memory, the stack, timers and DataBlocks are shared with the interpreter, so
+// monitoring works as before, and a program downloaded later simply runs
+// interpreted.
+//
+// The WASM simulator binds WebAssembly modules the same way: assembly/aot-wasm.h
+// translates the loaded program and the worker places the module's entry in the
+// function table (VovkPLC.compileToWasm()).
+// ============================================================================
+
+class VovkPLCRuntime;
+
+// Native form of a program. Runs from the first instruction and returns like the
+// interpreter: PROGRAM_EXITED, an error, or STATUS_SUCCESS with `index` holding the
+// byte offset where the interpreter continues (prog_size when the program finished).
+typedef RuntimeError (*PLCAotEntry)(VovkPLCRuntime& runtime, u32& index);
+
+struct PLCAotProgram {
+    PLCAotEntry entry;
+    const u8* bytecode; // Program the native code was generated from
+    u32 size;
+    u8 checksum;        // CRC-8 as expected by loadProgram()
+    u32 crc;            // CRC-32 of the bytecode, compared with the loaded program
+};
+
+// Binding between the runtime and the native form of its program
+struct PLCAotBinding {
+    const PLCAotProgram* native = nullptr;
+    u32 revision = 0;   // RuntimeProgram::revision the match was computed for
+    bool checked = false;
+    bool match = false;
+
+    void attach(const PLCAotProgram* program) {
+        native = program;
+        checked = false;
+        match = false;
+    }
+
+    void detach() { attach(nullptr); }
+
+    // True while the loaded program is the one the native code was generated from
+    bool active(const RuntimeProgram& program) {
+        if (!native) return false;
+        if (!checked || revision != program.revision) {
+            checked = true;
+            revision = program.revision;
+            match = program.prog_size == native->size && crc32_update(0, program.program, program.prog_size) == native->crc;
+        }
+        return match;
+    }
+};
+
+// Execute the instruction at byte offset `at` in generated code, leaving on error or EXIT
+#define PLC_AOT_OP(at, opcode) \
+    index = (at) + 1; \
+    status = rt.execute(opcode, program, prog_size, index); \
+    if (status != STATUS_SUCCESS) return status;
+
+#endif // PLCRUNTIME_AOT_ENABLED
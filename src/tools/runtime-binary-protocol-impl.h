@@ -0,0 +1,275 @@
+// runtime-binary-protocol-impl.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+
+template <typename IO>
+void VovkPLCRuntime::pollFrames(IO& io, PLCFramePort& port) {
+    if (port.subscription.count) pushSubscription(io, port);
+    u32 now = (u32) millis();
+    while (io.available() > 0) {
+        int c = io.read();
+        if (c < 0) break;
+        if (port.parser.feed((u8) c, now)) {
+            handleFrame(io, port);
+            return;
+        }
+    }
+}
+
+// Send the subscribed bytes that changed since the last push, as runs of <u16 offset><u8 count><bytes>
+template <typename IO>
+void VovkPLCRuntime::pushSubscription(IO& io, PLCFramePort& port) {
+    PLCFrameSubscription& sub = port.subscription;
+    if (sub.last_scan == scan_count || port.parser.busy()) return;
+    u32 now = (u32) millis();
+    if (sub.valid == sub.total && now - sub.last_push_ms < sub.interval_ms) return;
+    sub.last_scan = scan_count;
+
+    u8* out = port.parser.payload; // Free while no frame is being received
+    const u16 capacity = PLCRUNTIME_BINARY_MAX_PAYLOAD - 1; // Status byte
+    u16 size = 0;
+    u16 offset = 0; // Position in the concatenated ranges
+    i32 run_header = -1; // Output position of the open run header
+    u16 run_end = 0; // Subscription offset right after the open run
+    bool full = false;
+    for (u8 r = 0; r < sub.count && !full; r++) {
+        const u8* source = memory + sub.ranges[r].address;
+        for (u16 i = 0; i < sub.ranges[r].size; i++, offset++) {
+            u8 value = source[i];
+            if (offset < sub.valid && sub.shadow[offset] == value) continue;
+            // Extend the open run over small gaps, a new run costs 3 header bytes
+            if (run_header >= 0 && offset - run_end <= 3 && out[run_header + 2] + (offset - run_end) + 1 <= 255) {
+                u16 gap = offset - run_end;
+                if (size + gap + 1 > capacity) { full = true; break; }
+                for (u16 g = 0; g < gap; g++) out[size++] = sub.shadow[run_end + g];
+                out[run_header + 2] += gap;
+            } else {
+                if (size + 4 > capacity) { full = true; break; }
+                run_header = size;
+                plc_frame_put_u16(out + size, offset);
+                out[size + 2] = 0;
+                size += 3;
+            }
+            out[size++] = value;
+            out[run_header + 2]++;
+            run_end = offset + 1;
+            sub.shadow[offset] = value;
+        }
+    }
+    // When the frame filled up, the rest follows with the next push
+    if (offset > sub.valid) sub.valid = offset;
+    if (size == 0) return;
+    sub.last_push_ms = now;
+    plc_frame_send(io, FRAME_PUSH, sub.sequence++, STATUS_SUCCESS, out, size);
+}
+
+template <typename IO>
+void VovkPLCRuntime::handleFrame(IO& io, PLCFramePort& port) {
+    PLCFrameParser& parser = port.parser;
+    const u8 cmd = parser.command();
+    const u8 seq = parser.sequence();
+    const u8* p = parser.payload;
+    const u16 len = parser.length;
+    u8 reply[52];
+
+    if (parser.crc_error) return plc_frame_send(io, cmd, seq, INVALID_CHECKSUM, nullptr, 0);
+    if (parser.overflow) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_SIZE, nullptr, 0);
+
+    switch (cmd) {
+        case FRAME_HELLO: {
+            reply[0] = PLC_FRAME_VERSION;
+            plc_frame_put_u16(reply + 1, PLCRUNTIME_BINARY_MAX_PAYLOAD);
+            plc_frame_put_u32(reply + 3, PLCRUNTIME_MAX_PROGRAM_SIZE);
+            plc_frame_put_u32(reply + 7, PLCRUNTIME_MAX_MEMORY_SIZE);
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, reply, 11);
+        }
+        case FRAME_HEALTH: {
+            DeviceHealth health;
+            getDeviceHealth(health);
+            const u32 fields[13] = {
+                health.last_cycle_time_us, health.min_cycle_time_us, health.max_cycle_time_us,
+                health.last_ram_free, health.min_ram_free, health.max_ram_free, health.total_ram_size,
+                health.last_period_us, health.min_period_us, health.max_period_us,
+                health.last_jitter_us, health.min_jitter_us, health.max_jitter_us
+            };
+            for (u8 i = 0; i < 13; i++) plc_frame_put_u32(reply + i * 4, fields[i]);
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, reply, 52);
+        }
+        case FRAME_HEALTH_RESET: {
+            resetDeviceHealth();
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, nullptr, 0);
+        }
+        case FRAME_RESET: {
+            plc_frame_send(io, cmd, seq, STATUS_SUCCESS, nullptr, 0);
+            io.flush();
+            processExit();
+            return;
+        }
+        case FRAME_MEMORY_READ: {
+            if (len != 6) return plc_frame_send(io, cmd, seq, INVALID_INSTRUCTION, nullptr, 0);
+            u32 address = plc_frame_u32(p);
+            u16 size = plc_frame_u16(p + 4);
+            if (size > PLCRUNTIME_BINARY_MAX_PAYLOAD - 1) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_SIZE, nullptr, 0);
+            if (address > PLCRUNTIME_MAX_MEMORY_SIZE || size > PLCRUNTIME_MAX_MEMORY_SIZE - address) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_ADDRESS, nullptr, 0);
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, memory + address, size);
+        }
+        case FRAME_MEMORY_WRITE: {
+            if (len < 4) return plc_frame_send(io, cmd, seq, INVALID_INSTRUCTION, nullptr, 0);
+            u32 address = plc_frame_u32(p);
+            u32 size = len - 4;
+            if (address > PLCRUNTIME_MAX_MEMORY_SIZE || size > PLCRUNTIME_MAX_MEMORY_SIZE - address) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_ADDRESS, nullptr, 0);
+            for (u32 i = 0; i < size; i++) memory[address + i] = p[4 + i];
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, nullptr, 0);
+        }
+        case FRAME_MEMORY_WRITE_MASK: {
+            if (len < 4 || (len - 4) % 2) return plc_frame_send(io, cmd, seq, INVALID_INSTRUCTION, nullptr, 0);
+            u32 address = plc_frame_u32(p);
+            u32 size = (len - 4) / 2;
+            if (address > PLCRUNTIME_MAX_MEMORY_SIZE || size > PLCRUNTIME_MAX_MEMORY_SIZE - address) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_ADDRESS, nullptr, 0);
+            const u8* data = p + 4;
+            const u8* mask = data + size;
+            for (u32 i = 0; i < size; i++) memory[address + i] = (memory[address + i] & ~mask[i]) | (data[i] & mask[i]);
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, nullptr, 0);
+        }
+        case FRAME_MEMORY_FORMAT: {
+            if (len != 9) return plc_frame_send(io, cmd, seq, INVALID_INSTRUCTION, nullptr, 0);
+            u32 address = plc_frame_u32(p);
+            u32 size = plc_frame_u32(p + 4);
+            if (address > PLCRUNTIME_MAX_MEMORY_SIZE || size > PLCRUNTIME_MAX_MEMORY_SIZE - address) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_ADDRESS, nullptr, 0);
+            for (u32 i = 0; i < size; i++) memory[address + i] = p[8];
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, nullptr, 0);
+        }
+        case FRAME_PROGRAM_BEGIN: {
+            if (len != 8) return plc_frame_send(io, cmd, seq, INVALID_INSTRUCTION, nullptr, 0);
+            u32 size = plc_frame_u32(p);
+            if (size == 0 || size > PLCRUNTIME_MAX_PROGRAM_SIZE) return plc_frame_send(io, cmd, seq, PROGRAM_SIZE_EXCEEDED, nullptr, 0);
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+            staged.begin(size); // The active program keeps running until the swap
+#else
+            program.format();
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
+            frame_download.active = true;
+            frame_download.size = size;
+            frame_download.crc = plc_frame_u32(p + 4);
+            frame_download.received = 0;
+            frame_download.received_crc = 0;
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, nullptr, 0);
+        }
+        case FRAME_PROGRAM_CHUNK: {
+            if (!frame_download.active) return plc_frame_send(io, cmd, seq, NO_PROGRAM, nullptr, 0);
+            if (len < 4) return plc_frame_send(io, cmd, seq, INVALID_INSTRUCTION, nullptr, 0);
+            u32 offset = plc_frame_u32(p);
+            u32 size = len - 4;
+            RuntimeError status = STATUS_SUCCESS;
+            if (size > 0 && offset + size == frame_download.received) {
+                // Repeated chunk (the reply was lost), acknowledge again
+            } else if (offset != frame_download.received) {
+                status = INVALID_PROGRAM_INDEX;
+            } else if (size > frame_download.size - offset) {
+                status = PROGRAM_SIZE_EXCEEDED;
+            } else {
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+                staged.write(offset, p + 4, size);
+#else
+                for (u32 i = 0; i < size; i++) program.program[offset + i] = p[4 + i];
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
+                frame_download.received_crc = crc32_update(frame_download.received_crc, p + 4, size);
+                frame_download.received += size;
+            }
+            plc_frame_put_u32(reply, frame_download.received);
+            return plc_frame_send(io, cmd, seq, status, reply, 4);
+        }
+        case FRAME_PROGRAM_END: {
+            if (!frame_download.active) return plc_frame_send(io, cmd, seq, NO_PROGRAM, nullptr, 0);
+            frame_download.active = false;
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+            if (frame_download.received != frame_download.size || frame_download.received_crc != frame_download.crc) {
+                staged.cancel();
+                return plc_frame_send(io, cmd, seq, INVALID_CHECKSUM, nullptr, 0);
+            }
+            // Checked and staged, run() swaps it in at the next scan boundary
+            RuntimeError status = staged.commit();
+            if (status != STATUS_SUCCESS) return plc_frame_send(io, cmd, seq, status, nullptr, 0);
+            plc_frame_put_u32(reply, frame_download.size);
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, reply, 4);
+#else
+            if (frame_download.received != frame_download.size || frame_download.received_crc != frame_download.crc) {
+                program.format();
+                return plc_frame_send(io, cmd, seq, INVALID_CHECKSUM, nullptr, 0);
+            }
+            // The bytes are already in place, loadUnsafe() only activates them
+            program.loadUnsafe(program.program, frame_download.size);
+            program.resetLine();
+#ifdef PLCRUNTIME_EEPROM_STORAGE
+            u8 prog_checksum = 0;
+            crc8_simple(prog_checksum, program.program, program.prog_size);
+            if (!EEPROMStorage::saveProgram(program.program, program.prog_size, prog_checksum)) {
+                return plc_frame_send(io, cmd, seq, MEMORY_ACCESS_ERROR, nullptr, 0);
+            }
+#endif // PLCRUNTIME_EEPROM_STORAGE
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+            predecode();
+#endif // PLCRUNTIME_PREDECODE_ENABLED
+            plc_frame_put_u32(reply, program.prog_size);
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, reply, 4);
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
+        }
+        case FRAME_PROGRAM_UPLOAD: {
+            if (len != 6) return plc_frame_send(io, cmd, seq, INVALID_INSTRUCTION, nullptr, 0);
+            u32 offset = plc_frame_u32(p);
+            u16 size = plc_frame_u16(p + 4);
+            if (size > PLCRUNTIME_BINARY_MAX_PAYLOAD - 1) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_SIZE, nullptr, 0);
+            if (offset > program.prog_size || size > program.prog_size - offset) return plc_frame_send(io, cmd, seq, INVALID_PROGRAM_INDEX, nullptr, 0);
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, program.program + offset, size);
+        }
+        case FRAME_SUBSCRIBE: {
+            if (len < 2 || (len - 2) % 6) return plc_frame_send(io, cmd, seq, INVALID_INSTRUCTION, nullptr, 0);
+            PLCFrameSubscription& sub = port.subscription;
+            u16 count = (len - 2) / 6;
+            if (count > PLCRUNTIME_SUBSCRIPTION_MAX_RANGES) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_SIZE, nullptr, 0);
+            u32 total = 0;
+            for (u16 i = 0; i < count; i++) {
+                u32 address = plc_frame_u32(p + 2 + i * 6);
+                u16 size = plc_frame_u16(p + 6 + i * 6);
+                if (address > PLCRUNTIME_MAX_MEMORY_SIZE || size > PLCRUNTIME_MAX_MEMORY_SIZE - address) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_ADDRESS, nullptr, 0);
+                total += size;
+            }
+            if (total > PLCRUNTIME_SUBSCRIPTION_MAX_BYTES) return plc_frame_send(io, cmd, seq, INVALID_MEMORY_SIZE, nullptr, 0);
+            for (u16 i = 0; i < count; i++) {
+                sub.ranges[i].address = plc_frame_u32(p + 2 + i * 6);
+                sub.ranges[i].size = plc_frame_u16(p + 6 + i * 6);
+            }
+            sub.count = (u8) count;
+            sub.total = (u16) total;
+            sub.interval_ms = plc_frame_u16(p);
+            sub.valid = 0;
+            sub.last_scan = scan_count - 1; // Push the initial state right away
+            plc_frame_put_u16(reply, sub.total);
+            return plc_frame_send(io, cmd, seq, STATUS_SUCCESS, reply, 2);
+        }
+        default: return plc_frame_send(io, cmd, seq, UNKNOWN_INSTRUCTION, nullptr, 0);
+    }
+}
+
+#endif // PLCRUNTIME_BINARY_PROTOCOL_ENABLED
@@ -0,0 +1,229 @@
+// runtime-binary-protocol.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-tools.h"
+#include "arithmetics/crc32.h"
+
+#ifdef PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+
+#ifndef PLCRUNTIME_BINARY_MAX_PAYLOAD
+#ifdef __AVR__
+#define PLCRUNTIME_BINARY_MAX_PAYLOAD 64
+#else
+#define PLCRUNTIME_BINARY_MAX_PAYLOAD 512
+#endif // __AVR__
+#endif // PLCRUNTIME_BINARY_MAX_PAYLOAD
+
+#ifndef PLCRUNTIME_SUBSCRIPTION_MAX_RANGES
+#ifdef __AVR__
+#define PLCRUNTIME_SUBSCRIPTION_MAX_RANGES 4
+#else
+#define PLCRUNTIME_SUBSCRIPTION_MAX_RANGES 16
+#endif // __AVR__
+#endif // PLCRUNTIME_SUBSCRIPTION_MAX_RANGES
+
+#ifndef PLCRUNTIME_SUBSCRIPTION_MAX_BYTES
+#ifdef __AVR__
+#define PLCRUNTIME_SUBSCRIPTION_MAX_BYTES 64
+#else
+#define PLCRUNTIME_SUBSCRIPTION_MAX_BYTES 512
+#endif // __AVR__
+#endif // PLCRUNTIME_SUBSCRIPTION_MAX_BYTES
+
+#ifndef PLCRUNTIME_BINARY_FRAME_TIMEOUT_MS
+#define PLCRUNTIME_BINARY_FRAME_TIMEOUT_MS 200
+#endif // PLCRUNTIME_BINARY_FRAME_TIMEOUT_MS
+
+// ============================================================================
+// Binary framed programming protocol
+// ============================================================================
+// Alternative to the hex encoded serial protocol for slow links. Every frame is
+//
+//     A5 <cmd u8> <seq u8> <len u16> <payload[len]> <crc32 u32>
+//
+// with all multi-byte fields little-endian and the CRC-32 taken over everything
+// between the sync byte and the CRC. The sync byte never starts a hex command,
+// so both protocols can share the same port. A host discovers support with the
+// hex command 'BF' and then switches to frames.
+//
+// The reply carries the request command with PLC_FRAME_REPLY set, the same
+// sequence number, and a payload starting with the RuntimeError status byte.
+//
+// Program downloads are streamed: PROGRAM_BEGIN announces the size and CRC-32,
+// PROGRAM_CHUNK frames append in order (each reply reports the bytes received,
+// so a host can resume after a lost frame) and PROGRAM_END verifies and
+// activates the program. The previous program is cleared at PROGRAM_BEGIN;
+// with PLCRUNTIME_ONLINE_CHANGE the download is staged instead and PROGRAM_END
+// only validates it, run() swaps it in at the next scan boundary.
+//
+// Monitoring uses subscriptions instead of polling: SUBSCRIBE registers a set
+// of memory ranges and a minimum interval per port, and after every scan cycle
+// (at most once per interval) the runtime pushes a PUSH frame with only the
+// bytes that changed since the last push. The PUSH payload is a list of runs
+//
+//     <u16 offset> <u8 count> <u8[count] bytes>
+//
+// where the offset indexes the subscribed ranges laid out back to back. The
+// first push after SUBSCRIBE carries every subscribed byte.
+// ============================================================================
+
+#define PLC_FRAME_SYNC 0xA5
+#define PLC_FRAME_REPLY 0x80
+#define PLC_FRAME_VERSION 1
+#define PLC_FRAME_HEADER_SIZE 4 // cmd, seq, len
+
+enum PLCFrameCommand : u8 {
+    FRAME_HELLO = 0x01, //              -> u8 version, u16 max payload, u32 max program size, u32 memory size
+    FRAME_HEALTH = 0x02, //             -> 13 x u32 DeviceHealth fields
+    FRAME_HEALTH_RESET = 0x03,
+    FRAME_RESET = 0x04, //              Restart the runtime after the reply
+    FRAME_MEMORY_READ = 0x10, //        u32 address, u16 size -> u8[size]
+    FRAME_MEMORY_WRITE = 0x11, //       u32 address, u8[] data
+    FRAME_MEMORY_WRITE_MASK = 0x12, //  u32 address, u8[n] data, u8[n] mask
+    FRAME_MEMORY_FORMAT = 0x13, //      u32 address, u32 size, u8 value
+    FRAME_PROGRAM_BEGIN = 0x20, //      u32 size, u32 crc32
+    FRAME_PROGRAM_CHUNK = 0x21, //      u32 offset, u8[] data -> u32 received
+    FRAME_PROGRAM_END = 0x22, //        -> u32 size
+    FRAME_PROGRAM_UPLOAD = 0x23, //     u32 offset, u16 size -> u8[size]
+    FRAME_SUBSCRIBE = 0x30, //          u16 interval ms, { u32 address, u16 size }[] -> u16 total size (no ranges = unsubscribe)
+    FRAME_PUSH = 0x40, //               Sent by the runtime: { u16 offset, u8 count, u8[count] }[]
+};
+
+inline u16 plc_frame_u16(const u8* p) { return (u16) p[0] | ((u16) p[1] << 8); }
+inline u32 plc_frame_u32(const u8* p) { return (u32) p[0] | ((u32) p[1] << 8) | ((u32) p[2] << 16) | ((u32) p[3] << 24); }
+inline void plc_frame_put_u16(u8* p, u16 v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+inline void plc_frame_put_u32(u8* p, u32 v) { p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = v >> 24; }
+
+// Byte-by-byte frame receiver, one per port. Never blocks: feed it whatever is available.
+struct PLCFrameParser {
+    enum State : u8 { WAIT_SYNC = 0, HEADER, PAYLOAD, CRC };
+    State state = WAIT_SYNC;
+    u8 header[PLC_FRAME_HEADER_SIZE];
+    u8 payload[PLCRUNTIME_BINARY_MAX_PAYLOAD];
+    u16 length = 0;
+    u16 received = 0;
+    u32 crc = 0;
+    u32 last_byte_ms = 0;
+    bool crc_error = false; // Set together with a completed frame whose CRC did not match
+    bool overflow = false; // Set together with a completed frame that was longer than the payload buffer
+
+    u8 command() const { return header[0]; }
+    u8 sequence() const { return header[1]; }
+    bool busy() const { return state != WAIT_SYNC; }
+    void reset() { state = WAIT_SYNC; received = 0; }
+
+    // Returns true when a frame is complete; check crc_error and overflow before using it
+    bool feed(u8 b, u32 now_ms) {
+        if (state != WAIT_SYNC && now_ms - last_byte_ms > PLCRUNTIME_BINARY_FRAME_TIMEOUT_MS) reset();
+        last_byte_ms = now_ms;
+        switch (state) {
+            case WAIT_SYNC:
+                if (b == PLC_FRAME_SYNC) {
+                    state = HEADER;
+                    received = 0;
+                    crc_error = false;
+                    overflow = false;
+                }
+                return false;
+            case HEADER:
+                header[received++] = b;
+                if (received < PLC_FRAME_HEADER_SIZE) return false;
+                length = plc_frame_u16(header + 2);
+                overflow = length > PLCRUNTIME_BINARY_MAX_PAYLOAD;
+                crc = crc32_update(0, header, PLC_FRAME_HEADER_SIZE);
+                received = 0;
+                state = length ? PAYLOAD : CRC;
+                return false;
+            case PAYLOAD:
+                // Oversized payloads are still consumed so the reply can report the error
+                if (received < PLCRUNTIME_BINARY_MAX_PAYLOAD) payload[received] = b;
+                crc = crc32_update(crc, b);
+                if (++received < length) return false;
+                received = 0;
+                state = CRC;
+                return false;
+            case CRC: {
+                u8 shift = received * 8;
+                received++;
+                if (((crc >> shift) & 0xFF) != b) crc_error = true;
+                if (received < 4) return false;
+                state = WAIT_SYNC;
+                received = 0;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Memory ranges watched by one port and the bytes last pushed for them
+struct PLCFrameSubscription {
+    struct Range {
+        u32 address;
+        u16 size;
+    };
+    Range ranges[PLCRUNTIME_SUBSCRIPTION_MAX_RANGES];
+    u8 count = 0;
+    u16 total = 0; // Sum of the range sizes
+    u16 interval_ms = 0;
+    u32 last_push_ms = 0;
+    u32 last_scan = 0; // Scan cycle of the last comparison, pushes happen once per cycle
+    u8 sequence = 0;
+    u16 valid = 0; // Shadow holds the pushed state of the first `valid` bytes
+    u8 shadow[PLCRUNTIME_SUBSCRIPTION_MAX_BYTES];
+};
+
+// Frame receiver and subscription of one port (Serial or a transport)
+struct PLCFramePort {
+    PLCFrameParser parser;
+    PLCFrameSubscription subscription;
+};
+
+// State of a streamed program download
+struct PLCFrameDownload {
+    bool active = false;
+    u32 size = 0;
+    u32 crc = 0; // Expected CRC-32 of the whole program
+    u32 received = 0;
+    u32 received_crc = 0; // CRC-32 of the bytes received so far
+};
+
+// Write one reply frame: status byte followed by `size` bytes of data
+template <typename IO>
+void plc_frame_send(IO& io, u8 command, u8 sequence, u8 status, const u8* data, u16 size) {
+    u8 head[PLC_FRAME_HEADER_SIZE + 2];
+    head[0] = PLC_FRAME_SYNC;
+    head[1] = command | PLC_FRAME_REPLY;
+    head[2] = sequence;
+    plc_frame_put_u16(head + 3, size + 1);
+    head[5] = status;
+    u32 crc = crc32_update(0, head + 1, sizeof(head) - 1);
+    crc = crc32_update(crc, data, size);
+    u8 tail[4];
+    plc_frame_put_u32(tail, crc);
+    io.write(head, sizeof(head));
+    if (size) io.write(data, size);
+    io.write(tail, 4);
+}
+
+#endif // PLCRUNTIME_BINARY_PROTOCOL_ENABLED
@@ -49,17 +49,48 @@
 //  - Declared by runtime bytecode on P_First_Cycle via CONFIG_DB instruction
 //  - Managed over Serial API for live updates when program changes
 //  - Migrated (relocated) for seamless program patching
+//  - Laid out for the new program by online program changes (relayout())
+//
+// The table in memory[] stays the source of truth. The manager keeps three
+// RAM structures on top of it:
+//  - a direct-mapped DB number index (db & mask, linear probing), so finding
+//    a DB is O(1) and every hit is checked against the table entry
+//  - the active slots ordered by address (highest first)
+//  - the free list: gaps between the DB regions, allocated best fit
+// A checksum of the table detects entries written from outside the manager
+// (memory writes over the API, formatMemory()); the RAM structures are then
+// rebuilt before they are used.
 
 #ifndef PLCRUNTIME_NUM_OF_DATABLOCKS
 #define PLCRUNTIME_NUM_OF_DATABLOCKS 16
 #endif // PLCRUNTIME_NUM_OF_DATABLOCKS
 
+// Most slots the manager can index, db_setSlotCount() can configure up to 256 in the WASM build
+#ifndef PLCRUNTIME_DB_MAX_SLOTS
+#ifdef __WASM__
+#define PLCRUNTIME_DB_MAX_SLOTS 256
+#else
+#define PLCRUNTIME_DB_MAX_SLOTS PLCRUNTIME_NUM_OF_DATABLOCKS
+#endif // __WASM__
+#endif // PLCRUNTIME_DB_MAX_SLOTS
+
 #define PLCRUNTIME_DB_ENTRY_SIZE 6  // sizeof(u16 db + u16 offset + u16 size)
 #define PLCRUNTIME_DB_TABLE_SIZE (PLCRUNTIME_NUM_OF_DATABLOCKS * PLCRUNTIME_DB_ENTRY_SIZE)
 
 // The DB lookup table starts at this offset (end of memory minus table)
 #define PLCRUNTIME_DB_TABLE_OFFSET (PLCRUNTIME_MAX_MEMORY_SIZE - PLCRUNTIME_DB_TABLE_SIZE)
 
+// Slot reference in the RAM index: slot + 1 in the DB number index (0 = empty bucket), slot in the address order
+#if PLCRUNTIME_DB_MAX_SLOTS < 255
+typedef u8 DBSlotRef;
+#else
+typedef u16 DBSlotRef;
+#endif
+
+// Buckets of the DB number index, the power of two that keeps the load at 50% or less
+constexpr u16 plc_db_index_size(u16 slots, u16 size = 4) { return size >= slots * 2 ? size : plc_db_index_size(slots, (u16) (size * 2)); }
+#define PLCRUNTIME_DB_INDEX_SIZE plc_db_index_size(PLCRUNTIME_DB_MAX_SLOTS)
+
 // ============================================================================
 // DataBlock Manager
 // ============================================================================
@@ -74,13 +105,25 @@ struct DataBlockManager {
     u16 table_offset;     // Start of the DB lookup table in memory
     u16 user_area_end;    // End of the "regular" memory areas (counters end), start of free region
 
+    // RAM structures over the lookup table, rebuilt by sync()
+    DBSlotRef index[PLCRUNTIME_DB_INDEX_SIZE];       // (db & mask) + probe -> slot + 1
+    DBSlotRef by_address[PLCRUNTIME_DB_MAX_SLOTS];   // Active slots, highest offset first
+    u16 active = 0;
+    u16 free_start[PLCRUNTIME_DB_MAX_SLOTS + 1];     // Free list, highest address first
+    u16 free_size[PLCRUNTIME_DB_MAX_SLOTS + 1];
+    u16 free_count = 0;
+    u16 free_slot_hint = 0;                          // Every slot below this one is in use
+    u32 table_check = 0;                             // Checksum of the table the structures describe
+
     // Initialize the manager (call once after memory is available)
     void init(u8* mem, u32 mem_size, u16 slots, u16 area_end) {
+        if (slots > PLCRUNTIME_DB_MAX_SLOTS) slots = PLCRUNTIME_DB_MAX_SLOTS;
         memory = mem;
         memory_size = mem_size;
         num_slots = slots;
         table_offset = (u16)(mem_size - (u32)slots * PLCRUNTIME_DB_ENTRY_SIZE);
         user_area_end = area_end;
+        sync();
     }
 
     // Format (clear) all DB entries - sets all slots to unused (db=0)
@@ -91,6 +134,7 @@ struct DataBlockManager {
             write_u16(memory + entry_addr + 2, 0); // offset = 0
             write_u16(memory + entry_addr + 4, 0); // size = 0
         }
+        sync();
     }
 
     // ========================================================================
@@ -109,6 +153,7 @@ struct DataBlockManager {
     }
 
     // Write a DB entry by slot index
+    // The RAM index catches up on the next lookup miss or allocation (see refresh())
     bool setEntry(u16 slot, u16 db, u16 offset, u16 size) {
         if (slot >= num_slots) return false;
         u16 entry_addr = table_offset + slot * PLCRUNTIME_DB_ENTRY_SIZE;
@@ -118,26 +163,32 @@ struct DataBlockManager {
         return true;
     }
 
+    u16 entryDB(u16 slot) const { return read_u16(memory + table_offset + slot * PLCRUNTIME_DB_ENTRY_SIZE + 0); }
+    u16 entryOffset(u16 slot) const { return read_u16(memory + table_offset + slot * PLCRUNTIME_DB_ENTRY_SIZE + 2); }
+    u16 entrySize(u16 slot) const { return read_u16(memory + table_offset + slot * PLCRUNTIME_DB_ENTRY_SIZE + 4); }
+
     // Find the slot index for a given DB number
     // Returns -1 if not found
-    i16 findSlot(u16 db_number) const {
+    i16 findSlot(u16 db_number) {
         if (db_number == 0) return -1; // DB 0 is reserved as "unused"
-        for (u16 i = 0; i < num_slots; i++) {
-            u16 db, offset, size;
-            getEntry(i, db, offset, size);
-            if (db == db_number) return (i16)i;
-        }
-        return -1;
+        i16 slot = lookup(db_number);
+        if (slot >= 0) return slot;
+        // A miss is only final when nobody changed the table behind the index
+        if (tableChecksum() == table_check) return -1;
+        sync();
+        return lookup(db_number);
     }
 
     // Find first unused slot
     // Returns -1 if all slots are occupied
-    i16 findFreeSlot() const {
-        for (u16 i = 0; i < num_slots; i++) {
-            u16 db, offset, size;
-            getEntry(i, db, offset, size);
-            if (db == 0) return (i16)i;
+    i16 findFreeSlot() {
+        for (u16 i = free_slot_hint; i < num_slots; i++) {
+            if (entryDB(i) == 0) {
+                free_slot_hint = i;
+                return (i16)i;
+            }
         }
+        free_slot_hint = num_slots;
         return -1;
     }
 
@@ -184,6 +235,7 @@ struct DataBlockManager {
 
     // Calculate free space available for new DB allocations.
     // Free space = gap between user_area_end and the lowest DB data address.
+    // Holes left by removed DBs are not counted, declare() reuses them first.
     u16 freeSpace() const {
         u16 lowest = lowestAllocatedAddress();
         if (lowest <= user_area_end) return 0;
@@ -194,34 +246,41 @@ struct DataBlockManager {
     // DataBlock Declaration (allocate)
     // ========================================================================
 
-    // Declare a new DataBlock. Allocates data region growing downward from
-    // the lookup table (or below existing DBs).
+    // Declare a new DataBlock. The region comes from the free list (best fit,
+    // top of the extent), so a fresh table fills downward from the lookup table
+    // and holes left by removed DBs are reused.
     // Returns the slot index on success, -1 on failure.
     // Failure reasons: db_number is 0, already exists, no free slot, not enough space.
     i16 declare(u16 db_number, u16 size) {
         if (db_number == 0) return -1;
         if (size == 0) return -1;
+        refresh();
 
         // Check if already declared
-        i16 existing = findSlot(db_number);
-        if (existing >= 0) return -1; // Already exists
+        if (lookup(db_number) >= 0) return -1; // Already exists
 
         // Find a free slot
         i16 slot = findFreeSlot();
         if (slot < 0) return -1; // No free slot
 
-        // Calculate allocation address (grow downward)
-        u16 lowest = lowestAllocatedAddress();
-        if (size > lowest || (lowest - size) < user_area_end) return -1; // Not enough space
-        u16 new_offset = lowest - size;
+        // Smallest extent that fits, the highest one on a tie
+        i16 best = -1;
+        for (u16 i = 0; i < free_count; i++) {
+            if (free_size[i] < size) continue;
+            if (best < 0 || free_size[i] < free_size[best]) best = (i16)i;
+        }
+        if (best < 0) return -1; // Not enough space
+        free_size[best] -= size;
+        u16 new_offset = free_start[best] + free_size[best];
+        if (free_size[best] == 0) removeFree((u16)best);
 
         // Zero-fill the new DB data region
-        for (u16 i = 0; i < size; i++) {
-            memory[new_offset + i] = 0;
-        }
+        memset(memory + new_offset, 0, size);
 
         // Write the entry
-        setEntry((u16)slot, db_number, new_offset, size);
+        writeEntry((u16)slot, db_number, new_offset, size);
+        indexInsert(db_number, (u16)slot);
+        orderInsert((u16)slot, new_offset);
         return slot;
     }
 
@@ -230,13 +289,19 @@ struct DataBlockManager {
     // ========================================================================
 
     // Remove a DataBlock by DB number, freeing its slot.
-    // Note: This does NOT compact - it just marks the slot as unused.
-    // Data region remains until compacted or overwritten.
+    // Note: This does NOT compact - it marks the slot as unused and returns
+    // the region to the free list. Data remains until reused or compacted.
     // Returns true on success.
     bool remove(u16 db_number) {
-        i16 slot = findSlot(db_number);
+        if (db_number == 0) return false;
+        refresh();
+        i16 slot = lookup(db_number);
         if (slot < 0) return false;
-        setEntry((u16)slot, 0, 0, 0);
+        indexRemove(db_number, (u16)slot);
+        orderRemove((u16)slot);
+        writeEntry((u16)slot, 0, 0, 0);
+        if ((u16)slot < free_slot_hint) free_slot_hint = (u16)slot;
+        rebuildFreeList();
         return true;
     }
 
@@ -246,7 +311,7 @@ struct DataBlockManager {
 
     // Read data from a DataBlock at a relative offset within the DB.
     // Returns false on error (DB not found, out of range).
-    bool readDB(u16 db_number, u16 db_offset, u8* dest, u16 count) const {
+    bool readDB(u16 db_number, u16 db_offset, u8* dest, u16 count) {
         i16 slot = findSlot(db_number);
         if (slot < 0) return false;
 
@@ -260,9 +325,7 @@ struct DataBlockManager {
         u32 abs_addr = (u32)base_offset + (u32)db_offset;
         if (abs_addr + count > memory_size) return false;
 
-        for (u16 i = 0; i < count; i++) {
-            dest[i] = memory[abs_addr + i];
-        }
+        memcpy(dest, memory + abs_addr, count);
         return true;
     }
 
@@ -281,16 +344,14 @@ struct DataBlockManager {
         u32 abs_addr = (u32)base_offset + (u32)db_offset;
         if (abs_addr + count > memory_size) return false;
 
-        for (u16 i = 0; i < count; i++) {
-            memory[abs_addr + i] = src[i];
-        }
+        memcpy(memory + abs_addr, src, count);
         return true;
     }
 
     // Get the absolute memory address for a DB + relative offset.
     // Returns 0xFFFF on error. Useful for bytecode instructions that
     // need to resolve DB addresses to flat memory addresses.
-    u16 resolveAddress(u16 db_number, u16 db_offset) const {
+    u16 resolveAddress(u16 db_number, u16 db_offset) {
         i16 slot = findSlot(db_number);
         if (slot < 0) return 0xFFFF;
 
@@ -313,7 +374,9 @@ struct DataBlockManager {
     // target_offset: the new absolute memory address for the DB data.
     // Returns true on success.
     bool migrate(u16 db_number, u16 target_offset) {
-        i16 slot = findSlot(db_number);
+        if (db_number == 0) return false;
+        refresh();
+        i16 slot = lookup(db_number);
         if (slot < 0) return false;
 
         u16 db, old_offset, db_size;
@@ -324,45 +387,71 @@ struct DataBlockManager {
         if (target_offset < user_area_end) return false;
 
         // Check target doesn't overlap any other active DB
-        for (u16 i = 0; i < num_slots; i++) {
-            if (i == (u16)slot) continue; // Skip self
-            u16 other_db, other_offset, other_size;
-            getEntry(i, other_db, other_offset, other_size);
-            if (other_db == 0) continue;
-            // Check for overlap: [target_offset, target_offset+db_size) vs [other_offset, other_offset+other_size)
-            u16 target_end = target_offset + db_size;
-            u16 other_end = other_offset + other_size;
+        u16 target_end = target_offset + db_size;
+        for (u16 i = 0; i < active; i++) {
+            u16 other = by_address[i];
+            if (other == (u16)slot) continue; // Skip self
+            u16 other_offset = entryOffset(other);
+            u16 other_end = other_offset + entrySize(other);
             if (target_offset < other_end && target_end > other_offset) return false; // Overlap
         }
 
-        // Copy data (handle overlapping regions safely with direction check)
-        if (target_offset < old_offset) {
-            // Copy forward (low to high)
-            for (u16 i = 0; i < db_size; i++) {
-                memory[target_offset + i] = memory[old_offset + i];
-            }
-        } else if (target_offset > old_offset) {
-            // Copy backward (high to low)
-            for (i16 i = (i16)db_size - 1; i >= 0; i--) {
-                memory[target_offset + (u16)i] = memory[old_offset + (u16)i];
-            }
-        }
-        // If target == old, no copy needed
-
-        // Zero-fill old location (only the parts that don't overlap with new)
         if (target_offset != old_offset) {
+            memmove(memory + target_offset, memory + old_offset, db_size);
+            // Zero-fill the part of the old location the new one does not cover
             u16 old_end = old_offset + db_size;
-            u16 new_end = target_offset + db_size;
-            for (u16 addr = old_offset; addr < old_end; addr++) {
-                // Only zero if not in new region
-                if (addr < target_offset || addr >= new_end) {
-                    memory[addr] = 0;
-                }
+            if (target_offset < old_offset) {
+                u16 from = target_end > old_offset ? target_end : old_offset;
+                memset(memory + from, 0, old_end - from);
+            } else {
+                u16 to = target_offset < old_end ? target_offset : old_end;
+                memset(memory + old_offset, 0, to - old_offset);
             }
         }
 
         // Update the lookup table entry
-        setEntry((u16)slot, db_number, target_offset, db_size);
+        writeEntry((u16)slot, db_number, target_offset, db_size);
+        orderRemove((u16)slot);
+        orderInsert((u16)slot, target_offset);
+        rebuildFreeList();
+        return true;
+    }
+
+    // Change the size of a DataBlock, keeping its data. A DB that shrinks stays
+    // where it is; one that grows is reallocated best fit with its own region
+    // counted as free, the bytes it gains are zeroed.
+    // Returns true on success, false if the DB does not exist or does not fit.
+    bool resize(u16 db_number, u16 new_size) {
+        if (db_number == 0 || new_size == 0) return false;
+        refresh();
+        i16 slot = lookup(db_number);
+        if (slot < 0) return false;
+        u16 db, old_offset, old_size;
+        getEntry((u16)slot, db, old_offset, old_size);
+        if (new_size == old_size) return true;
+
+        u16 new_offset = old_offset;
+        if (new_size > old_size) {
+            // Look for room with the DB taken out of the address order
+            orderRemove((u16)slot);
+            rebuildFreeList();
+            i16 best = -1;
+            for (u16 i = 0; i < free_count; i++) {
+                if (free_size[i] < new_size) continue;
+                if (best < 0 || free_size[i] < free_size[best]) best = (i16)i;
+            }
+            if (best < 0) {
+                orderInsert((u16)slot, old_offset);
+                rebuildFreeList();
+                return false; // Not enough space
+            }
+            new_offset = free_start[best] + free_size[best] - new_size;
+            memmove(memory + new_offset, memory + old_offset, old_size);
+            memset(memory + new_offset + old_size, 0, new_size - old_size);
+            orderInsert((u16)slot, new_offset);
+        }
+        writeEntry((u16)slot, db_number, new_offset, new_size);
+        rebuildFreeList();
         return true;
     }
 
@@ -370,57 +459,99 @@ struct DataBlockManager {
     // tightly against the lookup table. This maximizes free space.
     // Returns the new lowest allocated address.
     u16 compact() {
-        // Sort active entries by current offset (descending - highest first)
-        // Then pack them downward from the table
+        refresh();
+        // Walk the DBs from the highest address down and pack each one just
+        // below the previous, so a DB only ever moves up and the order holds
         u16 pack_addr = table_offset;
-
-        // Simple approach: repeatedly find the DB with the highest offset
-        // and pack it just below the current pack_addr.
-        // Use a visited flag via a small bitmask.
-        u32 visited = 0; // Supports up to 32 slots
-
-        for (u16 pass = 0; pass < num_slots; pass++) {
-            i16 best_slot = -1;
-            u16 best_offset = 0;
-
-            for (u16 i = 0; i < num_slots && i < 32; i++) {
-                if (visited & ((u32)1 << i)) continue;
-                u16 db, offset, size;
-                getEntry(i, db, offset, size);
-                if (db == 0) {
-                    visited |= ((u32)1 << i);
-                    continue;
-                }
-                if (best_slot < 0 || offset > best_offset) {
-                    best_slot = (i16)i;
-                    best_offset = offset;
-                }
+        for (u16 i = 0; i < active; i++) {
+            u16 slot = by_address[i];
+            u16 db, offset, size;
+            getEntry(slot, db, offset, size);
+            u16 target = pack_addr - size;
+            if (target != offset) {
+                memmove(memory + target, memory + offset, size);
+                writeEntry(slot, db, target, size);
             }
+            pack_addr = target;
+        }
+        rebuildFreeList();
+        return pack_addr;
+    }
 
-            if (best_slot < 0) break; // No more active DBs
-            visited |= ((u32)1 << (u16)best_slot);
+    // Lay the DataBlocks out the way a compiled program addresses them: `count`
+    // DBs packed downward from the lookup table in the given order, in slots
+    // 0..count-1. Each DB keeps its data, cut off where it shrinks and zeroed
+    // where it grows or is new. DBs missing from the list are removed.
+    // Returns false with nothing changed if a DB number is 0 or repeats, a size
+    // is 0, or the layout does not fit.
+    bool relayout(const u16* numbers, const u16* sizes, u16 count) {
+        if (count > num_slots) return false;
+        u32 total = 0;
+        for (u16 i = 0; i < count; i++) {
+            if (numbers[i] == 0 || sizes[i] == 0) return false;
+            for (u16 j = 0; j < i; j++) if (numbers[j] == numbers[i]) return false;
+            total += sizes[i];
+        }
+        if (table_offset < user_area_end || total > (u32)(table_offset - user_area_end)) return false;
+        refresh();
 
-            u16 db, offset, size;
-            getEntry((u16)best_slot, db, offset, size);
+        // Current region of each listed DB, size 0 for new ones
+        u16 at[PLCRUNTIME_DB_MAX_SLOTS];
+        u16 old_size[PLCRUNTIME_DB_MAX_SLOTS];
+        for (u16 i = 0; i < count; i++) {
+            i16 slot = lookup(numbers[i]);
+            at[i] = table_offset;
+            old_size[i] = 0;
+            if (slot < 0) continue;
+            u16 offset = entryOffset((u16)slot);
+            u16 size = entrySize((u16)slot);
+            if (offset < user_area_end || (u32)offset + size > table_offset) continue; // Not a region the manager owns
+            at[i] = offset;
+            old_size[i] = size;
+        }
 
-            u16 target = pack_addr - size;
-            if (target != offset) {
-                // Move the data
-                if (target < offset) {
-                    for (u16 j = 0; j < size; j++)
-                        memory[target + j] = memory[offset + j];
-                } else {
-                    for (i16 j = (i16)size - 1; j >= 0; j--)
-                        memory[target + (u16)j] = memory[offset + (u16)j];
+        // Bring the listed DBs against the table in list order, old sizes kept. Rotating
+        // [at, top) puts the DB on top and shifts everything above it down, so the DBs
+        // still to place always stay below `top`.
+        u16 top = table_offset;
+        for (u16 i = 0; i < count; i++) {
+            u16 size = old_size[i];
+            if (size == 0) continue;
+            u16 from = at[i];
+            if (from + size != top) {
+                rotate(from, top, size);
+                for (u16 j = i + 1; j < count; j++) {
+                    if (old_size[j] > 0 && at[j] > from && at[j] < top) at[j] -= size;
                 }
-                // Update entry
-                setEntry((u16)best_slot, db, target, size);
             }
+            top -= size;
+            at[i] = top;
+        }
 
-            pack_addr = target;
+        // Move every DB to its final offset. Both layouts are packed in the same order,
+        // so DBs moving up go first from the top and DBs moving down from the bottom.
+        u16 target[PLCRUNTIME_DB_MAX_SLOTS];
+        top = table_offset;
+        for (u16 i = 0; i < count; i++) {
+            top -= sizes[i];
+            target[i] = top;
+        }
+        for (u16 i = 0; i < count; i++) {
+            if (old_size[i] > 0 && target[i] >= at[i]) memmove(memory + target[i], memory + at[i], old_size[i] < sizes[i] ? old_size[i] : sizes[i]);
+        }
+        for (u16 i = count; i-- > 0;) {
+            if (old_size[i] > 0 && target[i] < at[i]) memmove(memory + target[i], memory + at[i], old_size[i] < sizes[i] ? old_size[i] : sizes[i]);
+        }
+        for (u16 i = 0; i < count; i++) {
+            if (sizes[i] > old_size[i]) memset(memory + target[i] + old_size[i], 0, sizes[i] - old_size[i]);
         }
 
-        return pack_addr;
+        for (u16 slot = 0; slot < num_slots; slot++) {
+            if (slot < count) setEntry(slot, numbers[slot], target[slot], sizes[slot]);
+            else setEntry(slot, 0, 0, 0);
+        }
+        sync();
+        return true;
     }
 
     // ========================================================================
@@ -433,18 +564,166 @@ struct DataBlockManager {
     // Validates against PLCRUNTIME_MAX_MEMORY_SIZE.
     bool safeRead(u16 address, u8* dest, u16 count) const {
         if ((u32)address + (u32)count > memory_size) return false;
-        for (u16 i = 0; i < count; i++) {
-            dest[i] = memory[address + i];
-        }
+        memcpy(dest, memory + address, count);
         return true;
     }
 
     // Write bytes to an absolute memory address with bounds checking.
     bool safeWrite(u16 address, const u8* src, u16 count) {
         if ((u32)address + (u32)count > memory_size) return false;
-        for (u16 i = 0; i < count; i++) {
-            memory[address + i] = src[i];
-        }
+        memcpy(memory + address, src, count);
         return true;
     }
+
+    // ========================================================================
+    // RAM index maintenance
+    // ========================================================================
+
+    // Rebuild the DB number index, the address order and the free list from the table
+    void sync() {
+        for (u16 i = 0; i < PLCRUNTIME_DB_INDEX_SIZE; i++) index[i] = 0;
+        active = 0;
+        table_check = 0;
+        free_slot_hint = num_slots;
+        for (u16 slot = 0; slot < num_slots; slot++) {
+            u16 db, offset, size;
+            getEntry(slot, db, offset, size);
+            table_check += entryCheck(slot, db, offset, size);
+            if (db == 0) {
+                if (slot < free_slot_hint) free_slot_hint = slot;
+                continue;
+            }
+            // A repeated DB number keeps its region, lookups find the first slot
+            if (lookup(db) < 0) indexInsert(db, slot);
+            orderInsert(slot, offset);
+        }
+        rebuildFreeList();
+    }
+
+    // Rebuild the RAM structures if the table was changed from outside the manager
+    void refresh() {
+        if (tableChecksum() != table_check) sync();
+    }
+
+    // Index probe, every candidate is checked against the table entry
+    i16 lookup(u16 db_number) const {
+        const u16 mask = PLCRUNTIME_DB_INDEX_SIZE - 1;
+        for (u16 i = db_number & mask; index[i] != 0; i = (i + 1) & mask) {
+            u16 slot = index[i] - 1;
+            if (entryDB(slot) == db_number) return (i16)slot;
+        }
+        return -1;
+    }
+
+    void indexInsert(u16 db_number, u16 slot) {
+        const u16 mask = PLCRUNTIME_DB_INDEX_SIZE - 1;
+        u16 i = db_number & mask;
+        while (index[i] != 0) i = (i + 1) & mask;
+        index[i] = (DBSlotRef)(slot + 1);
+    }
+
+    // Remove a slot from the index while its table entry still holds db_number
+    void indexRemove(u16 db_number, u16 slot) {
+        const u16 mask = PLCRUNTIME_DB_INDEX_SIZE - 1;
+        u16 i = db_number & mask;
+        while (index[i] != 0 && index[i] != slot + 1) i = (i + 1) & mask;
+        if (index[i] == 0) return;
+        // Backward shift: pull later entries of the probe run into the hole,
+        // unless their home bucket lies between the hole and their position
+        for (u16 j = (i + 1) & mask; index[j] != 0; j = (j + 1) & mask) {
+            u16 home = entryDB(index[j] - 1) & mask;
+            bool stays = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+            if (stays) continue;
+            index[i] = index[j];
+            i = j;
+        }
+        index[i] = 0;
+    }
+
+    // Insert from the low end, DBs are usually declared below the previous one
+    void orderInsert(u16 slot, u16 offset) {
+        u16 pos = active;
+        while (pos > 0 && entryOffset(by_address[pos - 1]) < offset) {
+            by_address[pos] = by_address[pos - 1];
+            pos--;
+        }
+        by_address[pos] = (DBSlotRef)slot;
+        active++;
+    }
+
+    void orderRemove(u16 slot) {
+        u16 pos = 0;
+        while (pos < active && by_address[pos] != slot) pos++;
+        if (pos == active) return;
+        active--;
+        memmove(by_address + pos, by_address + pos + 1, (active - pos) * sizeof(DBSlotRef));
+    }
+
+    // Free list = the gaps between the DB regions, from the table down to user_area_end
+    void rebuildFreeList() {
+        free_count = 0;
+        u16 top = table_offset;
+        for (u16 i = 0; i < active; i++) {
+            u16 offset = entryOffset(by_address[i]);
+            u32 end = (u32)offset + entrySize(by_address[i]);
+            if (end < top) addFree(end > user_area_end ? (u16)end : user_area_end, top);
+            if (offset < top) top = offset;
+        }
+        addFree(user_area_end, top);
+    }
+
+    void addFree(u16 start, u16 end) {
+        if (end <= start) return;
+        free_start[free_count] = start;
+        free_size[free_count] = end - start;
+        free_count++;
+    }
+
+    void removeFree(u16 i) {
+        free_count--;
+        memmove(free_start + i, free_start + i + 1, (free_count - i) * sizeof(u16));
+        memmove(free_size + i, free_size + i + 1, (free_count - i) * sizeof(u16));
+    }
+
+    // Rotate memory[from, to) left by `shift` bytes in place
+    void rotate(u16 from, u16 to, u16 shift) {
+        reverse(from, from + shift);
+        reverse(from + shift, to);
+        reverse(from, to);
+    }
+
+    void reverse(u16 from, u16 to) {
+        if (to - from < 2) return;
+        u8* a = memory + from;
+        u8* b = memory + to - 1;
+        while (a < b) {
+            u8 t = *a;
+            *a++ = *b;
+            *b-- = t;
+        }
+    }
+
+    // setEntry() for the manager's own changes, keeps the table checksum current
+    void writeEntry(u16 slot, u16 db, u16 offset, u16 size) {
+        u16 old_db, old_offset, old_size;
+        getEntry(slot, old_db, old_offset, old_size);
+        table_check -= entryCheck(slot, old_db, old_offset, old_size);
+        setEntry(slot, db, offset, size);
+        table_check += entryCheck(slot, db, offset, size);
+    }
+
+    static u32 entryCheck(u16 slot, u16 db, u16 offset, u16 size) {
+        if (db == 0) return 0; // Unused slots only count as unused
+        return ((((u32)db << 16) | offset) * 2654435761u) ^ ((((u32)size << 16) | slot) * 2246822519u);
+    }
+
+    u32 tableChecksum() const {
+        u32 check = 0;
+        for (u16 i = 0; i < num_slots; i++) {
+            u16 db, offset, size;
+            getEntry(i, db, offset, size);
+            check += entryCheck(i, db, offset, size);
+        }
+        return check;
+    }
 };
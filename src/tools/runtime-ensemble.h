@@ -0,0 +1,603 @@
+// runtime-ensemble.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef PLCRUNTIME_ENSEMBLE_ENABLED
+
+// ============================================================================
+// Lockstep ensemble execution
+// ============================================================================
+// Runs the program of one runtime over many memory images ("lanes") at once,
+// for test-vector sweeps and virtual commissioning. Lane memory and the data
+// stack are stored structure-of-arrays: byte `address` of lane `l` lives at
+// memory[address * lanes + l], so every instruction becomes a loop over a
+// contiguous row of lanes that the compiler can vectorize.
+//
+// The program must pass the load-time verifier (runtime-verifier.h). Its stack
+// depth before every instruction is then a constant, the same for all lanes,
+// and the stack needs no per-lane pointer. Constants, LOAD_FROM/MOVE_TO, MEM_FILL, bit
+// access, boolean logic, the branch stack, typed ADD/SUB/MUL and comparisons (also fused)
+// run as lane loops. Other stack-only instructions (DIV, CVT, bitwise, ...) are
+// executed lane by lane through step(). At a branch the lanes disagree on, an
+// instruction that failed in some lanes, or any other instruction (timers,
+// calls, strings, FFI, ...) the rest of the cycle runs lane by lane on the
+// runtime itself, with the lane's memory image copied in and out.
+//
+//   PLCEnsemble ensemble;                       // Large, keep it static
+//   runtime.loadProgram(program, size, checksum);
+//   ensemble.load(runtime);
+//   ensemble.attach(memory, 1024, lanes, stack, br, status); // Caller-owned buffers
+//   for (lane...) ensemble.scatter(lane, image);
+//   ensemble.run();                             // One scan cycle of every lane
+//
+// A cycle executes the program only: no clock, process image or online change
+// handling as in VovkPLCRuntime::run(). The runtime's memory is scratch space
+// for the lane-by-lane path, addresses past the lane memory size are shared by
+// all lanes there.
+// ============================================================================
+
+class PLCEnsemble {
+public:
+    // Bind to the verified program loaded in `runtime`. NO_PROGRAM when nothing is
+    // decoded, INVALID_STACK_SIZE when the verifier could not prove the program
+    RuntimeError load(VovkPLCRuntime& runtime);
+
+    // Lane storage, owned by the caller:
+    //   memory  memory_size * lanes bytes
+    //   stack   stackBytes() * lanes bytes
+    //   br      one branch stack (VovkPLCRuntime::BR) per lane
+    //   status  result of the last cycle per lane
+    // INVALID_MEMORY_ADDRESS when the program addresses memory past memory_size
+    RuntimeError attach(u8* memory, u32 memory_size, u32 lanes, u8* stack, u32* br, RuntimeError* status);
+
+    // Stack bytes per lane the program needs
+    u32 stackBytes() const { return max_stack; }
+
+    // Copy a plain memory image (memory_size bytes) into or out of a lane
+    void scatter(u32 lane, const u8* image);
+    void gather(u32 lane, u8* image) const;
+    u8 read(u32 lane, u32 address) const { return memory[address * lanes + lane]; }
+    void write(u32 lane, u32 address, u8 value) { memory[address * lanes + lane] = value; }
+
+    // One scan cycle of every lane. Returns the number of lanes that stopped with an error
+    u32 run();
+
+    // Statistics of the last run()
+    u32 vector_steps = 0;   // Instructions executed for all lanes at once
+    u32 lane_steps = 0;     // Instructions executed lane by lane
+    bool diverged = false;  // The cycle finished lane by lane
+
+private:
+    enum Kernel : u8 {
+        K_LANE = 0,   // Finish the cycle lane by lane
+        K_NOP,
+        K_EXIT,
+        K_PUSH,
+        K_LOAD,
+        K_MOVE,
+        K_FILL,
+        K_READ_BIT,
+        K_WRITE_BIT,
+        K_SET_BIT,
+        K_RESET_BIT,
+        K_INVERT_BIT,
+        K_AND,
+        K_OR,
+        K_XOR,
+        K_NOT,
+        K_BR_SAVE,
+        K_BR_READ,
+        K_BR_DROP,
+        K_BR_CLR,
+        K_TYPED,      // ADD/SUB/MUL/CMP_* with a type the lane loops handle
+        K_LOAD_CMP,   // LOAD_CMP_IMM
+        K_STACK,      // Stack-only instruction executed through step() per lane
+        K_JMP,
+        K_JMP_IF,
+        K_JMP_IF_NOT,
+        K_LOAD_CMP_JMP, // LOAD_CMP_IMM_JMP_IF_NOT
+    };
+
+    struct Step {
+        u8 kernel;
+        u8 width;     // Operand bytes, bit index for bit access
+        u8 type;      // Data type of K_TYPED and K_LOAD_CMP
+        u8 opcode;    // Comparison of the fused LOAD_CMP_IMM forms
+        u16 depth;    // Stack bytes before the instruction
+        u16 target;   // Jump target record, MEM_FILL length
+        u32 arg;      // Memory address
+        u8 value[8];  // Immediate of K_PUSH, K_FILL and K_LOAD_CMP
+    };
+
+    Step steps[PLCRUNTIME_PREDECODE_MAX_OPS];
+    u8 scratch[PLCRUNTIME_MAX_STACK_SIZE];
+    VovkPLCRuntime* runtime = nullptr;
+    u32 revision = 0;
+    u32 count = 0;
+    u32 max_stack = 0;
+    u32 memory_end = 0; // Highest memory byte the lane loops touch, plus one
+    u8* memory = nullptr;
+    u32 memory_size = 0;
+    u32 lanes = 0;
+    u8* stack = nullptr;
+    u32* br = nullptr;
+    RuntimeError* status = nullptr;
+
+    static bool typedSupported(u8 type);
+    static bool stackOnly(u8 opcode);
+    void classify(const u8* program, const PLCDecodedProgram& d, u32 record, Step& s);
+
+    template <typename T> static T laneGet(const u8* row, u32 lanes, u32 lane) {
+        u8 raw[sizeof(T)];
+        for (u32 b = 0; b < sizeof(T); b++) raw[b] = row[b * lanes + lane];
+        T value;
+        memcpy(&value, raw, sizeof(T));
+        return value;
+    }
+    template <typename T> static void lanePut(u8* row, u32 lanes, u32 lane, T value) {
+        u8 raw[sizeof(T)];
+        memcpy(raw, &value, sizeof(T));
+        for (u32 b = 0; b < sizeof(T); b++) row[b * lanes + lane] = raw[b];
+    }
+    template <typename T, typename R, R(*Fn)(T, T)> void binary(u8* a);
+    template <typename T> void typed(u8 opcode, u8* a);
+    void typedStep(u8 type, u8 opcode, u8* a);
+
+    u32 stackStep(const Step& s, u32 offset);
+    void runLanes(u32 record, u32 depth);
+    u32 failures() const;
+};
+
+RuntimeError PLCEnsemble::load(VovkPLCRuntime& rt) {
+    runtime = nullptr;
+    memory = nullptr;
+    PLCDecodedProgram& d = rt.decoded;
+    if (!d.valid || d.revision != rt.program.revision || d.count == 0) return NO_PROGRAM;
+    if (!d.verified || !rt.verifier.entryDepths(d, rt.program.program)) return INVALID_STACK_SIZE;
+    count = d.count;
+    max_stack = d.max_stack;
+    memory_end = 0;
+    runtime = &rt;
+    for (u32 r = 0; r < count; r++) classify(rt.program.program, d, r, steps[r]);
+    revision = rt.program.revision;
+    return STATUS_SUCCESS;
+}
+
+RuntimeError PLCEnsemble::attach(u8* memory, u32 memory_size, u32 lanes, u8* stack, u32* br, RuntimeError* status) {
+    this->memory = nullptr;
+    if (!runtime) return NO_PROGRAM;
+    if (memory_end > memory_size || memory_size > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+    if (!memory || !br || !status || lanes == 0 || (max_stack > 0 && !stack)) return INVALID_MEMORY_SIZE;
+    this->memory = memory;
+    this->memory_size = memory_size;
+    this->lanes = lanes;
+    this->stack = stack;
+    this->br = br;
+    this->status = status;
+    for (u32 l = 0; l < lanes; l++) {
+        br[l] = 0;
+        status[l] = STATUS_SUCCESS;
+    }
+    return STATUS_SUCCESS;
+}
+
+void PLCEnsemble::scatter(u32 lane, const u8* image) {
+    for (u32 a = 0; a < memory_size; a++) memory[a * lanes + lane] = image[a];
+}
+
+void PLCEnsemble::gather(u32 lane, u8* image) const {
+    for (u32 a = 0; a < memory_size; a++) image[a] = memory[a * lanes + lane];
+}
+
+// Same type set as the pre-decoded typed handlers
+bool PLCEnsemble::typedSupported(u8 type) {
+    switch (type) {
+        case type_bool: case type_u8: case type_i8: case type_u16: case type_i16:
+#ifdef PLCRUNTIME_32BIT_OPS_ENABLED
+        case type_u32: case type_i32:
+#endif // PLCRUNTIME_32BIT_OPS_ENABLED
+#ifdef PLCRUNTIME_FLOAT_OPS_ENABLED
+        case type_f32:
+#endif // PLCRUNTIME_FLOAT_OPS_ENABLED
+#ifdef USE_X64_OPS
+        case type_u64: case type_i64: case type_f64:
+#endif // USE_X64_OPS
+            return true;
+        default: return false;
+    }
+}
+
+// Instructions whose handlers only touch the data stack
+bool PLCEnsemble::stackOnly(u8 opcode) {
+    if (opcode >= GET_X8_B0 && opcode <= RSET_X8_B7) return true;
+    if (opcode >= BW_AND_X8 && opcode <= BW_RSHIFT_X64) return true;
+    switch (opcode) {
+        case CVT: case COPY: case SWAP: case DROP:
+        case ADD: case SUB: case MUL: case DIV: case MOD: case POW:
+        case ABS: case NEG: case SQRT: case SIN: case COS:
+        case CMP_EQ: case CMP_NEQ: case CMP_GT: case CMP_GTE: case CMP_LT: case CMP_LTE:
+            return true;
+        default: return false;
+    }
+}
+
+void PLCEnsemble::classify(const u8* program, const PLCDecodedProgram& d, u32 record, Step& s) {
+    const u32 offset = d.ops[record].offset;
+    const u8 opcode = program[offset];
+    const u8* p = program + offset + 1;
+    const i16 depth = runtime->verifier.depth[record];
+    s.kernel = K_LANE;
+    s.width = 0;
+    s.type = 0;
+    s.opcode = opcode;
+    s.depth = depth < 0 ? 0 : (u16) depth;
+    s.target = 0;
+    s.arg = 0;
+    if (depth < 0) return; // Only reached through calls, runs lane by lane
+
+    if (opcode >= READ_X8_B0 && opcode <= WRITE_INV_X8_B7) {
+        static const u8 kernels[5] = { K_READ_BIT, K_WRITE_BIT, K_SET_BIT, K_RESET_BIT, K_INVERT_BIT };
+        s.arg = read_ptr(p);
+        s.width = (opcode - READ_X8_B0) % 8;
+        s.kernel = kernels[(opcode - READ_X8_B0) / 8];
+        if (s.arg + 1 > memory_end) memory_end = s.arg + 1;
+        return;
+    }
+
+    switch (opcode) {
+        case NOP:
+        case LANG:
+        case COMMENT:
+        case CLEAR: s.kernel = K_NOP; return; // Depths are static, CLEAR only resets them
+        case EXIT: s.kernel = K_EXIT; return;
+
+        case type_bool: case type_u8: case type_i8: case type_u16: case type_i16:
+        case type_u32: case type_i32: case type_f32: case type_u64: case type_i64: case type_f64:
+            s.width = plc_verify_type_size(opcode);
+            for (u32 b = 0; b < s.width; b++) s.value[b] = p[b];
+            if (opcode == type_bool) s.value[0] = p[0] ? 1 : 0;
+            s.kernel = K_PUSH;
+            return;
+
+        case MEM_FILL: {
+            const u32 length = read_ptr(p + 1 + MY_PTR_SIZE_BYTES);
+            s.value[0] = p[0];
+            s.arg = read_ptr(p + 1);
+            s.target = (u16) length;
+            if (s.arg + length > memory_end) memory_end = s.arg + length;
+            s.kernel = K_FILL;
+            return;
+        }
+
+        case LOAD_CMP_IMM:
+        case LOAD_CMP_IMM_JMP_IF_NOT: {
+            if (p[0] < CMP_EQ || p[0] > CMP_LTE || !typedSupported(p[1])) return;
+            u32 target = 0;
+            if (opcode == LOAD_CMP_IMM_JMP_IF_NOT && (!PLCVerifier::target(d, program, offset, target) || runtime->verifier.depth[target] < 0)) return;
+            s.opcode = p[0];
+            s.type = p[1];
+            s.width = plc_verify_type_size(p[1]);
+            s.arg = read_ptr(p + 2);
+            for (u32 b = 0; b < s.width; b++) s.value[b] = p[2 + MY_PTR_SIZE_BYTES + b];
+            s.target = (u16) target;
+            if (s.arg + s.width > memory_end) memory_end = s.arg + s.width;
+            if (s.depth + 2u * s.width > max_stack) max_stack = s.depth + 2u * s.width; // Both operands are staged on the stack
+            s.kernel = opcode == LOAD_CMP_IMM ? K_LOAD_CMP : K_LOAD_CMP_JMP;
+            return;
+        }
+
+        case LOAD_FROM:
+        case MOVE_TO:
+            if (!typedSupported(p[0])) return;
+            s.width = plc_verify_type_size(p[0]);
+            s.arg = read_ptr(p + 1);
+            if (s.arg + s.width > memory_end) memory_end = s.arg + s.width;
+            s.kernel = opcode == LOAD_FROM ? K_LOAD : K_MOVE;
+            return;
+
+        case LOGIC_AND: s.kernel = K_AND; return;
+        case LOGIC_OR: s.kernel = K_OR; return;
+        case LOGIC_XOR: s.kernel = K_XOR; return;
+        case LOGIC_NOT: s.kernel = K_NOT; return;
+        case BR_SAVE: s.kernel = K_BR_SAVE; return;
+        case BR_READ: s.kernel = K_BR_READ; return;
+        case BR_DROP: s.kernel = K_BR_DROP; return;
+        case BR_CLR: s.kernel = K_BR_CLR; return;
+
+        case ADD: case SUB: case MUL:
+        case CMP_EQ: case CMP_NEQ: case CMP_GT: case CMP_GTE: case CMP_LT: case CMP_LTE:
+            if (typedSupported(p[0])) {
+                s.type = p[0];
+                s.width = plc_verify_type_size(p[0]);
+                s.kernel = K_TYPED;
+                return;
+            }
+            break;
+
+        case JMP: case JMP_REL:
+        case JMP_IF: case JMP_IF_REL:
+        case JMP_IF_NOT: case JMP_IF_NOT_REL: {
+            u32 target = 0;
+            if (!PLCVerifier::target(d, program, offset, target) || runtime->verifier.depth[target] < 0) return;
+            s.target = (u16) target;
+            s.kernel = (opcode == JMP || opcode == JMP_REL) ? K_JMP : (opcode == JMP_IF || opcode == JMP_IF_REL) ? K_JMP_IF : K_JMP_IF_NOT;
+            return;
+        }
+        default: break;
+    }
+    if (stackOnly(opcode)) {
+        u16 need = 0;
+        i16 net = 0;
+        if (!plc_verify_stack_effect(program, offset, need, net)) return;
+        s.width = (u8) need;
+        s.arg = (u32) (i32) net;
+        s.kernel = K_STACK;
+    }
+}
+
+template <typename T, typename R, R(*Fn)(T, T)>
+void PLCEnsemble::binary(u8* a) {
+    u8* b = a + sizeof(T) * lanes;
+    for (u32 l = 0; l < lanes; l++) lanePut<R>(a, lanes, l, Fn(laneGet<T>(a, lanes, l), laneGet<T>(b, lanes, l)));
+}
+
+template <typename T>
+void PLCEnsemble::typed(u8 opcode, u8* a) {
+    switch (opcode) {
+        case ADD: binary<T, T, PLCPredecode::pd_add<T> >(a); break;
+        case SUB: binary<T, T, PLCPredecode::pd_sub<T> >(a); break;
+        case MUL: binary<T, T, PLCPredecode::pd_mul<T> >(a); break;
+        case CMP_EQ: binary<T, u8, PLCPredecode::pd_eq<T> >(a); break;
+        case CMP_NEQ: binary<T, u8, PLCPredecode::pd_neq<T> >(a); break;
+        case CMP_GT: binary<T, u8, PLCPredecode::pd_gt<T> >(a); break;
+        case CMP_GTE: binary<T, u8, PLCPredecode::pd_gte<T> >(a); break;
+        case CMP_LT: binary<T, u8, PLCPredecode::pd_lt<T> >(a); break;
+        default: binary<T, u8, PLCPredecode::pd_lte<T> >(a); break;
+    }
+}
+
+void PLCEnsemble::typedStep(u8 type, u8 opcode, u8* a) {
+    switch (type) {
+        case type_bool:
+        case type_u8: typed<u8>(opcode, a); break;
+        case type_i8: typed<i8>(opcode, a); break;
+        case type_u16: typed<u16>(opcode, a); break;
+        case type_i16: typed<i16>(opcode, a); break;
+#ifdef PLCRUNTIME_32BIT_OPS_ENABLED
+        case type_u32: typed<u32>(opcode, a); break;
+        case type_i32: typed<i32>(opcode, a); break;
+#endif // PLCRUNTIME_32BIT_OPS_ENABLED
+#ifdef PLCRUNTIME_FLOAT_OPS_ENABLED
+        case type_f32: typed<f32>(opcode, a); break;
+#endif // PLCRUNTIME_FLOAT_OPS_ENABLED
+#ifdef USE_X64_OPS
+        case type_u64: typed<u64>(opcode, a); break;
+        case type_i64: typed<i64>(opcode, a); break;
+        case type_f64: typed<f64>(opcode, a); break;
+#endif // USE_X64_OPS
+        default: break;
+    }
+}
+
+// Execute a stack-only instruction in every running lane, returns the lanes it failed in
+u32 PLCEnsemble::stackStep(const Step& s, u32 offset) {
+    VovkPLCRuntime& rt = *runtime;
+    const u32 need = s.width;
+    const u32 out = (u32) ((i32) need + (i32) s.arg);
+    u8* base = stack + (s.depth - need) * lanes;
+    u32 failed = 0;
+    for (u32 l = 0; l < lanes; l++) {
+        if (status[l] != STATUS_SUCCESS) continue;
+        for (u32 b = 0; b < need; b++) scratch[b] = base[b * lanes + l];
+        rt.stack.clear();
+        rt.stack.stack.pushRaw(scratch, need);
+        u32 index = offset;
+        RuntimeError e = rt.step(rt.program.program, rt.program.prog_size, index);
+        if (e != STATUS_SUCCESS) {
+            status[l] = e;
+            failed++;
+            continue;
+        }
+        const u8* result = rt.stack.stack.data();
+        for (u32 b = 0; b < out; b++) base[b * lanes + l] = result[b];
+    }
+    lane_steps += lanes;
+    return failed;
+}
+
+// Finish the cycle of every running lane on the runtime, starting at `record`
+void PLCEnsemble::runLanes(u32 record, u32 depth) {
+    VovkPLCRuntime& rt = *runtime;
+    diverged = true;
+    if (record >= count) return;
+    u8* const program = rt.program.program;
+    const u32 prog_size = rt.program.prog_size;
+    const u32 offset = rt.decoded.ops[record].offset;
+    for (u32 l = 0; l < lanes; l++) {
+        if (status[l] != STATUS_SUCCESS) continue;
+        for (u32 a = 0; a < memory_size; a++) rt.memory[a] = memory[a * lanes + l];
+        for (u32 b = 0; b < depth; b++) scratch[b] = stack[b * lanes + l];
+        rt.stack.clear();
+        rt.stack.stack.pushRaw(scratch, depth);
+        rt.BR = br[l];
+        u32 index = offset;
+        RuntimeError e = STATUS_SUCCESS;
+        while (index < prog_size) {
+            e = rt.step(program, prog_size, index);
+            lane_steps++;
+            if (e != STATUS_SUCCESS) break;
+        }
+        status[l] = e == PROGRAM_EXITED ? STATUS_SUCCESS : e;
+        br[l] = rt.BR;
+        for (u32 a = 0; a < memory_size; a++) memory[a * lanes + l] = rt.memory[a];
+    }
+}
+
+u32 PLCEnsemble::failures() const {
+    u32 failed = 0;
+    for (u32 l = 0; l < lanes; l++) if (status[l] != STATUS_SUCCESS) failed++;
+    return failed;
+}
+
+u32 PLCEnsemble::run() {
+    vector_steps = 0;
+    lane_steps = 0;
+    diverged = false;
+    if (!runtime || !memory) return lanes;
+    if (runtime->program.revision != revision) {
+        for (u32 l = 0; l < lanes; l++) status[l] = NO_PROGRAM; // Reload the ensemble after a program change
+        return lanes;
+    }
+    for (u32 l = 0; l < lanes; l++) status[l] = STATUS_SUCCESS;
+    const u32 n = lanes;
+    u32 r = 0;
+    while (r < count) {
+        const Step& s = steps[r];
+        u8* const top = stack + s.depth * n; // First free stack row
+        u8* const mem = memory + s.arg * n;
+        vector_steps++;
+        switch (s.kernel) {
+            case K_NOP: break;
+            case K_EXIT: return 0;
+            case K_PUSH:
+                for (u32 b = 0; b < s.width; b++) memset(top + b * n, s.value[b], n);
+                break;
+            case K_LOAD:
+                memcpy(top, mem, s.width * n);
+                break;
+            case K_MOVE:
+                memcpy(mem, top - s.width * n, s.width * n);
+                break;
+            case K_FILL:
+                memset(mem, s.value[0], s.target * n);
+                break;
+            case K_LOAD_CMP:
+            case K_LOAD_CMP_JMP: {
+                memcpy(top, mem, s.width * n);
+                for (u32 b = 0; b < s.width; b++) memset(top + (s.width + b) * n, s.value[b], n);
+                typedStep(s.type, s.opcode, top);
+                if (s.kernel == K_LOAD_CMP) break;
+                u32 taken = 0;
+                for (u32 l = 0; l < n; l++) taken += top[l] == 0;
+                if (taken == n) {
+                    r = s.target;
+                    continue;
+                }
+                if (taken == 0) break;
+                vector_steps--;
+                runLanes(r, s.depth);
+                return failures();
+            }
+            case K_READ_BIT:
+                for (u32 l = 0; l < n; l++) top[l] = (mem[l] >> s.width) & 1;
+                break;
+            case K_WRITE_BIT: {
+                const u8 mask = (u8) (1 << s.width);
+                const u8* v = top - n;
+                for (u32 l = 0; l < n; l++) mem[l] = v[l] ? (u8) (mem[l] | mask) : (u8) (mem[l] & ~mask);
+                break;
+            }
+            case K_SET_BIT:
+                for (u32 l = 0; l < n; l++) mem[l] |= (u8) (1 << s.width);
+                break;
+            case K_RESET_BIT:
+                for (u32 l = 0; l < n; l++) mem[l] &= (u8) ~(1 << s.width);
+                break;
+            case K_INVERT_BIT:
+                for (u32 l = 0; l < n; l++) mem[l] ^= (u8) (1 << s.width);
+                break;
+            case K_AND: {
+                u8* a = top - 2 * n;
+                const u8* b = top - n;
+                for (u32 l = 0; l < n; l++) a[l] = (a[l] != 0) & (b[l] != 0);
+                break;
+            }
+            case K_OR: {
+                u8* a = top - 2 * n;
+                const u8* b = top - n;
+                for (u32 l = 0; l < n; l++) a[l] = (a[l] != 0) | (b[l] != 0);
+                break;
+            }
+            case K_XOR: {
+                u8* a = top - 2 * n;
+                const u8* b = top - n;
+                for (u32 l = 0; l < n; l++) a[l] = (a[l] != 0) ^ (b[l] != 0);
+                break;
+            }
+            case K_NOT: {
+                u8* a = top - n;
+                for (u32 l = 0; l < n; l++) a[l] = a[l] == 0;
+                break;
+            }
+            case K_BR_SAVE: {
+                const u8* v = top - n;
+                for (u32 l = 0; l < n; l++) br[l] = (br[l] << 1) | (v[l] ? 1 : 0);
+                break;
+            }
+            case K_BR_READ:
+                for (u32 l = 0; l < n; l++) top[l] = (u8) (br[l] & 1);
+                break;
+            case K_BR_DROP:
+                for (u32 l = 0; l < n; l++) br[l] >>= 1;
+                break;
+            case K_BR_CLR:
+                for (u32 l = 0; l < n; l++) br[l] = 0;
+                break;
+            case K_TYPED:
+                typedStep(s.type, s.opcode, top - 2 * s.width * n);
+                break;
+            case K_STACK:
+                vector_steps--;
+                if (stackStep(s, runtime->decoded.ops[r].offset) > 0) {
+                    runLanes(r + 1, (u32) ((i32) s.depth + (i32) s.arg));
+                    return failures();
+                }
+                break;
+            case K_JMP:
+                r = s.target;
+                continue;
+            case K_JMP_IF:
+            case K_JMP_IF_NOT: {
+                const u8* c = top - n;
+                u32 taken = 0;
+                for (u32 l = 0; l < n; l++) taken += c[l] != 0;
+                if (s.kernel == K_JMP_IF_NOT) taken = n - taken;
+                if (taken == n) {
+                    r = s.target;
+                    continue;
+                }
+                if (taken == 0) break;
+                vector_steps--;
+                runLanes(r, s.depth); // Divergent: each lane takes its own path from here
+                return failures();
+            }
+            default:
+                vector_steps--;
+                runLanes(r, s.depth);
+                return failures();
+        }
+        r++;
+    }
+    return 0;
+}
+
+#endif // PLCRUNTIME_ENSEMBLE_ENABLED
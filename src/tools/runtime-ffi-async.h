@@ -0,0 +1,331 @@
+// runtime-ffi-async.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-ffi.h"
+
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+
+#ifdef PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif // PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+
+#ifndef PLCRUNTIME_FFI_ASYNC_MAX_JOBS
+#ifdef __AVR__
+#define PLCRUNTIME_FFI_ASYNC_MAX_JOBS 2
+#else
+#define PLCRUNTIME_FFI_ASYNC_MAX_JOBS 8
+#endif // __AVR__
+#endif // PLCRUNTIME_FFI_ASYNC_MAX_JOBS
+
+#ifndef PLCRUNTIME_FFI_ASYNC_WORKERS
+#define PLCRUNTIME_FFI_ASYNC_WORKERS 2
+#endif // PLCRUNTIME_FFI_ASYNC_WORKERS
+
+// Parameter snapshot plus the return value, every FFI type is at most 8 bytes
+#define PLCRUNTIME_FFI_ASYNC_DATA_SIZE ((PLCRUNTIME_FFI_MAX_PARAMS + 1) * 8)
+
+// ============================================================================
+// Asynchronous FFI jobs
+// ============================================================================
+// FFI_START copies the parameter values of an async FFI function into a job
+// slot and queues it, then writes the job handle to memory and continues with
+// the scan. The function runs outside the scan: on a worker thread when
+// PLCRUNTIME_FFI_ASYNC_THREAD is enabled, otherwise from service(), which the
+// application calls between scans (the cooperative task on an MCU, or the JS
+// side on WASM). The function only ever sees the job's private copy of its
+// parameters, so PLC memory is never touched from outside the scan.
+//
+// At the start of the next scan commit() copies the results of finished jobs
+// into PLC memory, so a result always appears at a scan boundary. FFI_POLL
+// pushes true once the job's result has been committed and frees the slot;
+// awaiting a job is a poll followed by a conditional jump.
+//
+// Handles are (generation << 8) | (slot + 1), 0 means no job was started
+// (all slots busy). A stale handle, e.g. one polled after its job was freed,
+// never matches a slot again until its generation wraps around.
+//
+// The job table is shared by every runtime in the process, so runtimes scanning
+// on different threads (PLCScheduler) may start jobs at the same time. A scan
+// claims a free slot with a compare-and-swap before it writes the job fields,
+// and only looks at a job's owner after its state shows the job is in use.
+// The counters are updated atomically.
+//
+// Job life cycle (the owner of each step in brackets):
+//   FREE -> CLAIMED [scan, start] -> QUEUED [scan] -> RUNNING [executor]
+//        -> FINISHED [executor] -> DONE [scan, commit] -> FREE [scan, poll]
+// cancel() frees a job of its runtime right away, except a RUNNING one:
+//   RUNNING -> CANCELLED [scan, cancel] -> FREE [executor]
+// ============================================================================
+
+enum PLCFFIJobState : u8 {
+    FFI_JOB_FREE = 0,
+    FFI_JOB_CLAIMED,                // Being filled in by start()
+    FFI_JOB_QUEUED,
+    FFI_JOB_RUNNING,
+    FFI_JOB_FINISHED,
+    FFI_JOB_DONE,
+    FFI_JOB_CANCELLED,              // Freed by the executor once the function returns
+};
+
+#ifdef __AVR__
+#include <util/atomic.h>
+inline u8 plc_ffi_job_load(volatile u8* state) { return *state; }
+inline void plc_ffi_job_store(volatile u8* state, u8 value) { *state = value; }
+inline bool plc_ffi_job_claim(volatile u8* state, u8 expected, u8 value) {
+    bool claimed = false;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (*state == expected) { *state = value; claimed = true; }
+    }
+    return claimed;
+}
+inline void plc_ffi_count(volatile u32* counter) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { (*counter)++; }
+}
+inline u8* plc_ffi_owner_load(u8** owner) { return *owner; }
+inline void plc_ffi_owner_store(u8** owner, u8* memory) { *owner = memory; }
+#else
+inline u8 plc_ffi_job_load(volatile u8* state) { return __atomic_load_n(state, __ATOMIC_ACQUIRE); }
+inline void plc_ffi_job_store(volatile u8* state, u8 value) { __atomic_store_n(state, value, __ATOMIC_RELEASE); }
+inline bool plc_ffi_job_claim(volatile u8* state, u8 expected, u8 value) {
+    return __atomic_compare_exchange_n(state, &expected, value, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+inline void plc_ffi_count(volatile u32* counter) { __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED); }
+inline u8* plc_ffi_owner_load(u8** owner) { return __atomic_load_n(owner, __ATOMIC_RELAXED); }
+inline void plc_ffi_owner_store(u8** owner, u8* memory) { __atomic_store_n(owner, memory, __ATOMIC_RELAXED); }
+#endif // __AVR__
+
+struct PLCFFIJob {
+    volatile u8 state;              // PLCFFIJobState
+    u8 generation;
+    u8 ffi_index;
+    u8 param_count;
+    u8 ret_size;
+    u16 ret_addr;                   // Destination in the owner's memory
+    u8* owner;                      // Memory of the runtime that started the job, kept after the job is freed
+    RuntimeError status;            // Result of the FFI function
+    u16 param_offsets[PLCRUNTIME_FFI_MAX_PARAMS]; // Parameter positions in data[]
+    u16 ret_offset;
+    u8 data[PLCRUNTIME_FFI_ASYNC_DATA_SIZE];
+};
+
+class PLCFFIAsync {
+public:
+    PLCFFIJob jobs[PLCRUNTIME_FFI_ASYNC_MAX_JOBS];
+    volatile u32 started = 0;
+    volatile u32 rejected = 0;      // FFI_START without a free slot
+    volatile u32 failed = 0;        // Jobs whose function returned an error
+    volatile u8 last_error = STATUS_SUCCESS; // RuntimeError
+
+    PLCFFIAsync() {
+        for (u8 i = 0; i < PLCRUNTIME_FFI_ASYNC_MAX_JOBS; i++) {
+            jobs[i].state = FFI_JOB_FREE;
+            jobs[i].generation = 0;
+            jobs[i].owner = nullptr;
+        }
+    }
+
+    // Queue a call of an async FFI function with the values at `param_addrs`.
+    // Returns the job handle in `handle`, 0 when every slot is busy.
+    RuntimeError start(u8* memory, u8 ffi_index, u8 param_count, const u16* param_addrs, u16 ret_addr, u16& handle) {
+        handle = 0;
+        const PLCFFIEntry* entry = g_ffiRegistry.getEntry(ffi_index);
+        if (!entry) return FFI_NOT_FOUND;
+        if (!entry->async) return FFI_INVALID_PARAMS;
+        if (entry->param_count != param_count) return FFI_INVALID_PARAMS;
+        const u8* param_types = entry->param_types;
+        u8 ret_size = ffi_getTypeSize(entry->ret_type);
+        if ((u32) ret_addr + ret_size > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+
+        for (u8 i = 0; i < param_count; i++) {
+            if ((u32) param_addrs[i] + ffi_getTypeSize(param_types[i]) > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+        }
+
+        u8 slot = 0;
+        while (slot < PLCRUNTIME_FFI_ASYNC_MAX_JOBS && !plc_ffi_job_claim(&jobs[slot].state, FFI_JOB_FREE, FFI_JOB_CLAIMED)) slot++;
+        if (slot == PLCRUNTIME_FFI_ASYNC_MAX_JOBS) {
+            plc_ffi_count(&rejected);
+            return STATUS_SUCCESS;
+        }
+        PLCFFIJob& job = jobs[slot];
+        u16 offset = 0;
+        for (u8 i = 0; i < param_count; i++) {
+            u8 size = ffi_getTypeSize(param_types[i]);
+            job.param_offsets[i] = offset;
+            memcpy(job.data + offset, memory + param_addrs[i], size);
+            offset += 8;
+        }
+        job.ret_offset = offset;
+        memset(job.data + offset, 0, 8);
+        job.ffi_index = ffi_index;
+        job.param_count = param_count;
+        job.ret_size = ret_size;
+        job.ret_addr = ret_addr;
+        plc_ffi_owner_store(&job.owner, memory);
+        job.status = STATUS_SUCCESS;
+        job.generation++;
+        handle = (u16) (((u16) job.generation << 8) | (slot + 1));
+        plc_ffi_job_store(&job.state, FFI_JOB_QUEUED);
+        plc_ffi_count(&started);
+#ifdef PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+        wake();
+#endif // PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+        return STATUS_SUCCESS;
+    }
+
+    // True once the job's result is in memory, the slot is freed by the first poll that sees it
+    bool poll(u8* memory, u16 handle) {
+        u8 slot = (u8) (handle & 0xFF);
+        if (slot == 0 || slot > PLCRUNTIME_FFI_ASYNC_MAX_JOBS) return false;
+        PLCFFIJob& job = jobs[slot - 1];
+        if (!owns(job, memory, FFI_JOB_DONE) || job.generation != (u8) (handle >> 8)) return false;
+        plc_ffi_job_store(&job.state, FFI_JOB_FREE);
+        return true;
+    }
+
+    // Copy the results of finished jobs into the owner's memory (scan boundary)
+    void commit(u8* memory) {
+        for (u8 i = 0; i < PLCRUNTIME_FFI_ASYNC_MAX_JOBS; i++) {
+            PLCFFIJob& job = jobs[i];
+            if (!owns(job, memory, FFI_JOB_FINISHED)) continue;
+            if (job.status == STATUS_SUCCESS) {
+                if (job.ret_size > 0) memcpy(memory + job.ret_addr, job.data + job.ret_offset, job.ret_size);
+            } else {
+                plc_ffi_count(&failed);
+                plc_ffi_job_store(&last_error, (u8) job.status);
+            }
+            plc_ffi_job_store(&job.state, FFI_JOB_DONE);
+        }
+    }
+
+    // Run up to `max_jobs` queued jobs on the calling thread, returns the number run
+    u8 service(u8 max_jobs = 1) {
+        u8 count = 0;
+        for (u8 i = 0; i < PLCRUNTIME_FFI_ASYNC_MAX_JOBS && count < max_jobs; i++) {
+            if (execute(jobs[i])) count++;
+        }
+        return count;
+    }
+
+    // Drop the jobs of a runtime (program reload). A running job keeps its slot
+    // until it finishes, the executor then discards its result.
+    void cancel(u8* memory) {
+        for (u8 i = 0; i < PLCRUNTIME_FFI_ASYNC_MAX_JOBS; i++) {
+            PLCFFIJob& job = jobs[i];
+            u8 state = plc_ffi_job_load(&job.state);
+            if (state == FFI_JOB_FREE || state == FFI_JOB_CLAIMED || state == FFI_JOB_CANCELLED) continue;
+            if (plc_ffi_owner_load(&job.owner) != memory) continue;
+            // Only the executor can move the job on meanwhile, so follow it through its states
+            if (plc_ffi_job_claim(&job.state, FFI_JOB_QUEUED, FFI_JOB_FREE)) continue;
+            if (plc_ffi_job_claim(&job.state, FFI_JOB_RUNNING, FFI_JOB_CANCELLED)) continue;
+            if (plc_ffi_job_claim(&job.state, FFI_JOB_FINISHED, FFI_JOB_FREE)) continue;
+            plc_ffi_job_claim(&job.state, FFI_JOB_DONE, FFI_JOB_FREE);
+        }
+    }
+
+    u8 pending() const {
+        u8 count = 0;
+        for (u8 i = 0; i < PLCRUNTIME_FFI_ASYNC_MAX_JOBS; i++) {
+            u8 state = plc_ffi_job_load((volatile u8*) &jobs[i].state);
+            if (state == FFI_JOB_QUEUED || state == FFI_JOB_RUNNING) count++;
+        }
+        return count;
+    }
+
+#ifdef PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+    // Start the worker threads that run queued jobs
+    void startWorkers(u8 count = PLCRUNTIME_FFI_ASYNC_WORKERS) {
+        if (worker_count > 0) return;
+        if (count > PLCRUNTIME_FFI_ASYNC_WORKERS) count = PLCRUNTIME_FFI_ASYNC_WORKERS;
+        stopping = false;
+        for (u8 i = 0; i < count; i++) workers[i] = std::thread(&PLCFFIAsync::workerLoop, this);
+        worker_count = count;
+    }
+
+    // Stop the workers after their current job, queued jobs stay queued
+    void stopWorkers() {
+        if (worker_count == 0) return;
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping = true;
+        }
+        wake_signal.notify_all();
+        for (u8 i = 0; i < worker_count; i++) workers[i].join();
+        worker_count = 0;
+    }
+
+    ~PLCFFIAsync() { stopWorkers(); }
+#endif // PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+
+private:
+    // True when the job is in `state` and was started by the runtime with `memory`.
+    // The owner is read after the state, so it is the one that queued the job;
+    // a job in DONE or FINISHED only moves on through its own runtime.
+    bool owns(PLCFFIJob& job, u8* memory, u8 state) {
+        return plc_ffi_job_load(&job.state) == state && plc_ffi_owner_load(&job.owner) == memory;
+    }
+
+    // Claim and run one job, false when it was not queued
+    bool execute(PLCFFIJob& job) {
+        if (!plc_ffi_job_claim(&job.state, FFI_JOB_QUEUED, FFI_JOB_RUNNING)) return false;
+        job.status = g_ffiRegistry.call(job.ffi_index, job.data, job.param_offsets, job.param_count, job.ret_offset);
+        if (!plc_ffi_job_claim(&job.state, FFI_JOB_RUNNING, FFI_JOB_FINISHED)) plc_ffi_job_store(&job.state, FFI_JOB_FREE); // Cancelled
+        return true;
+    }
+
+#ifdef PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+    std::thread workers[PLCRUNTIME_FFI_ASYNC_WORKERS];
+    u8 worker_count = 0;
+    bool stopping = false;
+    u32 wake_requests = 0;
+    std::mutex wake_mutex;
+    std::condition_variable wake_signal;
+
+    void wake() {
+        if (worker_count == 0) return;
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            wake_requests++;
+        }
+        wake_signal.notify_one();
+    }
+
+    void workerLoop() {
+        u32 seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex);
+                wake_signal.wait(lock, [&] { return stopping || wake_requests != seen; });
+                if (stopping) return;
+                seen = wake_requests;
+            }
+            while (service(1) > 0) {}
+        }
+    }
+#endif // PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+};
+
+static PLCFFIAsync g_ffiAsync;
+
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
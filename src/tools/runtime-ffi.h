@@ -91,6 +91,30 @@
 // ffi.call_stack 0, 1     ; call FFI #0 with 1 param from stack, push result
 //
 // ============================================================================
+// Asynchronous (long-running) functions
+// ============================================================================
+//
+// runtime.registerFFIAsync("F_motor_home", "u8->bool", "Home axis", motor_home);
+//
+// ffi.start F_motor_home M10 M20 M30  ; queue F_motor_home(M10), result to M20, handle to M30
+// ...
+// ffi.poll M30                        ; push true once the result is in M20
+// jmp_if_not wait_home
+//
+// The function runs on a worker thread (PLCRUNTIME_FFI_ASYNC_THREAD) or from
+// runtime.serviceFFI() between scans, see runtime-ffi-async.h.
+//
+// ============================================================================
+// Batched calls
+// ============================================================================
+//
+// ffi.batch F_axis_step M100 8      ; F_axis_step over 8 records starting at M100
+// ffi.batch F_axis_step M100 8 12   ; same, records 12 bytes apart
+//
+// One instruction calls the function once per record, a record is the
+// parameters packed in signature order followed by the return value.
+//
+// ============================================================================
 
 #pragma once
 
@@ -221,184 +245,115 @@ typedef RuntimeError (*PLCFFIInternalHandler)(u8* memory, u16* param_addrs, u8 p
 typedef PLCFFIInternalHandler PLCFFIHandler;
 
 // ============================================================================
-// FFI Wrapper Templates - Generate marshalling code at compile time
+// Compile-time FFI binding
+// ============================================================================
+// registerFFI() binds a function through FFIThunk<Ret, A...>, generated from
+// the function's own parameter pack: every argument is read straight from its
+// PLC memory address into the call, with no intermediate copies or signature
+// parsing. FFIDescriptor<Ret, A...> is the matching constexpr table of type
+// codes, sizes and packed record offsets; it is copied into the registry
+// entry once so the interpreter never parses the signature string at run time.
+//
+// FFIThunk::batch() calls the function over an array of records in one FFI
+// invocation (FFI_CALL_BATCH). A record holds the parameters packed in order
+// followed by the return value:
+//
+//   i32 axis_step(i32 target, u16 speed)  ->  [i32 target][u16 speed][i32 ret]  (10 bytes)
 // ============================================================================
 
-// --- 0 parameters ---
-template<typename Ret>
-struct FFIWrapper0 {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<Ret(*)()>(fn_ptr);
-        Ret result = fn();
-        ffi_write<Ret>(memory, ret_addr, result);
-        return STATUS_SUCCESS;
-    }
-};
-template<>
-struct FFIWrapper0<void> {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<void(*)()>(fn_ptr);
-        fn();
-        return STATUS_SUCCESS;
-    }
+// FFI type codes and sizes, see ffi_parseSignatureParams()
+template<typename T> struct FFIType;
+template<> struct FFIType<void> { static constexpr u8 code = 0; static constexpr u8 size = 0; };
+template<> struct FFIType<bool> { static constexpr u8 code = 1; static constexpr u8 size = 1; };
+template<> struct FFIType<u8> { static constexpr u8 code = 2; static constexpr u8 size = 1; };
+template<> struct FFIType<i8> { static constexpr u8 code = 3; static constexpr u8 size = 1; };
+template<> struct FFIType<u16> { static constexpr u8 code = 4; static constexpr u8 size = 2; };
+template<> struct FFIType<i16> { static constexpr u8 code = 5; static constexpr u8 size = 2; };
+template<> struct FFIType<u32> { static constexpr u8 code = 6; static constexpr u8 size = 4; };
+template<> struct FFIType<i32> { static constexpr u8 code = 7; static constexpr u8 size = 4; };
+template<> struct FFIType<u64> { static constexpr u8 code = 8; static constexpr u8 size = 8; };
+template<> struct FFIType<i64> { static constexpr u8 code = 9; static constexpr u8 size = 8; };
+template<> struct FFIType<f32> { static constexpr u8 code = 10; static constexpr u8 size = 4; };
+template<> struct FFIType<f64> { static constexpr u8 code = 11; static constexpr u8 size = 8; };
+template<> struct FFIType<str8> { static constexpr u8 code = 12; static constexpr u8 size = 2; };
+template<> struct FFIType<str16> { static constexpr u8 code = 13; static constexpr u8 size = 2; };
+
+template<typename Ret, typename... A>
+struct FFIDescriptor {
+    static constexpr u8 param_count = sizeof...(A);
+    static constexpr u8 ret_type = FFIType<Ret>::code;
+    static constexpr u8 ret_size = FFIType<Ret>::size;
+    static constexpr u8 param_types[sizeof...(A) + 1] = { FFIType<A>::code..., 0 };
+    static constexpr u8 param_sizes[sizeof...(A) + 1] = { FFIType<A>::size..., 0 };
+
+    // Offset of parameter `i` in a batch record, offset(param_count) is the return value
+    static constexpr u16 offset(u8 i) { return i == 0 ? 0 : (u16) (param_sizes[i - 1] + offset(i - 1)); }
+    static constexpr u16 record_size() { return (u16) (offset(param_count) + ret_size); }
 };
+template<typename Ret, typename... A> constexpr u8 FFIDescriptor<Ret, A...>::param_types[];
+template<typename Ret, typename... A> constexpr u8 FFIDescriptor<Ret, A...>::param_sizes[];
 
-// --- 1 parameter ---
-template<typename Ret, typename A1>
-struct FFIWrapper1 {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<Ret(*)(A1)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        Ret result = fn(a1);
-        ffi_write<Ret>(memory, ret_addr, result);
-        return STATUS_SUCCESS;
-    }
-};
-template<typename A1>
-struct FFIWrapper1<void, A1> {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<void(*)(A1)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        fn(a1);
-        return STATUS_SUCCESS;
-    }
-};
+// Index pack 0..N-1 for expanding the parameters (std::index_sequence is C++14)
+template<u8... I> struct FFIIndices {};
+template<u8 N, u8... I> struct FFIMakeIndices : FFIMakeIndices<N - 1, N - 1, I...> {};
+template<u8... I> struct FFIMakeIndices<0, I...> { typedef FFIIndices<I...> type; };
 
-// --- 2 parameters ---
-template<typename Ret, typename A1, typename A2>
-struct FFIWrapper2 {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<Ret(*)(A1, A2)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        Ret result = fn(a1, a2);
-        ffi_write<Ret>(memory, ret_addr, result);
-        return STATUS_SUCCESS;
+template<typename Ret>
+struct FFIInvoke {
+    template<typename... A, u8... I>
+    static void call(Ret (*fn)(A...), u8* memory, const u16* addrs, u16 ret_addr, FFIIndices<I...>) {
+        ffi_write<Ret>(memory, ret_addr, fn(ffi_read<A>(memory, addrs[I])...));
     }
-};
-template<typename A1, typename A2>
-struct FFIWrapper2<void, A1, A2> {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<void(*)(A1, A2)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        fn(a1, a2);
-        return STATUS_SUCCESS;
+    template<typename... A, u8... I>
+    static void record(Ret (*fn)(A...), u8* memory, u16 base, FFIIndices<I...>) {
+        typedef FFIDescriptor<Ret, A...> Desc;
+        ffi_write<Ret>(memory, base + Desc::offset(Desc::param_count), fn(ffi_read<A>(memory, base + Desc::offset(I))...));
     }
 };
-
-// --- 3 parameters ---
-template<typename Ret, typename A1, typename A2, typename A3>
-struct FFIWrapper3 {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<Ret(*)(A1, A2, A3)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        A3 a3 = ffi_read<A3>(memory, addrs[2]);
-        Ret result = fn(a1, a2, a3);
-        ffi_write<Ret>(memory, ret_addr, result);
-        return STATUS_SUCCESS;
+template<>
+struct FFIInvoke<void> {
+    template<typename... A, u8... I>
+    static void call(void (*fn)(A...), u8* memory, const u16* addrs, u16 ret_addr, FFIIndices<I...>) {
+        fn(ffi_read<A>(memory, addrs[I])...);
     }
-};
-template<typename A1, typename A2, typename A3>
-struct FFIWrapper3<void, A1, A2, A3> {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<void(*)(A1, A2, A3)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        A3 a3 = ffi_read<A3>(memory, addrs[2]);
-        fn(a1, a2, a3);
-        return STATUS_SUCCESS;
+    template<typename... A, u8... I>
+    static void record(void (*fn)(A...), u8* memory, u16 base, FFIIndices<I...>) {
+        typedef FFIDescriptor<void, A...> Desc;
+        fn(ffi_read<A>(memory, base + Desc::offset(I))...);
     }
 };
 
-// --- 4 parameters ---
-template<typename Ret, typename A1, typename A2, typename A3, typename A4>
-struct FFIWrapper4 {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<Ret(*)(A1, A2, A3, A4)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        A3 a3 = ffi_read<A3>(memory, addrs[2]);
-        A4 a4 = ffi_read<A4>(memory, addrs[3]);
-        Ret result = fn(a1, a2, a3, a4);
-        ffi_write<Ret>(memory, ret_addr, result);
-        return STATUS_SUCCESS;
-    }
-};
-template<typename A1, typename A2, typename A3, typename A4>
-struct FFIWrapper4<void, A1, A2, A3, A4> {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<void(*)(A1, A2, A3, A4)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        A3 a3 = ffi_read<A3>(memory, addrs[2]);
-        A4 a4 = ffi_read<A4>(memory, addrs[3]);
-        fn(a1, a2, a3, a4);
-        return STATUS_SUCCESS;
-    }
-};
+typedef RuntimeError (*PLCFFIBatchHandler)(u8* memory, u16 base, u16 count, u16 stride, void* fn_ptr);
 
-// --- 5 parameters ---
-template<typename Ret, typename A1, typename A2, typename A3, typename A4, typename A5>
-struct FFIWrapper5 {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<Ret(*)(A1, A2, A3, A4, A5)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        A3 a3 = ffi_read<A3>(memory, addrs[2]);
-        A4 a4 = ffi_read<A4>(memory, addrs[3]);
-        A5 a5 = ffi_read<A5>(memory, addrs[4]);
-        Ret result = fn(a1, a2, a3, a4, a5);
-        ffi_write<Ret>(memory, ret_addr, result);
-        return STATUS_SUCCESS;
-    }
-};
-template<typename A1, typename A2, typename A3, typename A4, typename A5>
-struct FFIWrapper5<void, A1, A2, A3, A4, A5> {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<void(*)(A1, A2, A3, A4, A5)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        A3 a3 = ffi_read<A3>(memory, addrs[2]);
-        A4 a4 = ffi_read<A4>(memory, addrs[3]);
-        A5 a5 = ffi_read<A5>(memory, addrs[4]);
-        fn(a1, a2, a3, a4, a5);
-        return STATUS_SUCCESS;
-    }
-};
+template<typename Ret, typename... A>
+struct FFIThunk {
+    static_assert(sizeof...(A) <= PLCRUNTIME_FFI_MAX_PARAMS, "too many FFI parameters (PLCRUNTIME_FFI_MAX_PARAMS)");
+    typedef Ret (*Fn)(A...);
+    typedef typename FFIMakeIndices<sizeof...(A)>::type Indices;
 
-// --- 6 parameters ---
-template<typename Ret, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
-struct FFIWrapper6 {
     static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<Ret(*)(A1, A2, A3, A4, A5, A6)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        A3 a3 = ffi_read<A3>(memory, addrs[2]);
-        A4 a4 = ffi_read<A4>(memory, addrs[3]);
-        A5 a5 = ffi_read<A5>(memory, addrs[4]);
-        A6 a6 = ffi_read<A6>(memory, addrs[5]);
-        Ret result = fn(a1, a2, a3, a4, a5, a6);
-        ffi_write<Ret>(memory, ret_addr, result);
+        FFIInvoke<Ret>::call(reinterpret_cast<Fn>(fn_ptr), memory, addrs, ret_addr, Indices());
         return STATUS_SUCCESS;
     }
-};
-template<typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
-struct FFIWrapper6<void, A1, A2, A3, A4, A5, A6> {
-    static RuntimeError call(u8* memory, u16* addrs, u8 cnt, u16 ret_addr, void* fn_ptr) {
-        auto fn = reinterpret_cast<void(*)(A1, A2, A3, A4, A5, A6)>(fn_ptr);
-        A1 a1 = ffi_read<A1>(memory, addrs[0]);
-        A2 a2 = ffi_read<A2>(memory, addrs[1]);
-        A3 a3 = ffi_read<A3>(memory, addrs[2]);
-        A4 a4 = ffi_read<A4>(memory, addrs[3]);
-        A5 a5 = ffi_read<A5>(memory, addrs[4]);
-        A6 a6 = ffi_read<A6>(memory, addrs[5]);
-        fn(a1, a2, a3, a4, a5, a6);
+
+    // `count` records of FFIDescriptor::record_size() bytes, `stride` bytes apart, starting at `base`
+    static RuntimeError batch(u8* memory, u16 base, u16 count, u16 stride, void* fn_ptr) {
+        Fn fn = reinterpret_cast<Fn>(fn_ptr);
+        u32 record = base;
+        for (u16 n = 0; n < count; n++, record += stride) FFIInvoke<Ret>::record(fn, memory, (u16) record, Indices());
         return STATUS_SUCCESS;
     }
 };
 
+// Names of the fixed-arity wrappers that FFIThunk replaces
+template<typename Ret> using FFIWrapper0 = FFIThunk<Ret>;
+template<typename Ret, typename A1> using FFIWrapper1 = FFIThunk<Ret, A1>;
+template<typename Ret, typename A1, typename A2> using FFIWrapper2 = FFIThunk<Ret, A1, A2>;
+template<typename Ret, typename A1, typename A2, typename A3> using FFIWrapper3 = FFIThunk<Ret, A1, A2, A3>;
+template<typename Ret, typename A1, typename A2, typename A3, typename A4> using FFIWrapper4 = FFIThunk<Ret, A1, A2, A3, A4>;
+template<typename Ret, typename A1, typename A2, typename A3, typename A4, typename A5> using FFIWrapper5 = FFIThunk<Ret, A1, A2, A3, A4, A5>;
+template<typename Ret, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6> using FFIWrapper6 = FFIThunk<Ret, A1, A2, A3, A4, A5, A6>;
+
 // ============================================================================
 // Signature Parsing Helpers (for editor/transport API)
 // ============================================================================
@@ -495,7 +450,13 @@ struct PLCFFIEntry {
     char description[PLCRUNTIME_FFI_MAX_DESC_LEN];
     PLCFFIInternalHandler wrapper;   // Generated wrapper function
     void* fn_ptr;                    // Original user function pointer
+    PLCFFIBatchHandler batch;        // Record loop generated with the wrapper, nullptr for raw handlers
     bool active;
+    bool async;                      // Long-running, started with FFI_START and run outside the scan
+    // Signature resolved at registration (FFIDescriptor or the parsed signature string)
+    u8 param_count;
+    u8 ret_type;
+    u8 param_types[PLCRUNTIME_FFI_MAX_PARAMS];
 };
 
 // ============================================================================
@@ -523,6 +484,15 @@ private:
         return *a == *b;
     }
 
+    static bool signatureMatches(const char* sig, const u8* param_types, u8 param_count, u8 ret_type) {
+        u8 parsed[PLCRUNTIME_FFI_MAX_PARAMS];
+        if (ffi_parseSignatureParams(sig, parsed, PLCRUNTIME_FFI_MAX_PARAMS) != param_count) return false;
+        for (u8 i = 0; i < param_count; i++) {
+            if (parsed[i] != param_types[i]) return false;
+        }
+        return ffi_parseSignatureReturn(sig) == ret_type;
+    }
+
 public:
     PLCFFIRegistry() {
         // Only initialize once - static globals survive WASM reinitialization
@@ -531,7 +501,10 @@ public:
                 g_ffi_entries[i].active = false;
                 g_ffi_entries[i].wrapper = nullptr;
                 g_ffi_entries[i].fn_ptr = nullptr;
+                g_ffi_entries[i].batch = nullptr;
+                g_ffi_entries[i].param_count = 0;
                 g_ffi_entries[i].name[0] = '\0';
+                g_ffi_entries[i].async = false;
             }
             g_ffi_initialized = true;
         }
@@ -539,76 +512,56 @@ public:
 
     // Internal registration (called by template helpers)
     i8 registerInternal(const char* name, const char* sig, const char* desc,
-                        PLCFFIInternalHandler wrapper, void* fn_ptr) {
+                        PLCFFIInternalHandler wrapper, PLCFFIBatchHandler batch, void* fn_ptr,
+                        const u8* param_types, u8 param_count, u8 ret_type) {
+        if (param_count > PLCRUNTIME_FFI_MAX_PARAMS) return -1;
         // Check if already exists
-        for (u8 i = 0; i < PLCRUNTIME_MAX_FFI_FUNCTIONS; i++) {
-            if (g_ffi_entries[i].active && strEqual(g_ffi_entries[i].name, name)) {
-                copyStr(g_ffi_entries[i].signature, sig, PLCRUNTIME_FFI_MAX_SIG_LEN);
-                copyStr(g_ffi_entries[i].description, desc, PLCRUNTIME_FFI_MAX_DESC_LEN);
-                g_ffi_entries[i].wrapper = wrapper;
-                g_ffi_entries[i].fn_ptr = fn_ptr;
-                return i;
-            }
-        }
-        // Find empty slot
-        for (u8 i = 0; i < PLCRUNTIME_MAX_FFI_FUNCTIONS; i++) {
-            if (!g_ffi_entries[i].active) {
-                copyStr(g_ffi_entries[i].name, name, PLCRUNTIME_FFI_MAX_NAME_LEN);
-                copyStr(g_ffi_entries[i].signature, sig, PLCRUNTIME_FFI_MAX_SIG_LEN);
-                copyStr(g_ffi_entries[i].description, desc, PLCRUNTIME_FFI_MAX_DESC_LEN);
-                g_ffi_entries[i].wrapper = wrapper;
-                g_ffi_entries[i].fn_ptr = fn_ptr;
-                g_ffi_entries[i].active = true;
-                return i;
+        i8 index = findByName(name);
+        if (index < 0) {
+            // Find empty slot
+            for (u8 i = 0; i < PLCRUNTIME_MAX_FFI_FUNCTIONS && index < 0; i++) {
+                if (!g_ffi_entries[i].active) index = (i8) i;
             }
+            if (index < 0) return -1;
+            copyStr(g_ffi_entries[(u8) index].name, name, PLCRUNTIME_FFI_MAX_NAME_LEN);
         }
-        return -1;
+        PLCFFIEntry& entry = g_ffi_entries[(u8) index];
+        copyStr(entry.signature, sig, PLCRUNTIME_FFI_MAX_SIG_LEN);
+        copyStr(entry.description, desc, PLCRUNTIME_FFI_MAX_DESC_LEN);
+        entry.wrapper = wrapper;
+        entry.batch = batch;
+        entry.fn_ptr = fn_ptr;
+        entry.param_count = param_count;
+        entry.ret_type = ret_type;
+        for (u8 i = 0; i < param_count; i++) entry.param_types[i] = param_types[i];
+        entry.active = true;
+        entry.async = false;
+        return index;
     }
 
     // ========================================================================
     // Simple User-Facing Registration Templates
     // ========================================================================
 
-    // 0 parameters
-    template<typename Ret>
-    i8 add(const char* name, const char* sig, const char* desc, Ret (*fn)()) {
-        return registerInternal(name, sig, desc, FFIWrapper0<Ret>::call, (void*)fn);
-    }
-
-    // 1 parameter
-    template<typename Ret, typename A1>
-    i8 add(const char* name, const char* sig, const char* desc, Ret (*fn)(A1)) {
-        return registerInternal(name, sig, desc, FFIWrapper1<Ret, A1>::call, (void*)fn);
-    }
-
-    // 2 parameters
-    template<typename Ret, typename A1, typename A2>
-    i8 add(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2)) {
-        return registerInternal(name, sig, desc, FFIWrapper2<Ret, A1, A2>::call, (void*)fn);
-    }
-
-    // 3 parameters
-    template<typename Ret, typename A1, typename A2, typename A3>
-    i8 add(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2, A3)) {
-        return registerInternal(name, sig, desc, FFIWrapper3<Ret, A1, A2, A3>::call, (void*)fn);
-    }
-
-    // 4 parameters
-    template<typename Ret, typename A1, typename A2, typename A3, typename A4>
-    i8 add(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2, A3, A4)) {
-        return registerInternal(name, sig, desc, FFIWrapper4<Ret, A1, A2, A3, A4>::call, (void*)fn);
-    }
-
-    // 5 parameters
-    template<typename Ret, typename A1, typename A2, typename A3, typename A4, typename A5>
-    i8 add(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2, A3, A4, A5)) {
-        return registerInternal(name, sig, desc, FFIWrapper5<Ret, A1, A2, A3, A4, A5>::call, (void*)fn);
-    }
-
-    // 6 parameters
-    template<typename Ret, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
-    i8 add(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2, A3, A4, A5, A6)) {
-        return registerInternal(name, sig, desc, FFIWrapper6<Ret, A1, A2, A3, A4, A5, A6>::call, (void*)fn);
+    // Any function of up to PLCRUNTIME_FFI_MAX_PARAMS parameters. The signature string
+    // is what the editor and assembler see, so it has to describe the function exactly.
+    template<typename Ret, typename... A>
+    i8 add(const char* name, const char* sig, const char* desc, Ret (*fn)(A...)) {
+        typedef FFIDescriptor<Ret, A...> Desc;
+        if (!signatureMatches(sig, Desc::param_types, Desc::param_count, Desc::ret_type)) return -1;
+        return registerInternal(name, sig, desc, FFIThunk<Ret, A...>::call, FFIThunk<Ret, A...>::batch, (void*)fn,
+                                Desc::param_types, Desc::param_count, Desc::ret_type);
+    }
+
+    // Long-running function, any of the signatures accepted by add()
+    template<typename Fn>
+    i8 addAsync(const char* name, const char* sig, const char* desc, Fn fn) {
+        i8 index = add(name, sig, desc, fn);
+        if (index >= 0 && !setAsync((u8) index, true)) {
+            remove((u8) index);
+            return -1;
+        }
+        return index;
     }
 
     // ========================================================================
@@ -619,7 +572,9 @@ public:
     // Used by WASM exports and advanced users who need direct memory access
     i8 registerFunction(const char* name, const char* sig, const char* desc,
                         PLCFFIHandler handler, void* user_data = nullptr) {
-        return registerInternal(name, sig, desc, handler, user_data);
+        u8 param_types[PLCRUNTIME_FFI_MAX_PARAMS];
+        u8 param_count = ffi_parseSignatureParams(sig, param_types, PLCRUNTIME_FFI_MAX_PARAMS);
+        return registerInternal(name, sig, desc, handler, nullptr, user_data, param_types, param_count, ffi_parseSignatureReturn(sig));
     }
 
     bool remove(u8 index) {
@@ -627,7 +582,25 @@ public:
         g_ffi_entries[index].active = false;
         g_ffi_entries[index].wrapper = nullptr;
         g_ffi_entries[index].fn_ptr = nullptr;
+        g_ffi_entries[index].batch = nullptr;
+        g_ffi_entries[index].param_count = 0;
         g_ffi_entries[index].name[0] = '\0';
+        g_ffi_entries[index].async = false;
+        return true;
+    }
+
+    // Mark a function as long-running (FFI_START / FFI_POLL) or back to a plain FFI_CALL function.
+    // Async functions get copies of their parameters, so string parameters and returns are rejected.
+    bool setAsync(u8 index, bool async) {
+        if (index >= PLCRUNTIME_MAX_FFI_FUNCTIONS || !g_ffi_entries[index].active) return false;
+        const PLCFFIEntry& entry = g_ffi_entries[index];
+        if (async) {
+            for (u8 i = 0; i < entry.param_count; i++) {
+                if (entry.param_types[i] == 12 || entry.param_types[i] == 13) return false;
+            }
+            if (entry.ret_type == 12 || entry.ret_type == 13) return false;
+        }
+        g_ffi_entries[index].async = async;
         return true;
     }
 
@@ -668,9 +641,43 @@ public:
     RuntimeError call(u8 index, u8* memory, u16* param_addrs, u8 param_count, u16 ret_addr) {
         if (index >= PLCRUNTIME_MAX_FFI_FUNCTIONS) return EXECUTION_ERROR;
         if (!g_ffi_entries[index].active || !g_ffi_entries[index].wrapper) return EXECUTION_ERROR;
+        if (param_count != g_ffi_entries[index].param_count) return FFI_INVALID_PARAMS;
         return g_ffi_entries[index].wrapper(memory, param_addrs, param_count, ret_addr, g_ffi_entries[index].fn_ptr);
     }
 
+    // Size of one batch record: the parameters packed in order, then the return value
+    u16 recordSize(u8 index) const {
+        if (index >= PLCRUNTIME_MAX_FFI_FUNCTIONS || !g_ffi_entries[index].active) return 0;
+        const PLCFFIEntry& entry = g_ffi_entries[index];
+        u16 size = ffi_getTypeSize(entry.ret_type);
+        for (u8 i = 0; i < entry.param_count; i++) size += ffi_getTypeSize(entry.param_types[i]);
+        return size;
+    }
+
+    // Call the function once per record, `count` records `stride` bytes apart starting at `base`
+    RuntimeError callBatch(u8 index, u8* memory, u16 base, u16 count, u16 stride) {
+        if (index >= PLCRUNTIME_MAX_FFI_FUNCTIONS) return EXECUTION_ERROR;
+        const PLCFFIEntry& entry = g_ffi_entries[index];
+        if (!entry.active || !entry.wrapper) return EXECUTION_ERROR;
+        if (count == 0) return STATUS_SUCCESS;
+        u16 record_size = recordSize(index);
+        if (count > 1 && stride < record_size) return FFI_INVALID_PARAMS;
+        if ((u32) base + (u32) (count - 1) * stride + record_size > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+        if (entry.batch) return entry.batch(memory, base, count, stride, entry.fn_ptr);
+        // Raw handlers take addresses, point them into each record
+        u16 param_addrs[PLCRUNTIME_FFI_MAX_PARAMS];
+        for (u16 n = 0; n < count; n++) {
+            u16 addr = (u16) (base + (u32) n * stride);
+            for (u8 i = 0; i < entry.param_count; i++) {
+                param_addrs[i] = addr;
+                addr += ffi_getTypeSize(entry.param_types[i]);
+            }
+            RuntimeError err = entry.wrapper(memory, param_addrs, entry.param_count, addr, entry.fn_ptr);
+            if (err != STATUS_SUCCESS) return err;
+        }
+        return STATUS_SUCCESS;
+    }
+
     // Iterate all entries (for transport/serial API)
     template<typename Callback>
     void forEach(Callback cb) const {
@@ -684,7 +691,10 @@ public:
             g_ffi_entries[i].active = false;
             g_ffi_entries[i].wrapper = nullptr;
             g_ffi_entries[i].fn_ptr = nullptr;
+            g_ffi_entries[i].batch = nullptr;
+            g_ffi_entries[i].param_count = 0;
             g_ffi_entries[i].name[0] = '\0';
+            g_ffi_entries[i].async = false;
         }
     }
 };
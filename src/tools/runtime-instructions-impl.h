@@ -142,6 +142,7 @@ bool OPCODE_EXISTS(PLCRuntimeInstructionSet opcode) {
         case POKE:
 #endif // PLCRUNTIME_STACK_OPS_ENABLED
         case MEM_FILL:
+        case LOAD_CMP_IMM:
         case ADD:
         case SUB:
         case MUL:
@@ -157,6 +158,10 @@ bool OPCODE_EXISTS(PLCRuntimeInstructionSet opcode) {
         case SIN:
         case COS:
 #endif // PLCRUNTIME_ADVANCED_MATH_ENABLED
+        case READ_AND_X8:
+        case READ_OR_X8:
+        case READ_AND_WRITE_X8:
+        case LOAD_CMP_IMM_JMP_IF_NOT:
             /* TODO: */
             // case MOD:
             // case POW:
@@ -269,6 +274,7 @@ bool OPCODE_EXISTS(PLCRuntimeInstructionSet opcode) {
         case BR_READ:
         case BR_DROP:
         case BR_CLR:
+        case BR_SAVE_READ:
 
 #ifdef PLCRUNTIME_BITWISE_OPS_ENABLED
         case BW_AND_X8:
@@ -296,6 +302,12 @@ bool OPCODE_EXISTS(PLCRuntimeInstructionSet opcode) {
         case BW_NOT_X64:
         case BW_LSHIFT_X64:
         case BW_RSHIFT_X64:
+#endif
+        case BIT_GATHER_X32:
+        case BIT_SCATTER_X32:
+#ifdef USE_X64_OPS
+        case BIT_GATHER_X64:
+        case BIT_SCATTER_X64:
 #endif
 #endif // PLCRUNTIME_BITWISE_OPS_ENABLED
 #ifdef PLCRUNTIME_STRINGS_ENABLED
@@ -415,6 +427,7 @@ const FSH* OPCODE_NAME(PLCRuntimeInstructionSet opcode) {
         case PICK: return F("PICK");
         case POKE: return F("POKE");
         case MEM_FILL: return F("MEM_FILL");
+        case LOAD_CMP_IMM: return F("LOAD_CMP_IMM");
         case ADD: return F("ADD");
         case SUB: return F("SUB");
         case MUL: return F("MUL");
@@ -426,6 +439,10 @@ const FSH* OPCODE_NAME(PLCRuntimeInstructionSet opcode) {
         case ABS: return F("ABS");
         case SIN: return F("SIN");
         case COS: return F("COS");
+        case READ_AND_X8: return F("READ_AND_X8");
+        case READ_OR_X8: return F("READ_OR_X8");
+        case READ_AND_WRITE_X8: return F("READ_AND_WRITE_X8");
+        case LOAD_CMP_IMM_JMP_IF_NOT: return F("LOAD_CMP_IMM_JMP_IF_NOT");
                 /* TODO: */
                 // case MIN: return F("MIN");
                 // case MAX: return F("MAX");
@@ -536,6 +553,7 @@ const FSH* OPCODE_NAME(PLCRuntimeInstructionSet opcode) {
         case BR_READ: return F("BR_READ");
         case BR_DROP: return F("BR_DROP");
         case BR_CLR: return F("BR_CLR");
+        case BR_SAVE_READ: return F("BR_SAVE_READ");
 
 #ifdef PLCRUNTIME_BITWISE_OPS_ENABLED
         case BW_AND_X8: return F("BW_AND_X8");
@@ -563,6 +581,12 @@ const FSH* OPCODE_NAME(PLCRuntimeInstructionSet opcode) {
         case BW_NOT_X64: return F("BW_NOT_X64");
         case BW_LSHIFT_X64: return F("BW_LSHIFT_X64");
         case BW_RSHIFT_X64: return F("BW_RSHIFT_X64");
+#endif
+        case BIT_GATHER_X32: return F("BIT_GATHER_X32");
+        case BIT_SCATTER_X32: return F("BIT_SCATTER_X32");
+#ifdef USE_X64_OPS
+        case BIT_GATHER_X64: return F("BIT_GATHER_X64");
+        case BIT_SCATTER_X64: return F("BIT_SCATTER_X64");
 #endif
 #endif // PLCRUNTIME_BITWISE_OPS_ENABLED
         case STR_LEN: return F("STR_LEN");
@@ -678,6 +702,7 @@ u8 OPCODE_SIZE(PLCRuntimeInstructionSet opcode) {
         case PICK: return 2 + MY_PTR_SIZE_BYTES;
         case POKE: return 2 + MY_PTR_SIZE_BYTES;
         case MEM_FILL: return 1 + 1 + MY_PTR_SIZE_BYTES + MY_PTR_SIZE_BYTES; // opcode + value + address + length
+        case LOAD_CMP_IMM: return 0; // Dynamic size: LOAD_CMP_IMM_SIZE(type) (handled specially)
         case ADD: return 2;
         case SUB: return 2;
         case MUL: return 2;
@@ -689,6 +714,10 @@ u8 OPCODE_SIZE(PLCRuntimeInstructionSet opcode) {
         case ABS: return 2;
         case SIN: return 2;
         case COS: return 2;
+        case READ_AND_X8:
+        case READ_OR_X8: return 2 + MY_PTR_SIZE_BYTES; // opcode + address + bit
+        case READ_AND_WRITE_X8: return 3 + MY_PTR_SIZE_BYTES + MY_PTR_SIZE_BYTES; // opcode + src address + src bit + dst address + dst bit
+        case LOAD_CMP_IMM_JMP_IF_NOT: return 0; // Dynamic size: LOAD_CMP_IMM_SIZE(type) + 2 (handled specially)
             // case MOD: return 2;
             // case POW: return 2;
             // case SQRT: return 2;
@@ -803,7 +832,8 @@ u8 OPCODE_SIZE(PLCRuntimeInstructionSet opcode) {
         case BR_SAVE:
         case BR_READ:
         case BR_DROP:
-        case BR_CLR: return 1;
+        case BR_CLR:
+        case BR_SAVE_READ: return 1;
 
         case BW_AND_X8:
         case BW_AND_X16:
@@ -831,6 +861,10 @@ u8 OPCODE_SIZE(PLCRuntimeInstructionSet opcode) {
         case BW_LSHIFT_X64:
         case BW_RSHIFT_X64: return 1;
 #endif
+        case BIT_GATHER_X32:
+        case BIT_GATHER_X64:
+        case BIT_SCATTER_X32:
+        case BIT_SCATTER_X64: return 0; // Dynamic size: 2 + count * (address + bit) (handled specially)
 
         // String operations: [ opcode, u8 str_type, u16 str_addr, ... ]
         case STR_LEN:       // [ STR_LEN, type, addr ] -> push u16
@@ -920,6 +954,69 @@ u8 OPCODE_SIZE(PLCRuntimeInstructionSet opcode) {
     return 0;
 }
 
+u8 LOAD_CMP_IMM_SIZE(u8 data_type) {
+    // opcode + cmp_opcode + type + address + value
+    u8 value_size = 0;
+    switch (data_type) {
+        case type_bool:
+        case type_u8:
+        case type_i8: value_size = 1; break;
+        case type_u16:
+        case type_i16: value_size = 2; break;
+        case type_u32:
+        case type_i32:
+        case type_f32: value_size = 4; break;
+#ifdef USE_X64_OPS
+        case type_u64:
+        case type_i64:
+        case type_f64: value_size = 8; break;
+#endif // USE_X64_OPS
+        default: return 0;
+    }
+    return 3 + MY_PTR_SIZE_BYTES + value_size;
+}
+
+
+// Total encoded size of the instruction at `index`, or 0 if it cannot be determined statically
+u32 INSTRUCTION_SIZE(const u8* program, u32 prog_size, u32 index) {
+    u8 opcode = program[index];
+    u32 remaining = prog_size - index;
+    switch (opcode) {
+        case COMMENT: {
+            if (remaining < 2) return 0;
+            u32 size = 2 + program[index + 1];
+            return size < remaining ? size : 0; // step() rejects a comment that ends the program
+        }
+        case CONFIG_DB: return remaining < 2 ? 0 : 2 + (u32) program[index + 1] * 4;
+        case LOAD_CMP_IMM: return remaining < 3 ? 0 : LOAD_CMP_IMM_SIZE(program[index + 2]);
+        case LOAD_CMP_IMM_JMP_IF_NOT: {
+            u32 size = remaining < 3 ? 0 : LOAD_CMP_IMM_SIZE(program[index + 2]);
+            return size ? size + 2 : 0;
+        }
+#ifdef PLCRUNTIME_BITWISE_OPS_ENABLED
+        case BIT_GATHER_X32:
+        case BIT_GATHER_X64:
+        case BIT_SCATTER_X32:
+        case BIT_SCATTER_X64: return remaining < 2 ? 0 : 2 + (u32) program[index + 1] * (MY_PTR_SIZE_BYTES + 1);
+#endif // PLCRUNTIME_BITWISE_OPS_ENABLED
+#ifdef PLCRUNTIME_STRINGS_ENABLED
+        case CSTR_LIT:
+        case CSTR_CAT: {
+            u32 head = 1 + 1 + MY_PTR_SIZE_BYTES + 2;
+            if (remaining < head) return 0;
+            return head + read_u16(program + index + head - 2);
+        }
+#endif // PLCRUNTIME_STRINGS_ENABLED
+#ifdef PLCRUNTIME_FFI_ENABLED
+        case FFI_CALL: return remaining < 3 ? 0 : 3 + (u32) program[index + 2] * 2 + 2;
+        case FFI_CALL_STACK: return 3;
+        case FFI_START: return remaining < 3 ? 0 : 3 + (u32) program[index + 2] * 2 + 4;
+        case FFI_POLL: return 3;
+        case FFI_CALL_BATCH: return 8;
+#endif // PLCRUNTIME_FFI_ENABLED
+        default: return OPCODE_SIZE((PLCRuntimeInstructionSet) opcode);
+    }
+}
 
 #ifdef __RUNTIME_DEBUG__
 void logRuntimeInstructionSet() {
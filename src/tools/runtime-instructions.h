@@ -173,6 +173,7 @@ enum PLCRuntimeInstructionSet {
     PICK,               // Copy value from stack at byte depth to top. Example: [ u8 PICK, u8 type, u16 depth ]
     POKE,               // Write top value to stack at byte depth. Example: [ u8 POKE, u8 type, u16 depth ]
     MEM_FILL,           // Fill memory with repeating byte pattern. Example: [ u8 MEM_FILL, u8 value, u16 address, u16 length ]
+    LOAD_CMP_IMM,       // Fused LOAD_FROM + <type> const + CMP_xx -> push bool. [ u8 LOAD_CMP_IMM, u8 cmp_opcode, u8 type, u16 address, <type> value ]
 
     // Arithmetic operations
     ADD = 0x20,         // Addition, requires data type as argument
@@ -200,6 +201,12 @@ enum PLCRuntimeInstructionSet {
     SIN,                // Sine
     COS,                // Cosine
 
+    // Fused superinstructions (emitted by the PLCASM peephole pass)
+    READ_AND_X8 = 0x2C, // Fused READ_X8_Bn + LOGIC_AND. [ u8 READ_AND_X8, u16 address, u8 bit ]
+    READ_OR_X8,         // Fused READ_X8_Bn + LOGIC_OR. [ u8 READ_OR_X8, u16 address, u8 bit ]
+    READ_AND_WRITE_X8,  // Fused READ_X8_Bn + LOGIC_AND + WRITE_X8_Bn. [ u8 READ_AND_WRITE_X8, u16 src_address, u8 src_bit, u16 dst_address, u8 dst_bit ]
+    LOAD_CMP_IMM_JMP_IF_NOT, // Fused LOAD_CMP_IMM + JMP_IF_NOT. [ u8 LOAD_CMP_IMM_JMP_IF_NOT, u8 cmp_opcode, u8 type, u16 address, <type> value, u16 target ]
+
     // Timer operations
     TON_CONST = 0x30,   // Timer On-Delay (IN, PT: Constant u32) -> Q
     TON_MEM,            // Timer On-Delay (IN, PT: Memory u32) -> Q
@@ -370,6 +377,12 @@ enum PLCRuntimeInstructionSet {
     LOGIC_XOR,          // Logical XOR for bool (x, y)
     LOGIC_NOT,          // Logical NOT for bool (x)
 
+    // Packed bit access (bit n of the value <-> n-th listed memory bit)
+    BIT_GATHER_X32 = 0xC4, // Pack up to 32 memory bits into an u32. [ u8 BIT_GATHER_X32, u8 count, count x (u16 address, u8 bit) ]
+    BIT_GATHER_X64,     // Pack up to 64 memory bits into an u64. [ u8 BIT_GATHER_X64, u8 count, count x (u16 address, u8 bit) ]
+    BIT_SCATTER_X32,    // Pop an u32 and write its low bits to up to 32 memory bits. [ u8 BIT_SCATTER_X32, u8 count, count x (u16 address, u8 bit) ]
+    BIT_SCATTER_X64,    // Pop an u64 and write its low bits to up to 64 memory bits. [ u8 BIT_SCATTER_X64, u8 count, count x (u16 address, u8 bit) ]
+
     // Comparison operations
     CMP_EQ = 0xD0,      // Compare  (x, y)
     CMP_NEQ,            // Compare  (x, y)
@@ -378,6 +391,10 @@ enum PLCRuntimeInstructionSet {
     CMP_GTE,            // Compare  (x, y)
     CMP_LTE,            // Compare  (x, y)
 
+    // Asynchronous FFI operations (long-running functions, results committed at the next scan boundary)
+    FFI_START = 0xDE,       // Queue an async FFI call: [ FFI_START, u8 index, u8 param_count, u16 addr1, ..., u16 ret_addr, u16 handle_addr ]
+    FFI_POLL,               // Push true once the job's result is in memory and free it: [ FFI_POLL, u16 handle_addr ]
+
     // Control flow
     JMP = 0xE0,         // Jump to the given address in the program bytecode (u16)
     JMP_IF,             // Jump to the given address in the program bytecode if the top of the stack is true (u16)
@@ -396,6 +413,9 @@ enum PLCRuntimeInstructionSet {
     CALL_IF_REL,        // Call a function relative to the next instruction address if the top of the stack is true (i16)
     CALL_IF_NOT_REL,    // Call a function relative to the next instruction address if the top of the stack is false (i16)
 
+    // Batched FFI call, one invocation over an array of records (see FFIThunk::batch)
+    FFI_CALL_BATCH = 0xEF,  // Call FFI once per record: [ FFI_CALL_BATCH, u8 index, u16 base_addr, u16 count, u16 stride ]
+
     // FFI (Foreign Function Interface) operations
     FFI_CALL = 0xF0,        // Call FFI by index with memory addresses: [ FFI_CALL, u8 index, u8 param_count, u16 addr1, ..., u16 ret_addr ]
     FFI_CALL_STACK,         // Call FFI by index with params from stack: [ FFI_CALL_STACK, u8 index, u8 param_count ] - pops params, pushes result
@@ -416,6 +436,9 @@ enum PLCRuntimeInstructionSet {
     // Communication protocol operations (multi-protocol, multi-instance)
     COMMS = 0xF9,           // Communication protocol operation: [ COMMS, u8 sub_function, ... ] - dynamic size per sub-function
 
+    // Fused branch stack operation (emitted by the PLCASM peephole pass)
+    BR_SAVE_READ = 0xFA,    // Fused BR_SAVE + BR_READ: BR = (BR << 1) | (v ? 1 : 0), push_u8(v ? 1 : 0) where v = pop_u8()
+
     // Runtime configuration instructions
     CONFIG_DB = 0xFB,   // Configure DataBlock: [ CONFIG_DB, u8 count, { u16 db_number, u16 size }... ] - 1 + count*4 bytes
     CONFIG_TC = 0xFC,   // Configure Timer/Counter offsets: [ CONFIG_TC, u16 timer_offset, u8 timer_count, u16 counter_offset, u8 counter_count ] - 7 bytes
@@ -431,6 +454,8 @@ enum PLCRuntimeInstructionSet {
 bool OPCODE_EXISTS(PLCRuntimeInstructionSet opcode);
 const FSH* OPCODE_NAME(PLCRuntimeInstructionSet opcode);
 u8 OPCODE_SIZE(PLCRuntimeInstructionSet opcode);
+u8 LOAD_CMP_IMM_SIZE(u8 data_type); // Size of LOAD_CMP_IMM for the given type (0 if unsupported), add 2 for LOAD_CMP_IMM_JMP_IF_NOT
+u32 INSTRUCTION_SIZE(const u8* program, u32 prog_size, u32 index); // Encoded size of the instruction at `index` including dynamic operands (0 if unknown)
 void logRuntimeInstructionSet();
 
 
@@ -0,0 +1,183 @@
+// runtime-jit-impl.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef PLCRUNTIME_JIT_ENABLED
+
+namespace PLCJit {
+
+    // x86-64 System V code emitter. With `buf == nullptr` it only measures, which
+    // is used by the first pass to lay out the record entry points.
+    struct Emitter {
+        u8* buf = nullptr;
+        u32 pos = 0;
+
+        void byte(u8 b) { if (buf) buf[pos] = b; pos++; }
+        void bytes(const u8* data, u32 size) { for (u32 i = 0; i < size; i++) byte(data[i]); }
+        void dword(u32 value) { for (u32 i = 0; i < 4; i++) byte((value >> (i * 8)) & 0xFF); }
+        void qword(u64 value) { for (u32 i = 0; i < 8; i++) byte((value >> (i * 8)) & 0xFF); }
+        // Relative 32-bit displacement to `target`, measured from the end of the displacement
+        void rel32(u32 target) { dword(target - (pos + 4)); }
+
+        // Register usage: r12 = runtime, r13 = &pc, r14 = &tos, r15 = &instruction_count
+        void prologue() {
+            static const u8 code[] = {
+                0x53,             // push rbx (keeps rsp 16-byte aligned at call sites)
+                0x41, 0x54,       // push r12
+                0x41, 0x55,       // push r13
+                0x41, 0x56,       // push r14
+                0x41, 0x57,       // push r15
+                0x49, 0x89, 0xFC, // mov r12, rdi
+                0x49, 0x89, 0xF5, // mov r13, rsi
+                0x49, 0x89, 0xD6, // mov r14, rdx
+                0x49, 0x89, 0xCF, // mov r15, rcx
+            };
+            bytes(code, sizeof(code));
+        }
+        void epilogue() {
+            static const u8 code[] = {
+                0x41, 0x5F, // pop r15
+                0x41, 0x5E, // pop r14
+                0x41, 0x5D, // pop r13
+                0x41, 0x5C, // pop r12
+                0x5B,       // pop rbx
+                0xC3,       // ret
+            };
+            bytes(code, sizeof(code));
+        }
+        void countInstruction() { byte(0x41); byte(0xFF); byte(0x07); }                        // inc dword [r15]
+        void storePc(u32 value) { byte(0x41); byte(0xC7); byte(0x45); byte(0x00); dword(value); } // mov dword [r13], imm32
+        void cmpPc(u32 value) { byte(0x41); byte(0x81); byte(0x7D); byte(0x00); dword(value); }   // cmp dword [r13], imm32
+        void callHandler(PLCDecodedHandler handler, const PLCDecodedOp* op) {
+            byte(0x4C); byte(0x89); byte(0xE7);              // mov rdi, r12
+            byte(0x48); byte(0xBE); qword((u64) op);         // mov rsi, imm64
+            byte(0x4C); byte(0x89); byte(0xEA);              // mov rdx, r13
+            byte(0x4C); byte(0x89); byte(0xF1);              // mov rcx, r14
+            byte(0x48); byte(0xB8); qword((u64) handler);    // mov rax, imm64
+            byte(0xFF); byte(0xD0);                          // call rax
+        }
+        void testStatus() { byte(0x85); byte(0xC0); }                  // test eax, eax
+        void clearStatus() { byte(0x31); byte(0xC0); }                 // xor eax, eax
+        void jmp(u32 target) { byte(0xE9); rel32(target); }
+        void jne(u32 target) { byte(0x0F); byte(0x85); rel32(target); }
+        void jae(u32 target) { byte(0x0F); byte(0x83); rel32(target); }
+        // Jump through the record entry table: pc (already checked < count) indexes `table`
+        void jmpTable(u64 table) {
+            byte(0x41); byte(0x8B); byte(0x45); byte(0x00); // mov eax, [r13]
+            byte(0x48); byte(0xB9); qword(table);           // mov rcx, imm64
+            byte(0xFF); byte(0x24); byte(0xC1);             // jmp [rcx + rax * 8]
+        }
+        void cmpPcCount(u32 count) {
+            byte(0x41); byte(0x8B); byte(0x45); byte(0x00); // mov eax, [r13]
+            byte(0x3D); dword(count);                       // cmp eax, imm32
+        }
+        void align(u32 alignment) { while (pos % alignment) byte(0xCC); }
+    };
+
+    struct Labels {
+        u32* record = nullptr; // Entry point of each record
+        u32 end = 0;           // Normal end of the program (status 0)
+        u32 dispatch = 0;      // pc changed to an unknown record
+        u32 exit = 0;          // Return with the status in eax
+        u32 table = 0;         // Record entry table (absolute addresses)
+    };
+
+    // Emit the whole program. The first pass (e.buf == nullptr) fills in the labels.
+    void emitProgram(Emitter& e, Labels& l, const PLCDecodedProgram& d) {
+        const u32 count = d.count;
+        e.prologue();
+        for (u32 i = 0; i < count; i++) {
+            const PLCDecodedOp& op = d.ops[i];
+            l.record[i] = e.pos;
+            e.countInstruction();
+            if (op.handler == PLCPredecode::op_nop) continue;
+            if (op.handler == PLCPredecode::op_jmp) {
+                e.jmp(l.record[op.arg]);
+                continue;
+            }
+            e.storePc(i + 1);
+            e.callHandler(op.handler, &op);
+            e.testStatus();
+            e.jne(l.exit);
+            if (op.handler == PLCPredecode::op_call) {
+                e.jmp(l.record[op.arg]);
+            } else if (op.handler == PLCPredecode::op_jmp_if || op.handler == PLCPredecode::op_jmp_if_not ||
+                       op.handler == PLCPredecode::op_call_if || op.handler == PLCPredecode::op_call_if_not) {
+                e.cmpPc(i + 1);
+                e.jne(l.record[op.arg]);
+            } else if (op.handler == PLCPredecode::op_generic) {
+                e.cmpPc(i + 1);
+                e.jne(l.dispatch);
+            }
+        }
+        l.end = e.pos;
+        e.clearStatus();
+        l.exit = e.pos;
+        e.epilogue();
+        l.dispatch = e.pos;
+        e.cmpPcCount(count);
+        e.jae(l.end); // Also covers PLC_DECODED_HANDOFF
+        e.jmpTable((u64) e.buf + l.table);
+        e.align(8);
+        l.table = e.pos;
+        for (u32 i = 0; i < count; i++) e.qword((u64) e.buf + l.record[i]);
+    }
+
+} // namespace PLCJit
+
+bool PLCJitProgram::compile(PLCDecodedProgram& decoded) {
+    release();
+    if (!decoded.valid || decoded.count == 0) return false;
+    PLCJit::Labels labels;
+    labels.record = new u32[decoded.count];
+    for (u32 i = 0; i < decoded.count; i++) labels.record[i] = 0;
+
+    // Pass 1: layout only, every encoding has a fixed size so the labels stay valid for pass 2
+    PLCJit::Emitter e;
+    PLCJit::emitProgram(e, labels, decoded);
+    const u32 size = e.pos;
+
+    // Pass 2: write the code into a writable mapping, then flip it to executable
+    const u32 page = 4096;
+    capacity = (size + page - 1) / page * page;
+    void* mem = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (mem == MAP_FAILED) {
+        delete[] labels.record;
+        capacity = 0;
+        return false;
+    }
+    code = (u8*) mem;
+    e = PLCJit::Emitter();
+    e.buf = code;
+    PLCJit::emitProgram(e, labels, decoded);
+    delete[] labels.record;
+    if (e.pos != size || mprotect(code, capacity, PROT_READ | PROT_EXEC) != 0) {
+        release();
+        return false;
+    }
+    code_size = size;
+    entry = (PLCJitEntry) (void*) code;
+    valid = true;
+    return true;
+}
+
+#endif // PLCRUNTIME_JIT_ENABLED
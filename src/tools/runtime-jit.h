@@ -0,0 +1,78 @@
+// runtime-jit.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-predecode.h"
+
+#ifdef PLCRUNTIME_JIT_ENABLED
+
+#include <sys/mman.h>
+
+// ============================================================================
+// Native code for the pre-decoded program
+// ============================================================================
+// The generated function has the signature of PLCJitEntry and executes the
+// decoded records in order. Each record is translated to:
+//
+//     inc   [instruction_count]
+//     mov   [pc], <next record>
+//     call  <specialized handler>(runtime, record, pc, tos)
+//     test  status; jnz exit
+//
+// followed, for records that may move `pc`, by a compare against the next
+// record and a native jump to the resolved target (or to the dispatcher that
+// maps `pc` through a table of record entry points). Unconditional jumps and
+// NOPs are emitted without a call. Status codes, `pc` hand-over and the
+// instruction count behave exactly like PLCDecodedProgram executed by
+// runDecoded(), which remains the fallback when code allocation fails.
+// ============================================================================
+
+class VovkPLCRuntime;
+
+typedef RuntimeError (*PLCJitEntry)(VovkPLCRuntime* runtime, u32* pc, PLCDecodedTos* tos, u32* instruction_count);
+
+struct PLCJitProgram {
+    u8* code = nullptr;         // Executable mapping holding the code and the dispatch table
+    u32 capacity = 0;           // Size of the mapping in bytes
+    u32 code_size = 0;          // Bytes of generated code
+    PLCJitEntry entry = nullptr;
+    bool valid = false;
+
+    void release() {
+        if (code) munmap(code, capacity);
+        code = nullptr;
+        capacity = 0;
+        code_size = 0;
+        entry = nullptr;
+        valid = false;
+    }
+
+    PLCJitProgram() {}
+    PLCJitProgram(const PLCJitProgram&) = delete;
+    PLCJitProgram& operator=(const PLCJitProgram&) = delete;
+    ~PLCJitProgram() { release(); }
+
+    // Translate the decoded program, returns false (and stays invalid) if it can not be compiled
+    bool compile(PLCDecodedProgram& decoded);
+};
+
+#endif // PLCRUNTIME_JIT_ENABLED
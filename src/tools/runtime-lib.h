@@ -93,15 +93,24 @@
 #include "stack/runtime-stack.h"
 #include "runtime-interval.h"
 #include "arithmetics/crc8.h"
+#include "arithmetics/crc32.h"
 #include "stack/stack-struct-impl.h"
 #include "runtime-instructions.h"
 #include "stack/runtime-stack.h"
 #include "arithmetics/runtime-arithmetics.h"
 #include "runtime-program.h"
+#include "runtime-predecode.h"
+#include "runtime-verifier.h"
+#include "runtime-jit.h"
+#include "runtime-aot.h"
+#include "runtime-process-image.h"
+#include "runtime-binary-protocol.h"
+#include "runtime-online-change.h"
 #include "runtime-datablock.h"
 #include "runtime-thread.h"
 #ifdef PLCRUNTIME_FFI_ENABLED
 #include "runtime-ffi.h"
+#include "runtime-ffi-async.h"
 #endif // PLCRUNTIME_FFI_ENABLED
 
 // Transport system (optional - define PLCRUNTIME_TRANSPORT to enable)
@@ -342,6 +351,21 @@ private:
     PLCTransportInterface* _activeTransport = nullptr;
 #endif // PLCRUNTIME_TRANSPORT
 
+#ifdef PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+    // Binary framed protocol ports and the download in progress
+    PLCFramePort serial_frames;
+#ifdef PLCRUNTIME_TRANSPORT
+    PLCFramePort transport_frames;
+#endif // PLCRUNTIME_TRANSPORT
+    PLCFrameDownload frame_download;
+    u32 scan_count = 0; // Completed run() calls, paces subscription pushes
+
+    // Push subscription changes, then feed available bytes from `io` and handle at most one complete frame
+    template <typename IO> void pollFrames(IO& io, PLCFramePort& port);
+    template <typename IO> void handleFrame(IO& io, PLCFramePort& port);
+    template <typename IO> void pushSubscription(IO& io, PLCFramePort& port);
+#endif // PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+
     void updateRamStats() {
         int free_mem = freeMemory();
         u32 free_u32 = free_mem < 0 ? 0u : (u32) free_mem;
@@ -400,6 +424,28 @@ public:
     u32 last_run_timestamp_us = 0;
     u32 previous_period_us = 0;
     u32 last_instruction_count = 0; // Number of instructions executed in last run()
+    PLCClock clock; // Time base and system pulses of this runtime
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+    PLCDecodedProgram decoded; // Pre-decoded form of the active program, rebuilt on load/modify
+#endif // PLCRUNTIME_PREDECODE_ENABLED
+#ifdef PLCRUNTIME_VERIFIER_ENABLED
+    PLCVerifier verifier; // Scratch space of the load-time verifier run by predecode()
+#endif // PLCRUNTIME_VERIFIER_ENABLED
+#ifdef PLCRUNTIME_JIT_ENABLED
+    PLCJitProgram jit; // Native code for `decoded`, rebuilt together with it
+#endif // PLCRUNTIME_JIT_ENABLED
+#ifdef PLCRUNTIME_AOT_ENABLED
+    PLCAotBinding aot; // Ahead-of-time compiled form of the program, see loadNativeProgram()
+#endif // PLCRUNTIME_AOT_ENABLED
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+    PLCProgramStage staged; // Shadow program of an online change, swapped in by run() at the scan boundary
+    RuntimeError program_change_status = STATUS_SUCCESS; // Result of the last applyStagedProgram()
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
+#ifdef PLCRUNTIME_PROCESS_IMAGE_ENABLED
+    PLCImageExchange<PLCRUNTIME_NUM_OF_INPUTS> input_image; // I/O side writes, run() reads
+    PLCImageExchange<PLCRUNTIME_NUM_OF_OUTPUTS> output_image; // run() writes, I/O side reads
+    u8 input_staging[PLCRUNTIME_NUM_OF_INPUTS] = { 0 }; // Input image being assembled by the I/O side
+#endif // PLCRUNTIME_PROCESS_IMAGE_ENABLED
 
     static void splash() {
         Serial.println();
@@ -647,53 +693,17 @@ public:
     }
 
     // ========================================================================
-    // Simple FFI Registration (template-based auto-marshalling)
+    // Simple FFI Registration (compile-time binding)
     // ========================================================================
-    // These overloads allow registering normal C++ functions directly:
+    // Registers a normal C++ function of up to PLCRUNTIME_FFI_MAX_PARAMS parameters:
     //   bool motor_goto(i32 position) { return true; }
     //   runtime.registerFFI("F_motor_goto", "i32->bool", "Move motor", motor_goto);
-    // The templates automatically generate marshalling code at compile time.
+    // The call thunk and type descriptor are generated from the function type.
+    // Returns -1 when the signature string does not describe the function.
     // ========================================================================
 
-    // 0 parameters: Ret fn()
-    template<typename Ret>
-    i8 registerFFI(const char* name, const char* sig, const char* desc, Ret (*fn)()) {
-        return g_ffiRegistry.add(name, sig, desc, fn);
-    }
-
-    // 1 parameter: Ret fn(A1)
-    template<typename Ret, typename A1>
-    i8 registerFFI(const char* name, const char* sig, const char* desc, Ret (*fn)(A1)) {
-        return g_ffiRegistry.add(name, sig, desc, fn);
-    }
-
-    // 2 parameters: Ret fn(A1, A2)
-    template<typename Ret, typename A1, typename A2>
-    i8 registerFFI(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2)) {
-        return g_ffiRegistry.add(name, sig, desc, fn);
-    }
-
-    // 3 parameters: Ret fn(A1, A2, A3)
-    template<typename Ret, typename A1, typename A2, typename A3>
-    i8 registerFFI(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2, A3)) {
-        return g_ffiRegistry.add(name, sig, desc, fn);
-    }
-
-    // 4 parameters: Ret fn(A1, A2, A3, A4)
-    template<typename Ret, typename A1, typename A2, typename A3, typename A4>
-    i8 registerFFI(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2, A3, A4)) {
-        return g_ffiRegistry.add(name, sig, desc, fn);
-    }
-
-    // 5 parameters: Ret fn(A1, A2, A3, A4, A5)
-    template<typename Ret, typename A1, typename A2, typename A3, typename A4, typename A5>
-    i8 registerFFI(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2, A3, A4, A5)) {
-        return g_ffiRegistry.add(name, sig, desc, fn);
-    }
-
-    // 6 parameters: Ret fn(A1, A2, A3, A4, A5, A6)
-    template<typename Ret, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6>
-    i8 registerFFI(const char* name, const char* sig, const char* desc, Ret (*fn)(A1, A2, A3, A4, A5, A6)) {
+    template<typename Ret, typename... A>
+    i8 registerFFI(const char* name, const char* sig, const char* desc, Ret (*fn)(A...)) {
         return g_ffiRegistry.add(name, sig, desc, fn);
     }
 
@@ -763,15 +773,112 @@ public:
     PLCFFIRegistry* getFFIRegistry() {
         return &g_ffiRegistry;
     }
+
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+    // ========================================================================
+    // Asynchronous FFI (long-running functions, see runtime-ffi-async.h)
+    // ========================================================================
+    //   bool motor_home(u8 axis) { ...; return true; }
+    //   runtime.registerFFIAsync("F_motor_home", "u8->bool", "Home axis", motor_home);
+    // The bytecode starts the call with FFI_START and polls it with FFI_POLL.
+    // ========================================================================
+
+    /**
+     * @brief Register a long-running FFI function (started with FFI_START)
+     * @return Function index on success, -1 on failure or for string signatures
+     */
+    template<typename Fn>
+    i8 registerFFIAsync(const char* name, const char* sig, const char* desc, Fn fn) {
+        return g_ffiRegistry.addAsync(name, sig, desc, fn);
+    }
+
+    /**
+     * @brief Mark a registered FFI function as long-running or back to synchronous
+     * @return true on success
+     */
+    bool setFFIAsync(u8 index, bool async) {
+        return g_ffiRegistry.setAsync(index, async);
+    }
+
+    /**
+     * @brief Run queued async FFI jobs on the calling thread (call between scans)
+     * @param max_jobs Maximum number of jobs to run
+     * @return Number of jobs run
+     */
+    u8 serviceFFI(u8 max_jobs = 1) {
+        return g_ffiAsync.service(max_jobs);
+    }
+
+    /**
+     * @brief Number of async FFI jobs queued or running
+     */
+    u8 getFFIPending() const {
+        return g_ffiAsync.pending();
+    }
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
 #endif // PLCRUNTIME_FFI_ENABLED
 
     void loadProgramUnsafe(const u8* program, u32 prog_size) {
         this->program.loadUnsafe(program, prog_size);
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+        g_ffiAsync.cancel(memory); // Handles of the previous program are meaningless to the new one
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+        predecode();
+#endif // PLCRUNTIME_PREDECODE_ENABLED
     }
 
     void loadProgram(const u8* program, u32 prog_size, u8 checksum) {
         this->program.load(program, prog_size, checksum);
-    }
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+        g_ffiAsync.cancel(memory); // Handles of the previous program are meaningless to the new one
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+        predecode();
+#endif // PLCRUNTIME_PREDECODE_ENABLED
+    }
+
+#ifdef PLCRUNTIME_AOT_ENABLED
+    // Load the bytecode of an ahead-of-time compiled program and run it natively while it stays loaded
+    void loadNativeProgram(const PLCAotProgram& native) {
+        loadProgram(native.bytecode, native.size, native.checksum);
+        aot.attach(&native);
+    }
+    // Go back to interpreting the loaded program
+    void detachNativeProgram() { aot.detach(); }
+#endif // PLCRUNTIME_AOT_ENABLED
+
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+    // Stage a program for an online change. It replaces the active program at the start of the next
+    // run(), memory (timers, counters, DataBlocks, ...) is kept. Returns the checksum or validation error
+    RuntimeError stageProgram(const u8* program, u32 prog_size, u8 checksum) {
+        u8 calculated_checksum = 0;
+        crc8_simple(calculated_checksum, program, prog_size);
+        if (calculated_checksum != checksum) {
+            staged.cancel();
+            return INVALID_CHECKSUM;
+        }
+        RuntimeError status = staged.begin(prog_size);
+        if (status == STATUS_SUCCESS) status = staged.write(0, program, prog_size);
+        if (status == STATUS_SUCCESS) status = staged.commit();
+        if (status != STATUS_SUCCESS) staged.cancel();
+        return status;
+    }
+    // True while a validated program waits for the scan boundary
+    bool programChangePending() const { return staged.ready(); }
+    // Result of the last swap: STATUS_SUCCESS, or why the staged program was dropped
+    RuntimeError programChangeStatus() const { return program_change_status; }
+    // Swap the staged program in now. run() calls this at the scan boundary
+    RuntimeError applyStagedProgram();
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
+
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+    // Decode the active program into the pre-decoded instruction cache
+    void predecode();
+    // Execute the active program from the pre-decoded cache. On return `index` holds the byte offset
+    // where the interpreter must continue (prog_size or beyond when the whole program was executed)
+    RuntimeError runDecoded(u32& index, u32& instruction_count);
+#endif // PLCRUNTIME_PREDECODE_ENABLED
 
     void updateGlobals();
 
@@ -781,6 +888,9 @@ public:
     void clear(RuntimeProgram& program);
     // Execute one PLC instruction at index, returns an error code (0 on success)
     RuntimeError step(u8* program, u32 prog_size, u32& index);
+    // Execute an instruction whose opcode was already read, `index` points right after the opcode.
+    // Always inlined so callers with a constant opcode (ahead-of-time compiled programs) get the handler call alone
+    inline RuntimeError execute(u8 opcode, u8* program, u32 prog_size, u32& index) __attribute__((always_inline));
     // Execute the whole PLC program, returns an error code (0 on success)
     RuntimeError run(u8* program, u32 prog_size);
     // Execute one PLC instruction, returns an error code (0 on success)
@@ -909,6 +1019,43 @@ public:
     }
 #endif // __AVR__
 
+#ifdef PLCRUNTIME_PROCESS_IMAGE_ENABLED
+    // Copy the staged inputs into a new input image, taken over by the next run()
+    void publishInputs() {
+        u8* slot = input_image.writeSlot();
+        for (u32 i = 0; i < PLCRUNTIME_NUM_OF_INPUTS; i++) slot[i] = input_staging[i];
+        input_image.publish();
+    }
+
+    // Write a block of inputs as one image, so multi-byte values are never seen half updated
+    bool writeInputs(u32 index, const u8* data, u32 size) {
+        if (index + size > PLCRUNTIME_NUM_OF_INPUTS) return false;
+        for (u32 i = 0; i < size; i++) input_staging[index + i] = data[i];
+        publishInputs();
+        return true;
+    }
+
+    // Read a block of outputs from the newest output image
+    bool readOutputs(u32 index, u8* data, u32 size) {
+        if (index + size > PLCRUNTIME_NUM_OF_OUTPUTS) return false;
+        output_image.fetch();
+        const u8* slot = output_image.readSlot();
+        for (u32 i = 0; i < size; i++) data[i] = slot[index + i];
+        return true;
+    }
+
+    void setInput(u32 index, byte value) {
+        writeInputs(index, &value, 1);
+    }
+
+    void setInputBit(u32 index, u8 bit, bool value) {
+        if (index >= PLCRUNTIME_NUM_OF_INPUTS) return;
+        u8 temp = input_staging[index];
+        if (value) temp |= (1 << bit);
+        else temp &= ~(1 << bit);
+        writeInputs(index, &temp, 1);
+    }
+#else
     void setInput(u32 index, byte value) {
         // memory.set(index + input_offset, value);
         memory[index + input_offset] = value;
@@ -924,6 +1071,7 @@ public:
         // memory.set(index + input_offset, temp);
         memory[index + input_offset] = temp;
     }
+#endif // PLCRUNTIME_PROCESS_IMAGE_ENABLED
 
 #ifndef __AVR__
     void setInputBit(float index, bool value) {
@@ -934,6 +1082,19 @@ public:
     }
 #endif // __AVR__
 
+#ifdef PLCRUNTIME_PROCESS_IMAGE_ENABLED
+    byte getOutput(u32 index) {
+        u8 value = 0;
+        readOutputs(index, &value, 1);
+        return value;
+    }
+
+    bool getOutputBit(u32 index, u8 bit) {
+        u8 temp = 0;
+        if (!readOutputs(index, &temp, 1)) return false;
+        return temp & (1 << bit);
+    }
+#else
     byte getOutput(u32 index) {
         byte value = 0;
         // memory.get(index + output_offset, value);
@@ -948,6 +1109,7 @@ public:
         if (error) return false;
         return temp & (1 << bit);
     }
+#endif // PLCRUNTIME_PROCESS_IMAGE_ENABLED
 
 #ifndef __AVR__
     bool getOutputBit(float index) {
@@ -1367,6 +1529,9 @@ public:
         // Check if any transport has data available
         uint8_t transportIndex = 0;
         _activeTransport = _transports.getActiveTransport(&transportIndex);
+#ifdef PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+        if (_activeTransport) pollFrames(*_activeTransport, transport_frames);
+#endif // PLCRUNTIME_BINARY_PROTOCOL_ENABLED
         
         // If we have transport data, process it through the transport system
         // Note: The existing Serial protocol can still be used in parallel
@@ -1380,8 +1545,22 @@ public:
             print_info_first_time = false;
         }
 
+#ifdef PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+        // Binary frames start with a sync byte that no hex command starts with
+        if (serial_frames.parser.busy() || (Serial.available() && Serial.peek() == PLC_FRAME_SYNC)) {
+            pollFrames(Serial, serial_frames);
+            return;
+        }
+        if (serial_frames.subscription.count) pushSubscription(Serial, serial_frames);
+#endif // PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+
         // If the serial port is available and the first character is not 'P' or 'M', skip the character
-        while (Serial.available() && Serial.peek() != 'R' && Serial.peek() != 'P' && Serial.peek() != 'M' && Serial.peek() != 'S' && Serial.peek() != 'T' && Serial.peek() != 'D' && Serial.peek() != '?') Serial.read();
+        while (Serial.available() && Serial.peek() != 'R' && Serial.peek() != 'P' && Serial.peek() != 'M' && Serial.peek() != 'S' && Serial.peek() != 'T' && Serial.peek() != 'D' && Serial.peek() != 'B' && Serial.peek() != '?') {
+#ifdef PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+            if (Serial.peek() == PLC_FRAME_SYNC) return; // Keep a frame that follows line noise for the next call
+#endif // PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+            Serial.read();
+        }
         if (Serial.available() > 1 || Serial.peek() == '?') {
             // Command syntax:
             // <command>[<size>][<data>]<checksum>
@@ -1410,7 +1589,9 @@ public:
             //  - DB write:         'DW<u16><u16><u16><u8[]><u8>' (db_number, offset, size, data, checksum) - Write to DataBlock
             //  - DB migrate:       'DM<u16><u16><u8>' (db_number, target_offset, checksum) - Migrate DataBlock to new location
             //  - DB compact:       'DK<u8>' (checksum) - Compact all DataBlocks
+            //  - Binary framing:   'BF<u8>' (checksum) - Query binary frame support: 'OK BF<u8><u16>' (version, max payload) // Only available if PLCRUNTIME_BINARY_PROTOCOL_ENABLED is defined
             // If the program is downloaded and the checksum is invalid, the runtime will restart
+            // (with PLCRUNTIME_ONLINE_CHANGE the download is staged instead and dropped on an invalid checksum)
             u8 cmd[2] = { 0, 0 };
             u32 size = 0;
             u32 address = 0;
@@ -1451,6 +1632,7 @@ public:
             bool db_write = cmd[0] == 'D' && cmd[1] == 'W';
             bool db_migrate = cmd[0] == 'D' && cmd[1] == 'M';
             bool db_compact = cmd[0] == 'D' && cmd[1] == 'K';
+            bool binary_framing = cmd[0] == 'B' && cmd[1] == 'F';
 
             if (ping) {
                 Serial.println(F("<VovkPLC>"));
@@ -1536,6 +1718,34 @@ public:
                 crc8_simple(checksum_calc, (size & 0xff));
 
 
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+                // Stage the data, the active program keeps its buffer until run() swaps the new one in
+                RuntimeError stage_status = staged.begin(size);
+                u8 b = 0;
+                for (u32 i = 0; i < size; i++) {
+                    b = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(staged.cancel());
+                    if (stage_status == STATUS_SUCCESS) stage_status = staged.write(i, &b, 1);
+                    crc8_simple(checksum_calc, b);
+                }
+
+                // Read the checksum
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_JOB(staged.cancel());
+
+                // A broken download is dropped, the active program continues
+                if (checksum != checksum_calc) {
+                    staged.cancel();
+                    Serial.println(F("Invalid checksum"));
+                    return;
+                }
+                if (stage_status == STATUS_SUCCESS) stage_status = staged.commit();
+                if (stage_status != STATUS_SUCCESS) {
+                    staged.cancel();
+                    Serial.print(F("ERR PROGRAM REJECTED "));
+                    Serial.println((int) stage_status);
+                    return;
+                }
+                Serial.println(F("PROGRAM DOWNLOAD COMPLETE"));
+#else
                 // Read the data
                 program.format();
                 program.prog_size = size;
@@ -1567,7 +1777,12 @@ public:
                 }
 #endif // PLCRUNTIME_EEPROM_STORAGE
 
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+                predecode();
+#endif // PLCRUNTIME_PREDECODE_ENABLED
+
                 Serial.println(F("PROGRAM DOWNLOAD COMPLETE"));
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
             } else if (program_upload) {
                 // Read the checksum
                 checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
@@ -2116,6 +2331,21 @@ public:
                 u16 new_lowest = dataBlocks.compact();
                 Serial.print(F("OK DB COMPACT LOWEST="));
                 Serial.println(new_lowest);
+            } else if (binary_framing) {
+                // BF - Binary framing negotiation
+                checksum = serialReadHexByteTimeout(); SERIAL_TIMEOUT_RETURN;
+                if (checksum != checksum_calc) { Serial.println(F("Invalid checksum")); return; }
+#ifdef PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+                Serial.print(F("OK BF"));
+                char c1, c2;
+                byteToHex(PLC_FRAME_VERSION, c1, c2);
+                Serial.print(c1);
+                Serial.print(c2);
+                printHexU16(PLCRUNTIME_BINARY_MAX_PAYLOAD);
+                Serial.println();
+#else
+                Serial.println(F("ERR BF UNSUPPORTED"));
+#endif // PLCRUNTIME_BINARY_PROTOCOL_ENABLED
             }
         }
 #endif // PLCRUNTIME_SERIAL_ENABLED
@@ -2148,76 +2378,75 @@ int VovkPLCRuntime::printStack() { return stack.print(); }
 void VovkPLCRuntime::updateGlobals() {
     u32 base = system_offset;
     u8 state = 0;
-    state = state << 1 | P_10s; // 2.7
-    state = state << 1 | P_5s; // 2.6
-    state = state << 1 | P_2s; // 2.5
-    state = state << 1 | P_1s; // 2.4
-    state = state << 1 | P_500ms; // 2.3
-    state = state << 1 | P_300ms; // 2.2
-    state = state << 1 | P_200ms; // 2.1
-    state = state << 1 | P_100ms; // 2.0
+    state = state << 1 | clock.P_10s; // 2.7
+    state = state << 1 | clock.P_5s; // 2.6
+    state = state << 1 | clock.P_2s; // 2.5
+    state = state << 1 | clock.P_1s; // 2.4
+    state = state << 1 | clock.P_500ms; // 2.3
+    state = state << 1 | clock.P_300ms; // 2.2
+    state = state << 1 | clock.P_200ms; // 2.1
+    state = state << 1 | clock.P_100ms; // 2.0
     memory[base + 2] = state;
 
     state = 0;
-    state = state << 1 | P_1hr; // 3.7
-    state = state << 1 | P_30min; // 3.6
-    state = state << 1 | P_15min; // 3.5
-    state = state << 1 | P_10min; // 3.4
-    state = state << 1 | P_5min; // 3.3
-    state = state << 1 | P_2min; // 3.2
-    state = state << 1 | P_1min; // 3.1
-    state = state << 1 | P_30s; // 3.0
+    state = state << 1 | clock.P_1hr; // 3.7
+    state = state << 1 | clock.P_30min; // 3.6
+    state = state << 1 | clock.P_15min; // 3.5
+    state = state << 1 | clock.P_10min; // 3.4
+    state = state << 1 | clock.P_5min; // 3.3
+    state = state << 1 | clock.P_2min; // 3.2
+    state = state << 1 | clock.P_1min; // 3.1
+    state = state << 1 | clock.P_30s; // 3.0
     memory[base + 3] = state;
 
     state = 0;
-    state = state << 1 | P_1day; // 4.6
-    state = state << 1 | P_12hr; // 4.5
-    state = state << 1 | P_6hr; // 4.4
-    state = state << 1 | P_5hr; // 4.3
-    state = state << 1 | P_4hr; // 4.2
-    state = state << 1 | P_3hr; // 4.1
-    state = state << 1 | P_2hr; // 4.0
+    state = state << 1 | clock.P_1day; // 4.6
+    state = state << 1 | clock.P_12hr; // 4.5
+    state = state << 1 | clock.P_6hr; // 4.4
+    state = state << 1 | clock.P_5hr; // 4.3
+    state = state << 1 | clock.P_4hr; // 4.2
+    state = state << 1 | clock.P_3hr; // 4.1
+    state = state << 1 | clock.P_2hr; // 4.0
     memory[base + 4] = state;
 
     state = 0;
-    state = state << 1 | S_10s; // 5.7
-    state = state << 1 | S_5s; // 5.6
-    state = state << 1 | S_2s; // 5.5
-    state = state << 1 | S_1s; // 5.4
-    state = state << 1 | S_500ms; // 5.3
-    state = state << 1 | S_300ms; // 5.2 
-    state = state << 1 | S_200ms; // 5.1
-    state = state << 1 | S_100ms; // 5.0
+    state = state << 1 | clock.S_10s; // 5.7
+    state = state << 1 | clock.S_5s; // 5.6
+    state = state << 1 | clock.S_2s; // 5.5
+    state = state << 1 | clock.S_1s; // 5.4
+    state = state << 1 | clock.S_500ms; // 5.3
+    state = state << 1 | clock.S_300ms; // 5.2 
+    state = state << 1 | clock.S_200ms; // 5.1
+    state = state << 1 | clock.S_100ms; // 5.0
     memory[base + 5] = state;
 
     state = 0;
-    state = state << 1 | S_1hr; // 6.7
-    state = state << 1 | S_30min; // 6.6
-    state = state << 1 | S_15min; // 6.5
-    state = state << 1 | S_10min; // 6.4
-    state = state << 1 | S_5min; // 6.3
-    state = state << 1 | S_2min; // 6.2
-    state = state << 1 | S_1min; // 6.1
-    state = state << 1 | S_30s; // 6.0
+    state = state << 1 | clock.S_1hr; // 6.7
+    state = state << 1 | clock.S_30min; // 6.6
+    state = state << 1 | clock.S_15min; // 6.5
+    state = state << 1 | clock.S_10min; // 6.4
+    state = state << 1 | clock.S_5min; // 6.3
+    state = state << 1 | clock.S_2min; // 6.2
+    state = state << 1 | clock.S_1min; // 6.1
+    state = state << 1 | clock.S_30s; // 6.0
     memory[base + 6] = state;
 
-    memory[base + 8] = interval_time_seconds;
-    memory[base + 9] = interval_time_minutes;
-    memory[base + 10] = interval_time_hours;
-    memory[base + 11] = interval_time_days;
+    memory[base + 8] = clock.time_seconds;
+    memory[base + 9] = clock.time_minutes;
+    memory[base + 10] = clock.time_hours;
+    memory[base + 11] = clock.time_days;
 
-    writeMemory(base + 12, (u8*) &uptime_seconds, sizeof(u32));
+    writeMemory(base + 12, (u8*) &clock.uptime_seconds, sizeof(u32));
 
     // System Time (Unix Timestamp style) - Offset 16 (4 bytes)
     // Read from memory, increment if 1s elapsed, write back
-    static bool _last_P_1s = false;
-    if (P_1s && !_last_P_1s) {
+    if (clock.P_1s && !clock.last_P_1s) {
         // Increment system time in memory (Little Endian)
         u32 t_current = read_u32(memory + base + 16);
         t_current++;
         write_u32(memory + base + 16, t_current);
     }
-    _last_P_1s = P_1s;
+    clock.last_P_1s = clock.P_1s;
 
     // First Cycle Flag - Offset 20 (1 bit / byte)
     // 1 during the first cycle, 0 otherwise
@@ -2228,6 +2457,69 @@ void VovkPLCRuntime::updateGlobals() {
     }
 }
 
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+RuntimeError VovkPLCRuntime::applyStagedProgram() {
+    if (!staged.ready()) return NO_PROGRAM;
+    const u8* code = staged.program;
+    const u32 size = staged.size;
+
+    // DataBlocks of the new program, in the order its CONFIG_DB instructions declare them.
+    // The compiler addresses them at the offsets that order gives on an empty table.
+    u16 db_numbers[PLCRUNTIME_DB_MAX_SLOTS];
+    u16 db_sizes[PLCRUNTIME_DB_MAX_SLOTS];
+    u16 db_count = 0;
+    bool declares = false;
+    RuntimeError status = STATUS_SUCCESS;
+    for (u32 index = 0; index < size && status == STATUS_SUCCESS; index += INSTRUCTION_SIZE(code, size, index)) {
+        if (code[index] != CONFIG_DB) continue;
+        declares = true;
+        u8 count = code[index + 1];
+        for (u8 i = 0; i < count; i++) {
+            u16 db_num = read_u16(code + index + 2 + i * 4);
+            u16 db_size = read_u16(code + index + 4 + i * 4);
+            bool repeated = false;
+            for (u16 j = 0; j < db_count && !repeated; j++) repeated = db_numbers[j] == db_num;
+            if (repeated || db_num == 0 || db_size == 0) continue; // CONFIG_DB skips these as well
+            if (db_count >= PLCRUNTIME_DB_MAX_SLOTS) {
+                status = INVALID_MEMORY_SIZE;
+                break;
+            }
+            db_numbers[db_count] = db_num;
+            db_sizes[db_count] = db_size;
+            db_count++;
+        }
+    }
+    // Move the DataBlocks to that layout with their data, a program without CONFIG_DB leaves them alone
+    if (status == STATUS_SUCCESS && declares && !dataBlocks.relayout(db_numbers, db_sizes, db_count)) status = INVALID_MEMORY_SIZE;
+    program_change_status = status;
+    if (status != STATUS_SUCCESS) {
+        staged.cancel();
+        return status;
+    }
+
+    memcpy(program.program, code, size);
+    program.prog_size = size;
+    program.revision++;
+    program.status = STATUS_SUCCESS;
+    program.resetLine();
+    staged.cancel();
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+    g_ffiAsync.cancel(memory); // Handles of the previous program are meaningless to the new one
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
+#ifdef PLCRUNTIME_EEPROM_STORAGE
+    u8 prog_checksum = 0;
+    crc8_simple(prog_checksum, program.program, program.prog_size);
+    if (!EEPROMStorage::saveProgram(program.program, program.prog_size, prog_checksum)) {
+        Serial.println(F("Warning: Failed to save program to EEPROM"));
+    }
+#endif // PLCRUNTIME_EEPROM_STORAGE
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+    predecode();
+#endif // PLCRUNTIME_PREDECODE_ENABLED
+    return STATUS_SUCCESS;
+}
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
+
 // Execute the whole PLC program, returns an erro code (0 on success)
 RuntimeError VovkPLCRuntime::run(RuntimeProgram& program) { return run(program.program, program.prog_size); }
 
@@ -2235,10 +2527,33 @@ RuntimeError VovkPLCRuntime::run(RuntimeProgram& program) { return run(program.p
 RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     u32 start_us = (u32) micros();
 
-#ifndef __WASM__ // WASM can optionally execute the global loop check, embedded systems must always call this
-    IntervalGlobalLoopCheck();
+#ifndef __WASM__ // WASM updates the clock from its exports, embedded systems always poll it here
+    if (!clock.external) clock.update(millis());
 #endif // __WASM__
 
+#ifdef PLCRUNTIME_PROCESS_IMAGE_ENABLED
+    // Take over the newest input image; without a new one the input area keeps its contents
+    if (input_image.fetch()) {
+        const u8* inputs = input_image.readSlot();
+        for (u32 i = 0; i < PLCRUNTIME_NUM_OF_INPUTS; i++) memory[input_offset + i] = inputs[i];
+    }
+#endif // PLCRUNTIME_PROCESS_IMAGE_ENABLED
+
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+    // Scan boundary: a staged program replaces the active one before this cycle starts
+    // A rejected change keeps the active program running and is reported by this cycle
+    RuntimeError change_status = STATUS_SUCCESS;
+    if (staged.ready() && program == this->program.program) {
+        change_status = applyStagedProgram();
+        prog_size = this->program.prog_size;
+    }
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
+
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+    // Results of async FFI calls that finished since the last cycle become visible here
+    g_ffiAsync.commit(memory);
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
+
 #ifdef PLCRUNTIME_VARIABLE_REGISTRATION_ENABLED
 #ifndef PLCRUNTIME_VARIABLE_REGISTRATION_MANUAL_SYNC
     // Sync registered input variables to PLC memory before execution
@@ -2269,6 +2584,37 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     u32 instruction_count = 0;
     RuntimeError status = STATUS_SUCCESS;
 
+#ifdef PLCRUNTIME_AOT_ENABLED
+    // Native code of the active program, built into the firmware. Like the pre-decoded cache
+    // it hands over to the interpreter below at `index` when it leaves early.
+    const bool native = program == this->program.program && prog_size == this->program.prog_size && aot.active(this->program);
+    if (native) {
+        status = aot.native->entry(*this, index);
+        if (status == PROGRAM_EXITED) {
+            status = STATUS_SUCCESS;
+            index = prog_size;
+        }
+        if (status != STATUS_SUCCESS) goto _run_done;
+    }
+#elif defined(PLCRUNTIME_PREDECODE_ENABLED)
+    const bool native = false;
+#endif // PLCRUNTIME_AOT_ENABLED
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+    // Run the pre-decoded cache when executing the active program. Anything the cache
+    // could not resolve is handed over to the interpreter below at `index`.
+    if (!native && program == this->program.program && prog_size == this->program.prog_size) {
+        if (!decoded.valid || decoded.revision != this->program.revision || decoded.prog_size != prog_size) predecode();
+        // A verified program relies on its proven stack peak fitting above what is already on the stack,
+        // otherwise the checked interpreter below runs the whole cycle. Without memory for the cache it stays invalid and the interpreter runs too.
+        if (decoded.valid && (!decoded.verified || stack.size() + decoded.max_stack <= PLCRUNTIME_MAX_STACK_SIZE)) status = runDecoded(index, instruction_count);
+        if (status == PROGRAM_EXITED) {
+            status = STATUS_SUCCESS;
+            index = prog_size;
+        }
+        if (status != STATUS_SUCCESS) goto _run_done;
+    }
+#endif // PLCRUNTIME_PREDECODE_ENABLED
+
 #ifdef PLCRUNTIME_USE_COMPUTED_GOTO
     // ========================================================================
     // Threaded-code dispatch: each handler jumps directly to the next
@@ -2313,7 +2659,7 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         /* 0x1C */ _OP_LABEL(PICK),
         /* 0x1D */ _OP_LABEL(POKE),
         /* 0x1E */ _OP_LABEL(MEM_FILL),
-        /* 0x1F */ _OP_UNKNOWN,
+        /* 0x1F */ _OP_LABEL(LOAD_CMP_IMM),
         /* 0x20 */ _OP_LABEL(ADD),
         /* 0x21 */ _OP_LABEL(SUB),
         /* 0x22 */ _OP_LABEL(MUL),
@@ -2322,14 +2668,14 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         /* 0x25 */ _OP_LABEL(POW),
         /* 0x26 */ _OP_LABEL(SQRT),
         /* 0x27 */ _OP_LABEL(NEG),
-        /* 0x28 */ _OP_UNKNOWN, // reserved
-        /* 0x29 */ _OP_LABEL(ABS),
-        /* 0x2A */ _OP_UNKNOWN, // reserved
+        /* 0x28 */ _OP_LABEL(ABS),
+        /* 0x29 */ _OP_LABEL(SIN),
+        /* 0x2A */ _OP_LABEL(COS),
         /* 0x2B */ _OP_UNKNOWN, // reserved
-        /* 0x2C */ _OP_UNKNOWN, // reserved
-        /* 0x2D */ _OP_UNKNOWN, // reserved
-        /* 0x2E */ _OP_LABEL(SIN),
-        /* 0x2F */ _OP_LABEL(COS),
+        /* 0x2C */ _OP_LABEL(READ_AND_X8),
+        /* 0x2D */ _OP_LABEL(READ_OR_X8),
+        /* 0x2E */ _OP_LABEL(READ_AND_WRITE_X8),
+        /* 0x2F */ _OP_LABEL(LOAD_CMP_IMM_JMP_IF_NOT),
         /* 0x30 */ _OP_LABEL(TON_CONST),
         /* 0x31 */ _OP_LABEL(TON_MEM),
         /* 0x32 */ _OP_LABEL(TOF_CONST),
@@ -2478,10 +2824,10 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         /* 0xC1 */ _OP_LABEL(LOGIC_OR),
         /* 0xC2 */ _OP_LABEL(LOGIC_XOR),
         /* 0xC3 */ _OP_LABEL(LOGIC_NOT),
-        /* 0xC4 */ _OP_UNKNOWN,
-        /* 0xC5 */ _OP_UNKNOWN,
-        /* 0xC6 */ _OP_UNKNOWN,
-        /* 0xC7 */ _OP_UNKNOWN,
+        /* 0xC4 */ _OP_LABEL(BIT_GATHER_X32),
+        /* 0xC5 */ _OP_LABEL(BIT_GATHER_X64),
+        /* 0xC6 */ _OP_LABEL(BIT_SCATTER_X32),
+        /* 0xC7 */ _OP_LABEL(BIT_SCATTER_X64),
         /* 0xC8 */ _OP_UNKNOWN,
         /* 0xC9 */ _OP_UNKNOWN,
         /* 0xCA */ _OP_UNKNOWN,
@@ -2493,8 +2839,8 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         /* 0xD0 */ _OP_LABEL(CMP_EQ),
         /* 0xD1 */ _OP_LABEL(CMP_NEQ),
         /* 0xD2 */ _OP_LABEL(CMP_GT),
-        /* 0xD3 */ _OP_LABEL(CMP_GTE),
-        /* 0xD4 */ _OP_LABEL(CMP_LT),
+        /* 0xD3 */ _OP_LABEL(CMP_LT),
+        /* 0xD4 */ _OP_LABEL(CMP_GTE),
         /* 0xD5 */ _OP_LABEL(CMP_LTE),
         /* 0xD6 */ _OP_UNKNOWN,
         /* 0xD7 */ _OP_UNKNOWN,
@@ -2504,8 +2850,8 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         /* 0xDB */ _OP_UNKNOWN,
         /* 0xDC */ _OP_UNKNOWN,
         /* 0xDD */ _OP_UNKNOWN,
-        /* 0xDE */ _OP_UNKNOWN,
-        /* 0xDF */ _OP_UNKNOWN,
+        /* 0xDE */ _OP_LABEL(FFI_START),
+        /* 0xDF */ _OP_LABEL(FFI_POLL),
         /* 0xE0 */ _OP_LABEL(JMP),
         /* 0xE1 */ _OP_LABEL(JMP_IF),
         /* 0xE2 */ _OP_LABEL(JMP_IF_NOT),
@@ -2521,7 +2867,7 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         /* 0xEC */ _OP_LABEL(CALL_REL),
         /* 0xED */ _OP_LABEL(CALL_IF_REL),
         /* 0xEE */ _OP_LABEL(CALL_IF_NOT_REL),
-        /* 0xEF */ _OP_UNKNOWN,
+        /* 0xEF */ _OP_LABEL(FFI_CALL_BATCH),
         /* 0xF0 */ _OP_LABEL(FFI_CALL),
         /* 0xF1 */ _OP_LABEL(FFI_CALL_STACK),
         /* 0xF2 */ _OP_LABEL(STR_TO_NUM),
@@ -2532,7 +2878,7 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         /* 0xF7 */ _OP_LABEL(CSTR_EQ),
         /* 0xF8 */ _OP_LABEL(CSTR_CAT),
         /* 0xF9 */ _OP_UNKNOWN,
-        /* 0xFA */ _OP_UNKNOWN,
+        /* 0xFA */ _OP_LABEL(BR_SAVE_READ),
         /* 0xFB */ _OP_LABEL(CONFIG_DB),
         /* 0xFC */ _OP_LABEL(CONFIG_TC),
         /* 0xFD */ _OP_LABEL(LANG),
@@ -2595,6 +2941,12 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
 #endif
     _op_MEM_FILL:  _OP_CALL(PLCMethods::MEM_FILL(this->memory, program, prog_size, index));
 
+    _op_LOAD_CMP_IMM:            _OP_CALL(PLCMethods::LOAD_CMP_IMM(this->stack, this->memory, program, prog_size, index));
+    _op_LOAD_CMP_IMM_JMP_IF_NOT: _OP_CALL(PLCMethods::LOAD_CMP_IMM_JMP_IF_NOT(this->stack, this->memory, program, prog_size, index));
+    _op_READ_AND_X8:             _OP_CALL(PLCMethods::READ_AND_X8(this->stack, this->memory, program, prog_size, index));
+    _op_READ_OR_X8:              _OP_CALL(PLCMethods::READ_OR_X8(this->stack, this->memory, program, prog_size, index));
+    _op_READ_AND_WRITE_X8:       _OP_CALL(PLCMethods::READ_AND_WRITE_X8(this->stack, this->memory, program, prog_size, index));
+
     _op_JMP:               _OP_CALL(PLCMethods::handle_JMP(this->stack, program, prog_size, index));
     _op_JMP_IF:            _OP_CALL(PLCMethods::handle_JMP_IF(this->stack, program, prog_size, index));
     _op_JMP_IF_NOT:        _OP_CALL(PLCMethods::handle_JMP_IF_NOT(this->stack, program, prog_size, index));
@@ -2659,12 +3011,12 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     _op_NEG: _OP_CALL(PLCMethods::handle_NEG(this->stack, program, prog_size, index));
 
 #ifdef PLCRUNTIME_TIMERS_ENABLED
-    _op_TON_CONST: _OP_CALL(PLCMethods::handle_TON_CONST(this->stack, this->memory, program, prog_size, index));
-    _op_TON_MEM:   _OP_CALL(PLCMethods::handle_TON_MEM(this->stack, this->memory, program, prog_size, index));
-    _op_TOF_CONST: _OP_CALL(PLCMethods::handle_TOF_CONST(this->stack, this->memory, program, prog_size, index));
-    _op_TOF_MEM:   _OP_CALL(PLCMethods::handle_TOF_MEM(this->stack, this->memory, program, prog_size, index));
-    _op_TP_CONST:  _OP_CALL(PLCMethods::handle_TP_CONST(this->stack, this->memory, program, prog_size, index));
-    _op_TP_MEM:    _OP_CALL(PLCMethods::handle_TP_MEM(this->stack, this->memory, program, prog_size, index));
+    _op_TON_CONST: _OP_CALL(PLCMethods::handle_TON_CONST(this->stack, this->memory, clock.millis_now, program, prog_size, index));
+    _op_TON_MEM:   _OP_CALL(PLCMethods::handle_TON_MEM(this->stack, this->memory, clock.millis_now, program, prog_size, index));
+    _op_TOF_CONST: _OP_CALL(PLCMethods::handle_TOF_CONST(this->stack, this->memory, clock.millis_now, program, prog_size, index));
+    _op_TOF_MEM:   _OP_CALL(PLCMethods::handle_TOF_MEM(this->stack, this->memory, clock.millis_now, program, prog_size, index));
+    _op_TP_CONST:  _OP_CALL(PLCMethods::handle_TP_CONST(this->stack, this->memory, clock.millis_now, program, prog_size, index));
+    _op_TP_MEM:    _OP_CALL(PLCMethods::handle_TP_MEM(this->stack, this->memory, clock.millis_now, program, prog_size, index));
 #else
     _op_TON_CONST: status = UNKNOWN_INSTRUCTION; goto _op_done;
     _op_TON_MEM:   status = UNKNOWN_INSTRUCTION; goto _op_done;
@@ -2785,6 +3137,12 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         this->BR = 0;
         DISPATCH();
     }
+    _op_BR_SAVE_READ: {
+        u8 value = this->stack.pop_u8() ? 1 : 0;
+        this->BR = (this->BR << 1) | value;
+        this->stack.push(value);
+        DISPATCH();
+    }
 
 #ifdef PLCRUNTIME_STRINGS_ENABLED
     _op_STR_LEN:    _OP_CALL(PLCMethods::handle_STR_LEN(this->stack, this->memory, program, prog_size, index));
@@ -2841,11 +3199,16 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     _op_BW_NOT_X64:    _OP_CALL(PLCMethods::handle_BW_NOT_X64(this->stack));
     _op_BW_LSHIFT_X64: _OP_CALL(PLCMethods::handle_BW_LSHIFT_X64(this->stack));
     _op_BW_RSHIFT_X64: _OP_CALL(PLCMethods::handle_BW_RSHIFT_X64(this->stack));
+    _op_BIT_GATHER_X64:  _OP_CALL(PLCMethods::handle_BIT_GATHER_X64(this->stack, this->memory, program, prog_size, index));
+    _op_BIT_SCATTER_X64: _OP_CALL(PLCMethods::handle_BIT_SCATTER_X64(this->stack, this->memory, program, prog_size, index));
 #else
     _op_BW_AND_X64:    _op_BW_OR_X64:     _op_BW_XOR_X64:
     _op_BW_NOT_X64:    _op_BW_LSHIFT_X64: _op_BW_RSHIFT_X64:
+    _op_BIT_GATHER_X64: _op_BIT_SCATTER_X64:
         status = UNKNOWN_INSTRUCTION; goto _op_done;
 #endif
+    _op_BIT_GATHER_X32:  _OP_CALL(PLCMethods::handle_BIT_GATHER_X32(this->stack, this->memory, program, prog_size, index));
+    _op_BIT_SCATTER_X32: _OP_CALL(PLCMethods::handle_BIT_SCATTER_X32(this->stack, this->memory, program, prog_size, index));
 #else
     _op_BW_AND_X8:   _op_BW_AND_X16:   _op_BW_AND_X32:   _op_BW_AND_X64:
     _op_BW_OR_X8:    _op_BW_OR_X16:    _op_BW_OR_X32:    _op_BW_OR_X64:
@@ -2853,6 +3216,7 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     _op_BW_NOT_X8:   _op_BW_NOT_X16:   _op_BW_NOT_X32:   _op_BW_NOT_X64:
     _op_BW_LSHIFT_X8: _op_BW_LSHIFT_X16: _op_BW_LSHIFT_X32: _op_BW_LSHIFT_X64:
     _op_BW_RSHIFT_X8: _op_BW_RSHIFT_X16: _op_BW_RSHIFT_X32: _op_BW_RSHIFT_X64:
+    _op_BIT_GATHER_X32: _op_BIT_GATHER_X64: _op_BIT_SCATTER_X32: _op_BIT_SCATTER_X64:
         status = UNKNOWN_INSTRUCTION; goto _op_done;
 #endif
 
@@ -2889,9 +3253,8 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
         if (param_count > PLCRUNTIME_FFI_MAX_PARAMS) { status = FFI_INVALID_PARAMS; goto _op_done; }
         const PLCFFIEntry* entry = g_ffiRegistry.getEntry(ffi_index);
         if (!entry) { status = FFI_NOT_FOUND; goto _op_done; }
-        u8 param_types[PLCRUNTIME_FFI_MAX_PARAMS];
-        u8 sig_param_count = ffi_parseSignatureParams(entry->signature, param_types, PLCRUNTIME_FFI_MAX_PARAMS);
-        if (sig_param_count != param_count) { status = FFI_INVALID_PARAMS; goto _op_done; }
+        const u8* param_types = entry->param_types;
+        if (entry->param_count != param_count) { status = FFI_INVALID_PARAMS; goto _op_done; }
         u16 temp_base = (u16)(((u32)PLCRUNTIME_MAX_MEMORY_SIZE) - 256);
         u16 param_addrs[PLCRUNTIME_FFI_MAX_PARAMS];
         u16 offset = 0;
@@ -2904,21 +3267,73 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
             }
             offset += sz;
         }
-        u8 ret_type = ffi_parseSignatureReturn(entry->signature);
+        u8 ret_type = entry->ret_type;
         u8 ret_size = ffi_getTypeSize(ret_type);
         u16 ret_addr = temp_base + offset;
         status = g_ffiRegistry.call(ffi_index, memory, param_addrs, param_count, ret_addr);
         if (status != STATUS_SUCCESS) goto _op_done;
         if (ret_size > 0) {
             for (u8 j = 0; j < ret_size; j++) {
-                if (!stack.push(memory[ret_addr + j])) { status = STACK_OVERFLOW; goto _op_done; }
+                if (stack.push(memory[ret_addr + j]) != STATUS_SUCCESS) { status = STACK_OVERFLOW; goto _op_done; }
             }
         }
         DISPATCH();
     }
+    _op_FFI_CALL_BATCH: {
+        if (index + 7 > prog_size) { status = PROGRAM_SIZE_EXCEEDED; goto _op_done; }
+        u8 ffi_index = program[index];
+        u16 base = read_u16(program + index + 1);
+        u16 count = read_u16(program + index + 3);
+        u16 stride = read_u16(program + index + 5);
+        index += 7;
+        status = g_ffiRegistry.callBatch(ffi_index, memory, base, count, stride);
+        if (status != STATUS_SUCCESS) goto _op_done;
+        DISPATCH();
+    }
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+    _op_FFI_START: {
+        if (index + 2 > prog_size) { status = PROGRAM_SIZE_EXCEEDED; goto _op_done; }
+        u8 ffi_index = program[index++];
+        u8 param_count = program[index++];
+        if (param_count > PLCRUNTIME_FFI_MAX_PARAMS) { status = FFI_INVALID_PARAMS; goto _op_done; }
+        if (index + (u32) param_count * 2 + 4 > prog_size) { status = PROGRAM_SIZE_EXCEEDED; goto _op_done; }
+        u16 param_addrs[PLCRUNTIME_FFI_MAX_PARAMS];
+        for (u8 i = 0; i < param_count; i++) {
+            param_addrs[i] = read_u16(program + index);
+            index += 2;
+        }
+        u16 ret_addr = read_u16(program + index);
+        u16 handle_addr = read_u16(program + index + 2);
+        index += 4;
+        if ((u32) handle_addr + 2 > PLCRUNTIME_MAX_MEMORY_SIZE) { status = INVALID_MEMORY_ADDRESS; goto _op_done; }
+        u16 handle = 0;
+        status = g_ffiAsync.start(memory, ffi_index, param_count, param_addrs, ret_addr, handle);
+        if (status != STATUS_SUCCESS) goto _op_done;
+        write_u16(memory + handle_addr, handle);
+        DISPATCH();
+    }
+    _op_FFI_POLL: {
+        if (index + 2 > prog_size) { status = PROGRAM_SIZE_EXCEEDED; goto _op_done; }
+        u16 handle_addr = read_u16(program + index);
+        index += 2;
+        if ((u32) handle_addr + 2 > PLCRUNTIME_MAX_MEMORY_SIZE) { status = INVALID_MEMORY_ADDRESS; goto _op_done; }
+        bool done = g_ffiAsync.poll(memory, read_u16(memory + handle_addr));
+        if (done) write_u16(memory + handle_addr, 0);
+        status = stack.push_bool(done);
+        if (status != STATUS_SUCCESS) goto _op_done;
+        DISPATCH();
+    }
+#else
+    _op_FFI_START:
+    _op_FFI_POLL:
+        status = UNKNOWN_INSTRUCTION; goto _op_done;
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
 #else
     _op_FFI_CALL:
     _op_FFI_CALL_STACK:
+    _op_FFI_CALL_BATCH:
+    _op_FFI_START:
+    _op_FFI_POLL:
         status = UNKNOWN_INSTRUCTION; goto _op_done;
 #endif
 
@@ -2992,6 +3407,9 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
 
 #endif // PLCRUNTIME_USE_COMPUTED_GOTO
 
+#if defined(PLCRUNTIME_PREDECODE_ENABLED) || defined(PLCRUNTIME_AOT_ENABLED)
+    _run_done:
+#endif // PLCRUNTIME_PREDECODE_ENABLED || PLCRUNTIME_AOT_ENABLED
     last_instruction_count = instruction_count;
 
 #ifdef PLCRUNTIME_VARIABLE_REGISTRATION_ENABLED
@@ -3001,6 +3419,17 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
 #endif // PLCRUNTIME_VARIABLE_REGISTRATION_MANUAL_SYNC
 #endif // PLCRUNTIME_VARIABLE_REGISTRATION_ENABLED
 
+#ifdef PLCRUNTIME_PROCESS_IMAGE_ENABLED
+    // Publish the outputs of this cycle as one image
+    u8* outputs = output_image.writeSlot();
+    for (u32 i = 0; i < PLCRUNTIME_NUM_OF_OUTPUTS; i++) outputs[i] = memory[output_offset + i];
+    output_image.publish();
+#endif // PLCRUNTIME_PROCESS_IMAGE_ENABLED
+
+#ifdef PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+    scan_count++;
+#endif // PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+
     if (status == STATUS_SUCCESS) updateCycleStats((u32) (micros() - start_us));
     else updateRamStats();
 
@@ -3010,6 +3439,9 @@ RuntimeError VovkPLCRuntime::run(u8* program, u32 prog_size) {
     // if is_first_cycle is false.
     if (is_first_cycle) is_first_cycle = false;
 
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+    if (status == STATUS_SUCCESS) status = change_status;
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
     return status;
 }
 
@@ -3025,6 +3457,10 @@ RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
     SAFE_BOUNDS_CHECK(index >= prog_size, PROGRAM_SIZE_EXCEEDED);
     u8 opcode = program[index];
     index++;
+    return execute(opcode, program, prog_size, index);
+}
+
+inline RuntimeError VovkPLCRuntime::execute(u8 opcode, u8* program, u32 prog_size, u32& index) {
     switch (opcode) {
         case NOP: return STATUS_SUCCESS;
         case LOGIC_AND: return PLCMethods::LOGIC_AND(this->stack);
@@ -3052,6 +3488,11 @@ RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
         case POKE: return PLCMethods::POKE(this->stack, program, prog_size, index);
 #endif // PLCRUNTIME_STACK_OPS_ENABLED
         case MEM_FILL: return PLCMethods::MEM_FILL(this->memory, program, prog_size, index);
+        case LOAD_CMP_IMM: return PLCMethods::LOAD_CMP_IMM(this->stack, this->memory, program, prog_size, index);
+        case LOAD_CMP_IMM_JMP_IF_NOT: return PLCMethods::LOAD_CMP_IMM_JMP_IF_NOT(this->stack, this->memory, program, prog_size, index);
+        case READ_AND_X8: return PLCMethods::READ_AND_X8(this->stack, this->memory, program, prog_size, index);
+        case READ_OR_X8: return PLCMethods::READ_OR_X8(this->stack, this->memory, program, prog_size, index);
+        case READ_AND_WRITE_X8: return PLCMethods::READ_AND_WRITE_X8(this->stack, this->memory, program, prog_size, index);
         case JMP: return PLCMethods::handle_JMP(this->stack, program, prog_size, index);
         case JMP_IF: return PLCMethods::handle_JMP_IF(this->stack, program, prog_size, index);
         case JMP_IF_NOT: return PLCMethods::handle_JMP_IF_NOT(this->stack, program, prog_size, index);
@@ -3102,12 +3543,12 @@ RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
 #endif // PLCRUNTIME_ADVANCED_MATH_ENABLED
 
 #ifdef PLCRUNTIME_TIMERS_ENABLED
-        case TON_CONST: return PLCMethods::handle_TON_CONST(this->stack, this->memory, program, prog_size, index);
-        case TON_MEM: return PLCMethods::handle_TON_MEM(this->stack, this->memory, program, prog_size, index);
-        case TOF_CONST: return PLCMethods::handle_TOF_CONST(this->stack, this->memory, program, prog_size, index);
-        case TOF_MEM: return PLCMethods::handle_TOF_MEM(this->stack, this->memory, program, prog_size, index);
-        case TP_CONST: return PLCMethods::handle_TP_CONST(this->stack, this->memory, program, prog_size, index);
-        case TP_MEM: return PLCMethods::handle_TP_MEM(this->stack, this->memory, program, prog_size, index);
+        case TON_CONST: return PLCMethods::handle_TON_CONST(this->stack, this->memory, clock.millis_now, program, prog_size, index);
+        case TON_MEM: return PLCMethods::handle_TON_MEM(this->stack, this->memory, clock.millis_now, program, prog_size, index);
+        case TOF_CONST: return PLCMethods::handle_TOF_CONST(this->stack, this->memory, clock.millis_now, program, prog_size, index);
+        case TOF_MEM: return PLCMethods::handle_TOF_MEM(this->stack, this->memory, clock.millis_now, program, prog_size, index);
+        case TP_CONST: return PLCMethods::handle_TP_CONST(this->stack, this->memory, clock.millis_now, program, prog_size, index);
+        case TP_MEM: return PLCMethods::handle_TP_MEM(this->stack, this->memory, clock.millis_now, program, prog_size, index);
 #endif // PLCRUNTIME_TIMERS_ENABLED
 
 #ifdef PLCRUNTIME_COUNTERS_ENABLED
@@ -3223,6 +3664,13 @@ RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
             this->BR = 0;
             return STATUS_SUCCESS;
         }
+        case BR_SAVE_READ: {
+            // Fused BR_SAVE + BR_READ: save RLO to BR and push it straight back
+            u8 value = this->stack.pop_u8() ? 1 : 0;
+            this->BR = (this->BR << 1) | value;
+            this->stack.push(value);
+            return STATUS_SUCCESS;
+        }
 
 #ifdef PLCRUNTIME_STRINGS_ENABLED
         // String instructions (0x94-0x9F)
@@ -3275,7 +3723,11 @@ RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
         case BW_NOT_X64: return PLCMethods::handle_BW_NOT_X64(this->stack);
         case BW_LSHIFT_X64: return PLCMethods::handle_BW_LSHIFT_X64(this->stack);
         case BW_RSHIFT_X64: return PLCMethods::handle_BW_RSHIFT_X64(this->stack);
+        case BIT_GATHER_X64: return PLCMethods::handle_BIT_GATHER_X64(this->stack, this->memory, program, prog_size, index);
+        case BIT_SCATTER_X64: return PLCMethods::handle_BIT_SCATTER_X64(this->stack, this->memory, program, prog_size, index);
 #endif // USE_X64_OPS
+        case BIT_GATHER_X32: return PLCMethods::handle_BIT_GATHER_X32(this->stack, this->memory, program, prog_size, index);
+        case BIT_SCATTER_X32: return PLCMethods::handle_BIT_SCATTER_X32(this->stack, this->memory, program, prog_size, index);
 #endif // PLCRUNTIME_BITWISE_OPS_ENABLED
         case CMP_EQ: return PLCMethods::handle_CMP_EQ(this->stack, program, prog_size, index);
         case CMP_NEQ: return PLCMethods::handle_CMP_NEQ(this->stack, program, prog_size, index);
@@ -3321,10 +3773,9 @@ RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
             const PLCFFIEntry* entry = g_ffiRegistry.getEntry(ffi_index);
             if (!entry) return FFI_NOT_FOUND;
             
-            // Parse parameter types from signature
-            u8 param_types[PLCRUNTIME_FFI_MAX_PARAMS];
-            u8 sig_param_count = ffi_parseSignatureParams(entry->signature, param_types, PLCRUNTIME_FFI_MAX_PARAMS);
-            if (sig_param_count != param_count) return FFI_INVALID_PARAMS;
+            // Parameter types were resolved when the function was registered
+            const u8* param_types = entry->param_types;
+            if (entry->param_count != param_count) return FFI_INVALID_PARAMS;
             
             // Allocate temp buffer for params (on stack memory in a reserved area)
             // We use a temporary area at the end of memory (use u32 to avoid overflow)
@@ -3346,7 +3797,7 @@ RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
             }
             
             // Get return type and allocate return address
-            u8 ret_type = ffi_parseSignatureReturn(entry->signature);
+            u8 ret_type = entry->ret_type;
             u8 ret_size = ffi_getTypeSize(ret_type);
             u16 ret_addr = temp_base + offset;
             
@@ -3357,15 +3808,68 @@ RuntimeError VovkPLCRuntime::step(u8* program, u32 prog_size, u32& index) {
             // Push return value to stack if not void
             if (ret_size > 0) {
                 for (u8 j = 0; j < ret_size; j++) {
-                    if (!stack.push(memory[ret_addr + j])) return STACK_OVERFLOW;
+                    if (stack.push(memory[ret_addr + j]) != STATUS_SUCCESS) return STACK_OVERFLOW;
                 }
             }
             
             return STATUS_SUCCESS;
         }
+        case FFI_CALL_BATCH: {
+            // Format: FFI_CALL_BATCH <index:u8> <base_addr:u16> <count:u16> <stride:u16>
+            if (index + 7 > prog_size) return PROGRAM_SIZE_EXCEEDED;
+            u8 ffi_index = program[index];
+            u16 base = read_u16(program + index + 1);
+            u16 count = read_u16(program + index + 3);
+            u16 stride = read_u16(program + index + 5);
+            index += 7;
+            return g_ffiRegistry.callBatch(ffi_index, memory, base, count, stride);
+        }
+#ifdef PLCRUNTIME_FFI_ASYNC_ENABLED
+        case FFI_START: {
+            // Format: FFI_START <index:u8> <param_count:u8> <addr1:u16> ... <addrN:u16> <ret_addr:u16> <handle_addr:u16>
+            if (index + 2 > prog_size) return PROGRAM_SIZE_EXCEEDED;
+            u8 ffi_index = program[index++];
+            u8 param_count = program[index++];
+            if (param_count > PLCRUNTIME_FFI_MAX_PARAMS) return FFI_INVALID_PARAMS;
+            if (index + (u32) param_count * 2 + 4 > prog_size) return PROGRAM_SIZE_EXCEEDED;
+            u16 param_addrs[PLCRUNTIME_FFI_MAX_PARAMS];
+            for (u8 i = 0; i < param_count; i++) {
+                param_addrs[i] = read_u16(program + index);
+                index += 2;
+            }
+            u16 ret_addr = read_u16(program + index);
+            u16 handle_addr = read_u16(program + index + 2);
+            index += 4;
+            if ((u32) handle_addr + 2 > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+
+            // Queue the job, the handle is 0 when no job slot is free
+            u16 handle = 0;
+            RuntimeError err = g_ffiAsync.start(memory, ffi_index, param_count, param_addrs, ret_addr, handle);
+            if (err != STATUS_SUCCESS) return err;
+            write_u16(memory + handle_addr, handle);
+            return STATUS_SUCCESS;
+        }
+        case FFI_POLL: {
+            // Format: FFI_POLL <handle_addr:u16> - pushes true once the result is in memory
+            if (index + 2 > prog_size) return PROGRAM_SIZE_EXCEEDED;
+            u16 handle_addr = read_u16(program + index);
+            index += 2;
+            if ((u32) handle_addr + 2 > PLCRUNTIME_MAX_MEMORY_SIZE) return INVALID_MEMORY_ADDRESS;
+            bool done = g_ffiAsync.poll(memory, read_u16(memory + handle_addr));
+            if (done) write_u16(memory + handle_addr, 0); // The job is gone, so is its handle
+            return stack.push_bool(done);
+        }
+#else
+        case FFI_START:
+        case FFI_POLL:
+            return UNKNOWN_INSTRUCTION;
+#endif // PLCRUNTIME_FFI_ASYNC_ENABLED
 #else
         case FFI_CALL:
         case FFI_CALL_STACK:
+        case FFI_CALL_BATCH:
+        case FFI_START:
+        case FFI_POLL:
             // FFI not enabled, skip instruction
             return UNKNOWN_INSTRUCTION;
 #endif // PLCRUNTIME_FFI_ENABLED
@@ -3478,4 +3982,10 @@ template<> inline SymbolType VovkPLCRuntime::getSymbolTypeFor<u64>() { return TY
 template<> inline SymbolType VovkPLCRuntime::getSymbolTypeFor<f64>() { return TYPE_F64; }
 #endif // USE_X64_OPS
 
-#endif // PLCRUNTIME_VARIABLE_REGISTRATION_ENABLED
\ No newline at end of file
+#endif // PLCRUNTIME_VARIABLE_REGISTRATION_ENABLED
+
+#include "runtime-predecode-impl.h"
+#include "runtime-jit-impl.h"
+#include "runtime-scheduler.h"
+#include "runtime-ensemble.h"
+#include "runtime-binary-protocol-impl.h"
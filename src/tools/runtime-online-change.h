@@ -0,0 +1,104 @@
+// runtime-online-change.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-tools.h"
+#include "runtime-instructions.h"
+#include "runtime-verifier.h"
+
+#ifdef PLCRUNTIME_ONLINE_CHANGE_ENABLED
+
+// ============================================================================
+// Online program change
+// ============================================================================
+// A new program is downloaded into a shadow buffer while the active one keeps
+// scanning. Once the whole program has arrived and its checksum matches, the
+// staged copy is checked structurally and marked ready; run() swaps it in at
+// the start of the next scan cycle. Memory is not touched by the swap, so
+// timers, counters, markers and DataBlocks keep their values (bumpless).
+//
+// Before the swap the DataBlocks are moved to the layout the new program was
+// compiled for: the DBs of its CONFIG_DB instructions, packed below the DB
+// table in declaration order (see DataBlockManager::relayout). Each DB keeps
+// its data, growth is zeroed and DBs the new program does not declare are
+// dropped. If the layout does not fit nothing is touched, the active program
+// keeps running and run() returns the error once (programChangeStatus()).
+//
+// Downloads over 'PD' and the binary PROGRAM_* frames are staged. A download
+// that fails its checksum or validation is dropped and the active program
+// continues, instead of the runtime being restarted.
+// ============================================================================
+
+enum PLCStageState {
+    PLC_STAGE_EMPTY = 0,    // Nothing staged
+    PLC_STAGE_RECEIVING,    // begin() was called, bytes are arriving
+    PLC_STAGE_READY,        // Complete and validated, waiting for the scan boundary
+};
+
+// Shadow program buffer of an online change
+struct PLCProgramStage {
+    u8 program[PLCRUNTIME_MAX_PROGRAM_SIZE];
+    u8 starts[(PLCRUNTIME_MAX_PROGRAM_SIZE + 7) / 8]; // Instruction start bitmap for the structural check
+    u32 size = 0;
+    u32 received = 0;
+    volatile u8 state = PLC_STAGE_EMPTY;
+
+    // Start receiving a program of `prog_size` bytes, drops anything staged before
+    RuntimeError begin(u32 prog_size) {
+        state = PLC_STAGE_EMPTY;
+        if (prog_size == 0) return EMPTY_PROGRAM;
+        if (prog_size > PLCRUNTIME_MAX_PROGRAM_SIZE) return PROGRAM_SIZE_EXCEEDED;
+        size = prog_size;
+        received = 0;
+        state = PLC_STAGE_RECEIVING;
+        return STATUS_SUCCESS;
+    }
+
+    // Append the next `count` bytes, `offset` must continue where the previous write ended
+    RuntimeError write(u32 offset, const u8* data, u32 count) {
+        if (state != PLC_STAGE_RECEIVING) return NO_PROGRAM;
+        if (offset != received) return INVALID_PROGRAM_INDEX;
+        if (count > size - offset) return PROGRAM_SIZE_EXCEEDED;
+        memcpy(program + offset, data, count);
+        received += count;
+        return STATUS_SUCCESS;
+    }
+
+    // Validate the complete program and mark it ready for the swap.
+    // The caller checks the transfer checksum before, a rejected program is dropped.
+    RuntimeError commit() {
+        if (state != PLC_STAGE_RECEIVING) return NO_PROGRAM;
+        if (received != size) {
+            state = PLC_STAGE_EMPTY;
+            return PROGRAM_SIZE_EXCEEDED;
+        }
+        RuntimeError status = plc_check_program_structure(program, size, starts);
+        state = status == STATUS_SUCCESS ? PLC_STAGE_READY : PLC_STAGE_EMPTY;
+        return status;
+    }
+
+    void cancel() { state = PLC_STAGE_EMPTY; }
+    bool ready() const { return state == PLC_STAGE_READY; }
+    bool receiving() const { return state == PLC_STAGE_RECEIVING; }
+};
+
+#endif // PLCRUNTIME_ONLINE_CHANGE_ENABLED
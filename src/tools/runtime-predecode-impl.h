@@ -0,0 +1,536 @@
+// runtime-predecode-impl.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+
+namespace PLCPredecode {
+
+    // Common handler parameters, see PLCDecodedHandler
+#define PLC_PD_ARGS VovkPLCRuntime& rt, const PLCDecodedOp& op, u32& pc, PLCDecodedTos& tos
+
+    // ---- Fallback: execute the original bytecode through step() ----
+
+    RuntimeError op_generic(PLC_PD_ARGS) {
+        tos.spill(rt.stack);
+        u32 index = op.offset;
+        RuntimeError status = rt.step(rt.program.program, rt.program.prog_size, index);
+        if (status != STATUS_SUCCESS) return status;
+        rt.decoded.resume(index, pc);
+        return STATUS_SUCCESS;
+    }
+
+    RuntimeError op_nop(PLC_PD_ARGS) { return STATUS_SUCCESS; }
+    RuntimeError op_exit(PLC_PD_ARGS) { return PROGRAM_EXITED; }
+
+    // ---- Stack-only instructions ----
+
+    template <RuntimeError(*Handler)(RuntimeStack&)>
+    RuntimeError op_stack(PLC_PD_ARGS) {
+        tos.spill(rt.stack);
+        return Handler(rt.stack);
+    }
+
+    // ---- Checked and unchecked variants ----
+    // Handlers touching the data stack come in two flavours: Checked = true keeps the
+    // overflow and underflow checks, Checked = false is used for programs proven by
+    // the load-time verifier (runtime-verifier.h) and drops them.
+
+    template <bool Checked, typename T> RuntimeError pd_push(PLCDecodedTos& tos, RuntimeStack& stack, T value) {
+        if (Checked) return tos.push<T>(stack, value);
+        tos.put<T>(stack, value);
+        return STATUS_SUCCESS;
+    }
+
+    // ---- Constants (immediate unpacked at decode time) ----
+
+    template <bool Checked> RuntimeError op_push_u8(PLC_PD_ARGS) { return pd_push<Checked, u8>(tos, rt.stack, op.imm.type_u8); }
+    template <bool Checked> RuntimeError op_push_u16(PLC_PD_ARGS) { return pd_push<Checked, u16>(tos, rt.stack, op.imm.type_u16); }
+    template <bool Checked> RuntimeError op_push_u32(PLC_PD_ARGS) { return pd_push<Checked, u32>(tos, rt.stack, op.imm.type_u32); }
+#ifdef USE_X64_OPS
+    template <bool Checked> RuntimeError op_push_u64(PLC_PD_ARGS) { return pd_push<Checked, u64>(tos, rt.stack, op.imm.type_u64); }
+#endif // USE_X64_OPS
+
+    // ---- Memory access (address resolved and bounds checked at decode time) ----
+
+    template <bool Checked> RuntimeError op_load_u8(PLC_PD_ARGS) { return pd_push<Checked, u8>(tos, rt.stack, rt.memory[op.arg]); }
+    template <bool Checked> RuntimeError op_load_u16(PLC_PD_ARGS) { return pd_push<Checked, u16>(tos, rt.stack, read_u16(rt.memory + op.arg)); }
+    template <bool Checked> RuntimeError op_load_u32(PLC_PD_ARGS) { return pd_push<Checked, u32>(tos, rt.stack, read_u32(rt.memory + op.arg)); }
+#ifdef USE_X64_OPS
+    template <bool Checked> RuntimeError op_load_u64(PLC_PD_ARGS) { return pd_push<Checked, u64>(tos, rt.stack, read_u64(rt.memory + op.arg)); }
+#endif // USE_X64_OPS
+
+    template <bool Checked> RuntimeError op_move_u8(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 1) return STACK_UNDERFLOW;
+        rt.memory[op.arg] = tos.pop<u8>(rt.stack);
+        return STATUS_SUCCESS;
+    }
+    template <bool Checked> RuntimeError op_move_u16(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 2) return STACK_UNDERFLOW;
+        write_u16(rt.memory + op.arg, tos.pop<u16>(rt.stack));
+        return STATUS_SUCCESS;
+    }
+    template <bool Checked> RuntimeError op_move_u32(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 4) return STACK_UNDERFLOW;
+        write_u32(rt.memory + op.arg, tos.pop<u32>(rt.stack));
+        return STATUS_SUCCESS;
+    }
+#ifdef USE_X64_OPS
+    template <bool Checked> RuntimeError op_move_u64(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 8) return STACK_UNDERFLOW;
+        write_u64(rt.memory + op.arg, tos.pop<u64>(rt.stack));
+        return STATUS_SUCCESS;
+    }
+#endif // USE_X64_OPS
+
+    // ---- Bit access: address in `arg`, bit index in `imm` ----
+
+    template <bool Checked> RuntimeError op_read_bit(PLC_PD_ARGS) {
+        return pd_push<Checked, u8>(tos, rt.stack, (rt.memory[op.arg] >> op.imm.type_u8) & 1);
+    }
+    template <bool Checked> RuntimeError op_write_bit(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 1) return STACK_UNDERFLOW;
+        u8 x = rt.memory[op.arg];
+        u8 bit = tos.pop<u8>(rt.stack);
+        rt.memory[op.arg] = bit ? x | 1 << op.imm.type_u8 : x & ~(1 << op.imm.type_u8);
+        return STATUS_SUCCESS;
+    }
+    RuntimeError op_write_s_bit(PLC_PD_ARGS) {
+        rt.memory[op.arg] |= 1 << op.imm.type_u8;
+        return STATUS_SUCCESS;
+    }
+    RuntimeError op_write_r_bit(PLC_PD_ARGS) {
+        rt.memory[op.arg] &= ~(1 << op.imm.type_u8);
+        return STATUS_SUCCESS;
+    }
+    RuntimeError op_write_inv_bit(PLC_PD_ARGS) {
+        rt.memory[op.arg] ^= 1 << op.imm.type_u8;
+        return STATUS_SUCCESS;
+    }
+
+    // ---- Boolean logic ----
+
+    template <bool Checked> RuntimeError op_logic_and(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 2) return STACK_UNDERFLOW;
+        u8 b = tos.pop<u8>(rt.stack) != 0;
+        u8 a = tos.pop<u8>(rt.stack) != 0;
+        return pd_push<Checked, u8>(tos, rt.stack, a && b);
+    }
+    template <bool Checked> RuntimeError op_logic_or(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 2) return STACK_UNDERFLOW;
+        u8 b = tos.pop<u8>(rt.stack) != 0;
+        u8 a = tos.pop<u8>(rt.stack) != 0;
+        return pd_push<Checked, u8>(tos, rt.stack, a || b);
+    }
+    template <bool Checked> RuntimeError op_logic_xor(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 2) return STACK_UNDERFLOW;
+        u8 b = tos.pop<u8>(rt.stack) != 0;
+        u8 a = tos.pop<u8>(rt.stack) != 0;
+        return pd_push<Checked, u8>(tos, rt.stack, a ^ b);
+    }
+    template <bool Checked> RuntimeError op_logic_not(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 1) return STACK_UNDERFLOW;
+        u8 a = tos.pop<u8>(rt.stack) != 0;
+        return pd_push<Checked, u8>(tos, rt.stack, !a);
+    }
+
+    // ---- Branch stack (ladder parallel branches) ----
+
+    template <bool Checked> RuntimeError op_br_save(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 1) return STACK_UNDERFLOW;
+        u8 value = tos.pop<u8>(rt.stack);
+        rt.BR = (rt.BR << 1) | (value ? 1 : 0);
+        return STATUS_SUCCESS;
+    }
+    template <bool Checked> RuntimeError op_br_read(PLC_PD_ARGS) {
+        u8 value = (rt.BR & 1) ? 1 : 0;
+        return pd_push<Checked, u8>(tos, rt.stack, value);
+    }
+    RuntimeError op_br_drop(PLC_PD_ARGS) { rt.BR >>= 1; return STATUS_SUCCESS; }
+    RuntimeError op_br_clr(PLC_PD_ARGS) { rt.BR = 0; return STATUS_SUCCESS; }
+
+    // ---- Control flow: `arg` is the resolved target record, `imm` the return byte address ----
+    // The call stack is separate from the data stack, so calls keep the cached values.
+    // Shared by both handler sets because the JIT recognizes them by address.
+
+    RuntimeError op_jmp(PLC_PD_ARGS) { pc = op.arg; return STATUS_SUCCESS; }
+    RuntimeError op_jmp_if(PLC_PD_ARGS) {
+        if (tos.size(rt.stack) < 1) return STACK_UNDERFLOW;
+        if (tos.pop<u8>(rt.stack)) pc = op.arg;
+        return STATUS_SUCCESS;
+    }
+    RuntimeError op_jmp_if_not(PLC_PD_ARGS) {
+        if (tos.size(rt.stack) < 1) return STACK_UNDERFLOW;
+        if (!tos.pop<u8>(rt.stack)) pc = op.arg;
+        return STATUS_SUCCESS;
+    }
+    RuntimeError op_call(PLC_PD_ARGS) {
+        RuntimeError status = rt.stack.pushCall(op.imm.type_u32);
+        pc = op.arg;
+        return status;
+    }
+    RuntimeError op_call_if(PLC_PD_ARGS) {
+        if (tos.size(rt.stack) < 1) return STACK_UNDERFLOW;
+        if (!tos.pop<u8>(rt.stack)) return STATUS_SUCCESS;
+        return op_call(rt, op, pc, tos);
+    }
+    RuntimeError op_call_if_not(PLC_PD_ARGS) {
+        if (tos.size(rt.stack) < 1) return STACK_UNDERFLOW;
+        if (tos.pop<u8>(rt.stack)) return STATUS_SUCCESS;
+        return op_call(rt, op, pc, tos);
+    }
+
+    // ---- Typed arithmetic and comparison: data type resolved at decode time ----
+    // Same operand order and truncation as the PLCMethods handlers they replace
+
+    template <typename T> T pd_add(T a, T b) { return a + b; }
+    template <typename T> T pd_sub(T a, T b) { return a - b; }
+    template <typename T> T pd_mul(T a, T b) { return a * b; }
+    template <typename T> T pd_div(T a, T b) { return a / b; }
+    template <typename T> T pd_mod(T a, T b) { return a % b; }
+#ifdef PLCRUNTIME_FLOAT_OPS_ENABLED
+    template <> f32 pd_mod<f32>(f32 a, f32 b) { return fmod(a, b); }
+#endif // PLCRUNTIME_FLOAT_OPS_ENABLED
+#ifdef USE_X64_OPS
+    template <> f64 pd_mod<f64>(f64 a, f64 b) { return fmod(a, b); }
+#endif // USE_X64_OPS
+    template <typename T> u8 pd_eq(T a, T b) { return a == b; }
+    template <typename T> u8 pd_neq(T a, T b) { return a != b; }
+    template <typename T> u8 pd_gt(T a, T b) { return a > b; }
+    template <typename T> u8 pd_gte(T a, T b) { return a >= b; }
+    template <typename T> u8 pd_lt(T a, T b) { return a < b; }
+    template <typename T> u8 pd_lte(T a, T b) { return a <= b; }
+
+    template <bool Checked, typename T, T(*Fn)(T, T)>
+    RuntimeError op_arith(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 2 * sizeof(T)) return STACK_UNDERFLOW;
+        T b = tos.pop<T>(rt.stack);
+        T a = tos.pop<T>(rt.stack);
+        return pd_push<Checked, T>(tos, rt.stack, Fn(a, b));
+    }
+
+    template <bool Checked, typename T, u8(*Fn)(T, T)>
+    RuntimeError op_compare(PLC_PD_ARGS) {
+        if (Checked && tos.size(rt.stack) < 2 * sizeof(T)) return STACK_UNDERFLOW;
+        T b = tos.pop<T>(rt.stack);
+        T a = tos.pop<T>(rt.stack);
+        return pd_push<Checked, u8>(tos, rt.stack, Fn(a, b));
+    }
+
+#ifdef PLCRUNTIME_32BIT_OPS_ENABLED
+#define PLC_PD_CASE_32(handler, fn) \
+        case type_u32: return handler<Checked, u32, fn<u32> >; \
+        case type_i32: return handler<Checked, i32, fn<i32> >;
+#else
+#define PLC_PD_CASE_32(handler, fn)
+#endif // PLCRUNTIME_32BIT_OPS_ENABLED
+
+#ifdef PLCRUNTIME_FLOAT_OPS_ENABLED
+#define PLC_PD_CASE_F32(handler, fn) case type_f32: return handler<Checked, f32, fn<f32> >;
+#else
+#define PLC_PD_CASE_F32(handler, fn)
+#endif // PLCRUNTIME_FLOAT_OPS_ENABLED
+
+#ifdef USE_X64_OPS
+#define PLC_PD_CASE_64(handler, fn) \
+        case type_u64: return handler<Checked, u64, fn<u64> >; \
+        case type_i64: return handler<Checked, i64, fn<i64> >; \
+        case type_f64: return handler<Checked, f64, fn<f64> >;
+#else
+#define PLC_PD_CASE_64(handler, fn)
+#endif // USE_X64_OPS
+
+    // Returns nullptr for types handled by the generic path (pointer arithmetic, invalid types)
+#define PLC_PD_TYPED_SELECT(name, handler, fn) \
+    template <bool Checked> PLCDecodedHandler select_##name(u8 data_type) { \
+        switch (data_type) { \
+            case type_bool: \
+            case type_u8: return handler<Checked, u8, fn<u8> >; \
+            case type_u16: return handler<Checked, u16, fn<u16> >; \
+            case type_i8: return handler<Checked, i8, fn<i8> >; \
+            case type_i16: return handler<Checked, i16, fn<i16> >; \
+            PLC_PD_CASE_32(handler, fn) \
+            PLC_PD_CASE_F32(handler, fn) \
+            PLC_PD_CASE_64(handler, fn) \
+            default: return nullptr; \
+        } \
+    }
+
+    PLC_PD_TYPED_SELECT(ADD, op_arith, pd_add)
+    PLC_PD_TYPED_SELECT(SUB, op_arith, pd_sub)
+    PLC_PD_TYPED_SELECT(MUL, op_arith, pd_mul)
+    PLC_PD_TYPED_SELECT(DIV, op_arith, pd_div)
+    PLC_PD_TYPED_SELECT(MOD, op_arith, pd_mod)
+    PLC_PD_TYPED_SELECT(CMP_EQ, op_compare, pd_eq)
+    PLC_PD_TYPED_SELECT(CMP_NEQ, op_compare, pd_neq)
+    PLC_PD_TYPED_SELECT(CMP_GT, op_compare, pd_gt)
+    PLC_PD_TYPED_SELECT(CMP_GTE, op_compare, pd_gte)
+    PLC_PD_TYPED_SELECT(CMP_LT, op_compare, pd_lt)
+    PLC_PD_TYPED_SELECT(CMP_LTE, op_compare, pd_lte)
+
+#undef PLC_PD_TYPED_SELECT
+#undef PLC_PD_CASE_32
+#undef PLC_PD_CASE_F32
+#undef PLC_PD_CASE_64
+#undef PLC_PD_ARGS
+
+    // Resolve a jump target byte offset to a record index, false if it is not an instruction start
+    bool resolveTarget(PLCDecodedProgram& d, i32 target, u32& record) {
+        if (target < 0 || (u32) target >= d.prog_size) return false;
+        if (d.op_at[target] == PLC_DECODED_NONE) return false;
+        record = d.op_at[target];
+        return true;
+    }
+
+    // Pick the specialized handler for a decoded record, leaving op_generic when unsure
+    template <bool Checked>
+    void specialize(VovkPLCRuntime& rt, PLCDecodedOp& op) {
+        PLCDecodedProgram& d = rt.decoded;
+        const u8* program = rt.program.program;
+        const u32 prog_size = d.prog_size;
+        const u32 i = op.offset + 1; // First operand byte
+        const u8 opcode = program[op.offset];
+        op.handler = op_generic;
+
+        if (opcode >= READ_X8_B0 && opcode <= WRITE_INV_X8_B7) {
+            // Operand bounds are validated by step() after the access, so keep the error path generic
+            if (i + MY_PTR_SIZE_BYTES >= prog_size) return;
+            MY_PTR_t address = read_ptr(program + i);
+            if ((u32) address + 1 > PLCRUNTIME_MAX_MEMORY_SIZE) return;
+            u8 group = (opcode - READ_X8_B0) / 8;
+            op.arg = address;
+            op.imm.type_u8 = (opcode - READ_X8_B0) % 8;
+            switch (group) {
+                case 0: op.handler = op_read_bit<Checked>; break;
+                case 1: op.handler = op_write_bit<Checked>; break;
+                case 2: op.handler = op_write_s_bit; break;
+                case 3: op.handler = op_write_r_bit; break;
+                default: op.handler = op_write_inv_bit; break;
+            }
+            return;
+        }
+
+        switch (opcode) {
+            case NOP:
+            case LANG:
+            case COMMENT: op.handler = op_nop; return;
+            case EXIT: op.handler = op_exit; return;
+
+            case LOGIC_AND: op.handler = op_logic_and<Checked>; return;
+            case LOGIC_OR: op.handler = op_logic_or<Checked>; return;
+            case LOGIC_NOT: op.handler = op_logic_not<Checked>; return;
+            case LOGIC_XOR: op.handler = op_logic_xor<Checked>; return;
+            case CLEAR: op.handler = op_stack<PLCMethods::CLEAR>; return;
+
+            case GET_X8_B0: op.handler = op_stack<PLCMethods::handle_GET_X8_B0>; return;
+            case GET_X8_B1: op.handler = op_stack<PLCMethods::handle_GET_X8_B1>; return;
+            case GET_X8_B2: op.handler = op_stack<PLCMethods::handle_GET_X8_B2>; return;
+            case GET_X8_B3: op.handler = op_stack<PLCMethods::handle_GET_X8_B3>; return;
+            case GET_X8_B4: op.handler = op_stack<PLCMethods::handle_GET_X8_B4>; return;
+            case GET_X8_B5: op.handler = op_stack<PLCMethods::handle_GET_X8_B5>; return;
+            case GET_X8_B6: op.handler = op_stack<PLCMethods::handle_GET_X8_B6>; return;
+            case GET_X8_B7: op.handler = op_stack<PLCMethods::handle_GET_X8_B7>; return;
+            case SET_X8_B0: op.handler = op_stack<PLCMethods::handle_SET_X8_B0>; return;
+            case SET_X8_B1: op.handler = op_stack<PLCMethods::handle_SET_X8_B1>; return;
+            case SET_X8_B2: op.handler = op_stack<PLCMethods::handle_SET_X8_B2>; return;
+            case SET_X8_B3: op.handler = op_stack<PLCMethods::handle_SET_X8_B3>; return;
+            case SET_X8_B4: op.handler = op_stack<PLCMethods::handle_SET_X8_B4>; return;
+            case SET_X8_B5: op.handler = op_stack<PLCMethods::handle_SET_X8_B5>; return;
+            case SET_X8_B6: op.handler = op_stack<PLCMethods::handle_SET_X8_B6>; return;
+            case SET_X8_B7: op.handler = op_stack<PLCMethods::handle_SET_X8_B7>; return;
+            case RSET_X8_B0: op.handler = op_stack<PLCMethods::handle_RSET_X8_B0>; return;
+            case RSET_X8_B1: op.handler = op_stack<PLCMethods::handle_RSET_X8_B1>; return;
+            case RSET_X8_B2: op.handler = op_stack<PLCMethods::handle_RSET_X8_B2>; return;
+            case RSET_X8_B3: op.handler = op_stack<PLCMethods::handle_RSET_X8_B3>; return;
+            case RSET_X8_B4: op.handler = op_stack<PLCMethods::handle_RSET_X8_B4>; return;
+            case RSET_X8_B5: op.handler = op_stack<PLCMethods::handle_RSET_X8_B5>; return;
+            case RSET_X8_B6: op.handler = op_stack<PLCMethods::handle_RSET_X8_B6>; return;
+            case RSET_X8_B7: op.handler = op_stack<PLCMethods::handle_RSET_X8_B7>; return;
+
+            case BR_SAVE: op.handler = op_br_save<Checked>; return;
+            case BR_READ: op.handler = op_br_read<Checked>; return;
+            case BR_DROP: op.handler = op_br_drop; return;
+            case BR_CLR: op.handler = op_br_clr; return;
+
+            case type_bool: op.handler = op_push_u8<Checked>; op.imm.type_u8 = program[i] ? 1 : 0; return;
+            case type_u8:
+            case type_i8: op.handler = op_push_u8<Checked>; op.imm.type_u8 = program[i]; return;
+            case type_u16:
+            case type_i16: op.handler = op_push_u16<Checked>; memcpy(&op.imm.type_u16, program + i, 2); return;
+#ifdef PLCRUNTIME_32BIT_OPS_ENABLED
+            case type_u32:
+            case type_i32: op.handler = op_push_u32<Checked>; memcpy(&op.imm.type_u32, program + i, 4); return;
+#endif // PLCRUNTIME_32BIT_OPS_ENABLED
+#ifdef PLCRUNTIME_FLOAT_OPS_ENABLED
+            case type_f32: op.handler = op_push_u32<Checked>; memcpy(&op.imm.type_u32, program + i, 4); return;
+#endif // PLCRUNTIME_FLOAT_OPS_ENABLED
+#ifdef USE_X64_OPS
+            case type_u64:
+            case type_i64:
+            case type_f64: op.handler = op_push_u64<Checked>; memcpy(&op.imm.type_u64, program + i, 8); return;
+#endif // USE_X64_OPS
+
+            case LOAD_FROM:
+            case MOVE_TO: {
+                u8 data_type = program[i];
+                u32 address = read_ptr(program + i + 1);
+                u32 width = 0;
+                PLCDecodedHandler load = nullptr;
+                PLCDecodedHandler move = nullptr;
+                switch (data_type) {
+                    case type_bool:
+                    case type_u8:
+                    case type_i8: width = 1; load = op_load_u8<Checked>; move = op_move_u8<Checked>; break;
+                    case type_u16:
+                    case type_i16: width = 2; load = op_load_u16<Checked>; move = op_move_u16<Checked>; break;
+                    case type_u32:
+                    case type_i32:
+                    case type_f32: width = 4; load = op_load_u32<Checked>; move = op_move_u32<Checked>; break;
+#ifdef USE_X64_OPS
+                    case type_u64:
+                    case type_i64:
+                    case type_f64: width = 8; load = op_load_u64<Checked>; move = op_move_u64<Checked>; break;
+#endif // USE_X64_OPS
+                    default: return;
+                }
+                if (address + width > PLCRUNTIME_MAX_MEMORY_SIZE) return;
+                op.arg = address;
+                op.handler = opcode == LOAD_FROM ? load : move;
+                return;
+            }
+
+            case ADD: op.handler = select_ADD<Checked>(program[i]); break;
+            case SUB: op.handler = select_SUB<Checked>(program[i]); break;
+            case MUL: op.handler = select_MUL<Checked>(program[i]); break;
+            case DIV: op.handler = select_DIV<Checked>(program[i]); break;
+            case MOD: op.handler = select_MOD<Checked>(program[i]); break;
+            case CMP_EQ: op.handler = select_CMP_EQ<Checked>(program[i]); break;
+            case CMP_NEQ: op.handler = select_CMP_NEQ<Checked>(program[i]); break;
+            case CMP_GT: op.handler = select_CMP_GT<Checked>(program[i]); break;
+            case CMP_GTE: op.handler = select_CMP_GTE<Checked>(program[i]); break;
+            case CMP_LT: op.handler = select_CMP_LT<Checked>(program[i]); break;
+            case CMP_LTE: op.handler = select_CMP_LTE<Checked>(program[i]); break;
+
+            case JMP:
+            case JMP_IF:
+            case JMP_IF_NOT:
+            case CALL:
+            case CALL_IF:
+            case CALL_IF_NOT:
+            case JMP_REL:
+            case JMP_IF_REL:
+            case JMP_IF_NOT_REL:
+            case CALL_REL:
+            case CALL_IF_REL:
+            case CALL_IF_NOT_REL: {
+                bool relative = opcode >= JMP_REL && opcode <= CALL_IF_NOT_REL;
+                i32 target = relative ? (i32) i + 2 + read_i16(program + i) : (i32) read_u16(program + i);
+                // CALL_IF/CALL_IF_NOT treat address 0 as an error, keep that path in step()
+                if ((opcode == CALL_IF || opcode == CALL_IF_NOT) && target == 0) return;
+                u32 record = 0;
+                if (!resolveTarget(d, target, record)) return;
+                op.arg = record;
+                op.imm.type_u32 = i + 2;
+                switch (opcode) {
+                    case JMP: case JMP_REL: op.handler = op_jmp; break;
+                    case JMP_IF: case JMP_IF_REL: op.handler = op_jmp_if; break;
+                    case JMP_IF_NOT: case JMP_IF_NOT_REL: op.handler = op_jmp_if_not; break;
+                    case CALL: case CALL_REL: op.handler = op_call; break;
+                    case CALL_IF: case CALL_IF_REL: op.handler = op_call_if; break;
+                    default: op.handler = op_call_if_not; break;
+                }
+                return;
+            }
+            default: return;
+        }
+        if (!op.handler) op.handler = op_generic;
+    }
+
+} // namespace PLCPredecode
+
+void VovkPLCRuntime::predecode() {
+    PLCDecodedProgram& d = decoded;
+    const u8* bytecode = program.program;
+    const u32 prog_size = program.prog_size;
+    d.invalidate();
+    if (!d.reserve(prog_size)) return; // Stays invalid, run() interprets the bytecode
+    d.prog_size = prog_size;
+    d.revision = program.revision;
+    d.end_offset = 0;
+    d.handoff_index = 0;
+    for (u32 i = 0; i < prog_size; i++) d.op_at[i] = PLC_DECODED_NONE;
+
+    // Pass 1: instruction boundaries
+    u32 index = 0;
+    u32 count = 0;
+    while (index < prog_size && count < PLCDecodedProgram::maxOps(prog_size)) {
+        u32 size = INSTRUCTION_SIZE(bytecode, prog_size, index);
+        if (size == 0 || index + size > prog_size) break; // Unknown or truncated - the interpreter takes over here
+        PLCDecodedOp& op = d.ops[count];
+        op.handler = PLCPredecode::op_generic;
+        op.offset = index;
+        op.arg = 0;
+        op.imm.type_u32 = 0;
+        d.op_at[index] = (u16) count;
+        count++;
+        index += size;
+    }
+    d.count = count;
+    d.end_offset = index;
+
+#ifdef PLCRUNTIME_VERIFIER_ENABLED
+    // Proven programs get the handlers without stack overflow/underflow checks
+    d.verified = verifier.verify(d, bytecode, d.max_stack);
+#endif // PLCRUNTIME_VERIFIER_ENABLED
+
+    // Pass 2: specialized handlers (jump targets need the complete boundary map)
+    if (d.verified) for (u32 i = 0; i < count; i++) PLCPredecode::specialize<false>(*this, d.ops[i]);
+    else for (u32 i = 0; i < count; i++) PLCPredecode::specialize<true>(*this, d.ops[i]);
+    d.valid = true;
+#ifdef PLCRUNTIME_JIT_ENABLED
+    jit.compile(d); // Falls back to runDecoded() when the code can not be generated
+#endif // PLCRUNTIME_JIT_ENABLED
+}
+
+RuntimeError VovkPLCRuntime::runDecoded(u32& index, u32& instruction_count) {
+    PLCDecodedProgram& d = decoded;
+    const PLCDecodedOp* ops = d.ops;
+    const u32 count = d.count;
+    RuntimeError status = STATUS_SUCCESS;
+    PLCDecodedTos tos; // Top of stack cache, spilled before leaving the loop
+    u32 pc = 0;
+#ifdef PLCRUNTIME_JIT_ENABLED
+    if (jit.valid) status = jit.entry(this, &pc, &tos, &instruction_count);
+    else
+#endif // PLCRUNTIME_JIT_ENABLED
+    while (pc < count) {
+        const PLCDecodedOp& op = ops[pc++];
+        instruction_count++;
+        status = op.handler(*this, op, pc, tos);
+        if (status != STATUS_SUCCESS) break;
+    }
+    tos.spill(stack);
+    index = pc == PLC_DECODED_HANDOFF ? d.handoff_index : d.end_offset;
+    return status;
+}
+
+#endif // PLCRUNTIME_PREDECODE_ENABLED
@@ -0,0 +1,233 @@
+// runtime-predecode.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-tools.h"
+#include "runtime-instructions.h"
+#include "stack/runtime-stack.h"
+
+#ifdef PLCRUNTIME_PREDECODE_ENABLED
+
+// ============================================================================
+// Pre-decoded instruction stream
+// ============================================================================
+// The bytecode is decoded linearly into PLCDecodedOp records. Each record keeps
+// the byte offset of its instruction, so control flow that cannot be resolved
+// at load time (RET, computed targets, instructions without a specialized
+// handler) is mapped back through `op_at` - a byte offset to record index table.
+// Both tables are allocated for the size of the loaded program and only grow
+// when a larger program is loaded, so an idle runtime costs no cache memory.
+//
+// Instructions without a specialized handler use a generic record that calls
+// VovkPLCRuntime::step() on the original bytecode, so behaviour is identical
+// to the interpreter for every opcode. If execution ever lands on a byte offset
+// that was not decoded (jump into the middle of an instruction, program larger
+// than the cache), run() hands the remainder of the cycle over to the regular
+// interpreter at that offset.
+//
+// While the cache runs, the top two stack values are held in a PLCDecodedTos
+// owned by the dispatch loop instead of the byte stack, so arithmetic, compare
+// and logic chains do not round-trip through RuntimeStack memory. The cached
+// values are spilled back before anything that works on RuntimeStack directly
+// runs (step() fallbacks, generic stack handlers, FFI) and when the loop ends
+// or hands over to the interpreter.
+// ============================================================================
+
+#ifndef PLCRUNTIME_PREDECODE_MAX_OPS
+#define PLCRUNTIME_PREDECODE_MAX_OPS (PLCRUNTIME_MAX_PROGRAM_SIZE / 2)
+#endif // PLCRUNTIME_PREDECODE_MAX_OPS
+
+// Record indexes are stored as u16 (op_at[], verifier work list, ensemble jump targets), 0xFFFF stays free for PLC_DECODED_NONE
+static_assert(PLCRUNTIME_PREDECODE_MAX_OPS <= 0xFFFF, "PLCRUNTIME_PREDECODE_MAX_OPS must fit a u16 record index");
+
+#define PLC_DECODED_NONE 0xFFFF               // op_at[] marker for bytes that are not an instruction start
+#define PLC_DECODED_HANDOFF 0xFFFFFFFFu       // pc value requesting a hand-over to the interpreter
+
+class VovkPLCRuntime;
+struct PLCDecodedOp;
+struct PLCDecodedTos;
+
+// Specialized instruction handler. `pc` already points at the next record when called.
+typedef RuntimeError (*PLCDecodedHandler)(VovkPLCRuntime& runtime, const PLCDecodedOp& op, u32& pc, PLCDecodedTos& tos);
+
+union PLCDecodedValue {
+    u8 type_u8;
+    u16 type_u16;
+    u32 type_u32;
+#ifdef USE_X64_OPS
+    u64 type_u64;
+#endif // USE_X64_OPS
+};
+
+// Cached top of the runtime stack. Values keep their native byte layout, so a
+// spill is a plain copy and values of any width can be mixed with stack memory.
+struct PLCDecodedTos {
+    PLCDecodedValue top;  // Top of stack
+    PLCDecodedValue next; // Value right below `top`
+    u8 top_width = 0;     // Bytes held in `top`, 0 when empty
+    u8 next_width = 0;    // Bytes held in `next`, only used while `top` is held
+
+    // Stack size including the cached values
+    u32 size(RuntimeStack& stack) const { return stack.size() + top_width + next_width; }
+
+    // Write the cached values back to the stack
+    void spill(RuntimeStack& stack) {
+        if (next_width) stack.stack.pushRaw(&next, next_width);
+        if (top_width) stack.stack.pushRaw(&top, top_width);
+        top_width = 0;
+        next_width = 0;
+    }
+
+    template <typename T> RuntimeError push(RuntimeStack& stack, T value) {
+        if (size(stack) + sizeof(T) > PLCRUNTIME_MAX_STACK_SIZE) return STACK_OVERFLOW;
+        if (next_width) stack.stack.pushRaw(&next, next_width);
+        next = top;
+        next_width = top_width;
+        memcpy(&top, &value, sizeof(T));
+        top_width = sizeof(T);
+        return STATUS_SUCCESS;
+    }
+
+    // push() without the overflow check, for programs proven by the load-time verifier
+    template <typename T> void put(RuntimeStack& stack, T value) {
+        if (next_width) stack.stack.pushRaw(&next, next_width);
+        next = top;
+        next_width = top_width;
+        memcpy(&top, &value, sizeof(T));
+        top_width = sizeof(T);
+    }
+
+    // Values cached with a different width are spilled and read back from the stack
+    template <typename T> T pop(RuntimeStack& stack) {
+        T value = 0;
+        if (top_width == sizeof(T)) {
+            memcpy(&value, &top, sizeof(T));
+            top = next;
+            top_width = next_width;
+            next_width = 0;
+            return value;
+        }
+        spill(stack);
+        stack.stack.popRaw(&value, sizeof(T));
+        return value;
+    }
+};
+
+struct PLCDecodedOp {
+    PLCDecodedHandler handler; // Type-specialized handler for this instruction
+    u32 offset;                // Byte offset of the instruction in the bytecode
+    u32 arg;                   // Unpacked operand: memory address or resolved record index
+    PLCDecodedValue imm;       // Unpacked immediate: constant, bit index or return address
+};
+
+// Table memory for the cache and the verifier. On WASM malloc() only serves small
+// blocks, so the tables come from page_alloc() and are never handed back; tables
+// grow at least twofold so the pages left behind stay below the final size.
+template <typename T> T* plc_decoded_alloc(u32 count) {
+#ifdef __WASM__
+    return (T*) page_alloc(count * sizeof(T));
+#else
+    return new T[count];
+#endif // __WASM__
+}
+
+template <typename T> void plc_decoded_free(T* table) {
+#ifndef __WASM__
+    delete[] table;
+#else
+    (void) table;
+#endif // __WASM__
+}
+
+// Capacity to grow to for a program of `size` bytes
+inline u32 plc_decoded_capacity(u32 size, u32 capacity) {
+    u32 grown = capacity * 2;
+    if (grown > PLCRUNTIME_MAX_PROGRAM_SIZE) grown = PLCRUNTIME_MAX_PROGRAM_SIZE;
+    return size > grown ? size : grown;
+}
+
+struct PLCDecodedProgram {
+    PLCDecodedOp* ops = nullptr; // Decoded records
+    u16* op_at = nullptr;   // Byte offset -> record index (PLC_DECODED_NONE if not decoded)
+    u32 capacity = 0;       // Program bytes the tables are allocated for
+    u32 count = 0;          // Number of decoded records
+    u32 end_offset = 0;     // Byte offset right after the last decoded record
+    u32 prog_size = 0;      // Program size the cache was built for
+    u32 revision = 0;       // RuntimeProgram::revision the cache was built for
+    u32 handoff_index = 0;  // Byte offset to continue from when pc == PLC_DECODED_HANDOFF
+    bool valid = false;
+    bool verified = false;  // Proven by the load-time verifier, runs the unchecked handlers
+    u16 max_stack = 0;      // Peak stack depth of a verified program
+
+    void invalidate() { valid = false; verified = false; count = 0; }
+
+    // Largest number of records a program of `size` bytes can decode into
+    static u32 maxOps(u32 size) { return size < PLCRUNTIME_PREDECODE_MAX_OPS ? size : PLCRUNTIME_PREDECODE_MAX_OPS; }
+
+    // Grow the tables to hold a program of `size` bytes, smaller programs reuse them
+    // Returns false when the memory can not be allocated
+    bool reserve(u32 size) {
+        if (size <= capacity) return true;
+        size = plc_decoded_capacity(size, capacity);
+        release();
+        ops = plc_decoded_alloc<PLCDecodedOp>(maxOps(size));
+        op_at = plc_decoded_alloc<u16>(size);
+        if (!ops || !op_at) {
+            release();
+            return false;
+        }
+        capacity = size;
+        return true;
+    }
+
+    void release() {
+        invalidate();
+        plc_decoded_free(ops);
+        plc_decoded_free(op_at);
+        ops = nullptr;
+        op_at = nullptr;
+        capacity = 0;
+    }
+
+    PLCDecodedProgram() {}
+    PLCDecodedProgram(const PLCDecodedProgram&) = delete;
+    PLCDecodedProgram& operator=(const PLCDecodedProgram&) = delete;
+    ~PLCDecodedProgram() { release(); }
+
+    // Map a byte offset to a record index, or request an interpreter hand-over
+    void jumpTo(u32 index, u32& pc) {
+        if (index < prog_size && op_at[index] != PLC_DECODED_NONE) {
+            pc = op_at[index];
+            return;
+        }
+        handoff_index = index;
+        pc = PLC_DECODED_HANDOFF;
+    }
+
+    // Continue after an instruction that moved the byte index itself
+    void resume(u32 index, u32& pc) {
+        if (pc < count && ops[pc].offset == index) return;
+        jumpTo(index, pc);
+    }
+};
+
+#endif // PLCRUNTIME_PREDECODE_ENABLED
@@ -0,0 +1,97 @@
+// runtime-process-image.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-tools.h"
+
+#ifdef PLCRUNTIME_PROCESS_IMAGE_ENABLED
+
+// ============================================================================
+// Process image exchange
+// ============================================================================
+// Hands a block of I/O bytes from one writer to one reader without locks.
+// Three slots rotate between the two sides: the writer fills its `back` slot
+// and publishes it by swapping it with the shared `middle` slot, the reader
+// takes the newest published slot by swapping its `front` slot with `middle`.
+// Both operations are a single atomic byte exchange, so neither side ever waits
+// for the other and the reader always sees a complete image, never a mix of two.
+//
+// The scan cycle is the reader of the input image and the writer of the output
+// image; the I/O thread or interrupt is the other side of both.
+// ============================================================================
+
+#define PLC_IMAGE_SLOT_MASK 0x03
+#define PLC_IMAGE_FRESH     0x80
+
+#ifdef __AVR__
+#include <util/atomic.h>
+inline u8 plc_image_exchange(volatile u8* shared, u8 value) {
+    u8 previous;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        previous = *shared;
+        *shared = value;
+    }
+    return previous;
+}
+inline u8 plc_image_load(volatile u8* shared) { return *shared; }
+#else
+inline u8 plc_image_exchange(volatile u8* shared, u8 value) { return __atomic_exchange_n(shared, value, __ATOMIC_ACQ_REL); }
+inline u8 plc_image_load(volatile u8* shared) { return __atomic_load_n(shared, __ATOMIC_ACQUIRE); }
+#endif // __AVR__
+
+template <u32 SIZE>
+struct PLCImageExchange {
+    u8 slots[3][SIZE];
+    u8 back = 0; // Writer side
+    u8 front = 1; // Reader side
+    volatile u8 middle = 2; // Shared slot index, with PLC_IMAGE_FRESH set while it holds an image the reader has not taken
+
+    PLCImageExchange() { reset(); }
+
+    void reset() {
+        for (u32 s = 0; s < 3; s++)
+            for (u32 i = 0; i < SIZE; i++) slots[s][i] = 0;
+        back = 0;
+        front = 1;
+        middle = 2;
+    }
+
+    // Writer: slot to fill before publish()
+    u8* writeSlot() { return slots[back]; }
+
+    // Writer: make the filled slot the newest image
+    void publish() {
+        back = plc_image_exchange(&middle, back | PLC_IMAGE_FRESH) & PLC_IMAGE_SLOT_MASK;
+    }
+
+    // Reader: switch to the newest image, returns false if nothing was published since the last fetch
+    bool fetch() {
+        if (!(plc_image_load(&middle) & PLC_IMAGE_FRESH)) return false;
+        front = plc_image_exchange(&middle, front) & PLC_IMAGE_SLOT_MASK;
+        return true;
+    }
+
+    // Reader: image taken by the last fetch()
+    const u8* readSlot() const { return slots[front]; }
+};
+
+#endif // PLCRUNTIME_PROCESS_IMAGE_ENABLED
@@ -301,6 +301,65 @@ public:
         return 1;
     }
 
+    // Push BR_SAVE_READ instruction - fused BR_SAVE + BR_READ
+    static u8 push_br_save_read(u8* location) {
+        location[0] = BR_SAVE_READ;
+        return 1;
+    }
+
+    // Fused superinstructions
+
+    // Push READ_AND_X8 / READ_OR_X8 instruction - fused READ_X8_Bn + LOGIC_AND / LOGIC_OR
+    static u8 push_read_logic_x8(u8* location, PLCRuntimeInstructionSet opcode, MY_PTR_t address, u8 bit) {
+        location[0] = opcode;
+        write_ptr(location + 1, address);
+        location[1 + sizeof(MY_PTR_t)] = bit;
+        return 2 + sizeof(MY_PTR_t);
+    }
+
+    // Push BIT_GATHER_X32/X64 or BIT_SCATTER_X32/X64 instruction - `count` (address, bit) pairs, bit n of the value is the n-th pair
+    static u8 push_bit_list(u8* location, PLCRuntimeInstructionSet opcode, u8 count, const MY_PTR_t* addresses, const u8* bits) {
+        location[0] = opcode;
+        location[1] = count;
+        u8* entry = location + 2;
+        for (u8 n = 0; n < count; n++, entry += sizeof(MY_PTR_t) + 1) {
+            write_ptr(entry, addresses[n]);
+            entry[sizeof(MY_PTR_t)] = bits[n];
+        }
+        return 2 + count * (sizeof(MY_PTR_t) + 1);
+    }
+
+    // Push READ_AND_WRITE_X8 instruction - fused READ_X8_Bn + LOGIC_AND + WRITE_X8_Bn
+    static u8 push_read_and_write_x8(u8* location, MY_PTR_t src_address, u8 src_bit, MY_PTR_t dst_address, u8 dst_bit) {
+        location[0] = READ_AND_WRITE_X8;
+        write_ptr(location + 1, src_address);
+        location[1 + sizeof(MY_PTR_t)] = src_bit;
+        write_ptr(location + 2 + sizeof(MY_PTR_t), dst_address);
+        location[2 + 2 * sizeof(MY_PTR_t)] = dst_bit;
+        return 3 + 2 * sizeof(MY_PTR_t);
+    }
+
+    // Push LOAD_CMP_IMM instruction - fused LOAD_FROM + <type> const + CMP_xx. `value` holds the encoded immediate
+    static u8 push_load_cmp_imm(u8* location, PLCRuntimeInstructionSet cmp_opcode, PLCRuntimeInstructionSet type, MY_PTR_t address, const u8* value) {
+        u8 size = LOAD_CMP_IMM_SIZE(type);
+        if (size == 0) return 0;
+        location[0] = LOAD_CMP_IMM;
+        location[1] = cmp_opcode;
+        location[2] = type;
+        write_ptr(location + 3, address);
+        for (u8 i = 3 + sizeof(MY_PTR_t); i < size; i++) location[i] = value[i - 3 - sizeof(MY_PTR_t)];
+        return size;
+    }
+
+    // Push LOAD_CMP_IMM_JMP_IF_NOT instruction - fused LOAD_CMP_IMM + JMP_IF_NOT
+    static u8 push_load_cmp_imm_jmp_if_not(u8* location, PLCRuntimeInstructionSet cmp_opcode, PLCRuntimeInstructionSet type, MY_PTR_t address, const u8* value, u32 location_address) {
+        u8 size = push_load_cmp_imm(location, cmp_opcode, type, address, value);
+        if (size == 0) return 0;
+        location[0] = LOAD_CMP_IMM_JMP_IF_NOT;
+        write_u16(location + size, (u16) location_address);
+        return size + 2;
+    }
+
 
     // Convert a data type to another data type
     static u8 push_cvt(u8* location, PLCRuntimeInstructionSet from, PLCRuntimeInstructionSet to) {
@@ -506,6 +565,39 @@ public:
         }
         return offset; // 3 + 2 * (param_count + 1)
     }
+
+    // Push FFI_START instruction, addresses as for push_ffi_call followed by the handle address
+    // Format: [FFI_START][index:u8][param_count:u8][addr1:u16]...[addrN:u16][ret_addr:u16][handle_addr:u16]
+    // param_addrs array should have param_count + 2 elements (params + return address + handle address)
+    static u8 push_ffi_start(u8* location, u8 ffi_index, u8 param_count, const u16* param_addrs) {
+        location[0] = FFI_START;
+        location[1] = ffi_index;
+        location[2] = param_count;
+        u8 offset = 3;
+        for (u8 i = 0; i < param_count + 2; i++) {
+            write_u16(location + offset, param_addrs[i]);
+            offset += sizeof(u16);
+        }
+        return offset; // 3 + 2 * (param_count + 2)
+    }
+
+    // Push FFI_POLL instruction: [FFI_POLL][handle_addr:u16]
+    static u8 push_ffi_poll(u8* location, u16 handle_addr) {
+        location[0] = FFI_POLL;
+        write_u16(location + 1, handle_addr);
+        return 3;
+    }
+
+    // Push FFI_CALL_BATCH instruction, `count` records of the function's record size `stride` bytes apart
+    // Format: [FFI_CALL_BATCH][index:u8][base_addr:u16][count:u16][stride:u16]
+    static u8 push_ffi_batch(u8* location, u8 ffi_index, u16 base_addr, u16 count, u16 stride) {
+        location[0] = FFI_CALL_BATCH;
+        location[1] = ffi_index;
+        write_u16(location + 2, base_addr);
+        write_u16(location + 4, count);
+        write_u16(location + 6, stride);
+        return 8;
+    }
 };
 
 // ==================== EEPROM/Flash Program Storage Support ====================
@@ -947,6 +1039,7 @@ public:
     u32 prog_size = 0; // Current program size in bytes
     u32 program_line = 0; // Active program line
     RuntimeError status = UNDEFINED_STATE;
+    u32 revision = 0; // Incremented on every load/format/modify so cached decodings can detect changes
 
     RuntimeProgram(u32 prog_size) {
         if (prog_size > PLCRUNTIME_MAX_PROGRAM_SIZE) prog_size = PLCRUNTIME_MAX_PROGRAM_SIZE;
@@ -968,6 +1061,7 @@ public:
         this->prog_size = 0;
         this->program_line = 0;
         this->status = UNDEFINED_STATE;
+        this->revision++;
     }
 
     RuntimeError loadUnsafe(const u8* program, u32 prog_size) {
@@ -981,6 +1075,7 @@ public:
             // memcpy(this->program, program, prog_size);
             for (u32 i = 0; i < prog_size; i++) this->program[i] = program[i];
             this->prog_size = prog_size;
+            this->revision++;
             status = STATUS_SUCCESS;
         }
         return status;
@@ -1026,6 +1121,7 @@ public:
         
         this->prog_size = eeprom_prog_size;
         this->program_line = 0;
+        this->revision++;
         status = STATUS_SUCCESS;
         Serial.print(F("Loaded program from EEPROM: "));
         Serial.print(eeprom_prog_size);
@@ -1041,6 +1137,7 @@ public:
     RuntimeError modify(u32 index, u8 value) {
         if (index >= prog_size) return INVALID_PROGRAM_INDEX;
         program[index] = value;
+        revision++;
         return STATUS_SUCCESS;
     }
 
@@ -1048,12 +1145,14 @@ public:
     RuntimeError modify(u32 index, u8* data, u32 size) {
         if (index + size > prog_size) return INVALID_PROGRAM_INDEX;
         for (u32 i = 0; i < size; i++) program[index + i] = data[i];
+        revision++;
         return STATUS_SUCCESS;
     }
 
     RuntimeError modifyValue(u32 index, u16 value) {
         if (index + sizeof(u16) > prog_size) return INVALID_PROGRAM_INDEX;
         write_u16(program + index, value);
+        revision++;
         return STATUS_SUCCESS;
     }
 
@@ -1216,6 +1315,7 @@ public:
 
             // Get current instruction size
             u8 instruction_size = OPCODE_SIZE(opcode);
+            if (instruction_size == 0) instruction_size = (u8) INSTRUCTION_SIZE(program, prog_size, index); // Packed bit lists and fused compares
             // Get current instruction name
             auto instruction_name = OPCODE_NAME(opcode);
             int length = Serial.print(instruction_name);
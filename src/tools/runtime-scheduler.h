@@ -0,0 +1,311 @@
+// runtime-scheduler.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#ifdef PLCRUNTIME_SCHEDULER_ENABLED
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#ifndef PLCRUNTIME_SCHEDULER_MAX_TASKS
+#define PLCRUNTIME_SCHEDULER_MAX_TASKS 256
+#endif // PLCRUNTIME_SCHEDULER_MAX_TASKS
+
+#ifndef PLCRUNTIME_SCHEDULER_MAX_WORKERS
+#define PLCRUNTIME_SCHEDULER_MAX_WORKERS 64
+#endif // PLCRUNTIME_SCHEDULER_MAX_WORKERS
+
+// ============================================================================
+// Multi-PLC scheduler
+// ============================================================================
+// Every registered runtime is a task with its own scan period. Any idle worker
+// scans the task table and moves due tasks into the ready queue of the task's
+// home worker, so a task keeps running on the same core while its home worker
+// keeps up. A worker pops its own queue newest first and, when it runs dry,
+// steals the oldest task from the other workers. A task is never queued or run
+// twice at the same time; a release that finds the previous cycle still running
+// is counted as an overrun and skipped.
+//
+// The scheduler owns the time base of its runtimes: each cycle feeds the task
+// clock (PLCClock::external) with the scheduler time in milliseconds. Cycle time,
+// period and jitter are measured by the scheduler per task and reported through
+// getDeviceHealth() together with the runtime's own RAM statistics.
+//
+//   PLCScheduler scheduler;
+//   scheduler.add(plc_a, 10000); // 10 ms scan
+//   scheduler.add(plc_b, 50000); // 50 ms scan
+//   scheduler.start();           // One worker per hardware thread
+//   ...
+//   scheduler.stop();
+// ============================================================================
+
+class PLCScheduler {
+public:
+    enum TaskState : u8 { TASK_IDLE = 0, TASK_QUEUED, TASK_RUNNING };
+
+    struct Task {
+        VovkPLCRuntime* runtime = nullptr;
+        u32 period_us = 0;
+        u16 home = 0;                  // Worker whose queue receives the task's releases
+        std::atomic<u8> state;         // TaskState
+        std::atomic<u64> next_release_us; // Advanced by whoever moves the task from IDLE to QUEUED
+        u64 release_us = 0;            // Release time of the queued / running cycle
+        // Statistics, written only by the worker running the task
+        u64 last_start_us = 0;
+        u32 cycles = 0;
+        u32 overruns = 0;              // Releases skipped because the previous cycle was still running
+        u32 last_release_delay_us = 0; // Time from release to start of the last cycle
+        u32 max_release_delay_us = 0;
+        RuntimeError last_status = STATUS_SUCCESS;
+        DeviceHealth health;
+        Task() : state(TASK_IDLE), next_release_us(0) { resetHealth(); }
+        void resetHealth() {
+            health.last_cycle_time_us = 0;
+            health.min_cycle_time_us = 1000000000;
+            health.max_cycle_time_us = 0;
+            health.last_ram_free = 0;
+            health.min_ram_free = 0;
+            health.max_ram_free = 0;
+            health.total_ram_size = 0;
+            health.last_period_us = 0;
+            health.min_period_us = 1000000000;
+            health.max_period_us = 0;
+            health.last_jitter_us = 0;
+            health.min_jitter_us = 1000000000;
+            health.max_jitter_us = 0;
+            max_release_delay_us = 0;
+        }
+    };
+
+private:
+    // Ready queue of one worker. The owner takes from the bottom, thieves from the top.
+    struct ReadyQueue {
+        std::mutex lock;
+        u16 items[PLCRUNTIME_SCHEDULER_MAX_TASKS];
+        u32 top = 0;    // Oldest entry
+        u32 bottom = 0; // One past the newest entry
+
+        void push(u16 task) {
+            std::lock_guard<std::mutex> guard(lock);
+            items[bottom % PLCRUNTIME_SCHEDULER_MAX_TASKS] = task;
+            bottom++;
+        }
+        bool pop(u16& task) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (bottom == top) return false;
+            bottom--;
+            task = items[bottom % PLCRUNTIME_SCHEDULER_MAX_TASKS];
+            return true;
+        }
+        bool steal(u16& task) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (bottom == top) return false;
+            task = items[top % PLCRUNTIME_SCHEDULER_MAX_TASKS];
+            top++;
+            return true;
+        }
+    };
+
+    Task tasks[PLCRUNTIME_SCHEDULER_MAX_TASKS];
+    ReadyQueue queues[PLCRUNTIME_SCHEDULER_MAX_WORKERS];
+    std::thread threads[PLCRUNTIME_SCHEDULER_MAX_WORKERS];
+    std::atomic<u32> task_count;
+    std::atomic<bool> running;
+    u32 worker_count = 0;
+    std::chrono::steady_clock::time_point epoch;
+
+    u64 nowUs() const {
+        return (u64) std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    // Queue every task whose release time has come, returns the earliest upcoming release
+    u64 release(u64 now) {
+        u64 next = now + 1000; // Re-check at least every millisecond
+        const u32 count = task_count.load(std::memory_order_acquire);
+        for (u32 i = 0; i < count; i++) {
+            Task& task = tasks[i];
+            u8 state = task.state.load(std::memory_order_acquire);
+            if (state != TASK_IDLE) continue;
+            u64 due = task.next_release_us.load(std::memory_order_relaxed);
+            if (due > now) {
+                if (due < next) next = due;
+                continue;
+            }
+            u8 expected = TASK_IDLE;
+            if (!task.state.compare_exchange_strong(expected, TASK_QUEUED, std::memory_order_acq_rel)) continue;
+            due = task.next_release_us.load(std::memory_order_relaxed);
+            task.release_us = due;
+            due += task.period_us;
+            if (due <= now) {
+                // Fell behind by a whole period or more: drop the missed releases instead of bursting
+                u64 missed = (now - due) / task.period_us + 1;
+                task.overruns += (u32) missed;
+                due += missed * task.period_us;
+            }
+            task.next_release_us.store(due, std::memory_order_relaxed);
+            queues[task.home].push((u16) i);
+        }
+        return next;
+    }
+
+    bool take(u32 worker, u16& task) {
+        if (queues[worker].pop(task)) return true;
+        for (u32 i = 1; i < worker_count; i++) {
+            if (queues[(worker + i) % worker_count].steal(task)) return true;
+        }
+        return false;
+    }
+
+    void execute(Task& task) {
+        VovkPLCRuntime& rt = *task.runtime;
+        u64 start = nowUs();
+        u32 delay = (u32) (start - task.release_us);
+        task.last_release_delay_us = delay;
+        if (delay > task.max_release_delay_us) task.max_release_delay_us = delay;
+        rt.clock.update((u32) (start / 1000));
+        task.last_status = rt.run();
+        u64 end = nowUs();
+
+        DeviceHealth& h = task.health;
+        h.last_cycle_time_us = (u32) (end - start);
+        if (h.last_cycle_time_us < h.min_cycle_time_us) h.min_cycle_time_us = h.last_cycle_time_us;
+        if (h.last_cycle_time_us > h.max_cycle_time_us) h.max_cycle_time_us = h.last_cycle_time_us;
+        if (task.cycles > 0) {
+            u32 previous_period = h.last_period_us;
+            h.last_period_us = (u32) (start - task.last_start_us);
+            if (h.last_period_us < h.min_period_us) h.min_period_us = h.last_period_us;
+            if (h.last_period_us > h.max_period_us) h.max_period_us = h.last_period_us;
+            if (task.cycles > 1) {
+                h.last_jitter_us = h.last_period_us > previous_period ? h.last_period_us - previous_period : previous_period - h.last_period_us;
+                if (h.last_jitter_us < h.min_jitter_us) h.min_jitter_us = h.last_jitter_us;
+                if (h.last_jitter_us > h.max_jitter_us) h.max_jitter_us = h.last_jitter_us;
+            }
+        }
+        task.last_start_us = start;
+        task.cycles++;
+    }
+
+    void worker(u32 index) {
+        while (running.load(std::memory_order_acquire)) {
+            u64 next = release(nowUs());
+            u16 id = 0;
+            if (take(index, id)) {
+                Task& task = tasks[id];
+                task.state.store(TASK_RUNNING, std::memory_order_relaxed);
+                execute(task);
+                task.state.store(TASK_IDLE, std::memory_order_release);
+                continue;
+            }
+            u64 now = nowUs();
+            if (next > now) std::this_thread::sleep_for(std::chrono::microseconds(next - now));
+        }
+    }
+
+public:
+    PLCScheduler() : task_count(0), running(false), epoch(std::chrono::steady_clock::now()) {}
+    ~PLCScheduler() { stop(); }
+
+    // Register a runtime with its scan period, returns the task index or -1 when the table is full.
+    // Tasks can be added while the scheduler is running; the runtime must outlive the scheduler.
+    int add(VovkPLCRuntime& runtime, u32 period_us) {
+        u32 index = task_count.load(std::memory_order_relaxed);
+        if (index >= PLCRUNTIME_SCHEDULER_MAX_TASKS || period_us == 0) return -1;
+        Task& task = tasks[index];
+        task.runtime = &runtime;
+        task.period_us = period_us;
+        task.home = (u16) (worker_count ? index % worker_count : 0);
+        task.next_release_us.store(nowUs(), std::memory_order_relaxed);
+        task.cycles = 0;
+        task.overruns = 0;
+        task.last_status = STATUS_SUCCESS;
+        task.resetHealth();
+        runtime.clock.external = true;
+        task.state.store(TASK_IDLE, std::memory_order_relaxed);
+        task_count.store(index + 1, std::memory_order_release);
+        return (int) index;
+    }
+
+    // Start the worker threads (0 = one per hardware thread)
+    bool start(u32 workers = 0) {
+        if (running.load()) return false;
+        if (workers == 0) workers = std::thread::hardware_concurrency();
+        if (workers == 0) workers = 1;
+        if (workers > PLCRUNTIME_SCHEDULER_MAX_WORKERS) workers = PLCRUNTIME_SCHEDULER_MAX_WORKERS;
+        worker_count = workers;
+        const u32 count = task_count.load();
+        const u64 now = nowUs();
+        for (u32 i = 0; i < count; i++) {
+            tasks[i].home = (u16) (i % workers);
+            tasks[i].next_release_us.store(now, std::memory_order_relaxed);
+        }
+        running.store(true);
+        for (u32 i = 0; i < workers; i++) threads[i] = std::thread(&PLCScheduler::worker, this, i);
+        return true;
+    }
+
+    // Stop the workers after their current cycle and wait for them to exit
+    void stop() {
+        if (!running.exchange(false)) return;
+        for (u32 i = 0; i < worker_count; i++) {
+            if (threads[i].joinable()) threads[i].join();
+        }
+        // Drop releases that were queued but not executed
+        for (u32 i = 0; i < worker_count; i++) {
+            u16 id = 0;
+            while (queues[i].pop(id)) tasks[id].state.store(TASK_IDLE);
+        }
+    }
+
+    bool isRunning() const { return running.load(); }
+    u32 taskCount() const { return task_count.load(); }
+    u32 workerCount() const { return worker_count; }
+
+    // Scheduler view of a task. Statistics are updated by the workers without locking, so read them as a snapshot.
+    const Task* getTask(u32 index) const { return index < task_count.load() ? &tasks[index] : nullptr; }
+
+    // Device health of a task: cycle, period and jitter measured by the scheduler, RAM statistics from the runtime
+    bool getDeviceHealth(u32 index, DeviceHealth& health) {
+        if (index >= task_count.load()) return false;
+        Task& task = tasks[index];
+        task.runtime->getDeviceHealth(health);
+        health.last_cycle_time_us = task.health.last_cycle_time_us;
+        health.min_cycle_time_us = task.health.min_cycle_time_us;
+        health.max_cycle_time_us = task.health.max_cycle_time_us;
+        health.last_period_us = task.health.last_period_us;
+        health.min_period_us = task.health.min_period_us;
+        health.max_period_us = task.health.max_period_us;
+        health.last_jitter_us = task.health.last_jitter_us;
+        health.min_jitter_us = task.health.min_jitter_us;
+        health.max_jitter_us = task.health.max_jitter_us;
+        return true;
+    }
+
+    void resetDeviceHealth(u32 index) {
+        if (index >= task_count.load()) return;
+        tasks[index].resetHealth();
+        tasks[index].runtime->resetDeviceHealth();
+    }
+};
+
+#endif // PLCRUNTIME_SCHEDULER_ENABLED
@@ -44,10 +44,10 @@ void print__i64(i64 big_number) {
         Serial.print('-');
         big_number = -big_number;
     }
-    print__u64(big_number);
+    print__u64((u64) big_number);
 }
 void println__i64(i64 big_number) {
-    print__u64(big_number);
+    print__i64(big_number);
     Serial.println();
 }
 #endif // USE_X64_OPS
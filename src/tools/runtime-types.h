@@ -32,6 +32,7 @@
 //   #define PLCRUNTIME_NO_COUNTERS      // Disable counter operations (~1KB savings)
 //   #define PLCRUNTIME_NO_TIMERS        // Disable timer operations (~2KB savings)
 //   #define PLCRUNTIME_NO_FFI           // Disable FFI function calls (~1KB savings)
+//   #define PLCRUNTIME_NO_FFI_ASYNC     // Disable async FFI jobs (FFI_START / FFI_POLL)
 //   #define PLCRUNTIME_NO_X64_OPS       // Disable 64-bit operations (~2KB savings)
 //   #define PLCRUNTIME_NO_FLOAT_OPS     // Disable float (f32) operations (~3KB savings)
 //   #define PLCRUNTIME_NO_TRANSPORT     // Disable transport system
@@ -163,6 +164,11 @@
     #define PLCRUNTIME_FFI_ENABLED
 #endif
 
+// Long-running FFI functions started with FFI_START and polled with FFI_POLL
+#if defined(PLCRUNTIME_FFI_ENABLED) && !defined(PLCRUNTIME_NO_FFI_ASYNC)
+    #define PLCRUNTIME_FFI_ASYNC_ENABLED
+#endif
+
 #ifndef PLCRUNTIME_NO_FLOAT_OPS
     #define PLCRUNTIME_FLOAT_OPS_ENABLED
 #endif
@@ -314,6 +320,171 @@
   #endif
 #endif
 
+// ============================================================================
+// Pre-decoded Bytecode Cache
+// ============================================================================
+// When a program is loaded, every instruction is decoded once into a compact
+// record holding a type-specialized handler pointer and its unpacked operands
+// (addresses, bit indexes, constants, jump targets resolved to record indexes).
+// run() then executes one indirect call per instruction without re-parsing
+// the bytecode. The wire format is unchanged - the cache lives only in RAM.
+//
+// Costs roughly 14 bytes of heap per byte of the largest program loaded so far
+// (24 per record, at most one record per two bytes, plus 2 per byte for the
+// offset map), so it is only auto-enabled on hosts.
+//
+// Auto-enabled for: WASM, x86/x64, AArch64
+// Override: #define PLCRUNTIME_NO_PREDECODE    to always interpret the raw bytecode
+//           #define PLCRUNTIME_FORCE_PREDECODE to enable on other targets
+// ============================================================================
+#if defined(PLCRUNTIME_FORCE_PREDECODE)
+  #define PLCRUNTIME_PREDECODE_ENABLED
+#elif !defined(PLCRUNTIME_NO_PREDECODE)
+  #if defined(__WASM__) || defined(__wasm__) || defined(__x86_64__) || defined(__i386__) || defined(__aarch64__)
+    #define PLCRUNTIME_PREDECODE_ENABLED
+  #endif
+#endif
+
+// ============================================================================
+// Load-time bytecode verifier
+// ============================================================================
+// Proves once per load that a program only jumps to instruction starts, only
+// addresses memory inside PLCRUNTIME_MAX_MEMORY_SIZE and keeps a consistent,
+// bounded stack depth on every path. A verified program runs through the
+// pre-decoded handlers without their stack overflow and underflow checks.
+// Programs the verifier can not prove keep the checked handlers.
+//
+// Costs roughly 3 bytes of heap per program byte on top of the pre-decoded cache.
+//
+// Auto-enabled with the pre-decoded cache
+// Override: #define PLCRUNTIME_NO_VERIFIER  to always run the checked handlers
+// Limits:   PLCRUNTIME_VERIFY_MAX_FUNCTIONS (default 32) subroutines per program
+// ============================================================================
+#if defined(PLCRUNTIME_PREDECODE_ENABLED) && !defined(PLCRUNTIME_NO_VERIFIER)
+  #define PLCRUNTIME_VERIFIER_ENABLED
+#endif
+
+// ============================================================================
+// Native JIT for soft-PLC hosts
+// ============================================================================
+// Compiles the pre-decoded program into native x86-64 code when it is loaded.
+// Every record becomes a direct call to its specialized handler, followed by a
+// status check and native jumps for resolved control flow, so the dispatch loop
+// and its indirect branch disappear. Instructions without a specialized handler
+// (COMMS, FFI_CALL, strings, ...) still run through step().
+//
+// Requires the pre-decoded cache and an x86-64 Linux or macOS host.
+// Opt-in:   #define PLCRUNTIME_JIT  to enable on supported hosts
+// ============================================================================
+#if defined(PLCRUNTIME_JIT) && defined(PLCRUNTIME_PREDECODE_ENABLED)
+  #if defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+    #define PLCRUNTIME_JIT_ENABLED
+  #endif
+#endif
+
+// ============================================================================
+// Ahead-of-time compiled programs
+// ============================================================================
+// `npm run aot` translates a compiled program into C++ that is built into the
+// firmware (see runtime-aot.h). run() calls the native function instead of
+// interpreting while the loaded program is the one it was generated from.
+// Memory, stack and monitoring stay the same, a newly downloaded program falls
+// back to the interpreter.
+//
+// Costs a few bytes of RAM and one comparison per scan cycle.
+// Override: #define PLCRUNTIME_NO_AOT  to always interpret
+// ============================================================================
+#ifndef PLCRUNTIME_NO_AOT
+  #define PLCRUNTIME_AOT_ENABLED
+#endif
+
+// ============================================================================
+// Multi-PLC scheduler for soft-PLC hosts
+// ============================================================================
+// Runs the scan cycles of many VovkPLCRuntime instances on a pool of worker
+// threads, each at its own period, with work-stealing between the workers.
+// Uses the C++11 thread library, so it is only available on hosted builds.
+//
+// Opt-in:   #define PLCRUNTIME_SCHEDULER
+// Limits:   PLCRUNTIME_SCHEDULER_MAX_TASKS (default 256), PLCRUNTIME_SCHEDULER_MAX_WORKERS (default 64)
+// ============================================================================
+#if defined(PLCRUNTIME_SCHEDULER) && !defined(__WASM__) && !defined(__wasm__) && !defined(__EMSCRIPTEN__)
+  #define PLCRUNTIME_SCHEDULER_ENABLED
+#endif
+
+// ============================================================================
+// Lockstep ensemble execution
+// ============================================================================
+// Runs one verified program over many caller-owned memory images at once,
+// stored structure-of-arrays so each instruction is a loop over all lanes
+// (see runtime-ensemble.h). For test-vector sweeps on hosted builds.
+// Cost: an execution plan of 20 bytes per pre-decoded instruction
+//
+// Opt-in:   #define PLCRUNTIME_ENSEMBLE (needs the load-time verifier)
+// ============================================================================
+#if defined(PLCRUNTIME_ENSEMBLE) && defined(PLCRUNTIME_VERIFIER_ENABLED)
+  #define PLCRUNTIME_ENSEMBLE_ENABLED
+#endif
+
+// ============================================================================
+// Async FFI worker threads for soft-PLC hosts
+// ============================================================================
+// Runs long-running FFI functions (FFI_START) on a small pool of worker
+// threads instead of runtime.serviceFFI() calls between scans. Results still
+// reach PLC memory only at the start of a scan cycle.
+// Uses the C++11 thread library, so it is only available on hosted builds.
+//
+// Opt-in:   #define PLCRUNTIME_FFI_ASYNC_THREAD
+// Limits:   PLCRUNTIME_FFI_ASYNC_WORKERS (default 2), PLCRUNTIME_FFI_ASYNC_MAX_JOBS (default 8, 2 on AVR)
+// ============================================================================
+#if defined(PLCRUNTIME_FFI_ASYNC_THREAD) && defined(PLCRUNTIME_FFI_ASYNC_ENABLED) && !defined(__WASM__) && !defined(__wasm__) && !defined(__EMSCRIPTEN__)
+  #define PLCRUNTIME_FFI_ASYNC_THREAD_ENABLED
+#endif
+
+// ============================================================================
+// Double-buffered process image
+// ============================================================================
+// The input and output areas are exchanged with I/O threads and interrupts
+// through lock-free image buffers instead of direct access to memory[].
+// setInput*() / getOutput*() work on the images, run() takes the newest input
+// image at the start of the cycle and publishes the output image at the end.
+// One I/O writer and one I/O reader are supported (e.g. a fieldbus thread).
+//
+// Opt-in:   #define PLCRUNTIME_PROCESS_IMAGE
+// ============================================================================
+#ifdef PLCRUNTIME_PROCESS_IMAGE
+  #define PLCRUNTIME_PROCESS_IMAGE_ENABLED
+#endif
+
+// ============================================================================
+// Binary framed programming protocol
+// ============================================================================
+// Length-prefixed binary frames with CRC-32 next to the hex serial protocol,
+// for program download and monitoring over slow links (RS-485, radio).
+// Served by listen() on Serial and on the active PLCRUNTIME_TRANSPORT port.
+//
+// Opt-in:   #define PLCRUNTIME_BINARY_PROTOCOL
+// Limits:   PLCRUNTIME_BINARY_MAX_PAYLOAD (default 512, 64 on AVR), PLCRUNTIME_BINARY_FRAME_TIMEOUT_MS (default 200)
+// ============================================================================
+#if defined(PLCRUNTIME_BINARY_PROTOCOL) && !defined(__WASM__)
+  #define PLCRUNTIME_BINARY_PROTOCOL_ENABLED
+#endif
+
+// ============================================================================
+// Online program change
+// ============================================================================
+// Program downloads are staged in a shadow buffer, checked (checksum and
+// instruction structure) and swapped in by run() at the next scan boundary.
+// PLC memory is kept, DataBlocks of the new program are declared or resized.
+// See runtime-online-change.h.
+//
+// Costs PLCRUNTIME_MAX_PROGRAM_SIZE * 9 / 8 bytes of RAM for the shadow buffer.
+// Opt-in:   #define PLCRUNTIME_ONLINE_CHANGE
+// ============================================================================
+#ifdef PLCRUNTIME_ONLINE_CHANGE
+  #define PLCRUNTIME_ONLINE_CHANGE_ENABLED
+#endif
+
 // ============================================================================
 // Endianness detection - detect at compile time
 // ============================================================================
@@ -0,0 +1,434 @@
+// runtime-verifier.h - 2026-10-17
+//
+// Copyright (c) 2026 J.Vovk
+//
+// This file is part of VovkPLCRuntime.
+//
+// VovkPLCRuntime is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// VovkPLCRuntime is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with VovkPLCRuntime.  If not, see <https://www.gnu.org/licenses/>.
+//
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+#pragma once
+
+#include "runtime-tools.h"
+#include "runtime-instructions.h"
+#include "runtime-predecode.h"
+#include "assembly/wcet-costs.h"
+
+// ============================================================================
+// Load-time bytecode verification
+// ============================================================================
+// Proves static properties of a program once, when it is loaded:
+//  - structure: every instruction decodes inside the program and every jump
+//    and call lands on an instruction start
+//  - memory: immediate address operands (LOAD_FROM, MOVE_TO, bit access, edge
+//    detection, fused compares, ...) lie inside PLCRUNTIME_MAX_MEMORY_SIZE
+//  - stack: the stack depth before every instruction is the same on every path
+//    reaching it, never below what the instruction consumes and never above
+//    PLCRUNTIME_MAX_STACK_SIZE. Stack effects come from wcet_stack_effect().
+//    Subroutines are summarized once (bytes taken from the caller, net effect
+//    and peak depth) and applied at every call site.
+//
+// A verified program runs through the pre-decoded handlers without their stack
+// overflow and underflow checks (see runtime-predecode-impl.h). Anything the
+// verifier cannot prove - an opcode with a data dependent stack effect (PICK,
+// strings, FFI_CALL_STACK, ...), depths that differ between paths, recursion -
+// fails verification and the program keeps the fully checked path.
+// ============================================================================
+
+// Size of a value type on the stack, 0 for types the verifier does not track
+inline u8 plc_verify_type_size(u8 type) {
+    switch (type) {
+        case type_bool: case type_u8: case type_i8: return 1;
+        case type_u16: case type_i16: return 2;
+        case type_u32: case type_i32: case type_f32: return 4;
+        case type_u64: case type_i64: case type_f64: return 8;
+        default: return 0;
+    }
+}
+
+// Structural check of a whole program: every instruction must decode to a known
+// size inside the program and every absolute or relative jump and call must land
+// on an instruction start. `starts` needs (prog_size + 7) / 8 bytes of scratch.
+inline RuntimeError plc_check_program_structure(const u8* program, u32 prog_size, u8* starts) {
+    if (prog_size == 0) return EMPTY_PROGRAM;
+    for (u32 i = 0; i < (prog_size + 7) / 8; i++) starts[i] = 0;
+    u32 index = 0;
+    while (index < prog_size) {
+        if (!OPCODE_EXISTS((PLCRuntimeInstructionSet) program[index])) return UNKNOWN_INSTRUCTION;
+        u32 size = INSTRUCTION_SIZE(program, prog_size, index);
+        if (size == 0 || size > prog_size - index) return PROGRAM_SIZE_EXCEEDED;
+        starts[index >> 3] |= (u8) (1 << (index & 7));
+        index += size;
+    }
+    index = 0;
+    while (index < prog_size) {
+        u8 opcode = program[index];
+        u32 size = INSTRUCTION_SIZE(program, prog_size, index);
+        bool jumps = true;
+        i32 target = 0;
+        if (opcode >= JMP && opcode <= CALL_IF_NOT) target = (i32) read_u16(program + index + 1);
+        else if (opcode >= JMP_REL && opcode <= CALL_IF_NOT_REL) target = (i32) (index + 3) + read_i16(program + index + 1);
+        else if (opcode == LOAD_CMP_IMM_JMP_IF_NOT) target = (i32) read_u16(program + index + size - 2);
+        else jumps = false;
+        // CALL_IF/CALL_IF_NOT use address 0 as "no target", step() reports it when taken
+        if (jumps && target == 0 && (opcode == CALL_IF || opcode == CALL_IF_NOT)) jumps = false;
+        if (jumps && (target < 0 || (u32) target >= prog_size || !(starts[target >> 3] & (1 << (target & 7))))) return PROGRAM_POINTER_OUT_OF_BOUNDS;
+        index += size;
+    }
+    return STATUS_SUCCESS;
+}
+
+// Check the immediate memory operands of the instruction at `index`.
+// Instructions without immediate addresses pass.
+inline bool plc_check_memory_operands(const u8* program, u32 index) {
+    const u8 opcode = program[index];
+    const u8* p = program + index + 1;
+    if (opcode >= READ_X8_B0 && opcode <= WRITE_INV_X8_B7) return (u32) read_ptr(p) + 1 <= PLCRUNTIME_MAX_MEMORY_SIZE;
+    switch (opcode) {
+        case LOAD_FROM:
+        case MOVE_TO:
+        case INC_MEM:
+        case DEC_MEM: {
+            u8 width = plc_verify_type_size(p[0]);
+            return width && (u32) read_ptr(p + 1) + width <= PLCRUNTIME_MAX_MEMORY_SIZE;
+        }
+        case MEM_FILL: return (u32) read_ptr(p + 1) + read_ptr(p + 1 + MY_PTR_SIZE_BYTES) <= PLCRUNTIME_MAX_MEMORY_SIZE;
+        case LOAD_CMP_IMM:
+        case LOAD_CMP_IMM_JMP_IF_NOT: {
+            u8 width = plc_verify_type_size(p[1]);
+            return width && (u32) read_ptr(p + 2) + width <= PLCRUNTIME_MAX_MEMORY_SIZE;
+        }
+        case READ_AND_X8:
+        case READ_OR_X8: return (u32) read_ptr(p) + 1 <= PLCRUNTIME_MAX_MEMORY_SIZE && p[MY_PTR_SIZE_BYTES] < 8;
+        case READ_AND_WRITE_X8:
+        case READ_BIT_DU: case READ_BIT_DD: case READ_BIT_INV_DU: case READ_BIT_INV_DD:
+        case WRITE_BIT_DU: case WRITE_BIT_DD: case WRITE_BIT_INV_DU: case WRITE_BIT_INV_DD:
+        case WRITE_SET_DU: case WRITE_SET_DD: case WRITE_RSET_DU: case WRITE_RSET_DD: {
+            const u8* second = p + MY_PTR_SIZE_BYTES + 1;
+            return (u32) read_ptr(p) + 1 <= PLCRUNTIME_MAX_MEMORY_SIZE && p[MY_PTR_SIZE_BYTES] < 8
+                && (u32) read_ptr(second) + 1 <= PLCRUNTIME_MAX_MEMORY_SIZE && second[MY_PTR_SIZE_BYTES] < 8;
+        }
+        case BIT_GATHER_X32: case BIT_SCATTER_X32:
+        case BIT_GATHER_X64: case BIT_SCATTER_X64: {
+            const u8 count = p[0];
+            const u8 max_count = opcode == BIT_GATHER_X32 || opcode == BIT_SCATTER_X32 ? 32 : 64;
+            if (count == 0 || count > max_count) return false;
+            for (const u8* entry = p + 1; entry < p + 1 + (u32) count * (MY_PTR_SIZE_BYTES + 1); entry += MY_PTR_SIZE_BYTES + 1) {
+                if ((u32) read_ptr(entry) + 1 > PLCRUNTIME_MAX_MEMORY_SIZE || entry[MY_PTR_SIZE_BYTES] > 7) return false;
+            }
+            return true;
+        }
+        default: return true;
+    }
+}
+
+// Exact stack effect of the instruction at `index`: bytes it needs on the stack and
+// the net change. Returns false when the effect depends on runtime data or is unknown.
+// Control flow and CLEAR are handled by the verifier itself.
+inline bool plc_verify_stack_effect(const u8* program, u32 index, u16& need, i16& net) {
+    const u8 opcode = program[index];
+    OpcodeStackEffect effect;
+    switch (opcode) {
+        case CVT: {
+            u8 from = plc_verify_type_size(program[index + 1]);
+            u8 to = plc_verify_type_size(program[index + 2]);
+            if (!from || !to) return false;
+            need = from;
+            net = (i16) to - (i16) from;
+            return true;
+        }
+        case COPY: {
+            u8 size = plc_verify_type_size(program[index + 1]);
+            need = size;
+            net = size;
+            return size != 0;
+        }
+        case SWAP: {
+            u8 a = plc_verify_type_size(program[index + 1]);
+            u8 b = plc_verify_type_size(program[index + 2]);
+            need = a + b;
+            net = 0;
+            return a && b;
+        }
+
+        // Typed instructions, the type byte follows the opcode
+        case DROP: case LOAD: case MOVE: case MOVE_COPY: case LOAD_FROM: case MOVE_TO:
+        case ADD: case SUB: case MUL: case DIV: case MOD: case POW:
+        case SQRT: case NEG: case ABS: case SIN: case COS:
+        case CMP_EQ: case CMP_NEQ: case CMP_GT: case CMP_GTE: case CMP_LT: case CMP_LTE:
+            if (!plc_verify_type_size(program[index + 1])) return false;
+            effect = wcet_stack_effect(opcode, program[index + 1]);
+            break;
+
+        case type_bool: case type_u8: case type_i8: case type_u16: case type_i16:
+        case type_u32: case type_i32: case type_f32: case type_u64: case type_i64: case type_f64:
+        case NOP: case LANG: case COMMENT: case CONFIG_DB: case CONFIG_TC:
+        case INC_MEM: case DEC_MEM: case MEM_FILL:
+        case LOGIC_AND: case LOGIC_OR: case LOGIC_XOR: case LOGIC_NOT:
+        case TON_CONST: case TON_MEM: case TOF_CONST: case TOF_MEM: case TP_CONST: case TP_MEM:
+        case CTU_CONST: case CTU_MEM: case CTD_CONST: case CTD_MEM:
+        case READ_BIT_DU: case READ_BIT_DD: case READ_BIT_INV_DU: case READ_BIT_INV_DD:
+        case WRITE_BIT_DU: case WRITE_BIT_DD: case WRITE_BIT_INV_DU: case WRITE_BIT_INV_DD:
+        case WRITE_SET_DU: case WRITE_SET_DD: case WRITE_RSET_DU: case WRITE_RSET_DD:
+        case STACK_DU: case STACK_DD: case STACK_DC:
+        case BR_SAVE: case BR_READ: case BR_DROP: case BR_CLR: case BR_SAVE_READ:
+        case READ_AND_X8: case READ_OR_X8: case READ_AND_WRITE_X8: case LOAD_CMP_IMM:
+        case BIT_GATHER_X32: case BIT_GATHER_X64: case BIT_SCATTER_X32: case BIT_SCATTER_X64:
+        case FFI_CALL: case FFI_CALL_BATCH: case FFI_START: case FFI_POLL:
+            effect = wcet_stack_effect(opcode);
+            break;
+
+        default:
+            if (opcode >= GET_X8_B0 && opcode <= WRITE_INV_X8_B7) effect = wcet_stack_effect(opcode); // Bit access
+            else if (opcode >= BW_AND_X8 && opcode <= BW_RSHIFT_X64) effect = wcet_stack_effect(opcode); // Bitwise
+            else return false;
+            break;
+    }
+    need = (u16) effect.pop_bytes;
+    net = (i16) effect.push_bytes - (i16) effect.pop_bytes;
+    return true;
+}
+
+#ifdef PLCRUNTIME_VERIFIER_ENABLED
+
+#ifndef PLCRUNTIME_VERIFY_MAX_FUNCTIONS
+#define PLCRUNTIME_VERIFY_MAX_FUNCTIONS 32 // Program entry plus distinct CALL targets
+#endif // PLCRUNTIME_VERIFY_MAX_FUNCTIONS
+
+#define PLC_VERIFY_UNSET -32768 // depth[] marker for records not reached yet
+
+// Stack depth proof over the pre-decoded records of a program.
+// Scratch space is kept here and grows with the decoded tables, so verifying a program no larger than the last one does not allocate.
+struct PLCVerifier {
+    i16* depth = nullptr;   // Stack depth before each record, relative to the function entry
+    u16* work = nullptr;    // Records whose successors still need a visit
+    u8* starts = nullptr;   // Instruction start bitmap
+    u32 capacity = 0;       // Program bytes the scratch space is allocated for
+
+    // Returns false when the memory can not be allocated
+    bool reserve(u32 size) {
+        if (size <= capacity) return true;
+        size = plc_decoded_capacity(size, capacity);
+        release();
+        depth = plc_decoded_alloc<i16>(PLCDecodedProgram::maxOps(size));
+        work = plc_decoded_alloc<u16>(PLCDecodedProgram::maxOps(size));
+        starts = plc_decoded_alloc<u8>((size + 7) / 8);
+        if (!depth || !work || !starts) {
+            release();
+            return false;
+        }
+        capacity = size;
+        return true;
+    }
+
+    void release() {
+        plc_decoded_free(depth);
+        plc_decoded_free(work);
+        plc_decoded_free(starts);
+        depth = nullptr;
+        work = nullptr;
+        starts = nullptr;
+        capacity = 0;
+    }
+
+    PLCVerifier() {}
+    PLCVerifier(const PLCVerifier&) = delete;
+    PLCVerifier& operator=(const PLCVerifier&) = delete;
+    ~PLCVerifier() { release(); }
+
+    enum FunctionState { FN_PENDING = 0, FN_DONE, FN_FAILED };
+    struct Function {
+        u16 entry;    // Entry record
+        u16 need;     // Bytes taken from below the entry depth (arguments)
+        u16 peak;     // Highest depth reached inside, callees included
+        i16 net;      // Depth at RET minus depth at entry
+        u8 state;
+        bool returns; // Has a reachable RET
+    };
+    Function functions[PLCRUNTIME_VERIFY_MAX_FUNCTIONS];
+    u8 function_count = 0;
+
+    // Returns true if the whole program is proven, `max_stack` receives the peak stack depth
+    bool verify(const PLCDecodedProgram& d, const u8* program, u16& max_stack) {
+        max_stack = 0;
+        if (d.count == 0 || d.end_offset != d.prog_size) return false; // Not fully decoded
+        if (!reserve(d.capacity)) return false;
+        if (plc_check_program_structure(program, d.prog_size, starts) != STATUS_SUCCESS) return false;
+
+        // Functions: the program entry and every call target
+        function_count = 0;
+        addFunction(0);
+        for (u32 r = 0; r < d.count; r++) {
+            u32 offset = d.ops[r].offset;
+            if (!plc_check_memory_operands(program, offset)) return false;
+            u32 target = 0;
+            if (callTarget(d, program, offset, target) && !addFunction(target)) return false;
+        }
+
+        // Each round summarizes the functions whose callees are all summarized,
+        // so call chains resolve bottom up; recursion never does and fails
+        for (u8 round = 0; round <= function_count; round++) {
+            bool progress = false;
+            for (u8 f = 0; f < function_count; f++) {
+                if (functions[f].state != FN_PENDING) continue;
+                functions[f].state = analyze(d, program, functions[f]);
+                if (functions[f].state != FN_PENDING) progress = true;
+            }
+            if (functions[0].state != FN_PENDING || !progress) break;
+        }
+        if (functions[0].state != FN_DONE || functions[0].need > 0) return false;
+        max_stack = functions[0].peak;
+        return true;
+    }
+
+    // Refill depth[] for the program entry after a successful verify(). Records only
+    // reached through calls stay PLC_VERIFY_UNSET, depths are absolute (entry starts empty)
+    bool entryDepths(const PLCDecodedProgram& d, const u8* program) {
+        if (function_count == 0 || functions[0].state != FN_DONE) return false;
+        return analyze(d, program, functions[0]) == FN_DONE;
+    }
+
+    bool addFunction(u32 entry) {
+        for (u8 f = 0; f < function_count; f++) if (functions[f].entry == entry) return true;
+        if (function_count >= PLCRUNTIME_VERIFY_MAX_FUNCTIONS) return false;
+        Function& fn = functions[function_count++];
+        fn.entry = (u16) entry;
+        fn.need = 0;
+        fn.peak = 0;
+        fn.net = 0;
+        fn.state = FN_PENDING;
+        fn.returns = false;
+        return true;
+    }
+
+    i16 findFunction(u32 entry) const {
+        for (u8 f = 0; f < function_count; f++) if (functions[f].entry == entry) return f;
+        return -1;
+    }
+
+    // Jump or call target of the instruction at `offset` as a record index
+    static bool target(const PLCDecodedProgram& d, const u8* program, u32 offset, u32& record) {
+        u8 opcode = program[offset];
+        u32 size = INSTRUCTION_SIZE(program, d.prog_size, offset);
+        i32 at = 0;
+        if (opcode >= JMP && opcode <= CALL_IF_NOT) at = (i32) read_u16(program + offset + 1);
+        else if (opcode >= JMP_REL && opcode <= CALL_IF_NOT_REL) at = (i32) (offset + 3) + read_i16(program + offset + 1);
+        else if (opcode == LOAD_CMP_IMM_JMP_IF_NOT) at = (i32) read_u16(program + offset + size - 2);
+        else return false;
+        if (at < 0 || (u32) at >= d.prog_size || d.op_at[at] == PLC_DECODED_NONE) return false;
+        record = d.op_at[at];
+        return true;
+    }
+
+    static bool callTarget(const PLCDecodedProgram& d, const u8* program, u32 offset, u32& record) {
+        u8 opcode = program[offset];
+        bool call = (opcode >= CALL && opcode <= CALL_IF_NOT) || (opcode >= CALL_REL && opcode <= CALL_IF_NOT_REL);
+        return call && target(d, program, offset, record);
+    }
+
+    // Set the depth of a successor, false if another path reaches it with a different depth
+    bool reach(const PLCDecodedProgram& d, u32 record, i32 value, u32& pending) {
+        if (record >= d.count) return true; // Falling off the end finishes the cycle
+        if (value < -PLCRUNTIME_MAX_STACK_SIZE || value > PLCRUNTIME_MAX_STACK_SIZE) return false;
+        if (depth[record] == PLC_VERIFY_UNSET) {
+            depth[record] = (i16) value;
+            work[pending++] = (u16) record;
+            return true;
+        }
+        return depth[record] == value;
+    }
+
+    u8 analyze(const PLCDecodedProgram& d, const u8* program, Function& fn) {
+        for (u32 r = 0; r < d.count; r++) depth[r] = PLC_VERIFY_UNSET;
+        u32 pending = 0;
+        bool returns = false;
+        i32 ret_depth = 0;
+        i32 low = 0; // Lowest depth any instruction needs, negative when it reads arguments
+        i32 peak = 0;
+        const bool entry = &fn == &functions[0];
+        reach(d, fn.entry, 0, pending);
+        while (pending > 0) {
+            const u32 r = work[--pending];
+            const u32 offset = d.ops[r].offset;
+            const u8 opcode = program[offset];
+            const i32 in = depth[r];
+            if (in > peak) peak = in;
+            bool conditional = opcode == JMP_IF || opcode == JMP_IF_NOT || opcode == JMP_IF_REL || opcode == JMP_IF_NOT_REL ||
+                opcode == CALL_IF || opcode == CALL_IF_NOT || opcode == CALL_IF_REL || opcode == CALL_IF_NOT_REL ||
+                opcode == RET_IF || opcode == RET_IF_NOT;
+            const i32 out = conditional ? in - 1 : in; // Conditions pop their bool first
+            if (out < low) low = out;
+            u32 next = 0;
+
+            switch (opcode) {
+                case EXIT: break;
+                case RET:
+                case RET_IF:
+                case RET_IF_NOT:
+                    if (returns && ret_depth != out) return FN_FAILED;
+                    returns = true;
+                    ret_depth = out;
+                    if (opcode != RET && !reach(d, r + 1, out, pending)) return FN_FAILED;
+                    break;
+                case JMP:
+                case JMP_REL:
+                    if (!target(d, program, offset, next) || !reach(d, next, out, pending)) return FN_FAILED;
+                    break;
+                case JMP_IF: case JMP_IF_NOT: case JMP_IF_REL: case JMP_IF_NOT_REL:
+                case LOAD_CMP_IMM_JMP_IF_NOT:
+                    if (!target(d, program, offset, next) || !reach(d, next, out, pending) || !reach(d, r + 1, out, pending)) return FN_FAILED;
+                    break;
+                case CALL: case CALL_IF: case CALL_IF_NOT:
+                case CALL_REL: case CALL_IF_REL: case CALL_IF_NOT_REL: {
+                    // CALL_IF/CALL_IF_NOT with address 0 stop with an error when taken, only the fall-through continues
+                    if (!callTarget(d, program, offset, next)) {
+                        if (!conditional || !reach(d, r + 1, out, pending)) return FN_FAILED;
+                        break;
+                    }
+                    i16 f = findFunction(next);
+                    if (f < 0 || functions[f].state == FN_FAILED) return FN_FAILED;
+                    if (functions[f].state == FN_PENDING) return FN_PENDING; // Callee not summarized yet
+                    const Function& callee = functions[f];
+                    if (out - callee.need < low) low = out - callee.need;
+                    if (out + callee.peak > peak) peak = out + callee.peak;
+                    if (callee.returns && !reach(d, r + 1, out + callee.net, pending)) return FN_FAILED;
+                    if (conditional && !reach(d, r + 1, out, pending)) return FN_FAILED; // Not taken
+                    break;
+                }
+                case CLEAR:
+                    // Depth 0 is only known relative to the program entry
+                    if (!entry || !reach(d, r + 1, 0, pending)) return FN_FAILED;
+                    break;
+                default: {
+                    u16 need = 0;
+                    i16 net = 0;
+                    if (!plc_verify_stack_effect(program, offset, need, net)) return FN_FAILED;
+                    if (in - need < low) low = in - need;
+                    if (in + net > peak) peak = in + net;
+                    if (!reach(d, r + 1, in + net, pending)) return FN_FAILED;
+                    break;
+                }
+            }
+        }
+        if (peak - low > PLCRUNTIME_MAX_STACK_SIZE) return FN_FAILED;
+        fn.need = (u16) -low;
+        fn.peak = (u16) peak;
+        fn.returns = returns;
+        fn.net = (i16) ret_depth;
+        return FN_DONE;
+    }
+};
+
+#endif // PLCRUNTIME_VERIFIER_ENABLED
@@ -399,6 +399,12 @@ static const FSH* comms_subfn_name(u8 sub_fn) {
 //
 // Priority can be changed at runtime via comms_set_priority instruction.
 // Mixing is supported: set SYNC for critical reads, ASYNC for background polling.
+//
+// Modbus RTU instances queue ASYNC requests in the driver itself (ModbusRTU::
+// submit). mb_read_* / mb_write_* push MODBUS_PENDING and return immediately,
+// an identical request that is still pending is not queued twice. Each
+// comms_poll_async advances the bus state machine without waiting on the wire,
+// completed requests update comms_status.
 // ============================================================================
 
 #define COMMS_PRIORITY_SYNC  0  // Blocking: execute immediately
@@ -76,6 +76,29 @@
 //        delay(100);
 //    }
 //
+// 3. Modbus RTU Master without blocking the loop:
+//    --------------------------------------------
+//    ModbusRTU modbus(Serial1, 9600, 2);
+//    uint16_t regs[4];
+//    ModbusResult status = MODBUS_OK;
+//
+//    void loop() {
+//        if (status != MODBUS_PENDING) {
+//            // regs[0..3] are valid here when status == MODBUS_OK
+//            ModbusRequest req;
+//            req.slave = 1; req.fc = MODBUS_FC_READ_HOLDING_REGISTERS;
+//            req.start = 0; req.quantity = 4;
+//            req.data = (uint8_t*) regs; req.result = &status;
+//            modbus.submit(req);
+//        }
+//        modbus.poll();  // Drives the bus, never waits for the wire
+//    }
+//
+// All bus timing (t3.5 gaps, transmit drain, response timeout, end of frame)
+// is tracked with micros()/millis() by the state machine in poll(). The
+// blocking master functions (readHoldingRegisters, ...) are thin wrappers
+// that submit a request and call poll() until it completes.
+//
 
 #pragma once
 
@@ -99,6 +122,10 @@
 #define MODBUS_RTU_DEFAULT_TIMEOUT_MS 1000
 #endif
 
+#ifndef MODBUS_RTU_QUEUE_DEPTH
+#define MODBUS_RTU_QUEUE_DEPTH 4  // Pending master requests per instance
+#endif
+
 #ifndef MODBUS_RTU_MAX_COILS
 #define MODBUS_RTU_MAX_COILS 128
 #endif
@@ -157,6 +184,45 @@ enum ModbusResult : uint8_t {
     MODBUS_ERR_SLAVE_ADDR               = 0x05,
     MODBUS_ERR_BUFFER_OVERFLOW          = 0x06,
     MODBUS_ERR_INVALID_PARAMS           = 0x07,
+    MODBUS_ERR_QUEUE_FULL               = 0x08,
+    MODBUS_PENDING                      = 0x09,  // Request queued or on the wire
+};
+
+// ============================================================================
+// Bus State (non-blocking engine)
+// ============================================================================
+
+enum ModbusState : uint8_t {
+    MODBUS_STATE_IDLE                   = 0x00,  // Listening (slave) or ready to send (master)
+    MODBUS_STATE_TX_DELAY               = 0x01,  // Waiting for t3.5 of bus silence before sending
+    MODBUS_STATE_TX                     = 0x02,  // Frame handed to the UART, waiting for it to leave
+    MODBUS_STATE_WAIT_REPLY             = 0x03,  // Master: waiting for the first response byte
+    MODBUS_STATE_RX                     = 0x04,  // Receiving until t3.5 silence or expected length
+};
+
+// ============================================================================
+// Master Requests
+// ============================================================================
+
+// Layout of ModbusRequest::data for register functions
+#define MODBUS_DATA_HOST    0x00  // uint16_t array in host byte order
+#define MODBUS_DATA_LE      0x01  // Little-endian byte pairs, no alignment needed (PLC memory)
+#define MODBUS_DATA_RAW     0x02  // Raw request PDU of `quantity` bytes (rawRequest)
+
+struct ModbusRequest {
+    uint8_t slave = 0;              // Target slave address (1-247)
+    uint8_t fc = 0;                 // Function code
+    uint8_t flags = MODBUS_DATA_HOST;
+    uint16_t start = 0;             // Starting coil/register address
+    uint16_t quantity = 0;          // Number of coils/registers
+    uint16_t value = 0;             // FC 05 (0xFF00 / 0x0000) and FC 06 value
+    uint8_t* data = nullptr;        // Read destination or multi-write source, valid until completion
+    ModbusResult* result = nullptr; // MODBUS_PENDING while queued, the outcome once complete
+
+    bool sameTarget(const ModbusRequest& other) const {
+        return slave == other.slave && fc == other.fc && flags == other.flags
+            && start == other.start && quantity == other.quantity && data == other.data;
+    }
 };
 
 // ============================================================================
@@ -283,9 +349,28 @@ private:
     uint32_t _t35;                // Inter-frame delay (3.5 char times) in microseconds
     uint32_t _timeoutMs;          // Response timeout for master mode
 
+    uint32_t _tchar;              // One character on the wire in microseconds
+
     // TX/RX buffer
     uint8_t _buf[MODBUS_RTU_MAX_ADU];
     uint16_t _bufLen;
+    bool _rxOverflow;
+
+    // Bus state machine
+    ModbusState _state;
+    uint32_t _lastBusUs;          // Last byte seen or sent on the bus
+    uint32_t _txTimeUs;           // Time the current TX frame needs on the wire
+    uint32_t _waitStartMs;        // Master: start of the response timeout
+
+    // Master request queue, the head request is on the wire while _state != IDLE
+    ModbusRequest _queue[MODBUS_RTU_QUEUE_DEPTH];
+    uint8_t _queueHead;
+    uint8_t _queueCount;
+
+    // Response buffer of the pending rawRequest
+    uint8_t* _rawResp;
+    uint16_t* _rawRespLen;
+    uint16_t _rawRespMax;
 
     // Slave data areas
     ModbusCoilBlock _coils;
@@ -339,33 +424,31 @@ private:
             // t3.5 = 3.5 * 11 / baudrate * 1000000 = 38500000 / baudrate
             _t35 = 38500000UL / _baudrate;
         }
+        _tchar = 11000000UL / _baudrate;
     }
 
     // ========================================================================
     // Frame TX/RX
     // ========================================================================
 
-    void sendFrame(const uint8_t* data, uint16_t length) {
-        // Wait inter-frame gap before transmitting
-        delayMicroseconds(_t35);
-
+    // Start sending _buf, poll() switches back to RX once it has left the UART
+    void transmit(uint16_t length) {
         setTxMode();
-        _serial->write(data, length);
-        _serial->flush();  // Wait for all data to be sent
-        setRxMode();
-
+        _serial->write(_buf, length);
         _txCount++;
+        _txTimeUs = length * _tchar;
+        _lastBusUs = micros();
+        _state = MODBUS_STATE_TX;
     }
 
     void sendResponse(uint8_t slaveAddr, const uint8_t* pdu, uint16_t pduLen) {
         if (pduLen + 3 > MODBUS_RTU_MAX_ADU) return;
-        uint8_t frame[MODBUS_RTU_MAX_ADU];
-        frame[0] = slaveAddr;
-        memcpy(&frame[1], pdu, pduLen);
-        uint16_t crc = modbus_crc16(frame, pduLen + 1);
-        frame[pduLen + 1] = crc & 0xFF;         // CRC low byte first
-        frame[pduLen + 2] = (crc >> 8) & 0xFF;  // CRC high byte
-        sendFrame(frame, pduLen + 3);
+        _buf[0] = slaveAddr;
+        memmove(&_buf[1], pdu, pduLen);  // pdu may point into _buf (echo responses)
+        uint16_t crc = modbus_crc16(_buf, pduLen + 1);
+        _buf[pduLen + 1] = crc & 0xFF;         // CRC low byte first
+        _buf[pduLen + 2] = (crc >> 8) & 0xFF;  // CRC high byte
+        transmit(pduLen + 3);
     }
 
     void sendException(uint8_t slaveAddr, uint8_t fc, ModbusException ex) {
@@ -377,51 +460,47 @@ private:
     }
 
     /**
-     * @brief Receive a complete Modbus RTU frame
-     * @param timeoutMs Maximum time to wait for first byte
-     * @return Number of bytes received (including address + CRC), 0 on timeout/error
+     * @brief Validate the frame collected in _buf (length + CRC)
+     * @return true if the frame can be processed
      */
-    uint16_t receiveFrame(uint32_t timeoutMs) {
-        _bufLen = 0;
-        uint32_t startMs = millis();
-
-        // Wait for first byte
-        while (!_serial->available()) {
-            if ((millis() - startMs) > timeoutMs) return 0;
-        }
-
-        // Read bytes, using t1.5 silence to detect end-of-frame
-        uint32_t lastByteTime = micros();
-        while (_bufLen < MODBUS_RTU_MAX_ADU) {
-            if (_serial->available()) {
-                int b = _serial->read();
-                if (b < 0) break;
-                _buf[_bufLen++] = (uint8_t)b;
-                lastByteTime = micros();
-            } else {
-                // Check for inter-frame gap (t3.5) to detect end of frame
-                uint32_t elapsed = micros() - lastByteTime;
-                if (elapsed > _t35) break;
-            }
-        }
-
+    bool checkFrame() {
         // Minimum valid frame: address(1) + fc(1) + CRC(2) = 4 bytes
-        if (_bufLen < 4) {
-            if (_bufLen > 0) _errCount++;
-            return 0;
+        if (_bufLen < 4 || _rxOverflow) {
+            _errCount++;
+            return false;
         }
-
-        // Verify CRC
         uint16_t receivedCrc = (uint16_t)_buf[_bufLen - 2] | ((uint16_t)_buf[_bufLen - 1] << 8);
         uint16_t calculatedCrc = modbus_crc16(_buf, _bufLen - 2);
         if (receivedCrc != calculatedCrc) {
             _errCount++;
             _lastError = MODBUS_ERR_CRC;
-            return 0;
+            return false;
         }
-
         _rxCount++;
-        return _bufLen;
+        return true;
+    }
+
+    /**
+     * @brief Length of the response being received, known from its header
+     * @return Frame length including address + CRC, 0 while unknown (wait for t3.5 silence)
+     */
+    uint16_t expectedLength() const {
+        if (_bufLen < 2) return 0;
+        if (_buf[1] & 0x80) return 5;
+        switch (_buf[1]) {
+            case MODBUS_FC_READ_COILS:
+            case MODBUS_FC_READ_DISCRETE_INPUTS:
+            case MODBUS_FC_READ_HOLDING_REGISTERS:
+            case MODBUS_FC_READ_INPUT_REGISTERS:
+                return _bufLen >= 3 ? 5 + _buf[2] : 0;
+            case MODBUS_FC_WRITE_SINGLE_COIL:
+            case MODBUS_FC_WRITE_SINGLE_REGISTER:
+            case MODBUS_FC_WRITE_MULTIPLE_COILS:
+            case MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+                return 8;
+            default:
+                return 0;
+        }
     }
 
     // ========================================================================
@@ -607,64 +686,159 @@ private:
     }
 
     // ========================================================================
-    // Master Mode: Send Request and Receive Response
+    // Master Mode: Request Encoding and Response Decoding
     // ========================================================================
 
-    ModbusResult masterTransaction(uint8_t slaveAddr, const uint8_t* pdu, uint16_t pduLen,
-                                   uint8_t* responsePdu, uint16_t* responseLen, uint16_t maxResponseLen) {
-        if (slaveAddr == 0 || slaveAddr > 247) return MODBUS_ERR_INVALID_PARAMS;
-        if (pduLen + 3 > MODBUS_RTU_MAX_ADU) return MODBUS_ERR_BUFFER_OVERFLOW;
-
-        // Build and send request frame
-        uint8_t frame[MODBUS_RTU_MAX_ADU];
-        frame[0] = slaveAddr;
-        memcpy(&frame[1], pdu, pduLen);
-        uint16_t crc = modbus_crc16(frame, pduLen + 1);
-        frame[pduLen + 1] = crc & 0xFF;
-        frame[pduLen + 2] = (crc >> 8) & 0xFF;
-
-        // Drain any stale data in RX buffer before sending
-        while (_serial->available()) _serial->read();
-
-        sendFrame(frame, pduLen + 3);
-
-        // Receive response
-        uint16_t rxLen = receiveFrame(_timeoutMs);
-        if (rxLen == 0) {
-            _lastError = MODBUS_ERR_TIMEOUT;
-            return MODBUS_ERR_TIMEOUT;
+    static uint16_t loadRegister(const ModbusRequest& req, uint16_t i) {
+        if (req.flags & MODBUS_DATA_LE) return (uint16_t)req.data[i * 2] | ((uint16_t)req.data[i * 2 + 1] << 8);
+        return ((const uint16_t*)req.data)[i];
+    }
+
+    static void storeRegister(const ModbusRequest& req, uint16_t i, uint16_t value) {
+        if (req.flags & MODBUS_DATA_LE) {
+            req.data[i * 2] = value & 0xFF;
+            req.data[i * 2 + 1] = (value >> 8) & 0xFF;
+        } else {
+            ((uint16_t*)req.data)[i] = value;
         }
+    }
 
-        // Verify slave address
-        if (_buf[0] != slaveAddr) {
-            _lastError = MODBUS_ERR_SLAVE_ADDR;
-            return MODBUS_ERR_SLAVE_ADDR;
+    ModbusResult validate(const ModbusRequest& req) const {
+        if (_slaveAddr != 0) return MODBUS_ERR_INVALID_PARAMS;  // Slave mode never sends requests
+        if (req.slave == 0 || req.slave > 247) return MODBUS_ERR_INVALID_PARAMS;
+        if (req.flags & MODBUS_DATA_RAW) {
+            if (req.quantity == 0 || !req.data) return MODBUS_ERR_INVALID_PARAMS;
+            if (req.quantity + 3 > MODBUS_RTU_MAX_ADU) return MODBUS_ERR_BUFFER_OVERFLOW;
+            return MODBUS_OK;
+        }
+        switch (req.fc) {
+            case MODBUS_FC_READ_COILS:
+            case MODBUS_FC_READ_DISCRETE_INPUTS:
+                if (req.quantity == 0 || req.quantity > 2000 || !req.data) return MODBUS_ERR_INVALID_PARAMS;
+                return MODBUS_OK;
+            case MODBUS_FC_READ_HOLDING_REGISTERS:
+            case MODBUS_FC_READ_INPUT_REGISTERS:
+                if (req.quantity == 0 || req.quantity > 125 || !req.data) return MODBUS_ERR_INVALID_PARAMS;
+                return MODBUS_OK;
+            case MODBUS_FC_WRITE_SINGLE_COIL:
+            case MODBUS_FC_WRITE_SINGLE_REGISTER:
+                return MODBUS_OK;
+            case MODBUS_FC_WRITE_MULTIPLE_COILS:
+                if (req.quantity == 0 || req.quantity > 1968 || !req.data) return MODBUS_ERR_INVALID_PARAMS;
+                if (6 + (req.quantity + 7) / 8 > MODBUS_RTU_MAX_PDU) return MODBUS_ERR_BUFFER_OVERFLOW;
+                return MODBUS_OK;
+            case MODBUS_FC_WRITE_MULTIPLE_REGISTERS:
+                if (req.quantity == 0 || req.quantity > 123 || !req.data) return MODBUS_ERR_INVALID_PARAMS;
+                if (6 + req.quantity * 2 > MODBUS_RTU_MAX_PDU) return MODBUS_ERR_BUFFER_OVERFLOW;
+                return MODBUS_OK;
+            default:
+                return MODBUS_ERR_INVALID_PARAMS;
+        }
+    }
+
+    /**
+     * @brief Encode a validated request as an ADU in _buf
+     * @return Frame length including address + CRC
+     */
+    uint16_t encodeRequest(const ModbusRequest& req) {
+        uint8_t* pdu = &_buf[1];
+        uint16_t pduLen = 5;
+        _buf[0] = req.slave;
+        if (req.flags & MODBUS_DATA_RAW) {
+            memcpy(pdu, req.data, req.quantity);
+            pduLen = req.quantity;
+        } else {
+            bool single = req.fc == MODBUS_FC_WRITE_SINGLE_COIL || req.fc == MODBUS_FC_WRITE_SINGLE_REGISTER;
+            uint16_t field = single ? req.value : req.quantity;
+            pdu[0] = req.fc;
+            pdu[1] = (req.start >> 8) & 0xFF;
+            pdu[2] = req.start & 0xFF;
+            pdu[3] = (field >> 8) & 0xFF;
+            pdu[4] = field & 0xFF;
+            if (req.fc == MODBUS_FC_WRITE_MULTIPLE_COILS) {
+                uint8_t byteCount = (req.quantity + 7) / 8;
+                pdu[5] = byteCount;
+                memcpy(&pdu[6], req.data, byteCount);
+                pduLen = 6 + byteCount;
+            } else if (req.fc == MODBUS_FC_WRITE_MULTIPLE_REGISTERS) {
+                pdu[5] = req.quantity * 2;
+                for (uint16_t i = 0; i < req.quantity; i++) {
+                    uint16_t val = loadRegister(req, i);
+                    pdu[6 + i * 2]     = (val >> 8) & 0xFF;
+                    pdu[6 + i * 2 + 1] = val & 0xFF;
+                }
+                pduLen = 6 + req.quantity * 2;
+            }
         }
+        uint16_t crc = modbus_crc16(_buf, pduLen + 1);
+        _buf[pduLen + 1] = crc & 0xFF;
+        _buf[pduLen + 2] = (crc >> 8) & 0xFF;
+        return pduLen + 3;
+    }
+
+    ModbusResult decodeResponse(const ModbusRequest& req) {
+        if (!checkFrame()) return _rxOverflow ? MODBUS_ERR_BUFFER_OVERFLOW : (_bufLen < 4 ? MODBUS_ERR_FRAME : MODBUS_ERR_CRC);
+
+        // Verify slave address
+        if (_buf[0] != req.slave) return MODBUS_ERR_SLAVE_ADDR;
+
+        const uint8_t* pdu = &_buf[1];
+        uint16_t pduLen = _bufLen - 3;  // Remove address + CRC
 
         // Check for exception response
-        if (_buf[1] & 0x80) {
-            _lastError = MODBUS_ERR_EXCEPTION;
-            if (responsePdu && maxResponseLen >= 2) {
-                responsePdu[0] = _buf[1];
-                responsePdu[1] = _buf[2];
-                *responseLen = 2;
+        if (pdu[0] & 0x80) {
+            if (_rawResp && _rawRespLen && _rawRespMax >= 2) {
+                _rawResp[0] = pdu[0];
+                _rawResp[1] = pdu[1];
+                *_rawRespLen = 2;
             }
             return MODBUS_ERR_EXCEPTION;
         }
 
-        // Copy PDU to caller buffer
-        uint16_t respPduLen = rxLen - 3;  // Remove address + CRC
-        if (respPduLen > maxResponseLen) {
-            _lastError = MODBUS_ERR_BUFFER_OVERFLOW;
-            return MODBUS_ERR_BUFFER_OVERFLOW;
+        if (req.flags & MODBUS_DATA_RAW) {
+            if (pduLen > _rawRespMax) return MODBUS_ERR_BUFFER_OVERFLOW;
+            if (_rawResp && _rawRespLen) {
+                memcpy(_rawResp, pdu, pduLen);
+                *_rawRespLen = pduLen;
+            }
+            return MODBUS_OK;
         }
-        if (responsePdu) {
-            memcpy(responsePdu, &_buf[1], respPduLen);
-            *responseLen = respPduLen;
+
+        if (pdu[0] != req.fc) return MODBUS_ERR_FRAME;
+        switch (req.fc) {
+            case MODBUS_FC_READ_COILS:
+            case MODBUS_FC_READ_DISCRETE_INPUTS: {
+                if (pduLen < 2) return MODBUS_ERR_FRAME;
+                uint8_t byteCount = pdu[1];
+                if (byteCount != (req.quantity + 7) / 8) return MODBUS_ERR_FRAME;
+                if (pduLen < (uint16_t)(2 + byteCount)) return MODBUS_ERR_FRAME;
+                memcpy(req.data, &pdu[2], byteCount);
+                return MODBUS_OK;
+            }
+            case MODBUS_FC_READ_HOLDING_REGISTERS:
+            case MODBUS_FC_READ_INPUT_REGISTERS: {
+                if (pduLen < 2) return MODBUS_ERR_FRAME;
+                uint8_t byteCount = pdu[1];
+                if (byteCount != req.quantity * 2) return MODBUS_ERR_FRAME;
+                if (pduLen < (uint16_t)(2 + byteCount)) return MODBUS_ERR_FRAME;
+                for (uint16_t i = 0; i < req.quantity; i++) {
+                    storeRegister(req, i, ((uint16_t)pdu[2 + i * 2] << 8) | pdu[2 + i * 2 + 1]);
+                }
+                return MODBUS_OK;
+            }
+            default:
+                return pduLen >= 5 ? MODBUS_OK : MODBUS_ERR_FRAME;
         }
+    }
 
-        _lastError = MODBUS_OK;
-        return MODBUS_OK;
+    // Finish the head request and free its queue slot
+    void completeRequest(ModbusResult result) {
+        ModbusRequest& req = _queue[_queueHead];
+        _lastError = result;
+        if (req.result) *req.result = result;
+        _queueHead = (_queueHead + 1) % MODBUS_RTU_QUEUE_DEPTH;
+        _queueCount--;
+        _state = MODBUS_STATE_IDLE;
     }
 
 public:
@@ -687,7 +861,18 @@ public:
         , _t15(0)
         , _t35(0)
         , _timeoutMs(MODBUS_RTU_DEFAULT_TIMEOUT_MS)
+        , _tchar(0)
         , _bufLen(0)
+        , _rxOverflow(false)
+        , _state(MODBUS_STATE_IDLE)
+        , _lastBusUs(0)
+        , _txTimeUs(0)
+        , _waitStartMs(0)
+        , _queueHead(0)
+        , _queueCount(0)
+        , _rawResp(nullptr)
+        , _rawRespLen(nullptr)
+        , _rawRespMax(0)
         , _rxCount(0)
         , _txCount(0)
         , _errCount(0)
@@ -712,6 +897,11 @@ public:
             pinMode(_dePin, OUTPUT);
             digitalWrite(_dePin, LOW);  // Start in RX mode
         }
+        _state = MODBUS_STATE_IDLE;
+        _queueHead = 0;
+        _queueCount = 0;
+        _bufLen = 0;
+        _lastBusUs = micros();
     }
 
     // ========================================================================
@@ -783,23 +973,137 @@ public:
     void inputRegister(uint16_t address, uint16_t value) { if (_inputRegs.contains(address, 1)) _inputRegs.setReg(address, value); }
 
     // ========================================================================
-    // Slave Mode: Poll (call from loop)
+    // Bus Engine: Poll (call from loop)
     // ========================================================================
 
     /**
-     * @brief Process incoming Modbus requests (slave mode)
+     * @brief Advance the bus state machine without waiting on the wire
+     * Slave mode: collects and answers requests. Master mode: sends queued
+     * requests one at a time and completes them from the response.
      * Call this regularly in the main loop.
      */
     void poll() {
-        if (_slaveAddr == 0) return;  // Master mode, nothing to poll
-        if (!_serial->available()) return;
+        if (_state == MODBUS_STATE_IDLE) {
+            if (_slaveAddr != 0) {
+                if (!_serial->available()) return;
+                _bufLen = 0;
+                _rxOverflow = false;
+                _state = MODBUS_STATE_RX;
+            } else {
+                // Drop stray bytes, they still count as bus activity
+                while (_serial->available()) {
+                    _serial->read();
+                    _lastBusUs = micros();
+                }
+                if (_queueCount == 0) return;
+                _bufLen = encodeRequest(_queue[_queueHead]);
+                _state = MODBUS_STATE_TX_DELAY;
+            }
+        }
+
+        if (_state == MODBUS_STATE_TX_DELAY) {
+            if ((uint32_t)(micros() - _lastBusUs) < _t35) return;
+            transmit(_bufLen);
+        }
+
+        if (_state == MODBUS_STATE_TX) {
+            if ((uint32_t)(micros() - _lastBusUs) < _txTimeUs) return;
+            setRxMode();
+            _lastBusUs = micros();
+            _bufLen = 0;
+            if (_slaveAddr != 0) {
+                _state = MODBUS_STATE_IDLE;
+                return;
+            }
+            _waitStartMs = millis();
+            _state = MODBUS_STATE_WAIT_REPLY;
+        }
+
+        if (_state == MODBUS_STATE_WAIT_REPLY) {
+            if (!_serial->available()) {
+                if ((millis() - _waitStartMs) > _timeoutMs) completeRequest(MODBUS_ERR_TIMEOUT);
+                return;
+            }
+            _rxOverflow = false;
+            _state = MODBUS_STATE_RX;
+        }
+
+        if (_state == MODBUS_STATE_RX) {
+            while (_serial->available()) {
+                int b = _serial->read();
+                if (b < 0) break;
+                if (_bufLen < MODBUS_RTU_MAX_ADU) _buf[_bufLen++] = (uint8_t)b;
+                else _rxOverflow = true;
+                _lastBusUs = micros();
+            }
+            // End of frame on t3.5 silence, or as soon as a known response is complete
+            bool complete = (uint32_t)(micros() - _lastBusUs) > _t35;
+            if (!complete && _slaveAddr == 0) {
+                uint16_t expected = expectedLength();
+                complete = expected > 0 && _bufLen >= expected;
+            }
+            if (!complete) return;
+            if (_slaveAddr != 0) {
+                _state = MODBUS_STATE_IDLE;
+                if (checkFrame()) processSlaveRequest();
+            } else {
+                completeRequest(decodeResponse(_queue[_queueHead]));
+            }
+        }
+    }
 
-        uint16_t rxLen = receiveFrame(_timeoutMs);
-        if (rxLen > 0) {
-            processSlaveRequest();
+    // ========================================================================
+    // Master Mode: Request Queue
+    // ========================================================================
+
+    /**
+     * @brief Queue a master request, sent by poll() when the bus is free
+     * @param request Request to queue (copied), its data buffer must stay valid until completion
+     * @param coalesce Skip the request if the same one is already queued, a queued
+     *                 single write to the same address takes the new value instead
+     * @return MODBUS_PENDING if queued (or coalesced), an error code otherwise
+     */
+    ModbusResult submit(const ModbusRequest& request, bool coalesce = false) {
+        ModbusResult valid = validate(request);
+        if (valid != MODBUS_OK) return valid;
+        if (coalesce) {
+            for (uint8_t i = 0; i < _queueCount; i++) {
+                ModbusRequest& queued = _queue[(_queueHead + i) % MODBUS_RTU_QUEUE_DEPTH];
+                if (!queued.sameTarget(request)) continue;
+                if (queued.value == request.value) return MODBUS_PENDING;
+                bool onWire = i == 0 && _state != MODBUS_STATE_IDLE;
+                if (!onWire) {
+                    queued.value = request.value;
+                    return MODBUS_PENDING;
+                }
+            }
         }
+        if (_queueCount >= MODBUS_RTU_QUEUE_DEPTH) return MODBUS_ERR_QUEUE_FULL;
+        ModbusRequest& slot = _queue[(_queueHead + _queueCount) % MODBUS_RTU_QUEUE_DEPTH];
+        slot = request;
+        if (slot.result) *slot.result = MODBUS_PENDING;
+        _queueCount++;
+        return MODBUS_PENDING;
     }
 
+    /**
+     * @brief Queue a request and drive the bus until it completes (blocking)
+     * @return ModbusResult
+     */
+    ModbusResult transact(ModbusRequest request) {
+        ModbusResult result = MODBUS_PENDING;
+        request.result = &result;
+        ModbusResult status;
+        while ((status = submit(request)) == MODBUS_ERR_QUEUE_FULL) poll();
+        if (status != MODBUS_PENDING) return status;
+        while (result == MODBUS_PENDING) poll();
+        return result;
+    }
+
+    ModbusState state() const { return _state; }
+    bool busy() const { return _queueCount > 0 || _state != MODBUS_STATE_IDLE; }
+    uint8_t queued() const { return _queueCount; }
+
     // ========================================================================
     // Master Mode: Read Functions
     // ========================================================================
@@ -813,24 +1117,13 @@ public:
      * @return ModbusResult
      */
     ModbusResult readCoils(uint8_t slaveAddr, uint16_t startAddress, uint16_t quantity, uint8_t* result) {
-        if (quantity == 0 || quantity > 2000 || !result) return MODBUS_ERR_INVALID_PARAMS;
-        uint8_t pdu[5];
-        pdu[0] = MODBUS_FC_READ_COILS;
-        pdu[1] = (startAddress >> 8) & 0xFF;
-        pdu[2] = startAddress & 0xFF;
-        pdu[3] = (quantity >> 8) & 0xFF;
-        pdu[4] = quantity & 0xFF;
-
-        uint8_t resp[MODBUS_RTU_MAX_PDU];
-        uint16_t respLen = 0;
-        ModbusResult r = masterTransaction(slaveAddr, pdu, 5, resp, &respLen, sizeof(resp));
-        if (r != MODBUS_OK) return r;
-        if (respLen < 2) return MODBUS_ERR_FRAME;
-
-        uint8_t byteCount = resp[1];
-        if (respLen < (uint16_t)(2 + byteCount)) return MODBUS_ERR_FRAME;
-        memcpy(result, &resp[2], byteCount);
-        return MODBUS_OK;
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = MODBUS_FC_READ_COILS;
+        req.start = startAddress;
+        req.quantity = quantity;
+        req.data = result;
+        return transact(req);
     }
 
     /**
@@ -842,24 +1135,13 @@ public:
      * @return ModbusResult
      */
     ModbusResult readDiscreteInputs(uint8_t slaveAddr, uint16_t startAddress, uint16_t quantity, uint8_t* result) {
-        if (quantity == 0 || quantity > 2000 || !result) return MODBUS_ERR_INVALID_PARAMS;
-        uint8_t pdu[5];
-        pdu[0] = MODBUS_FC_READ_DISCRETE_INPUTS;
-        pdu[1] = (startAddress >> 8) & 0xFF;
-        pdu[2] = startAddress & 0xFF;
-        pdu[3] = (quantity >> 8) & 0xFF;
-        pdu[4] = quantity & 0xFF;
-
-        uint8_t resp[MODBUS_RTU_MAX_PDU];
-        uint16_t respLen = 0;
-        ModbusResult r = masterTransaction(slaveAddr, pdu, 5, resp, &respLen, sizeof(resp));
-        if (r != MODBUS_OK) return r;
-        if (respLen < 2) return MODBUS_ERR_FRAME;
-
-        uint8_t byteCount = resp[1];
-        if (respLen < (uint16_t)(2 + byteCount)) return MODBUS_ERR_FRAME;
-        memcpy(result, &resp[2], byteCount);
-        return MODBUS_OK;
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = MODBUS_FC_READ_DISCRETE_INPUTS;
+        req.start = startAddress;
+        req.quantity = quantity;
+        req.data = result;
+        return transact(req);
     }
 
     /**
@@ -871,27 +1153,13 @@ public:
      * @return ModbusResult
      */
     ModbusResult readHoldingRegisters(uint8_t slaveAddr, uint16_t startAddress, uint16_t quantity, uint16_t* result) {
-        if (quantity == 0 || quantity > 125 || !result) return MODBUS_ERR_INVALID_PARAMS;
-        uint8_t pdu[5];
-        pdu[0] = MODBUS_FC_READ_HOLDING_REGISTERS;
-        pdu[1] = (startAddress >> 8) & 0xFF;
-        pdu[2] = startAddress & 0xFF;
-        pdu[3] = (quantity >> 8) & 0xFF;
-        pdu[4] = quantity & 0xFF;
-
-        uint8_t resp[MODBUS_RTU_MAX_PDU];
-        uint16_t respLen = 0;
-        ModbusResult r = masterTransaction(slaveAddr, pdu, 5, resp, &respLen, sizeof(resp));
-        if (r != MODBUS_OK) return r;
-        if (respLen < 2) return MODBUS_ERR_FRAME;
-
-        uint8_t byteCount = resp[1];
-        if (byteCount != quantity * 2) return MODBUS_ERR_FRAME;
-        if (respLen < (uint16_t)(2 + byteCount)) return MODBUS_ERR_FRAME;
-        for (uint16_t i = 0; i < quantity; i++) {
-            result[i] = ((uint16_t)resp[2 + i * 2] << 8) | resp[2 + i * 2 + 1];
-        }
-        return MODBUS_OK;
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = MODBUS_FC_READ_HOLDING_REGISTERS;
+        req.start = startAddress;
+        req.quantity = quantity;
+        req.data = (uint8_t*)result;
+        return transact(req);
     }
 
     /**
@@ -903,27 +1171,13 @@ public:
      * @return ModbusResult
      */
     ModbusResult readInputRegisters(uint8_t slaveAddr, uint16_t startAddress, uint16_t quantity, uint16_t* result) {
-        if (quantity == 0 || quantity > 125 || !result) return MODBUS_ERR_INVALID_PARAMS;
-        uint8_t pdu[5];
-        pdu[0] = MODBUS_FC_READ_INPUT_REGISTERS;
-        pdu[1] = (startAddress >> 8) & 0xFF;
-        pdu[2] = startAddress & 0xFF;
-        pdu[3] = (quantity >> 8) & 0xFF;
-        pdu[4] = quantity & 0xFF;
-
-        uint8_t resp[MODBUS_RTU_MAX_PDU];
-        uint16_t respLen = 0;
-        ModbusResult r = masterTransaction(slaveAddr, pdu, 5, resp, &respLen, sizeof(resp));
-        if (r != MODBUS_OK) return r;
-        if (respLen < 2) return MODBUS_ERR_FRAME;
-
-        uint8_t byteCount = resp[1];
-        if (byteCount != quantity * 2) return MODBUS_ERR_FRAME;
-        if (respLen < (uint16_t)(2 + byteCount)) return MODBUS_ERR_FRAME;
-        for (uint16_t i = 0; i < quantity; i++) {
-            result[i] = ((uint16_t)resp[2 + i * 2] << 8) | resp[2 + i * 2 + 1];
-        }
-        return MODBUS_OK;
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = MODBUS_FC_READ_INPUT_REGISTERS;
+        req.start = startAddress;
+        req.quantity = quantity;
+        req.data = (uint8_t*)result;
+        return transact(req);
     }
 
     // ========================================================================
@@ -938,16 +1192,12 @@ public:
      * @return ModbusResult
      */
     ModbusResult writeSingleCoil(uint8_t slaveAddr, uint16_t address, bool value) {
-        uint8_t pdu[5];
-        pdu[0] = MODBUS_FC_WRITE_SINGLE_COIL;
-        pdu[1] = (address >> 8) & 0xFF;
-        pdu[2] = address & 0xFF;
-        pdu[3] = value ? 0xFF : 0x00;
-        pdu[4] = 0x00;
-
-        uint8_t resp[MODBUS_RTU_MAX_PDU];
-        uint16_t respLen = 0;
-        return masterTransaction(slaveAddr, pdu, 5, resp, &respLen, sizeof(resp));
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = MODBUS_FC_WRITE_SINGLE_COIL;
+        req.start = address;
+        req.value = value ? 0xFF00 : 0x0000;
+        return transact(req);
     }
 
     /**
@@ -958,16 +1208,12 @@ public:
      * @return ModbusResult
      */
     ModbusResult writeSingleRegister(uint8_t slaveAddr, uint16_t address, uint16_t value) {
-        uint8_t pdu[5];
-        pdu[0] = MODBUS_FC_WRITE_SINGLE_REGISTER;
-        pdu[1] = (address >> 8) & 0xFF;
-        pdu[2] = address & 0xFF;
-        pdu[3] = (value >> 8) & 0xFF;
-        pdu[4] = value & 0xFF;
-
-        uint8_t resp[MODBUS_RTU_MAX_PDU];
-        uint16_t respLen = 0;
-        return masterTransaction(slaveAddr, pdu, 5, resp, &respLen, sizeof(resp));
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = MODBUS_FC_WRITE_SINGLE_REGISTER;
+        req.start = address;
+        req.value = value;
+        return transact(req);
     }
 
     /**
@@ -979,22 +1225,13 @@ public:
      * @return ModbusResult
      */
     ModbusResult writeMultipleCoils(uint8_t slaveAddr, uint16_t startAddress, uint16_t quantity, const uint8_t* values) {
-        if (quantity == 0 || quantity > 1968 || !values) return MODBUS_ERR_INVALID_PARAMS;
-        uint8_t byteCount = (quantity + 7) / 8;
-        if (6 + byteCount > MODBUS_RTU_MAX_PDU) return MODBUS_ERR_BUFFER_OVERFLOW;
-
-        uint8_t pdu[MODBUS_RTU_MAX_PDU];
-        pdu[0] = MODBUS_FC_WRITE_MULTIPLE_COILS;
-        pdu[1] = (startAddress >> 8) & 0xFF;
-        pdu[2] = startAddress & 0xFF;
-        pdu[3] = (quantity >> 8) & 0xFF;
-        pdu[4] = quantity & 0xFF;
-        pdu[5] = byteCount;
-        memcpy(&pdu[6], values, byteCount);
-
-        uint8_t resp[MODBUS_RTU_MAX_PDU];
-        uint16_t respLen = 0;
-        return masterTransaction(slaveAddr, pdu, 6 + byteCount, resp, &respLen, sizeof(resp));
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = MODBUS_FC_WRITE_MULTIPLE_COILS;
+        req.start = startAddress;
+        req.quantity = quantity;
+        req.data = (uint8_t*)values;
+        return transact(req);
     }
 
     /**
@@ -1006,25 +1243,13 @@ public:
      * @return ModbusResult
      */
     ModbusResult writeMultipleRegisters(uint8_t slaveAddr, uint16_t startAddress, uint16_t quantity, const uint16_t* values) {
-        if (quantity == 0 || quantity > 123 || !values) return MODBUS_ERR_INVALID_PARAMS;
-        uint8_t byteCount = quantity * 2;
-        if (6 + byteCount > MODBUS_RTU_MAX_PDU) return MODBUS_ERR_BUFFER_OVERFLOW;
-
-        uint8_t pdu[MODBUS_RTU_MAX_PDU];
-        pdu[0] = MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
-        pdu[1] = (startAddress >> 8) & 0xFF;
-        pdu[2] = startAddress & 0xFF;
-        pdu[3] = (quantity >> 8) & 0xFF;
-        pdu[4] = quantity & 0xFF;
-        pdu[5] = byteCount;
-        for (uint16_t i = 0; i < quantity; i++) {
-            pdu[6 + i * 2]     = (values[i] >> 8) & 0xFF;
-            pdu[6 + i * 2 + 1] = values[i] & 0xFF;
-        }
-
-        uint8_t resp[MODBUS_RTU_MAX_PDU];
-        uint16_t respLen = 0;
-        return masterTransaction(slaveAddr, pdu, 6 + byteCount, resp, &respLen, sizeof(resp));
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = MODBUS_FC_WRITE_MULTIPLE_REGISTERS;
+        req.start = startAddress;
+        req.quantity = quantity;
+        req.data = (uint8_t*)values;
+        return transact(req);
     }
 
     // ========================================================================
@@ -1032,7 +1257,7 @@ public:
     // ========================================================================
 
     /**
-     * @brief Send a raw Modbus PDU and receive the response
+     * @brief Send a raw Modbus PDU and receive the response (blocking)
      * @param slaveAddr Target slave address (1-247)
      * @param requestPdu PDU to send (function code + data)
      * @param requestLen Length of request PDU
@@ -1043,7 +1268,21 @@ public:
      */
     ModbusResult rawRequest(uint8_t slaveAddr, const uint8_t* requestPdu, uint16_t requestLen,
                             uint8_t* responsePdu, uint16_t* responseLen, uint16_t maxResponseLen) {
-        return masterTransaction(slaveAddr, requestPdu, requestLen, responsePdu, responseLen, maxResponseLen);
+        if (!requestPdu || requestLen == 0) return MODBUS_ERR_INVALID_PARAMS;
+        ModbusRequest req;
+        req.slave = slaveAddr;
+        req.fc = requestPdu[0];
+        req.flags = MODBUS_DATA_RAW;
+        req.quantity = requestLen;
+        req.data = (uint8_t*)requestPdu;
+        _rawResp = responsePdu;
+        _rawRespLen = responseLen;
+        _rawRespMax = maxResponseLen;
+        ModbusResult r = transact(req);
+        _rawResp = nullptr;
+        _rawRespLen = nullptr;
+        _rawRespMax = 0;
+        return r;
     }
 
     // ========================================================================
@@ -1075,7 +1314,7 @@ public:
      * @return Exception code, or 0 if no exception
      */
     uint8_t lastExceptionCode() const {
-        // After a failed masterTransaction that returned MODBUS_ERR_EXCEPTION,
+        // After a request that completed with MODBUS_ERR_EXCEPTION,
         // the exception code is in buf[2]
         if (_bufLen >= 3 && (_buf[1] & 0x80)) return _buf[2];
         return 0;
@@ -25,6 +25,7 @@
 #define __RUNTIME_FULL_UNIT_TEST___
 #define USE_X64_OPS
 #define PLCRUNTIME_FFI_ENABLED
+#define PLCRUNTIME_ONLINE_CHANGE
 
 #define VOVKPLC_DEVICE_NAME "Simulator"
 
@@ -123,22 +124,22 @@ void custom_test() {
 }
 
 WASM_EXPORT int run() {
-    IntervalGlobalLoopCheck();
+    runtime.clock.update(millis());
     return runtime.run();
 }
 
 WASM_EXPORT int runDirty() {
-    IntervalGlobalLoopCheck();
+    runtime.clock.update(millis());
     return runtime.runDirty();
 }
 
 WASM_EXPORT int runExplain() {
-    IntervalGlobalLoopCheck();
+    runtime.clock.update(millis());
     return UnitTest::fullProgramDebug(runtime);
 }
 
 WASM_EXPORT void run_unit_test() {
-    IntervalGlobalLoopCheck();
+    runtime.clock.update(millis());
     runtime_unit_test(runtime);
 }
 
@@ -404,6 +405,21 @@ WASM_EXPORT int project_loadToRuntime() {
     return (int)runtime.program.load(project_compiler.getBytecode(), project_compiler.getBytecodeLength(), project_compiler.getChecksum());
 }
 
+// Stage the compiled project as an online change: memory and DataBlocks are kept,
+// the program is swapped in by the next run() call. Returns 0 or the RuntimeError.
+WASM_EXPORT int project_stageToRuntime() {
+    return (int)runtime.stageProgram(project_compiler.getBytecode(), project_compiler.getBytecodeLength(), project_compiler.getChecksum());
+}
+
+WASM_EXPORT int program_changePending() {
+    return runtime.programChangePending() ? 1 : 0;
+}
+
+// Result of the last online change: 0, or the RuntimeError that made the runtime drop the staged program
+WASM_EXPORT int program_changeStatus() {
+    return (int)runtime.programChangeStatus();
+}
+
 WASM_EXPORT void memoryReset() {
     runtime.formatMemory();
 }
@@ -644,57 +660,10 @@ RuntimeError js_ffi_router(u8* memory, u16* param_addrs, u8 param_count, u16 ret
     const PLCFFIEntry* entry = runtime.getFFI(ffi_index);
     if (!entry) return FFI_NOT_FOUND;
     
-    // Parse signature to get parameter types and return type
-    const char* sig = entry->signature;
-    u8 param_types[8] = {0};
-    u8 ret_type = 0;
-    u8 p_idx = 0;
-    
-    // Helper lambda-like function to match type prefix
-    auto matchType = [](const char* s, const char* t, int len) -> bool {
-        for (int i = 0; i < len; i++) {
-            if (s[i] != t[i]) return false;
-        }
-        return true;
-    };
-    
-    // Parse parameter types (before "->")
-    const char* ptr = sig;
-    while (*ptr && !(ptr[0] == '-' && ptr[1] == '>')) {
-        if (*ptr == ',') { ptr++; continue; }
-        
-        // Match type names
-        if (matchType(ptr, "void", 4)) { param_types[p_idx++] = 0; ptr += 4; }
-        else if (matchType(ptr, "bool", 4)) { param_types[p_idx++] = 1; ptr += 4; }
-        else if (matchType(ptr, "u8", 2) && ptr[2] != '6') { param_types[p_idx++] = 2; ptr += 2; }
-        else if (matchType(ptr, "i8", 2)) { param_types[p_idx++] = 3; ptr += 2; }
-        else if (matchType(ptr, "u16", 3)) { param_types[p_idx++] = 4; ptr += 3; }
-        else if (matchType(ptr, "i16", 3)) { param_types[p_idx++] = 5; ptr += 3; }
-        else if (matchType(ptr, "u32", 3)) { param_types[p_idx++] = 6; ptr += 3; }
-        else if (matchType(ptr, "i32", 3)) { param_types[p_idx++] = 7; ptr += 3; }
-        else if (matchType(ptr, "u64", 3)) { param_types[p_idx++] = 8; ptr += 3; }
-        else if (matchType(ptr, "i64", 3)) { param_types[p_idx++] = 9; ptr += 3; }
-        else if (matchType(ptr, "f32", 3)) { param_types[p_idx++] = 10; ptr += 3; }
-        else if (matchType(ptr, "f64", 3)) { param_types[p_idx++] = 11; ptr += 3; }
-        else ptr++;
-    }
-    
-    // Skip "->"
-    if (ptr[0] == '-' && ptr[1] == '>') ptr += 2;
-    
-    // Parse return type
-    if (matchType(ptr, "void", 4)) ret_type = 0;
-    else if (matchType(ptr, "bool", 4)) ret_type = 1;
-    else if (matchType(ptr, "u8", 2) && ptr[2] != '6') ret_type = 2;
-    else if (matchType(ptr, "i8", 2)) ret_type = 3;
-    else if (matchType(ptr, "u16", 3)) ret_type = 4;
-    else if (matchType(ptr, "i16", 3)) ret_type = 5;
-    else if (matchType(ptr, "u32", 3)) ret_type = 6;
-    else if (matchType(ptr, "i32", 3)) ret_type = 7;
-    else if (matchType(ptr, "u64", 3)) ret_type = 8;
-    else if (matchType(ptr, "i64", 3)) ret_type = 9;
-    else if (matchType(ptr, "f32", 3)) ret_type = 10;
-    else if (matchType(ptr, "f64", 3)) ret_type = 11;
+    // Types were resolved from the signature when the entry was registered
+    u8 param_types[PLCRUNTIME_FFI_MAX_PARAMS];
+    for (u8 i = 0; i < entry->param_count; i++) param_types[i] = entry->param_types[i];
+    u8 ret_type = entry->ret_type;
     
     // Call the JS import
     return js_ffi_invoke(ffi_index, param_types, param_addrs, param_count, ret_addr, ret_type);
@@ -728,6 +697,18 @@ WASM_EXPORT u8 ffi_isJSBacked(u8 index) {
     return (js_ffi_flags & (1ULL << index)) ? 1 : 0;
 }
 
+// Mark an FFI entry as long-running (FFI_START / FFI_POLL). JS-backed entries read the
+// runtime memory directly instead of the job's parameter copy, so they stay synchronous.
+WASM_EXPORT u8 ffi_setAsync(u8 index, u8 async) {
+    if (async && ffi_isJSBacked(index)) return 0;
+    return runtime.setFFIAsync(index, async != 0) ? 1 : 0;
+}
+
+// Run queued async FFI jobs between scans, returns the number of jobs run
+WASM_EXPORT u8 ffi_service(u8 max_jobs) {
+    return runtime.serviceFFI(max_jobs);
+}
+
 // ============================================================================
 // Legacy JS Callback System (for backward compatibility)
 // ============================================================================
@@ -1100,4 +1081,86 @@ WASM_EXPORT u32 wcet_target_get_active_caps()     { return g_wcet_active_profile
 WASM_EXPORT u32 wcet_target_list_name(u32 i)      { return (u32)(uintptr_t)wcet_get_target_name(i); }
 WASM_EXPORT u32 wcet_target_list_arch(u32 i)      { return (u32)(uintptr_t)wcet_get_target_arch(i); }
 WASM_EXPORT u16 wcet_target_list_clock(u32 i)     { return wcet_get_target_clock(i); }
-WASM_EXPORT u32 wcet_target_list_caps(u32 i)      { return wcet_get_target_caps(i); }
\ No newline at end of file
+WASM_EXPORT u32 wcet_target_list_caps(u32 i)      { return wcet_get_target_caps(i); }
+// ============================================================================
+// Ahead-of-time translator WASM Exports
+// ============================================================================
+// Translate compiled bytecode into C++ for firmware builds (see aot-cpp.h).
+// Stream the symbol name and call aot_load_name_from_stream() first (optional,
+// defaults to "plc_program"), then aot_translate_compiled/project/runtime().
+// The source is printed to stdout, aot_get_error() explains a failure.
+
+WASM_EXPORT bool aot_load_name_from_stream() {
+    char name[AOT_NAME_MAX];
+    int length = 0;
+    streamRead(name, length, AOT_NAME_MAX);
+    return aot_set_name(name);
+}
+
+// Translate bytecode currently loaded in the PLCASM compiler (defaultCompiler)
+WASM_EXPORT bool aot_translate_compiled() {
+    return aot_translate(defaultCompiler.built_bytecode, (u32) defaultCompiler.built_bytecode_length);
+}
+
+// Translate bytecode currently loaded in the project compiler
+WASM_EXPORT bool aot_translate_project() {
+    u8* bytecode = project_compiler.getBytecode();
+    int length = project_compiler.getBytecodeLength();
+    if (!bytecode || length <= 0) return false;
+    return aot_translate(bytecode, (u32) length);
+}
+
+// Translate bytecode currently loaded in the runtime program
+WASM_EXPORT bool aot_translate_runtime() {
+    return aot_translate(runtime.program.program, runtime.program.prog_size);
+}
+
+WASM_EXPORT const char* aot_get_error() { return g_aot_error; }
+
+#ifdef PLCRUNTIME_AOT_ENABLED
+// ============================================================================
+// WebAssembly tier WASM Exports
+// ============================================================================
+// Translate the loaded runtime program into a WebAssembly module (see aot-wasm.h).
+// The host instantiates aot_wasm_get_module() with { env: { memory, step: aot_wasm_step } },
+// stores its `run` export in the function table and passes the slot to aot_wasm_attach().
+// From then on run() executes the module while the translated program stays loaded.
+
+PLCAotProgram g_aot_wasm_program;
+
+WASM_EXPORT bool aot_wasm_translate_runtime() {
+    AotWasmLayout layout;
+    layout.memory = (u32) (uintptr_t) runtime.memory;
+    layout.stack_data = (u32) (uintptr_t) runtime.stack.stack.data();
+    layout.stack_max = (u32) (uintptr_t) &runtime.stack.stack.MAX_STACK_SIZE;
+    layout.stack_size = (u32) (uintptr_t) &runtime.stack.stack._size;
+    return aot_wasm_translate(runtime.program.program, runtime.program.prog_size, layout);
+}
+
+WASM_EXPORT u32 aot_wasm_get_module() { return (u32) (uintptr_t) g_aot_wasm_module; }
+WASM_EXPORT u32 aot_wasm_get_module_size() { return g_aot_wasm_length; }
+WASM_EXPORT u32 aot_wasm_get_native_count() { return g_aot_wasm_native; }
+WASM_EXPORT u32 aot_wasm_get_fallback_count() { return g_aot_wasm_fallback; }
+
+// env.step of the generated module: execute the instruction at *index
+WASM_EXPORT RuntimeError aot_wasm_step(VovkPLCRuntime* rt, u32* index) {
+    return rt->step(rt->program.program, rt->program.prog_size, *index);
+}
+
+// Bind the module instance whose `run` export is in function table slot `slot`
+WASM_EXPORT bool aot_wasm_attach(u32 slot) {
+    if (g_aot_wasm_size == 0 || slot == 0) return false;
+    g_aot_wasm_program.entry = (PLCAotEntry) (uintptr_t) slot;
+    g_aot_wasm_program.bytecode = runtime.program.program;
+    g_aot_wasm_program.size = g_aot_wasm_size;
+    g_aot_wasm_program.checksum = g_aot_wasm_checksum;
+    g_aot_wasm_program.crc = g_aot_wasm_crc;
+    runtime.aot.attach(&g_aot_wasm_program);
+    return runtime.aot.active(runtime.program);
+}
+
+WASM_EXPORT void aot_wasm_detach() { runtime.detachNativeProgram(); }
+
+// True while run() executes the attached module
+WASM_EXPORT bool aot_wasm_active() { return runtime.aot.active(runtime.program); }
+#endif // PLCRUNTIME_AOT_ENABLED
@@ -48,7 +48,7 @@ if %SAFE_MODE%==1 (
 @echo Building...
 @echo off
 
-wasm-ld --no-entry --export-dynamic --allow-undefined --lto-O3 build/VovkPLC.o -o dist/VovkPLC.wasm      || goto :error
+wasm-ld --no-entry --export-dynamic --export-table --growable-table --allow-undefined --lto-O3 build/VovkPLC.o -o dist/VovkPLC.wasm      || goto :error
 
 @echo on
 @echo Done.
@@ -45,5 +45,5 @@ else
 fi
 
 echo "Building..."
-wasm-ld --no-entry --export-dynamic --allow-undefined --lto-O3 build/VovkPLC.o -o dist/VovkPLC.wasm
+wasm-ld --no-entry --export-dynamic --export-table --growable-table --allow-undefined --lto-O3 build/VovkPLC.o -o dist/VovkPLC.wasm
 echo "Done."
\ No newline at end of file
@@ -677,6 +677,7 @@ const MEMORY_LAYOUT = {
  *     downloadAssembly: (assembly: string) => boolean, // Helper: Downloads assembly string directly (calls streamIn + loadAssembly).
  *     extractProgram: () => { size: number, output: string }, // Helper: Extracts program (calls uploadProgram + readStream).
  *     memory: WebAssembly.Memory, // The main WebAssembly linear memory.
+ *     __indirect_function_table?: WebAssembly.Table, // Function table, holds the `run` export of the WebAssembly tier (see compileToWasm).
  *     lint_load_assembly: () => void, // Moves streamed input to the linter buffer.
  *     lint_run: () => void, // Runs the linter on the loaded assembly.
  *     lint_get_problem_count: () => number, // Returns the number of problems found by the linter.
@@ -805,9 +806,16 @@ const MEMORY_LAYOUT = {
  *     project_load: () => boolean, // Loads the compiled program into the runtime. Returns true on success.
  *     project_reset: () => void, // Resets the project compiler state.
  *     project_getCombinedPLCASM: () => number, // Returns a pointer to the combined PLCASM source string from all blocks.
+ *     project_setIncremental: (enabled: boolean) => void, // Reuses the output of unchanged blocks from the previous compile.
+ *     project_clearCache: () => void, // Drops the cached block output.
+ *     project_getCacheHits: () => number, // Returns the number of blocks reused by the last compile.
+ *     project_getCacheMisses: () => number, // Returns the number of blocks converted by the last compile.
  *     project_uploadBytecode: () => number, // Streams the bytecode to stdout. Returns the bytecode length.
  *     project_printInfo: () => void, // Prints project information to stdout.
  *     project_loadToRuntime: () => number, // Loads the project bytecode into the runtime. Returns status code.
+ *     project_stageToRuntime?: () => number, // Stages the project bytecode as an online change, swapped in by the next run(). Returns status code.
+ *     program_changePending?: () => number, // Returns 1 while a staged program waits for the next run().
+ *     program_changeStatus?: () => number, // Returns the status of the last online change: 0, or why the staged program was dropped.
  *     runExplain: () => number, // Executes a single cycle with step-by-step explanation output.
  *     doSomething: () => void, // Test function that does something (for benchmarking).
  *     getLastInstructionCount: () => number, // Returns the number of instructions executed in the last cycle.
@@ -893,6 +901,20 @@ const MEMORY_LAYOUT = {
  *     wcet_analyze_compiled?: () => boolean, // Analyze bytecode from PLCASM compiler. Returns true on success.
  *     wcet_analyze_project?: () => boolean, // Analyze bytecode from project compiler. Returns true on success.
  *     wcet_analyze_runtime?: () => boolean, // Analyze bytecode loaded in runtime. Returns true on success.
+ *     aot_load_name_from_stream?: () => boolean, // Reads the symbol name for the AOT translator from the input stream. Returns false if it is not a C identifier.
+ *     aot_translate_compiled?: () => boolean, // Prints the PLCASM compiler bytecode as C++ source (see translateToCpp). Returns true on success.
+ *     aot_translate_project?: () => boolean, // Prints the project compiler bytecode as C++ source. Returns true on success.
+ *     aot_translate_runtime?: () => boolean, // Prints the runtime program as C++ source. Returns true on success.
+ *     aot_get_error?: () => number, // Pointer to the reason of the last failed translation.
+ *     aot_wasm_translate_runtime?: () => boolean, // Translates the runtime program into a WebAssembly module (see compileToWasm). Returns true on success.
+ *     aot_wasm_get_module?: () => number, // Pointer to the translated module bytes.
+ *     aot_wasm_get_module_size?: () => number, // Size of the translated module in bytes.
+ *     aot_wasm_get_native_count?: () => number, // Instructions emitted as WebAssembly.
+ *     aot_wasm_get_fallback_count?: () => number, // Instructions executed through env.step.
+ *     aot_wasm_step?: (runtime: number, index_ptr: number) => number, // env.step of the translated module: executes the instruction at *index_ptr.
+ *     aot_wasm_attach?: (slot: number) => boolean, // Binds the module in function table slot `slot`. Returns true while it matches the loaded program.
+ *     aot_wasm_detach?: () => void, // Goes back to interpreting the loaded program.
+ *     aot_wasm_active?: () => boolean, // True while run() executes the translated module.
  *     wcet_do_print_report?: () => void, // Print human-readable WCET report to stdout.
  *     wcet_get_bytecode_size?: () => number, // Total bytecode size analyzed.
  *     wcet_get_instruction_count?: () => number, // Total decoded instructions.
@@ -1060,6 +1082,10 @@ class VovkPLC_class {
     console_message = ''
     error_message = ''
     stream_message = ''
+    /** @type { string | null } Collects raw stdout (blank lines included) instead of printing it while non-null */
+    stdout_capture = null
+    /** @type { number | null } Function table slot holding the `run` export of the WebAssembly tier */
+    wasm_tier_slot = null
     /** @type { Performance | null } */
     perf = null
 
@@ -2295,6 +2321,73 @@ class VovkPLC_class {
         }
     }
 
+    /**
+     * Ahead-of-time translation of compiled bytecode into C++ source for firmware builds.
+     * The result holds the bytecode and a native function; include it after VovkPLCRuntime.h
+     * and load it with `runtime.loadNativeProgram(<name>)`.
+     * @param {'compiled' | 'project' | 'runtime'} [source='compiled'] - Which bytecode to translate
+     * @param {{ name?: string }} [options] - `name` of the generated symbols (C identifier, default 'plc_program')
+     * @returns {string} Generated C++ source
+     */
+    translateToCpp(source = 'compiled', options = {}) {
+        if (!this.wasm_exports) throw new Error('WebAssembly module not initialized')
+        const wasm = this.wasm_exports
+        if (!wasm.aot_translate_compiled) throw new Error('AOT translator not available in this build')
+        const name = options.name || 'plc_program'
+        wasm.streamClear()
+        for (let i = 0; i < name.length; i++) wasm.streamIn(name.charCodeAt(i))
+        wasm.streamIn(0)
+        if (!wasm.aot_load_name_from_stream()) throw new Error(`Invalid name '${name}', expected a C identifier`)
+
+        this.stdout_capture = ''
+        let ok = false
+        let output = ''
+        try {
+            if (source === 'compiled') ok = wasm.aot_translate_compiled()
+            else if (source === 'project') ok = wasm.aot_translate_project()
+            else if (source === 'runtime') ok = wasm.aot_translate_runtime()
+            else throw new Error(`AOT translation not available for source '${source}'`)
+        } finally {
+            output = this.stdout_capture
+            this.stdout_capture = null
+        }
+        if (!ok) throw new Error(`AOT translation failed for source '${source}': ${this.readCString(wasm.aot_get_error()) || 'no bytecode available'}`)
+        return output
+    }
+
+    /**
+     * WebAssembly tier: translates the program loaded in the runtime into a WebAssembly module
+     * and binds it to the runtime, so every run() executes it instead of interpreting the bytecode.
+     * The module imports this instance's memory and `aot_wasm_step` for the instructions it does not
+     * emit itself (timers, strings, FFI, COMMS, calls), its `run` export lives in the function table.
+     * Loading another program falls back to the interpreter until compileToWasm() is called again.
+     * @returns {Promise<{ size: number, native: number, fallback: number }>} Module size and instruction split
+     */
+    async compileToWasm() {
+        if (!this.wasm_exports || !this.wasm) throw new Error('WebAssembly module not initialized')
+        const wasm = this.wasm_exports
+        if (!wasm.aot_wasm_translate_runtime) throw new Error('WebAssembly tier not available in this build')
+        const table = this.wasm.exports.__indirect_function_table
+        if (!(table instanceof WebAssembly.Table)) throw new Error('WebAssembly tier needs the function table export (link with --export-table --growable-table)')
+        if (!wasm.aot_wasm_translate_runtime()) throw new Error(`WebAssembly translation failed: ${this.readCString(wasm.aot_get_error()) || 'no program loaded'}`)
+        const memory = this.wasm.exports.memory
+        const ptr = wasm.aot_wasm_get_module()
+        const size = wasm.aot_wasm_get_module_size()
+        const bytes = new Uint8Array(memory.buffer, ptr, size).slice()
+        const module = await WebAssembly.compile(bytes)
+        const instance = await WebAssembly.instantiate(module, { env: { memory, step: this.wasm.exports.aot_wasm_step } })
+        if (this.wasm_tier_slot === null) this.wasm_tier_slot = table.grow(1)
+        table.set(this.wasm_tier_slot, instance.exports.run) // Replaces the module of a previous program
+        if (!wasm.aot_wasm_attach(this.wasm_tier_slot)) throw new Error('Failed to attach the WebAssembly module')
+        return { size, native: wasm.aot_wasm_get_native_count(), fallback: wasm.aot_wasm_get_fallback_count() }
+    }
+
+    /** Go back to interpreting the loaded program after compileToWasm() */
+    detachWasm() {
+        if (!this.wasm_exports) throw new Error('WebAssembly module not initialized')
+        if (this.wasm_exports.aot_wasm_detach) this.wasm_exports.aot_wasm_detach()
+    }
+
     /**
      * WCET (Worst-Case Execution Time) Analysis.
      * Performs static analysis on compiled bytecode to determine:
@@ -2575,13 +2668,15 @@ class VovkPLC_class {
             0x10: 'CVT', 0x11: 'LOAD', 0x12: 'MOVE', 0x13: 'MOVE_COPY',
             0x14: 'COPY', 0x15: 'SWAP', 0x16: 'DROP', 0x17: 'CLEAR',
             0x18: 'LOAD_FROM', 0x19: 'MOVE_TO', 0x1A: 'INC_MEM', 0x1B: 'DEC_MEM',
-            0x1C: 'PICK', 0x1D: 'POKE', 0x1E: 'MEM_FILL',
+            0x1C: 'PICK', 0x1D: 'POKE', 0x1E: 'MEM_FILL', 0x1F: 'LOAD_CMP_IMM',
             0x20: 'ADD', 0x21: 'SUB', 0x22: 'MUL', 0x23: 'DIV', 0x24: 'MOD',
-            0x25: 'POW', 0x26: 'SQRT', 0x27: 'NEG', 0x29: 'ABS', 0x2A: 'SIN', 0x2B: 'COS',
+            0x25: 'POW', 0x26: 'SQRT', 0x27: 'NEG', 0x28: 'ABS', 0x29: 'SIN', 0x2A: 'COS',
+            0x2C: 'READ_AND_X8', 0x2D: 'READ_OR_X8', 0x2E: 'READ_AND_WRITE_X8', 0x2F: 'LOAD_CMP_IMM_JMP_IF_NOT',
             0x30: 'TON_CONST', 0x31: 'TON_MEM', 0x32: 'TOF_CONST', 0x33: 'TOF_MEM',
             0x34: 'TP_CONST', 0x35: 'TP_MEM', 0x36: 'CTU_CONST', 0x37: 'CTU_MEM',
             0x38: 'CTD_CONST', 0x39: 'CTD_MEM',
             0xC0: 'LOGIC_AND', 0xC1: 'LOGIC_OR', 0xC2: 'LOGIC_XOR', 0xC3: 'LOGIC_NOT',
+            0xC4: 'BIT_GATHER_X32', 0xC5: 'BIT_GATHER_X64', 0xC6: 'BIT_SCATTER_X32', 0xC7: 'BIT_SCATTER_X64',
             0xD0: 'CMP_EQ', 0xD1: 'CMP_NEQ', 0xD2: 'CMP_GT', 0xD3: 'CMP_LT',
             0xD4: 'CMP_GTE', 0xD5: 'CMP_LTE',
             0xE0: 'JMP', 0xE1: 'JMP_IF', 0xE2: 'JMP_IF_NOT',
@@ -2589,7 +2684,7 @@ class VovkPLC_class {
             0xE6: 'RET', 0xE7: 'RET_IF', 0xE8: 'RET_IF_NOT',
             0xE9: 'JMP_REL', 0xEA: 'JMP_IF_REL', 0xEB: 'JMP_IF_NOT_REL',
             0xEC: 'CALL_REL', 0xED: 'CALL_IF_REL', 0xEE: 'CALL_IF_NOT_REL',
-            0xF0: 'FFI_CALL', 0xF1: 'FFI_CALL_STACK',
+            0xF0: 'FFI_CALL', 0xF1: 'FFI_CALL_STACK', 0xFA: 'BR_SAVE_READ',
             0xFD: 'LANG', 0xFE: 'COMMENT', 0xFF: 'EXIT',
         }
         return names[opcode] || `OP_0x${opcode.toString(16).toUpperCase().padStart(2, '0')}`
@@ -3034,6 +3129,13 @@ class VovkPLC_class {
      *   Use VovkPLC.RUNTIME_FLAGS constants or a value from decodeRuntimeFlags().raw.
      *   Default is 0xFFFF (all features enabled). Set to a device's actual flags to get errors
      *   when the project uses unsupported features like timers, counters, or strings.
+     * @property {boolean} [fuseSuperinstructions] - Replace common instruction sequences with fused opcodes
+     *   (READ_AND_X8, LOAD_CMP_IMM_JMP_IF_NOT, BR_SAVE_READ, ...). Default is false.
+     *   Only enable it for runtimes that support the fused opcodes.
+     * @property {boolean} [bitParallel] - Evaluate runs of pure boolean STL/Ladder rungs 32/64 at a time with
+     *   BIT_GATHER/BIT_SCATTER and word-wide bitwise ops. Default is false.
+     *   Only enable it for runtimes that support the bit gather/scatter opcodes.
+     * @property {boolean} [incremental] - Reuse the output of blocks that did not change since the previous compile (default true)
      */
 
     /**
@@ -3097,6 +3199,16 @@ class VovkPLC_class {
             }
         }
 
+        if (this.wasm_exports.project_setSuperinstructionFusion) {
+            this.wasm_exports.project_setSuperinstructionFusion(!!options.fuseSuperinstructions)
+        }
+        if (this.wasm_exports.project_setBitParallel) {
+            this.wasm_exports.project_setBitParallel(!!options.bitParallel)
+        }
+        if (this.wasm_exports.project_setIncremental) {
+            this.wasm_exports.project_setIncremental(options.incremental !== false)
+        }
+
         // Clear any stale data in the stream buffer first
         if (this.wasm_exports.streamClear) this.wasm_exports.streamClear()
 
@@ -5376,6 +5488,10 @@ class VovkPLC_class {
     /** @type { (charcode: number) => void } */
     console_print = c => {
         const char = String.fromCharCode(c)
+        if (this.stdout_capture !== null) {
+            this.stdout_capture += char
+            return
+        }
         if (char === '\n') {
             const callback = this.stdout_callback || console.log
             if (this.console_message && this.console_message.length > 0 && !this.silent) callback(this.console_message)
@@ -5723,6 +5839,145 @@ class VovkPLC_class {
             const checksum_hex = checksum.toString(16).padStart(2, '0')
             return cmd + db_hex_u16 + checksum_hex
         },
+
+        /** Query binary frame support (BF command), replies 'OK BF<u8 version><u16 max payload>' * @returns { string } */
+        binaryFraming: () => {
+            const cmd = 'BF'
+            const cmd_hex = this.stringToHex(cmd)
+            const checksum = this.crc8(this.parseHex(cmd_hex))
+            const checksum_hex = checksum.toString(16).padStart(2, '0')
+            return cmd + checksum_hex
+        },
+    }
+
+    /** CRC-32 (IEEE, zlib compatible), chain by passing the previous result * @param { number[] | Uint8Array } data * @param { number } [crc] */
+    crc32 = (data, crc = 0) => {
+        crc = ~crc >>> 0
+        for (let i = 0; i < data.length; i++) {
+            crc ^= data[i]
+            for (let k = 0; k < 8; k++) crc = crc & 1 ? (crc >>> 1) ^ 0xedb88320 : crc >>> 1
+        }
+        return ~crc >>> 0
+    }
+
+    // Binary framed protocol (PLCRUNTIME_BINARY_PROTOCOL):
+    //   A5 <cmd u8> <seq u8> <len u16> <payload[len]> <crc32 u32>, little-endian, CRC over cmd..payload
+    // Replies carry cmd | 0x80, the same seq and a payload starting with the status byte.
+    frame_commands = {
+        hello: 0x01,
+        health: 0x02,
+        healthReset: 0x03,
+        reset: 0x04,
+        memoryRead: 0x10,
+        memoryWrite: 0x11,
+        memoryWriteMask: 0x12,
+        memoryFormat: 0x13,
+        programBegin: 0x20,
+        programChunk: 0x21,
+        programEnd: 0x22,
+        programUpload: 0x23,
+        subscribe: 0x30,
+        push: 0x40,
+    }
+    frame_sequence = 0
+
+    /** @param { number } command * @param { number[] | Uint8Array } [payload] * @returns { Uint8Array } */
+    encodeFrame = (command, payload = []) => {
+        const length = payload.length
+        const frame = new Uint8Array(length + 9)
+        frame[0] = 0xa5
+        frame[1] = command
+        frame[2] = this.frame_sequence = (this.frame_sequence + 1) & 0xff
+        frame[3] = length & 0xff
+        frame[4] = length >> 8
+        frame.set(payload, 5)
+        const crc = this.crc32(frame.subarray(1, 5 + length))
+        new DataView(frame.buffer).setUint32(5 + length, crc, true)
+        return frame
+    }
+
+    /** @param { number } value */
+    u32le = value => [value & 0xff, (value >>> 8) & 0xff, (value >>> 16) & 0xff, (value >>> 24) & 0xff]
+
+    buildFrame = {
+        hello: () => this.encodeFrame(this.frame_commands.hello),
+        health: () => this.encodeFrame(this.frame_commands.health),
+        healthReset: () => this.encodeFrame(this.frame_commands.healthReset),
+        reset: () => this.encodeFrame(this.frame_commands.reset),
+        /** @param { number } address * @param { number } size */
+        memoryRead: (address, size) => this.encodeFrame(this.frame_commands.memoryRead, [...this.u32le(address), size & 0xff, size >> 8]),
+        /** @param { number } address * @param { number[] | Uint8Array } data */
+        memoryWrite: (address, data) => this.encodeFrame(this.frame_commands.memoryWrite, [...this.u32le(address), ...data]),
+        /** @param { number } address * @param { number[] | Uint8Array } data * @param { number[] | Uint8Array } mask */
+        memoryWriteMask: (address, data, mask) => {
+            if (data.length !== mask.length) throw new Error('Mask length must match data length')
+            return this.encodeFrame(this.frame_commands.memoryWriteMask, [...this.u32le(address), ...data, ...mask])
+        },
+        /** @param { number } address * @param { number } size * @param { number } value */
+        memoryFormat: (address, size, value) => this.encodeFrame(this.frame_commands.memoryFormat, [...this.u32le(address), ...this.u32le(size), value & 0xff]),
+        /**
+         * Watch memory ranges, the device then pushes changed bytes after each scan (at most once per interval). No ranges = unsubscribe.
+         * @param { number } interval_ms * @param { { address: number, size: number }[] } ranges
+         */
+        subscribe: (interval_ms, ranges) => {
+            const payload = [interval_ms & 0xff, (interval_ms >> 8) & 0xff]
+            for (const range of ranges) payload.push(...this.u32le(range.address), range.size & 0xff, range.size >> 8)
+            return this.encodeFrame(this.frame_commands.subscribe, payload)
+        },
+        /** @param { number } offset * @param { number } size */
+        programUpload: (offset, size) => this.encodeFrame(this.frame_commands.programUpload, [...this.u32le(offset), size & 0xff, size >> 8]),
+        /**
+         * Frames of a streamed program download: begin, chunks, end. Send them in order and wait for each reply.
+         * @param { number[] | Uint8Array } program * @param { number } [chunk_size] - Bytes per chunk, at most the device max payload - 4
+         * @returns { Uint8Array[] }
+         */
+        programDownload: (program, chunk_size = 256) => {
+            const bytes = Uint8Array.from(program)
+            const frames = [this.encodeFrame(this.frame_commands.programBegin, [...this.u32le(bytes.length), ...this.u32le(this.crc32(bytes))])]
+            for (let offset = 0; offset < bytes.length; offset += chunk_size) {
+                const chunk = bytes.subarray(offset, Math.min(offset + chunk_size, bytes.length))
+                frames.push(this.encodeFrame(this.frame_commands.programChunk, [...this.u32le(offset), ...chunk]))
+            }
+            frames.push(this.encodeFrame(this.frame_commands.programEnd))
+            return frames
+        },
+    }
+
+    /**
+     * Apply the runs of a PUSH frame to the local copy of the subscribed ranges (laid out back to back)
+     * @param { Uint8Array } data - `data` of the parsed PUSH frame * @param { Uint8Array } image - Local copy, `total` bytes from the SUBSCRIBE reply
+     */
+    applyPush = (data, image) => {
+        let i = 0
+        while (i + 3 <= data.length) {
+            const offset = data[i] | (data[i + 1] << 8)
+            const count = data[i + 2]
+            image.set(data.subarray(i + 3, i + 3 + count), offset)
+            i += 3 + count
+        }
+        return image
+    }
+
+    /**
+     * Decode one reply frame from the start of `bytes`
+     * @param { number[] | Uint8Array } bytes
+     * @returns {{ command: number, sequence: number, status: number, data: Uint8Array, size: number } | null} - `size` is the number of bytes consumed, null if incomplete
+     */
+    parseFrame = bytes => {
+        const start = Array.prototype.indexOf.call(bytes, 0xa5)
+        if (start < 0 || bytes.length - start < 9) return null
+        const frame = Uint8Array.from(bytes.slice(start))
+        const length = frame[3] | (frame[4] << 8)
+        if (frame.length < length + 9) return null
+        const crc = new DataView(frame.buffer).getUint32(5 + length, true)
+        if (crc !== this.crc32(frame.subarray(1, 5 + length))) throw new Error('Invalid frame checksum')
+        return {
+            command: frame[1] & 0x7f,
+            sequence: frame[2],
+            status: frame[5],
+            data: frame.slice(6, 5 + length),
+            size: start + length + 9,
+        }
     }
 }
 
@@ -6379,6 +6634,12 @@ class VovkPLCWorker extends VovkPLCWorkerClient {
     compileProject = (projectSource, options = {}) => this.call('compileProject', projectSource, options)
     /** @type { (source?: 'compiled' | 'project' | 'runtime', options?: { print?: boolean }) => Promise<WCETReport> } */
     analyzeWCET = (source = 'compiled', options = {}) => this.call('analyzeWCET', source, options)
+    /** @type { (source?: 'compiled' | 'project' | 'runtime', options?: { name?: string }) => Promise<string> } */
+    translateToCpp = (source = 'compiled', options = {}) => this.call('translateToCpp', source, options)
+    /** @type { () => Promise<{ size: number, native: number, fallback: number }> } */
+    compileToWasm = () => this.call('compileToWasm')
+    /** @type { () => Promise<void> } */
+    detachWasm = () => this.call('detachWasm')
     /** @type { (projectSource: string, options?: ProjectCompileOptions) => Promise<ProjectLinterProblem[]> } */
     lintProject = (projectSource, options = {}) => this.call('lintProject', projectSource, options)
     /** @type { (projectSource: string) => Promise<ProjectLinterProblem[]> } */
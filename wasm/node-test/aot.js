@@ -0,0 +1,298 @@
+#!/usr/bin/env node
+// aot.js - CLI tool for ahead-of-time translation of PLC programs into C++
+//
+// Usage:
+//   npm run aot < input.asm                       # Translate PLCASM code
+//   npm run aot < input.stl                       # Translate STL code (auto-detected)
+//   npm run aot < input.json                      # Translate Ladder Graph JSON (auto-detected)
+//   npm run aot -- --name conveyor < input.asm > conveyor.h
+//   echo "03 0A 03 14 20 03 FF" | npm run aot     # Translate raw bytecode hex
+//
+// The script will:
+//   1. Auto-detect the input language (Bytecode Hex, Ladder Graph JSON, PLCScript, STL, or PLCASM)
+//   2. Compile to bytecode as needed
+//   3. Print C++ source holding the bytecode and its native function
+//
+// Include the output after VovkPLCRuntime.h in the firmware and call
+// runtime.loadNativeProgram(<name>) instead of loading the bytecode.
+//
+// Options:
+//   --name NAME    Name of the generated symbols (default: plc_program)
+//   --out FILE     Write the source to FILE instead of stdout
+//   --help         Show this help message
+
+import VovkPLC from '../dist/VovkPLC.js'
+import path from 'path'
+import fs from 'fs'
+import { fileURLToPath } from 'url'
+
+const __filename = fileURLToPath(import.meta.url)
+const __dirname = path.dirname(__filename)
+
+// Parse command line arguments
+const args = process.argv.slice(2)
+const showHelp = args.includes('--help') || args.includes('-h')
+const nameIdx = args.findIndex(a => a === '--name')
+const symbolName = nameIdx >= 0 && args[nameIdx + 1] ? args[nameIdx + 1] : 'plc_program'
+const outIdx = args.findIndex(a => a === '--out')
+const outFile = outIdx >= 0 && args[outIdx + 1] ? args[outIdx + 1] : null
+// Without --out stdout carries the generated source, so compiler messages are suppressed
+const silent = !outFile
+
+if (showHelp) {
+    console.log(`
+aot.js - Ahead-of-time translation of PLC programs into C++
+
+Usage:
+  npm run aot < input.asm                       # Translate PLCASM code
+  npm run aot < input.stl                       # Translate STL code (auto-detected)
+  npm run aot -- --name conveyor < input.asm > conveyor.h
+  echo "03 0A 03 14 20 03 FF" | npm run aot     # Raw bytecode hex
+
+Options:
+  --name NAME    Name of the generated symbols (default: plc_program)
+  --out FILE     Write the source to FILE instead of stdout
+  --help         Show this help message
+
+Firmware:
+  #include <VovkPLCRuntime.h>
+  #include "plc_program.h"
+  ...
+  runtime.loadNativeProgram(plc_program);
+`)
+    process.exit(0)
+}
+
+// Read input from stdin
+async function readStdin() {
+    return new Promise((resolve, reject) => {
+        let data = ''
+        if (process.stdin.isTTY) {
+            console.error('Error: No input provided. Pipe code via stdin.')
+            console.error('Usage: echo "u8.const 10\\nu8.const 20\\nu8.add\\nexit" | npm run aot')
+            process.exit(1)
+        }
+        process.stdin.setEncoding('utf8')
+        process.stdin.on('data', chunk => data += chunk)
+        process.stdin.on('end', () => resolve(data))
+        process.stdin.on('error', reject)
+    })
+}
+
+// Detect input language (same as explain.js)
+function detectLanguage(code) {
+    const trimmed = code.trim()
+    if (/^(VOVKPLC)?PROJECT\s+\w+/i.test(trimmed)) return 'project'
+    const hexOnly = trimmed.replace(/[\s\r\n]/g, '')
+    if (/^[0-9A-Fa-f]+$/.test(hexOnly) && hexOnly.length >= 2 && hexOnly.length % 2 === 0) return 'bytecode-hex'
+    if (trimmed.startsWith('{')) {
+        try {
+            const parsed = JSON.parse(trimmed)
+            if (parsed.nodes && Array.isArray(parsed.nodes) && parsed.connections && Array.isArray(parsed.connections)) return 'ladder-graph'
+        } catch (e) { /* not JSON */ }
+    }
+    const lines = code.split('\n').map(l => l.trim()).filter(l => l && !l.startsWith('//'))
+    const stlPatterns = [/^A\s+[IQMXYSC]/i, /^AN\s+[IQMXYSC]/i, /^O\s+[IQMXYSC]/i, /^ON\s+[IQMXYSC]/i, /^=\s+[QYMSC]/i, /^S\s+[MQY]/i, /^R\s+[MQY]/i, /^L\s+[#MQY]/i, /^T\s+[MQY]/i, /^TON\s+T/i, /^TOF\s+T/i, /^TP\s+T/i, /^CTU\s+C/i, /^CTD\s+C/i, /^LD\s+[IQMXYSC]/i, /^ST\s+[QYMSC]/i]
+    const plcscriptPatterns = [/^let\s+\w+\s*:/i, /^const\s+\w+\s*:/i, /^function\s+\w+\s*\(/i, /^for\s*\(/i, /^while\s*\(/i, /^if\s*\(/i, /:\s*(u8|u16|u32|u64|i8|i16|i32|i64|f32|f64|bool)\s*[@=;]/i, /\+\+|--/, /&&|\|\|/]
+    const plcasmPatterns = [/^u8\./i, /^u16\./i, /^u32\./i, /^i8\./i, /^i16\./i, /^i32\./i, /^f32\./i, /^f64\./i, /^jmp\s+\w/i, /^jmp_if\s+\w/i, /^jmp_if_not\s+\w/i, /^call\s+\w/i, /^ret$/i, /^exit$/i]
+    let stlScore = 0, plcasmScore = 0, plcscriptScore = 0
+    for (const line of lines) {
+        for (const p of plcscriptPatterns) if (p.test(line)) { plcscriptScore++; break }
+        for (const p of stlPatterns) if (p.test(line)) { stlScore++; break }
+        for (const p of plcasmPatterns) if (p.test(line)) { plcasmScore++; break }
+    }
+    if (plcscriptScore > 0 && plcscriptScore >= stlScore && plcscriptScore >= plcasmScore) return 'plcscript'
+    if (plcasmScore > 0 && plcasmScore >= stlScore) return 'plcasm'
+    if (stlScore > 0) return 'stl'
+    return 'plcasm'
+}
+
+// Stream code to runtime
+function streamCode(runtime, code) {
+    for (let i = 0; i < code.length; i++) runtime.wasm_exports.streamIn(code.charCodeAt(i))
+    runtime.wasm_exports.streamIn(0)
+}
+
+// Capture stdout output
+let capturedOutput = ''
+function captureStdout(runtime) { capturedOutput = ''; runtime.stdout_callback = msg => { capturedOutput += msg + '\n' } }
+function readCapturedOutput() { const o = capturedOutput; capturedOutput = ''; return o }
+
+// CRC8 calculation
+function crc8Simple(bytes) {
+    let crc = 0
+    for (const byte of bytes) {
+        crc ^= byte
+        for (let k = 0; k < 8; k++) crc = (crc & 0x80) ? ((crc << 1) ^ 0x31) : (crc << 1)
+        crc &= 0xff
+    }
+    return crc
+}
+
+const run = async () => {
+    const wasmPath = path.resolve(__dirname, '../dist/VovkPLC.wasm')
+    if (!fs.existsSync(wasmPath)) {
+        console.error('Error: WASM file not found at', wasmPath)
+        console.error('Run "npm run build" first.')
+        process.exit(1)
+    }
+
+    const runtime = new VovkPLC(wasmPath)
+    captureStdout(runtime)
+    await runtime.initialize(wasmPath, false, false)
+    runtime.readStream()
+    readCapturedOutput()
+
+    try {
+        const input = await readStdin()
+        if (!input.trim()) { console.error('Error: Empty input'); process.exit(1) }
+
+        const language = detectLanguage(input)
+        const wasm = runtime.wasm_exports
+        let bytecodeSource = 'compiled'
+
+        if (!silent) {
+            console.log(`Detected language: ${language.toUpperCase()}`)
+        }
+
+        // Step 1: Compile to bytecode depending on language
+        if (language === 'bytecode-hex') {
+            // Parse hex and load directly as compiled bytecode
+            const hexOnly = input.replace(/[\s\r\n]/g, '')
+            const bytes = []
+            for (let i = 0; i < hexOnly.length; i += 2) bytes.push(parseInt(hexOnly.substr(i, 2), 16))
+            if (!silent) console.log(`Parsed ${bytes.length} bytes from hex input`)
+
+            // Load into runtime program for aot_translate_runtime
+            const checksum = crc8Simple(bytes)
+            const bufPtr = wasm.getHexDownloadBuffer ? wasm.getHexDownloadBuffer() : 0
+            readCapturedOutput()
+            if (bufPtr > 0 && wasm.downloadProgramHex) {
+                const view = new Uint8Array(wasm.memory.buffer, bufPtr, hexOnly.length + 1)
+                for (let i = 0; i < hexOnly.length; i++) view[i] = hexOnly.charCodeAt(i)
+                view[hexOnly.length] = 0
+                wasm.downloadProgramHex(bufPtr, bytes.length, checksum)
+            } else {
+                for (const b of bytes) wasm.streamIn(b)
+                wasm.downloadProgram(bytes.length, checksum)
+            }
+            readCapturedOutput()
+            bytecodeSource = 'runtime'
+
+        } else if (language === 'project') {
+            // Compile as project using high-level API
+            readCapturedOutput()
+            const result = runtime.compileProject(input)
+            if (!silent) {
+                const out = readCapturedOutput()
+                if (out.trim()) console.log(out.trimEnd())
+            } else { readCapturedOutput() }
+            if (result && result.problem) {
+                console.error(`Project compilation error: ${result.problem.message}`)
+                if (result.problem.line) console.error(`  at line ${result.problem.line}${result.problem.column ? ':' + result.problem.column : ''}`)
+                if (result.problem.block) console.error(`  in block: ${result.problem.block}`)
+                process.exit(1)
+            }
+            if (!result || !result.bytecode) {
+                console.error('Project compilation produced no bytecode')
+                process.exit(1)
+            }
+            if (!silent) {
+                console.log(`Project compiled: ${result.bytecode.split(' ').length} bytes`)
+                if (result.warnings && result.warnings.length > 0) {
+                    for (const w of result.warnings) console.log(`  Warning: ${w.message}`)
+                }
+            }
+            // Use 'project' source since project_compiler holds the bytecode
+            bytecodeSource = 'project'
+
+        } else if (language === 'ladder-graph') {
+            // Ladder → STL → PLCASM → bytecode
+            readCapturedOutput()
+            if (wasm.ladder_to_stl_load_from_stream && wasm.ladder_to_stl_compile) {
+                streamCode(runtime, input)
+                wasm.ladder_to_stl_load_from_stream()
+                wasm.ladder_to_stl_compile()
+            }
+            // Read the STL output and compile as STL
+            const stlOutput = runtime.readOutBuffer ? runtime.readOutBuffer() : runtime.readStream()
+            if (stlOutput && stlOutput.trim()) {
+                runtime.downloadAssembly(stlOutput)
+                wasm.compileAssembly(silent ? false : true)
+            }
+            if (!silent) {
+                const out = readCapturedOutput()
+                if (out.trim()) console.log(out.trimEnd())
+            } else { readCapturedOutput() }
+
+        } else if (language === 'plcscript') {
+            // PLCScript → PLCASM → bytecode
+            readCapturedOutput()
+            if (wasm.plcscript_compile_from_stream) {
+                streamCode(runtime, input)
+                wasm.plcscript_compile_from_stream()
+                const plcasm = runtime.readOutBuffer ? runtime.readOutBuffer() : runtime.readStream()
+                if (plcasm && plcasm.trim()) {
+                    runtime.downloadAssembly(plcasm)
+                    wasm.compileAssembly(silent ? false : true)
+                }
+            } else {
+                runtime.downloadAssembly(input)
+                wasm.compileAssembly(silent ? false : true)
+            }
+            if (!silent) {
+                const out = readCapturedOutput()
+                if (out.trim()) console.log(out.trimEnd())
+            } else { readCapturedOutput() }
+
+        } else if (language === 'stl') {
+            // STL → PLCASM → bytecode
+            readCapturedOutput()
+            if (wasm.stl_compile_from_stream) {
+                streamCode(runtime, input)
+                wasm.stl_compile_from_stream()
+                const plcasm = runtime.readOutBuffer ? runtime.readOutBuffer() : runtime.readStream()
+                if (plcasm && plcasm.trim()) {
+                    runtime.downloadAssembly(plcasm)
+                    wasm.compileAssembly(silent ? false : true)
+                }
+            } else {
+                runtime.downloadAssembly(input)
+                wasm.compileAssembly(silent ? false : true)
+            }
+            if (!silent) {
+                const out = readCapturedOutput()
+                if (out.trim()) console.log(out.trimEnd())
+            } else { readCapturedOutput() }
+
+        } else {
+            // PLCASM → bytecode
+            readCapturedOutput()
+            runtime.downloadAssembly(input)
+            wasm.compileAssembly(silent ? false : true)
+            if (!silent) {
+                const out = readCapturedOutput()
+                if (out.trim()) console.log(out.trimEnd())
+            } else { readCapturedOutput() }
+        }
+
+        // Step 2: Translate the bytecode
+        const source = runtime.translateToCpp(bytecodeSource, { name: symbolName })
+        readCapturedOutput()
+        if (outFile) {
+            fs.writeFileSync(outFile, source)
+            console.log(`Wrote ${outFile} (${source.split('\n').length} lines)`)
+        } else {
+            process.stdout.write(source)
+        }
+
+    } catch (err) {
+        console.error('Translation error:', err.message || err)
+        process.exit(1)
+    }
+}
+
+run().catch(err => {
+    console.error('Fatal error:', err)
+    process.exit(1)
+})
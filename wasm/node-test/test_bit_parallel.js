@@ -0,0 +1,102 @@
+// test_bit_parallel.js - Test bit-parallel compilation of boolean rung runs
+import VovkPLC from '../dist/VovkPLC.js';
+import fs from 'fs';
+import path from 'path';
+import { fileURLToPath } from 'url';
+
+const __dirname = path.dirname(fileURLToPath(import.meta.url));
+const samplesDir = path.join(__dirname, 'project-tests', 'samples');
+
+const plc = new VovkPLC();
+await plc.initialize('./wasm/dist/VovkPLC.wasm', false, true);
+
+const MEMORY_SIZE = 1024;
+const CYCLES = 5;
+const X_OFFSET = 64;
+
+// Deterministic pseudo-random numbers so failures are reproducible
+let seed = 12345;
+const random = n => {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    return seed % n;
+};
+
+// Compile, load and run a project, returning the bytecode and a memory snapshot
+const execute = (source, bitParallel, inputs = []) => {
+    const result = plc.compileProject(source, { bitParallel });
+    if (result.problem) return { error: result.problem.message };
+    if (!plc.wasm_exports.project_load()) return { error: 'load failed' };
+    plc.wasm_exports.memoryReset();
+    plc.wasm_exports.clearStack();
+    let status = 0;
+    for (let i = 0; i < CYCLES && status === 0; i++) {
+        const bytes = inputs[i] || [];
+        bytes.forEach((b, j) => plc.writeMemoryByte(X_OFFSET + j, b));
+        plc.setMillis((i + 1) * 10);
+        status = plc.run();
+    }
+    return { bytecode: result.bytecode, status, memory: Array.from(plc.readMemoryArea(0, MEMORY_SIZE)) };
+};
+
+const compare = (name, source, inputs) => {
+    const plain = execute(source, false, inputs);
+    if (plain.error) return { same: true, reduced: false }; // Lint and error samples
+    const packed = execute(source, true, inputs);
+    if (packed.error) {
+        console.log(`  ✗ ${name}: ${packed.error}`);
+        return { same: false, reduced: false };
+    }
+    const same = plain.status === packed.status && plain.memory.every((b, i) => b === packed.memory[i]);
+    console.log(`  ${same ? '✓' : '✗'} ${name}: ${plain.bytecode.length} -> ${packed.bytecode.length} bytes`);
+    return { same, reduced: packed.bytecode.length < plain.bytecode.length };
+};
+
+let failed = 0;
+const samples = fs.readdirSync(samplesDir).filter(f => f.endsWith('.project')).sort();
+for (const file of samples) {
+    const source = fs.readFileSync(path.join(samplesDir, file), 'utf8');
+    if (!compare(file, source).same) failed++;
+}
+
+// Many rungs of the same shape over random contacts, with random inputs per cycle
+const contact = () => ['X', 'M'][random(2)] + random(8) + '.' + random(8);
+const rungs = [];
+for (let r = 0; r < 40; r++) {
+    rungs.push(`A ${contact()}`, `AN ${contact()}`, 'O(', `A ${contact()}`, `A ${contact()}`, ')', `= Y${r >> 3}.${r & 7}`, `= M${20 + (r >> 3)}.${r & 7}`);
+}
+const source = `VOVKPLCPROJECT BitParallel
+VERSION 1.0
+
+MEMORY
+    OFFSET 0
+    AVAILABLE 1024
+    S 64
+    X 64
+    Y 64
+    M 256
+    T 90
+    C 40
+END_MEMORY
+
+FLASH
+    SIZE 32768
+END_FLASH
+
+PROGRAM main
+    BLOCK LANG=STL Rungs
+${rungs.join('\n')}
+    END_BLOCK
+END_PROGRAM
+`;
+const inputs = [];
+for (let i = 0; i < CYCLES; i++) inputs.push(Array.from({ length: 8 }, () => random(256)));
+const rung_run = compare('40 rungs', source, inputs);
+if (!rung_run.same) failed++;
+else if (!rung_run.reduced) {
+    console.log('  ✗ 40 rungs were not packed');
+    failed++;
+}
+
+const passed = failed === 0;
+console.log('\n' + (passed ? '✓ All tests passed!' : '✗ Tests failed!'));
+process.exit(passed ? 0 : 1);
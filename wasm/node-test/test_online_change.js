@@ -0,0 +1,98 @@
+// test_online_change.js - Test online program changes: DataBlock migration and rejected swaps
+import VovkPLC from '../dist/VovkPLC.js';
+
+const plc = new VovkPLC();
+await plc.initialize('./wasm/dist/VovkPLC.wasm', false, true);
+
+const M = 192; // Start of the M area in the projects below
+const INVALID_MEMORY_SIZE = 11;
+
+const project = (datablocks, code, memory = '') => `VOVKPLCPROJECT OnlineChange
+VERSION 1.0
+
+MEMORY
+    OFFSET 0
+    AVAILABLE 1024
+    S 64
+    X 64
+    Y 64
+    M 256
+${memory}END_MEMORY
+
+DATABLOCKS
+${datablocks}
+END_DATABLOCKS
+
+PROGRAM main
+    BLOCK LANG=PLCASM Main
+${code}
+    END_BLOCK
+END_PROGRAM
+`;
+
+const RECIPE = 'DB1 "Recipe" {\n    a: u8\n    b: u16\n}';
+const LOG = 'DB2 "Log" {\n    x: u16\n}';
+
+// The active program fills the DataBlocks
+const WRITER = project(`${RECIPE}\n${LOG}`, `
+u8.const 111
+u8.move_to Recipe.a
+u16.const 222
+u16.move_to Recipe.b
+u16.const 333
+u16.move_to Log.x`);
+
+// Copy DB fields into M0.. (u8 fields to one byte, u16 fields to two)
+const reader = fields => fields.map(([field, type], i) => `${type}.load_from ${field}\n${type}.move_to M${i * 2}`).join('\n');
+
+// Load and run the writer, stage `source` and run across the swap
+const change = source => {
+    const writer = plc.compileProject(WRITER);
+    if (writer.problem) return { error: writer.problem.message };
+    plc.wasm_exports.project_load();
+    plc.wasm_exports.memoryReset();
+    plc.wasm_exports.clearStack();
+    for (let i = 0; i < 3; i++) plc.run();
+    plc.writeMemoryArea(M, new Array(8).fill(0));
+    const result = plc.compileProject(source);
+    if (result.problem) return { error: result.problem.message };
+    const staged = plc.wasm_exports.project_stageToRuntime();
+    const first = plc.run();
+    const second = plc.run();
+    const memory = Array.from(plc.readMemoryArea(M, 8));
+    const u16 = i => memory[i * 2] | (memory[i * 2 + 1] << 8);
+    return { staged, first, second, pending: plc.wasm_exports.program_changePending(), status: plc.wasm_exports.program_changeStatus(), u8: i => memory[i * 2], u16 };
+};
+
+const cases = [
+    ['unchanged layout', project(`${RECIPE}\n${LOG}`, reader([['Recipe.a', 'u8'], ['Recipe.b', 'u16'], ['Log.x', 'u16']])),
+        r => r.u8(0) === 111 && r.u16(1) === 222 && r.u16(2) === 333],
+    ['grown DB', project('DB1 "Recipe" {\n    a: u8\n    b: u16\n    c: u32\n}\n' + LOG, reader([['Recipe.a', 'u8'], ['Recipe.b', 'u16'], ['Log.x', 'u16'], ['Recipe.c', 'u8']])),
+        r => r.u8(0) === 111 && r.u16(1) === 222 && r.u16(2) === 333 && r.u8(3) === 0],
+    ['shrunk DB', project('DB1 "Recipe" {\n    a: u8\n}\n' + LOG, reader([['Recipe.a', 'u8'], ['Log.x', 'u16']])),
+        r => r.u8(0) === 111 && r.u16(1) === 333],
+    ['reordered DBs', project(`${LOG}\n${RECIPE}`, reader([['Recipe.a', 'u8'], ['Recipe.b', 'u16'], ['Log.x', 'u16']])),
+        r => r.u8(0) === 111 && r.u16(1) === 222 && r.u16(2) === 333],
+    ['removed and added DB', project('DB3 "Extra" {\n    y: u8\n}\n' + LOG, reader([['Log.x', 'u16'], ['Extra.y', 'u8']])),
+        r => r.u16(0) === 333 && r.u8(1) === 0],
+];
+
+let failed = 0;
+for (const [name, source, check] of cases) {
+    const r = change(source);
+    const ok = !r.error && r.staged === 0 && r.first === 0 && r.second === 0 && r.pending === 0 && r.status === 0 && check(r);
+    console.log(`  ${ok ? '✓' : '✗'} ${name}${r.error ? ': ' + r.error : ''}`);
+    if (!ok) failed++;
+}
+
+// A layout that does not fit is reported by the next run() and the active program keeps running
+{
+    const r = change(project(`${RECIPE}\n${LOG}`, reader([['Recipe.a', 'u8']]), '    DB 9 65000\n'));
+    const ok = !r.error && r.staged === 0 && r.first === INVALID_MEMORY_SIZE && r.second === 0 && r.pending === 0 && r.status === INVALID_MEMORY_SIZE && r.u8(0) === 0;
+    console.log(`  ${ok ? '✓' : '✗'} layout that does not fit is rejected`);
+    if (!ok) failed++;
+}
+
+const passed = failed === 0;
+console.log('\n' + (passed ? '✓ All tests passed!' : '✗ Tests failed!'));
+process.exit(passed ? 0 : 1);
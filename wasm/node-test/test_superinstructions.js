@@ -0,0 +1,58 @@
+// test_superinstructions.js - Test superinstruction fusion for project compilation
+import VovkPLC from '../dist/VovkPLC.js';
+import fs from 'fs';
+import path from 'path';
+import { fileURLToPath } from 'url';
+
+const __dirname = path.dirname(fileURLToPath(import.meta.url));
+const samplesDir = path.join(__dirname, 'project-tests', 'samples');
+
+const plc = new VovkPLC();
+await plc.initialize('./wasm/dist/VovkPLC.wasm', false, true);
+
+const MEMORY_SIZE = 1024;
+const CYCLES = 5;
+
+// Compile, load and run a project, returning the bytecode and a memory snapshot
+const execute = (source, fuse) => {
+    const result = plc.compileProject(source, { fuseSuperinstructions: fuse });
+    if (result.problem) return { error: result.problem.message };
+    if (!plc.wasm_exports.project_load()) return { error: 'load failed' };
+    plc.wasm_exports.memoryReset();
+    plc.wasm_exports.clearStack();
+    let status = 0;
+    for (let i = 0; i < CYCLES && status === 0; i++) {
+        plc.setMillis((i + 1) * 10);
+        status = plc.run();
+    }
+    return { bytecode: result.bytecode, status, memory: Array.from(plc.readMemoryArea(0, MEMORY_SIZE)) };
+};
+
+let failed = 0;
+let fused_count = 0;
+const samples = fs.readdirSync(samplesDir).filter(f => f.endsWith('.project')).sort();
+for (const file of samples) {
+    const source = fs.readFileSync(path.join(samplesDir, file), 'utf8');
+    const plain = execute(source, false);
+    if (plain.error) continue; // Lint and error samples
+    const fused = execute(source, true);
+    if (fused.error) {
+        console.log(`  ✗ ${file}: ${fused.error}`);
+        failed++;
+        continue;
+    }
+    const same = plain.status === fused.status && plain.memory.every((b, i) => b === fused.memory[i]);
+    if (fused.bytecode.length < plain.bytecode.length) fused_count++;
+    console.log(`  ${same ? '✓' : '✗'} ${file}: ${plain.bytecode.length} -> ${fused.bytecode.length} bytes`);
+    if (!same) failed++;
+}
+
+// Fusion must stay off unless requested
+const check = execute(fs.readFileSync(path.join(samplesDir, 'test_01_base.project'), 'utf8'), false);
+const expected = JSON.parse(fs.readFileSync(path.join(samplesDir, 'test_01_base.output'), 'utf8'));
+const default_off = check.bytecode && Array.from(check.bytecode).map(b => b.toString(16).toUpperCase().padStart(2, '0')).join(' ') === expected.bytecode;
+if (!default_off) { console.log('  ✗ default compilation changed'); failed++; }
+
+const passed = failed === 0 && fused_count > 0;
+console.log('\n' + (passed ? '✓ All tests passed!' : '✗ Tests failed!'));
+process.exit(passed ? 0 : 1);
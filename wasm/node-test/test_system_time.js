@@ -42,7 +42,7 @@ console.log('Running for ~1.5s...')
 const delay = ms => new Promise(resolve => setTimeout(resolve, ms))
 
 // We need to loop and call run() repeatedly
-// P_1s depends on IntervalGlobalLoopCheck which reads performance.now()
+// P_1s depends on the runtime clock, which run() updates from performance.now()
 const duration = 1500
 const startTs = Date.now()
 